@@ -16,6 +16,7 @@
 
 #include "abstractCalculationThread.h"
 #include "log.h"
+#include "asyncLog.h"
 
 using namespace std;
 
@@ -78,6 +79,9 @@ void AbstractCalculationThread::newFrameReady(frame_data_t frameData)
     if (mCurrentState != CALCULATION_AWAITING_DATA) {
         if (mCurrentState == CALCULATION_ACTIVE) {
             DOTRACE(("AbstractCalculationThread::dropped frame\n"));
+            mLatencyStatistics.addDrop(FrameLatencyStatistics::DROP_CALCULATION_BUSY);
+        } else if (mCurrentState == CALCULATION_PAUSED) {
+            mLatencyStatistics.addDrop(FrameLatencyStatistics::DROP_PAUSED);
         }
         return;
     }
@@ -85,6 +89,7 @@ void AbstractCalculationThread::newFrameReady(frame_data_t frameData)
     if (frameData.timestamp <= mLastFrameTimeStamp)
     {
         //cout << "Frame was received second time. Previous TS: "<< lastFrameTimeStamp << " Current TS: " << frameData.timestamp << "\n";
+        mLatencyStatistics.addDrop(FrameLatencyStatistics::DROP_REPEATED_FRAME);
         return;
     }
 
@@ -121,15 +126,19 @@ void AbstractCalculationThread::newFrameReady(frame_data_t frameData)
 
         if (ok) /* At least one input is active */
         {
+            mFrames.lifecycle().stamp(FrameLifecycle::CALCULATION_START);
             AbstractOutputData *res = processNewData();
+            mFrames.lifecycle().stamp(FrameLifecycle::CALCULATION_END);
             if (res != NULL)
             {
+                res->lifecycle = mFrames.lifecycle();
                 /* TODO: Possibly needs redesign. If signal is not processed there will
                 be a memory leak. Use Smart pointers here */
                 emit processingFinished(res);
             }
         } else {
-            SYNC_PRINT(("AbstractCalculationThread::newFrameReady(): No good frames. All frames are NULL\n"));
+            LA_WARNING_RATE(1, "AbstractCalculationThread::newFrameReady(): No good frames. All frames are NULL");
+            mLatencyStatistics.addDrop(FrameLatencyStatistics::DROP_NO_FRAMES);
         }
     }
 
@@ -20,6 +20,7 @@
 #include "imageCaptureInterface.h"
 
 #include "filterGraph.h"
+#include "frameLatencyStatistics.h"
 
 /**
  * An empty stub for the output data obtained as the result of the calculation.
@@ -30,6 +31,12 @@
 class AbstractOutputData
 {
 public:
+    /**
+     * Stamps of the frame the output was calculated from.
+     * The host adds OUTPUT_DELIVERED and passes it to the FrameLatencyStatistics of the thread
+     **/
+    FrameLifecycle lifecycle;
+
     virtual ~AbstractOutputData() {}
 };
 
@@ -102,6 +109,15 @@ class AbstractCalculationThread : public QThread
             return &mFrames;
         }
 
+        /**
+         * Latencies and dropped frames. It is thread safe, so the host could query it
+         * and add the stamps of the delivered outputs.
+         **/
+        FrameLatencyStatistics *latencyStatistics()
+        {
+            return &mLatencyStatistics;
+        }
+
 //        QWaitCondition threadPaused;
 
         void setImageCaptureInterface(ImageCaptureInterface *captureInterface)
@@ -134,6 +150,8 @@ class AbstractCalculationThread : public QThread
          **/
         CalculationState mCurrentState;
 
+        FrameLatencyStatistics mLatencyStatistics;
+
         /**
          * This is the main calculation routine called when a new frame is received
          *
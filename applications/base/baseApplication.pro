@@ -31,6 +31,8 @@ HEADERS += \
     statistics/qtStatisticsCollector.h \
     abstractCalculationThread.h \
     baseCalculationThread.h \
+    boundedQueue.h \
+    calculationPipeline.h \
     baseOutputData.h \
     baseHostDialog.h \
     mainWindow.h \
@@ -49,6 +51,7 @@ SOURCES += \
     statistics/statisticsDialog.cpp \
     abstractCalculationThread.cpp \
     baseCalculationThread.cpp \
+    calculationPipeline.cpp \
     baseOutputData.cpp \
     baseHostDialog.cpp \
     mainWindow.cpp \
@@ -8,6 +8,8 @@
  */
 
 #include <QtCore/QDebug>
+#include <QtCore/QReadLocker>
+#include <QtCore/QWriteLocker>
 #include <QtGui/QImage>
 
 #include "global.h"
@@ -18,6 +20,8 @@
 #include "layers/imageResultLayer.h"
 #include "inputFilter.h"
 #include "outputFilter.h"
+#include "zoneTracer.h"
+#include "asyncLog.h"
 
 #ifdef WITH_HARDWARE
 #include "../../hardware/platform/xparameters.h"
@@ -29,6 +33,7 @@ BaseCalculationThread::BaseCalculationThread()
     , mActiveInputsNumber(CamerasConfigParameters::TwoCapDev)
     , mBaseParams(NULL)
     , mCacheUpdateNeeded(true)
+    , mPipeline(NULL)
 {
     qDebug() <<  "BaseCalculationThread::BaseCalculationThread() : hardware initialized";
 
@@ -48,6 +53,7 @@ BaseCalculationThread::BaseCalculationThread()
 #endif
     }
     mProcessorGraph = new FilterGraph(&mFiltersCollection, NULL);
+    mProcessorGraph->fusePointwise = true;
 }
 
 
@@ -55,11 +61,226 @@ AbstractOutputData* BaseCalculationThread::processNewData()
 {
     BaseOutputData *resultData = new BaseOutputData();
 
-    initData(resultData);
+    initData(resultData, &resultData->stats);
 
     return resultData;
 }
 
+void BaseCalculationThread::setPipelined(bool pipelined, int queueCapacity, PipelineQueue::DropPolicy policy)
+{
+    delete_safe(mPipeline);
+    if (!pipelined)
+        return;
+
+    vector<string> stageNames(PIPELINE_STAGES_NUMBER);
+    stageNames[FILTER_STAGE]    = "Filter";
+    stageNames[TRANSFORM_STAGE] = "Transform";
+    stageNames[OUTPUT_STAGE]    = "Output";
+
+    mPipeline = new CalculationPipeline(this, stageNames, queueCapacity, policy);
+    mPipeline->start();
+}
+
+/**
+ *  Fetch stage of the pipeline. It is done in the calculation thread itself, because
+ *  the frames should be taken from the capture interface in the context of this thread.
+ *
+ *  Unlike the serial mode the frames are not dropped here while other frames are processed,
+ *  the queue of the first stage decides it according to its DropPolicy.
+ **/
+void BaseCalculationThread::newFrameReady(frame_data_t frameData)
+{
+    if (mPipeline == NULL)
+    {
+        AbstractCalculationThread::newFrameReady(frameData);
+        return;
+    }
+
+    if (!mCaptureInterface)
+    {
+        LA_ERROR_RATE(1, "BaseCalculationThread::newFrameReady(): Image capture interface was not initialized");
+        return;
+    }
+
+    if (mCurrentState != CALCULATION_AWAITING_DATA)
+    {
+        if (mCurrentState == CALCULATION_PAUSED)
+            mLatencyStatistics.addDrop(FrameLatencyStatistics::DROP_PAUSED);
+        return;
+    }
+
+    if (frameData.timestamp <= mLastFrameTimeStamp)
+    {
+        mLatencyStatistics.addDrop(FrameLatencyStatistics::DROP_REPEATED_FRAME);
+        return;
+    }
+
+    TRACE_ZONE("BaseCalculationThread::fetch");
+    PreciseTimer fetchTime = PreciseTimer::currentTime();
+
+    uint64_t oldStamp   = mFrames.timestamp();
+    mFrames.fetchNewFrames(mCaptureInterface);
+    mInterframeDelay    = mFrames.timestamp() - oldStamp;
+    mLastFrameTimeStamp = mFrames.timestamp();
+
+    if (mBaseParams.isNull() || mPresentationParams.isNull())
+        return;
+
+    if (mCacheUpdateNeeded)
+    {
+        QWriteLocker locker(&mConfigurationLock);
+        recalculateCache();
+    }
+
+    // We are missing data, so pause calculation
+    if ((!mFrames.getCurrentFrame(Frames::LEFT_FRAME) ) ||
+       ((!mFrames.getCurrentFrame(Frames::RIGHT_FRAME)) && (CamerasConfigParameters::TwoCapDev == mActiveInputsNumber)))
+    {
+        mLatencyStatistics.addDrop(FrameLatencyStatistics::DROP_NO_FRAMES);
+        pauseCalculation();
+        return;
+    }
+
+    for (int stage = 0; stage < mPipeline->stagesNumber(); stage++)
+    {
+        mLatencyStatistics.addQueueDepth(mPipeline->stageName(stage), mPipeline->queueDepth(stage));
+    }
+
+    PipelineFrame *frame = new PipelineFrame();
+    frame->timestamp = mFrames.timestamp();
+    frame->lifecycle = mFrames.lifecycle();
+    for (int id = 0; id < Frames::MAX_INPUTS_NUMBER; id++)
+    {
+        G12Buffer *current = mFrames.getCurrentFrame((Frames::FrameSourceId)id);
+        /* Frames would be replaced by the next fetch, so the pipeline gets its own views of the data */
+        if (current != NULL)
+            frame->frames[id] = current->createView<G12Buffer>();
+    }
+
+    frame->stats.prefix = "Pipeline> ";
+    frame->stats.setTime("Fetch", fetchTime.usecsToNow());
+    frame->stats.setTime("Interframe delay", mInterframeDelay);
+
+    mPipeline->submit(frame);
+}
+
+void BaseCalculationThread::processStage(int stage, PipelineFrame *frame)
+{
+    if (stage == FILTER_STAGE)
+        frame->lifecycle.stamp(FrameLifecycle::CALCULATION_START);
+
+    QReadLocker locker(&mConfigurationLock);
+    switch (stage)
+    {
+        case FILTER_STAGE:    filterStage   (frame); break;
+        case TRANSFORM_STAGE: transformStage(frame); break;
+        case OUTPUT_STAGE:    outputStage   (frame); break;
+        default: break;
+    }
+}
+
+void BaseCalculationThread::filterStage(PipelineFrame *frame)
+{
+    TRACE_ZONE("BaseCalculationThread::filterStage");
+    if (mBaseParams->enableFilterGraph())
+    {
+        bindGraphInputs(frame->frames);
+
+        string oldPrefix = frame->stats.prefix;
+        frame->stats.prefix += "Input Graph> ";
+        mProcessorGraph->stats = &frame->stats;
+        mProcessorGraph->execute();
+        mProcessorGraph->stats = NULL;
+        frame->stats.prefix = oldPrefix;
+
+        for (unsigned i = 0; i < mProcessorGraph->outputs.size(); i++)
+        {
+            OutputFilter* result = dynamic_cast<OutputFilter*>(mProcessorGraph->outputs[i]->parent);
+            int id = Frames::DEFAULT_FRAME;
+            if (result->mOutputParameters.outputType() == OutputType::LEFT_FRAME)
+                id = Frames::LEFT_FRAME;
+            else if (result->mOutputParameters.outputType() == OutputType::RIGHT_FRAME)
+                id = Frames::RIGHT_FRAME;
+            else
+                continue;
+
+            /* The view keeps the data alive after the graph is cleared */
+            G12Buffer *outputFrame = NULL;
+            mProcessorGraph->outputs[i]->getPin(outputFrame, true);
+            if (outputFrame == NULL)
+                continue;
+
+            delete_safe(frame->filtered[id]);
+            frame->filtered[id] = outputFrame;
+        }
+        mProcessorGraph->clearAllData();
+    }
+    else
+    {
+        for (int i = 0; i < mActiveInputsNumber; i++)
+        {
+            if (mFilterExecuter[i] == NULL || mFilterExecuter[i]->mFilters.empty() || frame->frames[i] == NULL)
+                continue;
+
+            G12Buffer *filtered = mFilterExecuter[i]->filter(frame->frames[i]);
+            if (filtered != frame->frames[i])
+                frame->filtered[i] = filtered;
+        }
+    }
+}
+
+void BaseCalculationThread::transformStage(PipelineFrame *frame)
+{
+    TRACE_ZONE("BaseCalculationThread::transformStage");
+    for (int i = 0; i < Frames::MAX_INPUTS_NUMBER; i++)
+    {
+        G12Buffer *input = (frame->filtered[i] != NULL) ? frame->filtered[i] : frame->frames[i];
+        if (input == NULL || mTransformationCache[i] == NULL)
+            continue;
+
+        frame->transformed[i] = mTransformationCache[i]->doDeformation(mBaseParams->interpolationType(), input);
+    }
+}
+
+void BaseCalculationThread::outputStage(PipelineFrame *frame)
+{
+    TRACE_ZONE("BaseCalculationThread::outputStage");
+    BaseOutputData *outputData = new BaseOutputData();
+
+    outputData->mMainImage.addLayer(
+            new ImageResultLayer(
+                    mPresentationParams->output(),
+                    frame->transformed,
+                    mPresentationParams->leftFrame()
+            )
+    );
+
+    outputData->mMainImage.setHeight(mBaseParams->h());
+    outputData->mMainImage.setWidth (mBaseParams->w());
+
+    frame->output = outputData;
+}
+
+void BaseCalculationThread::pipelineFinished(PipelineFrame *frame)
+{
+    frame->lifecycle.stamp(FrameLifecycle::CALCULATION_END);
+
+    BaseOutputData *outputData = dynamic_cast<BaseOutputData *>(frame->output);
+    if (outputData != NULL)
+    {
+        outputData->stats     = frame->stats;
+        outputData->lifecycle = frame->lifecycle;
+        frame->output = NULL;
+        emit processingFinished(outputData);
+    }
+    delete_safe(frame);
+}
+
+void BaseCalculationThread::pipelineDropped(int /*stage*/, PipelineFrame * /*frame*/)
+{
+    mLatencyStatistics.addDrop(FrameLatencyStatistics::DROP_QUEUE_FULL);
+}
+
 void BaseCalculationThread::initData(BaseOutputData *calculationOutputData, Statistics *stats)
 {
     recalculateCache();
@@ -92,17 +313,22 @@ void BaseCalculationThread::initData(BaseOutputData *calculationOutputData, Stat
     calculationOutputData->mMainImage.setWidth (mBaseParams->w());
 }
 
-void BaseCalculationThread::executeFilterGraph(Statistics *stats)
+void BaseCalculationThread::bindGraphInputs(G12Buffer *frames[Frames::MAX_INPUTS_NUMBER])
 {
     for (unsigned int i = 0; i < mProcessorGraph->inputs.size(); i++ )
     {
         InputFilter* input = dynamic_cast<InputFilter*>(mProcessorGraph->inputs[i]->parent);
         if (input->mInputParameters.inputType() == InputType::LEFT_FRAME) //FIXME change to Frames::LEFT_FRAME
-            mProcessorGraph->inputs[i]->initPin(mFrames.getCurrentFrame(Frames::LEFT_FRAME));
+            mProcessorGraph->inputs[i]->initPin(frames[Frames::LEFT_FRAME]);
 
         if (input->mInputParameters.inputType() == InputType::RIGHT_FRAME) //FIXME change to Frames::RIGHT_FRAME
-            mProcessorGraph->inputs[i]->initPin(mFrames.getCurrentFrame(Frames::RIGHT_FRAME));
+            mProcessorGraph->inputs[i]->initPin(frames[Frames::RIGHT_FRAME]);
     }
+}
+
+void BaseCalculationThread::executeFilterGraph(Statistics *stats)
+{
+    bindGraphInputs(mFrames.currentFrames);
 
     string oldPrefix;
     PreciseTimer timer = PreciseTimer::currentTime();
@@ -138,13 +364,6 @@ void BaseCalculationThread::executeFilterGraph(Statistics *stats)
             continue;
         }
 
-        if (mDistortionTransform != NULL) {
-            outputFrame = outputFrame->doReverseDeformationBl<G12Buffer, DisplacementBuffer>(
-                mDistortionTransform.data(),
-                outputFrame->h, outputFrame->w
-            );
-        }
-
         delete mTransformedBuffers[currentOutputBlocks];
         mTransformedBuffers[currentOutputBlocks] = mTransformationCache[currentOutputBlocks]->doDeformation(mBaseParams->interpolationType(), outputFrame);
     }
@@ -187,26 +406,27 @@ void BaseCalculationThread::transformInputFrames()
             inputFrame = newInputFrame;
         }
 
-        if (mDistortionTransform != NULL)
-        {
-            G12Buffer *newInputFrame = inputFrame->doReverseDeformationBl<G12Buffer, DisplacementBuffer>(
-                mDistortionTransform.data(),
-                inputFrame->h, inputFrame->w
-            );
-            if (inputFrame != inputFrameOrig)
-                delete inputFrame;
-            inputFrame = newInputFrame;
-        }
-
         delete_safe (mTransformedBuffers[i]);
 #ifdef WITH_HARDWARE
         if (mBaseParams->interpolationType() == InterpolationType::HARDWARE)
         {
+            /* The hardware corrector knows only the matrix, the distortion is corrected before it */
+            if (mDistortionTransform != NULL)
+            {
+                G12Buffer *newInputFrame = inputFrame->doReverseDeformationBl<G12Buffer, DisplacementBuffer>(
+                    mDistortionTransform.data(),
+                    inputFrame->h, inputFrame->w
+                );
+                if (inputFrame != inputFrameOrig)
+                    delete inputFrame;
+                inputFrame = newInputFrame;
+            }
+
             try {
                 mTransformedBuffers[i] = new G12Buffer(inputFrame);
                 mHardwareCorrectors[i] -> processABuffer(1, *(mTransformedBuffers[i]));
             } catch (Failure fail ) {
-                qDebug() << fail.getReason().c_str();
+                LA_ERROR_RATE(1, "%s", fail.getReason());
             }
         } else
         {
@@ -226,6 +446,8 @@ void BaseCalculationThread::transformInputFrames()
 
 BaseCalculationThread::~BaseCalculationThread()
 {
+    /* Workers should be stopped before the data they use is destroyed */
+    delete_safe(mPipeline);
     for (int i = 0; i < Frames::MAX_INPUTS_NUMBER; i++)
     {
         delete_safe (mTransformationCache[i]);
@@ -244,9 +466,15 @@ BaseCalculationThread::~BaseCalculationThread()
 void BaseCalculationThread::graphChanged(tinyxml2::XMLDocument* doc)
 {
 //    cout << "graphChanged slot here!" << endl;
+    QWriteLocker locker(&mConfigurationLock);
     delete_safe(mProcessorGraph);
     mProcessorGraph = new FilterGraph(&mFiltersCollection, NULL);
     mProcessorGraph->deserialize(doc);
+    /* Independent branches of the graph are executed concurrently */
+    mProcessorGraph->topologicSort();
+    mProcessorGraph->parallelExecution = true;
+    /* Pointwise chains are fused and the neighbourhood blocks run by stripes, see FilterGraphPlan */
+    mProcessorGraph->fusePointwise = true;
 }
 
 void BaseCalculationThread::filterControlParametersChanged(
@@ -259,12 +487,14 @@ void BaseCalculationThread::filterControlParametersChanged(
     }*/
 
     params->printParams();
+    QWriteLocker locker(&mConfigurationLock);
     delete mFilterExecuter[id];
     mFilterExecuter[id] = new FilterExecuter(*params);
 }
 
 void BaseCalculationThread::baseControlParametersChanged(QSharedPointer<BaseParameters> params)
 {
+    QWriteLocker locker(&mConfigurationLock);
     if (!params.isNull())
         mBaseParams = params;
 
@@ -273,12 +503,14 @@ void BaseCalculationThread::baseControlParametersChanged(QSharedPointer<BasePara
 
 void BaseCalculationThread::presentationControlParametersChanged(QSharedPointer<PresentationParameters> params)
 {
+    QWriteLocker locker(&mConfigurationLock);
     if (!params.isNull())
         mPresentationParams = params;
 }
 
 void BaseCalculationThread::camerasParametersChanged(QSharedPointer<CamerasConfigParameters> parametersShPtr)
 {
+    QWriteLocker locker(&mConfigurationLock);
     mActiveInputsNumber = parametersShPtr->inputsN();
     mRectificationData  = parametersShPtr->rectifierData();
     mCacheUpdateNeeded  = true;
@@ -385,7 +617,18 @@ void BaseCalculationThread::recalculateCache()
 
 
         delete mTransformationCache[i];
-        mTransformationCache[i] = new TransformationCache(mFrameTransformsInv[i], w, h, currentBuffer->getSize());
+        if (mDistortionTransform != NULL)
+        {
+            /* Rectification and the distortion correction are composed, so the frame is warped once */
+            DeformChain *chain = new DeformChain();
+            chain->add(new ProjectiveDeformStep(mFrameTransformsInv[i]));
+            chain->add(new DisplacementDeformStep(mDistortionTransform.data()));
+            mTransformationCache[i] = new TransformationCache(chain, w, h, currentBuffer->getSize());
+        }
+        else
+        {
+            mTransformationCache[i] = new TransformationCache(mFrameTransformsInv[i], w, h, currentBuffer->getSize());
+        }
 #ifdef WITH_HARDWARE
         //Matrix33 mat = Matrix33::Scale2(1.08) * Matrix33::ShiftProj(-39.5, -39.5) * Matrix33::RotateProj(6.0 / 128.0);
         try {
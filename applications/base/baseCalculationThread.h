@@ -7,6 +7,7 @@
  */
 
 #include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
 #include <QtCore/QSharedPointer>
 #include <QtGui/QImage>
 
@@ -26,6 +27,7 @@
 #include "filterGraph.h"
 #include "baseOutputData.h"
 #include "transformationCache.h"
+#include "calculationPipeline.h"
 
 #ifdef WITH_HARDWARE
 #include <vector>
@@ -38,18 +40,53 @@
  * frames from a capture interface, applies a transform and passes
  * them to the host application
  *
+ * By default the frame is processed by processNewData() and the frames that arrive
+ * meanwhile are dropped. With setPipelined() the thread only fetches the frames, and
+ * filtering, rectification and output preparation are done by the stages of
+ * the CalculationPipeline, each on its own worker. Derived classes that override
+ * processNewData() should not enable the pipeline.
+ *
  */
 
-class BaseCalculationThread : public AbstractCalculationThread
+class BaseCalculationThread : public AbstractCalculationThread, public PipelineStageHandler
 {
     Q_OBJECT
 public:
+    enum PipelineStageId
+    {
+        FILTER_STAGE,    /**< Filter graph or filter executer */
+        TRANSFORM_STAGE, /**< Rectification and lens distortion correction with the TransformationCache */
+        OUTPUT_STAGE,    /**< Preparation of the output data for the host */
+        PIPELINE_STAGES_NUMBER
+    };
+
     BaseCalculationThread();
 
     virtual ~BaseCalculationThread();
 
     void setLeftTransform(Matrix33 &leftTransform);
 
+    /**
+     *  Switches between the serial and the pipelined processing.
+     *  Should be called before the thread is started or from the thread itself.
+     **/
+    void setPipelined(
+            bool pipelined,
+            int queueCapacity = 2,
+            PipelineQueue::DropPolicy policy = PipelineQueue::DROP_OLDEST);
+
+    bool isPipelined() const
+    {
+        return mPipeline != NULL;
+    }
+
+protected slots:
+    /**
+     *  In the pipelined mode this is the fetch stage, otherwise the frame is processed
+     *  by AbstractCalculationThread::newFrameReady()
+     **/
+    virtual void newFrameReady(frame_data_t frameData);
+
 public slots:
     virtual void camerasParametersChanged            (QSharedPointer<CamerasConfigParameters>  params);
     virtual void baseControlParametersChanged        (QSharedPointer<BaseParameters>           params);
@@ -81,6 +118,16 @@ protected:
     void executeFilterGraph(Statistics *stats = NULL);
     void transformInputFrames();
     void recalculateCache();
+    void bindGraphInputs(G12Buffer *frames[Frames::MAX_INPUTS_NUMBER]);
+
+    /* PipelineStageHandler */
+    virtual void processStage(int stage, PipelineFrame *frame);
+    virtual void pipelineFinished(PipelineFrame *frame);
+    virtual void pipelineDropped(int stage, PipelineFrame *frame);
+
+    void filterStage   (PipelineFrame *frame);
+    void transformStage(PipelineFrame *frame);
+    void outputStage   (PipelineFrame *frame);
 
 
     FilterExecuter      *mFilterExecuter [Frames::MAX_INPUTS_NUMBER];
@@ -123,6 +170,14 @@ protected:
 
     bool mCacheUpdateNeeded;
     FilterGraph* mProcessorGraph;
+
+    CalculationPipeline *mPipeline;
+
+    /**
+     *  Pipeline stages hold it for reading while they run, slots that change
+     *  the parameters, caches or the graph hold it for writing
+     **/
+    QReadWriteLock mConfigurationLock;
 };
 
 /* EOF */
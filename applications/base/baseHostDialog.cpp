@@ -238,6 +238,10 @@ void BaseHostDialog::initCommon()
     qRegisterMetaType<QSharedPointer<DisplacementBuffer> >("QSharedPointer<DisplacementBuffer>");
     connect(mDistortionWidget, SIGNAL(recalculationFinished(QSharedPointer<DisplacementBuffer>)), this, SLOT(distortionEstimationFinished()));
 
+    /* Latency statistics */
+    QAction *saveLatency = mAdditionalTools->addAction("Save latency statistics...");
+    connect(saveLatency, SIGNAL(triggered()), this, SLOT(doSaveLatencyStatistics()));
+
     /* Connect video sequence control */
     emit captureStatusUpdated(false);
 }
@@ -380,6 +384,8 @@ void BaseHostDialog::createCalculator()
     mapper->setPresentationParametersControlWidget(mPresentationControlWidget);
 
     BaseCalculationThread *calculator = new BaseCalculationThread();
+    /* Frames are filtered, rectified and shown concurrently */
+    calculator->setPipelined(true);
 //    mFilterGraphPresentation->filterPresentations->fCollection = &calculator->mFiltersCollection;
 
     mCalculator = calculator;
@@ -548,6 +554,13 @@ void BaseHostDialog::processResult()
             painter.drawImage(QPoint(0,0), *processedData->image());
         }
         */
+        mStatsDialog.addStats(processedData->stats);
+        if (mCalculator != NULL)
+        {
+            processedData->lifecycle.stamp(FrameLifecycle::OUTPUT_DELIVERED);
+            mCalculator->latencyStatistics()->addFrame(processedData->lifecycle);
+        }
+
         int h = processedData->mMainImage.height();
         int w = processedData->mMainImage.width();
 
@@ -672,6 +685,10 @@ void BaseHostDialog::swapCameras(bool shouldSwap)
 void BaseHostDialog::setCaptureStats(CaptureStatistics stats)
 {
     mStatsDialog.addCaptureStats(stats);
+    if (mCalculator != NULL && stats.framesSkipped > 0)
+    {
+        mCalculator->latencyStatistics()->addDrop(FrameLatencyStatistics::DROP_CAPTURE_SKIPPED, stats.framesSkipped);
+    }
 
     foreach (ViAreaWidget *widget, mWidgets)
     {
@@ -780,6 +797,27 @@ void BaseHostDialog::doSaveParams()
     saveParams(filename, "");
 }
 
+void BaseHostDialog::doSaveLatencyStatistics()
+{
+    if (mCalculator == NULL)
+        return;
+
+    QString filename = QFileDialog::getSaveFileName(
+        this,
+        "Choose an file name",
+        ".",
+        "CSV (*.csv)"
+        );
+
+    if (filename.isEmpty())
+        return;
+
+    if (!mCalculator->latencyStatistics()->dumpCsv(filename.toStdString()))
+    {
+        qDebug() << "Unable to save latency statistics to" << filename;
+    }
+}
+
 void BaseHostDialog::loadParams(const QString &fileName, QString root)
 {
     QSettings settings(fileName, QSettings::IniFormat);
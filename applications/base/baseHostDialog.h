@@ -143,6 +143,8 @@ public slots:
     void doOpenInput();
     virtual void doLoadParams();
     virtual void doSaveParams();
+    /** Writes latency histograms, dropped frames and lifecycles of the latest frames to CSV */
+    void doSaveLatencyStatistics();
 
     void toggleAdvanced(bool off);
 
@@ -7,6 +7,7 @@
 #include <QtGui/QImage>
 
 #include "frames.h"
+#include "calculationStats.h"
 #include "abstractCalculationThread.h"
 #include "layers/resultImage.h"
 
@@ -15,6 +16,7 @@ class BaseOutputData : public AbstractOutputData
 {
 public:
     ResultImage mMainImage;
+    Statistics  stats;
 };
 
 
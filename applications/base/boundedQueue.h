@@ -0,0 +1,158 @@
+#pragma once
+/**
+ * \file boundedQueue.h
+ * \brief Thread safe queue of the limited capacity that connects the stages of the calculation pipeline
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <deque>
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QWaitCondition>
+
+/**
+ *  The queue never grows above its capacity. When the consumer is slower than the producer
+ *  the DropPolicy decides what happens with the new element.
+ *
+ *  The queue does not own the elements. Elements that are dropped are given back to the caller
+ *  of push(), so it can destroy them.
+ **/
+template<typename ElementType>
+class BoundedQueue
+{
+public:
+    enum DropPolicy
+    {
+        BLOCK_PRODUCER, /**< Producer waits until there is room in the queue, nothing is dropped */
+        DROP_NEWEST,    /**< Incoming element is rejected if the queue is full */
+        DROP_OLDEST     /**< The oldest queued element is evicted to make room for the incoming one */
+    };
+
+    BoundedQueue(int capacity = 2, DropPolicy policy = DROP_OLDEST) :
+        mCapacity(capacity > 0 ? capacity : 1)
+      , mPolicy(policy)
+      , mClosed(false)
+      , mDroppedNumber(0)
+    {}
+
+    /**
+     *  Adds the element to the queue.
+     *
+     *  \return true if some element was dropped, it is returned in \c dropped.
+     *          It could be the incoming element itself (DROP_NEWEST, or the queue is closed).
+     **/
+    bool push(const ElementType &element, ElementType &dropped)
+    {
+        QMutexLocker locker(&mMutex);
+
+        if (mPolicy == BLOCK_PRODUCER)
+        {
+            while (!mClosed && (int)mElements.size() >= mCapacity)
+                mNotFull.wait(&mMutex);
+        }
+
+        if (mClosed)
+        {
+            dropped = element;
+            return true;
+        }
+
+        bool wasDropped = false;
+        if ((int)mElements.size() >= mCapacity)
+        {
+            mDroppedNumber++;
+            wasDropped = true;
+            if (mPolicy == DROP_NEWEST)
+            {
+                dropped = element;
+                return true;
+            }
+            dropped = mElements.front();
+            mElements.pop_front();
+        }
+
+        mElements.push_back(element);
+        mNotEmpty.wakeOne();
+        return wasDropped;
+    }
+
+    /**
+     *  Takes the oldest element. Blocks while the queue is empty.
+     *
+     *  \return false if the queue was closed and there is nothing more to take
+     **/
+    bool pop(ElementType &element)
+    {
+        QMutexLocker locker(&mMutex);
+        while (!mClosed && mElements.empty())
+            mNotEmpty.wait(&mMutex);
+
+        if (mElements.empty())
+            return false;
+
+        element = mElements.front();
+        mElements.pop_front();
+        mNotFull.wakeOne();
+        return true;
+    }
+
+    /**
+     *  Wakes up all the waiting threads. Elements that are already in the queue could still be taken,
+     *  new ones are rejected.
+     **/
+    void close()
+    {
+        QMutexLocker locker(&mMutex);
+        mClosed = true;
+        mNotEmpty.wakeAll();
+        mNotFull.wakeAll();
+    }
+
+    void reopen()
+    {
+        QMutexLocker locker(&mMutex);
+        mClosed = false;
+    }
+
+    int size()
+    {
+        QMutexLocker locker(&mMutex);
+        return (int)mElements.size();
+    }
+
+    int capacity() const
+    {
+        return mCapacity;
+    }
+
+    DropPolicy policy() const
+    {
+        return mPolicy;
+    }
+
+    /** Number of elements that were dropped because the queue was full */
+    unsigned droppedNumber()
+    {
+        QMutexLocker locker(&mMutex);
+        return mDroppedNumber;
+    }
+
+private:
+    std::deque<ElementType> mElements;
+    int            mCapacity;
+    DropPolicy     mPolicy;
+    bool           mClosed;
+    unsigned       mDroppedNumber;
+
+    QMutex         mMutex;
+    QWaitCondition mNotEmpty;
+    QWaitCondition mNotFull;
+
+    /* Not copyable */
+    BoundedQueue(const BoundedQueue &);
+    BoundedQueue &operator =(const BoundedQueue &);
+};
+
+/* EOF */
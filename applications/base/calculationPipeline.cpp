@@ -0,0 +1,157 @@
+/**
+ * \file calculationPipeline.cpp
+ * \brief Implements the stages and queues of the calculation pipeline
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include "global.h"
+
+#include "calculationPipeline.h"
+#include "abstractCalculationThread.h"
+
+PipelineFrame::PipelineFrame() :
+    frameNumber(0)
+  , timestamp(0)
+  , output(NULL)
+{
+    for (int id = 0; id < Frames::MAX_INPUTS_NUMBER; id++)
+    {
+        frames     [id] = NULL;
+        filtered   [id] = NULL;
+        transformed[id] = NULL;
+    }
+    queuedTime = PreciseTimer::currentTime();
+}
+
+PipelineFrame::~PipelineFrame()
+{
+    for (int id = 0; id < Frames::MAX_INPUTS_NUMBER; id++)
+    {
+        delete_safe(frames     [id]);
+        delete_safe(filtered   [id]);
+        delete_safe(transformed[id]);
+    }
+    delete_safe(output);
+}
+
+void PipelineWorker::run()
+{
+    PipelineQueue *input = mPipeline->mQueues[mStage];
+    const string  &name  = mPipeline->mStageNames[mStage];
+
+    PipelineFrame *frame = NULL;
+    while (input->pop(frame))
+    {
+        frame->stats.setTime(name + " queue", frame->queuedTime.usecsToNow());
+
+        PreciseTimer stageTime = PreciseTimer::currentTime();
+        mPipeline->mHandler->processStage(mStage, frame);
+        frame->stats.setTime(name, stageTime.usecsToNow());
+
+        mPipeline->passOn(mStage + 1, frame);
+    }
+}
+
+CalculationPipeline::CalculationPipeline(
+        PipelineStageHandler *handler,
+        const vector<string> &stageNames,
+        int queueCapacity,
+        PipelineQueue::DropPolicy policy) :
+    mHandler(handler)
+  , mStageNames(stageNames)
+  , mSubmitted(0)
+  , mStarted(false)
+{
+    for (unsigned stage = 0; stage < mStageNames.size(); stage++)
+    {
+        mQueues .push_back(new PipelineQueue(queueCapacity, policy));
+        mWorkers.push_back(new PipelineWorker(this, stage));
+    }
+}
+
+CalculationPipeline::~CalculationPipeline()
+{
+    stop();
+    for (unsigned stage = 0; stage < mQueues.size(); stage++)
+    {
+        delete_safe(mWorkers[stage]);
+        delete_safe(mQueues [stage]);
+    }
+}
+
+void CalculationPipeline::start()
+{
+    if (mStarted)
+        return;
+
+    for (unsigned stage = 0; stage < mQueues.size(); stage++)
+    {
+        mQueues [stage]->reopen();
+        mWorkers[stage]->start();
+    }
+    mStarted = true;
+}
+
+void CalculationPipeline::stop()
+{
+    if (!mStarted)
+        return;
+
+    for (unsigned stage = 0; stage < mQueues.size(); stage++)
+    {
+        mQueues[stage]->close();
+    }
+
+    /* Workers finish the frames they have already taken and exit */
+    for (unsigned stage = 0; stage < mWorkers.size(); stage++)
+    {
+        mWorkers[stage]->wait();
+    }
+
+    for (unsigned stage = 0; stage < mQueues.size(); stage++)
+    {
+        PipelineFrame *frame = NULL;
+        while (mQueues[stage]->pop(frame))
+            delete_safe(frame);
+    }
+    mStarted = false;
+}
+
+void CalculationPipeline::submit(PipelineFrame *frame)
+{
+    frame->frameNumber = mSubmitted++;
+    passOn(0, frame);
+}
+
+unsigned CalculationPipeline::droppedNumber(int stage)
+{
+    return mQueues[stage]->droppedNumber();
+}
+
+int CalculationPipeline::queueDepth(int stage)
+{
+    return mQueues[stage]->size();
+}
+
+void CalculationPipeline::passOn(int stage, PipelineFrame *frame)
+{
+    if (stage == stagesNumber())
+    {
+        for (int i = 0; i < stagesNumber(); i++)
+        {
+            frame->stats.setValue("Dropped before " + mStageNames[i], droppedNumber(i));
+        }
+        mHandler->pipelineFinished(frame);
+        return;
+    }
+
+    frame->queuedTime = PreciseTimer::currentTime();
+
+    PipelineFrame *dropped = NULL;
+    if (mQueues[stage]->push(frame, dropped))
+    {
+        mHandler->pipelineDropped(stage, dropped);
+        delete_safe(dropped);
+    }
+}
@@ -0,0 +1,174 @@
+#pragma once
+/**
+ * \file calculationPipeline.h
+ * \brief Multi-stage pipeline that lets the calculation thread work on several frames at once
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <string>
+#include <vector>
+
+#include <QtCore/QThread>
+
+#include "global.h"
+
+#include "g12Buffer.h"
+#include "calculationStats.h"
+#include "preciseTimer.h"
+#include "frameLatencyStatistics.h"
+#include "frames.h"
+#include "boundedQueue.h"
+
+class AbstractOutputData;
+
+using std::string;
+using std::vector;
+
+/**
+ *  The frame that travels through the pipeline together with everything
+ *  that is computed for it. The frame owns all the buffers.
+ **/
+class PipelineFrame
+{
+public:
+    uint64_t   frameNumber;
+    uint64_t   timestamp;
+
+    /** Input frames. Usually these are views that share memory with the captured buffers */
+    G12Buffer *frames     [Frames::MAX_INPUTS_NUMBER];
+    /** Result of the filtering. NULL if the frame was not filtered */
+    G12Buffer *filtered   [Frames::MAX_INPUTS_NUMBER];
+    /** Rectified frames */
+    G12Buffer *transformed[Frames::MAX_INPUTS_NUMBER];
+
+    /** Result of the last stage, it is passed to the host */
+    AbstractOutputData *output;
+
+    Statistics     stats;
+    FrameLifecycle lifecycle;
+    /** Moment the frame was put into the queue of the current stage */
+    PreciseTimer queuedTime;
+
+    PipelineFrame();
+   ~PipelineFrame();
+
+private:
+    PipelineFrame(const PipelineFrame &);
+    PipelineFrame &operator =(const PipelineFrame &);
+};
+
+typedef BoundedQueue<PipelineFrame *> PipelineQueue;
+
+/**
+ *  The owner of the pipeline implements the stages
+ **/
+class PipelineStageHandler
+{
+public:
+    /**
+     * Called on the worker of the stage. For each frame the stages are called in order,
+     * and each stage gets the frames in the order they were submitted.
+     **/
+    virtual void processStage(int stage, PipelineFrame *frame) = 0;
+
+    /**
+     * Called on the worker of the last stage. Takes ownership of the frame.
+     **/
+    virtual void pipelineFinished(PipelineFrame *frame) = 0;
+
+    /**
+     * Called when the frame is dropped at the input of the stage, just before it is destroyed
+     **/
+    virtual void pipelineDropped(int /*stage*/, PipelineFrame * /*frame*/) {}
+
+    virtual ~PipelineStageHandler() {}
+};
+
+class CalculationPipeline;
+
+/**
+ *  Worker that runs one stage. It takes the frames from the input queue of the stage
+ *  and passes them to the input queue of the next one.
+ **/
+class PipelineWorker : public QThread
+{
+public:
+    PipelineWorker(CalculationPipeline *pipeline, int stage) :
+        mPipeline(pipeline)
+      , mStage(stage)
+    {}
+
+    virtual void run();
+
+private:
+    CalculationPipeline *mPipeline;
+    int                  mStage;
+};
+
+/**
+ *  Stages are connected by the bounded queues and each stage has its own worker,
+ *  so frame N+1 could be rectified while frame N is still filtered.
+ *
+ *  When some stage is slower than the frames arrive, its queue is filled up and the
+ *  DropPolicy of the queues decides which frames are lost. BLOCK_PRODUCER
+ *  keeps every frame and slows down the producer instead.
+ *
+ *  Each stage adds two records to the Statistics of the frame - the time spent in
+ *  the stage and the time the frame has waited for it in the queue. The last stage
+ *  also reports the number of frames dropped at the input of each stage.
+ **/
+class CalculationPipeline
+{
+public:
+    CalculationPipeline(
+            PipelineStageHandler *handler,
+            const vector<string> &stageNames,
+            int queueCapacity = 2,
+            PipelineQueue::DropPolicy policy = PipelineQueue::DROP_OLDEST);
+
+    /** Stops the workers. Frames that are still in the queues are destroyed */
+   ~CalculationPipeline();
+
+    void start();
+    void stop();
+
+    /**
+     * Passes the frame to the first stage. Takes ownership of the frame.
+     * Could block if the policy is BLOCK_PRODUCER.
+     **/
+    void submit(PipelineFrame *frame);
+
+    int stagesNumber() const
+    {
+        return (int)mStageNames.size();
+    }
+
+    const string &stageName(int stage) const
+    {
+        return mStageNames[stage];
+    }
+
+    /** Number of frames dropped at the input of the stage */
+    unsigned droppedNumber(int stage);
+
+    /** Number of frames waiting for the stage */
+    int queueDepth(int stage);
+
+private:
+    friend class PipelineWorker;
+
+    PipelineStageHandler     *mHandler;
+    vector<string>            mStageNames;
+    vector<PipelineQueue *>   mQueues;
+    vector<PipelineWorker *>  mWorkers;
+    uint64_t                  mSubmitted;
+    bool                      mStarted;
+
+    void passOn(int stage, PipelineFrame *frame);
+
+    CalculationPipeline(const CalculationPipeline &);
+    CalculationPipeline &operator =(const CalculationPipeline &);
+};
+
+/* EOF */
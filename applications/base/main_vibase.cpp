@@ -16,6 +16,7 @@
 #include "global.h"
 
 #include "utils.h"
+#include "asyncLog.h"
 #include "baseHostDialog.h"
 #include "mainWindow.h"
 
@@ -23,6 +24,8 @@ int main(int argc, char *argv[])
 {
     setSegVHandler();
     setStdTerminateHandler();
+    /* The capture and the calculation threads log through the queue, the console is written by its thread */
+    AsyncLog::start();
 
     QString source;
     if (argc != 2)
@@ -43,6 +46,7 @@ int main(int argc, char *argv[])
     mainWindow.show();
 
     app.exec();
+    AsyncLog::stop();
 
     std::cout << "Exiting Host application  \n";
     return 0;
@@ -10,6 +10,7 @@
 #include "scene3DMouse.h"
 #include "cloudViewDialog.h"
 #include "opengl/openGLTools.h"
+#include "plyLoader.h"
 
 
 
@@ -190,48 +191,38 @@ void Scene3DMouse::dumpPCD(ostream &out)
 /**
  * Format description
  * http://local.wasp.uwa.edu.au/~pbourke/dataformats/ply/
+ *
+ * The points are streamed in the binary form, the stream should be opened in the binary mode
  **/
 void Scene3DMouse::dumpPLY(ostream &out)
 {
+    PLYWriter writer(out);
+    writer.addComment("made by ViMouse software");
+    writer.addComment("This file is a saved stereo-reconstruction");
+    writer.addElement("vertex", cloud->size());
+    writer.addProperty("x"    , PlyProperty::TYPE_FLOAT);
+    writer.addProperty("y"    , PlyProperty::TYPE_FLOAT);
+    writer.addProperty("z"    , PlyProperty::TYPE_FLOAT);
+    writer.addProperty("red"  , PlyProperty::TYPE_UCHAR);
+    writer.addProperty("green", PlyProperty::TYPE_UCHAR);
+    writer.addProperty("blue" , PlyProperty::TYPE_UCHAR);
+    writer.writeHeader();
 
-    out << "ply" << endl;
-    out << "format ascii 1.0" << endl;
-    out << "comment made by ViMouse software" << endl;
-    out << "comment This file is a saved stereo-reconstruction" << endl;
-    out << "element vertex " << cloud->size() << endl;
-    out << "property float x" << endl;
-    out << "property float y" << endl;
-    out << "property float z" << endl;
-    out << "property uchar red" << endl;
-    out << "property uchar green" << endl;
-    out << "property uchar blue" << endl;
-    out << "end_header" << endl;
     for (unsigned i = 0; i < cloud->size(); i++)
     {
         SwarmPoint &p  = cloud->operator[](i);
-        double x = p.point.x() / 100.0;
-        double y = p.point.y() / 100.0;
-        double z = p.point.z() / 100.0;
-
         double limit = 1000;
-
-        if (x < -limit) x = -limit;
-        if (y < -limit) y = -limit;
-        if (z < -limit) z = -limit;
-
-        if (x > limit) x = limit;
-        if (y > limit) y = limit;
-        if (z > limit) z = limit;
-
-
-       out << x << " "
-           << y << " "
-           << z << " "
-           << (unsigned)(p.color.r()) << " "
-           << (unsigned)(p.color.g()) << " "
-           << (unsigned)(p.color.b()) << endl;
+        double values[6] = {
+            CORE_MAX(-limit, CORE_MIN(limit, p.point.x() / 100.0)),
+            CORE_MAX(-limit, CORE_MIN(limit, p.point.y() / 100.0)),
+            CORE_MAX(-limit, CORE_MIN(limit, p.point.z() / 100.0)),
+            (double)p.color.r(),
+            (double)p.color.g(),
+            (double)p.color.b()
+        };
+        writer.writeRow(values);
     }
-
+    writer.finish();
 }
 
 Scene3DMouse::~Scene3DMouse()
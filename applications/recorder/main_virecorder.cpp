@@ -16,6 +16,7 @@
 #include "global.h"
 
 #include "utils.h"
+#include "asyncLog.h"
 #include "recorderDialog.h"
 #include "mainWindow.h"
 
@@ -26,6 +27,8 @@ int main(int argc, char *argv[])
 {
     setSegVHandler();
     setStdTerminateHandler();
+    /* The capture and the calculation threads log through the queue, the console is written by its thread */
+    AsyncLog::start();
 
     QString source;
     if (argc != 2)
@@ -48,6 +51,7 @@ int main(int argc, char *argv[])
     MainWindow mainWindow(new RecorderDialog(), source, params);
 
     app.exec();
+    AsyncLog::stop();
 
     cout << "Exiting Host application  \n";
 
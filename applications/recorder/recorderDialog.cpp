@@ -178,6 +178,11 @@ void RecorderDialog::processResult()
             break;
 
         mStatsDialog.addStats(fod->stats);
+        if (mCalculator != NULL)
+        {
+            fod->lifecycle.stamp(FrameLifecycle::OUTPUT_DELIVERED);
+            mCalculator->latencyStatistics()->addFrame(fod->lifecycle);
+        }
 
         if (mIsRecording)
             mRecorderControlWidget->ui()->frameCountLabel->setText(QString("Frame (frame pairs) written: %1").arg(fod->frameCount));
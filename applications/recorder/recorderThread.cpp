@@ -108,7 +108,10 @@ AbstractOutputData* RecorderThread::processNewData()
             else
                 snprintf2buf(currentPath, mPath.toStdString().c_str(), mFrameCount);
 
-            if (mSaver.save(currentPath, result[id]))
+            int saveError = mCompressedSaver.acceptsFile(currentPath) ?
+                    mCompressedSaver.save(currentPath, result[id]) :
+                    mSaver.save(currentPath, result[id]);
+            if (saveError)
             {
                 resetRecording();
                 emit errorMessage(QString("Error writing frame to file") + currentPath);
@@ -19,6 +19,7 @@
 #include "baseCalculationThread.h"
 #include "imageCaptureInterface.h"
 #include "ppmLoader.h"
+#include "g12Codec.h"
 #include "preciseTimer.h"
 #include "generatedParameters/recorder.h"
 #include "calculationStats.h"
@@ -26,7 +27,6 @@
 class RecorderOutputData : public BaseOutputData
 {
 public:
-    Statistics stats;
     unsigned frameCount;
 };
 
@@ -68,6 +68,8 @@ private:
 
     /* Might be misleading, but PPMLoader handles saving as well */
     PPMLoader mSaver;
+    /* Used instead of mSaver when the file template ends with .g12z */
+    G12CodecLoader mCompressedSaver;
 
     uint32_t mFrameCount;
     QString mPath;
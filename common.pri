@@ -29,6 +29,10 @@ asserts {
     DEFINES += ASSERTS
 }
 
+with_tracing {
+    DEFINES += WITH_TRACING
+}
+
 with_avx {
     QMAKE_CFLAGS   += -mavx
     QMAKE_CXXFLAGS += -mavx
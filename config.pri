@@ -25,6 +25,7 @@ CONFIG +=       \
 #               \
 #   trace       \
 #   asserts     \
+#   with_tracing \
                 \
 #   with_sse     \
 #   with_sse3    \
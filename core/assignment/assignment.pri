@@ -1,6 +1,8 @@
 HEADERS += \
-    assignment/assignmentOptimal.h 
+    assignment/assignmentOptimal.h \
+    assignment/lapSolver.h 
    
 SOURCES += \
-    assignment/assignmentOptimal.cpp 
+    assignment/assignmentOptimal.cpp \
+    assignment/lapSolver.cpp 
 
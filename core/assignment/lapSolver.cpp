@@ -0,0 +1,516 @@
+/**
+ * \file lapSolver.cpp
+ * \brief Jonker-Volgenant assignment solver with the warm start between the frames
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#include <limits>
+#include <algorithm>
+
+#include "global.h"
+
+#include "lapSolver.h"
+#include "preciseTimer.h"
+
+namespace corecvs {
+
+static const double LAP_INFINITY = std::numeric_limits<double>::infinity();
+
+/** Rounds of dropping the kept rows, after which the warm start is abandoned */
+static const int LAP_WARM_ROUNDS = 3;
+
+LapSolver::LapSolver() :
+    mWarmStart(true),
+    mRows(0),
+    mColumns(0),
+    mTransposed(false),
+    mSparse(false),
+    mHasPrevious(false),
+    mPreviousTransposed(false)
+{}
+
+void LapSolver::reset()
+{
+    mHasPrevious = false;
+    mPreviousV.clear();
+    mPreviousColumnForRow.clear();
+}
+
+void LapSolver::initialize()
+{
+    mU.assign(mRows, 0.0);
+    mV.assign(mColumns, 0.0);
+    mColumnForRow.assign(mRows, -1);
+    mRowForColumn.assign(mColumns, -1);
+
+    mPathCost.assign(mColumns, LAP_INFINITY);
+    mPath    .assign(mColumns, -1);
+    mScanned .assign(mColumns, 0);
+    mRemaining.clear();
+    mScannedRows.clear();
+    mScannedColumns.clear();
+}
+
+double LapSolver::cost(int row, int column)
+{
+    if (!mSparse)
+        return mCost[row * mColumns + column];
+    if (mRowStart[row] == mRowStart[row + 1])
+        return LAP_INFINITY;
+
+    const int *begin = &mColumnIndex[0] + mRowStart[row];
+    const int *end   = &mColumnIndex[0] + mRowStart[row + 1];
+    const int *found = std::lower_bound(begin, end, column);
+    if (found == end || *found != column)
+        return LAP_INFINITY;
+    return mSparseCost[found - &mColumnIndex[0]];
+}
+
+double LapSolver::rowMinimum(int row, int *argmin)
+{
+    double minimum = LAP_INFINITY;
+    *argmin = -1;
+    if (!mSparse)
+    {
+        const double *costRow = &mCost[row * mColumns];
+        for (int j = 0; j < mColumns; j++)
+        {
+            double reduced = costRow[j] - mV[j];
+            if (reduced < minimum)
+            {
+                minimum = reduced;
+                *argmin = j;
+            }
+        }
+    }
+    else
+    {
+        for (int k = mRowStart[row]; k < mRowStart[row + 1]; k++)
+        {
+            int j = mColumnIndex[k];
+            double reduced = mSparseCost[k] - mV[j];
+            if (reduced < minimum)
+            {
+                minimum = reduced;
+                *argmin = j;
+            }
+        }
+    }
+    return minimum;
+}
+
+/**
+ *  The duals stay feasible, c(i,j) - u(i) - v(j) >= 0, for the assigned rows, and the assigned pairs are tight.
+ *  For the rectangular problem the free columns should also have v = 0 and the rest v <= 0, so the previous
+ *  duals are clamped, and the free columns are lifted to zero. Lifting can break the tightness of some kept
+ *  rows, these are released and their columns are lifted in turn.
+ **/
+void LapSolver::warmStart()
+{
+    if (!mWarmStart || !mHasPrevious || mPreviousTransposed != mTransposed)
+        return;
+
+    mStatistics.warmStarts++;
+    int known = CORE_MIN(mColumns, (int)mPreviousV.size());
+    for (int j = 0; j < known; j++)
+        mV[j] = CORE_MIN(mPreviousV[j], 0.0);
+
+    int rows = CORE_MIN(mRows, (int)mPreviousColumnForRow.size());
+    for (int i = 0; i < rows; i++)
+    {
+        int previous = mPreviousColumnForRow[i];
+        if (previous < 0 || previous >= mColumns || mRowForColumn[previous] != -1)
+            continue;
+
+        int argmin;
+        double minimum = rowMinimum(i, &argmin);
+        double own = cost(i, previous) - mV[previous];
+        if (own == LAP_INFINITY || own > minimum)
+            continue;
+
+        mU[i] = own;
+        mColumnForRow[i] = previous;
+        mRowForColumn[previous] = i;
+    }
+
+    for (int round = 0; ; round++)
+    {
+        bool lifted = false;
+        for (int j = 0; j < mColumns; j++)
+        {
+            if (mRowForColumn[j] == -1 && mV[j] < 0.0)
+            {
+                mV[j] = 0.0;
+                lifted = true;
+            }
+        }
+        if (!lifted)
+            break;
+
+        if (round == LAP_WARM_ROUNDS)
+        {
+            /* Cold start is cheaper than chasing the released rows further */
+            mU.assign(mRows, 0.0);
+            mV.assign(mColumns, 0.0);
+            mColumnForRow.assign(mRows, -1);
+            mRowForColumn.assign(mColumns, -1);
+            return;
+        }
+
+        for (int i = 0; i < mRows; i++)
+        {
+            int column = mColumnForRow[i];
+            if (column == -1)
+                continue;
+            int argmin;
+            double minimum = rowMinimum(i, &argmin);
+            if (cost(i, column) - mV[column] > minimum)
+            {
+                mColumnForRow[i] = -1;
+                mRowForColumn[column] = -1;
+                mU[i] = 0.0;
+            }
+            else
+            {
+                mU[i] = minimum;
+            }
+        }
+    }
+
+    for (int i = 0; i < mRows; i++)
+    {
+        if (mColumnForRow[i] != -1)
+            mStatistics.keptRows++;
+    }
+}
+
+/**
+ *  Dijkstra over the columns from the free row. Among the columns with the equal distance
+ *  the free one is preferred, so the search stops earlier.
+ *  \return the free column the path ends in or -1 if the row can't be assigned
+ **/
+int LapSolver::denseShortestPath(int row, double *minValue)
+{
+    mRemaining.resize(mColumns);
+    for (int j = 0; j < mColumns; j++)
+        mRemaining[j] = j;
+    int remaining = mColumns;
+
+    double minimum = 0.0;
+    int current = row;
+    int sink = -1;
+    while (sink == -1)
+    {
+        mScannedRows.push_back(current);
+        const double *costRow = &mCost[current * mColumns];
+        double uCurrent = mU[current];
+
+        double lowest = LAP_INFINITY;
+        int index = -1;
+        for (int k = 0; k < remaining; k++)
+        {
+            int j = mRemaining[k];
+            double reduced = minimum + costRow[j] - uCurrent - mV[j];
+            if (reduced < mPathCost[j])
+            {
+                mPath[j] = current;
+                mPathCost[j] = reduced;
+            }
+            if (mPathCost[j] < lowest || (mPathCost[j] == lowest && mRowForColumn[j] == -1))
+            {
+                lowest = mPathCost[j];
+                index = k;
+            }
+        }
+        mStatistics.scannedCosts += remaining;
+
+        if (lowest == LAP_INFINITY)
+        {
+            mRemaining.resize(remaining);
+            return -1;
+        }
+
+        minimum = lowest;
+        int j = mRemaining[index];
+        mRemaining[index] = mRemaining[--remaining];
+        mScannedColumns.push_back(j);
+        if (mRowForColumn[j] == -1)
+            sink = j;
+        else
+            current = mRowForColumn[j];
+    }
+    mRemaining.resize(remaining);
+    *minValue = minimum;
+    return sink;
+}
+
+/**
+ *  Same search, but only the columns reached through the candidates are kept in mRemaining
+ **/
+int LapSolver::sparseShortestPath(int row, double *minValue)
+{
+    mRemaining.clear();
+
+    double minimum = 0.0;
+    int current = row;
+    int sink = -1;
+    while (sink == -1)
+    {
+        mScannedRows.push_back(current);
+        double uCurrent = mU[current];
+        for (int k = mRowStart[current]; k < mRowStart[current + 1]; k++)
+        {
+            int j = mColumnIndex[k];
+            if (mScanned[j])
+                continue;
+            double reduced = minimum + mSparseCost[k] - uCurrent - mV[j];
+            if (reduced < mPathCost[j])
+            {
+                if (mPathCost[j] == LAP_INFINITY)
+                    mRemaining.push_back(j);
+                mPath[j] = current;
+                mPathCost[j] = reduced;
+            }
+        }
+        mStatistics.scannedCosts += mRowStart[current + 1] - mRowStart[current];
+
+        double lowest = LAP_INFINITY;
+        int index = -1;
+        for (size_t k = 0; k < mRemaining.size(); k++)
+        {
+            int j = mRemaining[k];
+            if (mPathCost[j] < lowest || (mPathCost[j] == lowest && mRowForColumn[j] == -1))
+            {
+                lowest = mPathCost[j];
+                index = (int)k;
+            }
+        }
+        if (index == -1)
+            return -1;
+
+        minimum = lowest;
+        int j = mRemaining[index];
+        mRemaining[index] = mRemaining.back();
+        mRemaining.pop_back();
+        mScanned[j] = 1;
+        mScannedColumns.push_back(j);
+        if (mRowForColumn[j] == -1)
+            sink = j;
+        else
+            current = mRowForColumn[j];
+    }
+    *minValue = minimum;
+    return sink;
+}
+
+/**
+ *  Lazy dual update of the scanned rows and columns, then the assignment is flipped along the path
+ **/
+void LapSolver::augment(int row, int sink, double minValue)
+{
+    mU[row] += minValue;
+    for (size_t k = 1; k < mScannedRows.size(); k++)
+    {
+        int i = mScannedRows[k];
+        mU[i] += minValue - mPathCost[mColumnForRow[i]];
+    }
+    for (size_t k = 0; k < mScannedColumns.size(); k++)
+    {
+        int j = mScannedColumns[k];
+        mV[j] -= minValue - mPathCost[j];
+    }
+
+    int j = sink;
+    while (true)
+    {
+        int i = mPath[j];
+        mRowForColumn[j] = i;
+        std::swap(mColumnForRow[i], j);
+        if (i == row)
+            break;
+    }
+}
+
+void LapSolver::clearPath()
+{
+    for (size_t k = 0; k < mScannedColumns.size(); k++)
+    {
+        int j = mScannedColumns[k];
+        mPathCost[j] = LAP_INFINITY;
+        mScanned[j] = 0;
+    }
+    for (size_t k = 0; k < mRemaining.size(); k++)
+        mPathCost[mRemaining[k]] = LAP_INFINITY;
+
+    mRemaining.clear();
+    mScannedRows.clear();
+    mScannedColumns.clear();
+}
+
+void LapSolver::run()
+{
+    for (int i = 0; i < mRows; i++)
+    {
+        if (mColumnForRow[i] != -1)
+            continue;
+
+        mU[i] = 0.0;
+        double minValue = 0.0;
+        int sink = mSparse ? sparseShortestPath(i, &minValue) : denseShortestPath(i, &minValue);
+        if (sink == -1)
+        {
+            mStatistics.unassignedRows++;
+        }
+        else
+        {
+            augment(i, sink, minValue);
+            mStatistics.augmentations++;
+        }
+        clearPath();
+    }
+
+    mHasPrevious = true;
+    mPreviousTransposed = mTransposed;
+    mPreviousV = mV;
+    mPreviousColumnForRow = mColumnForRow;
+    mStatistics.solves++;
+}
+
+template<typename BufferType>
+double LapSolver::solveDense(BufferType *costs, AbstractBuffer<int, int> *mapping)
+{
+    ASSERT_TRUE(costs != NULL && mapping != NULL, "Input and output should not be NULL");
+    ASSERT_TRUE(mapping->h >= costs->h, "Mapping should have a row for each row of costs");
+
+    PreciseTimerEx timer(&mStatistics.totalTime);
+
+    mSparse     = false;
+    mTransposed = costs->h > costs->w;
+    mRows       = mTransposed ? costs->w : costs->h;
+    mColumns    = mTransposed ? costs->h : costs->w;
+
+    mCost.resize(mRows * mColumns);
+    for (int i = 0; i < costs->h; i++)
+    {
+        for (int j = 0; j < costs->w; j++)
+        {
+            double value = (double)costs->element(i, j);
+            if (mTransposed)
+                mCost[j * mColumns + i] = value;
+            else
+                mCost[i * mColumns + j] = value;
+        }
+    }
+
+    initialize();
+    warmStart();
+    run();
+
+    for (int i = 0; i < costs->h; i++)
+        mapping->element(i, 0) = -1;
+
+    double total = 0.0;
+    for (int r = 0; r < mRows; r++)
+    {
+        int c = mColumnForRow[r];
+        if (c == -1)
+            continue;
+        int row    = mTransposed ? c : r;
+        int column = mTransposed ? r : c;
+        mapping->element(row, 0) = column;
+        total += (double)costs->element(row, column);
+    }
+
+    mStatistics.lastTime = timer.elapsed();
+    return total;
+}
+
+double LapSolver::solve(AbstractBuffer<double, int> *costs, AbstractBuffer<int, int> *mapping)
+{
+    return solveDense(costs, mapping);
+}
+
+double LapSolver::solve(AbstractBuffer<float, int> *costs, AbstractBuffer<int, int> *mapping)
+{
+    return solveDense(costs, mapping);
+}
+
+double LapSolver::solve(AbstractBuffer<int, int> *costs, AbstractBuffer<int, int> *mapping)
+{
+    return solveDense(costs, mapping);
+}
+
+double LapSolver::solveSparse(int rows, int columns, const vector<LapCandidate> &candidates, vector<int> &columnForRow)
+{
+    PreciseTimerEx timer(&mStatistics.totalTime);
+
+    mSparse     = true;
+    mTransposed = rows > columns;
+    mRows       = mTransposed ? columns : rows;
+    mColumns    = mTransposed ? rows : columns;
+
+    /* Counting sort by the column and then by the row, so the columns of each row are ordered */
+    vector<int> columnStart(mColumns + 1, 0);
+    mRowStart.assign(mRows + 1, 0);
+    for (size_t k = 0; k < candidates.size(); k++)
+    {
+        const LapCandidate &candidate = candidates[k];
+        ASSERT_TRUE(candidate.row >= 0 && candidate.row < rows && candidate.column >= 0 && candidate.column < columns,
+                    "Candidate is out of the problem");
+        int row    = mTransposed ? candidate.column : candidate.row;
+        int column = mTransposed ? candidate.row : candidate.column;
+        columnStart[column + 1]++;
+        mRowStart[row + 1]++;
+    }
+    for (int j = 0; j < mColumns; j++)
+        columnStart[j + 1] += columnStart[j];
+    for (int i = 0; i < mRows; i++)
+        mRowStart[i + 1] += mRowStart[i];
+
+    vector<int> byColumn(candidates.size());
+    for (size_t k = 0; k < candidates.size(); k++)
+    {
+        int column = mTransposed ? candidates[k].row : candidates[k].column;
+        byColumn[columnStart[column]++] = (int)k;
+    }
+
+    mColumnIndex.resize(candidates.size());
+    mSparseCost .resize(candidates.size());
+    vector<int> position(mRowStart.begin(), mRowStart.end() - 1);
+    for (size_t k = 0; k < byColumn.size(); k++)
+    {
+        const LapCandidate &candidate = candidates[byColumn[k]];
+        int row    = mTransposed ? candidate.column : candidate.row;
+        int column = mTransposed ? candidate.row : candidate.column;
+        mColumnIndex[position[row]] = column;
+        mSparseCost [position[row]] = candidate.cost;
+        position[row]++;
+    }
+
+    initialize();
+    warmStart();
+    run();
+
+    columnForRow.assign(rows, -1);
+    double total = 0.0;
+    for (int r = 0; r < mRows; r++)
+    {
+        int c = mColumnForRow[r];
+        if (c == -1)
+            continue;
+        total += cost(r, c);
+        if (mTransposed)
+            columnForRow[c] = r;
+        else
+            columnForRow[r] = c;
+    }
+
+    mStatistics.lastTime = timer.elapsed();
+    return total;
+}
+
+} //namespace corecvs
+
+/* EOF */
@@ -0,0 +1,168 @@
+#pragma once
+/**
+ * \file lapSolver.h
+ * \brief Jonker-Volgenant assignment solver with the warm start between the frames
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#include <stdint.h>
+#include <vector>
+
+#include "global.h"
+
+#include "abstractBuffer.h"
+
+namespace corecvs {
+
+using std::vector;
+
+/** Allowed pair of the sparse assignment problem */
+struct LapCandidate
+{
+    int    row;
+    int    column;
+    double cost;
+
+    LapCandidate(int _row = 0, int _column = 0, double _cost = 0.0) :
+        row(_row),
+        column(_column),
+        cost(_cost)
+    {}
+};
+
+/**
+ *  Linear assignment solver.
+ *
+ *  Rows are added one by one, each with the shortest augmenting path found by Dijkstra in the reduced costs
+ *  c(i,j) - u(i) - v(j), and the dual variables are updated lazily once per path, like in the
+ *  Jonker-Volgenant LAPJV. This is O(n^2 m) for the dense n x m problem.
+ *
+ *  The solver keeps the column duals and the assignment of the last call. With the warm start enabled, the next
+ *  call starts from them: the row keeps its previous column if that column is still the tight minimum of the
+ *  row, and only the rest of the rows are augmented. For the tracker, where the costs change slightly between
+ *  the frames, most of the rows are kept. The rows and columns are matched between the calls by their index.
+ *
+ *  Rectangular problems are supported, the smaller side is always assigned completely. The costs may be
+ *  infinite (std::numeric_limits<double>::infinity()) for the forbidden pairs, the rows that can't be assigned
+ *  then get -1. The result is the minimum cost assignment among the ones of the maximum size.
+ *
+ *  The sparse variant takes only the gated candidate pairs and never touches the rest of the matrix.
+ **/
+class LapSolver
+{
+public:
+    struct Statistics
+    {
+        uint64_t solves;
+        /** Solves that started from the previous state */
+        uint64_t warmStarts;
+        /** Rows that kept the assignment of the previous solve */
+        uint64_t keptRows;
+        uint64_t augmentations;
+        /** Reduced costs evaluated in the shortest path search */
+        uint64_t scannedCosts;
+        /** Rows left without the column */
+        uint64_t unassignedRows;
+        /** Time of the last solve and all the solves, usec */
+        uint64_t lastTime;
+        uint64_t totalTime;
+
+        Statistics() { reset(); }
+
+        void reset()
+        {
+            solves = warmStarts = keptRows = augmentations = scannedCosts = unassignedRows = 0;
+            lastTime = totalTime = 0;
+        }
+    };
+
+    LapSolver();
+
+    /**
+     * Dense problem. mapping is h x 1 and receives the column of each row or -1.
+     * \return total cost of the assignment
+     **/
+    double solve(AbstractBuffer<double, int> *costs, AbstractBuffer<int, int> *mapping);
+    double solve(AbstractBuffer<float, int> *costs, AbstractBuffer<int, int> *mapping);
+    double solve(AbstractBuffer<int, int> *costs, AbstractBuffer<int, int> *mapping);
+
+    /**
+     * Sparse problem of the given size, the pairs that are not listed are forbidden.
+     * There should be no duplicate pairs.
+     * \return total cost of the assignment
+     **/
+    double solveSparse(int rows, int columns, const vector<LapCandidate> &candidates, vector<int> &columnForRow);
+
+    void setWarmStart(bool warmStart)
+    {
+        mWarmStart = warmStart;
+    }
+
+    /** Forgets the state of the previous solve */
+    void reset();
+
+    Statistics &statistics()
+    {
+        return mStatistics;
+    }
+
+private:
+    bool mWarmStart;
+    Statistics mStatistics;
+
+    /* Problem of the current solve, rows are never more than columns */
+    int  mRows;
+    int  mColumns;
+    bool mTransposed;
+    bool mSparse;
+    /** Dense costs, mRows x mColumns */
+    vector<double> mCost;
+    /** Sparse costs, compressed rows */
+    vector<int>    mRowStart;
+    vector<int>    mColumnIndex;
+    vector<double> mSparseCost;
+
+    /* Duals and assignment */
+    vector<double> mU;
+    vector<double> mV;
+    vector<int>    mColumnForRow;
+    vector<int>    mRowForColumn;
+
+    /* State kept for the warm start */
+    bool           mHasPrevious;
+    bool           mPreviousTransposed;
+    vector<double> mPreviousV;
+    vector<int>    mPreviousColumnForRow;
+
+    /* Shortest path work arrays */
+    vector<double> mPathCost;
+    vector<int>    mPath;
+    vector<char>   mScanned;
+    vector<int>    mRemaining;
+    vector<int>    mScannedRows;
+    vector<int>    mScannedColumns;
+
+    template<typename BufferType>
+    double solveDense(BufferType *costs, AbstractBuffer<int, int> *mapping);
+
+    void   initialize();
+    void   warmStart();
+    double rowMinimum(int row, int *argmin);
+    double cost(int row, int column);
+
+    int    denseShortestPath (int row, double *minValue);
+    int    sparseShortestPath(int row, double *minValue);
+    void   augment(int row, int sink, double minValue);
+    void   clearPath();
+
+    void   run();
+
+    LapSolver(const LapSolver &);
+    LapSolver &operator=(const LapSolver &);
+};
+
+} //namespace corecvs
+
+/* EOF */
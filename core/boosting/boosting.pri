@@ -3,6 +3,7 @@ HEADERS += \
     boosting/cascadeClassifier.h \
     boosting/vjPattern.h \
     boosting/detectedObject.h \
+    boosting/vjTrainer.h \
     
 
 SOURCES += \
@@ -10,4 +11,5 @@ SOURCES += \
     boosting/cascadeClassifier.cpp \
     boosting/vjPattern.cpp \
     boosting/detectedObject.cpp \
+    boosting/vjTrainer.cpp \
 
@@ -1,24 +1,497 @@
 /**
  * \file cascadeClassifier.cpp
- * \brief This file should hold implentation for cascade classifier
+ * \brief Implementation of the multi-scale cascade detector
  *
  * \ingroup cppcorefiles
  * \date Jun 24, 2010
  * \author alexander
  */
 
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <math.h>
+
 #include "global.h"
 
 #include "cascadeClassifier.h"
+#include "mathUtils.h"
+#include "tbbWrapper.h"
+#include "zoneTracer.h"
+
+#ifdef WITH_SSE
+#include "sseWrapper.h"
+#endif
+
 namespace corecvs {
 
-CascadeClassifier::CascadeClassifier()
+#ifdef WITH_SSE
+ALIGN_STACK_SSE void CompiledCascade::evaluate4(const uint32_t *origin, int step, int32_t passed[4]) const
+{
+    Int32x4 alive((int32_t)-1);
+    Int32x4 stagesPassed((int32_t)0);
+    const Int32x4 one((int32_t)1);
+
+    for (unsigned s = 0; s < stages.size(); s++)
+    {
+        const Stage &stage = stages[s];
+        Int32x4 sum((int32_t)0);
+        for (int32_t f = stage.featuresStart; f < stage.featuresEnd; f++)
+        {
+            const Feature &feature = features[f];
+            const int32_t *offset = &offsets[feature.offsetsStart];
+
+            Int32x4 value((int32_t)0);
+            if (step == 1)
+            {
+                /* Neighbouring windows have neighbouring corners */
+                for (int32_t k = 0; k < feature.positiveNumber; k++)
+                    value += Int32x4(origin + *offset++);
+                for (int32_t k = 0; k < feature.negativeNumber; k++)
+                    value -= Int32x4(origin + *offset++);
+            }
+            else
+            {
+                for (int32_t k = 0; k < feature.positiveNumber; k++)
+                {
+                    const uint32_t *corner = origin + *offset++;
+                    value += Int32x4((int32_t)corner[0], (int32_t)corner[step], (int32_t)corner[2 * step], (int32_t)corner[3 * step]);
+                }
+                for (int32_t k = 0; k < feature.negativeNumber; k++)
+                {
+                    const uint32_t *corner = origin + *offset++;
+                    value -= Int32x4((int32_t)corner[0], (int32_t)corner[step], (int32_t)corner[2 * step], (int32_t)corner[3 * step]);
+                }
+            }
+
+            /* Branchless vote: failWeight, plus (passWeight - failWeight) where the feature is above the threshold */
+            Int32x4 isPassed = value > Int32x4(feature.threshold);
+            sum += Int32x4(feature.failWeight) + (isPassed & Int32x4(feature.passWeight - feature.failWeight));
+        }
+
+        alive &= (sum > Int32x4(stage.threshold));
+        stagesPassed += (alive & one);
+        if (alive.maskToInt2bit() == 0)
+            break;
+    }
+    stagesPassed.save(passed);
+}
+#endif
+
+CascadeClassifier::CascadeClassifier(int windowH, int windowW) :
+    mWindowH(windowH)
+  , mWindowW(windowW)
+  , mCompiledStride(0)
 {
 }
 
 CascadeClassifier::~CascadeClassifier()
 {
+    clearCompiled();
 }
 
-} //namespace corecvs
+void CascadeClassifier::addStage(const VJAdaBoostedClassifier &stage, double threshold)
+{
+    Stage newStage;
+    newStage.featuresStart = (int)mFeatures.size();
+    newStage.threshold     = threshold;
+
+    for (unsigned i = 0; i < stage.children.size(); i++)
+    {
+        const VJSimpleClassifier *child = stage.children[i];
+        const VJPattern *pattern = child->pattern;
+
+        Feature feature;
+        feature.cornersStart = (int)mCorners.size();
+        feature.threshold    = child->thershold;
+        feature.weight       = stage.weights[i];
+
+        for (unsigned j = 0; j < pattern->points.size(); j++)
+        {
+            const PatternCorner &point = pattern->points[j];
+            if (point.multiplier == 0)
+                continue;
+            Corner corner;
+            corner.x          = point.point.x();
+            corner.y          = point.point.y();
+            corner.multiplier = point.multiplier;
+            mCorners.push_back(corner);
+        }
+        feature.cornersEnd = (int)mCorners.size();
+        mFeatures.push_back(feature);
+    }
+
+    newStage.featuresEnd = (int)mFeatures.size();
+    mStages.push_back(newStage);
+    clearCompiled();
+}
+
+CompiledCascade *CascadeClassifier::compile(double scale, int32_t stride) const
+{
+    CompiledCascade *result = new CompiledCascade();
+    result->scale   = scale;
+    result->windowH = fround(mWindowH * scale);
+    result->windowW = fround(mWindowW * scale);
+    result->stride  = stride;
+
+    double weightScale = (double)(1 << CompiledCascade::WEIGHT_SHIFT);
+
+    for (unsigned s = 0; s < mStages.size(); s++)
+    {
+        const Stage &stage = mStages[s];
+        CompiledCascade::Stage compiledStage;
+        compiledStage.featuresStart = (int32_t)result->features.size();
+        compiledStage.threshold     = fround(stage.threshold * weightScale);
+
+        for (int f = stage.featuresStart; f < stage.featuresEnd; f++)
+        {
+            const Feature &feature = mFeatures[f];
+            CompiledCascade::Feature compiled;
+            compiled.offsetsStart   = (int32_t)result->offsets.size();
+            compiled.positiveNumber = 0;
+            compiled.negativeNumber = 0;
+            /* Sum over the area grows as the square of the scale */
+            compiled.threshold      = fround(feature.threshold * scale * scale);
+            compiled.passWeight     = fround( feature.weight * weightScale);
+            compiled.failWeight     = fround(-feature.weight * weightScale);
+
+            /* Positive corners go first, then negative ones */
+            for (int sign = 1; sign >= -1; sign -= 2)
+            {
+                for (int c = feature.cornersStart; c < feature.cornersEnd; c++)
+                {
+                    const Corner &corner = mCorners[c];
+                    if (corner.multiplier * sign <= 0)
+                        continue;
+
+                    int32_t offset = fround(corner.y * scale) * stride + fround(corner.x * scale);
+                    int repeat = corner.multiplier * sign;
+                    for (int k = 0; k < repeat; k++)
+                        result->offsets.push_back(offset);
+
+                    if (sign > 0)
+                        compiled.positiveNumber += repeat;
+                    else
+                        compiled.negativeNumber += repeat;
+                }
+            }
+            result->features.push_back(compiled);
+        }
+
+        compiledStage.featuresEnd = (int32_t)result->features.size();
+        result->stages.push_back(compiledStage);
+    }
+    return result;
+}
+
+void CascadeClassifier::clearCompiled()
+{
+    for (unsigned i = 0; i < mCompiled.size(); i++)
+        delete_safe(mCompiled[i]);
+    mCompiled.clear();
+}
+
+CompiledCascade *CascadeClassifier::compiledForScale(double scale, int32_t stride)
+{
+    if (stride != mCompiledStride)
+    {
+        clearCompiled();
+        mCompiledStride = stride;
+    }
+
+    for (unsigned i = 0; i < mCompiled.size(); i++)
+    {
+        if (fabs(mCompiled[i]->scale - scale) < 1e-9)
+            return mCompiled[i];
+    }
+
+    CompiledCascade *compiled = compile(scale, stride);
+    mCompiled.push_back(compiled);
+    return compiled;
+}
+
+/**
+ *  Scans the rows of windows of the single scale
+ **/
+class ParallelCascadeScan
+{
+public:
+    const CompiledCascade *compiled;
+    G12IntegralBuffer     *integral;
+    int                    step;
+    int                    columns;
+
+    vector<CascadeHit>     hits;
+    CascadeStatistics      stats;
+
+    ParallelCascadeScan(const CompiledCascade *_compiled, G12IntegralBuffer *_integral, int _step, int _columns) :
+        compiled(_compiled)
+      , integral(_integral)
+      , step(_step)
+      , columns(_columns)
+      , stats(_compiled->stagesNumber())
+    {}
+
+#ifdef WITH_TBB
+    ParallelCascadeScan(ParallelCascadeScan &other, tbb::split) :
+        compiled(other.compiled)
+      , integral(other.integral)
+      , step(other.step)
+      , columns(other.columns)
+      , stats(other.compiled->stagesNumber())
+    {}
+
+    void join(const ParallelCascadeScan &other)
+    {
+        hits.insert(hits.end(), other.hits.begin(), other.hits.end());
+        stats.add(other.stats);
+    }
+#endif
+
+    void addWindow(int y, int column, int stagesPassed)
+    {
+        stats.addWindow(stagesPassed);
+        if (stagesPassed == compiled->stagesNumber())
+            hits.push_back(CascadeHit(column * step, y, compiled->windowW, compiled->windowH, compiled->scale));
+    }
+
+    void operator()(const BlockedRange<int> &r)
+    {
+        int stagesNumber = compiled->stagesNumber();
+        for (int row = r.begin(); row < r.end(); row++)
+        {
+            int y = row * step;
+            const uint32_t *origin = &integral->element(y, 0);
 
+            int column = 0;
+#ifdef WITH_SSE
+            for (; column + 4 <= columns; column += 4)
+            {
+                ALIGN_DATA(16) int32_t passed[4];
+                compiled->evaluate4(origin + column * step, step, passed);
+                for (int lane = 0; lane < 4; lane++)
+                {
+                    if (passed[lane] == stagesNumber)
+                        addWindow(y, column + lane, passed[lane]);
+                    else
+                        stats.addWindow(passed[lane]);
+                }
+            }
+#endif
+            for (; column < columns; column++)
+            {
+                addWindow(y, column, compiled->evaluate(origin + column * step));
+            }
+        }
+    }
+};
+
+vector<DetectedObject> CascadeClassifier::detect(
+        G12IntegralBuffer *integral,
+        const CascadeDetectorParameters &params,
+        vector<CascadeHit> *hits)
+{
+    TRACE_ZONE("CascadeClassifier::detect");
+
+    stats.reset(stagesNumber());
+    vector<CascadeHit> allHits;
+
+    int h = integral->getEffectiveH();
+    int w = integral->getEffectiveW();
+
+    for (double scale = params.minScale; ; scale *= params.scaleFactor)
+    {
+        if (params.maxScale > 0.0 && scale > params.maxScale * (1.0 + 1e-9))
+            break;
+
+        CompiledCascade *compiled = compiledForScale(scale, integral->stride);
+        if (compiled->windowH > h || compiled->windowW > w || compiled->windowH <= 0 || compiled->windowW <= 0)
+            break;
+
+        int step    = CORE_MAX(1, fround(params.step * scale));
+        int rows    = (h - compiled->windowH) / step + 1;
+        int columns = (w - compiled->windowW) / step + 1;
+
+        ParallelCascadeScan scan(compiled, integral, step, columns);
+        parallelable_reduce(0, rows, scan);
+
+        allHits.insert(allHits.end(), scan.hits.begin(), scan.hits.end());
+        stats.add(scan.stats);
+
+        if (params.scaleFactor <= 1.0)
+            break;
+    }
+
+    /* Threads could deliver the hits in any order */
+    std::sort(allHits.begin(), allHits.end());
+    if (hits != NULL)
+        *hits = allHits;
+
+    return group(allHits, params.minNeighbours, params.groupEps);
+}
+
+static bool similarHits(const CascadeHit &a, const CascadeHit &b, double eps)
+{
+    double delta = eps * (CORE_MIN(a.w, b.w) + CORE_MIN(a.h, b.h)) * 0.5;
+    return abs(a.x - b.x) <= delta &&
+           abs(a.y - b.y) <= delta &&
+           abs(a.x + a.w - b.x - b.w) <= delta &&
+           abs(a.y + a.h - b.y - b.h) <= delta;
+}
+
+static int findRoot(vector<int> &parents, int i)
+{
+    while (parents[i] != i)
+    {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
+
+vector<DetectedObject> CascadeClassifier::group(const vector<CascadeHit> &hits, int minNeighbours, double eps)
+{
+    vector<DetectedObject> result;
+    if (minNeighbours <= 0)
+    {
+        for (unsigned i = 0; i < hits.size(); i++)
+        {
+            const CascadeHit &hit = hits[i];
+            result.push_back(DetectedObject(
+                    Vector2dd(hit.x + hit.w / 2.0, hit.y + hit.h / 2.0),
+                    Vector2dd(hit.w, hit.h)));
+        }
+        return result;
+    }
+
+    int n = (int)hits.size();
+    vector<int> parents(n);
+    for (int i = 0; i < n; i++)
+        parents[i] = i;
+
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = i + 1; j < n; j++)
+        {
+            if (!similarHits(hits[i], hits[j], eps))
+                continue;
+            int rootI = findRoot(parents, i);
+            int rootJ = findRoot(parents, j);
+            if (rootI != rootJ)
+                parents[rootJ] = rootI;
+        }
+    }
+
+    /* Mean window of each group */
+    vector<int>    counts(n, 0);
+    vector<double> sums(n * 4, 0.0);
+    for (int i = 0; i < n; i++)
+    {
+        int root = findRoot(parents, i);
+        counts[root]++;
+        sums[root * 4 + 0] += hits[i].x;
+        sums[root * 4 + 1] += hits[i].y;
+        sums[root * 4 + 2] += hits[i].w;
+        sums[root * 4 + 3] += hits[i].h;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        if (counts[i] == 0 || counts[i] < minNeighbours)
+            continue;
+        double x  = sums[i * 4 + 0] / counts[i];
+        double y  = sums[i * 4 + 1] / counts[i];
+        double gw = sums[i * 4 + 2] / counts[i];
+        double gh = sums[i * 4 + 3] / counts[i];
+        result.push_back(DetectedObject(Vector2dd(x + gw / 2.0, y + gh / 2.0), Vector2dd(gw, gh)));
+    }
+    return result;
+}
+
+void CascadeClassifier::save(std::ostream &out) const
+{
+    out << std::setprecision(17);
+    out << mWindowH << " " << mWindowW << " " << mStages.size() << "\n";
+    for (unsigned s = 0; s < mStages.size(); s++)
+    {
+        const Stage &stage = mStages[s];
+        out << stage.threshold << " " << (stage.featuresEnd - stage.featuresStart) << "\n";
+        for (int f = stage.featuresStart; f < stage.featuresEnd; f++)
+        {
+            const Feature &feature = mFeatures[f];
+            out << feature.threshold << " " << feature.weight << " " << (feature.cornersEnd - feature.cornersStart) << "\n";
+            for (int c = feature.cornersStart; c < feature.cornersEnd; c++)
+            {
+                out << mCorners[c].x << " " << mCorners[c].y << " " << mCorners[c].multiplier << "\n";
+            }
+        }
+    }
+}
+
+bool CascadeClassifier::load(std::istream &in)
+{
+    int windowH = 0, windowW = 0;
+    unsigned stagesNumber = 0;
+    in >> windowH >> windowW >> stagesNumber;
+    if (!in || windowH <= 0 || windowW <= 0)
+        return false;
+
+    vector<Corner>  corners;
+    vector<Feature> features;
+    vector<Stage>   stages;
+
+    for (unsigned s = 0; s < stagesNumber; s++)
+    {
+        Stage stage;
+        int featuresNumber = 0;
+        in >> stage.threshold >> featuresNumber;
+        stage.featuresStart = (int)features.size();
+        for (int f = 0; f < featuresNumber && in; f++)
+        {
+            Feature feature;
+            int cornersNumber = 0;
+            in >> feature.threshold >> feature.weight >> cornersNumber;
+            feature.cornersStart = (int)corners.size();
+            for (int c = 0; c < cornersNumber && in; c++)
+            {
+                Corner corner;
+                in >> corner.x >> corner.y >> corner.multiplier;
+                corners.push_back(corner);
+            }
+            feature.cornersEnd = (int)corners.size();
+            features.push_back(feature);
+        }
+        stage.featuresEnd = (int)features.size();
+        stages.push_back(stage);
+    }
+
+    if (!in)
+        return false;
+
+    mWindowH  = windowH;
+    mWindowW  = windowW;
+    mCorners  = corners;
+    mFeatures = features;
+    mStages   = stages;
+    clearCompiled();
+    return true;
+}
+
+bool CascadeClassifier::save(const string &fileName) const
+{
+    std::ofstream out(fileName.c_str());
+    if (!out)
+        return false;
+    save(out);
+    return out.good();
+}
+
+bool CascadeClassifier::load(const string &fileName)
+{
+    std::ifstream in(fileName.c_str());
+    if (!in)
+        return false;
+    return load(in);
+}
+
+} //namespace corecvs
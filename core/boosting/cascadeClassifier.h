@@ -1,6 +1,10 @@
 /**
  * \file cascadeClassifier.h
- * \brief This file should hold the header for cascade classifier
+ * \brief Multi-scale cascade detector built from the boosted Viola-Jones stages
+ *
+ * The stages are compiled for each scale into flat arrays of corner offsets
+ * against the stride of the integral buffer, so the detector scans all the scales over
+ * the same integral image without allocations and pointer chasing.
  *
  * \ingroup cppcorefiles
  * \date Jun 24, 2010
@@ -10,22 +14,293 @@
 #ifndef CASCADECLASSIFIER_H_
 #define CASCADECLASSIFIER_H_
 
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include <iostream>
+
 #include "global.h"
 
 #include "g12Buffer.h"
-#include "mipmapPyramid.h"
+#include "integralBuffer.h"
+#include "vjPattern.h"
+#include "detectedObject.h"
+
 namespace corecvs {
 
+using std::vector;
+using std::string;
+
+/**
+ *  The window that passed all the stages of the cascade
+ **/
+class CascadeHit
+{
+public:
+    int x;
+    int y;
+    int w;
+    int h;
+    double scale;
+
+    CascadeHit(int _x = 0, int _y = 0, int _w = 0, int _h = 0, double _scale = 1.0) :
+        x(_x), y(_y), w(_w), h(_h), scale(_scale)
+    {}
+
+    inline bool operator < (const CascadeHit &that) const
+    {
+        if (scale != that.scale) return scale < that.scale;
+        if (y     != that.y    ) return y     < that.y;
+        return x < that.x;
+    }
+};
+
+/**
+ *  Early reject statistics - how many windows each stage has rejected
+ **/
+class CascadeStatistics
+{
+public:
+    uint64_t windows;
+    uint64_t accepted;
+    vector<uint64_t> rejected;
+
+    CascadeStatistics(int stagesNumber = 0)
+    {
+        reset(stagesNumber);
+    }
+
+    void reset(int stagesNumber)
+    {
+        windows  = 0;
+        accepted = 0;
+        rejected.assign(stagesNumber, 0);
+    }
+
+    /** Takes into account the window that has passed the given number of stages */
+    void addWindow(int stagesPassed)
+    {
+        windows++;
+        if (stagesPassed == (int)rejected.size())
+            accepted++;
+        else
+            rejected[stagesPassed]++;
+    }
+
+    void add(const CascadeStatistics &other)
+    {
+        windows  += other.windows;
+        accepted += other.accepted;
+        if (rejected.size() < other.rejected.size())
+            rejected.resize(other.rejected.size(), 0);
+        for (unsigned i = 0; i < other.rejected.size(); i++)
+            rejected[i] += other.rejected[i];
+    }
+};
+
+/**
+ *  The cascade compiled for the single scale and the stride of the integral buffer.
+ *
+ *  Each feature is the sum of the integral buffer values at the positive offsets
+ *  minus the sum at the negative ones. Corners with the multiplier other than +-1
+ *  are repeated, so the evaluation needs only additions. Stage weights are fixed point
+ *  with WEIGHT_SHIFT fractional bits.
+ **/
+class CompiledCascade
+{
+public:
+    static const int WEIGHT_SHIFT = 16;
+
+    struct Feature
+    {
+        int32_t offsetsStart;
+        int32_t positiveNumber;
+        int32_t negativeNumber;
+        int32_t threshold;
+        int32_t passWeight;
+        int32_t failWeight;
+    };
+
+    struct Stage
+    {
+        int32_t featuresStart;
+        int32_t featuresEnd;
+        int32_t threshold;
+    };
+
+    double  scale;
+    int     windowH;
+    int     windowW;
+    int32_t stride;
+
+    vector<int32_t> offsets;
+    vector<Feature> features;
+    vector<Stage>   stages;
+
+    int stagesNumber() const
+    {
+        return (int)stages.size();
+    }
+
+    /**
+     * Returns the number of stages the window with the top left corner at origin has passed.
+     * The window is detected if all the stages are passed.
+     **/
+    int evaluate(const uint32_t *origin) const
+    {
+        for (unsigned s = 0; s < stages.size(); s++)
+        {
+            const Stage &stage = stages[s];
+            int32_t sum = 0;
+            for (int32_t f = stage.featuresStart; f < stage.featuresEnd; f++)
+            {
+                const Feature &feature = features[f];
+                const int32_t *offset = &offsets[feature.offsetsStart];
+
+                /* Integral values could overflow, but the differences are exact modulo 2^32 */
+                uint32_t value = 0;
+                for (int32_t k = 0; k < feature.positiveNumber; k++)
+                    value += origin[*offset++];
+                for (int32_t k = 0; k < feature.negativeNumber; k++)
+                    value -= origin[*offset++];
+
+                sum += ((int32_t)value > feature.threshold) ? feature.passWeight : feature.failWeight;
+            }
+            if (sum <= stage.threshold)
+                return s;
+        }
+        return stagesNumber();
+    }
+
+#ifdef WITH_SSE
+    /**
+     * Evaluates 4 windows at origin, origin + step, origin + 2 * step and origin + 3 * step
+     * at once. Stops as soon as all of them are rejected.
+     **/
+    void evaluate4(const uint32_t *origin, int step, int32_t passed[4]) const;
+#endif
+};
+
+/**
+ *  Parameters of the multi-scale scan
+ **/
+class CascadeDetectorParameters
+{
+public:
+    double minScale;      /**< Scale of the smallest window relative to the trained one */
+    double maxScale;      /**< Scale of the largest window, zero means as large as the image */
+    double scaleFactor;   /**< Ratio of the neighbouring scales */
+    int    step;          /**< Window step at the scale 1.0, it grows together with the scale */
+    int    minNeighbours; /**< Groups with less hits are discarded. Zero disables grouping */
+    double groupEps;      /**< Relative tolerance of the window corners in one group */
+
+    CascadeDetectorParameters() :
+        minScale(1.0)
+      , maxScale(0.0)
+      , scaleFactor(1.25)
+      , step(1)
+      , minNeighbours(2)
+      , groupEps(0.2)
+    {}
+};
+
 class CascadeClassifier
 {
 public:
-    //AbstractMidmapPyramid<G12Buffer> *
+    CascadeStatistics stats; /**< Statistics of the last detect() call */
 
-    CascadeClassifier();
+    /**
+     * \param windowH height of the window the stages were trained for
+     * \param windowW width of the window the stages were trained for
+     **/
+    CascadeClassifier(int windowH, int windowW);
     virtual ~CascadeClassifier();
+
+    /**
+     * Appends the boosted classifier as the next stage. The window passes the stage
+     * if the weighted vote of its weak classifiers is above the threshold.
+     **/
+    void addStage(const VJAdaBoostedClassifier &stage, double threshold = 0.0);
+
+    int stagesNumber() const
+    {
+        return (int)mStages.size();
+    }
+
+    int windowH() const { return mWindowH; }
+    int windowW() const { return mWindowW; }
+
+    /**
+     * Compiles the cascade for the given scale and integral buffer stride. The caller owns the result.
+     **/
+    CompiledCascade *compile(double scale, int32_t stride) const;
+
+    /**
+     * Scans the integral buffer at all the scales, rows of windows are processed in parallel.
+     * Raw hits are returned in the optional vector sorted by scale and position.
+     **/
+    vector<DetectedObject> detect(
+            G12IntegralBuffer *integral,
+            const CascadeDetectorParameters &params = CascadeDetectorParameters(),
+            vector<CascadeHit> *hits = NULL);
+
+    /**
+     * Joins the hits with similar windows. Each group with at least minNeighbours hits
+     * becomes an object with the mean window. If minNeighbours is zero every hit is an object.
+     **/
+    static vector<DetectedObject> group(const vector<CascadeHit> &hits, int minNeighbours, double eps);
+
+    /**
+     * Text format: the window size and the number of stages, then for each stage its threshold
+     * and the number of features, and for each feature its threshold, weight and corners.
+     **/
+    void save(std::ostream &out) const;
+    bool load(std::istream &in);
+
+    bool save(const string &fileName) const;
+    bool load(const string &fileName);
+
+private:
+    struct Corner
+    {
+        int32_t x;
+        int32_t y;
+        int32_t multiplier;
+    };
+
+    struct Feature
+    {
+        int    cornersStart;
+        int    cornersEnd;
+        int    threshold;
+        double weight;
+    };
+
+    struct Stage
+    {
+        int    featuresStart;
+        int    featuresEnd;
+        double threshold;
+    };
+
+    int mWindowH;
+    int mWindowW;
+
+    vector<Corner>  mCorners;
+    vector<Feature> mFeatures;
+    vector<Stage>   mStages;
+
+    /** Compiled scales of the last stride */
+    vector<CompiledCascade *> mCompiled;
+    int32_t mCompiledStride;
+
+    void clearCompiled();
+    CompiledCascade *compiledForScale(double scale, int32_t stride);
+
+    CascadeClassifier(const CascadeClassifier &);
+    CascadeClassifier &operator =(const CascadeClassifier &);
 };
 
 
 } //namespace corecvs
 #endif /* CASCADECLASSIFIER_H_ */
-
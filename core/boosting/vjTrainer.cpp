@@ -0,0 +1,536 @@
+/**
+ * \file vjTrainer.cpp
+ * \brief Implementation of the Viola-Jones cascade trainer
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#include <algorithm>
+#include <stdlib.h>
+#include <math.h>
+
+#include "global.h"
+
+#include "vjTrainer.h"
+#include "tbbWrapper.h"
+#include "zoneTracer.h"
+
+namespace corecvs {
+
+/* VJSampleSet */
+
+VJSampleSet::VJSampleSet(int windowH, int windowW) :
+    mWindowH(windowH)
+  , mWindowW(windowW)
+  , mArea((windowH + 1) * (windowW + 1))
+{
+}
+
+void VJSampleSet::add(G12Buffer *window, bool isPositive)
+{
+    ASSERT_TRUE(window->h == mWindowH && window->w == mWindowW, "Wrong size of the training window");
+
+    G12IntegralBuffer integral(window);
+    for (int i = 0; i <= mWindowH; i++)
+        for (int j = 0; j <= mWindowW; j++)
+            mData.push_back(integral.element(i, j));
+    mLabels.push_back(isPositive);
+}
+
+void VJSampleSet::addResampled(G12IntegralBuffer *integral, int x, int y, int w, int h, bool isPositive)
+{
+    G12Buffer window(mWindowH, mWindowW, false);
+    for (int i = 0; i < mWindowH; i++)
+    {
+        int y1 = y + (i * h) / mWindowH;
+        int y2 = CORE_MAX(y1, y + ((i + 1) * h) / mWindowH - 1);
+        for (int j = 0; j < mWindowW; j++)
+        {
+            int x1 = x + (j * w) / mWindowW;
+            int x2 = CORE_MAX(x1, x + ((j + 1) * w) / mWindowW - 1);
+            uint32_t area = (y2 - y1 + 1) * (x2 - x1 + 1);
+            window.element(i, j) = integral->rectangle(x1, y1, x2, y2) / area;
+        }
+    }
+    add(&window, isPositive);
+}
+
+void VJSampleSet::add(const VJSampleSet &other, int sample)
+{
+    ASSERT_TRUE(other.mArea == mArea, "Sample sets have different window sizes");
+    const uint32_t *data = other.integral(sample);
+    mData.insert(mData.end(), data, data + mArea);
+    mLabels.push_back(other.mLabels[sample]);
+}
+
+int VJSampleSet::positiveNumber() const
+{
+    int count = 0;
+    for (unsigned i = 0; i < mLabels.size(); i++)
+        if (mLabels[i])
+            count++;
+    return count;
+}
+
+/* VJFeatureResponses */
+
+int32_t VJFeatureResponses::evaluate(const VJPattern *pattern, const uint32_t *integral, int stride)
+{
+    uint32_t sum = 0;
+    for (unsigned i = 0; i < pattern->points.size(); i++)
+    {
+        const PatternCorner &corner = pattern->points[i];
+        sum += (uint32_t)corner.multiplier * integral[corner.point.y() * stride + corner.point.x()];
+    }
+    return (int32_t)sum;
+}
+
+class ParallelComputeResponses
+{
+public:
+    const VJSampleSet         *samples;
+    const vector<VJPattern *> *features;
+    int32_t                   *values;
+    int32_t                   *sorted;
+
+    ParallelComputeResponses(const VJSampleSet *_samples, const vector<VJPattern *> *_features, int32_t *_values, int32_t *_sorted) :
+        samples(_samples)
+      , features(_features)
+      , values(_values)
+      , sorted(_sorted)
+    {}
+
+    void operator()(const BlockedRange<int> &r) const
+    {
+        int n      = samples->size();
+        int stride = samples->integralStride();
+
+        vector<int32_t> offsets;
+        vector<int32_t> multipliers;
+        vector<int64_t> keys(n);
+
+        for (int f = r.begin(); f < r.end(); f++)
+        {
+            /* Flatten the pattern once for all the samples */
+            const VJPattern *pattern = (*features)[f];
+            offsets.clear();
+            multipliers.clear();
+            for (unsigned i = 0; i < pattern->points.size(); i++)
+            {
+                const PatternCorner &corner = pattern->points[i];
+                offsets    .push_back(corner.point.y() * stride + corner.point.x());
+                multipliers.push_back(corner.multiplier);
+            }
+
+            int32_t *featureValues = values + (size_t)f * n;
+            for (int s = 0; s < n; s++)
+            {
+                const uint32_t *integral = samples->integral(s);
+                uint32_t sum = 0;
+                for (unsigned k = 0; k < offsets.size(); k++)
+                    sum += (uint32_t)multipliers[k] * integral[offsets[k]];
+                featureValues[s] = (int32_t)sum;
+
+                /* Value in the high half and the index in the low one, so one sort of int64 is enough */
+                keys[s] = (int64_t)featureValues[s] * ((int64_t)1 << 32) + s;
+            }
+
+            std::sort(keys.begin(), keys.end());
+            int32_t *featureSorted = sorted + (size_t)f * n;
+            for (int s = 0; s < n; s++)
+                featureSorted[s] = (int32_t)(keys[s] & 0xFFFFFFFF);
+        }
+    }
+};
+
+void VJFeatureResponses::compute(const VJSampleSet &samples, const vector<VJPattern *> &features)
+{
+    TRACE_ZONE("VJFeatureResponses::compute");
+
+    mFeaturesNumber = (int)features.size();
+    mSamplesNumber  = samples.size();
+    mValues.resize((size_t)mFeaturesNumber * mSamplesNumber);
+    mSorted.resize((size_t)mFeaturesNumber * mSamplesNumber);
+
+    if (mSamplesNumber == 0)
+        return;
+
+    parallelable_for(0, mFeaturesNumber, 8, ParallelComputeResponses(&samples, &features, &mValues[0], &mSorted[0]));
+}
+
+/* VJCascadeTrainer */
+
+class ParallelFindBestFeature
+{
+public:
+    const VJFeatureResponses *responses;
+    const VJSampleSet        *samples;
+    const vector<double>     *weights;
+    double positiveTotal;
+    double negativeTotal;
+
+    VJWeakSearchResult best;
+
+    ParallelFindBestFeature(const VJFeatureResponses *_responses, const VJSampleSet *_samples, const vector<double> *_weights,
+                            double _positiveTotal, double _negativeTotal) :
+        responses(_responses)
+      , samples(_samples)
+      , weights(_weights)
+      , positiveTotal(_positiveTotal)
+      , negativeTotal(_negativeTotal)
+    {}
+
+#ifdef WITH_TBB
+    ParallelFindBestFeature(ParallelFindBestFeature &other, tbb::split) :
+        responses(other.responses)
+      , samples(other.samples)
+      , weights(other.weights)
+      , positiveTotal(other.positiveTotal)
+      , negativeTotal(other.negativeTotal)
+    {}
+
+    void join(const ParallelFindBestFeature &other)
+    {
+        consider(other.best);
+    }
+#endif
+
+    /* Ties are resolved by the feature index, so the result does not depend on the split */
+    void consider(const VJWeakSearchResult &candidate)
+    {
+        if (candidate.feature < 0)
+            return;
+        if (best.feature < 0 || candidate.error < best.error ||
+           (candidate.error == best.error && candidate.feature < best.feature))
+        {
+            best = candidate;
+        }
+    }
+
+    void operator()(const BlockedRange<int> &r)
+    {
+        int n = samples->size();
+        const double *w = &(*weights)[0];
+
+        for (int f = r.begin(); f < r.end(); f++)
+        {
+            const int32_t *values = responses->values(f);
+            const int32_t *sorted = responses->sorted(f);
+
+            VJWeakSearchResult local;
+            local.feature = f;
+
+            /* Threshold below all the responses: everything is positive, or everything is negative */
+            local.threshold = (int32_t)((int64_t)values[sorted[0]] - 1);
+            local.inverted  = false;
+            local.error     = negativeTotal;
+            if (positiveTotal < local.error)
+            {
+                local.threshold = values[sorted[0]];
+                local.inverted  = true;
+                local.error     = positiveTotal;
+            }
+
+            double positiveBelow = 0.0;
+            double negativeBelow = 0.0;
+            for (int k = 0; k < n; k++)
+            {
+                int s = sorted[k];
+                if (samples->isPositive(s))
+                    positiveBelow += w[s];
+                else
+                    negativeBelow += w[s];
+
+                /* Only split between the different responses */
+                int64_t a = values[s];
+                if (k + 1 < n && values[sorted[k + 1]] == a)
+                    continue;
+                int64_t b = (k + 1 < n) ? values[sorted[k + 1]] : a + 2;
+
+                double aboveError = positiveBelow + (negativeTotal - negativeBelow);
+                double belowError = (positiveTotal - positiveBelow) + negativeBelow;
+
+                if (aboveError < local.error)
+                {
+                    local.error     = aboveError;
+                    local.inverted  = false;
+                    local.threshold = (int32_t)(a + (b - a) / 2);
+                }
+                if (belowError < local.error)
+                {
+                    local.error     = belowError;
+                    local.inverted  = true;
+                    local.threshold = (int32_t)(a + (b - a + 1) / 2);
+                }
+            }
+            consider(local);
+        }
+    }
+};
+
+VJWeakSearchResult VJCascadeTrainer::findBestFeature(
+        const VJFeatureResponses &responses,
+        const VJSampleSet &samples,
+        const vector<double> &weights)
+{
+    TRACE_ZONE("VJCascadeTrainer::findBestFeature");
+
+    double positiveTotal = 0.0;
+    double negativeTotal = 0.0;
+    for (int s = 0; s < samples.size(); s++)
+    {
+        if (samples.isPositive(s))
+            positiveTotal += weights[s];
+        else
+            negativeTotal += weights[s];
+    }
+
+    ParallelFindBestFeature search(&responses, &samples, &weights, positiveTotal, negativeTotal);
+    if (samples.size() != 0)
+        parallelable_reduce(0, responses.featuresNumber(), search);
+    return search.best;
+}
+
+vector<VJPattern *> VJCascadeTrainer::generateFeatures(int windowH, int windowW, int number, unsigned seed)
+{
+    vector<VJPatternGenerator *> generators;
+    generators.push_back(new HorizontalPattern2(windowH, windowW));
+    generators.push_back(new VerticalPattern2  (windowH, windowW));
+    generators.push_back(new SquarePattern2    (windowH, windowW));
+    generators.push_back(new VerticalPattern3  (windowH, windowW));
+    generators.push_back(new HorizontalPattern3(windowH, windowW));
+
+    srand(seed);
+    vector<VJPattern *> result;
+    for (int i = 0; i < number; i++)
+    {
+        result.push_back(generators[rand() % generators.size()]->pattern());
+    }
+
+    for (unsigned i = 0; i < generators.size(); i++)
+        delete_safe(generators[i]);
+    return result;
+}
+
+VJCascadeTrainer::VJCascadeTrainer(int windowH, int windowW, const VJCascadeTrainerParameters &_params) :
+    params(_params)
+  , mWindowH(windowH)
+  , mWindowW(windowW)
+  , mCascade(windowH, windowW)
+  , mPositives(windowH, windowW)
+  , mSamples(windowH, windowW)
+{
+}
+
+VJCascadeTrainer::~VJCascadeTrainer()
+{
+    for (unsigned i = 0; i < mFeatures.size(); i++)
+        delete_safe(mFeatures[i]);
+}
+
+void VJCascadeTrainer::addPositive(G12Buffer *window)
+{
+    mPositives.add(window, true);
+}
+
+void VJCascadeTrainer::addBackground(G12Buffer *image)
+{
+    mBackgrounds.push_back(image);
+}
+
+bool VJCascadeTrainer::train()
+{
+    if (mPositives.size() == 0 || mBackgrounds.empty())
+        return false;
+
+    if (!params.checkpointFile.empty() && mCascade.stagesNumber() == 0)
+    {
+        CascadeClassifier checkpoint(mWindowH, mWindowW);
+        if (checkpoint.load(params.checkpointFile) &&
+            checkpoint.windowH() == mWindowH && checkpoint.windowW() == mWindowW)
+        {
+            mCascade.load(params.checkpointFile);
+            SYNC_PRINT(("VJCascadeTrainer::train(): resuming from %d stages\n", mCascade.stagesNumber()));
+        }
+    }
+
+    if (mFeatures.empty())
+        mFeatures = generateFeatures(mWindowH, mWindowW, params.featuresNumber, params.seed);
+
+    while (mCascade.stagesNumber() < params.stagesNumber)
+    {
+        /* Positives that the cascade still accepts */
+        mSamples = VJSampleSet(mWindowH, mWindowW);
+        CompiledCascade *compiled = mCascade.compile(1.0, mPositives.integralStride());
+        for (int s = 0; s < mPositives.size(); s++)
+        {
+            if (compiled->evaluate(mPositives.integral(s)) == compiled->stagesNumber())
+                mSamples.add(mPositives, s);
+        }
+        delete_safe(compiled);
+
+        int positives = mSamples.size();
+        bootstrapNegatives(params.negativesNumber);
+        int negatives = mSamples.size() - positives;
+
+        SYNC_PRINT(("VJCascadeTrainer::train(): stage %d on %d positives and %d negatives\n",
+                    mCascade.stagesNumber(), positives, negatives));
+
+        if (positives == 0 || negatives == 0)
+            break;
+
+        trainStage();
+
+        if (!params.checkpointFile.empty())
+            mCascade.save(params.checkpointFile);
+    }
+    return true;
+}
+
+struct NegativeCandidate
+{
+    int        image;
+    CascadeHit hit;
+
+    bool operator < (const NegativeCandidate &that) const
+    {
+        return image < that.image;
+    }
+};
+
+void VJCascadeTrainer::bootstrapNegatives(int needed)
+{
+    TRACE_ZONE("VJCascadeTrainer::bootstrapNegatives");
+
+    CascadeDetectorParameters detectorParams;
+    detectorParams.step          = params.negativeStep;
+    detectorParams.minNeighbours = 0;
+
+    /* Reservoir sampling over the windows that pass the cascade, so only the chosen ones are stored */
+    srand(params.seed + mCascade.stagesNumber());
+    vector<NegativeCandidate> chosen;
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < mBackgrounds.size(); i++)
+    {
+        G12IntegralBuffer integral(mBackgrounds[i]);
+        vector<CascadeHit> hits;
+        mCascade.detect(&integral, detectorParams, &hits);
+
+        for (unsigned j = 0; j < hits.size(); j++)
+        {
+            NegativeCandidate candidate;
+            candidate.image = i;
+            candidate.hit   = hits[j];
+
+            seen++;
+            if ((int)chosen.size() < needed)
+            {
+                chosen.push_back(candidate);
+                continue;
+            }
+            uint64_t slot = (((uint64_t)rand() << 31) ^ (uint64_t)rand()) % seen;
+            if (slot < (uint64_t)needed)
+                chosen[slot] = candidate;
+        }
+    }
+
+    std::stable_sort(chosen.begin(), chosen.end());
+    for (unsigned k = 0; k < chosen.size(); )
+    {
+        int image = chosen[k].image;
+        G12IntegralBuffer integral(mBackgrounds[image]);
+        for (; k < chosen.size() && chosen[k].image == image; k++)
+        {
+            const CascadeHit &hit = chosen[k].hit;
+            mSamples.addResampled(&integral, hit.x, hit.y, hit.w, hit.h, false);
+        }
+    }
+}
+
+void VJCascadeTrainer::trainStage()
+{
+    TRACE_ZONE("VJCascadeTrainer::trainStage");
+
+    int n         = mSamples.size();
+    int positives = mSamples.positiveNumber();
+    int negatives = n - positives;
+
+    vector<double> weights(n);
+    for (int s = 0; s < n; s++)
+        weights[s] = mSamples.isPositive(s) ? 0.5 / positives : 0.5 / negatives;
+
+    VJFeatureResponses responses;
+    responses.compute(mSamples, mFeatures);
+
+    vector<double> scores(n, 0.0);
+    vector<double> positiveScores;
+    double threshold = 0.0;
+
+    VJAdaBoostedClassifier stage;
+    for (int weak = 0; weak < params.maxWeakNumber; weak++)
+    {
+        double sum = 0.0;
+        for (int s = 0; s < n; s++)
+            sum += weights[s];
+        for (int s = 0; s < n; s++)
+            weights[s] /= sum;
+
+        VJWeakSearchResult best = findBestFeature(responses, mSamples, weights);
+        double error = CORE_MAX(1e-10, CORE_MIN(best.error, 1.0 - 1e-10));
+        double alpha = 0.5 * log((1.0 - error) / error);
+
+        const int32_t *values = responses.values(best.feature);
+        for (int s = 0; s < n; s++)
+        {
+            int prediction = best.predict(values[s]) ? 1 : -1;
+            int truth      = mSamples.isPositive(s)  ? 1 : -1;
+            weights[s] *= exp(-alpha * prediction * truth);
+            scores [s] += alpha * prediction;
+        }
+
+        /* VJSimpleClassifier accepts values above the threshold, so the inverted feature is negated */
+        const VJPattern *feature = mFeatures[best.feature];
+        VJPattern *pattern = new VJPattern();
+        for (unsigned i = 0; i < feature->points.size(); i++)
+        {
+            PatternCorner corner = feature->points[i];
+            if (best.inverted)
+                corner.multiplier = -corner.multiplier;
+            pattern->points.push_back(corner);
+        }
+        int patternThreshold = best.inverted ? -best.threshold : best.threshold;
+        stage.addClassifier(new VJSimpleClassifier(pattern, patternThreshold, 0, 0, mWindowH, mWindowW), alpha);
+
+        /*
+         * Stage threshold keeps minHitRate of the positives. The margin covers the rounding
+         * of the weights when the cascade is compiled to the fixed point.
+         */
+        positiveScores.clear();
+        for (int s = 0; s < n; s++)
+            if (mSamples.isPositive(s))
+                positiveScores.push_back(scores[s]);
+        std::sort(positiveScores.begin(), positiveScores.end());
+        int lost = CORE_MAX(0, CORE_MIN(positives - 1, (int)floor((1.0 - params.minHitRate) * positives)));
+        double margin = (weak + 2) / (double)(1 << CompiledCascade::WEIGHT_SHIFT);
+        threshold = positiveScores[lost] - margin;
+
+        int falseAlarms = 0;
+        for (int s = 0; s < n; s++)
+            if (!mSamples.isPositive(s) && scores[s] > threshold)
+                falseAlarms++;
+
+        if (falseAlarms <= params.maxFalseAlarm * negatives)
+            break;
+    }
+
+    mCascade.addStage(stage, threshold);
+
+    for (unsigned i = 0; i < stage.children.size(); i++)
+    {
+        delete_safe(stage.children[i]->pattern);
+        delete_safe(stage.children[i]);
+    }
+}
+
+} //namespace corecvs
@@ -0,0 +1,243 @@
+#pragma once
+/**
+ * \file vjTrainer.h
+ * \brief Viola-Jones cascade trainer with bulk evaluated and presorted feature responses
+ *
+ * For each stage the responses of all the candidate features on all the samples are
+ * evaluated once and sorted once. Every boosting round then finds the best weak classifier
+ * of each feature with the single weighted sweep over its sorted responses, features are
+ * processed in parallel. Between the stages the negatives are bootstrapped from the
+ * background images with the cascade trained so far, and the cascade is checkpointed.
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+
+#include "global.h"
+
+#include "g12Buffer.h"
+#include "integralBuffer.h"
+#include "vjPattern.h"
+#include "cascadeClassifier.h"
+
+namespace corecvs {
+
+using std::vector;
+using std::string;
+
+/**
+ *  Training windows stored as the integral images in the one compact array
+ **/
+class VJSampleSet
+{
+public:
+    VJSampleSet(int windowH, int windowW);
+
+    /** Adds the window of exactly windowH x windowW */
+    void add(G12Buffer *window, bool isPositive);
+
+    /**
+     * Adds the window of the image given by its rectangle in the integral buffer of the image.
+     * The window is resampled to windowH x windowW by averaging.
+     **/
+    void addResampled(G12IntegralBuffer *integral, int x, int y, int w, int h, bool isPositive);
+
+    /** Copies the sample of the other set of the same window size */
+    void add(const VJSampleSet &other, int sample);
+
+    int size() const
+    {
+        return (int)mLabels.size();
+    }
+
+    int positiveNumber() const;
+
+    bool isPositive(int sample) const
+    {
+        return mLabels[sample] != 0;
+    }
+
+    /** Integral image of the sample, its stride is integralStride() */
+    const uint32_t *integral(int sample) const
+    {
+        return &mData[(size_t)sample * mArea];
+    }
+
+    int integralStride() const
+    {
+        return mWindowW + 1;
+    }
+
+    int windowH() const { return mWindowH; }
+    int windowW() const { return mWindowW; }
+
+private:
+    int mWindowH;
+    int mWindowW;
+    int mArea;
+
+    vector<uint32_t> mData;
+    vector<char>     mLabels;
+};
+
+/**
+ *  Responses of the candidate features on the sample set. Both the values and the order
+ *  of the samples by value are stored feature by feature in flat int32 arrays.
+ **/
+class VJFeatureResponses
+{
+public:
+    VJFeatureResponses() :
+        mFeaturesNumber(0),
+        mSamplesNumber(0)
+    {}
+
+    /** Evaluates and sorts the responses, features are processed in parallel */
+    void compute(const VJSampleSet &samples, const vector<VJPattern *> &features);
+
+    int featuresNumber() const { return mFeaturesNumber; }
+    int samplesNumber()  const { return mSamplesNumber; }
+
+    int32_t value(int feature, int sample) const
+    {
+        return mValues[(size_t)feature * mSamplesNumber + sample];
+    }
+
+    const int32_t *values(int feature) const
+    {
+        return &mValues[(size_t)feature * mSamplesNumber];
+    }
+
+    /** Sample indexes in the ascending order of the feature response */
+    const int32_t *sorted(int feature) const
+    {
+        return &mSorted[(size_t)feature * mSamplesNumber];
+    }
+
+    /** Evaluates the pattern on one sample */
+    static int32_t evaluate(const VJPattern *pattern, const uint32_t *integral, int stride);
+
+private:
+    int mFeaturesNumber;
+    int mSamplesNumber;
+
+    vector<int32_t> mValues;
+    vector<int32_t> mSorted;
+};
+
+/**
+ *  The best threshold of the single feature.
+ *  If inverted is false the samples with the response above the threshold are positive,
+ *  otherwise the ones below it.
+ **/
+class VJWeakSearchResult
+{
+public:
+    int     feature;
+    int32_t threshold;
+    bool    inverted;
+    double  error;
+
+    VJWeakSearchResult() :
+        feature(-1),
+        threshold(0),
+        inverted(false),
+        error(1.0)
+    {}
+
+    bool predict(int32_t value) const
+    {
+        return inverted ? (value < threshold) : (value > threshold);
+    }
+};
+
+class VJCascadeTrainerParameters
+{
+public:
+    int    featuresNumber;    /**< Number of the random candidate features */
+    int    stagesNumber;      /**< Target number of the stages */
+    int    maxWeakNumber;     /**< Limit of the weak classifiers in one stage */
+    double minHitRate;        /**< Each stage keeps at least this fraction of the positives */
+    double maxFalseAlarm;     /**< Stage is finished once it passes no more than this fraction of the negatives */
+    int    negativesNumber;   /**< Number of the negatives each stage is trained on */
+    int    negativeStep;      /**< Step of the windows when the negatives are bootstrapped */
+    unsigned seed;
+    string checkpointFile;    /**< The cascade is saved here after every stage and resumed from here. Empty to disable */
+
+    VJCascadeTrainerParameters() :
+        featuresNumber(2000)
+      , stagesNumber(10)
+      , maxWeakNumber(200)
+      , minHitRate(0.995)
+      , maxFalseAlarm(0.5)
+      , negativesNumber(5000)
+      , negativeStep(4)
+      , seed(1)
+    {}
+};
+
+class VJCascadeTrainer
+{
+public:
+    VJCascadeTrainerParameters params;
+
+    VJCascadeTrainer(int windowH, int windowW, const VJCascadeTrainerParameters &params = VJCascadeTrainerParameters());
+    virtual ~VJCascadeTrainer();
+
+    /** Adds the positive window, it should be exactly windowH x windowW */
+    void addPositive(G12Buffer *window);
+
+    /** Adds the background image the negatives are bootstrapped from. Does not take ownership */
+    void addBackground(G12Buffer *image);
+
+    /**
+     * Trains the stages up to params.stagesNumber. If the checkpoint file exists the
+     * training continues from the stages stored in it.
+     * \return false if there was nothing to train on
+     **/
+    bool train();
+
+    CascadeClassifier *cascade()
+    {
+        return &mCascade;
+    }
+
+    /**
+     * Finds the feature and the threshold with the least weighted error.
+     * Each feature is swept once over its sorted responses, features are processed in parallel.
+     **/
+    static VJWeakSearchResult findBestFeature(
+            const VJFeatureResponses &responses,
+            const VJSampleSet &samples,
+            const vector<double> &weights);
+
+    /** Creates the candidate features with the VJ pattern generators */
+    static vector<VJPattern *> generateFeatures(int windowH, int windowW, int number, unsigned seed);
+
+private:
+    int mWindowH;
+    int mWindowW;
+
+    CascadeClassifier    mCascade;
+    VJSampleSet          mPositives;
+    VJSampleSet          mSamples;
+    vector<G12Buffer *>  mBackgrounds;
+    vector<VJPattern *>  mFeatures;
+
+    /** Adds the windows of the backgrounds that pass the current cascade */
+    void bootstrapNegatives(int needed);
+
+    /** Trains one stage on mSamples and appends it to the cascade */
+    void trainStage();
+
+    VJCascadeTrainer(const VJCascadeTrainer &);
+    VJCascadeTrainer &operator =(const VJCascadeTrainer &);
+};
+
+} //namespace corecvs
+
+/* EOF */
@@ -392,6 +392,17 @@ template<typename ResultType>
         return this->createView<ResultType>(0, 0, this->h, this->w);
     }
 
+    /**
+     * Checks if the underlying memory is referenced by some other buffer (i.e. a view).
+     *
+     * Writers that got the buffer through a view should make a copy if this is true,
+     * and pools should not reuse such a memory for other purposes.
+     **/
+    bool isShared() const
+    {
+        return (memoryBlock.block != NULL) && (memoryBlock.block->refCount() > 1);
+    }
+
 
     /**
      * The element getter.
@@ -10,6 +10,7 @@
 #include "ppmLoader.h"
 #include "rawLoader.h"
 #include "bmpLoader.h"
+#include "g12Codec.h"
 
 namespace corecvs {
 
@@ -25,6 +26,7 @@ BufferFactory* BufferFactory::getInstance()
         sThis.get()->registerLoader(new PPMLoader());
         sThis.get()->registerLoader(new RAWLoader());
         sThis.get()->registerLoader(new BMPLoader());
+        sThis.get()->registerLoader(new G12CodecLoader());
     }
     return sThis.get();
 }
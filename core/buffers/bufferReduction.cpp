@@ -0,0 +1,284 @@
+/**
+ * \file bufferReduction.cpp
+ * \brief SSE row reductions of the 8 and 16 bit buffers
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+#include "bufferReduction.h"
+
+namespace corecvs {
+
+#ifdef WITH_SSE
+
+/* Steps between the flushes of the 32 bit lane sums to the 64 bit ones, so the lanes never overflow */
+static const int CHUNK_16 = 16384;
+static const int CHUNK_8  = 8192;
+static const int MOMENT_CHUNK = 64;
+
+/**
+ *  The first position of the value in the row, the value is known to be there
+ **/
+template<typename ElementType>
+static inline int findFirst(const ElementType *row, int x1, int x2, ElementType value)
+{
+    for (int j = x1; j < x2; j++)
+        if (row[j] == value)
+            return j;
+    return x1;
+}
+
+/**
+ *  The row extremums are found first and the position is searched only if the extremum of the block changes,
+ *  which is rare after the first rows.
+ **/
+template<typename ElementType>
+static inline void updateExtremums(const ElementType *row, int i, int x1, int x2, ElementType rowMin, ElementType rowMax, ReductionResult<ElementType> &block)
+{
+    if (block.count == 0 || rowMin < block.min)
+    {
+        block.min = rowMin;
+        block.minPosition = Vector2d32(findFirst(row, x1, x2, rowMin), i);
+    }
+    if (block.count == 0 || rowMax > block.max)
+    {
+        block.max = rowMax;
+        block.maxPosition = Vector2d32(findFirst(row, x1, x2, rowMax), i);
+    }
+}
+
+template<typename ElementType>
+static inline void rowMoments(const ElementType *row, int x1, int x2, int64_t &sumX, int64_t &sumXX)
+{
+    for (int j = x1; j < x2; j++)
+    {
+        int64_t weighted = (int64_t)j * row[j];
+        sumX  += weighted;
+        sumXX += weighted * j;
+    }
+}
+
+/**
+ *  SSE2 has no unsigned 16 bit min and max, the values are biased by 0x8000 to use the signed ones.
+ *  The squares are 32 bit wide, so they are multiplied into the 64 bit lanes by _mm_mul_epu32.
+ *
+ *  The moments need no multiplications in the loop. Each lane k sees the values v_s of the columns
+ *  base + k + 8 s, s < n, and keeps the running sums P = sum v_s, Q = sum P and R = sum Q. At the end of
+ *  the chunk Q = sum (n - s) v_s and R = sum (n - s)(n - s + 1) / 2 v_s, which give sum s v_s and
+ *  sum s^2 v_s. R stays below 2^32 for n <= MOMENT_CHUNK.
+ **/
+void BufferReduction::reduceRow(const uint16_t *row, const uint8_t *mask, int i, int x1, int x2, int flags, ReductionResult<uint16_t> &block)
+{
+    if (mask != NULL || x1 >= x2)
+    {
+        reduceRowGeneric(row, mask, i, x1, x2, flags, block);
+        return;
+    }
+
+    bool squares   = (flags & SQUARES) != 0;
+    bool extremums = (flags & MINMAX)  != 0;
+    bool moments   = (flags & MOMENTS) != 0;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16((short)0x8000);
+    __m128i minimum = _mm_set1_epi16(0x7FFF);
+    __m128i maximum = bias;
+    __m128i sum64   = zero;
+    __m128i sq64    = zero;
+    int64_t sumX  = 0;
+    int64_t sumXX = 0;
+
+    int j = x1;
+    while (j + 8 <= x2)
+    {
+        int chunkBase = j;
+        int chunkEnd = CORE_MIN(x2, j + 8 * (moments ? MOMENT_CHUNK : CHUNK_16));
+        __m128i sum32 = zero;
+        __m128i lowP  = zero, lowQ  = zero, lowR  = zero;
+        __m128i highP = zero, highQ = zero, highR = zero;
+        for (; j + 8 <= chunkEnd; j += 8)
+        {
+            __m128i value = _mm_loadu_si128((const __m128i *)(row + j));
+            __m128i low   = _mm_unpacklo_epi16(value, zero);
+            __m128i high  = _mm_unpackhi_epi16(value, zero);
+            sum32 = _mm_add_epi32(sum32, _mm_add_epi32(low, high));
+            if (moments)
+            {
+                lowP  = _mm_add_epi32(lowP,  low);
+                lowQ  = _mm_add_epi32(lowQ,  lowP);
+                lowR  = _mm_add_epi32(lowR,  lowQ);
+                highP = _mm_add_epi32(highP, high);
+                highQ = _mm_add_epi32(highQ, highP);
+                highR = _mm_add_epi32(highR, highQ);
+            }
+            if (squares)
+            {
+                __m128i lowOdd  = _mm_srli_epi64(low,  32);
+                __m128i highOdd = _mm_srli_epi64(high, 32);
+                sq64 = _mm_add_epi64(sq64, _mm_add_epi64(_mm_mul_epu32(low,  low),  _mm_mul_epu32(lowOdd,  lowOdd)));
+                sq64 = _mm_add_epi64(sq64, _mm_add_epi64(_mm_mul_epu32(high, high), _mm_mul_epu32(highOdd, highOdd)));
+            }
+            if (extremums)
+            {
+                __m128i biased = _mm_xor_si128(value, bias);
+                minimum = _mm_min_epi16(minimum, biased);
+                maximum = _mm_max_epi16(maximum, biased);
+            }
+        }
+        sum64 = _mm_add_epi64(sum64, _mm_unpacklo_epi32(sum32, zero));
+        sum64 = _mm_add_epi64(sum64, _mm_unpackhi_epi32(sum32, zero));
+
+        if (moments)
+        {
+            uint32_t P[8], Q[8], R[8];
+            _mm_storeu_si128((__m128i *)&P[0], lowP);
+            _mm_storeu_si128((__m128i *)&P[4], highP);
+            _mm_storeu_si128((__m128i *)&Q[0], lowQ);
+            _mm_storeu_si128((__m128i *)&Q[4], highQ);
+            _mm_storeu_si128((__m128i *)&R[0], lowR);
+            _mm_storeu_si128((__m128i *)&R[4], highR);
+            int64_t n = (j - chunkBase) / 8;
+            for (int k = 0; k < 8; k++)
+            {
+                int64_t sv  = n * P[k] - Q[k];
+                int64_t ssv = n * n * P[k] - (2 * n + 1) * Q[k] + 2 * (int64_t)R[k];
+                int64_t x   = chunkBase + k;
+                sumX  += x * P[k] + 8 * sv;
+                sumXX += x * x * P[k] + 16 * x * sv + 64 * ssv;
+            }
+        }
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, sum64);
+    uint64_t sum = lanes[0] + lanes[1];
+    _mm_storeu_si128((__m128i *)lanes, sq64);
+    uint64_t sumSq = lanes[0] + lanes[1];
+
+    if (moments)
+        rowMoments(row, j, x2, sumX, sumXX);
+
+    uint16_t rowMin = 0xFFFF;
+    uint16_t rowMax = 0;
+    if (extremums)
+    {
+        uint16_t values[8];
+        _mm_storeu_si128((__m128i *)values, _mm_xor_si128(minimum, bias));
+        for (int k = 0; k < 8; k++)
+            rowMin = CORE_MIN(rowMin, values[k]);
+        _mm_storeu_si128((__m128i *)values, _mm_xor_si128(maximum, bias));
+        for (int k = 0; k < 8; k++)
+            rowMax = CORE_MAX(rowMax, values[k]);
+    }
+
+    for (; j < x2; j++)
+    {
+        uint16_t value = row[j];
+        sum   += value;
+        sumSq += (uint64_t)value * value;
+        rowMin = CORE_MIN(rowMin, value);
+        rowMax = CORE_MAX(rowMax, value);
+    }
+    if (!squares)
+        sumSq = 0;
+
+    if (extremums)
+        updateExtremums(row, i, x1, x2, rowMin, rowMax, block);
+
+    block.addRow(i, x2 - x1, sum, sumSq, sumX, sumXX);
+}
+
+/**
+ *  The sums come from _mm_sad_epu8 against zero, the squares from _mm_madd_epi16 of the widened values.
+ **/
+void BufferReduction::reduceRow(const uint8_t *row, const uint8_t *mask, int i, int x1, int x2, int flags, ReductionResult<uint8_t> &block)
+{
+    if (mask != NULL || x1 >= x2)
+    {
+        reduceRowGeneric(row, mask, i, x1, x2, flags, block);
+        return;
+    }
+
+    bool squares   = (flags & SQUARES) != 0;
+    bool extremums = (flags & MINMAX)  != 0;
+
+    const __m128i zero = _mm_setzero_si128();
+    __m128i minimum = _mm_set1_epi8((char)0xFF);
+    __m128i maximum = zero;
+    __m128i sum64   = zero;
+    __m128i sq64    = zero;
+
+    int j = x1;
+    while (j + 16 <= x2)
+    {
+        int chunkEnd = CORE_MIN(x2, j + 16 * CHUNK_8);
+        __m128i sq32 = zero;
+        for (; j + 16 <= chunkEnd; j += 16)
+        {
+            __m128i value = _mm_loadu_si128((const __m128i *)(row + j));
+            sum64 = _mm_add_epi64(sum64, _mm_sad_epu8(value, zero));
+            if (squares)
+            {
+                __m128i low  = _mm_unpacklo_epi8(value, zero);
+                __m128i high = _mm_unpackhi_epi8(value, zero);
+                sq32 = _mm_add_epi32(sq32, _mm_add_epi32(_mm_madd_epi16(low, low), _mm_madd_epi16(high, high)));
+            }
+            if (extremums)
+            {
+                minimum = _mm_min_epu8(minimum, value);
+                maximum = _mm_max_epu8(maximum, value);
+            }
+        }
+        sq64 = _mm_add_epi64(sq64, _mm_unpacklo_epi32(sq32, zero));
+        sq64 = _mm_add_epi64(sq64, _mm_unpackhi_epi32(sq32, zero));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, sum64);
+    uint64_t sum = lanes[0] + lanes[1];
+    _mm_storeu_si128((__m128i *)lanes, sq64);
+    uint64_t sumSq = lanes[0] + lanes[1];
+
+    uint8_t rowMin = 0xFF;
+    uint8_t rowMax = 0;
+    if (extremums)
+    {
+        uint8_t values[16];
+        _mm_storeu_si128((__m128i *)values, minimum);
+        for (int k = 0; k < 16; k++)
+            rowMin = CORE_MIN(rowMin, values[k]);
+        _mm_storeu_si128((__m128i *)values, maximum);
+        for (int k = 0; k < 16; k++)
+            rowMax = CORE_MAX(rowMax, values[k]);
+    }
+
+    for (; j < x2; j++)
+    {
+        uint8_t value = row[j];
+        sum   += value;
+        sumSq += (uint64_t)value * value;
+        rowMin = CORE_MIN(rowMin, value);
+        rowMax = CORE_MAX(rowMax, value);
+    }
+    if (!squares)
+        sumSq = 0;
+
+    if (extremums)
+        updateExtremums(row, i, x1, x2, rowMin, rowMax, block);
+
+    int64_t sumX  = 0;
+    int64_t sumXX = 0;
+    if (flags & MOMENTS)
+        rowMoments(row, x1, x2, sumX, sumXX);
+
+    block.addRow(i, x2 - x1, sum, sumSq, sumX, sumXX);
+}
+
+#endif // WITH_SSE
+
+} //namespace corecvs
@@ -0,0 +1,375 @@
+#pragma once
+/**
+ * \file bufferReduction.h
+ * \brief Parallel reductions of the buffers: sums, squares, extremums with their positions and moments
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#include <stdint.h>
+#include <vector>
+
+#include "global.h"
+
+#include "vector2d.h"
+#include "rectangle.h"
+#include "g8Buffer.h"
+#include "tbbWrapper.h"
+
+namespace corecvs {
+
+using std::vector;
+
+/**
+ *  Accumulator types of the reductions. The integer elements are summed exactly, everything else in double.
+ **/
+template<typename ElementType>
+class ReductionTraits
+{
+public:
+    typedef double SumType;
+    typedef double SquareType;
+    /** Per row sums of x v and x^2 v */
+    typedef double MomentType;
+};
+
+template<>
+class ReductionTraits<uint8_t>
+{
+public:
+    typedef uint64_t SumType;
+    typedef uint64_t SquareType;
+    typedef int64_t  MomentType;
+};
+
+template<>
+class ReductionTraits<uint16_t>
+{
+public:
+    typedef uint64_t SumType;
+    typedef uint64_t SquareType;
+    typedef int64_t  MomentType;
+};
+
+template<>
+class ReductionTraits<int16_t>
+{
+public:
+    typedef int64_t  SumType;
+    typedef uint64_t SquareType;
+    typedef int64_t  MomentType;
+};
+
+template<>
+class ReductionTraits<uint32_t>
+{
+public:
+    typedef uint64_t SumType;
+    typedef double   SquareType;
+    typedef double   MomentType;
+};
+
+template<>
+class ReductionTraits<int32_t>
+{
+public:
+    typedef int64_t  SumType;
+    typedef double   SquareType;
+    typedef double   MomentType;
+};
+
+/**
+ *  Result of BufferReduction::reduce(). Only the fields of the requested flags are filled.
+ *
+ *  The moments are weighted by the element values, m00 is the sum. The extremums keep the first position
+ *  in the row major order if the value repeats.
+ **/
+template<typename ElementType>
+class ReductionResult
+{
+public:
+    typedef typename ReductionTraits<ElementType>::SumType    SumType;
+    typedef typename ReductionTraits<ElementType>::SquareType SquareType;
+    typedef typename ReductionTraits<ElementType>::MomentType MomentType;
+
+    uint64_t    count;
+    SumType     sum;
+    SquareType  sumSq;
+
+    ElementType min;
+    ElementType max;
+    Vector2d32  minPosition;
+    Vector2d32  maxPosition;
+
+    double m10;
+    double m01;
+    double m20;
+    double m11;
+    double m02;
+
+    ReductionResult() :
+        count(0),
+        sum(0),
+        sumSq(0),
+        min(0),
+        max(0),
+        minPosition(-1, -1),
+        maxPosition(-1, -1),
+        m10(0.0),
+        m01(0.0),
+        m20(0.0),
+        m11(0.0),
+        m02(0.0)
+    {}
+
+    bool isEmpty() const
+    {
+        return count == 0;
+    }
+
+    double mean() const
+    {
+        return count == 0 ? 0.0 : (double)sum / count;
+    }
+
+    double variance() const
+    {
+        if (count == 0)
+            return 0.0;
+        double m = mean();
+        return CORE_MAX((double)sumSq / count - m * m, 0.0);
+    }
+
+    /** Weighted by the values, zero if the sum is zero */
+    Vector2dd centroid() const
+    {
+        if (sum == 0)
+            return Vector2dd(0.0, 0.0);
+        return Vector2dd(m10 / (double)sum, m01 / (double)sum);
+    }
+
+    /** Adds the sums of the row i, x is the column and y is i */
+    void addRow(int i, uint64_t rowCount, SumType rowSum, SquareType rowSumSq, MomentType rowSumX, MomentType rowSumXX)
+    {
+        double y = i;
+        count += rowCount;
+        sum   += rowSum;
+        sumSq += rowSumSq;
+        m10 += (double)rowSumX;
+        m01 += y * (double)rowSum;
+        m20 += (double)rowSumXX;
+        m11 += y * (double)rowSumX;
+        m02 += y * y * (double)rowSum;
+    }
+
+    /** Adds the result of the area that follows this one in the row major order */
+    void merge(const ReductionResult &next)
+    {
+        if (next.count == 0)
+            return;
+        if (count == 0 || next.min < min)
+        {
+            min = next.min;
+            minPosition = next.minPosition;
+        }
+        if (count == 0 || next.max > max)
+        {
+            max = next.max;
+            maxPosition = next.maxPosition;
+        }
+        count += next.count;
+        sum   += next.sum;
+        sumSq += next.sumSq;
+        m10 += next.m10;
+        m01 += next.m01;
+        m20 += next.m20;
+        m11 += next.m11;
+        m02 += next.m02;
+    }
+};
+
+/**
+ *  \brief Reductions of the buffers of the arithmetic elements
+ *
+ *  The area is cut into the blocks of BLOCK_ROWS rows, the blocks are reduced in parallel and then merged
+ *  in their order. The cut does not depend on the number of threads, so unlike parallelable_reduce() the
+ *  floating point results are the same for any number of threads.
+ *
+ *  The rows are reduced by reduceRow(). The generic one is scalar, the overloads for uint8_t and uint16_t
+ *  compute the sums and the extremums of the unmasked rows with SSE.
+ *
+ *  All the methods take the optional region of interest and the optional mask of the buffer size,
+ *  the elements with the zero mask are skipped.
+ **/
+class BufferReduction
+{
+public:
+    enum {
+        SUM     = 0x1,
+        SQUARES = 0x2,
+        MINMAX  = 0x4,
+        MOMENTS = 0x8,
+        ALL     = SUM | SQUARES | MINMAX | MOMENTS
+    };
+
+    static const int BLOCK_ROWS = 16;
+
+    template<class BufferType>
+    static ReductionResult<typename BufferType::InternalElementType> reduce(
+            const BufferType *buffer,
+            int flags = ALL,
+            const Rectangle<int32_t> *roi = NULL,
+            const G8Buffer *mask = NULL);
+
+    template<class BufferType>
+    static typename ReductionTraits<typename BufferType::InternalElementType>::SumType sum(
+            const BufferType *buffer, const Rectangle<int32_t> *roi = NULL, const G8Buffer *mask = NULL)
+    {
+        return reduce(buffer, SUM, roi, mask).sum;
+    }
+
+    template<class BufferType>
+    static ReductionResult<typename BufferType::InternalElementType> minMax(
+            const BufferType *buffer, const Rectangle<int32_t> *roi = NULL, const G8Buffer *mask = NULL)
+    {
+        return reduce(buffer, MINMAX, roi, mask);
+    }
+
+    /**
+     *  Adds the elements x1 <= j < x2 of the row i to the block. row and mask point to the column 0,
+     *  mask may be NULL.
+     **/
+    template<typename ElementType>
+    static void reduceRow(const ElementType *row, const uint8_t *mask, int i, int x1, int x2, int flags, ReductionResult<ElementType> &block)
+    {
+        reduceRowGeneric(row, mask, i, x1, x2, flags, block);
+    }
+
+#ifdef WITH_SSE
+    static void reduceRow(const uint8_t  *row, const uint8_t *mask, int i, int x1, int x2, int flags, ReductionResult<uint8_t>  &block);
+    static void reduceRow(const uint16_t *row, const uint8_t *mask, int i, int x1, int x2, int flags, ReductionResult<uint16_t> &block);
+#endif
+
+    template<typename ElementType>
+    static void reduceRowGeneric(const ElementType *row, const uint8_t *mask, int i, int x1, int x2, int flags, ReductionResult<ElementType> &block)
+    {
+        typedef ReductionTraits<ElementType> Traits;
+        typename Traits::SumType    sum   = 0;
+        typename Traits::SquareType sumSq = 0;
+        typename Traits::MomentType sumX  = 0;
+        typename Traits::MomentType sumXX = 0;
+        uint64_t count = block.count;
+
+        for (int j = x1; j < x2; j++)
+        {
+            if (mask != NULL && !mask[j])
+                continue;
+            ElementType value = row[j];
+            sum += value;
+            if (flags & SQUARES)
+                sumSq += (typename Traits::SquareType)value * value;
+            if (flags & MINMAX)
+            {
+                if (count == 0 || value < block.min)
+                {
+                    block.min = value;
+                    block.minPosition = Vector2d32(j, i);
+                }
+                if (count == 0 || value > block.max)
+                {
+                    block.max = value;
+                    block.maxPosition = Vector2d32(j, i);
+                }
+            }
+            if (flags & MOMENTS)
+            {
+                typename Traits::MomentType weighted = (typename Traits::MomentType)j * value;
+                sumX  += weighted;
+                sumXX += weighted * j;
+            }
+            count++;
+        }
+        block.addRow(i, count - block.count, sum, sumSq, sumX, sumXX);
+    }
+
+    /** The region clipped by the buffer, the whole buffer if roi is NULL */
+    template<class BufferType>
+    static Rectangle<int32_t> clip(const BufferType *buffer, const Rectangle<int32_t> *roi)
+    {
+        if (roi == NULL)
+            return Rectangle<int32_t>(0, 0, buffer->w, buffer->h);
+
+        int x1 = CORE_MAX(roi->corner.x(), 0);
+        int y1 = CORE_MAX(roi->corner.y(), 0);
+        int x2 = CORE_MIN(roi->corner.x() + roi->size.x(), buffer->w);
+        int y2 = CORE_MIN(roi->corner.y() + roi->size.y(), buffer->h);
+        return Rectangle<int32_t>(x1, y1, CORE_MAX(x2 - x1, 0), CORE_MAX(y2 - y1, 0));
+    }
+};
+
+template<class BufferType>
+class ParallelBlockReduce
+{
+public:
+    typedef typename BufferType::InternalElementType ElementType;
+
+    const BufferType *buffer;
+    const G8Buffer   *mask;
+    Rectangle<int32_t> area;
+    int flags;
+    ReductionResult<ElementType> *blocks;
+
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        int y1 = area.corner.y();
+        int y2 = area.corner.y() + area.size.y();
+        int x1 = area.corner.x();
+        int x2 = area.corner.x() + area.size.x();
+        for (int block = r.begin(); block < r.end(); block++)
+        {
+            ReductionResult<ElementType> &result = blocks[block];
+            int end = CORE_MIN(y1 + (block + 1) * BufferReduction::BLOCK_ROWS, y2);
+            for (int i = y1 + block * BufferReduction::BLOCK_ROWS; i < end; i++)
+            {
+                const uint8_t *maskRow = (mask != NULL) ? &mask->element(i, 0) : NULL;
+                BufferReduction::reduceRow(&buffer->element(i, 0), maskRow, i, x1, x2, flags, result);
+            }
+        }
+    }
+
+    ParallelBlockReduce(const BufferType *_buffer, const G8Buffer *_mask, const Rectangle<int32_t> &_area, int _flags, ReductionResult<ElementType> *_blocks) :
+        buffer(_buffer),
+        mask(_mask),
+        area(_area),
+        flags(_flags),
+        blocks(_blocks)
+    {}
+};
+
+template<class BufferType>
+ReductionResult<typename BufferType::InternalElementType> BufferReduction::reduce(
+        const BufferType *buffer,
+        int flags,
+        const Rectangle<int32_t> *roi,
+        const G8Buffer *mask)
+{
+    typedef typename BufferType::InternalElementType ElementType;
+    ASSERT_TRUE(buffer != NULL, "Input buffer should not be NULL");
+    ASSERT_TRUE(mask == NULL || (mask->h == buffer->h && mask->w == buffer->w), "Mask should be of the buffer size");
+
+    ReductionResult<ElementType> result;
+    Rectangle<int32_t> area = clip(buffer, roi);
+    if (area.size.x() == 0 || area.size.y() == 0)
+        return result;
+
+    int blocksNumber = (area.size.y() + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    vector<ReductionResult<ElementType> > blocks(blocksNumber);
+    parallelable_for(0, blocksNumber, ParallelBlockReduce<BufferType>(buffer, mask, area, flags, &blocks[0]));
+
+    for (int block = 0; block < blocksNumber; block++)
+        result.merge(blocks[block]);
+    return result;
+}
+
+} //namespace corecvs
@@ -12,6 +12,7 @@ HEADERS += \
     buffers/commonMappers.h \
     buffers/integralBuffer.h \
     buffers/derivativeBuffer.h \
+    buffers/cannyDetector.h \
     buffers/mipmapPyramid.h \
     buffers/flow/flowBuffer.h \
     buffers/flow/sixDBuffer.h \
@@ -20,6 +21,8 @@ HEADERS += \
     buffers/flow/flowVector.h \
     buffers/flow/depthBuffer.h \
     buffers/histogram/histogram.h \
+    buffers/histogram/histogramBuilder.h \
+    buffers/bufferReduction.h \
     buffers/kernels/gaussian.h \
     buffers/kernels/sobel.h \
     buffers/kernels/threshold.h \
@@ -35,6 +38,7 @@ HEADERS += \
     buffers/kernels/blurProcessor.h \
     buffers/kernels/spatialGradient.h \
     buffers/morphological/morphological.h \
+    buffers/morphological/rectMorphology.h \
     buffers/rgb24/rgbColor.h \
     buffers/rgb24/rgb24Buffer.h \
     buffers/rgb24/hardcodeFont.h \
@@ -42,6 +46,8 @@ HEADERS += \
     buffers/rgb24/abstractPainter.h \
     buffers/voxels/voxelBuffer.h \
     buffers/fixeddisp/fixedPointDisplace.h \
+    buffers/fixeddisp/remapEngine.h \
+    buffers/fixeddisp/deformChain.h \
     buffers/interpolator.h \
     buffers/g12Buffer3d.h \
     buffers/buffer3d.h \
@@ -60,11 +66,14 @@ SOURCES += \
     buffers/commonMappers.cpp \
     buffers/mipmapPyramid.cpp \
     buffers/derivativeBuffer.cpp \
+    buffers/cannyDetector.cpp \
     buffers/flow/flowBuffer.cpp \
     buffers/flow/sixDBuffer.cpp \
     buffers/flow/floatFlowBuffer.cpp \
     buffers/flow/depthBuffer.cpp \
     buffers/histogram/histogram.cpp \
+    buffers/histogram/histogramBuilder.cpp \
+    buffers/bufferReduction.cpp \
     buffers/kernels/gaussian.cpp \
     buffers/kernels/sobel.cpp \
     buffers/kernels/threshold.cpp \
@@ -80,5 +89,7 @@ SOURCES += \
     buffers/g12Buffer3d.cpp \
     buffers/buffer3d.cpp \
     buffers/transformationCache.cpp \
+    buffers/fixeddisp/remapEngine.cpp \
+    buffers/fixeddisp/deformChain.cpp \
 
 
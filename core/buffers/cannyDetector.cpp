@@ -0,0 +1,364 @@
+/**
+ * \file cannyDetector.cpp
+ * \brief Canny edge detector with the vectorized suppression and the iterative hysteresis
+ *
+ * \date Oct 19, 2026
+ * \ingroup cppcorefiles
+ */
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+#include "cannyDetector.h"
+#include "fastKernel.h"
+#include "scalarAlgebra.h"
+#include "vectorAlgebra.h"
+#include "vectorTraits.h"
+#include "sobel.h"
+#include "tbbWrapper.h"
+#include "zoneTracer.h"
+
+namespace corecvs {
+
+const int CannyDetector::STRIPE_HEIGHT;
+
+/** tan(22.5 deg) in 1/65536, ay <= (ax * TAN_22_5) >> 16 is the same as ay < ax * TAN_22_5 / 65536 for the 13 bit ax */
+static const int TAN_22_5 = 27146;
+
+CannyDetector::CannyDetector() :
+    mGradientX(NULL),
+    mGradientY(NULL),
+    mMagnitude(NULL),
+    mLabels(NULL)
+{}
+
+void CannyDetector::allocate(int h, int w)
+{
+    if (mLabels != NULL && mLabels->h == h && mLabels->w == w)
+        return;
+
+    delete_safe(mGradientX);
+    delete_safe(mGradientY);
+    delete_safe(mMagnitude);
+    delete_safe(mLabels);
+
+    /* Zero initialized, the border rows and columns are never written afterwards */
+    mGradientX = new G12Buffer(h, w);
+    mGradientY = new G12Buffer(h, w);
+    mMagnitude = new G12Buffer(h, w);
+    mLabels    = new G8Buffer (h, w);
+}
+
+/**
+ *  Scalar suppression and thresholding of one pixel, also used for the row tails.
+ *  The first neighbour is the left one (the upper one for the vertical gradient), it wins the ties
+ **/
+static inline uint8_t classifyPixel(
+        const int16_t *gxRow, const int16_t *gyRow,
+        const int16_t *up, const int16_t *row, const int16_t *down,
+        int j, int lowThreshold, int highThreshold)
+{
+    int m = row[j];
+    if (m < lowThreshold)
+        return CannyDetector::NONE;
+
+    int gx = gxRow[j];
+    int gy = gyRow[j];
+    int ax = gx < 0 ? -gx : gx;
+    int ay = gy < 0 ? -gy : gy;
+
+    int first, second;
+    if (ay <= ((ax * TAN_22_5) >> 16))
+    {
+        first = row[j - 1]; second = row[j + 1];
+    }
+    else if (ax <= ((ay * TAN_22_5) >> 16))
+    {
+        first = up[j]; second = down[j];
+    }
+    else if ((gx ^ gy) >= 0)
+    {
+        first = up[j - 1]; second = down[j + 1];
+    }
+    else
+    {
+        first = down[j - 1]; second = up[j + 1];
+    }
+
+    if (!(m > first && m >= second))
+        return CannyDetector::NONE;
+    return (m > highThreshold) ? CannyDetector::STRONG : CannyDetector::WEAK;
+}
+
+class ParallelCannyMagnitude
+{
+public:
+    G12Buffer *gradientX;
+    G12Buffer *gradientY;
+    G12Buffer *magnitude;
+
+    ParallelCannyMagnitude(G12Buffer *_gradientX, G12Buffer *_gradientY, G12Buffer *_magnitude) :
+        gradientX(_gradientX), gradientY(_gradientY), magnitude(_magnitude)
+    {}
+
+    void operator()(const BlockedRange<int> &r) const
+    {
+        int w = magnitude->w;
+        for (int i = r.begin(); i < r.end(); i++)
+        {
+            const int16_t *gx = (const int16_t *)&gradientX->element(i, 0);
+            const int16_t *gy = (const int16_t *)&gradientY->element(i, 0);
+            int16_t *m = (int16_t *)&magnitude->element(i, 0);
+            int j = 0;
+#ifdef WITH_SSE
+            __m128i zero = _mm_setzero_si128();
+            for (; j + 8 <= w; j += 8)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i *)(gx + j));
+                __m128i y = _mm_loadu_si128((const __m128i *)(gy + j));
+                x = _mm_max_epi16(x, _mm_sub_epi16(zero, x));
+                y = _mm_max_epi16(y, _mm_sub_epi16(zero, y));
+                _mm_storeu_si128((__m128i *)(m + j), _mm_add_epi16(x, y));
+            }
+#endif
+            for (; j < w; j++)
+                m[j] = (int16_t)(abs(gx[j]) + abs(gy[j]));
+        }
+    }
+};
+
+class ParallelCannySuppression
+{
+public:
+    G12Buffer *gradientX;
+    G12Buffer *gradientY;
+    G12Buffer *magnitude;
+    G8Buffer  *labels;
+    int lowThreshold;
+    int highThreshold;
+
+    ParallelCannySuppression(G12Buffer *_gradientX, G12Buffer *_gradientY, G12Buffer *_magnitude, G8Buffer *_labels, int _low, int _high) :
+        gradientX(_gradientX), gradientY(_gradientY), magnitude(_magnitude), labels(_labels),
+        lowThreshold(_low), highThreshold(_high)
+    {}
+
+    ALIGN_STACK_SSE void operator()(const BlockedRange<int> &r) const
+    {
+        int w = magnitude->w;
+        for (int i = r.begin(); i < r.end(); i++)
+        {
+            const int16_t *gx   = (const int16_t *)&gradientX->element(i, 0);
+            const int16_t *gy   = (const int16_t *)&gradientY->element(i, 0);
+            const int16_t *up   = (const int16_t *)&magnitude->element(i - 1, 0);
+            const int16_t *row  = (const int16_t *)&magnitude->element(i    , 0);
+            const int16_t *down = (const int16_t *)&magnitude->element(i + 1, 0);
+            uint8_t *out = &labels->element(i, 0);
+
+            int j = 1;
+#ifdef WITH_SSE
+            __m128i zero    = _mm_setzero_si128();
+            __m128i one     = _mm_set1_epi16(1);
+            __m128i tangent = _mm_set1_epi16((int16_t)TAN_22_5);
+            __m128i low     = _mm_set1_epi16((int16_t)(lowThreshold - 1));
+            __m128i high    = _mm_set1_epi16((int16_t)highThreshold);
+
+            for (; j + 8 <= w - 1; j += 8)
+            {
+                __m128i x  = _mm_loadu_si128((const __m128i *)(gx + j));
+                __m128i y  = _mm_loadu_si128((const __m128i *)(gy + j));
+                __m128i ax = _mm_max_epi16(x, _mm_sub_epi16(zero, x));
+                __m128i ay = _mm_max_epi16(y, _mm_sub_epi16(zero, y));
+
+                __m128i horizontal = _mm_cmplt_epi16(ay, _mm_add_epi16(_mm_mulhi_epu16(ax, tangent), one));
+                __m128i vertical   = _mm_andnot_si128(horizontal, _mm_cmplt_epi16(ax, _mm_add_epi16(_mm_mulhi_epu16(ay, tangent), one)));
+                __m128i diagonal   = _mm_andnot_si128(_mm_or_si128(horizontal, vertical), _mm_cmpeq_epi16(zero, zero));
+                __m128i opposite   = _mm_cmplt_epi16(_mm_xor_si128(x, y), zero);
+                __m128i main       = _mm_andnot_si128(opposite, diagonal);
+                __m128i anti       = _mm_and_si128(opposite, diagonal);
+
+                __m128i first = _mm_or_si128(
+                        _mm_or_si128(
+                            _mm_and_si128(horizontal, _mm_loadu_si128((const __m128i *)(row + j - 1))),
+                            _mm_and_si128(vertical  , _mm_loadu_si128((const __m128i *)(up  + j    )))),
+                        _mm_or_si128(
+                            _mm_and_si128(main      , _mm_loadu_si128((const __m128i *)(up  + j - 1))),
+                            _mm_and_si128(anti      , _mm_loadu_si128((const __m128i *)(down + j - 1)))));
+                __m128i second = _mm_or_si128(
+                        _mm_or_si128(
+                            _mm_and_si128(horizontal, _mm_loadu_si128((const __m128i *)(row  + j + 1))),
+                            _mm_and_si128(vertical  , _mm_loadu_si128((const __m128i *)(down + j    )))),
+                        _mm_or_si128(
+                            _mm_and_si128(main      , _mm_loadu_si128((const __m128i *)(down + j + 1))),
+                            _mm_and_si128(anti      , _mm_loadu_si128((const __m128i *)(up   + j + 1)))));
+
+                __m128i m = _mm_loadu_si128((const __m128i *)(row + j));
+                /* m > first && m >= second */
+                __m128i keep = _mm_andnot_si128(_mm_cmplt_epi16(m, second), _mm_cmpgt_epi16(m, first));
+
+                __m128i weak   = _mm_and_si128(keep, _mm_cmpgt_epi16(m, low));
+                __m128i strong = _mm_and_si128(keep, _mm_cmpgt_epi16(m, high));
+                __m128i label  = _mm_add_epi16(_mm_and_si128(weak, one), _mm_and_si128(strong, one));
+
+                _mm_storel_epi64((__m128i *)(out + j), _mm_packus_epi16(label, zero));
+            }
+#endif
+            for (; j < w - 1; j++)
+                out[j] = classifyPixel(gx, gy, up, row, down, j, lowThreshold, highThreshold);
+        }
+    }
+};
+
+G8Buffer *CannyDetector::classify(G12Buffer *input, int lowThreshold, int highThreshold)
+{
+    TRACE_ZONE("CannyDetector::classify");
+    allocate(input->h, input->w);
+    if (input->h < 3 || input->w < 3)
+        return mLabels;
+
+    /**
+     * Sobel kernels give the difference of the left and the right columns divided by 4, that is minus
+     * the derivative. Both signs are flipped, so the direction sectors are the same. With zero bias the
+     * unsigned result wraps and is read back as int16.
+     **/
+    SobelHorizontalKernel<DummyAlgebra> kernelHor;
+    SobelVerticalKernel<DummyAlgebra>   kernelVert;
+    BufferProcessor<G12Buffer, G12Buffer, SobelHorizontalKernel, G12BufferAlgebra> processorHor;
+    BufferProcessor<G12Buffer, G12Buffer, SobelVerticalKernel,   G12BufferAlgebra> processorVer;
+    processorHor.process(&input, &mGradientX, kernelHor);
+    processorVer.process(&input, &mGradientY, kernelVert);
+
+    parallelable_for(0, input->h, ParallelCannyMagnitude(mGradientX, mGradientY, mMagnitude));
+
+    /* Magnitude is 4 times smaller than the full Sobel response the thresholds are given in */
+    int low  = CORE_MAX(1, (lowThreshold + 3) / 4);
+    int high = CORE_MAX(0, highThreshold / 4);
+    parallelable_for(1, input->h - 1, ParallelCannySuppression(mGradientX, mGradientY, mMagnitude, mLabels, low, high));
+
+    return mLabels;
+}
+
+/**
+ *  Grows the STRONG pixels from the stack over the WEAK ones between the rows minY and maxY inclusive
+ **/
+static void cannyGrow(G8Buffer *labels, vector<int> &stack, int minY, int maxY)
+{
+    int stride = labels->stride;
+    uint8_t *data = &labels->element(0, 0);
+
+    while (!stack.empty())
+    {
+        int position = stack.back();
+        stack.pop_back();
+        int i = position / stride;
+        int j = position % stride;
+
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            int y = i + dy;
+            if (y < minY || y > maxY)
+                continue;
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                int x = j + dx;
+                if (x < 0 || x >= labels->w)
+                    continue;
+                uint8_t &label = data[y * stride + x];
+                if (label == CannyDetector::WEAK)
+                {
+                    label = CannyDetector::STRONG;
+                    stack.push_back(y * stride + x);
+                }
+            }
+        }
+    }
+}
+
+class ParallelCannyStripes
+{
+public:
+    G8Buffer *labels;
+
+    ParallelCannyStripes(G8Buffer *_labels) : labels(_labels) {}
+
+    void operator()(const BlockedRange<int> &r) const
+    {
+        vector<int> stack;
+        for (int stripe = r.begin(); stripe < r.end(); stripe++)
+        {
+            int minY = stripe * CannyDetector::STRIPE_HEIGHT;
+            int maxY = CORE_MIN(labels->h, minY + CannyDetector::STRIPE_HEIGHT) - 1;
+
+            for (int i = minY; i <= maxY; i++)
+                for (int j = 0; j < labels->w; j++)
+                    if (labels->element(i, j) == CannyDetector::STRONG)
+                        stack.push_back(i * labels->stride + j);
+
+            cannyGrow(labels, stack, minY, maxY);
+        }
+    }
+};
+
+void CannyDetector::hysteresis(G8Buffer *labels)
+{
+    TRACE_ZONE("CannyDetector::hysteresis");
+    int stripes = (labels->h + STRIPE_HEIGHT - 1) / STRIPE_HEIGHT;
+    parallelable_for(0, stripes, 1, ParallelCannyStripes(labels));
+
+    /* Each stripe is complete by itself, what is left is the growth across the seams */
+    vector<int> stack;
+    for (int seam = 1; seam < stripes; seam++)
+    {
+        int below = seam * STRIPE_HEIGHT;
+        int above = below - 1;
+        for (int j = 0; j < labels->w; j++)
+        {
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                int x = j + dx;
+                if (x < 0 || x >= labels->w)
+                    continue;
+                if (labels->element(above, j) == STRONG && labels->element(below, x) == WEAK)
+                {
+                    labels->element(below, x) = STRONG;
+                    stack.push_back(below * labels->stride + x);
+                }
+                if (labels->element(below, j) == STRONG && labels->element(above, x) == WEAK)
+                {
+                    labels->element(above, x) = STRONG;
+                    stack.push_back(above * labels->stride + x);
+                }
+            }
+        }
+    }
+    cannyGrow(labels, stack, 0, labels->h - 1);
+}
+
+G12Buffer *CannyDetector::detect(G12Buffer *input, int lowThreshold, int highThreshold, bool track)
+{
+    G8Buffer *labels = classify(input, lowThreshold, highThreshold);
+    if (track)
+        hysteresis(labels);
+
+    const uint16_t values[3] = {
+        0,
+        track ? (uint16_t)0 : (uint16_t)(G12Buffer::BUFFER_MAX_VALUE / 2),
+        G12Buffer::BUFFER_MAX_VALUE
+    };
+
+    G12Buffer *result = new G12Buffer(input->h, input->w, false);
+    for (int i = 0; i < result->h; i++)
+        for (int j = 0; j < result->w; j++)
+            result->element(i, j) = values[labels->element(i, j)];
+    return result;
+}
+
+CannyDetector::~CannyDetector()
+{
+    delete_safe(mGradientX);
+    delete_safe(mGradientY);
+    delete_safe(mMagnitude);
+    delete_safe(mLabels);
+}
+
+} //namespace corecvs
@@ -0,0 +1,82 @@
+#pragma once
+/**
+ * \file cannyDetector.h
+ * \brief Canny edge detector with the vectorized suppression and the iterative hysteresis
+ *
+ * \date Oct 19, 2026
+ * \ingroup cppcorefiles
+ */
+
+#include <stdint.h>
+#include <vector>
+
+#include "global.h"
+
+#include "g8Buffer.h"
+#include "g12Buffer.h"
+
+namespace corecvs {
+
+using std::vector;
+
+/**
+ *  Canny edge detector.
+ *
+ *  The gradients are computed with the FastKernel Sobel kernels. The non-maximum suppression quantizes the
+ *  gradient direction into 4 sectors with the integer tangent tests and processes 8 pixels at a time.
+ *  Hysteresis grows the strong pixels over the weak ones with an explicit stack: first independently in the
+ *  horizontal stripes in parallel, then from the stripe seams over the whole image.
+ *
+ *  The thresholds are in the units of the full 3x3 Sobel response, as in CannyParameters.
+ *  The working planes are kept between the calls.
+ **/
+class CannyDetector
+{
+public:
+    enum Label {
+        NONE   = 0,
+        WEAK   = 1,
+        STRONG = 2
+    };
+
+    static const int STRIPE_HEIGHT = 64;
+
+    CannyDetector();
+
+    /**
+     *  Gradients, suppression and double thresholding.
+     *  \return plane of Label values owned by the detector
+     **/
+    G8Buffer *classify(G12Buffer *input, int lowThreshold, int highThreshold);
+
+    /** Marks STRONG every WEAK pixel 8-connected to a STRONG one */
+    static void hysteresis(G8Buffer *labels);
+
+    /**
+     * Full detector. The edges are BUFFER_MAX_VALUE, without tracking the weak pixels are left
+     * as half of it, like in the old CannyFilter
+     **/
+    G12Buffer *detect(G12Buffer *input, int lowThreshold, int highThreshold, bool track = true);
+
+    /** Sobel responses divided by 4 and the L1 magnitude of the last classify(), stored as int16 */
+    G12Buffer *gradientX() { return mGradientX; }
+    G12Buffer *gradientY() { return mGradientY; }
+    G12Buffer *magnitude() { return mMagnitude; }
+
+    ~CannyDetector();
+
+private:
+    G12Buffer *mGradientX;
+    G12Buffer *mGradientY;
+    G12Buffer *mMagnitude;
+    G8Buffer  *mLabels;
+
+    void allocate(int h, int w);
+
+    CannyDetector(const CannyDetector &);
+    CannyDetector &operator=(const CannyDetector &);
+};
+
+} //namespace corecvs
+
+/* EOF */
@@ -0,0 +1,338 @@
+/**
+ * \file deformChain.cpp
+ * \brief Composition of the deformations into one lazily built remap table
+ *
+ * \date Oct 19, 2026
+ * \ingroup cppcorefiles
+ */
+
+#include <stdio.h>
+#include <fstream>
+#include <algorithm>
+
+#include "deformChain.h"
+#include "tbbWrapper.h"
+#include "zoneTracer.h"
+
+namespace corecvs {
+
+using std::ifstream;
+using std::ofstream;
+using std::ios;
+
+bool ProjectiveDeformStep::map(const Vector2dd &point, Vector2dd &source) const
+{
+    Vector3dd projected = inverse * Vector3dd(point.x(), point.y(), 1.0);
+    if (projected.z() == 0.0)
+        return false;
+    source = Vector2dd(projected.x() / projected.z(), projected.y() / projected.z());
+    return true;
+}
+
+void ProjectiveDeformStep::hash(ParameterHash &hash) const
+{
+    hash.add(1);
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            hash.add(inverse.a(i, j));
+}
+
+bool RadialDeformStep::map(const Vector2dd &point, Vector2dd &source) const
+{
+    source = correction.map(point);
+    return true;
+}
+
+void RadialDeformStep::hash(ParameterHash &hash) const
+{
+    const LensCorrectionParametres &params = correction.mParams;
+    hash.add(2);
+    hash.add((int)params.koeff.size());
+    for (unsigned i = 0; i < params.koeff.size(); i++)
+        hash.add(params.koeff[i]);
+    hash.add(params.p1);
+    hash.add(params.p2);
+    hash.add(params.aspect);
+    hash.add(params.focal);
+    hash.add(params.center);
+}
+
+bool SphericalDeformStep::map(const Vector2dd &point, Vector2dd &source) const
+{
+    source = correction.map(point);
+    return true;
+}
+
+void SphericalDeformStep::hash(ParameterHash &hash) const
+{
+    hash.add(3);
+    hash.add(center);
+    hash.add((int)lut.size());
+    for (unsigned i = 0; i < lut.size(); i++)
+        hash.add(lut[i]);
+}
+
+bool DisplacementDeformStep::map(const Vector2dd &point, Vector2dd &source) const
+{
+    if (!displacement->isValidCoordBl(point.y(), point.x()))
+        return false;
+    source = point + displacement->elementBl(point.y(), point.x());
+    return true;
+}
+
+void DisplacementDeformStep::hash(ParameterHash &hash) const
+{
+    hash.add(4);
+    hash.add(displacement->h);
+    hash.add(displacement->w);
+    for (int i = 0; i < displacement->h; i++)
+        for (int j = 0; j < displacement->w; j++)
+            hash.add(displacement->element(i, j));
+}
+
+DisplacementDeformStep::~DisplacementDeformStep()
+{
+    delete_safe(displacement);
+}
+
+bool DeformChain::map(const Vector2dd &point, Vector2dd &source) const
+{
+    Vector2dd current = point;
+    for (unsigned i = 0; i < mSteps.size(); i++)
+    {
+        if (!mSteps[i]->map(current, current))
+            return false;
+    }
+    source = current;
+    return true;
+}
+
+void DeformChain::hash(ParameterHash &hash) const
+{
+    hash.add((int)mSteps.size());
+    for (unsigned i = 0; i < mSteps.size(); i++)
+        mSteps[i]->hash(hash);
+}
+
+DeformChain::~DeformChain()
+{
+    for (unsigned i = 0; i < mSteps.size(); i++)
+        delete_safe(mSteps[i]);
+}
+
+/* ComposedRemap */
+
+ComposedRemap::ComposedRemap(DeformChain *chain, int h, int w, int inputH, int inputW) :
+    mChain(chain)
+  , mMap(h, w, inputH, inputW)
+  , mTilesH((h + RemapEngine::TILE_H - 1) / RemapEngine::TILE_H)
+  , mTilesW((w + RemapEngine::TILE_W - 1) / RemapEngine::TILE_W)
+  , mTileReady(mTilesH * mTilesW, 0)
+  , mTilesMissing(mTilesH * mTilesW)
+  , mTilesBuilt(0)
+{
+    ParameterHash hash;
+    hash.add(h);
+    hash.add(w);
+    hash.add(inputH);
+    hash.add(inputW);
+    hash.add(RemapMap::FRACTION_BITS);
+    mChain->hash(hash);
+    mKey = hash.value;
+}
+
+void ComposedRemap::buildTile(int tile)
+{
+    int startY = (tile / mTilesW) * RemapEngine::TILE_H;
+    int startX = (tile % mTilesW) * RemapEngine::TILE_W;
+    int endY = CORE_MIN(mMap.h, startY + RemapEngine::TILE_H);
+    int endX = CORE_MIN(mMap.w, startX + RemapEngine::TILE_W);
+
+    for (int i = startY; i < endY; i++)
+    {
+        for (int j = startX; j < endX; j++)
+        {
+            Vector2dd source;
+            if (mChain->map(Vector2dd(j, i), source))
+                mMap.set(i, j, source.x(), source.y());
+            else
+                mMap.setInvalid(i, j);
+        }
+    }
+}
+
+class ParallelTileBuilder
+{
+public:
+    ComposedRemap *remap;
+    const vector<int> *tiles;
+
+    ParallelTileBuilder(ComposedRemap *_remap, const vector<int> *_tiles) :
+        remap(_remap), tiles(_tiles)
+    {}
+
+    void operator()(const BlockedRange<int> &r) const
+    {
+        for (int i = r.begin(); i < r.end(); i++)
+            remap->buildTile(tiles->at(i));
+    }
+};
+
+void ComposedRemap::prepare(int y, int x, int h, int w)
+{
+    if (mTilesMissing == 0 || h <= 0 || w <= 0)
+        return;
+
+    int tileY1 = CORE_MAX(0, y / RemapEngine::TILE_H);
+    int tileX1 = CORE_MAX(0, x / RemapEngine::TILE_W);
+    int tileY2 = CORE_MIN(mTilesH - 1, (y + h - 1) / RemapEngine::TILE_H);
+    int tileX2 = CORE_MIN(mTilesW - 1, (x + w - 1) / RemapEngine::TILE_W);
+
+    vector<int> missing;
+    for (int tileY = tileY1; tileY <= tileY2; tileY++)
+        for (int tileX = tileX1; tileX <= tileX2; tileX++)
+            if (!isTileReady(tileY, tileX))
+                missing.push_back(tileY * mTilesW + tileX);
+
+    if (missing.empty())
+        return;
+
+    TRACE_ZONE("ComposedRemap::prepare");
+    parallelable_for(0, (int)missing.size(), 1, ParallelTileBuilder(this, &missing));
+
+    for (unsigned i = 0; i < missing.size(); i++)
+        mTileReady[missing[i]] = 1;
+    mTilesMissing -= (int)missing.size();
+    mTilesBuilt   += (int)missing.size();
+
+    if (mTilesMissing == 0 && !mCacheDirectory.empty())
+        saveCache(cacheFileName(mCacheDirectory, mKey));
+}
+
+bool ComposedRemap::setCacheDirectory(const string &directory)
+{
+    mCacheDirectory = directory;
+    if (mCacheDirectory.empty())
+        return false;
+
+    if (mTilesMissing != 0 && loadCache(cacheFileName(mCacheDirectory, mKey)))
+        return true;
+
+    if (mTilesMissing == 0)
+        saveCache(cacheFileName(mCacheDirectory, mKey));
+    return false;
+}
+
+string ComposedRemap::cacheFileName(const string &directory, uint64_t key)
+{
+    char name[64];
+    snprintf2buf(name, "remap_%016llx.bin", (unsigned long long)key);
+    return directory + "/" + name;
+}
+
+static const char REMAP_CACHE_MAGIC[8] = {'C', 'V', 'S', 'R', 'E', 'M', 'A', 'P'};
+
+/**
+ *  The cache file is the magic, the key, the four sizes and the raw map arrays.
+ *  The arrays are stored in the machine byte order, the cache is not meant to be moved between machines.
+ **/
+bool ComposedRemap::saveCache(const string &fileName) const
+{
+    if (mTilesMissing != 0)
+        return false;
+
+    /* Written under the temporary name, so the reader never sees the partial file */
+    string temporary = fileName + ".tmp";
+    ofstream file(temporary.c_str(), ios::out | ios::binary);
+    if (!file)
+        return false;
+
+    file.write(REMAP_CACHE_MAGIC, sizeof(REMAP_CACHE_MAGIC));
+    write_integer_bin(file, (uint32_t)(mKey & 0xFFFFFFFF));
+    write_integer_bin(file, (uint32_t)(mKey >> 32));
+    write_integer_bin(file, (int32_t)mMap.h);
+    write_integer_bin(file, (int32_t)mMap.w);
+    write_integer_bin(file, (int32_t)mMap.inputH);
+    write_integer_bin(file, (int32_t)mMap.inputW);
+    file.write((const char *)&mMap.coords[0],    mMap.coords.size()    * sizeof(int16_t));
+    file.write((const char *)&mMap.fractions[0], mMap.fractions.size() * sizeof(uint16_t));
+    file.close();
+
+    if (file.fail())
+    {
+        remove(temporary.c_str());
+        return false;
+    }
+    remove(fileName.c_str());
+    return rename(temporary.c_str(), fileName.c_str()) == 0;
+}
+
+bool ComposedRemap::loadCache(const string &fileName)
+{
+    ifstream file(fileName.c_str(), ios::in | ios::binary);
+    if (!file)
+        return false;
+
+    char magic[sizeof(REMAP_CACHE_MAGIC)];
+    file.read(magic, sizeof(magic));
+    if (!file || !std::equal(magic, magic + sizeof(magic), REMAP_CACHE_MAGIC))
+        return false;
+
+    /* read_integer_bin() shifts int, so the 64 bit key is stored in two halves */
+    uint32_t keyLow = 0, keyHigh = 0;
+    int32_t h = 0, w = 0, inputH = 0, inputW = 0;
+    read_integer_bin(file, keyLow);
+    read_integer_bin(file, keyHigh);
+    read_integer_bin(file, h);
+    read_integer_bin(file, w);
+    read_integer_bin(file, inputH);
+    read_integer_bin(file, inputW);
+    uint64_t key = ((uint64_t)keyHigh << 32) | keyLow;
+    if (!file || key != mKey || h != mMap.h || w != mMap.w || inputH != mMap.inputH || inputW != mMap.inputW)
+        return false;
+
+    vector<int16_t>  coords   (mMap.coords.size());
+    vector<uint16_t> fractions(mMap.fractions.size());
+    file.read((char *)&coords[0],    coords.size()    * sizeof(int16_t));
+    file.read((char *)&fractions[0], fractions.size() * sizeof(uint16_t));
+    if (!file)
+        return false;
+
+    /* The damaged file with the matching header should not make the remap read outside of the input */
+    RemapMap loaded(mMap.h, mMap.w, mMap.inputH, mMap.inputW);
+    loaded.coords.swap(coords);
+    loaded.fractions.swap(fractions);
+    if (!loaded.verify())
+        return false;
+
+    mMap.coords.swap(loaded.coords);
+    mMap.fractions.swap(loaded.fractions);
+    std::fill(mTileReady.begin(), mTileReady.end(), 1);
+    mTilesMissing = 0;
+    return true;
+}
+
+void ComposedRemap::remap(G12Buffer *input, G12Buffer *output, int y, int x, int h, int w, RemapEngine::Interpolation interpolation)
+{
+    prepare(y, x, h, w);
+    RemapEngine::remap(mMap, input, output, y, x, h, w, interpolation);
+}
+
+void ComposedRemap::remap(G12Buffer *input, G12Buffer *output, RemapEngine::Interpolation interpolation)
+{
+    remap(input, output, 0, 0, mMap.h, mMap.w, interpolation);
+}
+
+G12Buffer *ComposedRemap::remap(G12Buffer *input, RemapEngine::Interpolation interpolation)
+{
+    G12Buffer *output = new G12Buffer(mMap.h, mMap.w, false);
+    remap(input, output, interpolation);
+    return output;
+}
+
+ComposedRemap::~ComposedRemap()
+{
+    delete_safe(mChain);
+}
+
+} //namespace corecvs
@@ -0,0 +1,290 @@
+#pragma once
+/**
+ * \file deformChain.h
+ * \brief Composition of the deformations into one lazily built remap table
+ *
+ * Lens undistortion and rectification are usually applied as separate warps, each of them reading
+ * and writing the whole frame. DeformChain concatenates the inverse mappings, so the composed
+ * RemapMap gives the camera pixel for each output pixel directly and the frame is warped once.
+ *
+ * ComposedRemap builds the table by tiles on demand, tiles are built in parallel,
+ * and the complete table can be stored on disk under the hash of the chain parameters.
+ *
+ * \date Oct 19, 2026
+ * \ingroup cppcorefiles
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "global.h"
+
+#include "matrix33.h"
+#include "displacementBuffer.h"
+#include "radialCorrection.h"
+#include "sphericalCorrectionLUT.h"
+#include "remapEngine.h"
+
+namespace corecvs {
+
+using std::string;
+using std::vector;
+
+/**
+ *  FNV-1a hash of the deformation parameters
+ **/
+class ParameterHash
+{
+public:
+    uint64_t value;
+
+    ParameterHash() : value(14695981039346656037ULL) {}
+
+    void add(const void *data, size_t size)
+    {
+        const uint8_t *bytes = (const uint8_t *)data;
+        for (size_t i = 0; i < size; i++)
+        {
+            value ^= bytes[i];
+            value *= 1099511628211ULL;
+        }
+    }
+
+    void add(int    v) { int64_t wide = v; add(&wide, sizeof(wide)); }
+    void add(double v) { add(&v, sizeof(v)); }
+    void add(const Vector2dd &v) { add(v.x()); add(v.y()); }
+};
+
+/**
+ *  One inverse mapping of the chain. It takes the point of the output of the step
+ *  and returns the point of its input.
+ **/
+class DeformStep
+{
+public:
+    /** \return false if the point has no source */
+    virtual bool map(const Vector2dd &point, Vector2dd &source) const = 0;
+
+    /** Adds all the parameters the mapping depends on */
+    virtual void hash(ParameterHash &hash) const = 0;
+
+    virtual ~DeformStep() {}
+};
+
+/** Projective step, the matrix maps the output to the input, like the one of TransformationCache */
+class ProjectiveDeformStep : public DeformStep
+{
+public:
+    Matrix33 inverse;
+
+    explicit ProjectiveDeformStep(const Matrix33 &_inverse) : inverse(_inverse) {}
+
+    virtual bool map(const Vector2dd &point, Vector2dd &source) const;
+    virtual void hash(ParameterHash &hash) const;
+};
+
+/** Lens distortion step with the RadialCorrection that maps the corrected image to the camera one */
+class RadialDeformStep : public DeformStep
+{
+public:
+    RadialCorrection correction;
+
+    explicit RadialDeformStep(const LensCorrectionParametres &params) : correction(params) {}
+
+    virtual bool map(const Vector2dd &point, Vector2dd &source) const;
+    virtual void hash(ParameterHash &hash) const;
+};
+
+/**
+ *  Spherical LUT correction step. The LUT is copied so the step does not depend on the caller,
+ *  the correction over it is made once with the step
+ **/
+class SphericalDeformStep : public DeformStep
+{
+public:
+    vector<Vector2dd>      lut;
+    RadiusCorrectionLUT    radiusDeformer;
+    Vector2dd              center;
+    SphericalCorrectionLUT correction;
+
+    SphericalDeformStep(const Vector2dd &_center, const vector<Vector2dd> &_lut) :
+        lut(_lut),
+        radiusDeformer(&lut),
+        center(_center),
+        correction(_center, &radiusDeformer)
+    {}
+
+    virtual bool map(const Vector2dd &point, Vector2dd &source) const;
+    virtual void hash(ParameterHash &hash) const;
+
+private:
+    SphericalDeformStep(const SphericalDeformStep &);
+    SphericalDeformStep &operator=(const SphericalDeformStep &);
+};
+
+/**
+ *  Step with the tabulated displacement, like the distortion transform of the camera configuration.
+ *  Between the nodes the displacement is interpolated bilinearly, outside of the table there is no source.
+ **/
+class DisplacementDeformStep : public DeformStep
+{
+public:
+    DisplacementBuffer *displacement;
+
+    /** The buffer is copied */
+    explicit DisplacementDeformStep(DisplacementBuffer *_displacement) :
+        displacement(new DisplacementBuffer(_displacement))
+    {}
+
+    virtual bool map(const Vector2dd &point, Vector2dd &source) const;
+    virtual void hash(ParameterHash &hash) const;
+
+    virtual ~DisplacementDeformStep();
+
+private:
+    DisplacementDeformStep(const DisplacementDeformStep &);
+    DisplacementDeformStep &operator=(const DisplacementDeformStep &);
+};
+
+/**
+ *  The chain of the inverse mappings. The output pixel goes through the steps in the order
+ *  they were added, so for the rectified undistorted image the rectification comes first and
+ *  the lens distortion last.
+ **/
+class DeformChain
+{
+public:
+    DeformChain() {}
+
+    /** Takes the ownership of the step */
+    DeformChain &add(DeformStep *step)
+    {
+        mSteps.push_back(step);
+        return *this;
+    }
+
+    int stepsNumber() const
+    {
+        return (int)mSteps.size();
+    }
+
+    bool map(const Vector2dd &point, Vector2dd &source) const;
+
+    void hash(ParameterHash &hash) const;
+
+    ~DeformChain();
+
+private:
+    vector<DeformStep *> mSteps;
+
+    DeformChain(const DeformChain &);
+    DeformChain &operator=(const DeformChain &);
+};
+
+/**
+ *  RemapMap of the DeformChain that is filled tile by tile when the tiles are requested.
+ *
+ *  prepare() is not reentrant, the callers that share the table should prepare it before
+ *  handing it over to the worker threads.
+ **/
+class ComposedRemap
+{
+public:
+    /**
+     * Takes the ownership of the chain
+     * \param h       output height
+     * \param w       output width
+     * \param inputH  height of the buffers the chain is applied to
+     * \param inputW  width of the buffers the chain is applied to
+     **/
+    ComposedRemap(DeformChain *chain, int h, int w, int inputH, int inputW);
+
+    /** Hash of the chain and of the sizes, the key of the disk cache */
+    uint64_t key() const
+    {
+        return mKey;
+    }
+
+    int tilesH() const { return mTilesH; }
+    int tilesW() const { return mTilesW; }
+
+    bool isTileReady(int tileY, int tileX) const
+    {
+        return mTileReady[tileY * mTilesW + tileX] != 0;
+    }
+
+    bool isComplete() const
+    {
+        return mTilesMissing == 0;
+    }
+
+    /** Number of the tiles computed by this object, the tiles read from the disk are not counted */
+    int tilesBuilt() const
+    {
+        return mTilesBuilt;
+    }
+
+    /** Builds the missing tiles that intersect the output rectangle */
+    void prepare(int y, int x, int h, int w);
+
+    void prepareAll()
+    {
+        prepare(0, 0, mMap.h, mMap.w);
+    }
+
+    /** The table with all the tiles built. remap() builds only the tiles it reads */
+    const RemapMap &map()
+    {
+        prepareAll();
+        return mMap;
+    }
+
+    /**
+     * Enables the disk cache in the given directory. If the file of the same key exists
+     * the table is read from it at once, otherwise it is written there when the table is completed.
+     * \return true if the table was read from the disk
+     **/
+    bool setCacheDirectory(const string &directory);
+
+    /** The file the table with this key is stored in */
+    static string cacheFileName(const string &directory, uint64_t key);
+
+    bool saveCache(const string &fileName) const;
+    bool loadCache(const string &fileName);
+
+    /**
+     * Warps the output rectangle, only the tiles of the rectangle are built.
+     * The output pixels outside of the rectangle are not changed.
+     **/
+    void remap(G12Buffer *input, G12Buffer *output, int y, int x, int h, int w, RemapEngine::Interpolation interpolation = RemapEngine::BILINEAR);
+
+    void remap(G12Buffer *input, G12Buffer *output, RemapEngine::Interpolation interpolation = RemapEngine::BILINEAR);
+    G12Buffer *remap(G12Buffer *input, RemapEngine::Interpolation interpolation = RemapEngine::BILINEAR);
+
+    ~ComposedRemap();
+
+private:
+    friend class ParallelTileBuilder;
+
+    DeformChain    *mChain;
+    RemapMap        mMap;
+    uint64_t        mKey;
+
+    int             mTilesH;
+    int             mTilesW;
+    vector<uint8_t> mTileReady;
+    int             mTilesMissing;
+    int             mTilesBuilt;
+
+    string          mCacheDirectory;
+
+    void buildTile(int tile);
+
+    ComposedRemap(const ComposedRemap &);
+    ComposedRemap &operator=(const ComposedRemap &);
+};
+
+} //namespace corecvs
+
+/* EOF */
@@ -0,0 +1,350 @@
+/**
+ * \file remapEngine.cpp
+ * \brief Fixed point remap of G12 buffers with the precomputed maps
+ *
+ * \date Oct 19, 2026
+ * \ingroup cppcorefiles
+ */
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+#include <math.h>
+
+#include "remapEngine.h"
+#include "mathUtils.h"
+#include "tbbWrapper.h"
+#include "zoneTracer.h"
+
+namespace corecvs {
+
+const int     RemapMap::FRACTION_BITS;
+const int     RemapMap::FRACTION_ONE;
+const int16_t RemapMap::INVALID;
+
+const int RemapEngine::TILE_H;
+const int RemapEngine::TILE_W;
+
+RemapMap::RemapMap(int _h, int _w, int _inputH, int _inputW) :
+    h(_h)
+  , w(_w)
+  , inputH(_inputH)
+  , inputW(_inputW)
+  , coords(2 * _h * _w, INVALID)
+  , fractions(_h * _w, 0)
+{
+    ASSERT_TRUE(inputH >= 2 && inputW >= 2, "RemapMap needs the input of at least 2x2");
+    ASSERT_TRUE(inputH <= 32767 && inputW <= 32767, "RemapMap input is too large for int16 coordinates");
+}
+
+void RemapMap::set(int y, int x, double sourceX, double sourceY)
+{
+    double limitX = (double)(inputW - 1) * FRACTION_ONE;
+    double limitY = (double)(inputH - 1) * FRACTION_ONE;
+    double scaledX = sourceX * FRACTION_ONE;
+    double scaledY = sourceY * FRACTION_ONE;
+
+    /* Also rejects NaN */
+    if (!(scaledX > -0.5 && scaledX < limitX + 0.5 && scaledY > -0.5 && scaledY < limitY + 0.5))
+    {
+        setInvalid(y, x);
+        return;
+    }
+
+    int qx = fround(scaledX);
+    int qy = fround(scaledY);
+    int ix = qx >> FRACTION_BITS;
+    int iy = qy >> FRACTION_BITS;
+    int fx = qx & (FRACTION_ONE - 1);
+    int fy = qy & (FRACTION_ONE - 1);
+
+    /* The last row and column are reached from the previous pixel with the full fraction */
+    if (ix == inputW - 1)
+    {
+        ix--;
+        fx = FRACTION_ONE;
+    }
+    if (iy == inputH - 1)
+    {
+        iy--;
+        fy = FRACTION_ONE;
+    }
+
+    int index = y * w + x;
+    coords[2 * index    ] = (int16_t)ix;
+    coords[2 * index + 1] = (int16_t)iy;
+    fractions[index] = (uint16_t)(fx | (fy << 8));
+}
+
+bool RemapMap::verify() const
+{
+    if (coords.size() != 2 * (size_t)h * w || fractions.size() != (size_t)h * w)
+        return false;
+
+    for (int index = 0; index < h * w; index++)
+    {
+        int x = coords[2 * index];
+        if (x == INVALID)
+            continue;
+        int y  = coords[2 * index + 1];
+        int fx = fractions[index] & 0xFF;
+        int fy = fractions[index] >> 8;
+        if (x < 0 || y < 0 || x > inputW - 2 || y > inputH - 2 || fx > FRACTION_ONE || fy > FRACTION_ONE)
+            return false;
+    }
+    return true;
+}
+
+RemapMap *RemapMap::fromMatrix(const Matrix33 &inverse, int h, int w, int inputH, int inputW)
+{
+    RemapMap *result = new RemapMap(h, w, inputH, inputW);
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            Vector2dd source = inverse * Vector2dd(j, i);
+            result->set(i, j, source.x(), source.y());
+        }
+    }
+    return result;
+}
+
+/**
+ *  Catmull-Rom weights for each of the fractions, scaled to 1 << CUBIC_BITS
+ **/
+class CubicWeights
+{
+public:
+    static const int CUBIC_BITS = 7;
+
+    int32_t weights[RemapMap::FRACTION_ONE + 1][4];
+
+    CubicWeights()
+    {
+        for (int f = 0; f <= RemapMap::FRACTION_ONE; f++)
+        {
+            double t  = (double)f / RemapMap::FRACTION_ONE;
+            double t2 = t * t;
+            double t3 = t2 * t;
+            double raw[4] = {
+                (-t3 + 2 * t2 - t) / 2.0,
+                (3 * t3 - 5 * t2 + 2) / 2.0,
+                (-3 * t3 + 4 * t2 + t) / 2.0,
+                (t3 - t2) / 2.0
+            };
+
+            int32_t sum = 0;
+            for (int k = 0; k < 4; k++)
+            {
+                weights[f][k] = fround(raw[k] * (1 << CUBIC_BITS));
+                sum += weights[f][k];
+            }
+            weights[f][t < 0.5 ? 1 : 2] += (1 << CUBIC_BITS) - sum;
+        }
+    }
+
+    static const CubicWeights &instance()
+    {
+        static CubicWeights weights;
+        return weights;
+    }
+};
+
+static const int G12_MAX_VALUE = (1 << 12) - 1;
+
+class ParallelRemap
+{
+public:
+    const RemapMap *map;
+    G12Buffer *input;
+    G12Buffer *output;
+    RemapEngine::Interpolation interpolation;
+    const CubicWeights *cubic;
+    /* Output rectangle */
+    int x1, y1, x2, y2;
+
+    ParallelRemap(const RemapMap *_map, G12Buffer *_input, G12Buffer *_output, RemapEngine::Interpolation _interpolation,
+                  int _x1, int _y1, int _x2, int _y2) :
+        map(_map), input(_input), output(_output), interpolation(_interpolation),
+        cubic(&CubicWeights::instance()),
+        x1(_x1), y1(_y1), x2(_x2), y2(_y2)
+    {}
+
+    inline uint16_t bilinear(int x, int y, int fx, int fy) const
+    {
+        const uint16_t *top    = &input->element(y, x);
+        const uint16_t *bottom = top + input->stride;
+        uint32_t w00 = (RemapMap::FRACTION_ONE - fx) * (RemapMap::FRACTION_ONE - fy);
+        uint32_t w01 = fx * (RemapMap::FRACTION_ONE - fy);
+        uint32_t w10 = (RemapMap::FRACTION_ONE - fx) * fy;
+        uint32_t w11 = fx * fy;
+        uint32_t sum = top[0] * w00 + top[1] * w01 + bottom[0] * w10 + bottom[1] * w11;
+        return (uint16_t)((sum + (1 << (2 * RemapMap::FRACTION_BITS - 1))) >> (2 * RemapMap::FRACTION_BITS));
+    }
+
+    inline uint16_t bicubic(int x, int y, int fx, int fy) const
+    {
+        if (x < 1 || y < 1 || x + 2 >= input->w || y + 2 >= input->h)
+            return bilinear(x, y, fx, fy);
+
+        const int32_t *wx = cubic->weights[fx];
+        const int32_t *wy = cubic->weights[fy];
+        const uint16_t *row = &input->element(y - 1, x - 1);
+        int32_t sum = 0;
+        for (int k = 0; k < 4; k++, row += input->stride)
+        {
+            int32_t line = row[0] * wx[0] + row[1] * wx[1] + row[2] * wx[2] + row[3] * wx[3];
+            sum += line * wy[k];
+        }
+        sum = (sum + (1 << (2 * CubicWeights::CUBIC_BITS - 1))) >> (2 * CubicWeights::CUBIC_BITS);
+        return (uint16_t)CORE_MAX(0, CORE_MIN(G12_MAX_VALUE, sum));
+    }
+
+    inline uint16_t pixel(int index) const
+    {
+        int x = map->coords[2 * index];
+        if (x == RemapMap::INVALID)
+            return 0;
+        int y  = map->coords[2 * index + 1];
+        int fx = map->fractions[index] & 0xFF;
+        int fy = map->fractions[index] >> 8;
+
+        switch (interpolation)
+        {
+            case RemapEngine::NEAREST:
+                return input->element(y + (fy >= RemapMap::FRACTION_ONE / 2), x + (fx >= RemapMap::FRACTION_ONE / 2));
+            case RemapEngine::BICUBIC:
+                return bicubic(x, y, fx, fy);
+            default:
+                return bilinear(x, y, fx, fy);
+        }
+    }
+
+#ifdef WITH_SSE
+    /**
+     * Bilinear interpolation of 8 pixels. The corners are gathered with the scalar loads,
+     * the weights and the sums are computed with madd of the interleaved 16 bit pairs.
+     **/
+    ALIGN_STACK_SSE inline void bilinear8(int index, uint16_t *out) const
+    {
+        ALIGN_DATA(16) int16_t top   [16];
+        ALIGN_DATA(16) int16_t bottom[16];
+        ALIGN_DATA(16) int16_t fxs[8];
+        ALIGN_DATA(16) int16_t fys[8];
+
+        const int16_t  *coords    = &map->coords[2 * index];
+        const uint16_t *fractions = &map->fractions[index];
+        int stride = input->stride;
+
+        for (int k = 0; k < 8; k++)
+        {
+            int x = coords[2 * k];
+            if (x == RemapMap::INVALID)
+            {
+                top[2 * k] = top[2 * k + 1] = bottom[2 * k] = bottom[2 * k + 1] = 0;
+                fxs[k] = fys[k] = 0;
+                continue;
+            }
+            const uint16_t *corner = &input->element(coords[2 * k + 1], x);
+            top   [2 * k    ] = corner[0];
+            top   [2 * k + 1] = corner[1];
+            bottom[2 * k    ] = corner[stride];
+            bottom[2 * k + 1] = corner[stride + 1];
+            fxs[k] = fractions[k] & 0xFF;
+            fys[k] = fractions[k] >> 8;
+        }
+
+        __m128i one = _mm_set1_epi16(RemapMap::FRACTION_ONE);
+        __m128i fx  = _mm_load_si128((__m128i *)fxs);
+        __m128i fy  = _mm_load_si128((__m128i *)fys);
+        __m128i ifx = _mm_sub_epi16(one, fx);
+        __m128i ify = _mm_sub_epi16(one, fy);
+
+        __m128i w00 = _mm_mullo_epi16(ifx, ify);
+        __m128i w01 = _mm_mullo_epi16(fx , ify);
+        __m128i w10 = _mm_mullo_epi16(ifx, fy );
+        __m128i w11 = _mm_mullo_epi16(fx , fy );
+
+        __m128i topWeightsLow     = _mm_unpacklo_epi16(w00, w01);
+        __m128i topWeightsHigh    = _mm_unpackhi_epi16(w00, w01);
+        __m128i bottomWeightsLow  = _mm_unpacklo_epi16(w10, w11);
+        __m128i bottomWeightsHigh = _mm_unpackhi_epi16(w10, w11);
+
+        __m128i round = _mm_set1_epi32(1 << (2 * RemapMap::FRACTION_BITS - 1));
+
+        __m128i low = _mm_add_epi32(
+                _mm_madd_epi16(_mm_load_si128((__m128i *)&top   [0]), topWeightsLow),
+                _mm_madd_epi16(_mm_load_si128((__m128i *)&bottom[0]), bottomWeightsLow));
+        __m128i high = _mm_add_epi32(
+                _mm_madd_epi16(_mm_load_si128((__m128i *)&top   [8]), topWeightsHigh),
+                _mm_madd_epi16(_mm_load_si128((__m128i *)&bottom[8]), bottomWeightsHigh));
+
+        low  = _mm_srli_epi32(_mm_add_epi32(low,  round), 2 * RemapMap::FRACTION_BITS);
+        high = _mm_srli_epi32(_mm_add_epi32(high, round), 2 * RemapMap::FRACTION_BITS);
+
+        _mm_storeu_si128((__m128i *)out, _mm_packs_epi32(low, high));
+    }
+#endif
+
+    ALIGN_STACK_SSE void operator()(const BlockedRange<int> &r) const
+    {
+        for (int band = r.begin(); band < r.end(); band++)
+        {
+            int startY = CORE_MAX(y1, band * RemapEngine::TILE_H);
+            int endY   = CORE_MIN(y2, (band + 1) * RemapEngine::TILE_H);
+
+            for (int tileX = x1 / RemapEngine::TILE_W * RemapEngine::TILE_W; tileX < x2; tileX += RemapEngine::TILE_W)
+            {
+                int startX = CORE_MAX(x1, tileX);
+                int endX   = CORE_MIN(x2, tileX + RemapEngine::TILE_W);
+                for (int i = startY; i < endY; i++)
+                {
+                    uint16_t *out = &output->element(i, 0);
+                    int index = i * map->w;
+                    int j = startX;
+#ifdef WITH_SSE
+                    if (interpolation == RemapEngine::BILINEAR)
+                    {
+                        for (; j + 8 <= endX; j += 8)
+                            bilinear8(index + j, out + j);
+                    }
+#endif
+                    for (; j < endX; j++)
+                        out[j] = pixel(index + j);
+                }
+            }
+        }
+    }
+};
+
+void RemapEngine::remap(const RemapMap &map, G12Buffer *input, G12Buffer *output, Interpolation interpolation)
+{
+    remap(map, input, output, 0, 0, map.h, map.w, interpolation);
+}
+
+void RemapEngine::remap(const RemapMap &map, G12Buffer *input, G12Buffer *output, int y, int x, int h, int w, Interpolation interpolation)
+{
+    TRACE_ZONE("RemapEngine::remap");
+
+    ASSERT_TRUE(input->h == map.inputH && input->w == map.inputW, "Map is computed for the other input size");
+    ASSERT_TRUE(output->h >= map.h && output->w >= map.w, "Output is smaller than the map");
+
+    int x1 = CORE_MAX(x, 0);
+    int y1 = CORE_MAX(y, 0);
+    int x2 = CORE_MIN(x + w, map.w);
+    int y2 = CORE_MIN(y + h, map.h);
+    if (x1 >= x2 || y1 >= y2)
+        return;
+
+    /* The bands stay on the tile grid, so the region reads the same map tiles as the whole frame */
+    parallelable_for(y1 / TILE_H, (y2 - 1) / TILE_H + 1, 1, ParallelRemap(&map, input, output, interpolation, x1, y1, x2, y2));
+}
+
+G12Buffer *RemapEngine::remap(const RemapMap &map, G12Buffer *input, Interpolation interpolation)
+{
+    G12Buffer *output = new G12Buffer(map.h, map.w, false);
+    remap(map, input, output, interpolation);
+    return output;
+}
+
+} //namespace corecvs
@@ -0,0 +1,131 @@
+#pragma once
+/**
+ * \file remapEngine.h
+ * \brief Fixed point remap of G12 buffers with the precomputed maps
+ *
+ * The map is computed once from any deformation (projective rectification, lens correction,
+ * or their composition) and packed into int16 integer coordinates with 5 fractional bits.
+ * Each frame is then warped with integer arithmetic only, the output is processed in
+ * tiles so the source reads of one tile stay in cache, and the bands of tiles run in parallel.
+ *
+ * \date Oct 19, 2026
+ * \ingroup cppcorefiles
+ */
+
+#include <stdint.h>
+#include <vector>
+
+#include "global.h"
+
+#include "g12Buffer.h"
+#include "matrix33.h"
+
+namespace corecvs {
+
+using std::vector;
+
+/**
+ *  The source point for each pixel of the output.
+ *
+ *  The integer part is stored as int16, the fractions are in 1/32 of the pixel, 0..32 inclusive,
+ *  so the point on the last row or column is represented as the previous pixel with the full fraction
+ *  and the bilinear interpolation never reads outside of the input.
+ **/
+class RemapMap
+{
+public:
+    static const int FRACTION_BITS = 5;
+    static const int FRACTION_ONE  = 1 << FRACTION_BITS;
+    static const int16_t INVALID   = -32768;
+
+    int h;
+    int w;
+    int inputH;
+    int inputW;
+
+    /** x and y of each output pixel */
+    vector<int16_t>  coords;
+    /** Fraction of x in the bits 0..5 and of y in the bits 8..13 */
+    vector<uint16_t> fractions;
+
+    /**
+     * \param h  output height
+     * \param w  output width
+     * \param inputH  height of the buffers the map is applied to
+     * \param inputW  width of the buffers the map is applied to
+     **/
+    RemapMap(int h, int w, int inputH, int inputW);
+
+    /** Sets the source point of the output pixel. The points outside of the input are marked invalid */
+    void set(int y, int x, double sourceX, double sourceY);
+
+    void setInvalid(int y, int x)
+    {
+        coords[2 * (y * w + x)] = INVALID;
+    }
+
+    bool isValid(int y, int x) const
+    {
+        return coords[2 * (y * w + x)] != INVALID;
+    }
+
+    /** Checks that all the valid sources are the ones set() gives, so the remap never reads outside of the input */
+    bool verify() const;
+
+    /**
+     * Map of the projective transformation
+     * \param inverse  matrix that maps the output pixel to the input
+     **/
+    static RemapMap *fromMatrix(const Matrix33 &inverse, int h, int w, int inputH, int inputW);
+
+    /**
+     * Map of any deformation that returns the source Vector2dd for map(y, x) of the output pixel,
+     * like DisplacementBuffer or RadialCorrection
+     **/
+    template<typename DeformMapType>
+    static RemapMap *fromDeformMap(const DeformMapType *map, int h, int w, int inputH, int inputW)
+    {
+        RemapMap *result = new RemapMap(h, w, inputH, inputW);
+        for (int i = 0; i < h; i++)
+        {
+            for (int j = 0; j < w; j++)
+            {
+                Vector2dd source = map->map(i, j);
+                result->set(i, j, source.x(), source.y());
+            }
+        }
+        return result;
+    }
+};
+
+/**
+ *  Applies the RemapMap to the G12 buffers
+ **/
+class RemapEngine
+{
+public:
+    enum Interpolation {
+        NEAREST,
+        BILINEAR,
+        BICUBIC   /**< Catmull-Rom, falls back to bilinear at one pixel from the input border */
+    };
+
+    static const int TILE_H = 16;
+    static const int TILE_W = 128;
+
+    /**
+     * Warps the input into the output of the map size. The output pixels with the invalid source are zero.
+     * The SIMD path expects the values to be 15 bit at most, which holds for G12 buffers.
+     **/
+    static void remap(const RemapMap &map, G12Buffer *input, G12Buffer *output, Interpolation interpolation = BILINEAR);
+
+    /** Warps only the output rectangle clipped by the map, the rest of the output is not changed */
+    static void remap(const RemapMap &map, G12Buffer *input, G12Buffer *output, int y, int x, int h, int w, Interpolation interpolation = BILINEAR);
+
+    /** Allocates and returns the output */
+    static G12Buffer *remap(const RemapMap &map, G12Buffer *input, Interpolation interpolation = BILINEAR);
+};
+
+} //namespace corecvs
+
+/* EOF */
@@ -16,6 +16,7 @@
 #include "arithmetic.h"
 #include "threshold.h"
 #include "vectorTraits.h"
+#include "bufferReduction.h"
 //#include "rgb24/hardcodeFont.h"
 
 namespace corecvs {
@@ -32,19 +33,13 @@ void G12Buffer::print()
 
 bool G12Buffer::verify()
 {
-    for (int i = 0; i < this->h; i++)
+    ReductionResult<uint16_t> range = BufferReduction::minMax(this);
+    if (range.max > G12Buffer::BUFFER_MAX_VALUE)
     {
-        for (int j = 0; j < this->w; j++)
-        {
-            if (this->element(i,j) > G12Buffer::BUFFER_MAX_VALUE)
-            {
-                DOTRACE(("verification failed at position %d %d with value %x\n", i,j, this->element(i,j)));
-                return false;
-            }
-        }
+        DOTRACE(("verification failed at position %d %d with value %x\n", range.maxPosition.y(), range.maxPosition.x(), range.max));
+        return false;
     }
     return true;
-
 }
 
 
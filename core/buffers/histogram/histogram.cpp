@@ -10,8 +10,17 @@
 #include "global.h"
 
 #include "histogram.h"
+#include "histogramBuilder.h"
 namespace corecvs {
 
+Histogram::Histogram(G12Buffer *buffer)
+{
+    ASSERT_TRUE(buffer != NULL, "Input buffer should not be NULL");
+
+    _init(0, G12Buffer::BUFFER_MAX_VALUE);
+    HistogramBuilder::add(this, buffer);
+}
+
 Histogram::~Histogram()
 {
     // TODO Auto-generated destructor stub
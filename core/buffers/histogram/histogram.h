@@ -30,6 +30,7 @@ using std::vector;
  **/
 class Histogram
 {
+    friend class HistogramBuilder;
 protected:
     int maxValue;
     int totalSum;
@@ -60,22 +61,8 @@ public:
         totalSum = buffer->h * buffer->w;
     }
 
-    Histogram(G12Buffer *buffer)
-    {
-        ASSERT_TRUE(buffer != NULL, "Input buffer should not be NULL");
-
-        _init(0, G12Buffer::BUFFER_MAX_VALUE);
-        for (int i = 0; i < buffer->h; i++)
-        {
-            for (int j = 0; j < buffer->w; j++)
-            {
-                int result = buffer->element(i, j);
-                ASSERT_TRUE(result <= G12Buffer::BUFFER_MAX_VALUE, "G12Buffer has overflows");
-                data[result]++;
-            }
-        }
-        totalSum = buffer->h * buffer->w;
-    }
+    /** Full range histogram, counted with HistogramBuilder */
+    Histogram(G12Buffer *buffer);
 
 
     inline void inc(int argument)
@@ -0,0 +1,386 @@
+/**
+ * \file histogramBuilder.cpp
+ * \brief Parallel histogram counting, joint and sliding window histograms of G12 buffers
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#include <math.h>
+
+#include "global.h"
+
+#include "histogramBuilder.h"
+#include "tbbWrapper.h"
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace corecvs {
+
+const int HistogramBuilder::BANKS;
+const int SlidingHistogram::FINE_BITS;
+const int SlidingHistogram::COARSE_SIZE;
+
+double JointHistogram::mutualInformation() const
+{
+    if (totalSum == 0)
+        return 0.0;
+
+    vector<double> marginalA(binsA, 0.0);
+    vector<double> marginalB(binsB, 0.0);
+    for (int a = 0; a < binsA; a++)
+    {
+        for (int b = 0; b < binsB; b++)
+        {
+            marginalA[a] += getData(a, b);
+            marginalB[b] += getData(a, b);
+        }
+    }
+
+    double total = (double)totalSum;
+    double result = 0.0;
+    for (int a = 0; a < binsA; a++)
+    {
+        if (marginalA[a] == 0.0)
+            continue;
+        for (int b = 0; b < binsB; b++)
+        {
+            unsigned count = getData(a, b);
+            if (count == 0)
+                continue;
+            result += count / total * log(count * total / (marginalA[a] * marginalB[b]));
+        }
+    }
+    return result / log(2.0);
+}
+
+int SlidingHistogram::rank(int value) const
+{
+    int result = 0;
+    int coarse = value >> FINE_BITS;
+    for (int c = 0; c < coarse; c++)
+        result += mCoarse[c];
+    for (int v = coarse << FINE_BITS; v < value; v++)
+        result += mFine[v];
+    return result;
+}
+
+void SlidingHistogram::clear()
+{
+    mFine.assign(mFine.size(), 0);
+    mCoarse.assign(mCoarse.size(), 0);
+    mTotal = 0;
+}
+
+Rectangle<int32_t> HistogramBuilder::clip(G12Buffer *buffer, const Rectangle<int32_t> *roi)
+{
+    if (roi == NULL)
+        return Rectangle<int32_t>(0, 0, buffer->w, buffer->h);
+
+    int x1 = CORE_MAX(roi->corner.x(), 0);
+    int y1 = CORE_MAX(roi->corner.y(), 0);
+    int x2 = CORE_MIN(roi->corner.x() + roi->size.x(), buffer->w);
+    int y2 = CORE_MIN(roi->corner.y() + roi->size.y(), buffer->h);
+    return Rectangle<int32_t>(x1, y1, CORE_MAX(x2 - x1, 0), CORE_MAX(y2 - y1, 0));
+}
+
+/**
+ *  Counts the rows of the region into the interleaved banks. The pixel j of the row goes to the bank j % BANKS,
+ *  so the neighbouring equal pixels never increment the same counter back to back.
+ **/
+class ParallelHistogramCount
+{
+public:
+    G12Buffer *buffer;
+    G8Buffer  *mask;
+    int x1;
+    int x2;
+    int min;
+    int max;
+    vector<unsigned> banks;
+    unsigned count;
+
+    void operator()( const BlockedRange<int>& r )
+    {
+        int banksNumber = HistogramBuilder::BANKS;
+        unsigned *bins = &banks[0];
+
+        for (int i = r.begin(); i < r.end(); i++)
+        {
+            uint16_t *row = &buffer->element(i, 0);
+            int j = x1;
+
+            if (mask != NULL)
+            {
+                uint8_t *maskRow = &mask->element(i, 0);
+                for (; j < x2; j++)
+                {
+                    if (!maskRow[j])
+                        continue;
+                    int value = CORE_MAX(min, CORE_MIN(max, (int)row[j]));
+                    bins[(value - min) * banksNumber + j % banksNumber]++;
+                    count++;
+                }
+                continue;
+            }
+
+#ifdef WITH_SSE
+            /**
+             * Clamping and offset 8 pixels at a time, the scatter into the banks stays scalar.
+             * SSE2 compares are signed, so the values are biased by 0x8000 to clamp them as unsigned.
+             **/
+            uint16_t offsets[8] ALIGN_DATA(16);
+            __m128i bias     = _mm_set1_epi16((int16_t)0x8000);
+            __m128i minValue = _mm_set1_epi16((int16_t)min);
+            __m128i minBiased = _mm_xor_si128(minValue, bias);
+            __m128i maxBiased = _mm_xor_si128(_mm_set1_epi16((int16_t)max), bias);
+            for (; j + 8 <= x2; j += 8)
+            {
+                __m128i values = _mm_xor_si128(_mm_loadu_si128((__m128i *)&row[j]), bias);
+                values = _mm_min_epi16(_mm_max_epi16(values, minBiased), maxBiased);
+                values = _mm_xor_si128(values, bias);
+                _mm_store_si128((__m128i *)offsets, _mm_sub_epi16(values, minValue));
+
+                for (int k = 0; k < 8; k++)
+                    bins[offsets[k] * banksNumber + (j + k) % banksNumber]++;
+            }
+#endif
+            for (; j < x2; j++)
+            {
+                int value = CORE_MAX(min, CORE_MIN(max, (int)row[j]));
+                bins[(value - min) * banksNumber + j % banksNumber]++;
+            }
+            count += x2 - x1;
+        }
+    }
+
+#ifdef WITH_TBB
+    ParallelHistogramCount( ParallelHistogramCount& x, tbb::split ) :
+        buffer(x.buffer)
+      , mask(x.mask)
+      , x1(x.x1)
+      , x2(x.x2)
+      , min(x.min)
+      , max(x.max)
+      , banks(x.banks.size(), 0)
+      , count(0)
+    {}
+
+    void join( const ParallelHistogramCount& y )
+    {
+        for (size_t k = 0; k < banks.size(); k++)
+            banks[k] += y.banks[k];
+        count += y.count;
+    }
+#endif
+
+    ParallelHistogramCount(G12Buffer *_buffer, G8Buffer *_mask, int _x1, int _x2, int _min, int _max) :
+        buffer(_buffer)
+      , mask(_mask)
+      , x1(_x1)
+      , x2(_x2)
+      , min(_min)
+      , max(_max)
+      , banks((_max - _min + 1) * HistogramBuilder::BANKS, 0)
+      , count(0)
+    {}
+};
+
+void HistogramBuilder::add(Histogram *histogram, G12Buffer *buffer, const Rectangle<int32_t> *roi, G8Buffer *mask)
+{
+    ASSERT_TRUE(buffer != NULL, "Input buffer should not be NULL");
+    ASSERT_TRUE(mask == NULL || (mask->h == buffer->h && mask->w == buffer->w), "Mask should be of the buffer size");
+    ASSERT_TRUE(histogram->min >= 0 && histogram->max <= 0x7FFF, "Histogram range should fit int16");
+
+    Rectangle<int32_t> area = clip(buffer, roi);
+    if (area.size.x() == 0 || area.size.y() == 0)
+        return;
+
+    ParallelHistogramCount counter(buffer, mask, area.corner.x(), area.corner.x() + area.size.x(), histogram->min, histogram->max);
+    parallelable_reduce(area.corner.y(), area.corner.y() + area.size.y(), counter);
+
+    for (size_t k = 0; k < histogram->data.size(); k++)
+    {
+        const unsigned *bank = &counter.banks[k * BANKS];
+        for (int b = 0; b < BANKS; b++)
+            histogram->data[k] += bank[b];
+    }
+    histogram->totalSum += counter.count;
+}
+
+Histogram *HistogramBuilder::build(G12Buffer *buffer, const Rectangle<int32_t> *roi, G8Buffer *mask)
+{
+    Histogram *result = new Histogram(0, G12Buffer::BUFFER_MAX_VALUE);
+    add(result, buffer, roi, mask);
+    return result;
+}
+
+/**
+ *  The joint bins are too many to be interleaved, each thread only gets its own copy of them.
+ **/
+class ParallelJointCount
+{
+public:
+    G12Buffer *first;
+    G12Buffer *second;
+    G8Buffer  *mask;
+    int x1;
+    int x2;
+    int shiftA;
+    int shiftB;
+    int binsB;
+    vector<unsigned> bins;
+    uint64_t count;
+
+    void operator()( const BlockedRange<int>& r )
+    {
+        for (int i = r.begin(); i < r.end(); i++)
+        {
+            uint16_t *rowA = &first->element(i, 0);
+            uint16_t *rowB = &second->element(i, 0);
+            uint8_t  *maskRow = (mask != NULL) ? &mask->element(i, 0) : NULL;
+            for (int j = x1; j < x2; j++)
+            {
+                if (maskRow != NULL && !maskRow[j])
+                    continue;
+                int a = CORE_MIN((int)rowA[j], (int)G12Buffer::BUFFER_MAX_VALUE) >> shiftA;
+                int b = CORE_MIN((int)rowB[j], (int)G12Buffer::BUFFER_MAX_VALUE) >> shiftB;
+                bins[a * binsB + b]++;
+                count++;
+            }
+        }
+    }
+
+#ifdef WITH_TBB
+    ParallelJointCount( ParallelJointCount& x, tbb::split ) :
+        first(x.first)
+      , second(x.second)
+      , mask(x.mask)
+      , x1(x.x1)
+      , x2(x.x2)
+      , shiftA(x.shiftA)
+      , shiftB(x.shiftB)
+      , binsB(x.binsB)
+      , bins(x.bins.size(), 0)
+      , count(0)
+    {}
+
+    void join( const ParallelJointCount& y )
+    {
+        for (size_t k = 0; k < bins.size(); k++)
+            bins[k] += y.bins[k];
+        count += y.count;
+    }
+#endif
+
+    ParallelJointCount(JointHistogram *histogram, G12Buffer *_first, G12Buffer *_second, G8Buffer *_mask, int _x1, int _x2) :
+        first(_first)
+      , second(_second)
+      , mask(_mask)
+      , x1(_x1)
+      , x2(_x2)
+      , shiftA(histogram->shiftA)
+      , shiftB(histogram->shiftB)
+      , binsB(histogram->binsB)
+      , bins(histogram->data.size(), 0)
+      , count(0)
+    {}
+};
+
+void HistogramBuilder::addJoint(JointHistogram *histogram, G12Buffer *first, G12Buffer *second, const Rectangle<int32_t> *roi, G8Buffer *mask)
+{
+    ASSERT_TRUE(first != NULL && second != NULL, "Input buffers should not be NULL");
+    ASSERT_TRUE(first->h == second->h && first->w == second->w, "Input buffers should be of the same size");
+    ASSERT_TRUE(mask == NULL || (mask->h == first->h && mask->w == first->w), "Mask should be of the buffer size");
+
+    Rectangle<int32_t> area = clip(first, roi);
+    if (area.size.x() == 0 || area.size.y() == 0)
+        return;
+
+    ParallelJointCount counter(histogram, first, second, mask, area.corner.x(), area.corner.x() + area.size.x());
+    parallelable_reduce(area.corner.y(), area.corner.y() + area.size.y(), counter);
+
+    for (size_t k = 0; k < histogram->data.size(); k++)
+        histogram->data[k] += counter.bins[k];
+    histogram->totalSum += counter.count;
+}
+
+/**
+ *  Each row starts with the window at the left border and slides it to the right,
+ *  one column of the window is added and one is removed per pixel.
+ **/
+class ParallelLocalEqualize
+{
+public:
+    G12Buffer *input;
+    G12Buffer *output;
+    int radius;
+
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        SlidingHistogram window;
+        int w = input->w;
+
+        for (int i = r.begin(); i < r.end(); i++)
+        {
+            int y1 = CORE_MAX(i - radius, 0);
+            int y2 = CORE_MIN(i + radius, input->h - 1);
+
+            window.clear();
+            for (int x = 0; x <= CORE_MIN(radius, w - 1); x++)
+                addColumn(window, x, y1, y2);
+
+            for (int j = 0; j < w; j++)
+            {
+                if (j > 0)
+                {
+                    int in  = j + radius;
+                    int out = j - radius - 1;
+                    if (in < w)
+                        addColumn(window, in, y1, y2);
+                    if (out >= 0)
+                        removeColumn(window, out, y1, y2);
+                }
+
+                int value = CORE_MIN((int)input->element(i, j), (int)G12Buffer::BUFFER_MAX_VALUE);
+                int64_t less  = window.rank(value);
+                int64_t equal = window.count(value);
+                int64_t total = window.total();
+                output->element(i, j) = (uint16_t)(((2 * less + equal) * G12Buffer::BUFFER_MAX_VALUE) / (2 * total));
+            }
+        }
+    }
+
+    void addColumn(SlidingHistogram &window, int x, int y1, int y2) const
+    {
+        for (int y = y1; y <= y2; y++)
+            window.add(CORE_MIN((int)input->element(y, x), (int)G12Buffer::BUFFER_MAX_VALUE));
+    }
+
+    void removeColumn(SlidingHistogram &window, int x, int y1, int y2) const
+    {
+        for (int y = y1; y <= y2; y++)
+            window.remove(CORE_MIN((int)input->element(y, x), (int)G12Buffer::BUFFER_MAX_VALUE));
+    }
+
+    ParallelLocalEqualize(G12Buffer *_input, G12Buffer *_output, int _radius) :
+        input(_input)
+      , output(_output)
+      , radius(_radius)
+    {}
+};
+
+G12Buffer *HistogramBuilder::localEqualize(G12Buffer *buffer, int radius)
+{
+    ASSERT_TRUE(buffer != NULL, "Input buffer should not be NULL");
+    ASSERT_TRUE(radius >= 0, "Radius should not be negative");
+
+    G12Buffer *result = new G12Buffer(buffer->h, buffer->w, false);
+    parallelable_for(0, buffer->h, ParallelLocalEqualize(buffer, result, radius));
+    return result;
+}
+
+} //namespace corecvs
+
+/* EOF */
@@ -0,0 +1,149 @@
+#pragma once
+/**
+ * \file histogramBuilder.h
+ * \brief Parallel histogram counting, joint and sliding window histograms of G12 buffers
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#include <stdint.h>
+#include <vector>
+
+#include "global.h"
+
+#include "g8Buffer.h"
+#include "g12Buffer.h"
+#include "rectangle.h"
+#include "histogram.h"
+
+namespace corecvs {
+
+using std::vector;
+
+/**
+ *  Joint histogram of two G12 buffers of the same size. The values are binned by the right shift,
+ *  so with the shift 4 there are 256 x 256 bins.
+ **/
+class JointHistogram
+{
+public:
+    int shiftA;
+    int shiftB;
+    int binsA;
+    int binsB;
+    uint64_t totalSum;
+    /** binsA rows of binsB counters */
+    vector<unsigned> data;
+
+    JointHistogram(int _shiftA = 4, int _shiftB = 4) :
+        shiftA(_shiftA),
+        shiftB(_shiftB),
+        binsA((G12Buffer::BUFFER_MAX_VALUE >> _shiftA) + 1),
+        binsB((G12Buffer::BUFFER_MAX_VALUE >> _shiftB) + 1),
+        totalSum(0),
+        data(binsA * binsB, 0)
+    {}
+
+    unsigned getData(int binA, int binB) const
+    {
+        return data[binA * binsB + binB];
+    }
+
+    /** Mutual information of the two buffers in bits */
+    double mutualInformation() const;
+};
+
+/**
+ *  Histogram of the window that is moved by adding and removing values, for the local histogram
+ *  equalization. Besides the 4096 fine counters it keeps 64 coarse ones, so the rank of the value
+ *  is found in at most 128 additions.
+ **/
+class SlidingHistogram
+{
+public:
+    static const int FINE_BITS   = 6;
+    static const int COARSE_SIZE = (G12Buffer::BUFFER_MAX_VALUE + 1) >> FINE_BITS;
+
+    SlidingHistogram() :
+        mTotal(0),
+        mFine(G12Buffer::BUFFER_MAX_VALUE + 1, 0),
+        mCoarse(COARSE_SIZE, 0)
+    {}
+
+    inline void add(int value)
+    {
+        mFine[value]++;
+        mCoarse[value >> FINE_BITS]++;
+        mTotal++;
+    }
+
+    inline void remove(int value)
+    {
+        mFine[value]--;
+        mCoarse[value >> FINE_BITS]--;
+        mTotal--;
+    }
+
+    /** Number of the values strictly less than the given one */
+    int rank(int value) const;
+
+    int count(int value) const
+    {
+        return mFine[value];
+    }
+
+    int total() const
+    {
+        return mTotal;
+    }
+
+    void clear();
+
+private:
+    int         mTotal;
+    vector<int> mFine;
+    vector<int> mCoarse;
+};
+
+/**
+ *  Histogram counting of G12Buffer.
+ *
+ *  A single counter array is slow on the flat images, each increment waits for the previous store to the same
+ *  counter. The builder cycles the pixels through several interleaved banks, bins[value * BANKS + bank],
+ *  and sums the banks only at the end. Rows are counted in parallel with parallelable_reduce, each
+ *  thread has its own banks and they are added up in join().
+ *
+ *  All the methods take the optional region of interest and the optional mask of the buffer size,
+ *  the pixels with the zero mask are skipped.
+ **/
+class HistogramBuilder
+{
+public:
+    static const int BANKS = 4;
+
+    /**
+     * Adds the pixels to the histogram. The values outside of [histogram->min, histogram->max]
+     * are counted in the margin bins, like the under and over exposure.
+     **/
+    static void add(Histogram *histogram, G12Buffer *buffer, const Rectangle<int32_t> *roi = NULL, G8Buffer *mask = NULL);
+
+    /** Full range histogram of the buffer */
+    static Histogram *build(G12Buffer *buffer, const Rectangle<int32_t> *roi = NULL, G8Buffer *mask = NULL);
+
+    static void addJoint(JointHistogram *histogram, G12Buffer *first, G12Buffer *second, const Rectangle<int32_t> *roi = NULL, G8Buffer *mask = NULL);
+
+    /**
+     * Local histogram equalization. Each pixel is replaced by its rank in the square window of the
+     * given radius, scaled to the G12 range. The window is slid along the rows, so the cost per pixel
+     * depends on the radius linearly.
+     **/
+    static G12Buffer *localEqualize(G12Buffer *buffer, int radius);
+
+    /** Clips roi to the buffer, the NULL roi is the whole buffer */
+    static Rectangle<int32_t> clip(G12Buffer *buffer, const Rectangle<int32_t> *roi);
+};
+
+} //namespace corecvs
+
+/* EOF */
@@ -14,6 +14,8 @@
  * \author: alexander
  */
 #include <stdio.h>
+#include <stddef.h>
+#include <vector>
 #ifdef WITH_SSE
 #include <emmintrin.h>
 #include "sseWrapper.h"
@@ -29,6 +31,271 @@
 
 namespace corecvs {
 
+/**
+ *  Tag type for the integral construction without the table of squares
+ **/
+class IntegralNoSquares
+{
+};
+
+/**
+ *  Row helpers of the integral construction. All of them work on the rows of the (w + 1) wide
+ *  integral table, the element 0 of the row is the zero left margin.
+ **/
+
+/** dst[j + 1] = src[0] + ... + src[j] */
+template<typename ElementType, typename BaseElementType>
+inline void integralRowPrefix(const BaseElementType *src, ElementType *dst, int w)
+{
+    ElementType sum(0);
+    dst[0] = ElementType(0);
+    for (int j = 0; j < w; j++)
+    {
+        sum += src[j];
+        dst[j + 1] = sum;
+    }
+}
+
+/** dst[j + 1] = src[0]^2 + ... + src[j]^2 */
+template<typename SquaredType, typename BaseElementType>
+inline void integralRowSquares(const BaseElementType *src, SquaredType *dst, int w)
+{
+    SquaredType sum(0);
+    dst[0] = SquaredType(0);
+    for (int j = 0; j < w; j++)
+    {
+        SquaredType value(src[j]);
+        sum += value * value;
+        dst[j + 1] = sum;
+    }
+}
+
+template<typename BaseElementType>
+inline void integralRowSquares(const BaseElementType * /*src*/, IntegralNoSquares * /*dst*/, int /*w*/)
+{
+}
+
+/** dst[j] += add[j] */
+template<typename ElementType>
+inline void integralRowAdd(ElementType *dst, const ElementType *add, int w)
+{
+    for (int j = 1; j <= w; j++)
+        dst[j] += add[j];
+}
+
+inline void integralRowAdd(IntegralNoSquares * /*dst*/, const IntegralNoSquares * /*add*/, int /*w*/)
+{
+}
+
+template<typename ElementType>
+inline void integralRowZero(ElementType *dst, int w)
+{
+    for (int j = 0; j <= w; j++)
+        dst[j] = ElementType(0);
+}
+
+inline void integralRowZero(IntegralNoSquares * /*dst*/, int /*w*/)
+{
+}
+
+template<typename ElementType>
+inline ElementType *integralRow(ElementType *base, int stride, int row)
+{
+    return base + (ptrdiff_t)row * stride;
+}
+
+inline IntegralNoSquares *integralRow(IntegralNoSquares * /*base*/, int /*stride*/, int /*row*/)
+{
+    return NULL;
+}
+
+#ifdef WITH_SSE
+/**
+ *  Prefix sum of 4 lanes, the carry holds the running sum broadcast into all the lanes
+ **/
+ALIGN_STACK_SSE FORCE_INLINE __m128i integralPrefix4(__m128i value, __m128i &carry)
+{
+    value = _mm_add_epi32(value, _mm_slli_si128(value, 4));
+    value = _mm_add_epi32(value, _mm_slli_si128(value, 8));
+    value = _mm_add_epi32(value, carry);
+    carry = _mm_shuffle_epi32(value, _MM_SHUFFLE(3, 3, 3, 3));
+    return value;
+}
+
+template<>
+ALIGN_STACK_SSE inline void integralRowPrefix<uint32_t, uint16_t>(const uint16_t *src, uint32_t *dst, int w)
+{
+    __m128i zero  = _mm_setzero_si128();
+    __m128i carry = zero;
+    dst[0] = 0;
+
+    int j = 0;
+    for (; j + 8 <= w; j += 8)
+    {
+        __m128i input = _mm_loadu_si128((__m128i *)(src + j));
+        __m128i low   = integralPrefix4(_mm_unpacklo_epi16(input, zero), carry);
+        __m128i high  = integralPrefix4(_mm_unpackhi_epi16(input, zero), carry);
+        _mm_storeu_si128((__m128i *)(dst + j + 1), low);
+        _mm_storeu_si128((__m128i *)(dst + j + 5), high);
+    }
+
+    uint32_t sum = dst[j];
+    for (; j < w; j++)
+    {
+        sum += src[j];
+        dst[j + 1] = sum;
+    }
+}
+
+template<>
+ALIGN_STACK_SSE inline void integralRowPrefix<uint32_t, uint8_t>(const uint8_t *src, uint32_t *dst, int w)
+{
+    __m128i zero  = _mm_setzero_si128();
+    __m128i carry = zero;
+    dst[0] = 0;
+
+    int j = 0;
+    for (; j + 8 <= w; j += 8)
+    {
+        __m128i input = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i *)(src + j)), zero);
+        __m128i low   = integralPrefix4(_mm_unpacklo_epi16(input, zero), carry);
+        __m128i high  = integralPrefix4(_mm_unpackhi_epi16(input, zero), carry);
+        _mm_storeu_si128((__m128i *)(dst + j + 1), low);
+        _mm_storeu_si128((__m128i *)(dst + j + 5), high);
+    }
+
+    uint32_t sum = dst[j];
+    for (; j < w; j++)
+    {
+        sum += src[j];
+        dst[j + 1] = sum;
+    }
+}
+
+template<>
+ALIGN_STACK_SSE inline void integralRowAdd<uint32_t>(uint32_t *dst, const uint32_t *add, int w)
+{
+    int j = 1;
+    for (; j + 4 <= w + 1; j += 4)
+    {
+        Int32x4 sum = Int32x4(dst + j) + Int32x4(add + j);
+        sum.save(dst + j);
+    }
+    for (; j <= w; j++)
+        dst[j] += add[j];
+}
+#endif
+
+/**
+ *  Row parallel construction of the integral table and, optionally, the table of the squares.
+ *
+ *  The rows are split into stripes. The first pass integrates each stripe on its own,
+ *  as if the stripe was the top of the image. Then the last rows of the stripes are fixed
+ *  one after another, and the second pass adds the fixed last row of the previous stripe to the
+ *  other rows of each stripe. Both passes process the stripes in parallel.
+ *
+ *  For the integer tables the result is exactly the same as with the sequential scan,
+ *  the floating point ones could differ in rounding.
+ **/
+template<typename ElementType, typename BaseElementType, typename SquaredType = IntegralNoSquares>
+class IntegralBuilder
+{
+public:
+    static const int STRIPE_HEIGHT = 64;
+
+    /**
+     * \param input    h x w source
+     * \param sum      (h + 1) x (w + 1) integral table
+     * \param squares  (h + 1) x (w + 1) table of the squares, NULL if not needed
+     **/
+    IntegralBuilder(
+            const BaseElementType *_input, int _inputStride, int _h, int _w,
+            ElementType *_sum, int _sumStride,
+            SquaredType *_squares = NULL, int _squaresStride = 0) :
+        input(_input), inputStride(_inputStride), h(_h), w(_w),
+        sum(_sum), sumStride(_sumStride),
+        squares(_squares), squaresStride(_squaresStride),
+        secondPass(false)
+    {}
+
+    void build()
+    {
+        integralRowZero(sum, w);
+        integralRowZero(squares, w);
+
+        int stripes = (h + STRIPE_HEIGHT - 1) / STRIPE_HEIGHT;
+
+        secondPass = false;
+        parallelable_for(0, stripes, 1, *this);
+
+        for (int stripe = 1; stripe < stripes; stripe++)
+        {
+            int last     = stripeEnd(stripe)     - 1;
+            int previous = stripeEnd(stripe - 1) - 1;
+            integralRowAdd(integralRow(sum, sumStride, last), integralRow(sum, sumStride, previous), w);
+            integralRowAdd(integralRow(squares, squaresStride, last), integralRow(squares, squaresStride, previous), w);
+        }
+
+        secondPass = true;
+        parallelable_for(1, stripes, 1, *this);
+    }
+
+    void operator()(const BlockedRange<int> &r) const
+    {
+        for (int stripe = r.begin(); stripe < r.end(); stripe++)
+        {
+            int start = stripeStart(stripe);
+            int end   = stripeEnd(stripe);
+
+            if (!secondPass)
+            {
+                for (int i = start; i < end; i++)
+                {
+                    const BaseElementType *src = input + (ptrdiff_t)(i - 1) * inputStride;
+                    integralRowPrefix (src, integralRow(sum,     sumStride,     i), w);
+                    integralRowSquares(src, integralRow(squares, squaresStride, i), w);
+                    if (i == start)
+                        continue;
+                    integralRowAdd(integralRow(sum,     sumStride,     i), integralRow(sum,     sumStride,     i - 1), w);
+                    integralRowAdd(integralRow(squares, squaresStride, i), integralRow(squares, squaresStride, i - 1), w);
+                }
+            }
+            else
+            {
+                int previous = start - 1;
+                for (int i = start; i < end - 1; i++)
+                {
+                    integralRowAdd(integralRow(sum,     sumStride,     i), integralRow(sum,     sumStride,     previous), w);
+                    integralRowAdd(integralRow(squares, squaresStride, i), integralRow(squares, squaresStride, previous), w);
+                }
+            }
+        }
+    }
+
+private:
+    const BaseElementType *input;
+    int          inputStride;
+    int          h;
+    int          w;
+    ElementType *sum;
+    int          sumStride;
+    SquaredType *squares;
+    int          squaresStride;
+    bool         secondPass;
+
+    /* Stripes are in the rows of the integral table, the row 0 is the zero margin */
+    int stripeStart(int stripe) const
+    {
+        return 1 + stripe * STRIPE_HEIGHT;
+    }
+
+    int stripeEnd(int stripe) const
+    {
+        return CORE_MIN(h + 1, 1 + (stripe + 1) * STRIPE_HEIGHT);
+    }
+};
+
+
 
  /**
   *
@@ -49,39 +316,21 @@ public:
     IntegralBuffer(SourceBufferType *input) :
         AbstractBuffer<ElementType, IndexType>(input->h + 1, input->w + 1, false)
     {
-        IndexType i,j;
-        // Scan the first line and column
-        for (j = 0; j < this->getW(); j++)
-            this->element(0, j) = ElementType(0);
-
-        for (i = 0; i < this->getH(); i++)
-            this->element(i, 0) = ElementType(0);
-
-        // Scan all the picture
-        for (i = 1; i < this->getH(); i++)
-        {
-            ElementType sum(0);
-            BaseElementType * baseOffset      = &(input->element(i - 1, 0));
-            ElementType     * currentOffset   = &(this-> element(i    , 1));
-            ElementType     * prevOffset      = &(this-> element(i - 1, 1));
-
-            for (j = 1; j < this->getW(); j ++)
-            {
-#ifdef ASSERTS
-//                ElementType test_sum = sum + input->element(i, j);
-//                ASSERT_FALSE((test_sum < sum || test_sum < input->element(i, j)), "Overflow while creating the integral buffer");
-
-#endif
-                sum += *baseOffset;
-                *currentOffset = sum + *prevOffset;
-                baseOffset++;
-                currentOffset++;
-                prevOffset++;
-            }
-        }
-
+        IntegralBuilder<ElementType, BaseElementType> builder(
+                input->data, input->stride, input->h, input->w,
+                this->data, this->stride);
+        builder.build();
     }
 
+protected:
+    /**
+     * The table of the given size that is filled by the derived class
+     **/
+    IntegralBuffer(IndexType h, IndexType w) :
+        AbstractBuffer<ElementType, IndexType>(h, w, false)
+    {}
+
+public:
     /**
      * This function returns the size of the buffer from which the intergal buffer was produced.
      *
@@ -213,6 +462,132 @@ public:
 };
 
 
+/**
+ *  The integral buffer together with the integral of the squared values. Both tables are built
+ *  in one pass over the input, so the variance of any rectangle is known in constant time, as it is
+ *  needed for the variance normalization of the VJ windows.
+ **/
+template<typename ElementType, typename SquaredType, typename BaseElementType, typename IndexType>
+class SquaredIntegralBuffer : public IntegralBuffer<ElementType, BaseElementType, IndexType>
+{
+public:
+    typedef AbstractBuffer<BaseElementType, IndexType> SourceBufferType;
+
+    /** Integral of the squared values, it has the same size as the integral itself */
+    AbstractBuffer<SquaredType, IndexType> squares;
+
+    SquaredIntegralBuffer(SourceBufferType *input) :
+        IntegralBuffer<ElementType, BaseElementType, IndexType>(input->h + 1, input->w + 1)
+      , squares(input->h + 1, input->w + 1, false)
+    {
+        IntegralBuilder<ElementType, BaseElementType, SquaredType> builder(
+                input->data, input->stride, input->h, input->w,
+                this->data, this->stride,
+                squares.data, squares.stride);
+        builder.build();
+    }
+
+    /** Sum of the squared values inside the rectangle, the corners are included */
+    inline SquaredType squaresRectangle(IndexType x1, IndexType y1, IndexType x2, IndexType y2)
+    {
+        return    squares.element(y1, x1    ) + squares.element(y2 + 1, x2 + 1)
+                - squares.element(y1, x2 + 1) - squares.element(y2 + 1, x1);
+    }
+
+    /** Variance of the values inside the rectangle, the corners are included */
+    inline double variance(IndexType x1, IndexType y1, IndexType x2, IndexType y2)
+    {
+        double area = (double)(x2 - x1 + 1) * (y2 - y1 + 1);
+        double mean = (double)this->rectangle(x1, y1, x2, y2) / area;
+        return (double)squaresRectangle(x1, y1, x2, y2) / area - mean * mean;
+    }
+};
+
+/**
+ *  Integral over the triangles rotated by 45 degrees, used by the rotated Haar features.
+ *
+ *  The element (Y, X) holds the sum over the triangle that has its apex at the pixel (Y - 1, X - 1)
+ *  and widens upwards:
+ *
+ *  \f[ Tilted(X,Y) = \sum_{i < Y, |j - X + 1| \le Y - 1 - i} I(j,i) \f]
+ *
+ *  The table is the difference of two sums of the row prefixes R, one taken along the diagonals and
+ *  the other along the anti-diagonals. Each of them depends on the previous row only, so every row is
+ *  a couple of the shifted vector additions.
+ **/
+template<typename ElementType, typename BaseElementType, typename IndexType>
+class TiltedIntegralBuffer : public AbstractBuffer<ElementType, IndexType>
+{
+public:
+    typedef AbstractBuffer<BaseElementType, IndexType> SourceBufferType;
+
+    TiltedIntegralBuffer(SourceBufferType *input) :
+        AbstractBuffer<ElementType, IndexType>(input->h + 1, input->w + 1, false)
+    {
+        int h = input->h;
+        int w = input->w;
+
+        /* anti[X] = sum_{i < Y} R(i, min(X + Y - 1 - i, w)),  diag[X] = sum_{i < Y} R(i, max(X - Y + i, 0)) */
+        std::vector<ElementType> prefix (w + 1);
+        std::vector<ElementType> anti   (w + 1, ElementType(0));
+        std::vector<ElementType> diag   (w + 1, ElementType(0));
+        std::vector<ElementType> newAnti(w + 1);
+        std::vector<ElementType> newDiag(w + 1);
+
+        for (int j = 0; j <= w; j++)
+            this->element(0, j) = ElementType(0);
+
+        for (int i = 1; i <= h; i++)
+        {
+            integralRowPrefix(&input->element(i - 1, 0), &prefix[0], w);
+
+            /* Beyond the right border the anti-diagonal sum is the sum of the whole rows */
+            for (int j = 0; j < w; j++)
+                newAnti[j] = anti[j + 1] + prefix[j];
+            newAnti[w] = anti[w] + prefix[w];
+
+            newDiag[0] = ElementType(0);
+            for (int j = 1; j <= w; j++)
+                newDiag[j] = diag[j - 1] + prefix[j - 1];
+
+            ElementType *row = &this->element(i, 0);
+            for (int j = 0; j <= w; j++)
+                row[j] = newAnti[j] - newDiag[j];
+
+            anti.swap(newAnti);
+            diag.swap(newDiag);
+        }
+    }
+
+    IndexType getEffectiveH() const
+    {
+        return this->h - 1;
+    }
+
+    IndexType getEffectiveW() const
+    {
+        return this->w - 1;
+    }
+
+    /**
+     * Sum inside the rectangle rotated by 45 degrees. Its top corner is the pixel (y, x),
+     * the sides go w pixels down and to the right and h pixels down and to the left.
+     * The rectangle should be inside the image.
+     **/
+    inline ElementType tiltedRectangle(IndexType x, IndexType y, IndexType w, IndexType h)
+    {
+        return    this->element(y + w + h, x + w - h + 1) + this->element(y, x + 1)
+                - this->element(y + w,     x + w + 1    ) - this->element(y + h, x - h + 1);
+    }
+};
+
+typedef IntegralBuffer<uint64_t, uint16_t, int32_t>                        G12IntegralBuffer64;
+typedef IntegralBuffer<float,    uint16_t, int32_t>                        G12IntegralBufferFloat;
+typedef IntegralBuffer<double,   uint16_t, int32_t>                        G12IntegralBufferDouble;
+typedef SquaredIntegralBuffer<uint32_t, uint64_t, uint16_t, int32_t>       G12SquaredIntegralBuffer;
+typedef TiltedIntegralBuffer<uint32_t, uint16_t, int32_t>                  G12TiltedIntegralBuffer;
+
+
 class G12IntegralBuffer : public IntegralBuffer<uint32_t, G12Buffer::InternalElementType, int32_t> {
 public:
     G12IntegralBuffer(G12Buffer *input) :
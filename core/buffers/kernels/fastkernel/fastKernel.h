@@ -12,6 +12,7 @@
 #include "baseKernel.h"
 #include "scalarAlgebra.h"
 #include "tbbWrapper.h"
+#include "zoneTracer.h"
 
 namespace corecvs {
 
@@ -54,16 +55,20 @@ public:
 
         MKernelType* mKernel;
         FKernelType* fKernel;
+        /* Output row of the input row 0, not counting the kernel center */
+        IndexType outputY;
     public:
         ParallelProcess(
             InputBuffer*  _input[inputNumber],
             OutputBuffer* _output[outputNumber],
             MKernelType* _mKernel,
-            FKernelType* _fKernel ):
+            FKernelType* _fKernel,
+            IndexType _outputY = 0 ):
                 input (_input),
                 output(_output),
                 mKernel(_mKernel),
-                fKernel(_fKernel)
+                fKernel(_fKernel),
+                outputY(_outputY)
         {}
 
         ALIGN_STACK_SSE void operator()( const BlockedRange<IndexType>& r ) const
@@ -101,7 +106,7 @@ public:
                     for (int  in = 0; in  <  inputNumber; in++)
                         fAlgebra.setInputPos ((void *)&input [ in]->element(         i,      0),  in);
                     for (int out = 0; out < outputNumber; out++)
-                        fAlgebra.setOutputPos((void *)&output[out]->element(i + shiftY, shiftX), out);
+                        fAlgebra.setOutputPos((void *)&output[out]->element(i + shiftY + outputY, shiftX), out);
 
                     for (j = 0; j + fStep <= wLimit; j += fStep)   // the next step index is validated
                     {
@@ -117,7 +122,7 @@ public:
                     for (int  in = 0; in  < inputNumber;  in++)
                         mAlgebra.setInputPos ((void *)&(input[in]  ->element(        i,       0)), in);
                     for (int out = 0; out < outputNumber; out++)
-                        mAlgebra.setOutputPos((void *)&(output[out]->element(i + shiftY, shiftX)), out);
+                        mAlgebra.setOutputPos((void *)&(output[out]->element(i + shiftY + outputY, shiftX)), out);
 
                 }
 
@@ -143,6 +148,7 @@ ALIGN_STACK_SSE void process(
             OutputBuffer* output[outputNumber],
             const DKernelType &kernel = DKernelType())
     {
+        TRACE_ZONE("BufferProcessor::process");
         MKernelType mKernel(kernel);
         FKernelType fKernel(kernel);
 
@@ -154,11 +160,33 @@ ALIGN_STACK_SSE void process(
     }
 
 
+    /**
+     *  Processes the input rows begin .. end - 1 on the calling thread, the input row i is the top
+     *  row of the kernel. Its output goes to the row i + outputY + getCenterY(), so the input could be
+     *  a stripe of the frame the output holds.
+     **/
+ALIGN_STACK_SSE void processRows(
+            InputBuffer* input[inputNumber],
+            OutputBuffer* output[outputNumber],
+            IndexType begin,
+            IndexType end,
+            IndexType outputY,
+            const DKernelType &kernel = DKernelType())
+    {
+        MKernelType mKernel(kernel);
+        FKernelType fKernel(kernel);
+
+        ParallelProcess<false> exe(input, output, &mKernel, &fKernel, outputY);
+        if (begin < end)
+            exe(BlockedRange<IndexType>(begin, end));
+    }
+
 ALIGN_STACK_SSE  void processSaveAligned(
             InputBuffer* input[inputNumber],
             OutputBuffer* output[outputNumber],
             const DKernelType &kernel = DKernelType())
     {
+        TRACE_ZONE("BufferProcessor::processSaveAligned");
         MKernelType mKernel(kernel);
         FKernelType fKernel(kernel);
 
@@ -11,11 +11,17 @@
  */
 
 #include <vector>
+#include <math.h>
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
 
 #include "global.h"
 
 #include "abstractBuffer.h"
 #include "gaussian.h"
+#include "mathUtils.h"
+#include "tbbWrapper.h"
 
 namespace corecvs {
 
@@ -92,6 +98,346 @@ public:
 };
 
 
+/**
+ *  Reflects the index that is out of [0, size) against the border, the border element is not repeated
+ **/
+inline int pyramidMirror(int index, int size)
+{
+    if (index < 0)
+        index = -index;
+    if (index >= size)
+        index = 2 * size - 2 - index;
+    return CORE_MAX(0, CORE_MIN(size - 1, index));
+}
+
+/**
+ *  Vertical pass of the 1-4-6-4-1 kernel, dst[j] = r0[j] + 4 r1[j] + 6 r2[j] + 4 r3[j] + r4[j]
+ **/
+template<typename ElementType>
+inline void pyramidVerticalTaps(const ElementType *r[5], uint32_t *dst, int w)
+{
+    for (int j = 0; j < w; j++)
+    {
+        uint32_t side   = (uint32_t)r[1][j] + r[3][j];
+        uint32_t center = r[2][j];
+        dst[j] = (uint32_t)r[0][j] + r[4][j] + (side << 2) + (center << 2) + (center << 1);
+    }
+}
+
+#ifdef WITH_SSE
+ALIGN_STACK_SSE inline void pyramidVerticalTaps(const uint16_t *r[5], uint32_t *dst, int w)
+{
+    __m128i zero = _mm_setzero_si128();
+    int j = 0;
+    for (; j + 8 <= w; j += 8)
+    {
+        __m128i in[5];
+        for (int k = 0; k < 5; k++)
+            in[k] = _mm_loadu_si128((__m128i *)(r[k] + j));
+
+        for (int half = 0; half < 2; half++)
+        {
+            __m128i v[5];
+            for (int k = 0; k < 5; k++)
+                v[k] = half ? _mm_unpackhi_epi16(in[k], zero) : _mm_unpacklo_epi16(in[k], zero);
+
+            __m128i side   = _mm_slli_epi32(_mm_add_epi32(v[1], v[3]), 2);
+            __m128i center = _mm_add_epi32(_mm_slli_epi32(v[2], 2), _mm_slli_epi32(v[2], 1));
+            __m128i sum    = _mm_add_epi32(_mm_add_epi32(v[0], v[4]), _mm_add_epi32(side, center));
+            _mm_storeu_si128((__m128i *)(dst + j + 4 * half), sum);
+        }
+    }
+
+    for (; j < w; j++)
+    {
+        uint32_t side   = (uint32_t)r[1][j] + r[3][j];
+        uint32_t center = r[2][j];
+        dst[j] = (uint32_t)r[0][j] + r[4][j] + (side << 2) + (center << 2) + (center << 1);
+    }
+}
+#endif
+
+/**
+ *  Resampling taps of one direction, precomputed for the given input and output sizes.
+ *  Each output sample is the weighted sum of the taps input samples starting at start[i].
+ *  The tent filter is as wide as the scale factor, so the reduction is antialiased.
+ **/
+class PyramidResampleTaps
+{
+public:
+    static const int WEIGHT_BITS = 12;
+
+    int inputSize;
+    int outputSize;
+    int taps;
+    vector<int32_t> start;
+    vector<int32_t> weights;
+
+    PyramidResampleTaps() :
+        inputSize(0), outputSize(0), taps(0)
+    {}
+
+    void init(int _inputSize, int _outputSize, double factor)
+    {
+        inputSize  = _inputSize;
+        outputSize = _outputSize;
+
+        double radius = CORE_MAX(1.0, factor);
+        taps = CORE_MIN(inputSize, 2 * (int)ceil(radius) + 1);
+        start  .resize(outputSize);
+        weights.resize(outputSize * taps);
+
+        vector<double> raw(taps);
+        for (int i = 0; i < outputSize; i++)
+        {
+            double center = (i + 0.5) * factor - 0.5;
+            int first = (int)floor(center) - taps / 2;
+            first = CORE_MAX(0, CORE_MIN(inputSize - taps, first));
+            start[i] = first;
+
+            double total = 0.0;
+            for (int t = 0; t < taps; t++)
+            {
+                raw[t] = CORE_MAX(0.0, 1.0 - fabs(first + t - center) / radius);
+                total += raw[t];
+            }
+
+            /* Fixed point weights that sum exactly to one, the rounding residual goes to the largest one */
+            int32_t *w = &weights[i * taps];
+            int32_t sum = 0;
+            int largest = 0;
+            for (int t = 0; t < taps; t++)
+            {
+                w[t] = (total > 0.0) ? fround(raw[t] / total * (1 << WEIGHT_BITS)) : 0;
+                sum += w[t];
+                if (w[t] > w[largest])
+                    largest = t;
+            }
+            w[largest] += (1 << WEIGHT_BITS) - sum;
+        }
+    }
+};
+
+/**
+ *  \brief Gaussian pyramid that keeps its level buffers between the frames.
+ *
+ *  build() could be called for each new frame, the levels are reallocated only when
+ *  the size of the frame changes. The levels with the factor 2 are produced with the
+ *  separable 1-4-6-4-1 binomial kernel, the vertical and the horizontal passes are fused
+ *  per output row, so no intermediate buffer is needed and the rows are processed in parallel.
+ *  Other factors use the tent filter with the precomputed fixed point taps.
+ *
+ *  The element type should be integer.
+ **/
+template<typename BufferType>
+class GaussianPyramid
+{
+public:
+    typedef typename BufferType::InternalElementType ElementType;
+
+    vector<BufferType *> levels;
+
+    GaussianPyramid(int levelNumber, double factor = 2.0) :
+        mLevelNumber(levelNumber),
+        mFactor(factor)
+    {}
+
+    GaussianPyramid(BufferType *input, int levelNumber, double factor = 2.0) :
+        mLevelNumber(levelNumber),
+        mFactor(factor)
+    {
+        build(input);
+    }
+
+    ~GaussianPyramid()
+    {
+        clear();
+    }
+
+    int levelNumber() const
+    {
+        return mLevelNumber;
+    }
+
+    double factor() const
+    {
+        return mFactor;
+    }
+
+    BufferType *level(int i)
+    {
+        return levels[i];
+    }
+
+    /**
+     * Fills the pyramid with the new frame. Level 0 is the copy of the input.
+     **/
+    void build(BufferType *input)
+    {
+        if (levels.empty() || levels[0]->h != input->h || levels[0]->w != input->w)
+            allocate(input->h, input->w);
+
+        levels[0]->fillWith(*input);
+        for (int i = 1; i < mLevelNumber; i++)
+        {
+            if (mFactor == 2.0)
+                reduce(levels[i - 1], levels[i]);
+            else
+                resample(levels[i - 1], levels[i], mTaps[2 * i], mTaps[2 * i + 1]);
+        }
+    }
+
+    class ParallelReduce
+    {
+        BufferType *input;
+        BufferType *output;
+
+    public:
+        ParallelReduce(BufferType *_input, BufferType *_output) :
+            input(_input), output(_output)
+        {}
+
+        void operator()(const BlockedRange<int> &r) const
+        {
+            int w = input->w;
+
+            /* The row after the vertical pass with 2 mirrored columns at both sides */
+            vector<uint32_t> row(w + 4);
+            uint32_t *center = &row[2];
+
+            for (int i = r.begin(); i < r.end(); i++)
+            {
+                const ElementType *rows[5];
+                for (int k = 0; k < 5; k++)
+                    rows[k] = &input->element(pyramidMirror(2 * i + k - 2, input->h), 0);
+
+                pyramidVerticalTaps(rows, center, w);
+                center[-1]    = center[pyramidMirror(-1,    w)];
+                center[-2]    = center[pyramidMirror(-2,    w)];
+                center[w]     = center[pyramidMirror(w,     w)];
+                center[w + 1] = center[pyramidMirror(w + 1, w)];
+
+                ElementType *out = &output->element(i, 0);
+                const uint32_t *in = &row[0];
+                for (int j = 0; j < output->w; j++, in += 2)
+                {
+                    uint32_t sum = in[0] + in[4] + ((in[1] + in[3]) << 2) + (in[2] << 2) + (in[2] << 1);
+                    out[j] = (ElementType)((sum + 128) >> 8);
+                }
+            }
+        }
+    };
+
+    /**
+     * Reduces the input twice with the 5x5 binomial kernel. The output should be h / 2 x w / 2 of the input
+     **/
+    static void reduce(BufferType *input, BufferType *output)
+    {
+        parallelable_for(0, (int)output->h, 8, ParallelReduce(input, output));
+    }
+
+    class ParallelResample
+    {
+        BufferType *input;
+        BufferType *output;
+        const PyramidResampleTaps *vertical;
+        const PyramidResampleTaps *horizontal;
+
+    public:
+        ParallelResample(BufferType *_input, BufferType *_output,
+                         const PyramidResampleTaps *_vertical, const PyramidResampleTaps *_horizontal) :
+            input(_input), output(_output), vertical(_vertical), horizontal(_horizontal)
+        {}
+
+        void operator()(const BlockedRange<int> &r) const
+        {
+            int w = input->w;
+
+            /* The row after the vertical pass with 4 fractional bits */
+            vector<int32_t> row(w);
+            const int ROW_SHIFT = PyramidResampleTaps::WEIGHT_BITS - 4;
+
+            for (int i = r.begin(); i < r.end(); i++)
+            {
+                const int32_t *vw = &vertical->weights[i * vertical->taps];
+                for (int j = 0; j < w; j++)
+                    row[j] = 1 << (ROW_SHIFT - 1);
+                for (int t = 0; t < vertical->taps; t++)
+                {
+                    if (vw[t] == 0)
+                        continue;
+                    const ElementType *in = &input->element(vertical->start[i] + t, 0);
+                    for (int j = 0; j < w; j++)
+                        row[j] += vw[t] * (int32_t)in[j];
+                }
+                for (int j = 0; j < w; j++)
+                    row[j] >>= ROW_SHIFT;
+
+                ElementType *out = &output->element(i, 0);
+                const int32_t *hw = &horizontal->weights[0];
+                for (int j = 0; j < output->w; j++, hw += horizontal->taps)
+                {
+                    const int32_t *in = &row[horizontal->start[j]];
+                    int64_t sum = (int64_t)1 << (PyramidResampleTaps::WEIGHT_BITS + 3);
+                    for (int t = 0; t < horizontal->taps; t++)
+                        sum += (int64_t)hw[t] * in[t];
+                    out[j] = (ElementType)(sum >> (PyramidResampleTaps::WEIGHT_BITS + 4));
+                }
+            }
+        }
+    };
+
+    /**
+     * Resamples the input to the size of the output with the precomputed taps
+     **/
+    static void resample(BufferType *input, BufferType *output,
+                         const PyramidResampleTaps &vertical, const PyramidResampleTaps &horizontal)
+    {
+        parallelable_for(0, (int)output->h, 8, ParallelResample(input, output, &vertical, &horizontal));
+    }
+
+private:
+    int    mLevelNumber;
+    double mFactor;
+
+    /** Vertical and horizontal taps of each level */
+    vector<PyramidResampleTaps> mTaps;
+
+    void clear()
+    {
+        for (unsigned i = 0; i < levels.size(); i++)
+            delete_safe(levels[i]);
+        levels.clear();
+    }
+
+    void allocate(int h, int w)
+    {
+        clear();
+        levels.resize(mLevelNumber);
+        mTaps.resize(2 * mLevelNumber);
+
+        levels[0] = new BufferType(h, w, false);
+        for (int i = 1; i < mLevelNumber; i++)
+        {
+            int previousH = levels[i - 1]->h;
+            int previousW = levels[i - 1]->w;
+            int newH = CORE_MAX(1, (int)(previousH / mFactor));
+            int newW = CORE_MAX(1, (int)(previousW / mFactor));
+            levels[i] = new BufferType(newH, newW, false);
+
+            if (mFactor != 2.0)
+            {
+                mTaps[2 * i    ].init(previousH, newH, (double)previousH / newH);
+                mTaps[2 * i + 1].init(previousW, newW, (double)previousW / newW);
+            }
+        }
+    }
+
+    GaussianPyramid(const GaussianPyramid &);
+    GaussianPyramid &operator =(const GaussianPyramid &);
+};
+
+
 } //namespace corecvs
 #endif  //MIPMAPPYRAMID_H_
 
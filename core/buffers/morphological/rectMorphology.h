@@ -0,0 +1,440 @@
+#pragma once
+/**
+ * \file rectMorphology.h
+ * \brief Grayscale morphology with the rectangular and line elements
+ *
+ * The rectangle is decomposed into the horizontal and the vertical line. Each line is processed
+ * with the van Herk/Gil-Werman algorithm: the input is cut into the blocks of the element length,
+ * the suffix minima of one block and the running prefix minimum of the next one give the minimum
+ * of any window with three comparisons per pixel, whatever the element size is.
+ *
+ * The vertical pass works on the whole rows of the column strip, so it is done with the SIMD min/max.
+ *
+ * \date Oct 19, 2026
+ * \ingroup cppcorefiles
+ */
+
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+#include "global.h"
+
+#include "abstractBuffer.h"
+#include "tbbWrapper.h"
+
+namespace corecvs {
+
+using std::vector;
+
+/* Row helpers, dst[i] = op(a[i], b[i]). dst may be the same as a or b */
+
+template<typename ElementType>
+inline void morphologyRowMin(ElementType *dst, const ElementType *a, const ElementType *b, int n)
+{
+    for (int i = 0; i < n; i++)
+        dst[i] = a[i] < b[i] ? a[i] : b[i];
+}
+
+template<typename ElementType>
+inline void morphologyRowMax(ElementType *dst, const ElementType *a, const ElementType *b, int n)
+{
+    for (int i = 0; i < n; i++)
+        dst[i] = a[i] > b[i] ? a[i] : b[i];
+}
+
+/** Saturating dst[i] = a[i] - b[i] */
+template<typename ElementType>
+inline void morphologyRowSubtract(ElementType *dst, const ElementType *a, const ElementType *b, int n)
+{
+    for (int i = 0; i < n; i++)
+        dst[i] = a[i] > b[i] ? (ElementType)(a[i] - b[i]) : (ElementType)0;
+}
+
+#ifdef WITH_SSE
+inline void morphologyRowMin(uint8_t *dst, const uint8_t *a, const uint8_t *b, int n)
+{
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_min_epu8(_mm_loadu_si128((const __m128i *)(a + i)), _mm_loadu_si128((const __m128i *)(b + i))));
+    for (; i < n; i++)
+        dst[i] = a[i] < b[i] ? a[i] : b[i];
+}
+
+inline void morphologyRowMax(uint8_t *dst, const uint8_t *a, const uint8_t *b, int n)
+{
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_max_epu8(_mm_loadu_si128((const __m128i *)(a + i)), _mm_loadu_si128((const __m128i *)(b + i))));
+    for (; i < n; i++)
+        dst[i] = a[i] > b[i] ? a[i] : b[i];
+}
+
+inline void morphologyRowSubtract(uint8_t *dst, const uint8_t *a, const uint8_t *b, int n)
+{
+    int i = 0;
+    for (; i + 16 <= n; i += 16)
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_subs_epu8(_mm_loadu_si128((const __m128i *)(a + i)), _mm_loadu_si128((const __m128i *)(b + i))));
+    for (; i < n; i++)
+        dst[i] = a[i] > b[i] ? (uint8_t)(a[i] - b[i]) : (uint8_t)0;
+}
+
+/* SSE2 has only the signed 16 bit min/max, the sign bit flip makes them unsigned */
+inline void morphologyRowMin(uint16_t *dst, const uint16_t *a, const uint16_t *b, int n)
+{
+    const __m128i sign = _mm_set1_epi16((int16_t)0x8000);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i va = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(a + i)), sign);
+        __m128i vb = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(b + i)), sign);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_xor_si128(_mm_min_epi16(va, vb), sign));
+    }
+    for (; i < n; i++)
+        dst[i] = a[i] < b[i] ? a[i] : b[i];
+}
+
+inline void morphologyRowMax(uint16_t *dst, const uint16_t *a, const uint16_t *b, int n)
+{
+    const __m128i sign = _mm_set1_epi16((int16_t)0x8000);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i va = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(a + i)), sign);
+        __m128i vb = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(b + i)), sign);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_xor_si128(_mm_max_epi16(va, vb), sign));
+    }
+    for (; i < n; i++)
+        dst[i] = a[i] > b[i] ? a[i] : b[i];
+}
+
+inline void morphologyRowSubtract(uint16_t *dst, const uint16_t *a, const uint16_t *b, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_subs_epu16(_mm_loadu_si128((const __m128i *)(a + i)), _mm_loadu_si128((const __m128i *)(b + i))));
+    for (; i < n; i++)
+        dst[i] = a[i] > b[i] ? (uint16_t)(a[i] - b[i]) : (uint16_t)0;
+}
+#endif
+
+class MorphologyMinOp
+{
+public:
+    template<typename ElementType>
+    static ElementType identity() { return std::numeric_limits<ElementType>::max(); }
+
+    template<typename ElementType>
+    static ElementType apply(ElementType a, ElementType b) { return a < b ? a : b; }
+
+    template<typename ElementType>
+    static void row(ElementType *dst, const ElementType *a, const ElementType *b, int n) { morphologyRowMin(dst, a, b, n); }
+};
+
+class MorphologyMaxOp
+{
+public:
+    template<typename ElementType>
+    static ElementType identity() { return std::numeric_limits<ElementType>::min(); }
+
+    template<typename ElementType>
+    static ElementType apply(ElementType a, ElementType b) { return a > b ? a : b; }
+
+    template<typename ElementType>
+    static void row(ElementType *dst, const ElementType *a, const ElementType *b, int n) { morphologyRowMax(dst, a, b, n); }
+};
+
+/**
+ *  Morphology of G8Buffer or G12Buffer with the rectangular element, the line is the rectangle of height or width 1.
+ *
+ *  The pixels outside of the buffer do not take part in the operation, so the erosion does not eat the image from the border.
+ *  The intermediate planes are kept between the calls, so per frame processing allocates nothing after the first frame.
+ *  Output should not be the input.
+ **/
+template<typename BufferType>
+class RectMorphology
+{
+public:
+    typedef typename BufferType::InternalElementType ElementType;
+
+    /** Width of the column strip of the vertical pass */
+    static const int STRIP_WIDTH = 256;
+
+    /** What the last pass does with the reference buffer */
+    enum FinalStep {
+        PLAIN,             /**< output = result */
+        REFERENCE_MINUS,   /**< output = reference - result */
+        MINUS_REFERENCE    /**< output = result - reference */
+    };
+
+    RectMorphology() :
+        mHorizontal(NULL),
+        mIntermediate(NULL)
+    {}
+
+    /**
+     *  Minimum over the h x w window. The center is the element cell placed over the output pixel,
+     *  by default the middle one.
+     **/
+    void erode(BufferType *input, BufferType *output, int h, int w, int centerX = -1, int centerY = -1)
+    {
+        centerX = (centerX < 0) ? w / 2 : centerX;
+        centerY = (centerY < 0) ? h / 2 : centerY;
+        apply<MorphologyMinOp>(input, output, h, w, centerY, centerX);
+    }
+
+    /** Maximum over the window of the reflected element, so that the opening and the closing are the usual ones */
+    void dilate(BufferType *input, BufferType *output, int h, int w, int centerX = -1, int centerY = -1)
+    {
+        centerX = (centerX < 0) ? w / 2 : centerX;
+        centerY = (centerY < 0) ? h / 2 : centerY;
+        apply<MorphologyMaxOp>(input, output, h, w, h - 1 - centerY, w - 1 - centerX);
+    }
+
+    void open(BufferType *input, BufferType *output, int h, int w)
+    {
+        BufferType *eroded = intermediate(input);
+        erode(input, eroded, h, w);
+        dilate(eroded, output, h, w);
+    }
+
+    void close(BufferType *input, BufferType *output, int h, int w)
+    {
+        BufferType *dilated = intermediate(input);
+        dilate(input, dilated, h, w);
+        erode(dilated, output, h, w);
+    }
+
+    /** White top-hat, input minus its opening. The subtraction is fused into the last pass */
+    void topHat(BufferType *input, BufferType *output, int h, int w)
+    {
+        BufferType *eroded = intermediate(input);
+        erode(input, eroded, h, w);
+        apply<MorphologyMaxOp>(eroded, output, h, w, h - 1 - h / 2, w - 1 - w / 2, input, REFERENCE_MINUS);
+    }
+
+    /** Black top-hat, the closing minus the input. The subtraction is fused into the last pass */
+    void blackHat(BufferType *input, BufferType *output, int h, int w)
+    {
+        BufferType *dilated = intermediate(input);
+        dilate(input, dilated, h, w);
+        apply<MorphologyMinOp>(dilated, output, h, w, h / 2, w / 2, input, MINUS_REFERENCE);
+    }
+
+    /**
+     * Generic pass, output(y, x) = op over input(y - centerY .. y - centerY + h - 1, x - centerX .. x - centerX + w - 1)
+     **/
+    template<class Op>
+    void apply(
+            BufferType *input,
+            BufferType *output,
+            int h, int w,
+            int centerY, int centerX,
+            BufferType *reference = NULL,
+            FinalStep finalStep = PLAIN)
+    {
+        ASSERT_TRUE(input != output, "RectMorphology does not work in place");
+        ASSERT_TRUE(input->hasSameSize(output), "RectMorphology output should be of the input size");
+        ASSERT_TRUE(h >= 1 && w >= 1, "RectMorphology element should not be empty");
+        ASSERT_TRUE(reference != output || finalStep == PLAIN, "Reference should not be the output");
+
+        if (w > 1 && h > 1)
+        {
+            if (mHorizontal == NULL || !mHorizontal->hasSameSize(input))
+            {
+                delete_safe(mHorizontal);
+                mHorizontal = new BufferType(input->h, input->w, false);
+            }
+            parallelable_for(0, input->h, ParallelHorizontal<Op>(input, mHorizontal, w, centerX, NULL, PLAIN));
+            parallelable_for(0, stripsNumber(input->w), 1, ParallelVertical<Op>(mHorizontal, output, h, centerY, reference, finalStep));
+        }
+        else if (w > 1)
+        {
+            parallelable_for(0, input->h, ParallelHorizontal<Op>(input, output, w, centerX, reference, finalStep));
+        }
+        else
+        {
+            parallelable_for(0, stripsNumber(input->w), 1, ParallelVertical<Op>(input, output, h, centerY, reference, finalStep));
+        }
+    }
+
+    ~RectMorphology()
+    {
+        delete_safe(mHorizontal);
+        delete_safe(mIntermediate);
+    }
+
+private:
+    BufferType *mHorizontal;
+    BufferType *mIntermediate;
+
+    RectMorphology(const RectMorphology &);
+    RectMorphology &operator=(const RectMorphology &);
+
+    BufferType *intermediate(BufferType *input)
+    {
+        if (mIntermediate == NULL || !mIntermediate->hasSameSize(input))
+        {
+            delete_safe(mIntermediate);
+            mIntermediate = new BufferType(input->h, input->w, false);
+        }
+        return mIntermediate;
+    }
+
+    static int stripsNumber(int w)
+    {
+        return (w + STRIP_WIDTH - 1) / STRIP_WIDTH;
+    }
+
+    static void finish(ElementType *out, const ElementType *reference, int n, FinalStep finalStep)
+    {
+        if (finalStep == REFERENCE_MINUS)
+            morphologyRowSubtract(out, reference, out, n);
+        else if (finalStep == MINUS_REFERENCE)
+            morphologyRowSubtract(out, out, reference, n);
+    }
+
+    template<class Op>
+    class ParallelHorizontal
+    {
+    public:
+        BufferType *input;
+        BufferType *output;
+        int k;
+        int anchor;
+        BufferType *reference;
+        FinalStep finalStep;
+
+        ParallelHorizontal(BufferType *_input, BufferType *_output, int _k, int _anchor, BufferType *_reference, FinalStep _finalStep) :
+            input(_input), output(_output), k(_k), anchor(_anchor), reference(_reference), finalStep(_finalStep)
+        {}
+
+        void operator()(const BlockedRange<int> &r) const
+        {
+            vector<ElementType> suffix(k);
+            const ElementType identity = Op::template identity<ElementType>();
+            int n = input->w;
+
+            for (int i = r.begin(); i < r.end(); i++)
+            {
+                const ElementType *src = &input->element(i, 0);
+                ElementType *dst = &output->element(i, 0);
+
+                /* Output x covers the padded positions x .. x + k - 1, the padded position p is src[p - anchor] */
+                for (int b0 = 0; b0 < n; b0 += k)
+                {
+                    ElementType acc = identity;
+                    for (int j = k - 1; j >= 0; j--)
+                    {
+                        int s = b0 + j - anchor;
+                        if (s >= 0 && s < n)
+                            acc = Op::apply(acc, src[s]);
+                        suffix[j] = acc;
+                    }
+
+                    acc = identity;
+                    int blockEnd = CORE_MIN(k, n - b0);
+                    for (int j = 0; j < blockEnd; j++)
+                    {
+                        dst[b0 + j] = Op::apply(suffix[j], acc);
+                        int s = b0 + k + j - anchor;
+                        if (s >= 0 && s < n)
+                            acc = Op::apply(acc, src[s]);
+                    }
+                }
+
+                if (finalStep != PLAIN)
+                    finish(dst, &reference->element(i, 0), n, finalStep);
+            }
+        }
+    };
+
+    template<class Op>
+    class ParallelVertical
+    {
+    public:
+        BufferType *input;
+        BufferType *output;
+        int k;
+        int anchor;
+        BufferType *reference;
+        FinalStep finalStep;
+
+        ParallelVertical(BufferType *_input, BufferType *_output, int _k, int _anchor, BufferType *_reference, FinalStep _finalStep) :
+            input(_input), output(_output), k(_k), anchor(_anchor), reference(_reference), finalStep(_finalStep)
+        {}
+
+        void operator()(const BlockedRange<int> &r) const
+        {
+            int h = input->h;
+            vector<ElementType> suffix(k * STRIP_WIDTH);
+            vector<ElementType> prefix(STRIP_WIDTH);
+            ElementType *acc = &prefix[0];
+
+            for (int strip = r.begin(); strip < r.end(); strip++)
+            {
+                int x0 = strip * STRIP_WIDTH;
+                int n  = CORE_MIN(STRIP_WIDTH, input->w - x0);
+
+                /* Same as the horizontal pass, the rows of the strip take place of the pixels */
+                for (int b0 = 0; b0 < h; b0 += k)
+                {
+                    for (int j = k - 1; j >= 0; j--)
+                    {
+                        ElementType *current = &suffix[j * STRIP_WIDTH];
+                        int s = b0 + j - anchor;
+                        bool valid = (s >= 0 && s < h);
+
+                        if (j == k - 1)
+                        {
+                            if (valid)
+                                memcpy(current, &input->element(s, x0), n * sizeof(ElementType));
+                            else
+                                std::fill(current, current + n, Op::template identity<ElementType>());
+                        }
+                        else
+                        {
+                            ElementType *next = current + STRIP_WIDTH;
+                            if (valid)
+                                Op::row(current, next, &input->element(s, x0), n);
+                            else
+                                memcpy(current, next, n * sizeof(ElementType));
+                        }
+                    }
+
+                    bool accValid = false;
+                    int blockEnd = CORE_MIN(k, h - b0);
+                    for (int j = 0; j < blockEnd; j++)
+                    {
+                        ElementType *out = &output->element(b0 + j, x0);
+                        if (accValid)
+                            Op::row(out, &suffix[j * STRIP_WIDTH], acc, n);
+                        else
+                            memcpy(out, &suffix[j * STRIP_WIDTH], n * sizeof(ElementType));
+
+                        if (finalStep != PLAIN)
+                            finish(out, &reference->element(b0 + j, x0), n, finalStep);
+
+                        int s = b0 + k + j - anchor;
+                        if (s >= 0 && s < h)
+                        {
+                            if (accValid)
+                                Op::row(acc, acc, &input->element(s, x0), n);
+                            else
+                                memcpy(acc, &input->element(s, x0), n * sizeof(ElementType));
+                            accValid = true;
+                        }
+                    }
+                }
+            }
+        }
+    };
+};
+
+} //namespace corecvs
+
+/* EOF */
@@ -5,13 +5,27 @@ namespace corecvs
 
 TransformationCache::TransformationCache(Matrix33 matrix, int w, int h, Vector2d<int> inputSize)
 {
-    mRemap      = new DirectRemapper    (&matrix, inputSize, Vector2d<int>(w, h));
     mDisplace   = new DisplacementBuffer(&matrix, h, w);
-    mF8Displace = new FixedPointDisplace( matrix, h, w);
+    mRemapMap   = RemapMap::fromMatrix(matrix, h, w, inputSize.y(), inputSize.x());
+    mComposed   = NULL;
+}
+
+TransformationCache::TransformationCache(DeformChain *chain, int w, int h, Vector2d<int> inputSize, const string &cacheDirectory)
+{
+    mDisplace   = NULL;
+    mRemapMap   = NULL;
+    mComposed   = new ComposedRemap(chain, h, w, inputSize.y(), inputSize.x());
+    mComposed->setCacheDirectory(cacheDirectory);
 }
 
 G12Buffer *TransformationCache::doDeformation(InterpolationType::InterpolationType type, G12Buffer *inputFrame)
 {
+    if (mComposed != NULL)
+    {
+        RemapEngine::Interpolation interpolation = (type == InterpolationType::NEAREST) ? RemapEngine::NEAREST : RemapEngine::BILINEAR;
+        return mComposed->remap(inputFrame, interpolation);
+    }
+
     switch (type)
     {
         case InterpolationType::BILINEAR :
@@ -22,14 +36,11 @@ G12Buffer *TransformationCache::doDeformation(InterpolationType::InterpolationTy
             break;
 
         case InterpolationType::NEAREST :
-            return mRemap->remap(inputFrame);
+            return RemapEngine::remap(*mRemapMap, inputFrame, RemapEngine::NEAREST);
             break;
 
         case InterpolationType::BILINEAR_FIXED8 :
-            return inputFrame->doReverseDeformationBlPrecomp(
-                        mF8Displace,
-                        mF8Displace->h,
-                        mF8Displace->w);
+            return RemapEngine::remap(*mRemapMap, inputFrame, RemapEngine::BILINEAR);
             break;
 
         default:
@@ -40,9 +51,9 @@ G12Buffer *TransformationCache::doDeformation(InterpolationType::InterpolationTy
 
 TransformationCache::~TransformationCache()
 {
-    delete_safe(mRemap);
     delete_safe(mDisplace);
-    delete_safe(mF8Displace);
+    delete_safe(mRemapMap);
+    delete_safe(mComposed);
 }
 
 } // namespace corecvs
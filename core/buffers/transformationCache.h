@@ -1,5 +1,7 @@
 #pragma once
 #include "displacementBuffer.h"
+#include "remapEngine.h"
+#include "deformChain.h"
 #include "generated/interpolationType.h"
 
 namespace corecvs {
@@ -7,7 +9,11 @@ namespace corecvs {
 /**
  *  This class is caching the transformation of the buffer.
  *
+ *  BILINEAR uses the exact displacement in doubles, NEAREST and BILINEAR_FIXED8 go through
+ *  the RemapEngine with the fixed point map.
  *
+ *  The cache built from the DeformChain warps the whole chain at once with the composed map,
+ *  BILINEAR is then the fixed point bilinear as well.
  **/
 class TransformationCache
 {
@@ -20,13 +26,19 @@ public:
      *
      **/
     TransformationCache(Matrix33 matrix, int w, int h, Vector2d<int> inputSize);
+
+    /**
+     * \param chain           inverse mappings from the output to the input, the ownership is taken
+     * \param cacheDirectory  directory of the disk cache of the composed map, empty to disable
+     **/
+    TransformationCache(DeformChain *chain, int w, int h, Vector2d<int> inputSize, const string &cacheDirectory = "");
     G12Buffer *doDeformation(InterpolationType::InterpolationType type, G12Buffer *buffer);
     ~TransformationCache();
 
 private:
-    DirectRemapper *mRemap;
     DisplacementBuffer *mDisplace;
-    FixedPointDisplace *mF8Displace;
+    RemapMap           *mRemapMap;
+    ComposedRemap      *mComposed;
 };
 
 }
@@ -1,5 +1,6 @@
 HEADERS += \
     clustering3d/cloud.h \
+    clustering3d/floatCloud.h \
     clustering3d/swarmPoint.h \
     clustering3d/cloudCluster.h \
     clustering3d/clustering3d.h \
@@ -7,6 +8,7 @@ HEADERS += \
 
 SOURCES += \
     clustering3d/cloud.cpp \
+    clustering3d/floatCloud.cpp \
     clustering3d/swarmPoint.cpp \
     clustering3d/cloudCluster.cpp \
     clustering3d/clustering3d.cpp \
@@ -0,0 +1,216 @@
+/**
+ * \file floatCloud.cpp
+ * \brief Point cloud stored as the separate float arrays
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <math.h>
+
+#include "floatCloud.h"
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace corecvs {
+
+void FloatCloud::resize(size_t size)
+{
+    x.resize(size);
+    y.resize(size);
+    z.resize(size);
+    if (hasChannel(COLOR))
+        color.resize(size, RGBColor::gray(0xFF));
+    if (hasChannel(TEXTURE))
+    {
+        texX.resize(size);
+        texY.resize(size);
+    }
+    if (hasChannel(SPEED))
+    {
+        speedX.resize(size);
+        speedY.resize(size);
+        speedZ.resize(size);
+        is6D.resize(size);
+    }
+}
+
+void FloatCloud::reserve(size_t size)
+{
+    x.reserve(size);
+    y.reserve(size);
+    z.reserve(size);
+    if (hasChannel(COLOR))
+        color.reserve(size);
+    if (hasChannel(TEXTURE))
+    {
+        texX.reserve(size);
+        texY.reserve(size);
+    }
+    if (hasChannel(SPEED))
+    {
+        speedX.reserve(size);
+        speedY.reserve(size);
+        speedZ.reserve(size);
+        is6D.reserve(size);
+    }
+}
+
+size_t FloatCloud::pointSize() const
+{
+    size_t result = 3 * sizeof(float);
+    if (hasChannel(COLOR))
+        result += sizeof(RGBColor);
+    if (hasChannel(TEXTURE))
+        result += 2 * sizeof(float);
+    if (hasChannel(SPEED))
+        result += 3 * sizeof(float) + sizeof(uint8_t);
+    return result;
+}
+
+void FloatCloud::push_back(const SwarmPoint &point)
+{
+    size_t i = size();
+    resize(i + 1);
+    setPoint(i, point.point);
+    if (hasChannel(COLOR))
+        color[i] = point.color;
+    if (hasChannel(TEXTURE))
+        setTexCoor(i, point.texCoor);
+    if (hasChannel(SPEED))
+    {
+        setSpeed(i, point.speed);
+        is6D[i] = point.is6D;
+    }
+}
+
+SwarmPoint FloatCloud::swarmPoint(size_t i) const
+{
+    SwarmPoint result;
+    result.point = point(i);
+    if (hasChannel(COLOR))
+        result.color = color[i];
+    if (hasChannel(TEXTURE))
+        result.texCoor = texCoor(i);
+    if (hasChannel(SPEED))
+    {
+        result.speed = speed(i);
+        result.is6D  = (is6D[i] != 0);
+    }
+    return result;
+}
+
+FloatCloud *FloatCloud::select(const vector<int> &indexes) const
+{
+    FloatCloud *result = new FloatCloud(mChannels);
+    result->resize(indexes.size());
+    for (size_t k = 0; k < indexes.size(); k++)
+    {
+        int i = indexes[k];
+        result->x[k] = x[i];
+        result->y[k] = y[i];
+        result->z[k] = z[i];
+        if (hasChannel(COLOR))
+            result->color[k] = color[i];
+        if (hasChannel(TEXTURE))
+        {
+            result->texX[k] = texX[i];
+            result->texY[k] = texY[i];
+        }
+        if (hasChannel(SPEED))
+        {
+            result->speedX[k] = speedX[i];
+            result->speedY[k] = speedY[i];
+            result->speedZ[k] = speedZ[i];
+            result->is6D  [k] = is6D  [i];
+        }
+    }
+    return result;
+}
+
+/**
+ *  The float coordinate is compared with the double bound exactly, if the bound is replaced with the
+ *  nearest float inside the box
+ **/
+static float floatBoundAbove(double bound)
+{
+    float result = (float)bound;
+    if ((double)result < bound)
+        result = nextafterf(result,  HUGE_VALF);
+    return result;
+}
+
+static float floatBoundBelow(double bound)
+{
+    float result = (float)bound;
+    if ((double)result > bound)
+        result = nextafterf(result, -HUGE_VALF);
+    return result;
+}
+
+FloatCloud *FloatCloud::filterByAABB(const AxisAlignedBox3d &box) const
+{
+    float lowX  = floatBoundAbove(box.low ().x());
+    float lowY  = floatBoundAbove(box.low ().y());
+    float lowZ  = floatBoundAbove(box.low ().z());
+    float highX = floatBoundBelow(box.high().x());
+    float highY = floatBoundBelow(box.high().y());
+    float highZ = floatBoundBelow(box.high().z());
+
+    vector<int> inside;
+    int count = (int)size();
+    int i = 0;
+
+#ifdef WITH_SSE
+    __m128 lowX4  = _mm_set1_ps(lowX),  lowY4  = _mm_set1_ps(lowY),  lowZ4  = _mm_set1_ps(lowZ);
+    __m128 highX4 = _mm_set1_ps(highX), highY4 = _mm_set1_ps(highY), highZ4 = _mm_set1_ps(highZ);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 px = _mm_loadu_ps(&x[i]);
+        __m128 py = _mm_loadu_ps(&y[i]);
+        __m128 pz = _mm_loadu_ps(&z[i]);
+        __m128 in = _mm_and_ps(_mm_cmpge_ps(px, lowX4), _mm_cmple_ps(px, highX4));
+        in = _mm_and_ps(in, _mm_and_ps(_mm_cmpge_ps(py, lowY4), _mm_cmple_ps(py, highY4)));
+        in = _mm_and_ps(in, _mm_and_ps(_mm_cmpge_ps(pz, lowZ4), _mm_cmple_ps(pz, highZ4)));
+
+        int mask = _mm_movemask_ps(in);
+        for (int k = 0; mask != 0; k++, mask >>= 1)
+        {
+            if (mask & 1)
+                inside.push_back(i + k);
+        }
+    }
+#endif
+    for (; i < count; i++)
+    {
+        if (x[i] >= lowX && x[i] <= highX &&
+            y[i] >= lowY && y[i] <= highY &&
+            z[i] >= lowZ && z[i] <= highZ)
+        {
+            inside.push_back(i);
+        }
+    }
+    return select(inside);
+}
+
+Cloud *FloatCloud::toCloud() const
+{
+    Cloud *result = new Cloud();
+    result->reserve(size());
+    for (size_t i = 0; i < size(); i++)
+        result->push_back(swarmPoint(i));
+    return result;
+}
+
+FloatCloud *FloatCloud::fromCloud(const Cloud *cloud, int channels)
+{
+    FloatCloud *result = new FloatCloud(channels);
+    result->reserve(cloud->size());
+    for (size_t i = 0; i < cloud->size(); i++)
+        result->push_back(cloud->at(i));
+    return result;
+}
+
+} //namespace corecvs
+
+/* EOF */
@@ -0,0 +1,146 @@
+#pragma once
+/**
+ * \file floatCloud.h
+ * \brief Point cloud stored as the separate float arrays
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <stdint.h>
+#include <vector>
+
+#include "global.h"
+
+#include "vector2d.h"
+#include "vector3d.h"
+#include "rgbColor.h"
+#include "mesh3d.h"
+#include "cloud.h"
+
+namespace corecvs {
+
+using std::vector;
+
+/**
+ *  Point cloud with the structure of arrays layout and float precision.
+ *
+ *  Coordinates are always present, the colour, texture coordinate and speed are the optional channels.
+ *  SwarmPoint takes 80 bytes, here the point with the texture coordinate takes 20, so the passes over the
+ *  cloud read much less memory and the coordinate loops vectorize.
+ *
+ *  Cloud is still the type Clustering3D, the scenes and the dialogs work with, toCloud() and fromCloud()
+ *  convert between the two.
+ **/
+class FloatCloud
+{
+public:
+    enum Channel {
+        COLOR   = 0x1,
+        TEXTURE = 0x2,
+        /** Speed together with the is6D flag */
+        SPEED   = 0x4
+    };
+
+    vector<float> x;
+    vector<float> y;
+    vector<float> z;
+
+    vector<RGBColor> color;
+
+    vector<float> texX;
+    vector<float> texY;
+
+    vector<float>   speedX;
+    vector<float>   speedY;
+    vector<float>   speedZ;
+    vector<uint8_t> is6D;
+
+    explicit FloatCloud(int channels = TEXTURE) :
+        mChannels(channels)
+    {}
+
+    int channels() const
+    {
+        return mChannels;
+    }
+
+    bool hasChannel(Channel channel) const
+    {
+        return (mChannels & channel) != 0;
+    }
+
+    size_t size() const
+    {
+        return x.size();
+    }
+
+    bool empty() const
+    {
+        return x.empty();
+    }
+
+    /** Sizes all the present channels, so the points can be written by index from several threads */
+    void resize(size_t size);
+    void reserve(size_t size);
+    void clear()
+    {
+        resize(0);
+    }
+
+    Vector3dd point(size_t i) const
+    {
+        return Vector3dd(x[i], y[i], z[i]);
+    }
+
+    void setPoint(size_t i, const Vector3dd &point)
+    {
+        x[i] = (float)point.x();
+        y[i] = (float)point.y();
+        z[i] = (float)point.z();
+    }
+
+    Vector2dd texCoor(size_t i) const
+    {
+        return Vector2dd(texX[i], texY[i]);
+    }
+
+    void setTexCoor(size_t i, const Vector2dd &texCoor)
+    {
+        texX[i] = (float)texCoor.x();
+        texY[i] = (float)texCoor.y();
+    }
+
+    Vector3dd speed(size_t i) const
+    {
+        return Vector3dd(speedX[i], speedY[i], speedZ[i]);
+    }
+
+    void setSpeed(size_t i, const Vector3dd &speed)
+    {
+        speedX[i] = (float)speed.x();
+        speedY[i] = (float)speed.y();
+        speedZ[i] = (float)speed.z();
+    }
+
+    void push_back(const SwarmPoint &point);
+    SwarmPoint swarmPoint(size_t i) const;
+
+    /** Points inside the box, the box is inclusive like AxisAlignedBox3d::contains() */
+    FloatCloud *filterByAABB(const AxisAlignedBox3d &box) const;
+
+    /** Copies the points of the given indexes */
+    FloatCloud *select(const vector<int> &indexes) const;
+
+    Cloud *toCloud() const;
+    static FloatCloud *fromCloud(const Cloud *cloud, int channels = TEXTURE);
+
+    /** Bytes taken by one point */
+    size_t pointSize() const;
+
+private:
+    int mChannels;
+};
+
+} /* namespace corecvs */
+
+/* EOF */
@@ -4,6 +4,8 @@ HEADERS += \
     fileformats/ppmLoader.h \
     fileformats/rawLoader.h \
     fileformats/plyLoader.h \
+    fileformats/tiledBuffer.h \
+    fileformats/g12Codec.h \
 
 SOURCES += \
     fileformats/bufferLoader.cpp \
@@ -11,5 +13,7 @@ SOURCES += \
     fileformats/ppmLoader.cpp \
     fileformats/rawLoader.cpp \
     fileformats/plyLoader.cpp \
+    fileformats/tiledBuffer.cpp \
+    fileformats/g12Codec.cpp \
     
 
@@ -0,0 +1,667 @@
+/**
+ * \file g12Codec.cpp
+ * \brief Lossless codec of the 12 bit frames
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+#include "g12Codec.h"
+#include "mappedFile.h"
+#include "tbbWrapper.h"
+
+namespace corecvs {
+
+static const char   G12_MAGIC[4]       = { 'G', '1', '2', 'C' };
+static const size_t G12_HEADER_SIZE    = 4 * 7;
+static const size_t G12_ENTRY_SIZE     = 4 + 1;
+static const int    G12_MASK           = G12Buffer::BUFFER_MAX_VALUE;
+static const int    G12_HALF           = (G12_MASK + 1) / 2;
+/* Sanity limit for the sizes read from the file */
+static const int    G12_MAX_SIDE       = 1 << 16;
+
+/* The unary part that long is the escape to the raw value */
+static const int    RICE_LIMIT         = 16;
+/* Log2 of the window of the running mean the Rice parameter is chosen by */
+static const int    RICE_WINDOW        = 4;
+static const int    RICE_MAX_K         = G12Buffer::BUFFER_BITS;
+static const int    RICE_MAX_CODE      = RICE_LIMIT + G12Buffer::BUFFER_BITS;
+
+static inline int leadingZeros64(uint64_t value)
+{
+#ifdef __GNUC__
+    return value == 0 ? 64 : __builtin_clzll(value);
+#else
+    int count = 0;
+    for (uint64_t bit = 1ULL << 63; bit != 0 && !(value & bit); bit >>= 1)
+        count++;
+    return count;
+#endif
+}
+
+static inline int bitLength(uint32_t value)
+{
+#ifdef __GNUC__
+    return value == 0 ? 0 : 32 - __builtin_clz(value);
+#else
+    int length = 0;
+    while (value != 0) {
+        value >>= 1;
+        length++;
+    }
+    return length;
+#endif
+}
+
+static inline size_t packedRowSize(int w)
+{
+    return ((size_t)w * 3 + 1) / 2;
+}
+
+/**
+ *  Running mean of the last 2^RICE_WINDOW symbols, kept scaled by the window size.
+ *  The parameter is the smallest k with 2^k not less than the mean.
+ **/
+class RiceState
+{
+public:
+    uint32_t sum;
+
+    RiceState() : sum(4 << RICE_WINDOW) {}
+
+    inline int k() const
+    {
+        int k = sum <= (1U << RICE_WINDOW) ? 0 : bitLength((sum - 1) >> RICE_WINDOW);
+        return CORE_MIN(k, RICE_MAX_K);
+    }
+
+    inline void update(uint32_t symbol)
+    {
+        sum += symbol - (sum >> RICE_WINDOW);
+    }
+};
+
+/* Big endian bit stream, the output should have room for all the codes */
+class BitWriter
+{
+public:
+    uint8_t *position;
+    uint64_t accumulator;
+    int      bits;
+
+    BitWriter(uint8_t *output) : position(output), accumulator(0), bits(0) {}
+
+    /* Up to 32 bits, the value should not have the bits above count */
+    inline void put(uint32_t value, int count)
+    {
+        accumulator = (accumulator << count) | value;
+        bits += count;
+        if (bits >= 32)
+        {
+            bits -= 32;
+            uint32_t word = (uint32_t)(accumulator >> bits);
+            position[0] = (uint8_t)(word >> 24);
+            position[1] = (uint8_t)(word >> 16);
+            position[2] = (uint8_t)(word >>  8);
+            position[3] = (uint8_t)(word      );
+            position += 4;
+        }
+    }
+
+    inline void putRice(uint32_t symbol, RiceState &state)
+    {
+        int k = state.k();
+        uint32_t quotient = symbol >> k;
+        if (quotient < (uint32_t)RICE_LIMIT)
+            put((1U << k) | (symbol & ((1U << k) - 1)), quotient + 1 + k);
+        else
+            put(symbol, RICE_MAX_CODE);
+        state.update(symbol);
+    }
+
+    void flush()
+    {
+        while (bits >= 8)
+        {
+            bits -= 8;
+            *position++ = (uint8_t)(accumulator >> bits);
+        }
+        if (bits > 0)
+            *position++ = (uint8_t)(accumulator << (8 - bits));
+        bits = 0;
+    }
+};
+
+/* The accumulator is left aligned, the reads past the end give zeros and are checked by consumedAll() */
+class BitReader
+{
+public:
+    const uint8_t *data;
+    size_t         size;
+    size_t         position;
+    uint64_t       accumulator;
+    int            bits;
+
+    BitReader(const uint8_t *_data, size_t _size) : data(_data), size(_size), position(0), accumulator(0), bits(0) {}
+
+    /* Keeps at least 57 bits, the bits below them are the next bits of the stream too */
+    inline void refill()
+    {
+        if (position + 8 <= size)
+        {
+            uint64_t word = 0;
+            for (int i = 0; i < 8; i++)
+                word = (word << 8) | data[position + i];
+            accumulator |= word >> bits;
+            int bytes = (63 - bits) >> 3;
+            position += bytes;
+            bits     += bytes * 8;
+            return;
+        }
+        while (bits <= 56)
+        {
+            uint64_t byte = position < size ? data[position] : 0;
+            accumulator |= byte << (56 - bits);
+            position++;
+            bits += 8;
+        }
+    }
+
+    inline uint32_t getRice(RiceState &state)
+    {
+        if (bits < RICE_MAX_CODE + 1)
+            refill();
+        int k = state.k();
+        int zeros = leadingZeros64(accumulator);
+        uint32_t symbol;
+        if (zeros >= RICE_LIMIT)
+        {
+            symbol = (uint32_t)(accumulator >> (64 - RICE_MAX_CODE));
+            accumulator <<= RICE_MAX_CODE;
+            bits -= RICE_MAX_CODE;
+        }
+        else
+        {
+            accumulator <<= zeros + 1;
+            bits -= zeros + 1;
+            symbol = k == 0 ? 0 : (uint32_t)(accumulator >> (64 - k));
+            accumulator <<= k;
+            bits -= k;
+            symbol |= (uint32_t)zeros << k;
+        }
+        state.update(symbol);
+        return symbol;
+    }
+
+    bool consumedAll() const
+    {
+        return position * 8 - bits <= size * 8;
+    }
+};
+
+static inline int medPredictor(int a, int b, int c)
+{
+    int minimum = CORE_MIN(a, b);
+    int maximum = CORE_MAX(a, b);
+    return CORE_MAX(minimum, CORE_MIN(maximum, a + b - c));
+}
+
+/**
+ *  Prediction of the pixel from the left, upper and upper left neighbours.
+ *  The first row of the stripe has no upper neighbours and is predicted from the left.
+ **/
+static inline int predict(G12Codec::Predictor predictor, const uint16_t *row, const uint16_t *up, int j)
+{
+    if (up == NULL)
+        return j == 0 ? 0 : row[j - 1];
+    if (j == 0 || predictor == G12Codec::PREDICTOR_UP)
+        return up[j];
+    return medPredictor(row[j - 1], up[j], up[j - 1]);
+}
+
+static inline uint16_t zigzag(int residual)
+{
+    residual = ((residual + G12_HALF) & G12_MASK) - G12_HALF;
+    return (uint16_t)(((uint32_t)residual << 1) ^ (uint32_t)(residual >> 15));
+}
+
+static inline int unzigzag(uint32_t symbol)
+{
+    return (int)(symbol >> 1) ^ -(int)(symbol & 1);
+}
+
+/* Zigzag mapped residuals of the row, false if some value does not fit 12 bits */
+static bool residualRow(G12Codec::Predictor predictor, const uint16_t *row, const uint16_t *up, int w, uint16_t *symbols)
+{
+    uint16_t over = 0;
+    int j = 0;
+    if (w > 0)
+    {
+        symbols[0] = zigzag(row[0] - predict(predictor, row, up, 0));
+        over = row[0];
+        j = 1;
+    }
+#ifdef WITH_SSE
+    __m128i mask   = _mm_set1_epi16((int16_t)G12_MASK);
+    __m128i half   = _mm_set1_epi16((int16_t)G12_HALF);
+    __m128i overV  = _mm_setzero_si128();
+    for (; j + 8 <= w; j += 8)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i *)(row + j));
+        __m128i a = _mm_loadu_si128((const __m128i *)(row + j - 1));
+        __m128i prediction = a;
+        if (up != NULL)
+        {
+            __m128i b = _mm_loadu_si128((const __m128i *)(up + j));
+            prediction = b;
+            if (predictor == G12Codec::PREDICTOR_MED)
+            {
+                __m128i c = _mm_loadu_si128((const __m128i *)(up + j - 1));
+                __m128i gradient = _mm_sub_epi16(_mm_add_epi16(a, b), c);
+                prediction = _mm_max_epi16(_mm_min_epi16(a, b), _mm_min_epi16(_mm_max_epi16(a, b), gradient));
+            }
+        }
+        overV = _mm_or_si128(overV, x);
+        __m128i residual = _mm_sub_epi16(_mm_and_si128(_mm_add_epi16(_mm_sub_epi16(x, prediction), half), mask), half);
+        __m128i symbol   = _mm_xor_si128(_mm_slli_epi16(residual, 1), _mm_srai_epi16(residual, 15));
+        _mm_storeu_si128((__m128i *)(symbols + j), symbol);
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_andnot_si128(mask, overV), _mm_setzero_si128())) != 0xFFFF)
+        return false;
+#endif
+    for (; j < w; j++)
+    {
+        symbols[j] = zigzag(row[j] - predict(predictor, row, up, j));
+        over |= row[j];
+    }
+    return (over & ~G12_MASK) == 0;
+}
+
+/* Restores the row from the residuals, the prediction from the row above is done with SIMD */
+static void restoreRow(G12Codec::Predictor predictor, const uint16_t *symbols, const uint16_t *up, int w, uint16_t *row)
+{
+    int j = 0;
+    if (up != NULL && predictor == G12Codec::PREDICTOR_UP)
+    {
+#ifdef WITH_SSE
+        __m128i mask = _mm_set1_epi16((int16_t)G12_MASK);
+        __m128i one  = _mm_set1_epi16(1);
+        __m128i zero = _mm_setzero_si128();
+        for (; j + 8 <= w; j += 8)
+        {
+            __m128i symbol   = _mm_loadu_si128((const __m128i *)(symbols + j));
+            __m128i residual = _mm_xor_si128(_mm_srli_epi16(symbol, 1), _mm_sub_epi16(zero, _mm_and_si128(symbol, one)));
+            __m128i value    = _mm_and_si128(_mm_add_epi16(_mm_loadu_si128((const __m128i *)(up + j)), residual), mask);
+            _mm_storeu_si128((__m128i *)(row + j), value);
+        }
+#endif
+        for (; j < w; j++)
+            row[j] = (uint16_t)((up[j] + unzigzag(symbols[j])) & G12_MASK);
+        return;
+    }
+
+    for (; j < w; j++)
+        row[j] = (uint16_t)((predict(predictor, row, up, j) + unzigzag(symbols[j])) & G12_MASK);
+}
+
+static void packRow(const uint16_t *row, int w, uint8_t *output)
+{
+    int even = w & ~1;
+    G12Codec::pack12(row, even, output);
+    if (even != w)
+    {
+        output[even / 2 * 3    ] = (uint8_t)(row[even]);
+        output[even / 2 * 3 + 1] = (uint8_t)(row[even] >> 8);
+    }
+}
+
+static void unpackRow(const uint8_t *input, int w, uint16_t *row)
+{
+    int even = w & ~1;
+    G12Codec::unpack12(input, even, row);
+    if (even != w)
+        row[even] = (uint16_t)((input[even / 2 * 3] | (input[even / 2 * 3 + 1] << 8)) & G12_MASK);
+}
+
+void G12Codec::pack12(const uint16_t *input, int count, uint8_t *output)
+{
+    for (int i = 0; i + 1 < count; i += 2, output += 3)
+    {
+        uint16_t a = input[i];
+        uint16_t b = input[i + 1];
+        output[0] = (uint8_t)a;
+        output[1] = (uint8_t)(((a >> 8) & 0x0F) | (b << 4));
+        output[2] = (uint8_t)(b >> 4);
+    }
+}
+
+void G12Codec::unpack12(const uint8_t *input, int count, uint16_t *output)
+{
+    for (int i = 0; i + 1 < count; i += 2, input += 3)
+    {
+        output[i    ] = (uint16_t)(input[0] | ((input[1] & 0x0F) << 8));
+        output[i + 1] = (uint16_t)((input[1] >> 4) | (input[2] << 4));
+    }
+}
+
+/* Stripe coding */
+
+static bool encodeStripePacked(const G12Buffer *buffer, int top, int bottom, vector<uint8_t> &output)
+{
+    size_t rowSize = packedRowSize(buffer->w);
+    output.resize(rowSize * (bottom - top));
+    uint16_t over = 0;
+    for (int i = top; i < bottom; i++)
+    {
+        const uint16_t *row = &buffer->element(i, 0);
+        for (int j = 0; j < buffer->w; j++)
+            over |= row[j];
+        packRow(row, buffer->w, &output[rowSize * (i - top)]);
+    }
+    return (over & ~G12_MASK) == 0;
+}
+
+static bool encodeStripeRice(const G12Buffer *buffer, int top, int bottom, G12Codec::Predictor predictor, vector<uint8_t> &output)
+{
+    int w = buffer->w;
+    output.resize(((size_t)w * (bottom - top) * RICE_MAX_CODE + 7) / 8 + 8);
+    vector<uint16_t> symbols(w);
+
+    BitWriter writer(&output[0]);
+    RiceState state;
+    for (int i = top; i < bottom; i++)
+    {
+        const uint16_t *row = &buffer->element(i, 0);
+        const uint16_t *up  = (i == top) ? NULL : &buffer->element(i - 1, 0);
+        if (!residualRow(predictor, row, up, w, &symbols[0]))
+            return false;
+        for (int j = 0; j < w; j++)
+            writer.putRice(symbols[j], state);
+    }
+    writer.flush();
+    output.resize(writer.position - &output[0]);
+    return true;
+}
+
+static bool decodeStripeRice(const uint8_t *data, size_t size, G12Codec::Predictor predictor, G12Buffer *buffer, int top, int bottom)
+{
+    int w = buffer->w;
+    vector<uint16_t> symbols(w);
+
+    BitReader reader(data, size);
+    RiceState state;
+    for (int i = top; i < bottom; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            uint32_t symbol = reader.getRice(state);
+            if (symbol > (uint32_t)G12_MASK)
+                return false;
+            symbols[j] = (uint16_t)symbol;
+        }
+        const uint16_t *up = (i == top) ? NULL : &buffer->element(i - 1, 0);
+        restoreRow(predictor, &symbols[0], up, w, &buffer->element(i, 0));
+    }
+    return reader.consumedAll();
+}
+
+class ParallelEncodeStripes
+{
+    const G12Buffer *buffer;
+    G12Codec::Mode mode;
+    G12Codec::Predictor predictor;
+    int stripeRows;
+    vector<vector<uint8_t> > *blobs;
+    vector<uint8_t> *modes;
+    vector<uint8_t> *valid;
+
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        for (int s = r.begin(); s < r.end(); s++)
+        {
+            int top    = s * stripeRows;
+            int bottom = CORE_MIN(top + stripeRows, buffer->h);
+            vector<uint8_t> &blob = (*blobs)[s];
+
+            if (mode == G12Codec::MODE_RICE)
+            {
+                if (!encodeStripeRice(buffer, top, bottom, predictor, blob))
+                    continue;
+                if (blob.size() < packedRowSize(buffer->w) * (bottom - top))
+                {
+                    (*modes)[s] = G12Codec::MODE_RICE;
+                    (*valid)[s] = true;
+                    continue;
+                }
+            }
+            (*modes)[s] = G12Codec::MODE_PACKED;
+            (*valid)[s] = encodeStripePacked(buffer, top, bottom, blob);
+        }
+    }
+
+    ParallelEncodeStripes(const G12Buffer *_buffer, G12Codec::Mode _mode, G12Codec::Predictor _predictor, int _stripeRows,
+                          vector<vector<uint8_t> > *_blobs, vector<uint8_t> *_modes, vector<uint8_t> *_valid) :
+        buffer(_buffer), mode(_mode), predictor(_predictor), stripeRows(_stripeRows), blobs(_blobs), modes(_modes), valid(_valid)
+    {}
+};
+
+struct StripeEntry {
+    const uint8_t *data;
+    size_t         size;
+    uint8_t        mode;
+};
+
+class ParallelDecodeStripes
+{
+    const vector<StripeEntry> *stripes;
+    G12Codec::Predictor predictor;
+    int stripeRows;
+    G12Buffer *buffer;
+    vector<uint8_t> *valid;
+
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        for (int s = r.begin(); s < r.end(); s++)
+        {
+            const StripeEntry &stripe = (*stripes)[s];
+            int top    = s * stripeRows;
+            int bottom = CORE_MIN(top + stripeRows, buffer->h);
+
+            if (stripe.mode == G12Codec::MODE_RICE)
+            {
+                (*valid)[s] = decodeStripeRice(stripe.data, stripe.size, predictor, buffer, top, bottom);
+                continue;
+            }
+
+            size_t rowSize = packedRowSize(buffer->w);
+            if (stripe.mode != G12Codec::MODE_PACKED || stripe.size != rowSize * (bottom - top))
+                continue;
+            for (int i = top; i < bottom; i++)
+                unpackRow(stripe.data + rowSize * (i - top), buffer->w, &buffer->element(i, 0));
+            (*valid)[s] = true;
+        }
+    }
+
+    ParallelDecodeStripes(const vector<StripeEntry> *_stripes, G12Codec::Predictor _predictor, int _stripeRows,
+                          G12Buffer *_buffer, vector<uint8_t> *_valid) :
+        stripes(_stripes), predictor(_predictor), stripeRows(_stripeRows), buffer(_buffer), valid(_valid)
+    {}
+};
+
+/* Header */
+
+static void putU32(vector<uint8_t> &output, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        output.push_back((uint8_t)(value >> (8 * i)));
+}
+
+static uint32_t getU32(const uint8_t *input)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= (uint32_t)input[i] << (8 * i);
+    return value;
+}
+
+/* G12Codec */
+
+G12Codec::G12Codec(Mode mode, Predictor predictor, int stripeRows) :
+    mMode(mode),
+    mPredictor(predictor),
+    mStripeRows(CORE_MAX(stripeRows, 1))
+{
+}
+
+bool G12Codec::encode(const G12Buffer *buffer, vector<uint8_t> &output) const
+{
+    output.clear();
+    if (buffer == NULL)
+        return false;
+
+    int h = buffer->h;
+    int w = buffer->w;
+    int stripes = (h + mStripeRows - 1) / mStripeRows;
+
+    vector<vector<uint8_t> > blobs(stripes);
+    vector<uint8_t> modes(stripes);
+    vector<uint8_t> valid(stripes, false);
+    if (w > 0)
+        parallelable_for(0, stripes, ParallelEncodeStripes(buffer, mMode, mPredictor, mStripeRows, &blobs, &modes, &valid));
+
+    size_t total = G12_HEADER_SIZE + stripes * G12_ENTRY_SIZE;
+    for (int s = 0; s < stripes; s++)
+    {
+        if (!valid[s])
+        {
+            SYNC_PRINT(("G12Codec::encode(): The frame has values that do not fit %d bits\n", G12Buffer::BUFFER_BITS));
+            return false;
+        }
+        total += blobs[s].size();
+    }
+
+    output.reserve(total);
+    output.insert(output.end(), G12_MAGIC, G12_MAGIC + sizeof(G12_MAGIC));
+    putU32(output, VERSION);
+    putU32(output, h);
+    putU32(output, w);
+    putU32(output, mMode);
+    putU32(output, mPredictor);
+    putU32(output, mStripeRows);
+    for (int s = 0; s < stripes; s++)
+    {
+        putU32(output, (uint32_t)blobs[s].size());
+        output.push_back(modes[s]);
+    }
+    for (int s = 0; s < stripes; s++)
+        output.insert(output.end(), blobs[s].begin(), blobs[s].end());
+    return true;
+}
+
+G12Buffer *G12Codec::decode(const uint8_t *data, size_t size)
+{
+    if (data == NULL || size < G12_HEADER_SIZE || memcmp(data, G12_MAGIC, sizeof(G12_MAGIC)) != 0)
+        return NULL;
+    if (getU32(data + 4) != VERSION)
+        return NULL;
+
+    uint32_t h          = getU32(data +  8);
+    uint32_t w          = getU32(data + 12);
+    uint32_t mode       = getU32(data + 16);
+    uint32_t predictor  = getU32(data + 20);
+    uint32_t stripeRows = getU32(data + 24);
+    if (h == 0 || w == 0 || h > (uint32_t)G12_MAX_SIDE || w > (uint32_t)G12_MAX_SIDE || stripeRows == 0)
+        return NULL;
+    if (mode != MODE_PACKED && mode != MODE_RICE)
+        return NULL;
+    if (predictor != PREDICTOR_UP && predictor != PREDICTOR_MED)
+        return NULL;
+
+    stripeRows = CORE_MIN(stripeRows, h);
+    size_t stripes = (h + stripeRows - 1) / stripeRows;
+    size_t offset  = G12_HEADER_SIZE + stripes * G12_ENTRY_SIZE;
+    if (offset > size)
+        return NULL;
+
+    vector<StripeEntry> entries(stripes);
+    for (size_t s = 0; s < stripes; s++)
+    {
+        const uint8_t *entry = data + G12_HEADER_SIZE + s * G12_ENTRY_SIZE;
+        entries[s].size = getU32(entry);
+        entries[s].mode = entry[4];
+        /* The packed frame has only the packed stripes, the Rice frame falls back to them per stripe */
+        if (entries[s].mode != MODE_PACKED && (entries[s].mode != MODE_RICE || mode != MODE_RICE))
+            return NULL;
+        if (entries[s].size > size - offset)
+            return NULL;
+        entries[s].data = data + offset;
+        offset += entries[s].size;
+    }
+
+    G12Buffer *result = new G12Buffer(h, w, false);
+    vector<uint8_t> valid(stripes, false);
+    parallelable_for(0, (int)stripes, ParallelDecodeStripes(&entries, (Predictor)predictor, stripeRows, result, &valid));
+
+    for (size_t s = 0; s < stripes; s++)
+    {
+        if (!valid[s])
+        {
+            delete_safe(result);
+            break;
+        }
+    }
+    return result;
+}
+
+/* G12CodecLoader */
+
+string G12CodecLoader::prefix1(".g12z");
+
+bool G12CodecLoader::acceptsFile(string name)
+{
+    return name.length() >= prefix1.length() &&
+           name.compare(name.length() - prefix1.length(), prefix1.length(), prefix1) == 0;
+}
+
+G12Buffer *G12CodecLoader::load(string name)
+{
+    MappedFile file;
+    if (!file.open(name))
+    {
+        SYNC_PRINT(("G12CodecLoader::load(): Unable to map <%s>\n", name.c_str()));
+        return NULL;
+    }
+    G12Buffer *result = G12Codec::decode(file.data(), file.size());
+    if (result == NULL)
+        SYNC_PRINT(("G12CodecLoader::load(): <%s> is corrupted\n", name.c_str()));
+    return result;
+}
+
+int G12CodecLoader::save(string name, G12Buffer *buffer, const G12Codec &codec)
+{
+    vector<uint8_t> encoded;
+    if (!codec.encode(buffer, encoded))
+        return -1;
+
+    FILE *fp = fopen(name.c_str(), "wb");
+    if (fp == NULL)
+    {
+        SYNC_PRINT(("G12CodecLoader::save(): Unable to open <%s> for writing\n", name.c_str()));
+        return -1;
+    }
+    size_t written = fwrite(&encoded[0], 1, encoded.size(), fp);
+    int closed = fclose(fp);
+    return (written == encoded.size() && closed == 0) ? 0 : -1;
+}
+
+} //namespace corecvs
+
+/* EOF */
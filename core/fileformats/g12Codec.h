@@ -0,0 +1,101 @@
+#pragma once
+/**
+ * \file g12Codec.h
+ * \brief Lossless codec of the 12 bit frames
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "global.h"
+
+#include "bufferLoader.h"
+#include "g12Buffer.h"
+
+namespace corecvs {
+
+using std::string;
+using std::vector;
+
+/**
+ *  \brief Lossless codec of G12Buffer
+ *
+ *  The frame is cut into the stripes of rows that are coded independently, so both the encoder and
+ *  the decoder run the stripes in parallel. Inside of the stripe every pixel is predicted from the
+ *  already coded neighbours, the residual is wrapped to 12 bits, zigzag mapped and written with the
+ *  adaptive Rice code. The long codes escape to the raw 12 bit value, so no pixel takes more than
+ *  28 bits. The stripe that does not become smaller than the 12 bit packing is stored packed.
+ *
+ *  File layout, all the numbers are little endian:
+ *
+ *  \code
+ *    "G12C" version h w mode predictor stripeRows
+ *    stripes x { size:u32 mode:u8 }
+ *    stripe data
+ *  \endcode
+ *
+ *  The stripe mode is packed or Rice, the Rice frame may have the packed stripes, the packed one only them.
+ *  Only the lower 12 bits are kept, encode() fails on the larger values.
+ **/
+class G12Codec
+{
+public:
+    enum Mode {
+        /** Two pixels in three bytes */
+        MODE_PACKED,
+        /** Predictor and the adaptive Rice code */
+        MODE_RICE
+    };
+
+    enum Predictor {
+        /** Pixel above, the decoder restores whole rows with SIMD */
+        PREDICTOR_UP,
+        /** Median edge detector of LOCO-I, usually 10-15% smaller, the decoder is sequential in the row */
+        PREDICTOR_MED
+    };
+
+    static const uint32_t VERSION = 1;
+
+    G12Codec(Mode mode = MODE_RICE, Predictor predictor = PREDICTOR_MED, int stripeRows = 32);
+
+    /** Replaces the contents of output with the encoded frame */
+    bool encode(const G12Buffer *buffer, vector<uint8_t> &output) const;
+
+    /** Returns NULL if the data is corrupted */
+    static G12Buffer *decode(const uint8_t *data, size_t size);
+
+    /** Packs count values, count should be even. The output takes count * 3 / 2 bytes */
+    static void pack12  (const uint16_t *input, int count, uint8_t *output);
+    static void unpack12(const uint8_t *input, int count, uint16_t *output);
+
+private:
+    Mode      mMode;
+    Predictor mPredictor;
+    int       mStripeRows;
+};
+
+/**
+ *  Reads and writes the G12Codec files, the files are recognized by the ".g12z" extension.
+ *  Registered in the BufferFactory, so the file capture sources read such frames as is.
+ **/
+class G12CodecLoader : public BufferLoader<G12Buffer>
+{
+    static string prefix1;
+
+public:
+    G12CodecLoader() {}
+    virtual ~G12CodecLoader() {}
+
+    virtual bool acceptsFile(string name);
+    virtual G12Buffer * load(string name);
+
+    /** Returns 0 on success, like PPMLoader::save() */
+    int save(string name, G12Buffer *buffer, const G12Codec &codec = G12Codec());
+};
+
+} //namespace corecvs
+
+/* EOF */
@@ -4,14 +4,16 @@
  * \date Nov 13, 2012
  **/
 
-#include "plyLoader.h"
-
-
+#include <stdlib.h>
+#include <string.h>
 
-PLYLoader::PLYLoader()
-{
-}
+#include "plyLoader.h"
+#include "atomicOps.h"
+#include "tbbWrapper.h"
 
+using corecvs::BlockedRange;
+using corecvs::parallelable_for;
+using corecvs::FloatCloud;
 
 
 /**
@@ -38,209 +40,1249 @@ PLYLoader::PLYLoader()
  *
  **/
 
-int PLYLoader::loadPLY(istream &input, Mesh3D &mesh)
+static bool isHostLittleEndian()
 {
-    char line[300];
-    input.getline(line, sizeof(line) - 1);
-    if (strcmp(line, "ply") != 0) {
-        SYNC_PRINT(("Not a PLY file\n"));
-        return 1;
+    uint16_t probe = 1;
+    return *(uint8_t *)&probe == 1;
+}
+
+/** Value of the given file type at the position, swap is set for the foreign byte order */
+template<typename Dst>
+static inline Dst decodeValue(const uint8_t *position, PlyProperty::Type type, bool swap)
+{
+    uint8_t swapped[8];
+    if (swap)
+    {
+        int size = PlyProperty::typeSize(type);
+        for (int i = 0; i < size; i++)
+            swapped[i] = position[size - 1 - i];
+        position = swapped;
     }
 
-    const char *com_format     = "format";
-    const char *com_comment    = "comment";
-    const char *com_element    = "element";
-    const char *com_property   = "property";
-    const char *com_end_header = "end_header";
-    const char *form_ascii     = "ascii";
-    const char *form_binaryle  = "binary_little_endian";
+    switch (type)
+    {
+        case PlyProperty::TYPE_CHAR:   { int8_t   value; memcpy(&value, position, sizeof(value)); return (Dst)value; }
+        case PlyProperty::TYPE_UCHAR:  { uint8_t  value; memcpy(&value, position, sizeof(value)); return (Dst)value; }
+        case PlyProperty::TYPE_SHORT:  { int16_t  value; memcpy(&value, position, sizeof(value)); return (Dst)value; }
+        case PlyProperty::TYPE_USHORT: { uint16_t value; memcpy(&value, position, sizeof(value)); return (Dst)value; }
+        case PlyProperty::TYPE_INT:    { int32_t  value; memcpy(&value, position, sizeof(value)); return (Dst)value; }
+        case PlyProperty::TYPE_UINT:   { uint32_t value; memcpy(&value, position, sizeof(value)); return (Dst)value; }
+        case PlyProperty::TYPE_FLOAT:  { float    value; memcpy(&value, position, sizeof(value)); return (Dst)value; }
+        case PlyProperty::TYPE_DOUBLE: { double   value; memcpy(&value, position, sizeof(value)); return (Dst)value; }
+        default:
+            return Dst(0);
+    }
+}
 
+/** Column of the fixed stride rows, the type switch is out of the loop */
+template<typename Src, typename Dst>
+static void copyColumn(const uint8_t *position, size_t stride, size_t count, Dst *output)
+{
+    for (size_t i = 0; i < count; i++, position += stride)
+    {
+        Src value;
+        memcpy(&value, position, sizeof(value));
+        output[i] = (Dst)value;
+    }
+}
 
+template<typename Dst>
+static void convertColumn(const uint8_t *position, size_t stride, size_t count, PlyProperty::Type type, bool swap, Dst *output)
+{
+    if (swap)
+    {
+        for (size_t i = 0; i < count; i++, position += stride)
+            output[i] = decodeValue<Dst>(position, type, true);
+        return;
+    }
 
-    const char *el_vertex = "vertex";
-    const char *el_face   = "face";
+    switch (type)
+    {
+        case PlyProperty::TYPE_CHAR:   copyColumn<int8_t  , Dst>(position, stride, count, output); break;
+        case PlyProperty::TYPE_UCHAR:  copyColumn<uint8_t , Dst>(position, stride, count, output); break;
+        case PlyProperty::TYPE_SHORT:  copyColumn<int16_t , Dst>(position, stride, count, output); break;
+        case PlyProperty::TYPE_USHORT: copyColumn<uint16_t, Dst>(position, stride, count, output); break;
+        case PlyProperty::TYPE_INT:    copyColumn<int32_t , Dst>(position, stride, count, output); break;
+        case PlyProperty::TYPE_UINT:   copyColumn<uint32_t, Dst>(position, stride, count, output); break;
+        case PlyProperty::TYPE_FLOAT:  copyColumn<float   , Dst>(position, stride, count, output); break;
+        case PlyProperty::TYPE_DOUBLE: copyColumn<double  , Dst>(position, stride, count, output); break;
+        default:
+            break;
+    }
+}
 
-    int vertex_number = -1;
-    int face_number = -1;
+/**
+ *  End of the binary row that starts at the position, NULL if the row does not fit the data
+ **/
+static const uint8_t *binaryRowEnd(const uint8_t *position, const uint8_t *end, const PlyElement &element, bool swap)
+{
+    for (size_t p = 0; p < element.properties.size(); p++)
+    {
+        const PlyProperty &property = element.properties[p];
+        if (!property.isList)
+        {
+            size_t size = PlyProperty::typeSize(property.type);
+            if ((size_t)(end - position) < size)
+                return NULL;
+            position += size;
+            continue;
+        }
 
-    enum PlyFormat {
-        ASCII,
-        BINARY_LITTLE_ENDIAN,
-        OTHER
-    };
+        size_t countSize = PlyProperty::typeSize(property.countType);
+        if ((size_t)(end - position) < countSize)
+            return NULL;
+        int64_t count = decodeValue<int64_t>(position, property.countType, swap);
+        position += countSize;
+        if (count < 0 || (uint64_t)(end - position) / PlyProperty::typeSize(property.type) < (uint64_t)count)
+            return NULL;
+        position += count * PlyProperty::typeSize(property.type);
+    }
+    return position;
+}
 
-    PlyFormat plyFormat = OTHER;
+/** Next whitespace separated number of the ascii line */
+static inline bool nextNumber(const uint8_t *&position, const uint8_t *end, double *value)
+{
+    while (position < end && (*position == ' ' || *position == '\t' || *position == '\r' || *position == '\n'))
+        position++;
+    if (position >= end)
+        return false;
 
-    while (!input.eof())
+    char token[64];
+    int length = 0;
+    while (position < end && *position != ' ' && *position != '\t' && *position != '\r' && *position != '\n')
     {
-        input.getline(line, sizeof(line) - 1);
-        char *work = line;
-        if (strncmp(work, com_format, strlen(com_format)) == 0)
+        if (length == (int)sizeof(token) - 1)
+            return false;
+        token[length++] = (char)*position++;
+    }
+    token[length] = 0;
+
+    char *tail;
+    *value = strtod(token, &tail);
+    return tail == token + length;
+}
+
+static inline const uint8_t *rowStart(const PLYReader::Layout &layout, size_t row)
+{
+    return layout.stride != 0 ? layout.begin + row * layout.stride : layout.begin + layout.rowOffsets[row];
+}
+
+static inline const uint8_t *rowEnd(const PLYReader::Layout &layout, size_t row)
+{
+    return layout.stride != 0 ? layout.begin + (row + 1) * layout.stride : layout.begin + layout.rowOffsets[row + 1];
+}
+
+/* PlyProperty */
+
+static const struct {
+    cchar *name;
+    cchar *sizedName;
+    int    size;
+} plyTypes[PlyProperty::TYPE_INVALID] = {
+    { "char"  , "int8"   , 1 },
+    { "uchar" , "uint8"  , 1 },
+    { "short" , "int16"  , 2 },
+    { "ushort", "uint16" , 2 },
+    { "int"   , "int32"  , 4 },
+    { "uint"  , "uint32" , 4 },
+    { "float" , "float32", 4 },
+    { "double", "float64", 8 }
+};
+
+int PlyProperty::typeSize(Type type)
+{
+    return type < TYPE_INVALID ? plyTypes[type].size : 0;
+}
+
+cchar *PlyProperty::typeName(Type type)
+{
+    return type < TYPE_INVALID ? plyTypes[type].name : "invalid";
+}
+
+PlyProperty::Type PlyProperty::typeByName(const char *name, size_t length)
+{
+    for (int i = 0; i < TYPE_INVALID; i++)
+    {
+        if ((strlen(plyTypes[i].name)      == length && strncmp(name, plyTypes[i].name     , length) == 0) ||
+            (strlen(plyTypes[i].sizedName) == length && strncmp(name, plyTypes[i].sizedName, length) == 0))
+            return (Type)i;
+    }
+    return TYPE_INVALID;
+}
+
+/* PlyElement */
+
+int PlyElement::findProperty(const std::string &name) const
+{
+    for (size_t i = 0; i < properties.size(); i++)
+        if (properties[i].name == name)
+            return (int)i;
+    return -1;
+}
+
+size_t PlyElement::rowSize() const
+{
+    size_t size = 0;
+    for (size_t i = 0; i < properties.size(); i++)
+    {
+        if (properties[i].isList)
+            return 0;
+        size += PlyProperty::typeSize(properties[i].type);
+    }
+    return size;
+}
+
+size_t PlyElement::minimalRowSize() const
+{
+    size_t size = 0;
+    for (size_t i = 0; i < properties.size(); i++)
+        size += PlyProperty::typeSize(properties[i].isList ? properties[i].countType : properties[i].type);
+    return size;
+}
+
+/* PlyHeader */
+
+bool PlyHeader::parse(const uint8_t *data, size_t dataSize)
+{
+    format = ASCII;
+    comments.clear();
+    elements.clear();
+    size = 0;
+
+    bool formatFound = false;
+    size_t lineNumber = 0;
+    const uint8_t *position = data;
+    const uint8_t *end = data + dataSize;
+    while (position < end)
+    {
+        const uint8_t *lineEnd = (const uint8_t *)memchr(position, '\n', end - position);
+        if (lineEnd == NULL)
+            break;
+        std::string line((const char *)position, lineEnd - position);
+        position = lineEnd + 1;
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.resize(line.size() - 1);
+
+        if (lineNumber++ == 0)
         {
-            work += strlen(com_format);
-            while(*work == ' ' && *work != 0) work++;
-            char *format = work;
-            if (strncmp(format, form_ascii, strlen(form_ascii)) == 0)
+            if (line != "ply")
             {
-                plyFormat = ASCII;
-                //SYNC_PRINT(("PLY ascii format\n"));
-                continue;
+                SYNC_PRINT(("Not a PLY file\n"));
+                return false;
             }
+            continue;
+        }
 
-            if (strncmp(format, form_binaryle, strlen(form_binaryle)) == 0)
+        vector<std::string> tokens;
+        size_t start = line.find_first_not_of(" \t");
+        while (start != std::string::npos)
+        {
+            size_t stop = line.find_first_of(" \t", start);
+            tokens.push_back(line.substr(start, stop == std::string::npos ? std::string::npos : stop - start));
+            start = line.find_first_not_of(" \t", stop);
+        }
+        if (tokens.empty())
+            continue;
+
+        const std::string &command = tokens[0];
+        if (command == "comment")
+        {
+            size_t text = line.find("comment") + strlen("comment");
+            comments.push_back(line.substr(CORE_MIN(text + 1, line.size())));
+            continue;
+        }
+
+        if (command == "obj_info")
+            continue;
+
+        if (command == "format")
+        {
+            if (tokens.size() < 2)
             {
-                plyFormat = BINARY_LITTLE_ENDIAN;
-                //SYNC_PRINT(("PLY binary format\n"));
-                continue;
+                SYNC_PRINT(("PLY format is missing\n"));
+                return false;
             }
-
-            SYNC_PRINT(("PLY format not supported. Format here <%s>\n", format));
-            return 1;
+            if (tokens[1] == "ascii") {
+                format = ASCII;
+            } else if (tokens[1] == "binary_little_endian") {
+                format = BINARY_LITTLE_ENDIAN;
+            } else if (tokens[1] == "binary_big_endian") {
+                format = BINARY_BIG_ENDIAN;
+            } else {
+                SYNC_PRINT(("PLY format not supported. Format here <%s>\n", tokens[1].c_str()));
+                return false;
+            }
+            formatFound = true;
+            continue;
         }
 
-        if (strncmp(work, com_comment, strlen(com_comment)) == 0)
+        if (command == "element")
         {
-            work += strlen(com_comment);
-            //printf("Skipping comment <%s>\n", work);
+            char *tail = NULL;
+            unsigned long long count = tokens.size() == 3 ? strtoull(tokens[2].c_str(), &tail, 10) : 0;
+            if (tail == NULL || *tail != 0)
+            {
+                SYNC_PRINT(("Element <%s> is corrupted\n", line.c_str()));
+                return false;
+            }
+            elements.push_back(PlyElement(tokens[1], count));
             continue;
         }
 
-        if (strncmp(work, com_property, strlen(com_property)) == 0)
+        if (command == "property")
         {
-            work += strlen(com_property);
+            if (elements.empty())
+            {
+                SYNC_PRINT(("Property <%s> is outside of the element\n", line.c_str()));
+                return false;
+            }
+            PlyProperty property;
+            if (tokens.size() == 5 && tokens[1] == "list")
+            {
+                property.isList    = true;
+                property.countType = PlyProperty::typeByName(tokens[2].c_str(), tokens[2].size());
+                property.type      = PlyProperty::typeByName(tokens[3].c_str(), tokens[3].size());
+                property.name      = tokens[4];
+            }
+            else if (tokens.size() == 3)
+            {
+                property.type      = PlyProperty::typeByName(tokens[1].c_str(), tokens[1].size());
+                property.name      = tokens[2];
+            }
+            else
+            {
+                SYNC_PRINT(("Property <%s> is corrupted\n", line.c_str()));
+                return false;
+            }
 
-            while(*work == ' ' && *work != 0) work++;
+            if (property.type == PlyProperty::TYPE_INVALID || property.countType == PlyProperty::TYPE_INVALID ||
+                property.countType == PlyProperty::TYPE_FLOAT  || property.countType == PlyProperty::TYPE_DOUBLE)
+            {
+                SYNC_PRINT(("Property type is not supported <%s>\n", line.c_str()));
+                return false;
+            }
+            elements.back().properties.push_back(property);
+            continue;
+        }
 
-            if (strncmp(work, el_vertex, strlen(el_vertex)) == 0)
+        if (command == "end_header")
+        {
+            if (!formatFound)
             {
-               work += strlen(el_vertex);
-               if (sscanf(work, "%d", &vertex_number) != 1) {
-                   SYNC_PRINT(("Vertex number is not found"));
-                   continue;
-               }
-               //SYNC_PRINT(("Vertex number %d", vertex_number));
-               continue;
+                SYNC_PRINT(("PLY format is missing\n"));
+                return false;
             }
+            size = position - data;
+            return true;
+        }
+
+        SYNC_PRINT(("Unknown PLY header line <%s>\n", line.c_str()));
+        return false;
+    }
+
+    SYNC_PRINT(("PLY header is not complete\n"));
+    return false;
+}
+
+void PlyHeader::write(std::ostream &out) const
+{
+    static cchar *formatNames[] = { "ascii", "binary_little_endian", "binary_big_endian" };
+
+    out << "ply\n";
+    out << "format " << formatNames[format] << " 1.0\n";
+    for (size_t i = 0; i < comments.size(); i++)
+        out << "comment " << comments[i] << "\n";
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        const PlyElement &element = elements[i];
+        out << "element " << element.name << " " << (unsigned long long)element.count << "\n";
+        for (size_t p = 0; p < element.properties.size(); p++)
+        {
+            const PlyProperty &property = element.properties[p];
+            if (property.isList)
+                out << "property list " << PlyProperty::typeName(property.countType) << " ";
+            else
+                out << "property ";
+            out << PlyProperty::typeName(property.type) << " " << property.name << "\n";
+        }
+    }
+    out << "end_header\n";
+}
+
+int PlyHeader::findElement(const std::string &name) const
+{
+    for (size_t i = 0; i < elements.size(); i++)
+        if (elements[i].name == name)
+            return (int)i;
+    return -1;
+}
+
+/* PLYReader */
+
+PLYReader::PLYReader() :
+    mData(NULL),
+    mSize(0)
+{
+}
+
+PLYReader::~PLYReader()
+{
+}
+
+bool PLYReader::open(const std::string &fileName)
+{
+    close();
+    if (!mMapped.open(fileName))
+    {
+        SYNC_PRINT(("PLYReader::open(): Unable to map <%s>\n", fileName.c_str()));
+        return false;
+    }
+    mData = mMapped.data();
+    mSize = mMapped.size();
+    return resolve();
+}
 
-            if (strncmp(work, el_face, strlen(el_face)) == 0)
+bool PLYReader::open(std::istream &input)
+{
+    close();
+    char chunk[1 << 16];
+    while (input.read(chunk, sizeof(chunk)) || input.gcount() > 0)
+        mBuffer.insert(mBuffer.end(), chunk, chunk + input.gcount());
+    mData = mBuffer.empty() ? NULL : &mBuffer[0];
+    mSize = mBuffer.size();
+    return resolve();
+}
+
+bool PLYReader::open(const uint8_t *data, size_t size)
+{
+    close();
+    mData = data;
+    mSize = size;
+    return resolve();
+}
+
+void PLYReader::close()
+{
+    mMapped.close();
+    mBuffer.clear();
+    mData = NULL;
+    mSize = 0;
+    mHeader = PlyHeader();
+    mLayouts.clear();
+}
+
+bool PLYReader::resolve()
+{
+    if (mData == NULL || !mHeader.parse(mData, mSize))
+        return false;
+
+    mLayouts.resize(mHeader.elements.size());
+    if (mHeader.format == PlyHeader::ASCII)
+        return resolveAscii();
+    return resolveBinary();
+}
+
+bool PLYReader::resolveBinary()
+{
+    bool swap = (mHeader.format == PlyHeader::BINARY_LITTLE_ENDIAN) != isHostLittleEndian();
+    const uint8_t *position = mData + mHeader.size;
+    const uint8_t *end      = mData + mSize;
+
+    for (size_t e = 0; e < mHeader.elements.size(); e++)
+    {
+        const PlyElement &element = mHeader.elements[e];
+        Layout &layout = mLayouts[e];
+        layout.begin  = position;
+        layout.stride = element.rowSize();
+
+        if (layout.stride != 0)
+        {
+            if ((uint64_t)(end - position) / layout.stride < element.count)
             {
-               work += strlen(el_face);
-               if (sscanf(work, "%d", &face_number) != 1) {
-                   SYNC_PRINT(("Face number is not found"));
-                   continue;
-               }
-               //SYNC_PRINT(("Face number %d", face_number));
-               continue;
+                SYNC_PRINT(("PLYReader: Element <%s> is truncated\n", element.name.c_str()));
+                return false;
             }
-            //SYNC_PRINT(("Found unsupported property <%s>\n", work));
+            position += layout.stride * element.count;
+            layout.end = position;
             continue;
         }
 
-        if (strncmp(work, com_element, strlen(com_element)) == 0)
+        /* Element with lists. The count comes from the header, so it is bounded by the data before anything is allocated */
+        size_t minimal = CORE_MAX(element.minimalRowSize(), (size_t)1);
+        if ((uint64_t)(end - position) / minimal < element.count)
         {
-            work += strlen(com_element);
+            SYNC_PRINT(("PLYReader: Element <%s> has more rows than the data can hold\n", element.name.c_str()));
+            return false;
+        }
 
-            while(*work == ' ' && *work != 0) work++;
+        /* The uniform lists are checked, otherwise the rows are indexed */
+        bool uniform = false;
+        if (element.count != 0)
+        {
+            const uint8_t *firstEnd = binaryRowEnd(position, end, element, swap);
+            size_t stride = firstEnd == NULL ? 0 : firstEnd - position;
+            uniform = (stride != 0) && ((uint64_t)(end - position) / stride >= element.count);
+            for (uint64_t i = 1; uniform && i < element.count; i++)
+            {
+                const uint8_t *row = position + i * stride;
+                uniform = (binaryRowEnd(row, end, element, swap) == row + stride);
+            }
+            if (uniform)
+                layout.stride = stride;
+        }
 
-            if (strncmp(work, el_vertex, strlen(el_vertex)) == 0)
+        if (!uniform)
+        {
+            layout.rowOffsets.resize(element.count + 1);
+            const uint8_t *row = position;
+            for (uint64_t i = 0; i < element.count; i++)
             {
-               work += strlen(el_vertex);
-               if (sscanf(work, "%d", &vertex_number) != 1) {
-                   SYNC_PRINT(("Vertex number is not found"));
-                   continue;
-               }
-               //SYNC_PRINT(("Vertex number %d\n", vertex_number));
-               continue;
+                layout.rowOffsets[i] = row - position;
+                row = binaryRowEnd(row, end, element, swap);
+                if (row == NULL)
+                {
+                    SYNC_PRINT(("PLYReader: Element <%s> is truncated at row %llu\n", element.name.c_str(), (unsigned long long)i));
+                    return false;
+                }
             }
+            layout.rowOffsets[element.count] = row - position;
+            position = row;
+        }
+        else
+        {
+            position += layout.stride * element.count;
+        }
+        layout.end = position;
+    }
+    return true;
+}
 
-            if (strncmp(work, el_face, strlen(el_face)) == 0)
+class ParallelCountLines
+{
+    const uint8_t *data;
+    size_t size;
+    size_t chunk;
+    vector<size_t> *counts;
+
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        for (int c = r.begin(); c < r.end(); c++)
+        {
+            const uint8_t *position = data + c * chunk;
+            const uint8_t *end = data + CORE_MIN(size, (c + 1) * chunk);
+            size_t count = 0;
+            while ((position = (const uint8_t *)memchr(position, '\n', end - position)) != NULL)
             {
-               work += strlen(el_face);
-               if (sscanf(work, "%d", &face_number) != 1) {
-                   SYNC_PRINT(("Face number is not found"));
-                   continue;
-               }
-               //SYNC_PRINT(("Face number %d\n", face_number));
-               continue;
+                count++;
+                position++;
             }
-            printf("Found unsupported element <%s>\n", work);
-            continue;
+            (*counts)[c] = count;
         }
+    }
 
-        if (strncmp(work, com_end_header, strlen(com_end_header)) == 0)
+    ParallelCountLines(const uint8_t *_data, size_t _size, size_t _chunk, vector<size_t> *_counts) :
+        data(_data), size(_size), chunk(_chunk), counts(_counts)
+    {}
+};
+
+class ParallelIndexLines
+{
+    const uint8_t *data;
+    size_t size;
+    size_t chunk;
+    const vector<size_t> *firsts;
+    vector<size_t> *starts;
+
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        for (int c = r.begin(); c < r.end(); c++)
         {
-            break;
+            const uint8_t *position = data + c * chunk;
+            const uint8_t *end = data + CORE_MIN(size, (c + 1) * chunk);
+            size_t line = (*firsts)[c];
+            while ((position = (const uint8_t *)memchr(position, '\n', end - position)) != NULL)
+            {
+                position++;
+                (*starts)[++line] = position - data;
+            }
         }
     }
 
-    if (vertex_number == -1 || face_number == -1)
+    ParallelIndexLines(const uint8_t *_data, size_t _size, size_t _chunk, const vector<size_t> *_firsts, vector<size_t> *_starts) :
+        data(_data), size(_size), chunk(_chunk), firsts(_firsts), starts(_starts)
+    {}
+};
+
+bool PLYReader::resolveAscii()
+{
+    const uint8_t *body = mData + mHeader.size;
+    size_t size = mSize - mHeader.size;
+
+    /* Newlines are counted by chunks, then every chunk writes the starts of its lines */
+    const size_t chunk = 1 << 20;
+    int chunks = (int)((size + chunk - 1) / chunk);
+    vector<size_t> counts(chunks);
+    parallelable_for(0, chunks, ParallelCountLines(body, size, chunk, &counts));
+
+    vector<size_t> firsts(chunks);
+    size_t newlines = 0;
+    for (int c = 0; c < chunks; c++)
     {
-        SYNC_PRINT(("Necessary data was missing form the header\n"));
-        return 1;
+        firsts[c] = newlines;
+        newlines += counts[c];
     }
 
-    if (plyFormat == ASCII)
+    vector<size_t> starts(newlines + 1);
+    starts[0] = 0;
+    parallelable_for(0, chunks, ParallelIndexLines(body, size, chunk, &firsts, &starts));
+    /* The last line may have no newline */
+    if (starts.back() != size)
+        starts.push_back(size);
+    size_t lines = starts.size() - 1;
+
+    size_t line = 0;
+    for (size_t e = 0; e < mHeader.elements.size(); e++)
     {
-        for (int i = 0; i < vertex_number; i++)
+        const PlyElement &element = mHeader.elements[e];
+        if (lines - line < element.count)
         {
-            input.getline(line, sizeof(line) - 1);
-            Vector3dd vertex;
-            if (sscanf(line, "%lf %lf %lf", &(vertex.x()), &(vertex.y()), &(vertex.z())) != 3) {
-                SYNC_PRINT(("Corrupted vertex %d <%s>\n", i, line));
-                return 1;
+            SYNC_PRINT(("PLYReader: Element <%s> is truncated\n", element.name.c_str()));
+            return false;
+        }
+        Layout &layout = mLayouts[e];
+        layout.begin  = body;
+        layout.stride = 0;
+        layout.rowOffsets.assign(starts.begin() + line, starts.begin() + line + element.count + 1);
+        layout.end    = body + starts[line + element.count];
+        line += element.count;
+    }
+    return true;
+}
+
+uint64_t PLYReader::elementCount(const std::string &name) const
+{
+    int element = findElement(name);
+    return element < 0 ? 0 : mHeader.elements[element].count;
+}
+
+const uint8_t *PLYReader::elementData(int element, size_t *stride) const
+{
+    if (element < 0 || element >= (int)mLayouts.size() || mHeader.format == PlyHeader::ASCII || mLayouts[element].stride == 0)
+        return NULL;
+    if (stride != NULL)
+        *stride = mLayouts[element].stride;
+    return mLayouts[element].begin;
+}
+
+/**
+ *  Reads the scalar properties of the rows. The wanted array has the output index for every property
+ *  of the element or -1.
+ **/
+template<typename T>
+class ParallelReadProperties
+{
+    const PlyHeader *header;
+    const PlyElement *element;
+    const PLYReader::Layout *layout;
+    const vector<int> *wanted;
+    T * const *outputs;
+    atomic_int *errors;
+
+public:
+    void operator()( const BlockedRange<size_t>& r ) const
+    {
+        bool swap = (header->format == PlyHeader::BINARY_LITTLE_ENDIAN) != isHostLittleEndian();
+        const vector<PlyProperty> &properties = element->properties;
+
+        if (header->format == PlyHeader::ASCII)
+        {
+            for (size_t row = r.begin(); row < r.end(); row++)
+            {
+                const uint8_t *position = rowStart(*layout, row);
+                const uint8_t *end      = rowEnd  (*layout, row);
+                for (size_t p = 0; p < properties.size(); p++)
+                {
+                    double value = 0;
+                    if (!nextNumber(position, end, &value))
+                    {
+                        atomic_inc_and_fetch(errors);
+                        break;
+                    }
+                    if (properties[p].isList)
+                    {
+                        for (int i = 0; i < (int)value; i++)
+                        {
+                            double item;
+                            nextNumber(position, end, &item);
+                        }
+                        continue;
+                    }
+                    if ((*wanted)[p] >= 0)
+                        outputs[(*wanted)[p]][row] = (T)value;
+                }
             }
-            mesh.vertexes.push_back(vertex);
+            return;
         }
 
-        for (int i = 0; i < face_number; i++)
+        if (layout->stride != 0 && element->rowSize() != 0)
         {
-            input.getline(line, sizeof(line) - 1);
-            char *work = line;
-            while(*work == ' ' && *work != 0) work++;
-            int points;
-            if (sscanf(line, "%d", &points) != 1) {
-                SYNC_PRINT(("Corrupted face number %d\n", i));
-                return 1;
+            size_t offset = 0;
+            for (size_t p = 0; p < properties.size(); p++)
+            {
+                if ((*wanted)[p] >= 0)
+                    convertColumn<T>(layout->begin + r.begin() * layout->stride + offset, layout->stride, r.size(),
+                                     properties[p].type, swap, outputs[(*wanted)[p]] + r.begin());
+                offset += PlyProperty::typeSize(properties[p].type);
             }
-            if (points != 3) {
-                SYNC_PRINT(("We only support faces with 3 sides not %d\n", points));
-                continue;
+            return;
+        }
+
+        for (size_t row = r.begin(); row < r.end(); row++)
+        {
+            const uint8_t *position = rowStart(*layout, row);
+            for (size_t p = 0; p < properties.size(); p++)
+            {
+                const PlyProperty &property = properties[p];
+                if (property.isList)
+                {
+                    int64_t count = decodeValue<int64_t>(position, property.countType, swap);
+                    position += PlyProperty::typeSize(property.countType) + count * PlyProperty::typeSize(property.type);
+                    continue;
+                }
+                if ((*wanted)[p] >= 0)
+                    outputs[(*wanted)[p]][row] = decodeValue<T>(position, property.type, swap);
+                position += PlyProperty::typeSize(property.type);
             }
+        }
+    }
+
+    ParallelReadProperties(const PlyHeader *_header, const PlyElement *_element, const PLYReader::Layout *_layout,
+                           const vector<int> *_wanted, T * const *_outputs, atomic_int *_errors) :
+        header(_header), element(_element), layout(_layout), wanted(_wanted), outputs(_outputs), errors(_errors)
+    {}
+};
+
+template<typename T>
+bool PLYReader::readProperties(int element, const vector<std::string> &names, T * const *outputs) const
+{
+    if (element < 0 || element >= (int)mLayouts.size())
+        return false;
+
+    const PlyElement &plyElement = mHeader.elements[element];
+    vector<int> wanted(plyElement.properties.size(), -1);
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        int property = plyElement.findProperty(names[i]);
+        if (property < 0 || plyElement.properties[property].isList)
+        {
+            SYNC_PRINT(("PLYReader: No scalar property <%s> in <%s>\n", names[i].c_str(), plyElement.name.c_str()));
+            return false;
+        }
+        wanted[property] = (int)i;
+    }
+
+    atomic_int errors = 0;
+    parallelable_for((size_t)0, (size_t)plyElement.count, (size_t)4096,
+                     ParallelReadProperties<T>(&mHeader, &plyElement, &mLayouts[element], &wanted, outputs, &errors));
+    if (errors != 0)
+    {
+        SYNC_PRINT(("PLYReader: %d rows of <%s> are corrupted\n", errors, plyElement.name.c_str()));
+        return false;
+    }
+    return true;
+}
+
+template<typename T>
+bool PLYReader::readProperty(int element, const std::string &name, vector<T> &values) const
+{
+    if (element < 0 || element >= (int)mLayouts.size())
+        return false;
+
+    values.resize(mHeader.elements[element].count);
+    T *output = values.empty() ? NULL : &values[0];
+    vector<std::string> names(1, name);
+    return readProperties<T>(element, names, &output);
+}
+
+template bool PLYReader::readProperty<float>  (int element, const std::string &name, vector<float>   &values) const;
+template bool PLYReader::readProperty<double> (int element, const std::string &name, vector<double>  &values) const;
+template bool PLYReader::readProperty<int>    (int element, const std::string &name, vector<int>     &values) const;
+template bool PLYReader::readProperty<uint8_t>(int element, const std::string &name, vector<uint8_t> &values) const;
+
+template bool PLYReader::readProperties<float>  (int element, const vector<std::string> &names, float   * const *outputs) const;
+template bool PLYReader::readProperties<double> (int element, const vector<std::string> &names, double  * const *outputs) const;
+template bool PLYReader::readProperties<int>    (int element, const vector<std::string> &names, int     * const *outputs) const;
+template bool PLYReader::readProperties<uint8_t>(int element, const vector<std::string> &names, uint8_t * const *outputs) const;
 
-            while(*work != ' ' && *work != 0) work++;
-            Vector3d32 face;
+class ParallelReadTriangles
+{
+    const PlyHeader *header;
+    const PlyElement *element;
+    const PLYReader::Layout *layout;
+    int list;
+    int vertexes;
+    Vector3d32 *faces;
+    uint8_t *valid;
+    atomic_int *errors;
+
+public:
+    void operator()( const BlockedRange<size_t>& r ) const
+    {
+        bool ascii = (header->format == PlyHeader::ASCII);
+        bool swap  = (header->format == PlyHeader::BINARY_LITTLE_ENDIAN) != isHostLittleEndian();
+        const vector<PlyProperty> &properties = element->properties;
+        const PlyProperty &indexes = properties[list];
+        int indexSize = PlyProperty::typeSize(indexes.type);
+
+        for (size_t row = r.begin(); row < r.end(); row++)
+        {
+            const uint8_t *position = rowStart(*layout, row);
+            const uint8_t *end      = rowEnd  (*layout, row);
+            int64_t count = -1;
+            Vector3d32 face(0);
+
+            if (ascii)
+            {
+                double value = 0;
+                bool ok = true;
+                for (int p = 0; p < list && ok; p++)
+                {
+                    ok = nextNumber(position, end, &value);
+                    for (int i = 0; ok && properties[p].isList && i < (int)value; i++)
+                    {
+                        double item;
+                        ok = nextNumber(position, end, &item);
+                    }
+                }
+                if (ok && nextNumber(position, end, &value))
+                {
+                    count = (int64_t)value;
+                    for (int i = 0; i < 3 && count == 3; i++)
+                    {
+                        if (!nextNumber(position, end, &value))
+                            count = -1;
+                        face[i] = (int)value;
+                    }
+                }
+            }
+            else
+            {
+                for (int p = 0; p < list; p++)
+                {
+                    const PlyProperty &property = properties[p];
+                    if (property.isList)
+                    {
+                        int64_t skip = decodeValue<int64_t>(position, property.countType, swap);
+                        position += PlyProperty::typeSize(property.countType) + skip * PlyProperty::typeSize(property.type);
+                    }
+                    else
+                        position += PlyProperty::typeSize(property.type);
+                }
+                count = decodeValue<int64_t>(position, indexes.countType, swap);
+                position += PlyProperty::typeSize(indexes.countType);
+                for (int i = 0; i < 3 && count == 3; i++)
+                    face[i] = decodeValue<int>(position + i * indexSize, indexes.type, swap);
+            }
 
-            if (sscanf(work, "%d %d %d", &(face.x()), &(face.y()), &(face.z())) != 3) {
-                SYNC_PRINT(("Corrupted face number %d\n", i));
-                return 1;
+            if (count < 0)
+            {
+                atomic_inc_and_fetch(errors);
+                valid[row] = false;
+                continue;
             }
 
-            if (!face.isInCube(
-                    Vector3d32(                0,                 0,                0),
-                    Vector3d32(vertex_number - 1, vertex_number - 1, vertex_number - 1)))
+            valid[row] = (count == 3);
+            if (count == 3)
             {
-                SYNC_PRINT(("Vertex index is wrong on face %i\n", i));
-                return 1;
+                if (!face.isInCube(Vector3d32(0), Vector3d32(vertexes - 1)))
+                    atomic_inc_and_fetch(errors);
+                faces[row] = face;
             }
-            //printf("%d %d %d\n", face.x(), face.y(), face.z());
+        }
+    }
+
+    ParallelReadTriangles(const PlyHeader *_header, const PlyElement *_element, const PLYReader::Layout *_layout,
+                          int _list, int _vertexes, Vector3d32 *_faces, uint8_t *_valid, atomic_int *_errors) :
+        header(_header), element(_element), layout(_layout), list(_list), vertexes(_vertexes),
+        faces(_faces), valid(_valid), errors(_errors)
+    {}
+};
+
+bool PLYReader::readTriangles(vector<Vector3d32> &faces, int *skipped) const
+{
+    int element = findElement("face");
+    if (element < 0)
+    {
+        SYNC_PRINT(("PLYReader: There is no face element\n"));
+        return false;
+    }
+
+    const PlyElement &plyElement = mHeader.elements[element];
+    int list = plyElement.findProperty("vertex_indices");
+    if (list < 0)
+        list = plyElement.findProperty("vertex_index");
+    if (list < 0 || !plyElement.properties[list].isList)
+    {
+        SYNC_PRINT(("PLYReader: Face element has no vertex index list\n"));
+        return false;
+    }
+
+    size_t count = plyElement.count;
+    vector<Vector3d32> rows(count);
+    vector<uint8_t> valid(count);
+    atomic_int errors = 0;
+    if (count != 0)
+    {
+        parallelable_for((size_t)0, count, (size_t)4096,
+                         ParallelReadTriangles(&mHeader, &plyElement, &mLayouts[element], list, (int)elementCount("vertex"),
+                                               &rows[0], &valid[0], &errors));
+    }
+    if (errors != 0)
+    {
+        SYNC_PRINT(("PLYReader: %d faces are corrupted or have wrong vertex indexes\n", errors));
+        return false;
+    }
+
+    size_t before = faces.size();
+    for (size_t i = 0; i < count; i++)
+        if (valid[i])
+            faces.push_back(rows[i]);
+
+    if (skipped != NULL)
+        *skipped = (int)(count - (faces.size() - before));
+    return true;
+}
+
+bool PLYReader::readMesh(Mesh3D &mesh) const
+{
+    int element = findElement("vertex");
+    if (element < 0)
+    {
+        SYNC_PRINT(("PLYReader: There is no vertex element\n"));
+        return false;
+    }
+
+    size_t count = mHeader.elements[element].count;
+    vector<double> coords[3];
+    double *outputs[3];
+    for (int i = 0; i < 3; i++)
+    {
+        coords[i].resize(count);
+        outputs[i] = count == 0 ? NULL : &coords[i][0];
+    }
+    vector<std::string> names;
+    names.push_back("x");
+    names.push_back("y");
+    names.push_back("z");
+    if (!readProperties<double>(element, names, outputs))
+        return false;
+
+    vector<Vector3d32> faces;
+    int skipped = 0;
+    if (findElement("face") >= 0)
+    {
+        if (!readTriangles(faces, &skipped))
+            return false;
+        if (skipped != 0)
+            SYNC_PRINT(("PLYReader: %d faces that are not triangles are skipped\n", skipped));
+    }
+
+    int offset = (int)mesh.vertexes.size();
+    mesh.vertexes.reserve(mesh.vertexes.size() + count);
+    for (size_t i = 0; i < count; i++)
+        mesh.vertexes.push_back(Vector3dd(coords[0][i], coords[1][i], coords[2][i]));
+
+    mesh.faces.reserve(mesh.faces.size() + faces.size());
+    for (size_t i = 0; i < faces.size(); i++)
+        mesh.faces.push_back(faces[i] + Vector3d32(offset));
+    return true;
+}
+
+FloatCloud *PLYReader::readCloud() const
+{
+    int element = findElement("vertex");
+    if (element < 0)
+    {
+        SYNC_PRINT(("PLYReader: There is no vertex element\n"));
+        return NULL;
+    }
+
+    const PlyElement &vertex = mHeader.elements[element];
+    bool hasColor = vertex.findProperty("red") >= 0 && vertex.findProperty("green") >= 0 && vertex.findProperty("blue") >= 0;
+
+    FloatCloud *cloud = new FloatCloud(hasColor ? FloatCloud::COLOR : 0);
+    size_t count = vertex.count;
+    cloud->resize(count);
+    if (count == 0)
+        return cloud;
+
+    vector<std::string> names;
+    names.push_back("x");
+    names.push_back("y");
+    names.push_back("z");
+    float *coords[3] = { &cloud->x[0], &cloud->y[0], &cloud->z[0] };
+    if (!readProperties<float>(element, names, coords))
+    {
+        delete_safe(cloud);
+        return NULL;
+    }
 
-            mesh.faces.push_back(face);
+    if (hasColor)
+    {
+        vector<uint8_t> channels[3];
+        uint8_t *colors[3];
+        for (int i = 0; i < 3; i++)
+        {
+            channels[i].resize(count);
+            colors[i] = &channels[i][0];
+        }
+        names[0] = "red";
+        names[1] = "green";
+        names[2] = "blue";
+        if (!readProperties<uint8_t>(element, names, colors))
+        {
+            delete_safe(cloud);
+            return NULL;
         }
-    } else {
-        for (int i = 0; i < vertex_number; i++)
+        for (size_t i = 0; i < count; i++)
+            cloud->color[i] = RGBColor(channels[0][i], channels[1][i], channels[2][i]);
+    }
+    return cloud;
+}
+
+/* PLYWriter */
+
+PLYWriter::PLYWriter(std::ostream &out, PlyHeader::Format format) :
+    mOut(out),
+    mHeaderWritten(false),
+    mElement(0),
+    mRow(0),
+    mBuffer(1 << 20),
+    mUsed(0)
+{
+    mHeader.format = format;
+    mSwap = (format != PlyHeader::ASCII) && ((format == PlyHeader::BINARY_LITTLE_ENDIAN) != isHostLittleEndian());
+}
+
+PLYWriter::~PLYWriter()
+{
+    flush();
+}
+
+void PLYWriter::addComment(const std::string &comment)
+{
+    mHeader.comments.push_back(comment);
+}
+
+void PLYWriter::addElement(const std::string &name, uint64_t count)
+{
+    mHeader.elements.push_back(PlyElement(name, count));
+}
+
+void PLYWriter::addProperty(const std::string &name, PlyProperty::Type type)
+{
+    ASSERT_FALSE(mHeader.elements.empty(), "Property should belong to the element");
+    mHeader.elements.back().properties.push_back(PlyProperty(name, type));
+}
+
+void PLYWriter::addListProperty(const std::string &name, PlyProperty::Type countType, PlyProperty::Type type)
+{
+    ASSERT_FALSE(mHeader.elements.empty(), "Property should belong to the element");
+    PlyProperty property(name, type);
+    property.isList    = true;
+    property.countType = countType;
+    mHeader.elements.back().properties.push_back(property);
+}
+
+bool PLYWriter::writeHeader()
+{
+    mHeader.write(mOut);
+    mHeaderWritten = true;
+    mElement = 0;
+    mRow = 0;
+    nextRow();
+    return mOut.good();
+}
+
+/* Skips the elements that are already written */
+void PLYWriter::nextRow()
+{
+    while (mElement < mHeader.elements.size() && mRow >= mHeader.elements[mElement].count)
+    {
+        mElement++;
+        mRow = 0;
+    }
+}
+
+void PLYWriter::reserve(size_t size)
+{
+    if (mUsed + size > mBuffer.size())
+        flush();
+}
+
+void PLYWriter::flush()
+{
+    if (mUsed != 0)
+        mOut.write(&mBuffer[0], mUsed);
+    mUsed = 0;
+}
+
+void PLYWriter::putValue(double value, PlyProperty::Type type, bool last)
+{
+    if (mHeader.format == PlyHeader::ASCII)
+    {
+        reserve(40);
+        char *output = &mBuffer[mUsed];
+        int length;
+        if (type == PlyProperty::TYPE_FLOAT)
+            length = snprintf(output, 40, "%.9g", value);
+        else if (type == PlyProperty::TYPE_DOUBLE)
+            length = snprintf(output, 40, "%.17g", value);
+        else
+            length = snprintf(output, 40, "%lld", (long long)value);
+        output[length] = last ? '\n' : ' ';
+        mUsed += length + 1;
+        return;
+    }
+
+    reserve(8);
+    char *output = &mBuffer[mUsed];
+    int size = PlyProperty::typeSize(type);
+    switch (type)
+    {
+        case PlyProperty::TYPE_CHAR:   { int8_t   v = (int8_t  )value; memcpy(output, &v, size); break; }
+        case PlyProperty::TYPE_UCHAR:  { uint8_t  v = (uint8_t )value; memcpy(output, &v, size); break; }
+        case PlyProperty::TYPE_SHORT:  { int16_t  v = (int16_t )value; memcpy(output, &v, size); break; }
+        case PlyProperty::TYPE_USHORT: { uint16_t v = (uint16_t)value; memcpy(output, &v, size); break; }
+        case PlyProperty::TYPE_INT:    { int32_t  v = (int32_t )value; memcpy(output, &v, size); break; }
+        case PlyProperty::TYPE_UINT:   { uint32_t v = (uint32_t)value; memcpy(output, &v, size); break; }
+        case PlyProperty::TYPE_FLOAT:  { float    v = (float   )value; memcpy(output, &v, size); break; }
+        case PlyProperty::TYPE_DOUBLE: { double   v =           value; memcpy(output, &v, size); break; }
+        default:
+            return;
+    }
+    if (mSwap)
+        for (int i = 0; i < size / 2; i++)
+            std::swap(output[i], output[size - 1 - i]);
+    mUsed += size;
+}
+
+void PLYWriter::writeRow(const double *values)
+{
+    ASSERT_TRUE(mHeaderWritten && mElement < mHeader.elements.size(), "Row is outside of the declared elements");
+    const vector<PlyProperty> &properties = mHeader.elements[mElement].properties;
+    for (size_t p = 0; p < properties.size(); p++)
+        putValue(values[p], properties[p].type, p + 1 == properties.size());
+    mRow++;
+    nextRow();
+}
+
+void PLYWriter::writeListRow(int count, const int *values)
+{
+    ASSERT_TRUE(mHeaderWritten && mElement < mHeader.elements.size(), "Row is outside of the declared elements");
+    const PlyProperty &property = mHeader.elements[mElement].properties[0];
+    putValue(count, property.countType, count == 0);
+    for (int i = 0; i < count; i++)
+        putValue(values[i], property.type, i + 1 == count);
+    mRow++;
+    nextRow();
+}
+
+bool PLYWriter::finish()
+{
+    flush();
+    mOut.flush();
+    if (mElement != mHeader.elements.size())
+    {
+        SYNC_PRINT(("PLYWriter::finish(): Not all rows are written\n"));
+        return false;
+    }
+    return mOut.good();
+}
+
+bool PLYWriter::write(std::ostream &out, const Mesh3D &mesh, PlyHeader::Format format)
+{
+    PLYWriter writer(out, format);
+    writer.addElement("vertex", mesh.vertexes.size());
+    writer.addProperty("x", PlyProperty::TYPE_DOUBLE);
+    writer.addProperty("y", PlyProperty::TYPE_DOUBLE);
+    writer.addProperty("z", PlyProperty::TYPE_DOUBLE);
+    writer.addElement("face", mesh.faces.size());
+    writer.addListProperty("vertex_indices", PlyProperty::TYPE_UCHAR, PlyProperty::TYPE_INT);
+    if (!writer.writeHeader())
+        return false;
+
+    for (size_t i = 0; i < mesh.vertexes.size(); i++)
+    {
+        const Vector3dd &vertex = mesh.vertexes[i];
+        double values[3] = { vertex.x(), vertex.y(), vertex.z() };
+        writer.writeRow(values);
+    }
+    for (size_t i = 0; i < mesh.faces.size(); i++)
+    {
+        const Vector3d32 &face = mesh.faces[i];
+        int values[3] = { face.x(), face.y(), face.z() };
+        writer.writeListRow(3, values);
+    }
+    return writer.finish();
+}
+
+bool PLYWriter::write(std::ostream &out, const FloatCloud &cloud, PlyHeader::Format format)
+{
+    bool hasColor = cloud.hasChannel(FloatCloud::COLOR);
+
+    PLYWriter writer(out, format);
+    writer.addElement("vertex", cloud.size());
+    writer.addProperty("x", PlyProperty::TYPE_FLOAT);
+    writer.addProperty("y", PlyProperty::TYPE_FLOAT);
+    writer.addProperty("z", PlyProperty::TYPE_FLOAT);
+    if (hasColor)
+    {
+        writer.addProperty("red"  , PlyProperty::TYPE_UCHAR);
+        writer.addProperty("green", PlyProperty::TYPE_UCHAR);
+        writer.addProperty("blue" , PlyProperty::TYPE_UCHAR);
+    }
+    if (!writer.writeHeader())
+        return false;
+
+    for (size_t i = 0; i < cloud.size(); i++)
+    {
+        double values[6] = { cloud.x[i], cloud.y[i], cloud.z[i], 0, 0, 0 };
+        if (hasColor)
         {
-            float f;
-            Vector3dd vertex;
-            input.read((char *)&f, sizeof(f)); vertex.x() = f;
-            input.read((char *)&f, sizeof(f)); vertex.y() = f;
-            input.read((char *)&f, sizeof(f)); vertex.z() = f;
-            mesh.vertexes.push_back(vertex);
+            values[3] = cloud.color[i].r();
+            values[4] = cloud.color[i].g();
+            values[5] = cloud.color[i].b();
         }
+        writer.writeRow(values);
     }
+    return writer.finish();
+}
+
+/* PLYLoader */
 
+PLYLoader::PLYLoader()
+{
+}
+
+int PLYLoader::loadPLY(istream &input, Mesh3D &mesh)
+{
+    PLYReader reader;
+    if (!reader.open(input) || !reader.readMesh(mesh))
+        return 1;
     return 0;
 }
 
+int PLYLoader::loadPLY(const std::string &fileName, Mesh3D &mesh)
+{
+    PLYReader reader;
+    if (!reader.open(fileName) || !reader.readMesh(mesh))
+        return 1;
+    return 0;
+}
 
 PLYLoader::~PLYLoader()
 {
@@ -5,20 +5,252 @@
  * \date Nov 13, 2012
  **/
 
+#include <stdint.h>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "global.h"
 
 #include "mesh3d.h"
+#include "floatCloud.h"
+#include "mappedFile.h"
 
 
 using std::vector;
 
+/**
+ *  Scalar or list property of the PLY element
+ **/
+struct PlyProperty
+{
+    enum Type {
+        TYPE_CHAR,
+        TYPE_UCHAR,
+        TYPE_SHORT,
+        TYPE_USHORT,
+        TYPE_INT,
+        TYPE_UINT,
+        TYPE_FLOAT,
+        TYPE_DOUBLE,
+        TYPE_INVALID
+    };
+
+    std::string name;
+    Type        type;
+    bool        isList;
+    /** Type of the element count of the list property */
+    Type        countType;
+
+    PlyProperty(const std::string &_name = "", Type _type = TYPE_FLOAT) :
+        name(_name),
+        type(_type),
+        isList(false),
+        countType(TYPE_UCHAR)
+    {}
+
+    /** Binary size of the value, 0 for TYPE_INVALID */
+    static int typeSize(Type type);
+    static cchar *typeName(Type type);
+    /** Accepts both the old (float) and the sized (float32) names */
+    static Type typeByName(const char *name, size_t length);
+};
+
+struct PlyElement
+{
+    std::string         name;
+    uint64_t            count;
+    vector<PlyProperty> properties;
+
+    PlyElement(const std::string &_name = "", uint64_t _count = 0) :
+        name(_name),
+        count(_count)
+    {}
+
+    /** -1 if there is no such property */
+    int findProperty(const std::string &name) const;
+
+    /** Binary size of the row, 0 if the element has list properties and the rows differ in size */
+    size_t rowSize() const;
+    /** Binary size of the row with all the lists empty */
+    size_t minimalRowSize() const;
+};
+
+class PlyHeader
+{
+public:
+    enum Format {
+        ASCII,
+        BINARY_LITTLE_ENDIAN,
+        BINARY_BIG_ENDIAN
+    };
+
+    Format                   format;
+    vector<std::string>      comments;
+    vector<PlyElement>       elements;
+    /** Bytes taken by the header with the end_header line */
+    size_t                   size;
+
+    PlyHeader() :
+        format(ASCII),
+        size(0)
+    {}
+
+    /** Parses the header at the beginning of the data */
+    bool parse(const uint8_t *data, size_t dataSize);
+    void write(std::ostream &out) const;
+
+    /** -1 if there is no such element */
+    int findElement(const std::string &name) const;
+};
+
+/**
+ *  \brief PLY reader over the memory mapped file
+ *
+ *  The file is mapped and the header is parsed by open(), the data of the elements is read only by the
+ *  read*() calls and only for the requested properties.
+ *
+ *  For the binary files the rows of the scalar elements are the fixed size records, so the properties
+ *  are strided copies from the mapping, and elementData() gives the rows themselves with no copy at all.
+ *  The face lists usually have the same vertex number in all rows, then they are read in the same way;
+ *  the mixed lists are indexed once by the sequential pass.
+ *
+ *  For the ascii files the lines are indexed in parallel and the rows are parsed in parallel.
+ **/
+class PLYReader
+{
+public:
+    PLYReader();
+    ~PLYReader();
+
+    bool open(const std::string &fileName);
+    /** Reads the rest of the stream into the own buffer, the binary files need the binary mode stream */
+    bool open(std::istream &input);
+    /** The data is not copied and should outlive the reader */
+    bool open(const uint8_t *data, size_t size);
+    void close();
+
+    const PlyHeader &header() const
+    {
+        return mHeader;
+    }
+
+    int findElement(const std::string &name) const
+    {
+        return mHeader.findElement(name);
+    }
+
+    /** Number of rows of the element, 0 if there is no such element */
+    uint64_t elementCount(const std::string &name) const;
+
+    /**
+     *  Rows of the binary element stored with the fixed stride, in the file byte order.
+     *  NULL for the ascii files and for the lists with the different vertex numbers.
+     **/
+    const uint8_t *elementData(int element, size_t *stride) const;
+
+    /** Scalar property of all rows of the element converted to T (float, double, int or uint8_t) */
+    template<typename T>
+    bool readProperty(int element, const std::string &name, vector<T> &values) const;
+
+    /**
+     *  Several scalar properties in one pass over the rows, each ascii line is parsed once.
+     *  The outputs should have room for elementCount() values each.
+     **/
+    template<typename T>
+    bool readProperties(int element, const vector<std::string> &names, T * const *outputs) const;
+
+    /**
+     *  Triangles of the "face" element, the faces with the other number of vertices are skipped.
+     *  Fails if an index is outside of the vertex element.
+     **/
+    bool readTriangles(vector<Vector3d32> &faces, int *skipped = NULL) const;
+
+    /** Appends the vertices and the triangles to the mesh, the faces are optional */
+    bool readMesh(Mesh3D &mesh) const;
+
+    /**
+     *  The vertex element as the float cloud with the COLOR channel if the file has red, green and blue.
+     *  The other vertex properties (normals, confidence...) are available through readProperty().
+     *  Returns NULL on error.
+     **/
+    FloatCloud *readCloud() const;
+
+    struct Layout {
+        const uint8_t *begin;
+        const uint8_t *end;
+        /** Row size, 0 if the rows are found through rowOffsets */
+        size_t         stride;
+        /** Row starts relative to begin, with the end of the last row */
+        vector<size_t> rowOffsets;
+    };
+
+private:
+    MappedFile      mMapped;
+    vector<uint8_t> mBuffer;
+    const uint8_t  *mData;
+    size_t          mSize;
+    PlyHeader       mHeader;
+    vector<Layout>  mLayouts;
+
+    bool resolve();
+    bool resolveBinary();
+    bool resolveAscii();
+};
+
+/**
+ *  \brief Streaming PLY writer
+ *
+ *  The elements and the properties are declared first, then the rows are written one by one through
+ *  the internal buffer, so the large cloud does not need any intermediate Mesh3D or Cloud.
+ *  The number of rows should be known in advance, finish() checks that all of them are written.
+ **/
+class PLYWriter
+{
+public:
+    PLYWriter(std::ostream &out, PlyHeader::Format format = PlyHeader::BINARY_LITTLE_ENDIAN);
+    ~PLYWriter();
+
+    void addComment(const std::string &comment);
+    void addElement(const std::string &name, uint64_t count);
+    /** Adds the property to the last element */
+    void addProperty(const std::string &name, PlyProperty::Type type);
+    void addListProperty(const std::string &name, PlyProperty::Type countType, PlyProperty::Type type);
+
+    bool writeHeader();
+
+    /** Row of the scalar properties of the current element, the values in the declared order */
+    void writeRow(const double *values);
+    /** Row of the element that has one list property only */
+    void writeListRow(int count, const int *values);
+
+    /** Flushes the buffer and checks that all declared rows are written */
+    bool finish();
+
+    static bool write(std::ostream &out, const Mesh3D &mesh, PlyHeader::Format format = PlyHeader::BINARY_LITTLE_ENDIAN);
+    static bool write(std::ostream &out, const FloatCloud &cloud, PlyHeader::Format format = PlyHeader::BINARY_LITTLE_ENDIAN);
+
+private:
+    std::ostream &mOut;
+    PlyHeader     mHeader;
+    bool          mSwap;
+    bool          mHeaderWritten;
+    unsigned      mElement;
+    uint64_t      mRow;
+    vector<char>  mBuffer;
+    size_t        mUsed;
+
+    void nextRow();
+    void putValue(double value, PlyProperty::Type type, bool last);
+    void reserve(size_t size);
+    void flush();
+};
+
 class PLYLoader {
 public:
     PLYLoader();
     int loadPLY(istream &input, Mesh3D &mesh);
+    int loadPLY(const std::string &fileName, Mesh3D &mesh);
     virtual ~PLYLoader();
 };
 
@@ -0,0 +1,597 @@
+/**
+ * \file tiledBuffer.cpp
+ * \brief Tiled on-disk container of the buffers with the compressed tiles and the partial reads
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <string.h>
+
+#include "tiledBuffer.h"
+#include "atomicOps.h"
+#include "tbbWrapper.h"
+
+namespace corecvs {
+
+/* LZ compressor */
+
+static const int    LZ_MIN_MATCH  = 4;
+static const int    LZ_HASH_BITS  = 12;
+static const size_t LZ_MAX_OFFSET = 0xFFFF;
+/* The tail that is always stored as literals, so the matcher may read 4 bytes ahead */
+static const size_t LZ_TAIL       = 8;
+
+static inline uint32_t read32(const uint8_t *position)
+{
+    uint32_t value;
+    memcpy(&value, position, sizeof(value));
+    return value;
+}
+
+static inline uint32_t lzHash(uint32_t value)
+{
+    return (value * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+static inline void putLength(vector<uint8_t> &output, size_t length)
+{
+    while (length >= 0xFF)
+    {
+        output.push_back(0xFF);
+        length -= 0xFF;
+    }
+    output.push_back((uint8_t)length);
+}
+
+static inline bool getLength(const uint8_t *&input, const uint8_t *end, size_t &length)
+{
+    uint8_t byte;
+    do {
+        if (input >= end)
+            return false;
+        byte = *input++;
+        length += byte;
+    } while (byte == 0xFF);
+    return true;
+}
+
+/* Sequence of the literals and the match, the match length 0 marks the last sequence */
+static void putSequence(vector<uint8_t> &output, const uint8_t *literals, size_t literalLength, size_t offset, size_t matchLength)
+{
+    size_t matchCode = matchLength == 0 ? 0 : matchLength - LZ_MIN_MATCH;
+    output.push_back((uint8_t)((CORE_MIN(literalLength, (size_t)15) << 4) | CORE_MIN(matchCode, (size_t)15)));
+    if (literalLength >= 15)
+        putLength(output, literalLength - 15);
+    output.insert(output.end(), literals, literals + literalLength);
+    if (matchLength == 0)
+        return;
+
+    output.push_back((uint8_t)(offset & 0xFF));
+    output.push_back((uint8_t)(offset >> 8));
+    if (matchCode >= 15)
+        putLength(output, matchCode - 15);
+}
+
+void TiledBufferFormat::compressLZ(const uint8_t *input, size_t size, vector<uint8_t> &output)
+{
+    /* Positions are stored plus one, zero is the empty entry */
+    vector<uint32_t> table(1 << LZ_HASH_BITS, 0);
+    size_t anchor   = 0;
+    size_t position = 0;
+    size_t limit    = size > LZ_TAIL ? size - LZ_TAIL : 0;
+
+    while (position < limit)
+    {
+        uint32_t sequence = read32(input + position);
+        uint32_t hash = lzHash(sequence);
+        size_t candidate = table[hash];
+        table[hash] = (uint32_t)(position + 1);
+
+        if (candidate == 0 || position - (candidate - 1) > LZ_MAX_OFFSET || read32(input + candidate - 1) != sequence)
+        {
+            /* The incompressible data is skipped faster */
+            position += 1 + ((position - anchor) >> 6);
+            continue;
+        }
+
+        size_t match  = candidate - 1;
+        size_t length = LZ_MIN_MATCH;
+        while (position + length < limit && input[match + length] == input[position + length])
+            length++;
+
+        putSequence(output, input + anchor, position - anchor, position - match, length);
+        position += length;
+        anchor = position;
+    }
+    putSequence(output, input + anchor, size - anchor, 0, 0);
+}
+
+bool TiledBufferFormat::decompressLZ(const uint8_t *input, size_t size, uint8_t *output, size_t outputSize)
+{
+    const uint8_t *end       = input + size;
+    uint8_t       *position  = output;
+    uint8_t       *outputEnd = output + outputSize;
+
+    while (input < end)
+    {
+        uint8_t token = *input++;
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !getLength(input, end, literalLength))
+            return false;
+        if ((size_t)(end - input) < literalLength || (size_t)(outputEnd - position) < literalLength)
+            return false;
+        memcpy(position, input, literalLength);
+        input    += literalLength;
+        position += literalLength;
+
+        if (input == end)
+            return position == outputEnd;
+
+        if (end - input < 2)
+            return false;
+        size_t offset = input[0] | (input[1] << 8);
+        input += 2;
+        size_t matchLength = token & 0xF;
+        if (matchLength == 15 && !getLength(input, end, matchLength))
+            return false;
+        matchLength += LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > (size_t)(position - output) || (size_t)(outputEnd - position) < matchLength)
+            return false;
+        const uint8_t *match = position - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(position, match, matchLength);
+            position += matchLength;
+        }
+        else
+        {
+            /* Overlapped match repeats the last offset bytes */
+            for (size_t i = 0; i < matchLength; i++)
+                *position++ = *match++;
+        }
+    }
+    return false;
+}
+
+/* Tile codecs */
+
+/* Element bytes to the planes, each plane delta coded in the row order, the row start from the row above */
+static void shuffleDelta(const uint8_t *tile, int h, int w, int elementSize, uint8_t *planes)
+{
+    size_t count = (size_t)h * w;
+    for (int b = 0; b < elementSize; b++)
+    {
+        uint8_t *plane = planes + b * count;
+        for (size_t k = 0; k < count; k++)
+            plane[k] = tile[k * elementSize + b];
+        for (size_t k = count - 1; k > 0; k--)
+            plane[k] -= (k % w == 0) ? plane[k - w] : plane[k - 1];
+    }
+}
+
+static void unshuffleDelta(uint8_t *planes, int h, int w, int elementSize, uint8_t *tile)
+{
+    size_t count = (size_t)h * w;
+    for (int b = 0; b < elementSize; b++)
+    {
+        uint8_t *plane = planes + b * count;
+        for (size_t k = 1; k < count; k++)
+            plane[k] += (k % w == 0) ? plane[k - w] : plane[k - 1];
+        for (size_t k = 0; k < count; k++)
+            tile[k * elementSize + b] = plane[k];
+    }
+}
+
+TiledBufferFormat::Codec TiledBufferFormat::encodeTile(Codec codec, const uint8_t *tile, int h, int w, int elementSize, vector<uint8_t> &output)
+{
+    size_t size  = (size_t)h * w * elementSize;
+    size_t start = output.size();
+
+    if (codec == CODEC_LZ)
+    {
+        compressLZ(tile, size, output);
+    }
+    else if (codec == CODEC_DELTA_LZ)
+    {
+        vector<uint8_t> planes(size);
+        if (size != 0)
+            shuffleDelta(tile, h, w, elementSize, &planes[0]);
+        compressLZ(planes.empty() ? NULL : &planes[0], size, output);
+    }
+
+    if (codec != CODEC_NONE && output.size() - start < size)
+        return codec;
+
+    output.resize(start);
+    output.insert(output.end(), tile, tile + size);
+    return CODEC_NONE;
+}
+
+bool TiledBufferFormat::decodeTile(Codec codec, const uint8_t *input, size_t size, int h, int w, int elementSize, uint8_t *tile)
+{
+    size_t tileSize = (size_t)h * w * elementSize;
+    switch (codec)
+    {
+        case CODEC_NONE:
+            if (size != tileSize)
+                return false;
+            memcpy(tile, input, size);
+            return true;
+        case CODEC_LZ:
+            return decompressLZ(input, size, tile, tileSize);
+        case CODEC_DELTA_LZ:
+        {
+            vector<uint8_t> planes(tileSize);
+            if (planes.empty() || !decompressLZ(input, size, &planes[0], tileSize))
+                return false;
+            unshuffleDelta(&planes[0], h, w, elementSize, tile);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+/* Header */
+
+static const char   TILED_MAGIC[4]    = { 'C', 'V', 'S', 'T' };
+static const size_t TILED_HEADER_SIZE = 4 * 5;
+static const size_t TILED_LEVEL_SIZE  = 4 * 2;
+static const size_t TILED_ENTRY_SIZE  = 8 + 4 + 1;
+
+static void putU32(vector<uint8_t> &output, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        output.push_back((uint8_t)(value >> (8 * i)));
+}
+
+static void putU64(vector<uint8_t> &output, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+        output.push_back((uint8_t)(value >> (8 * i)));
+}
+
+static uint32_t getU32(const uint8_t *input)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= (uint32_t)input[i] << (8 * i);
+    return value;
+}
+
+static uint64_t getU64(const uint8_t *input)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++)
+        value |= (uint64_t)input[i] << (8 * i);
+    return value;
+}
+
+static inline int tilesFor(int size, int tileSize)
+{
+    return (size + tileSize - 1) / tileSize;
+}
+
+/* TiledBufferWriter */
+
+TiledBufferWriter::TiledBufferWriter(int elementSize, int tileSize, TiledBufferFormat::Codec codec) :
+    mElementSize(elementSize),
+    mTileSize(tileSize),
+    mCodec(codec),
+    mEncodedSize(0)
+{
+}
+
+void TiledBufferWriter::addLevel(const uint8_t *data, int h, int w, size_t lineBytes)
+{
+    Level level = { data, h, w, lineBytes };
+    mLevels.push_back(level);
+}
+
+/* Tile of the level to encode */
+struct TileJob {
+    int level;
+    int top;
+    int left;
+    int h;
+    int w;
+};
+
+/* Tile of the index to decode */
+struct TileRead {
+    size_t tile;
+    int top;
+    int left;
+    int h;
+    int w;
+};
+
+class ParallelEncodeTiles
+{
+    const vector<TiledBufferWriter::Level> *levels;
+    const vector<TileJob> *jobs;
+    int elementSize;
+    TiledBufferFormat::Codec codec;
+    vector<vector<uint8_t> > *blobs;
+    vector<uint8_t> *codecs;
+
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        vector<uint8_t> tile;
+        for (int t = r.begin(); t < r.end(); t++)
+        {
+            const TileJob &job = (*jobs)[t];
+            const TiledBufferWriter::Level &level = (*levels)[job.level];
+            size_t lineSize = (size_t)job.w * elementSize;
+            tile.resize(lineSize * job.h);
+            for (int i = 0; i < job.h; i++)
+                memcpy(&tile[i * lineSize], level.data + (job.top + i) * level.lineBytes + (size_t)job.left * elementSize, lineSize);
+            (*codecs)[t] = (uint8_t)TiledBufferFormat::encodeTile(codec, tile.empty() ? NULL : &tile[0], job.h, job.w, elementSize, (*blobs)[t]);
+        }
+    }
+
+    ParallelEncodeTiles(const vector<TiledBufferWriter::Level> *_levels, const vector<TileJob> *_jobs, int _elementSize,
+                        TiledBufferFormat::Codec _codec, vector<vector<uint8_t> > *_blobs, vector<uint8_t> *_codecs) :
+        levels(_levels), jobs(_jobs), elementSize(_elementSize), codec(_codec), blobs(_blobs), codecs(_codecs)
+    {}
+};
+
+bool TiledBufferWriter::write(std::ostream &out)
+{
+    vector<TileJob> jobs;
+    for (size_t l = 0; l < mLevels.size(); l++)
+    {
+        const Level &level = mLevels[l];
+        for (int top = 0; top < level.h; top += mTileSize)
+        {
+            for (int left = 0; left < level.w; left += mTileSize)
+            {
+                TileJob job = { (int)l, top, left, CORE_MIN(mTileSize, level.h - top), CORE_MIN(mTileSize, level.w - left) };
+                jobs.push_back(job);
+            }
+        }
+    }
+
+    vector<vector<uint8_t> > blobs(jobs.size());
+    vector<uint8_t> codecs(jobs.size());
+    parallelable_for(0, (int)jobs.size(), ParallelEncodeTiles(&mLevels, &jobs, mElementSize, mCodec, &blobs, &codecs));
+
+    vector<uint8_t> header;
+    header.insert(header.end(), TILED_MAGIC, TILED_MAGIC + sizeof(TILED_MAGIC));
+    putU32(header, TiledBufferFormat::VERSION);
+    putU32(header, mElementSize);
+    putU32(header, mTileSize);
+    putU32(header, (uint32_t)mLevels.size());
+    for (size_t l = 0; l < mLevels.size(); l++)
+    {
+        putU32(header, mLevels[l].h);
+        putU32(header, mLevels[l].w);
+    }
+
+    uint64_t offset = header.size() + jobs.size() * TILED_ENTRY_SIZE;
+    mEncodedSize = 0;
+    for (size_t t = 0; t < jobs.size(); t++)
+    {
+        putU64(header, offset);
+        putU32(header, (uint32_t)blobs[t].size());
+        header.push_back(codecs[t]);
+        offset       += blobs[t].size();
+        mEncodedSize += blobs[t].size();
+    }
+
+    out.write((const char *)&header[0], header.size());
+    for (size_t t = 0; t < blobs.size(); t++)
+        if (!blobs[t].empty())
+            out.write((const char *)&blobs[t][0], blobs[t].size());
+    return out.good();
+}
+
+/* TiledBufferReader */
+
+TiledBufferReader::TiledBufferReader() :
+    mData(NULL),
+    mSize(0),
+    mElementSize(0),
+    mTileSize(0),
+    mDecodedTiles(0)
+{
+}
+
+bool TiledBufferReader::open(const std::string &fileName)
+{
+    close();
+    if (!mMapped.open(fileName))
+    {
+        SYNC_PRINT(("TiledBufferReader::open(): Unable to map <%s>\n", fileName.c_str()));
+        return false;
+    }
+    mData = mMapped.data();
+    mSize = mMapped.size();
+    return parse();
+}
+
+bool TiledBufferReader::open(std::istream &input)
+{
+    close();
+    char chunk[1 << 16];
+    while (input.read(chunk, sizeof(chunk)) || input.gcount() > 0)
+        mBuffer.insert(mBuffer.end(), chunk, chunk + input.gcount());
+    mData = mBuffer.empty() ? NULL : &mBuffer[0];
+    mSize = mBuffer.size();
+    return parse();
+}
+
+bool TiledBufferReader::open(const uint8_t *data, size_t size)
+{
+    close();
+    mData = data;
+    mSize = size;
+    return parse();
+}
+
+void TiledBufferReader::close()
+{
+    mMapped.close();
+    mBuffer.clear();
+    mData = NULL;
+    mSize = 0;
+    mElementSize = 0;
+    mTileSize = 0;
+    mLevels.clear();
+    mTiles.clear();
+    mDecodedTiles = 0;
+}
+
+bool TiledBufferReader::parse()
+{
+    if (mData == NULL || mSize < TILED_HEADER_SIZE || memcmp(mData, TILED_MAGIC, sizeof(TILED_MAGIC)) != 0)
+    {
+        SYNC_PRINT(("TiledBufferReader: Not a tiled buffer file\n"));
+        return false;
+    }
+
+    uint32_t version     = getU32(mData + 4);
+    uint32_t elementSize = getU32(mData + 8);
+    uint32_t tileSize    = getU32(mData + 12);
+    uint32_t levels      = getU32(mData + 16);
+    if (version != TiledBufferFormat::VERSION || elementSize == 0 || tileSize == 0 ||
+        elementSize > 0xFFFF || tileSize > 0xFFFF || levels > (mSize - TILED_HEADER_SIZE) / TILED_LEVEL_SIZE)
+    {
+        SYNC_PRINT(("TiledBufferReader: Header is not supported or corrupted\n"));
+        return false;
+    }
+    mElementSize = elementSize;
+    mTileSize    = tileSize;
+
+    const uint8_t *position = mData + TILED_HEADER_SIZE;
+    size_t tiles = 0;
+    for (uint32_t l = 0; l < levels; l++, position += TILED_LEVEL_SIZE)
+    {
+        Level level;
+        level.h = getU32(position);
+        level.w = getU32(position + 4);
+        if (level.h < 0 || level.w < 0)
+            return false;
+        level.tilesH    = tilesFor(level.h, mTileSize);
+        level.tilesW    = tilesFor(level.w, mTileSize);
+        level.firstTile = tiles;
+        tiles += (size_t)level.tilesH * level.tilesW;
+        mLevels.push_back(level);
+    }
+
+    if ((size_t)(mData + mSize - position) / TILED_ENTRY_SIZE < tiles)
+    {
+        SYNC_PRINT(("TiledBufferReader: Index is truncated\n"));
+        return false;
+    }
+
+    mTiles.resize(tiles);
+    for (size_t t = 0; t < tiles; t++, position += TILED_ENTRY_SIZE)
+    {
+        TiledBufferFormat::TileEntry &entry = mTiles[t];
+        entry.offset = getU64(position);
+        entry.size   = getU32(position + 8);
+        entry.codec  = position[12];
+        if (entry.offset > mSize || entry.size > mSize - entry.offset)
+        {
+            SYNC_PRINT(("TiledBufferReader: Tile %d is outside of the file\n", (int)t));
+            return false;
+        }
+    }
+    return true;
+}
+
+class ParallelDecodeTiles
+{
+    const uint8_t *data;
+    const vector<TiledBufferFormat::TileEntry> *entries;
+    const vector<TileRead> *jobs;
+    int elementSize;
+    int top;
+    int left;
+    int h;
+    int w;
+    uint8_t *output;
+    size_t lineBytes;
+    atomic_int *errors;
+
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        vector<uint8_t> tile;
+        for (int t = r.begin(); t < r.end(); t++)
+        {
+            const TileRead &job = (*jobs)[t];
+            const TiledBufferFormat::TileEntry &entry = (*entries)[job.tile];
+            tile.resize((size_t)job.h * job.w * elementSize);
+            if (!TiledBufferFormat::decodeTile((TiledBufferFormat::Codec)entry.codec, data + entry.offset, entry.size,
+                                               job.h, job.w, elementSize, tile.empty() ? NULL : &tile[0]))
+            {
+                atomic_inc_and_fetch(errors);
+                continue;
+            }
+
+            int rowStart = CORE_MAX(top , job.top);
+            int rowEnd   = CORE_MIN(top + h, job.top + job.h);
+            int colStart = CORE_MAX(left, job.left);
+            int colEnd   = CORE_MIN(left + w, job.left + job.w);
+            size_t length = (size_t)(colEnd - colStart) * elementSize;
+            for (int i = rowStart; i < rowEnd; i++)
+            {
+                memcpy(output + (size_t)(i - top) * lineBytes + (size_t)(colStart - left) * elementSize,
+                       &tile[((size_t)(i - job.top) * job.w + (colStart - job.left)) * elementSize], length);
+            }
+        }
+    }
+
+    ParallelDecodeTiles(const uint8_t *_data, const vector<TiledBufferFormat::TileEntry> *_entries, const vector<TileRead> *_jobs,
+                        int _elementSize, int _top, int _left, int _h, int _w, uint8_t *_output, size_t _lineBytes,
+                        atomic_int *_errors) :
+        data(_data), entries(_entries), jobs(_jobs), elementSize(_elementSize),
+        top(_top), left(_left), h(_h), w(_w), output(_output), lineBytes(_lineBytes), errors(_errors)
+    {}
+};
+
+bool TiledBufferReader::readRect(int level, int top, int left, int h, int w, uint8_t *output, size_t lineBytes)
+{
+    if (level < 0 || level >= levels())
+        return false;
+    const Level &info = mLevels[level];
+    if (top < 0 || left < 0 || h < 0 || w < 0 || top + h > info.h || left + w > info.w)
+    {
+        SYNC_PRINT(("TiledBufferReader::readRect(): Rectangle is outside of the level\n"));
+        return false;
+    }
+    if (h == 0 || w == 0)
+        return true;
+
+    vector<TileRead> jobs;
+    for (int ty = top / mTileSize; ty <= (top + h - 1) / mTileSize; ty++)
+    {
+        for (int tx = left / mTileSize; tx <= (left + w - 1) / mTileSize; tx++)
+        {
+            int tileTop  = ty * mTileSize;
+            int tileLeft = tx * mTileSize;
+            TileRead job = { info.firstTile + (size_t)ty * info.tilesW + tx, tileTop, tileLeft,
+                            CORE_MIN(mTileSize, info.h - tileTop), CORE_MIN(mTileSize, info.w - tileLeft) };
+            jobs.push_back(job);
+        }
+    }
+
+    atomic_int errors = 0;
+    parallelable_for(0, (int)jobs.size(),
+                     ParallelDecodeTiles(mData, &mTiles, &jobs, mElementSize, top, left, h, w, output, lineBytes, &errors));
+    mDecodedTiles += jobs.size();
+    if (errors != 0)
+    {
+        SYNC_PRINT(("TiledBufferReader::readRect(): %d tiles are corrupted\n", errors));
+        return false;
+    }
+    return true;
+}
+
+} /* namespace corecvs */
+
+/* EOF */
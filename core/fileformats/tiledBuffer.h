@@ -0,0 +1,230 @@
+#pragma once
+/**
+ * \file tiledBuffer.h
+ * \brief Tiled on-disk container of the buffers with the compressed tiles and the partial reads
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "global.h"
+
+#include "mappedFile.h"
+
+namespace corecvs {
+
+using std::vector;
+
+/**
+ *  File layout, all the numbers are little endian:
+ *
+ *  \code
+ *    "CVST" version elementSize tileSize levels
+ *    levels  x { h w }
+ *    tiles   x { offset:u64 size:u32 codec:u8 }      - level by level, row major tiles
+ *    tile data
+ *  \endcode
+ *
+ *  The elements are stored in the byte order of the machine, like AbstractBuffer::dump() does.
+ *  The border tiles are cut by the level size.
+ **/
+class TiledBufferFormat
+{
+public:
+    enum Codec {
+        /** Raw element bytes */
+        CODEC_NONE,
+        /** LZ77 byte compressor with the LZ4 style sequences */
+        CODEC_LZ,
+        /** Bytes of the elements split into the planes and delta coded along the rows, then LZ */
+        CODEC_DELTA_LZ
+    };
+
+    static const uint32_t VERSION = 1;
+
+    struct TileEntry {
+        uint64_t offset;
+        uint32_t size;
+        uint8_t  codec;
+    };
+
+    /** Appends the compressed data to the output */
+    static void compressLZ(const uint8_t *input, size_t size, vector<uint8_t> &output);
+    /** Fails if the data is corrupted or does not decompress to exactly outputSize bytes */
+    static bool decompressLZ(const uint8_t *input, size_t size, uint8_t *output, size_t outputSize);
+
+    /**
+     *  Encodes the tile of h x w elements stored without the gaps. If the codec does not make the tile
+     *  smaller, the tile is stored raw.
+     *  \return the codec that was actually used
+     **/
+    static Codec encodeTile(Codec codec, const uint8_t *tile, int h, int w, int elementSize, vector<uint8_t> &output);
+    static bool  decodeTile(Codec codec, const uint8_t *input, size_t size, int h, int w, int elementSize, uint8_t *tile);
+};
+
+/**
+ *  \brief Writer of the tiled buffer file
+ *
+ *  The levels are the buffers of the same element type, usually the pyramid of the image, but any
+ *  sizes are allowed. The tiles of all levels are extracted and encoded in parallel, then written with
+ *  the index in one sequential pass, so the stream does not have to be seekable.
+ **/
+class TiledBufferWriter
+{
+public:
+    TiledBufferWriter(int elementSize, int tileSize = 64, TiledBufferFormat::Codec codec = TiledBufferFormat::CODEC_DELTA_LZ);
+
+    /** The data is not copied and should live until write() */
+    void addLevel(const uint8_t *data, int h, int w, size_t lineBytes);
+
+    template<class BufferType>
+    void addLevel(const BufferType *buffer)
+    {
+        ASSERT_TRUE_S(sizeof(*buffer->data) == (size_t)mElementSize);
+        addLevel((const uint8_t *)buffer->data, buffer->h, buffer->w, buffer->stride * sizeof(*buffer->data));
+    }
+
+    bool write(std::ostream &out);
+
+    /** Bytes of the encoded tiles of the last write() */
+    uint64_t encodedSize() const
+    {
+        return mEncodedSize;
+    }
+
+    /**
+     *  Level for the pyramid, every second element of every second row.
+     *  The values are not filtered or rescaled, so this works for any element type.
+     **/
+    template<class BufferType>
+    static BufferType *subsample(const BufferType *buffer)
+    {
+        BufferType *result = new BufferType((buffer->h + 1) / 2, (buffer->w + 1) / 2);
+        for (int i = 0; i < result->h; i++)
+            for (int j = 0; j < result->w; j++)
+                result->element(i, j) = buffer->element(2 * i, 2 * j);
+        return result;
+    }
+
+    struct Level {
+        const uint8_t *data;
+        int            h;
+        int            w;
+        size_t         lineBytes;
+    };
+
+private:
+    int                      mElementSize;
+    int                      mTileSize;
+    TiledBufferFormat::Codec mCodec;
+    vector<Level>            mLevels;
+    uint64_t                 mEncodedSize;
+};
+
+/**
+ *  \brief Reader of the tiled buffer file
+ *
+ *  The file is memory mapped and only the index is parsed by open(). The reads of the rectangle decode
+ *  only the tiles it crosses, in parallel, straight into the result.
+ **/
+class TiledBufferReader
+{
+public:
+    TiledBufferReader();
+
+    bool open(const std::string &fileName);
+    /** Reads the whole stream into the own buffer */
+    bool open(std::istream &input);
+    /** The data is not copied and should outlive the reader */
+    bool open(const uint8_t *data, size_t size);
+    void close();
+
+    int elementSize() const
+    {
+        return mElementSize;
+    }
+
+    int tileSize() const
+    {
+        return mTileSize;
+    }
+
+    int levels() const
+    {
+        return (int)mLevels.size();
+    }
+
+    int levelH(int level) const
+    {
+        return mLevels[level].h;
+    }
+
+    int levelW(int level) const
+    {
+        return mLevels[level].w;
+    }
+
+    /** Number of the tiles decoded by the reads so far */
+    uint64_t decodedTiles() const
+    {
+        return mDecodedTiles;
+    }
+
+    /**
+     *  Decodes the rectangle of the level into the output with the given line size in bytes.
+     *  The rectangle should be inside of the level.
+     **/
+    bool readRect(int level, int top, int left, int h, int w, uint8_t *output, size_t lineBytes);
+
+    /** The rectangle as the new buffer, NULL on error or if the element size differs */
+    template<class BufferType>
+    BufferType *read(int level, int top, int left, int h, int w)
+    {
+        /* The element type is taken from the data, the punched buffers have the ambiguous typedefs */
+        if (sizeof(*((BufferType *)NULL)->data) != (size_t)mElementSize || h <= 0 || w <= 0)
+            return NULL;
+        BufferType *result = new BufferType(h, w);
+        if (!readRect(level, top, left, h, w, (uint8_t *)result->data, result->stride * sizeof(*result->data)))
+            delete_safe(result);
+        return result;
+    }
+
+    template<class BufferType>
+    BufferType *read(int level = 0)
+    {
+        if (level < 0 || level >= levels())
+            return NULL;
+        return read<BufferType>(level, 0, 0, levelH(level), levelW(level));
+    }
+
+    struct Level {
+        int h;
+        int w;
+        int tilesH;
+        int tilesW;
+        /** Index of the first tile of the level in mTiles */
+        size_t firstTile;
+    };
+
+private:
+    MappedFile      mMapped;
+    vector<uint8_t> mBuffer;
+    const uint8_t  *mData;
+    size_t          mSize;
+
+    int mElementSize;
+    int mTileSize;
+    vector<Level>                         mLevels;
+    vector<TiledBufferFormat::TileEntry>  mTiles;
+    uint64_t mDecodedTiles;
+
+    bool parse();
+};
+
+} /* namespace corecvs */
+
+/* EOF */
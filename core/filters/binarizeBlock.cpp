@@ -19,7 +19,7 @@ int BinarizeBlock::operator()()
     G12Buffer* &result = static_cast<G12Pin*>(outputPins[0])->getData();
 
     if (input == NULL)  return 0;
-    result = new G12Buffer(input->getSize());
+    result = newOutputBuffer(input);
 
     for (int h = 0; h < input->h; h++ )
     {
@@ -32,6 +32,12 @@ int BinarizeBlock::operator()()
     return 0;
 }
 
+void BinarizeBlock::getPointwiseTable(uint16_t *table)
+{
+    for (int i = 0; i < POINTWISE_TABLE_SIZE; i++)
+        table[i] = i > mBinarizeParameters.threshold() ? G12Buffer::BUFFER_MAX_VALUE : 0;
+}
+
 XMLNode* BinarizeBlock::serialize(XMLNode* node)
 {
     XMLNode* mBlock = FilterBlock::serialize(node);
@@ -50,6 +56,7 @@ void BinarizeBlock::deserialize(XMLNode* node, bool force)
 
     DeserializerVisitor visitor(p);
     mBinarizeParameters.accept(visitor);
+    parametersChanged();
 }
 
 
@@ -38,9 +38,13 @@ public:
     virtual bool setParameters(const void * newParameters)
     {
         mBinarizeParameters = *(BinarizeParameters *)newParameters;
+        parametersChanged();
         return true;
     }
 
+    virtual PointwiseKind pointwiseKind() const { return POINTWISE_MAP; }
+    virtual void getPointwiseTable(uint16_t *table);
+
     virtual void *getParameters()
     {
         return (void*)&mBinarizeParameters;
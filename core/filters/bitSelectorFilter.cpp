@@ -21,15 +21,8 @@ BitSelectorFilter::~BitSelectorFilter()
     // TODO Auto-generated destructor stub
 }
 
-int BitSelectorFilter::operator()()
+uint16_t BitSelectorFilter::getMask() const
 {
-//    printf("BitSelectorFilter::operator() called\n");
-    G12Buffer* &input  = static_cast<G12Pin*>(inputPins[0])->getData();
-    G12Buffer* &result = static_cast<G12Pin*>(outputPins[0])->getData();
-
-    if (input == NULL)
-        return 0;
-
     uint16_t mask = 0x0;
     if (mBitSelectorParameters.bit0 ()) mask |= 0x0001;
     if (mBitSelectorParameters.bit1 ()) mask |= 0x0002;
@@ -51,13 +44,34 @@ int BitSelectorFilter::operator()()
     if (mBitSelectorParameters.bit14()) mask |= 0x4000;
     if (mBitSelectorParameters.bit15()) mask |= 0x8000;
 
+    return mask;
+}
+
+int BitSelectorFilter::operator()()
+{
+//    printf("BitSelectorFilter::operator() called\n");
+    G12Buffer* &input  = static_cast<G12Pin*>(inputPins[0])->getData();
+    G12Buffer* &result = static_cast<G12Pin*>(outputPins[0])->getData();
+
+    if (input == NULL)
+        return 0;
+
+    uint16_t mask = getMask();
     int shift = mBitSelectorParameters.shift();
-    result = new G12Buffer(input);
+    result = newOutputBuffer(input);
+    result->fillWith(*input);
     ShiftMaskMapper smm(mask, shift);
     result->mapOperationElementwize<ShiftMaskMapper>(smm);
     return 0;
 }
 
+void BitSelectorFilter::getPointwiseTable(uint16_t *table)
+{
+    ShiftMaskMapper smm(getMask(), mBitSelectorParameters.shift());
+    for (int i = 0; i < POINTWISE_TABLE_SIZE; i++)
+        table[i] = smm((uint16_t)i);
+}
+
 XMLNode* BitSelectorFilter::serialize(XMLNode* node)
 {
     XMLNode* mBlock = FilterBlock::serialize(node);
@@ -76,6 +90,7 @@ void BitSelectorFilter::deserialize(XMLNode* node, bool force)
 
     DeserializerVisitor visitor(p);
     mBitSelectorParameters.accept(visitor);
+    parametersChanged();
 }
 
 } /* namespace corecvs */
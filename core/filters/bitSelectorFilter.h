@@ -45,6 +45,7 @@ public:
     virtual bool setParameters(const void *newParameters)
     {
         mBitSelectorParameters = *(BitSelectorParameters *)newParameters;
+        parametersChanged();
         return true;
     }
     virtual void *getParameters()
@@ -52,12 +53,17 @@ public:
         return (void*)&mBitSelectorParameters;
     }
 
+    virtual PointwiseKind pointwiseKind() const { return POINTWISE_MAP; }
+    virtual void getPointwiseTable(uint16_t *table);
+
     virtual XMLNode* serialize(XMLNode* node);
     virtual void deserialize(XMLNode*, bool = true);
 
     virtual ~BitSelectorFilter();
 
 private:
+    uint16_t getMask() const;
+
     G12Buffer *input;
     G12Buffer *result;
 
@@ -5,7 +5,7 @@
  **/
 
 #include "filterBlock.h"
-//#include "filterGraph.h"
+#include "filterGraph.h"
 #include "serializerVisitor.h"
 
 namespace corecvs
@@ -17,6 +17,7 @@ FilterBlock::FilterBlock(/*FilterGraph* _parent,*/ int id) :
     parent(NULL),
     instanceId(id),
     inLinks(0),
+    parametersVersion(0),
     sort(PROCESSING_FILTER),
     instanceName(NULL)
 {
@@ -106,6 +107,13 @@ void FilterBlock::deserializePins(vector<Pin*> &vec, XMLNode* node, bool force)
     }
 }
 
+G12Buffer *FilterBlock::newOutputBuffer(int h, int w)
+{
+    if (parent != NULL)
+        return parent->pool.acquire(h, w);
+    return new G12Buffer(h, w, false);
+}
+
 void FilterBlock::clear()
 {
     for (unsigned int i = 0; i < outputPins.size(); i++)
@@ -34,6 +34,22 @@ public:
         COMPOUND_FILTER
     };
 
+    /**
+     *  Pointwise blocks compute each output pixel only from the same pixel of the inputs,
+     *  so FilterGraphPlan could fuse chains of them into one pass over the frame.
+     *
+     *  POINTWISE_MAP  - one input, output = table[input], see getPointwiseTable()
+     *  POINTWISE_MASK - two inputs, output = (input1 != 0) ? input0 : 0
+     **/
+    enum PointwiseKind
+    {   NOT_POINTWISE,
+        POINTWISE_MAP,
+        POINTWISE_MASK
+    };
+
+    /** Size of the table that getPointwiseTable() fills - all the 16-bit values */
+    static const int POINTWISE_TABLE_SIZE = 0x10000;
+
     FilterBlock(/*FilterGraph* _parent,*/ int id = -1);
 
     virtual void setInstanceName(char* name)
@@ -89,6 +105,34 @@ public:
         return false;
     }
 
+    virtual PointwiseKind pointwiseKind() const { return NOT_POINTWISE; }
+
+    /**
+     * For POINTWISE_MAP blocks fills the table of POINTWISE_TABLE_SIZE elements
+     * with the block outputs for every input value
+     **/
+    virtual void getPointwiseTable(uint16_t * /*table*/) {}
+
+    /**
+     * Neighbourhood blocks that compute the output row i only from the input rows i - halo .. i + halo
+     * return the halo, so FilterGraphPlan could run them by horizontal stripes together with the
+     * pointwise chain that feeds them. -1 means that the block needs the whole frame.
+     **/
+    virtual int stripeHalo() const { return -1; }
+
+    /**
+     * For the blocks with stripeHalo() >= 0 computes the rows y1 .. y2 - 1 of the result, which is
+     * the whole output frame. The input row k is the frame row inputY + k, the input has at least
+     * the halo rows around the stripe that are inside the frame. Stripes could be computed concurrently.
+     **/
+    virtual void processRows(G12Buffer * /*input*/, int /*inputY*/, G12Buffer * /*result*/, int /*y1*/, int /*y2*/) {}
+
+    /**
+     * Blocks should call this when their parameters are changed, so the compiled
+     * execution plans that depend on the parameters are rebuilt
+     **/
+    void parametersChanged() { parametersVersion++; }
+
     virtual void* getParameters()
     {
         printf("Getting parameters\n");
@@ -126,6 +170,17 @@ public:
     virtual XMLNode* serialize(XMLNode*);
     virtual void deserialize(XMLNode*, bool force = true);
 
+    /**
+     * Allocates the buffer for the output pin. The content is undefined.
+     * If the block is a part of a graph, the buffer is recycled from the graph pool.
+     **/
+    G12Buffer *newOutputBuffer(int h, int w);
+
+    G12Buffer *newOutputBuffer(const G12Buffer *likeThis)
+    {
+        return newOutputBuffer(likeThis->h, likeThis->w);
+    }
+
     virtual void clear();
     virtual ~FilterBlock();
 
@@ -139,6 +194,7 @@ public:
     FilterGraph* parent;
     int instanceId;
     int inLinks;
+    unsigned parametersVersion;
     SortOfBlock sort;
     vector<Pin*> inputPins;
     vector<Pin*> outputPins;
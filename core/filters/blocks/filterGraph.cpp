@@ -1,5 +1,6 @@
 #include "filterGraph.h"
 #include "compoundFilter.h"
+#include "zoneTracer.h"
 
 namespace corecvs
 {
@@ -13,6 +14,7 @@ FilterGraph::~FilterGraph()
     blocks.clear();
     inputs.clear();
     outputs.clear();
+    delete_safe(plan);
 } // ~FilterGraph
 
 void FilterGraph::clear()
@@ -23,6 +25,8 @@ void FilterGraph::clear()
     blocks.clear();
     inputs.clear();
     outputs.clear();
+    levelStarts.clear();
+    delete_safe(plan);
 } // clear()
 
 //void FilterGraph::addIOPins()
@@ -98,7 +102,11 @@ void FilterGraph::removeConnections(Pin* pin)
               blocks[i]->inputPins[j]->takeFrom = NULL;
 }
 
-/* This is totally uneffective, please fix */
+/**
+ *  Blocks are sorted wave by wave: first all the blocks that have no incoming links,
+ *  then all the blocks that depend only on them and so on. Each wave is a dependency level,
+ *  the blocks inside one level do not depend on each other and could be executed concurrently.
+ **/
 bool FilterGraph::topologicSort()
 {
     /* Count inputs to blocks */
@@ -111,55 +119,173 @@ bool FilterGraph::topologicSort()
     }
 
     vector<FilterBlock*> result;
-    while(true)
-    {   /* Find Blocks with no links */
-        vector<FilterBlock *>::iterator itBlocks;
-        for (itBlocks = blocks.begin(); itBlocks != blocks.end(); ++itBlocks)
-            if ((*itBlocks)->inLinks == 0)  break;
+    vector<FilterBlock*> remaining = blocks;
+    vector<unsigned>     starts;
+    result.reserve(blocks.size());
 
-        if (itBlocks == blocks.end()) /* No objects found */
+    while (!remaining.empty())
+    {
+        /* Find Blocks with no links */
+        unsigned levelStart = (unsigned)result.size();
+        vector<FilterBlock*> rest;
+        for (unsigned int i = 0; i < remaining.size(); i++)
+        {
+            if (remaining[i]->inLinks == 0)
+                result.push_back(remaining[i]);
+            else
+                rest.push_back(remaining[i]);
+        }
+
+        if (result.size() == levelStart) /* No objects found, there is a loop */
+        {
+            levelStarts.clear();
             return false;
+        }
+        starts.push_back(levelStart);
 
-        result.push_back(*itBlocks);
+        /* Remove links that go out of the current level */
+        for (unsigned int i = 0; i < rest.size(); i++)
+           for (unsigned int j = 0; j < rest[i]->inputPins.size(); j++)
+           {
+               Pin *from = rest[i]->inputPins[j]->takeFrom;
+               if (from == NULL || rest[i]->isOuterPin(rest[i]->inputPins[j]))
+                   continue;
 
-        /* Count inputs to blocks */
-        for (unsigned int i = 0; i < blocks.size(); i++)
-           for (unsigned int j = 0; j < blocks[i]->inputPins.size(); j++)
-               if (blocks[i]->inputPins[j]->takeFrom != NULL &&
-                   blocks[i]->inputPins[j]->takeFrom->parent == *itBlocks)
+               for (unsigned int k = levelStart; k < result.size(); k++)
                {
-                   blocks[i]->inLinks--;
+                   if (from->parent == result[k])
+                   {
+                       rest[i]->inLinks--;
+                       break;
+                   }
                }
+           }
 
-        blocks.erase(itBlocks);
-        if (blocks.size() == 0)  break;
-    } // while(true)
+        remaining.swap(rest);
+    } // while
+
+    starts.push_back((unsigned)result.size());
     blocks = result;
+    levelStarts = starts;
     return true;
 } // topologicSort
 
+void FilterGraph::executeBlock(FilterBlock *block, uint64_t *time)
+{
+    TRACE_ZONE("FilterGraph::executeBlock");
+    for (unsigned int j = 0; j < block->inputPins.size(); j++)
+    {
+        block->inputPins[j]->setPin(block->inputPins[j]->takeFrom);
+    }
+
+    PreciseTimer blockExecutionTime = PreciseTimer::currentTime();
+    block->operator ()();
+    *time = blockExecutionTime.usecsToNow();
+}
+
+/**
+ *  Returns the outputs of the block to the pool. Data that was passed further by views
+ *  stays alive in that views.
+ **/
+void FilterGraph::recycleOutputs(FilterBlock *block)
+{
+    for (unsigned int i = 0; i < block->outputPins.size(); i++)
+    {
+        G12Pin *pin = dynamic_cast<G12Pin *>(block->outputPins[i]);
+        if (pin == NULL)
+        {
+            block->outputPins[i]->clear();
+            continue;
+        }
+        pool.release(pin->getData());
+        pin->getData() = NULL;
+    }
+}
+
+class ParallelLevelExecutor
+{
+public:
+    FilterGraph *graph;
+    FilterBlock **blocks;
+    uint64_t    *times;
+
+    ParallelLevelExecutor(FilterGraph *_graph, FilterBlock **_blocks, uint64_t *_times) :
+        graph(_graph),
+        blocks(_blocks),
+        times(_times)
+    {}
+
+    void operator()(const BlockedRange<int> &r) const;
+};
+
 void FilterGraph::execute()
 {
-    /* Ok, we expect graph to be topologically sorted*/
-    for (unsigned int i = 0; i < blocks.size(); i++)
+    if (fusePointwise)
     {
-        FilterBlock *block = blocks[i];
-        for (unsigned int j = 0; j < block->inputPins.size(); j++)
+        if (plan == NULL)
+            plan = new FilterGraphPlan(this);
+        if (plan->isValid() || plan->compile())
         {
-            block->inputPins[j]->setPin(block->inputPins[j]->takeFrom);
+            plan->execute();
+            finishExecution();
+            return;
         }
+    }
 
-        PreciseTimer blockExecutionTime = PreciseTimer::currentTime();
-        block->operator ()();
-        if (stats != NULL) {
-            stats->setTime(block->getFullName(), blockExecutionTime.usecsToNow());
+    /* Ok, we expect graph to be topologically sorted*/
+    bool parallel = parallelExecution;
+    if (levelStarts.empty() || levelStarts.back() != blocks.size())
+    {
+        /* Graph was modified after sorting, the whole graph is treated as one sequential level */
+        levelStarts.clear();
+        levelStarts.push_back(0);
+        levelStarts.push_back((unsigned)blocks.size());
+        parallel = false;
+    }
+
+    vector<uint64_t> times(blocks.size(), 0);
+    for (unsigned level = 0; level + 1 < levelStarts.size(); level++)
+    {
+        int levelBegin = levelStarts[level];
+        int levelEnd   = levelStarts[level + 1];
+
+        if (parallel && levelEnd - levelBegin > 1)
+        {
+            parallelable_for(levelBegin, levelEnd, 1, ParallelLevelExecutor(this, &blocks[0], &times[0]));
+        }
+        else
+        {
+            for (int i = levelBegin; i < levelEnd; i++)
+                executeBlock(blocks[i], &times[i]);
         }
     } // for
 
-    for (unsigned int i = 0; i < blocks.size(); i++)
-        if (blocks[i]->sort == FilterBlock::PROCESSING_FILTER)  blocks[i]->clear();
+    if (stats != NULL) {
+        for (unsigned int i = 0; i < blocks.size(); i++)
+            stats->setTime(blocks[i]->getFullName(), times[i]);
+    }
+
+    finishExecution();
 } // execute
 
+/**
+ *  Common end of the execution with and without the plan
+ **/
+void FilterGraph::finishExecution()
+{
+    if (stats != NULL)
+        stats->setValue("Pool misses", pool.misses());
+
+    for (unsigned int i = 0; i < blocks.size(); i++)
+        if (blocks[i]->sort == FilterBlock::PROCESSING_FILTER)  recycleOutputs(blocks[i]);
+}
+
+void ParallelLevelExecutor::operator()(const BlockedRange<int> &r) const
+{
+    for (int i = r.begin(); i < r.end(); i++)
+        graph->executeBlock(blocks[i], &times[i]);
+}
+
 void FilterGraph::clearAllData()
 {
     for (unsigned int i = 0; i < blocks.size(); i++)
@@ -9,10 +9,14 @@
 #include "filterBlock.h"
 #include "filtersCollection.h"
 #include "calculationStats.h"
+#include "g12BufferPool.h"
+#include "filterGraphPlan.h"
 
 namespace corecvs
 {
 using std::vector;
+
+class ParallelLevelExecutor;
 //using namespace tinyxml2;
 
 //class CompoundFilter;
@@ -30,11 +34,39 @@ public:
     /* Execution statistics */
     Statistics *stats;
 
+    /**
+     * Outputs of the processing blocks are returned here after the execution
+     * and reused on the next run
+     **/
+    G12BufferPool pool;
+
+    /**
+     * If true, blocks that belong to the same dependency level are executed concurrently
+     **/
+    bool parallelExecution;
+
+    /**
+     * topologicSort() orders blocks level by level. Blocks of the level i are
+     * blocks[levelStarts[i]] .. blocks[levelStarts[i + 1] - 1], the last entry is blocks.size()
+     **/
+    vector<unsigned> levelStarts;
+
+    /**
+     * If true, the graph is executed by the compiled plan that fuses chains of pointwise blocks
+     * and runs the neighbourhood blocks by stripes, see FilterGraphPlan.
+     * The plan is rebuilt when the graph or block parameters change.
+     **/
+    bool fusePointwise;
+    FilterGraphPlan *plan;
+
     FilterGraph(FiltersCollection* _collection, FilterGraph* _parent) :
         blockCounter(0)
       , collection(_collection)
       , parent(_parent)
       , stats(NULL)
+      , parallelExecution(false)
+      , fusePointwise(false)
+      , plan(NULL)
     {}
 
     ~FilterGraph();
@@ -79,6 +111,20 @@ public:
     void execute();
     void clearAllData();
 
+    unsigned levelsNumber() const
+    {
+        return levelStarts.empty() ? 0 : (unsigned)levelStarts.size() - 1;
+    }
+
+private:
+    friend class ParallelLevelExecutor;
+    friend class FilterGraphPlan;
+    void executeBlock(FilterBlock *block, uint64_t *time);
+    void recycleOutputs(FilterBlock *block);
+    void finishExecution();
+
+public:
+
     void print();
     void saveToFile(const char* filename);
     void loadFromFile(const char* filename);
@@ -0,0 +1,483 @@
+/**
+ * \file filterGraphPlan.cpp
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <map>
+
+#include "filterGraphPlan.h"
+#include "filterGraph.h"
+#include "zoneTracer.h"
+
+namespace corecvs
+{
+
+using std::map;
+
+/**
+ *  Intermediate representation of the fused chain while the plan is compiled
+ **/
+struct FusedExpression
+{
+    Pin             *valueSource;
+    vector<uint16_t> valueTable;
+    Pin             *maskSource;
+    vector<uint16_t> maskTable;
+    int              blocks;
+
+    FusedExpression() :
+        valueSource(NULL)
+      , maskSource(NULL)
+      , blocks(0)
+    {}
+
+    static vector<uint16_t> identity()
+    {
+        vector<uint16_t> table(FilterBlock::POINTWISE_TABLE_SIZE);
+        for (int i = 0; i < FilterBlock::POINTWISE_TABLE_SIZE; i++)
+            table[i] = (uint16_t)i;
+        return table;
+    }
+};
+
+typedef map<FilterBlock *, FusedExpression> ExpressionMap;
+
+/**
+ *  Result of the producer could be fused into the consumer only if nobody else uses it
+ **/
+static bool canAbsorb(Pin *source, ExpressionMap &expressions, map<Pin *, int> &consumers)
+{
+    if (source == NULL || source->parent == NULL)
+        return false;
+    if (expressions.find(source->parent) == expressions.end())
+        return false;
+    if (source->parent->outputPins.size() != 1)
+        return false;
+    return consumers[source] == 1;
+}
+
+void FilterGraphPlan::takeSnapshot(vector<FilterBlock *> &blocks, vector<Pin *> &links, vector<unsigned> &versions) const
+{
+    blocks = mGraph->blocks;
+    links.clear();
+    versions.clear();
+    for (unsigned i = 0; i < blocks.size(); i++)
+    {
+        versions.push_back(blocks[i]->parametersVersion);
+        for (unsigned j = 0; j < blocks[i]->inputPins.size(); j++)
+            links.push_back(blocks[i]->inputPins[j]->takeFrom);
+    }
+}
+
+bool FilterGraphPlan::isValid() const
+{
+    if (!mCompiled)
+        return false;
+
+    vector<FilterBlock *> blocks;
+    vector<Pin *>         links;
+    vector<unsigned>      versions;
+    takeSnapshot(blocks, links, versions);
+    return blocks == mBlocks && links == mLinks && versions == mVersions;
+}
+
+bool FilterGraphPlan::compile()
+{
+    steps.clear();
+    levelStarts.clear();
+    mCompiled = false;
+
+    vector<FilterBlock *> &blocks = mGraph->blocks;
+    if (mGraph->levelStarts.empty() || mGraph->levelStarts.back() != blocks.size())
+    {
+        if (!mGraph->topologicSort())
+            return false;
+    }
+
+    /* Count the consumers of each output */
+    map<Pin *, int> consumers;
+    for (unsigned i = 0; i < blocks.size(); i++)
+        for (unsigned j = 0; j < blocks[i]->inputPins.size(); j++)
+        {
+            Pin *pin = blocks[i]->inputPins[j];
+            if (pin->takeFrom != NULL && !blocks[i]->isOuterPin(pin))
+                consumers[pin->takeFrom]++;
+        }
+
+    ExpressionMap expressions;
+    ExpressionMap prologues;
+    map<FilterBlock *, bool> absorbed;
+    vector<uint16_t> table(FilterBlock::POINTWISE_TABLE_SIZE);
+
+    for (unsigned i = 0; i < blocks.size(); i++)
+    {
+        FilterBlock *block = blocks[i];
+        if (block->sort != FilterBlock::PROCESSING_FILTER)
+            continue;
+
+        if (block->pointwiseKind() == FilterBlock::NOT_POINTWISE && block->stripeHalo() >= 0 &&
+            block->inputPins.size() == 1 && block->outputPins.size() == 1)
+        {
+            Pin *source = block->inputPins[0]->takeFrom;
+            if (source == NULL)
+                continue;
+
+            FusedExpression prologue;
+            if (canAbsorb(source, expressions, consumers))
+            {
+                prologue = expressions[source->parent];
+                absorbed[source->parent] = true;
+            }
+            else
+            {
+                prologue.valueSource = source;
+            }
+            prologue.blocks++;
+            prologues[block] = prologue;
+            continue;
+        }
+
+        FusedExpression expression;
+        switch (block->pointwiseKind())
+        {
+            case FilterBlock::POINTWISE_MAP:
+            {
+                Pin *source = block->inputPins[0]->takeFrom;
+                if (source == NULL)
+                    continue;
+                block->getPointwiseTable(&table[0]);
+
+                /* f(mask ? v : 0) is f(mask ? v : f(0)), so the masked chain could be continued only if f(0) == 0 */
+                if (canAbsorb(source, expressions, consumers) &&
+                    (expressions[source->parent].maskSource == NULL || table[0] == 0))
+                {
+                    expression = expressions[source->parent];
+                    for (int j = 0; j < FilterBlock::POINTWISE_TABLE_SIZE; j++)
+                        expression.valueTable[j] = table[expression.valueTable[j]];
+                    absorbed[source->parent] = true;
+                }
+                else
+                {
+                    expression.valueSource = source;
+                    expression.valueTable  = table;
+                }
+                break;
+            }
+            case FilterBlock::POINTWISE_MASK:
+            {
+                Pin *valueSource = block->inputPins[0]->takeFrom;
+                Pin *maskSource  = block->inputPins[1]->takeFrom;
+                if (valueSource == NULL || maskSource == NULL)
+                    continue;
+
+                if (canAbsorb(valueSource, expressions, consumers) &&
+                    expressions[valueSource->parent].maskSource == NULL)
+                {
+                    FusedExpression &value = expressions[valueSource->parent];
+                    expression.valueSource = value.valueSource;
+                    expression.valueTable  = value.valueTable;
+                    expression.blocks     += value.blocks;
+                    absorbed[valueSource->parent] = true;
+                }
+                else
+                {
+                    expression.valueSource = valueSource;
+                    expression.valueTable  = FusedExpression::identity();
+                }
+
+                if (canAbsorb(maskSource, expressions, consumers) &&
+                    expressions[maskSource->parent].maskSource == NULL)
+                {
+                    FusedExpression &mask = expressions[maskSource->parent];
+                    expression.maskSource = mask.valueSource;
+                    expression.maskTable  = mask.valueTable;
+                    expression.blocks    += mask.blocks;
+                    absorbed[maskSource->parent] = true;
+                }
+                else
+                {
+                    expression.maskSource = maskSource;
+                    expression.maskTable  = FusedExpression::identity();
+                }
+
+                /* Both operands come from the same frame, so masking is folded into the table */
+                if (expression.maskSource == expression.valueSource)
+                {
+                    for (int j = 0; j < FilterBlock::POINTWISE_TABLE_SIZE; j++)
+                        if (expression.maskTable[j] == 0)
+                            expression.valueTable[j] = 0;
+                    expression.maskSource = NULL;
+                    expression.maskTable.clear();
+                }
+                break;
+            }
+            default:
+                continue;
+        }
+        expression.blocks++;
+        expressions[block] = expression;
+    }
+
+    /* Emit steps in the order of the graph, so they stay grouped by levels */
+    unsigned level = 0;
+    for (unsigned i = 0; i < blocks.size(); i++)
+    {
+        while (level < mGraph->levelStarts.size() && mGraph->levelStarts[level] <= i)
+        {
+            if (levelStarts.empty() || levelStarts.back() != steps.size())
+                levelStarts.push_back((unsigned)steps.size());
+            level++;
+        }
+
+        FilterBlock *block = blocks[i];
+        if (absorbed[block])
+            continue;
+
+        Step step(block);
+        FusedExpression *expression = NULL;
+        ExpressionMap::iterator it = expressions.find(block);
+        if (it != expressions.end())
+        {
+            expression = &it->second;
+            step.fused = true;
+        }
+        it = prologues.find(block);
+        if (it != prologues.end())
+        {
+            expression = &it->second;
+            step.striped = true;
+        }
+
+        if (expression != NULL)
+        {
+            step.blocksFused = expression->blocks;
+            step.valueSource = expression->valueSource;
+            step.maskSource  = expression->maskSource;
+            step.valueTable.swap(expression->valueTable);
+            step.maskTable .swap(expression->maskTable);
+        }
+        steps.push_back(step);
+    }
+    levelStarts.push_back((unsigned)steps.size());
+
+    takeSnapshot(mBlocks, mLinks, mVersions);
+    mCompiled = true;
+    return true;
+}
+
+int FilterGraphPlan::fusedBlocksNumber() const
+{
+    return (int)(mGraph->blocks.size() - steps.size());
+}
+
+static inline void fuseRow(const uint16_t *valueTable, const uint16_t *maskTable, const uint16_t *in, const uint16_t *m, uint16_t *out, int w)
+{
+    if (maskTable == NULL)
+    {
+        for (int j = 0; j < w; j++)
+            out[j] = valueTable[in[j]];
+    }
+    else
+    {
+        for (int j = 0; j < w; j++)
+            out[j] = maskTable[m[j]] != 0 ? valueTable[in[j]] : 0;
+    }
+}
+
+class ParallelFusedPass
+{
+public:
+    const FilterGraphPlan::Step *step;
+    G12Buffer *value;
+    G12Buffer *mask;
+    G12Buffer *result;
+    int stripeHeight;
+
+    ParallelFusedPass(const FilterGraphPlan::Step *_step, G12Buffer *_value, G12Buffer *_mask, G12Buffer *_result, int _stripeHeight) :
+        step(_step)
+      , value(_value)
+      , mask(_mask)
+      , result(_result)
+      , stripeHeight(_stripeHeight)
+    {}
+
+    void operator()(const BlockedRange<int> &r) const
+    {
+        const uint16_t *valueTable = &step->valueTable[0];
+        const uint16_t *maskTable  = (mask != NULL) ? &step->maskTable[0] : NULL;
+        int w = result->w;
+
+        for (int stripe = r.begin(); stripe < r.end(); stripe++)
+        {
+            int iEnd = CORE_MIN(result->h, (stripe + 1) * stripeHeight);
+            for (int i = stripe * stripeHeight; i < iEnd; i++)
+            {
+                const uint16_t *m = (mask != NULL) ? &mask->element(i, 0) : NULL;
+                fuseRow(valueTable, maskTable, &value->element(i, 0), m, &result->element(i, 0), w);
+            }
+        }
+    }
+};
+
+class ParallelStripedPass
+{
+public:
+    const FilterGraphPlan::Step *step;
+    G12Buffer *value;
+    G12Buffer *mask;
+    G12Buffer *result;
+    int stripeHeight;
+    int halo;
+
+    ParallelStripedPass(const FilterGraphPlan::Step *_step, G12Buffer *_value, G12Buffer *_mask, G12Buffer *_result, int _stripeHeight, int _halo) :
+        step(_step)
+      , value(_value)
+      , mask(_mask)
+      , result(_result)
+      , stripeHeight(_stripeHeight)
+      , halo(_halo)
+    {}
+
+    void operator()(const BlockedRange<int> &r) const
+    {
+        int h = result->h;
+        int w = result->w;
+        if (step->valueTable.empty())
+        {
+            for (int stripe = r.begin(); stripe < r.end(); stripe++)
+                step->block->processRows(value, 0, result, stripe * stripeHeight, CORE_MIN(h, (stripe + 1) * stripeHeight));
+            return;
+        }
+
+        /* Prologue rows of one stripe, the buffer is reused by the stripes of the range */
+        const uint16_t *valueTable = &step->valueTable[0];
+        const uint16_t *maskTable  = (mask != NULL) ? &step->maskTable[0] : NULL;
+        G12Buffer rows(CORE_MIN(h, stripeHeight + 2 * halo), w, false);
+
+        for (int stripe = r.begin(); stripe < r.end(); stripe++)
+        {
+            int y1 = stripe * stripeHeight;
+            int y2 = CORE_MIN(h, y1 + stripeHeight);
+            int inputY1 = CORE_MAX(0, y1 - halo);
+            int inputY2 = CORE_MIN(h, y2 + halo);
+            for (int i = inputY1; i < inputY2; i++)
+            {
+                const uint16_t *m = (mask != NULL) ? &mask->element(i, 0) : NULL;
+                fuseRow(valueTable, maskTable, &value->element(i, 0), m, &rows.element(i - inputY1, 0), w);
+            }
+            step->block->processRows(&rows, inputY1, result, y1, y2);
+        }
+    }
+};
+
+void FilterGraphPlan::executeFused(Step &step)
+{
+    TRACE_ZONE("FilterGraphPlan::executeFused");
+    G12Buffer *value = NULL;
+    G12Buffer *mask  = NULL;
+    step.valueSource->getPin(value);
+    if (step.maskSource != NULL)
+        step.maskSource->getPin(mask);
+
+    if (value == NULL || (step.maskSource != NULL && mask == NULL))
+        return;
+
+    G12Buffer *&result = static_cast<G12Pin *>(step.block->outputPins[0])->getData();
+    result = mGraph->pool.acquire(value->h, value->w);
+
+    int rowBytes     = value->stride * sizeof(uint16_t) * (mask != NULL ? 3 : 2);
+    int stripeHeight = CORE_MAX(1, STRIPE_BYTES / rowBytes);
+    int stripes      = (value->h + stripeHeight - 1) / stripeHeight;
+
+    parallelable_for(0, stripes, 1, ParallelFusedPass(&step, value, mask, result, stripeHeight));
+}
+
+void FilterGraphPlan::executeStriped(Step &step)
+{
+    TRACE_ZONE("FilterGraphPlan::executeStriped");
+    G12Buffer *value = NULL;
+    G12Buffer *mask  = NULL;
+    step.valueSource->getPin(value);
+    if (step.maskSource != NULL)
+        step.maskSource->getPin(mask);
+
+    if (value == NULL || (step.maskSource != NULL && mask == NULL))
+        return;
+
+    G12Buffer *&result = static_cast<G12Pin *>(step.block->outputPins[0])->getData();
+    result = mGraph->pool.acquire(value->h, value->w);
+
+    /* Stripes are at least twice the halo, so the prologue computes no more than twice the frame */
+    int halo         = step.block->stripeHalo();
+    int rowBytes     = value->stride * sizeof(uint16_t) * (mask != NULL ? 3 : 2);
+    int stripeHeight = CORE_MAX(CORE_MAX(1, STRIPE_BYTES / rowBytes), 2 * halo);
+    int stripes      = (value->h + stripeHeight - 1) / stripeHeight;
+
+    parallelable_for(0, stripes, 1, ParallelStripedPass(&step, value, mask, result, stripeHeight, halo));
+}
+
+void FilterGraphPlan::executeStep(Step &step, uint64_t *time)
+{
+    if (!step.fused && !step.striped)
+    {
+        mGraph->executeBlock(step.block, time);
+        return;
+    }
+
+    PreciseTimer stepExecutionTime = PreciseTimer::currentTime();
+    if (step.fused)
+        executeFused(step);
+    else
+        executeStriped(step);
+    *time = stepExecutionTime.usecsToNow();
+}
+
+class ParallelStepExecutor
+{
+public:
+    FilterGraphPlan *plan;
+    uint64_t        *times;
+
+    ParallelStepExecutor(FilterGraphPlan *_plan, uint64_t *_times) :
+        plan(_plan),
+        times(_times)
+    {}
+
+    void operator()(const BlockedRange<int> &r) const
+    {
+        for (int i = r.begin(); i < r.end(); i++)
+            plan->executeStep(plan->steps[i], &times[i]);
+    }
+};
+
+void FilterGraphPlan::execute()
+{
+    vector<uint64_t> times(steps.size(), 0);
+    for (unsigned level = 0; level + 1 < levelStarts.size(); level++)
+    {
+        int levelBegin = levelStarts[level];
+        int levelEnd   = levelStarts[level + 1];
+
+        if (mGraph->parallelExecution && levelEnd - levelBegin > 1)
+        {
+            parallelable_for(levelBegin, levelEnd, 1, ParallelStepExecutor(this, &times[0]));
+        }
+        else
+        {
+            for (int i = levelBegin; i < levelEnd; i++)
+                executeStep(steps[i], &times[i]);
+        }
+    }
+
+    /* Blocks fused into the steps get zero time, so the statistics have the same rows as without the plan */
+    Statistics *stats = mGraph->stats;
+    if (stats != NULL) {
+        for (unsigned i = 0; i < mGraph->blocks.size(); i++)
+            stats->setTime(mGraph->blocks[i]->getFullName(), 0);
+        for (unsigned i = 0; i < steps.size(); i++)
+            stats->setTime(steps[i].block->getFullName(), times[i]);
+    }
+}
+
+} /* namespace corecvs */
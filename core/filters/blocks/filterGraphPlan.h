@@ -0,0 +1,129 @@
+#pragma once
+/**
+ * \file filterGraphPlan.h
+ * \brief Compiled execution plan of the FilterGraph
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <vector>
+
+#include "global.h"
+
+#include "filterBlock.h"
+#include "calculationStats.h"
+
+namespace corecvs
+{
+
+using std::vector;
+
+class FilterGraph;
+
+/**
+ *  The plan is built from the topologically sorted graph. Chains of pointwise blocks
+ *  (see FilterBlock::pointwiseKind()) whose intermediate results are not used by anyone else are
+ *  fused into one step. Lookup tables of the chain are composed, so the whole chain is a single
+ *  pass over the frame and only the output of the last block is materialized.
+ *
+ *  A fused step computes
+ *  \code
+ *     out = (maskSource == NULL || maskTable[mask] != 0) ? valueTable[value] : 0
+ *  \endcode
+ *  so MaskFilterBlock with pointwise chains on both inputs is fused as well. The pass is done
+ *  in horizontal stripes that fit the L2 cache.
+ *
+ *  Neighbourhood blocks (see FilterBlock::stripeHalo()) are executed by the same stripes. The fused
+ *  chain that feeds such block only is its prologue: for every stripe the chain is computed for the
+ *  stripe rows with the halo rows around them into a buffer of the stripe size, and the block takes
+ *  its rows from there. So the chain result is never materialized for the whole frame. Consecutive
+ *  neighbourhood blocks are separate striped steps, each of them stores the whole result. The blocks
+ *  without the stripe support are executed by themselves on the whole frame.
+ *
+ *  SobelFilter and ThickeningBlock, the morphology block of the collection, support the stripes.
+ *  CannyFilter does not, its hysteresis needs the whole frame.
+ *
+ *  The plan is valid until the blocks, their connections or the parameters of
+ *  fused blocks (FilterBlock::parametersVersion) are changed.
+ **/
+class FilterGraphPlan
+{
+public:
+    /**
+     *  Approximate amount of data that is processed by one thread at once
+     **/
+    static const int STRIPE_BYTES = 256 * 1024;
+
+    struct Step
+    {
+        /** Block that is executed. For fused steps it is the last block, its output pin gets the result */
+        FilterBlock     *block;
+        bool             fused;
+        /**
+         *  The block is a neighbourhood one executed by stripes. The tables are the prologue,
+         *  if they are empty the block reads valueSource as is.
+         **/
+        bool             striped;
+        /** Number of blocks fused into this step */
+        int              blocksFused;
+
+        Pin             *valueSource;
+        vector<uint16_t> valueTable;
+        /** NULL if there is no masking */
+        Pin             *maskSource;
+        vector<uint16_t> maskTable;
+
+        Step(FilterBlock *_block = NULL) :
+            block(_block)
+          , fused(false)
+          , striped(false)
+          , blocksFused(0)
+          , valueSource(NULL)
+          , maskSource(NULL)
+        {}
+    };
+
+    vector<Step>     steps;
+    /** Steps of the level i are steps[levelStarts[i]] .. steps[levelStarts[i + 1] - 1] */
+    vector<unsigned> levelStarts;
+
+    explicit FilterGraphPlan(FilterGraph *graph) :
+        mGraph(graph)
+      , mCompiled(false)
+    {}
+
+    /**
+     * Builds the plan. Graph is sorted if it was not.
+     **/
+    bool compile();
+
+    /**
+     * Checks if the graph was not changed since the last compile()
+     **/
+    bool isValid() const;
+
+    void execute();
+
+    /** Number of blocks that are not executed by themselves but are fused into other steps */
+    int fusedBlocksNumber() const;
+
+private:
+    friend class ParallelStepExecutor;
+
+    void executeStep(Step &step, uint64_t *time);
+    void executeFused(Step &step);
+    void executeStriped(Step &step);
+
+    FilterGraph *mGraph;
+    bool         mCompiled;
+
+    /* Snapshot of the graph the plan is built for */
+    vector<FilterBlock *> mBlocks;
+    vector<Pin *>         mLinks;
+    vector<unsigned>      mVersions;
+
+    void takeSnapshot(vector<FilterBlock *> &blocks, vector<Pin *> &links, vector<unsigned> &versions) const;
+};
+
+} /* namespace corecvs */
+/* EOF */
@@ -0,0 +1,76 @@
+/**
+ * \file g12BufferPool.cpp
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include "g12BufferPool.h"
+
+namespace corecvs
+{
+
+#ifdef WITH_TBB
+#define POOL_LOCK tbb::spin_mutex::scoped_lock lock(mMutex);
+#else
+#define POOL_LOCK
+#endif
+
+G12BufferPool::~G12BufferPool()
+{
+    clear();
+}
+
+G12Buffer *G12BufferPool::acquire(int h, int w)
+{
+    {
+        POOL_LOCK
+        for (unsigned i = 0; i < mFree.size(); i++)
+        {
+            if (mFree[i]->hasSameSize(h, w))
+            {
+                G12Buffer *result = mFree[i];
+                mFree[i] = mFree.back();
+                mFree.pop_back();
+                mHits++;
+                return result;
+            }
+        }
+        mMisses++;
+    }
+    return new G12Buffer(h, w, false);
+}
+
+void G12BufferPool::release(G12Buffer *buffer)
+{
+    if (buffer == NULL)
+        return;
+
+    if (!buffer->isShared())
+    {
+        POOL_LOCK
+        if (mFree.size() < mMaxBuffers)
+        {
+            mFree.push_back(buffer);
+            return;
+        }
+    }
+    delete buffer;
+}
+
+void G12BufferPool::clear()
+{
+    POOL_LOCK
+    for (unsigned i = 0; i < mFree.size(); i++)
+        delete_safe(mFree[i]);
+    mFree.clear();
+}
+
+unsigned G12BufferPool::size()
+{
+    POOL_LOCK
+    return (unsigned)mFree.size();
+}
+
+#undef POOL_LOCK
+
+} /* namespace corecvs */
@@ -0,0 +1,84 @@
+#pragma once
+/**
+ * \file g12BufferPool.h
+ * \brief Pool of the G12 buffers that are recycled between the FilterGraph runs
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <vector>
+
+#ifdef WITH_TBB
+#include <tbb/spin_mutex.h>
+#endif
+
+#include "global.h"
+
+#include "g12Buffer.h"
+
+namespace corecvs
+{
+
+using std::vector;
+
+/**
+ *  Filter blocks produce a new output frame on every run, and the frame geometry is
+ *  the same from run to run. Instead of allocating a new buffer each time,
+ *  the blocks take their outputs from the pool of the graph, and the graph returns them back
+ *  after the execution.
+ *
+ *  Buffers that still share memory with some view (see AbstractBuffer::isShared())
+ *  are not reused, they are just deleted and the memory stays with the view.
+ *
+ *  Pool is thread safe with TBB, because blocks of one level could be executed concurrently.
+ **/
+class G12BufferPool
+{
+public:
+    G12BufferPool(unsigned maxBuffers = 64) :
+        mMaxBuffers(maxBuffers)
+      , mHits(0)
+      , mMisses(0)
+    {}
+
+    ~G12BufferPool();
+
+    /**
+     * Returns the buffer of the given size. The content of the buffer is undefined.
+     **/
+    G12Buffer *acquire(int h, int w);
+
+    /**
+     * Takes ownership of the buffer. NULL is allowed.
+     **/
+    void release(G12Buffer *buffer);
+
+    /**
+     * Deletes all the buffers that are kept in the pool
+     **/
+    void clear();
+
+    unsigned size();
+
+    /** Number of acquire() calls that were served from the pool */
+    unsigned hits()   const { return mHits;   }
+    /** Number of acquire() calls that caused a new allocation */
+    unsigned misses() const { return mMisses; }
+
+private:
+    vector<G12Buffer *> mFree;
+    unsigned mMaxBuffers;
+    unsigned mHits;
+    unsigned mMisses;
+
+#ifdef WITH_TBB
+    tbb::spin_mutex mMutex;
+#endif
+
+    /* Pool is not copyable */
+    G12BufferPool(const G12BufferPool &);
+    G12BufferPool &operator =(const G12BufferPool &);
+};
+
+} /* namespace corecvs */
+/* EOF */
@@ -102,10 +102,16 @@ public:
        else return false;
    }
 
+   /**
+    * With shouldCopy the caller gets its own buffer object, but it is a view that shares
+    * the refcounted memory with the pin data. So no pixels are copied, and the data
+    * survives clearing of the pin. If the caller wants to modify such a buffer,
+    * it should copy it first when isShared() is true.
+    **/
    virtual bool getPin(G12Buffer* &data, bool shouldCopy = false)
    {
        if (shouldCopy && inout != NULL)
-            data = new G12Buffer(inout);
+            data = inout->createView<G12Buffer>();
        else data = inout;
        return true;
    }
@@ -272,8 +278,8 @@ public:
 
    virtual bool getPin(G12Buffer* &data, bool shouldCopy = false)
    {
-       if (shouldCopy)
-            data = new G12Buffer(inout);
+       if (shouldCopy && inout != NULL)
+            data = inout->createView<G12Buffer>();
        else data = inout;
        return true;
    }
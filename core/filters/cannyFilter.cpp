@@ -23,63 +23,6 @@ namespace corecvs
 
 int CannyFilter::instanceCounter = 0;
 
-void CannyFilter::recursiveEdgeProver(G12Buffer *buffer, int h, int w)
-{
-    if ( h <= 0 || h >= buffer->h -1 || w <= 0 || w >= buffer->w - 1 ) return;
-
-    int l = buffer->element(h,w - 1);
-    int r = buffer->element(h,w + 1);
-    int u = buffer->element(h - 1, w);
-    int d = buffer->element(h + 1, w);
-
-    int lu = buffer->element(h - 1, w - 1);
-    int ld = buffer->element(h + 1, w - 1);
-    int ru = buffer->element(h - 1, w + 1);
-    int rd = buffer->element(h + 1, w + 1);
-    if (l == gray)
-    {
-        buffer->element(h, w - 1) = white;
-        recursiveEdgeProver(buffer,h, w - 1);
-    }
-    if (r == gray)
-    {
-        buffer->element(h, w + 1) = white;
-        recursiveEdgeProver(buffer,h, w + 1);
-    }
-    if (u == gray)
-    {
-        buffer->element(h - 1, w) = white;
-        recursiveEdgeProver(buffer,h - 1, w);
-    }
-    if (d == gray)
-    {
-        buffer->element(h + 1, w) = white;
-        recursiveEdgeProver(buffer, h + 1, w);
-    }
-    if (lu == gray)
-    {
-        buffer->element(h - 1, w - 1) = white;
-        recursiveEdgeProver(buffer, h - 1, w - 1);
-    }
-    if (ld == gray)
-    {
-        buffer->element(h + 1, w - 1) = white;
-        recursiveEdgeProver(buffer, h + 1, w - 1);
-    }
-    if (ru == gray)
-    {
-        buffer->element(h - 1, w + 1) = white;
-        recursiveEdgeProver(buffer,h - 1, w + 1);
-    }
-    if (rd == gray)
-    {
-        buffer->element(h + 1, w + 1) = white;
-        recursiveEdgeProver(buffer, h + 1, w + 1);
-    }
-
-    return;
-}
-
 int CannyFilter::operator ()()
 {
 
@@ -89,47 +32,11 @@ int CannyFilter::operator ()()
     if (input == NULL)
         return 0;
 
-    // non-maximum suppression
-    DerivativeBuffer derBuf(input);
-    G12Buffer *suppressedBuffer = derBuf.nonMaximalSuppression();
-
-    // double thresholding
-    for (int i = 0; i < suppressedBuffer->h; i++)
-    {
-        for (int j = 0; j < suppressedBuffer->w; j++ )
-        {
-             uint16_t pixel = suppressedBuffer->element(i,j);
-             if (pixel < mCannyParameters.minimumThreshold())
-             {
-                 suppressedBuffer->element(i,j) = 0;
-                 continue;
-             }
-             if (pixel > mCannyParameters.maximumThreshold())
-             {
-                 suppressedBuffer->element(i,j) = white;
-                 continue;
-             }
-             suppressedBuffer->element(i,j) = gray;
-        }
-    }
-
-    // edge tracking
-    if (mCannyParameters.shouldEdgeDetect())
-    {
-        for (int i = 0; i < suppressedBuffer->h; i++)
-        {
-            for (int j = 0; j < suppressedBuffer->w; j++ )
-            {
-                if (suppressedBuffer->element(i,j) == white)
-                    recursiveEdgeProver(suppressedBuffer, i, j);
-            }
-        }
-        for (int i = 0; i < suppressedBuffer->h; i++)
-            for (int j = 0; j < suppressedBuffer->w; j++ )
-                if (suppressedBuffer->element(i,j) == gray) suppressedBuffer->element(i,j) = 0;
-    }
-
-    result = suppressedBuffer;
+    result = mDetector.detect(
+                input,
+                mCannyParameters.minimumThreshold(),
+                mCannyParameters.maximumThreshold(),
+                mCannyParameters.shouldEdgeDetect());
     return 0;
 }
 
@@ -12,6 +12,7 @@
 #include "../xml/generated/cannyParameters.h"
 #include "filtersCollection.h"
 #include "g12Buffer.h"
+#include "cannyDetector.h"
 
 namespace corecvs
 {
@@ -63,8 +64,8 @@ private:
     G12Buffer *input;
     G12Buffer *result;
 
-    static void recursiveEdgeProver(G12Buffer *buffer, int h, int w);
-
+    /** Keeps the working planes between the frames */
+    CannyDetector mDetector;
 
     static int instanceCounter;
 };
@@ -17,7 +17,9 @@ HEADERS +=                            \
     filters/binarizeBlock.h \
     filters/maskFilterBlock.h \
     filters/thickeningBlock.h \
-    filters/blocks/compoundFilter.h
+    filters/blocks/compoundFilter.h \
+    filters/blocks/g12BufferPool.h \
+    filters/blocks/filterGraphPlan.h
 
 
 SOURCES +=                              \
@@ -39,4 +41,6 @@ SOURCES +=                              \
     filters/binarizeBlock.cpp \
     filters/maskFilterBlock.cpp \
     filters/thickeningBlock.cpp \
-    filters/blocks/compoundFilter.cpp
+    filters/blocks/compoundFilter.cpp \
+    filters/blocks/g12BufferPool.cpp \
+    filters/blocks/filterGraphPlan.cpp
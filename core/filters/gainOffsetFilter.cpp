@@ -31,12 +31,20 @@ int GainOffsetFilter::operator()()
     if (input == NULL)
         return 0;
 
-    result = new G12Buffer(input);
+    result = newOutputBuffer(input);
+    result->fillWith(*input);
     GainOffsetMapper gom(mGainOffsetParameters.gain(), mGainOffsetParameters.offset());
     result->mapOperationElementwize<GainOffsetMapper>(gom);
     return 0;
 }
 
+void GainOffsetFilter::getPointwiseTable(uint16_t *table)
+{
+    GainOffsetMapper gom(mGainOffsetParameters.gain(), mGainOffsetParameters.offset());
+    for (int i = 0; i < POINTWISE_TABLE_SIZE; i++)
+        table[i] = gom((uint16_t)i);
+}
+
 XMLNode* GainOffsetFilter::serialize(XMLNode* node)
 {
     XMLNode* mBlock = FilterBlock::serialize(node);
@@ -55,6 +63,7 @@ void GainOffsetFilter::deserialize(XMLNode* node, bool force)
 
     DeserializerVisitor visitor(p);
     mGainOffsetParameters.accept(visitor);
+    parametersChanged();
 }
 
 } /* namespace corecvs */
@@ -45,6 +45,7 @@ public:
     virtual bool setParameters(const void *newParameters)
     {
         mGainOffsetParameters = *(GainOffsetParameters *)newParameters;
+        parametersChanged();
         return true;
     }
     virtual void *getParameters()
@@ -52,6 +53,9 @@ public:
         return (void*)&mGainOffsetParameters;
     }
 
+    virtual PointwiseKind pointwiseKind() const { return POINTWISE_MAP; }
+    virtual void getPointwiseTable(uint16_t *table);
+
     virtual XMLNode* serialize(XMLNode* node);
     virtual void deserialize(XMLNode*, bool = true);
 
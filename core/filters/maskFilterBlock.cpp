@@ -20,7 +20,7 @@ int MaskFilterBlock::operator()()
     G12Buffer* &result = static_cast<G12Pin*>(outputPins[0])->getData();
 
     if (input == NULL || mask == NULL)  return 0;
-    result = new G12Buffer(input->getSize());
+    result = newOutputBuffer(input);
 
     for (int h = 0; h < input->h; h++ )
     {
@@ -34,6 +34,8 @@ public:
 
     virtual int operator()();
 
+    virtual PointwiseKind pointwiseKind() const { return POINTWISE_MASK; }
+
     MaskingParameters mMaskingParameters;
 
     virtual bool setParameters(const void * newParameters)
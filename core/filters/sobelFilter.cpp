@@ -40,7 +40,7 @@ int SobelFilter::operator()()
 
     if (!(mSobelParameters.horizontal() || mSobelParameters.vertical()))
     {
-        result = new G12Buffer(input);
+        result = input->createView<G12Buffer>();
         return 0;
     }
 
@@ -107,6 +107,79 @@ int SobelFilter::operator()()
     return 0;
 } // operator()()
 
+/**
+ *  Same as operator()(), the kernels write the output rows 1 .. h - 2 and the columns 1 .. w - 2,
+ *  the rest is zero.
+ **/
+void SobelFilter::processRows(G12Buffer *input, int inputY, G12Buffer *result, int y1, int y2)
+{
+    int h = result->h;
+    int w = result->w;
+
+    for (int i = y1; i < y2; i++)
+    {
+        if (i == 0 || i == h - 1)
+        {
+            memset(&result->element(i, 0), 0, w * sizeof(uint16_t));
+            continue;
+        }
+        result->element(i, 0)     = 0;
+        result->element(i, w - 1) = 0;
+    }
+
+    /* Input rows that are the top rows of the kernel for the output rows of the stripe */
+    int begin = CORE_MAX(y1 - 1, 0) - inputY;
+    int end   = CORE_MIN(y2 - 1, h - 2) - inputY;
+
+    SobelHorizontalKernel<DummyAlgebra> kernelHor;
+    SobelVerticalKernel<DummyAlgebra>   kernelVert;
+
+    kernelHor.bias  = ((G12Buffer::BUFFER_MAX_VALUE + 1) / 2);
+    kernelVert.bias = ((G12Buffer::BUFFER_MAX_VALUE + 1) / 2);
+
+    bool isDual = mSobelParameters.horizontal() && mSobelParameters.vertical();
+
+    if (isDual && mSobelParameters.mMixingType == SobelMixingType::SUM_OF_ABSOLUTE)
+    {
+        BufferProcessor<G12Buffer, G12Buffer, EdgeMagnitude, G12BufferAlgebra> processorEM;
+        processorEM.processRows(&input, &result, begin, end, inputY, EdgeMagnitude<DummyAlgebra>());
+        return;
+    }
+
+    if (!isDual)
+    {
+        if (mSobelParameters.horizontal())
+        {
+            BufferProcessor<G12Buffer, G12Buffer, SobelHorizontalKernel, G12BufferAlgebra> processorHor;
+            processorHor.processRows(&input, &result, begin, end, inputY, kernelHor);
+        }
+        else
+        {
+            BufferProcessor<G12Buffer, G12Buffer, SobelVerticalKernel, G12BufferAlgebra> processorVer;
+            processorVer.processRows(&input, &result, begin, end, inputY, kernelVert);
+        }
+        return;
+    }
+
+    /* Both directions are computed for the stripe rows only and mixed */
+    G12Buffer *outputH = new G12Buffer(y2 - y1, w);
+    G12Buffer *outputV = new G12Buffer(y2 - y1, w);
+    BufferProcessor<G12Buffer, G12Buffer, SobelHorizontalKernel, G12BufferAlgebra> processorHor;
+    processorHor.processRows(&input, &outputH, begin, end, inputY - y1, kernelHor);
+    BufferProcessor<G12Buffer, G12Buffer, SobelVerticalKernel, G12BufferAlgebra> processorVer;
+    processorVer.processRows(&input, &outputV, begin, end, inputY - y1, kernelVert);
+
+    for (int i = y1; i < y2; i++) {
+       for (int j = 0; j < w; j++) {
+          Vector2dd grad(outputH->element(i - y1, j), outputV->element(i - y1, j));
+          result->element(i, j) = grad.l2Metric();
+       }
+    }
+
+    delete outputH;
+    delete outputV;
+}
+
 XMLNode* SobelFilter::serialize(XMLNode* node)
 {
     XMLNode* mBlock = FilterBlock::serialize(node);
@@ -125,6 +198,7 @@ void SobelFilter::deserialize(XMLNode* node, bool force)
 
     DeserializerVisitor visitor(p);
     mSobelParameters.accept(visitor);
+    parametersChanged();
 }
 
 SobelFilter::~SobelFilter()
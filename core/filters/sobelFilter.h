@@ -45,8 +45,16 @@ public:
     virtual bool setParameters(const void* newParameters)
     {
         mSobelParameters = *(SobelParameters*)newParameters;
+        parametersChanged();
         return true;
     }
+
+    /* Without the directions the input is passed as is and needs no stripes */
+    virtual int stripeHalo() const
+    {
+        return (mSobelParameters.horizontal() || mSobelParameters.vertical()) ? 1 : -1;
+    }
+    virtual void processRows(G12Buffer *input, int inputY, G12Buffer *result, int y1, int y2);
     virtual void *getParameters()
     {
         return (void*)&mSobelParameters;
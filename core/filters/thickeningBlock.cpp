@@ -20,22 +20,34 @@ int ThickeningBlock::operator()()
 
     if (input == NULL)
         return 0;
-    result = new G12Buffer(input);
+    result = newOutputBuffer(input);
+    processRows(input, 0, result, 0, input->h);
+    return 0;
+}
+
+void ThickeningBlock::processRows(G12Buffer *input, int inputY, G12Buffer *result, int y1, int y2)
+{
+    int power = mThickeningParameters.power();
+    int shift = power / 2;
 
-    int shift = mThickeningParameters.power() / 2;
+    for (int h = y1; h < y2; h++)
+        memcpy(&result->element(h, 0), &input->element(h - inputY, 0), result->w * sizeof(uint16_t));
 
-    for (int h = shift + 1; h < input->h - shift - 1; h++ )
+    /* Only the part of the square that falls into the stripe is filled */
+    int hBegin = CORE_MAX(shift + 1, y1 - power + shift + 1);
+    int hEnd   = CORE_MIN(result->h - shift - 1, y2 + shift);
+    for (int h = hBegin; h < hEnd; h++ )
     {
-        for (int w = shift + 1; w < input->w - shift - 1; w++)
+        int top    = CORE_MAX(h - shift, y1);
+        int bottom = CORE_MIN(h - shift + power, y2);
+        for (int w = shift + 1; w < result->w - shift - 1; w++)
         {
-            if (input->element(h,w) == G12Buffer::BUFFER_MAX_VALUE)
+            if (input->element(h - inputY, w) == G12Buffer::BUFFER_MAX_VALUE)
             {
-                result->fillRectangleWith(h - shift, w - shift, mThickeningParameters.power(), mThickeningParameters.power(), G12Buffer::BUFFER_MAX_VALUE);
+                result->fillRectangleWith(top, w - shift, bottom - top, power, G12Buffer::BUFFER_MAX_VALUE);
             }
         }
     }
-
-    return 0;
 }
 
 XMLNode* ThickeningBlock::serialize(XMLNode* node)
@@ -56,6 +68,7 @@ void ThickeningBlock::deserialize(XMLNode* node, bool force)
 
     DeserializerVisitor visitor(p);
     mThickeningParameters.accept(visitor);
+    parametersChanged();
 }
 
 
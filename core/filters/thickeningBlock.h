@@ -38,9 +38,14 @@ public:
     virtual bool setParameters(const void * newParameters)
     {
         mThickeningParameters = *(ThickeningParameters*)newParameters;
+        parametersChanged();
         return true;
     }
 
+    /* Square of the row h covers the rows h - power / 2 .. h - power / 2 + power - 1 */
+    virtual int stripeHalo() const { return mThickeningParameters.power() / 2; }
+    virtual void processRows(G12Buffer *input, int inputY, G12Buffer *result, int y1, int y2);
+
     virtual void *getParameters()
     {
         return (void*)&mThickeningParameters;
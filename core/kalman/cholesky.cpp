@@ -6,6 +6,8 @@
  * \author alexander
  */
 
+#include <math.h>
+
 #include "cholesky.h"
 namespace corecvs {
 
@@ -17,6 +19,22 @@ Cholesky::~Cholesky()
 {
 }
 
+/**
+ *  The semidefinite matrices, like the process noise of the constant velocity model, have the zero
+ *  pivots. The numerator A(i,j) - sum is zero as well then up to the rounding, and any value of U fits,
+ *  so zero is taken. Any other numerator over the zero pivot means the matrix is not semidefinite,
+ *  it is divided as before.
+ **/
+static const double ZERO_PIVOT_TOLERANCE = 1e-12;
+
+static inline double zeroPivotSafe(double value, double sum, double pivot)
+{
+    double numerator = value - sum;
+    if (pivot == 0.0 && fabs(numerator) <= ZERO_PIVOT_TOLERANCE * (fabs(value) + fabs(sum)))
+        return 0.0;
+    return numerator / pivot;
+}
+
 /**
  *
  *  \brief Cholesky UDUT decomposition.
@@ -80,7 +98,7 @@ void Cholesky::udutDecompose(Matrix *A, Matrix **Uresult, DiagonalMatrix **Dresu
     u->a(j,j) = 1.0;
     for (int i = 0; i < j; i ++)
     {
-        u->a(i, j) = A->a(i, j) / d->a(j);
+        u->a(i, j) = zeroPivotSafe(A->a(i, j), 0.0, d->a(j));
     }
     /* Recurrent continuation for columns */
 
@@ -103,7 +121,7 @@ void Cholesky::udutDecompose(Matrix *A, Matrix **Uresult, DiagonalMatrix **Dresu
                 double uik = u->a(i,k);
                 sum += d->a(k) * ujk * uik;
             }
-            u->a(i,j) = (A->a(i,j) - sum ) / d->a(j);
+            u->a(i,j) = zeroPivotSafe(A->a(i,j), sum, d->a(j));
         }
 
         u->a(j,j) = 1.0;
@@ -138,7 +156,7 @@ void Cholesky::udutDecompose(Matrix *A, UpperUnitaryMatrix **Uresult, DiagonalMa
     d->a(j) = A->a(j,j);
     for (int i = 0; i < j; i ++)
     {
-        u->u(i, j) = A->a(i, j) / d->a(j);
+        u->u(i, j) = zeroPivotSafe(A->a(i, j), 0.0, d->a(j));
     }
     /* Recurrent continuation for columns */
 
@@ -161,7 +179,7 @@ void Cholesky::udutDecompose(Matrix *A, UpperUnitaryMatrix **Uresult, DiagonalMa
                 double uik = u->a(i,k);
                 sum += d->a(k) * ujk * uik;
             }
-            u->u(i,j) = (A->a(i,j) - sum ) / d->a(j);
+            u->u(i,j) = zeroPivotSafe(A->a(i,j), sum, d->a(j));
         }
     }
 
@@ -0,0 +1,331 @@
+#ifndef FIXEDKALMAN_H_
+#define FIXEDKALMAN_H_
+/**
+ * \file fixedKalman.h
+ * \brief Kalman filters of the fixed size
+ *
+ * \date Oct 19, 2026
+ */
+
+#include "global.h"
+
+#include "fixedVector.h"
+#include "fixedMatrix.h"
+#include "uduDecomposed.h"
+
+namespace corecvs {
+
+/**
+ *  Linear Kalman filter with the state and the measurement sizes known at compile time.
+ *
+ *  Unlike ClassicKalman everything is stored in place and the model is given by the matrices F and H,
+ *  so there are no allocations and no numeric differentiation in predict() and update(). For the
+ *  nonlinear model F and H could be set to the jacobians before each call, as the extended filter does.
+ *  The innovation covariance is not inverted, the gain is found by the LDL^T solve.
+ **/
+template<int stateSize, int measureSize>
+class FixedKalman
+{
+public:
+    typedef FixedVector<double, stateSize>              StateVector;
+    typedef FixedVector<double, measureSize>            MeasureVector;
+    typedef FixedMatrix<stateSize,   stateSize>         StateMatrix;
+    typedef FixedMatrix<measureSize, stateSize>         MeasureMatrix;
+    typedef FixedMatrix<measureSize, measureSize>       MeasureCovariance;
+    typedef FixedMatrix<stateSize,   measureSize>       GainMatrix;
+
+    /** Evolution and its noise */
+    StateMatrix       F;
+    StateMatrix       Q;
+    /** Measurement and its noise */
+    MeasureMatrix     H;
+    MeasureCovariance R;
+
+    StateVector       x;
+    StateMatrix       P;
+
+    FixedKalman() :
+        F(StateMatrix::Diagonal(1.0)),
+        Q(StateMatrix::Zero()),
+        H(MeasureMatrix::Diagonal(1.0)),
+        R(MeasureCovariance::Diagonal(1.0)),
+        x(0.0),
+        P(StateMatrix::Diagonal(1.0))
+    {}
+
+    /**
+     *  \f[ x_{k|k-1} = F x_{k-1|k-1} \f]
+     *  \f[ P_{k|k-1} = F P_{k-1|k-1} F^\top + Q \f]
+     **/
+    void predict()
+    {
+        x = F * x;
+        P = F * P * F.transposed() + Q;
+    }
+
+    /**
+     *  \f[ S = H P H^\top + R, \quad K = P H^\top S^{-1} \f]
+     *  \f[ x = x + K (z - H x), \quad P = P - K S K^\top \f]
+     *
+     *  Returns false and leaves the filter as is if S is not positive definite.
+     **/
+    bool update(const MeasureVector &z)
+    {
+        GainMatrix        PHt = P * H.transposed();
+        MeasureCovariance S   = H * PHt + R;
+
+        /* K S = P H^T, S is symmetric, so the rows of K are solved with the same factorization */
+        MeasureCovariance L;
+        MeasureVector     D;
+        if (!ldltDecompose(S, L, D))
+            return false;
+
+        GainMatrix K;
+        for (int r = 0; r < stateSize; r++)
+        {
+            double row[measureSize];
+            for (int i = 0; i < measureSize; i++)
+                row[i] = PHt.a(r, i);
+            ldltSolve(L, D, row);
+            for (int i = 0; i < measureSize; i++)
+                K.a(r, i) = row[i];
+        }
+
+        x += K * (z - H * x);
+        /* K S K^T = K (P H^T)^T */
+        P -= K * PHt.transposed();
+        symmetrize(P);
+        return true;
+    }
+
+    /** S = L D L^T with the unit lower L. False if some pivot is not positive */
+    static bool ldltDecompose(const MeasureCovariance &S, MeasureCovariance &L, MeasureVector &D)
+    {
+        L = MeasureCovariance::Diagonal(1.0);
+        for (int j = 0; j < measureSize; j++)
+        {
+            double d = S.a(j, j);
+            for (int k = 0; k < j; k++)
+                d -= L.a(j, k) * L.a(j, k) * D[k];
+            if (!(d > 0.0))
+                return false;
+            D[j] = d;
+            for (int i = j + 1; i < measureSize; i++)
+            {
+                double sum = S.a(i, j);
+                for (int k = 0; k < j; k++)
+                    sum -= L.a(i, k) * L.a(j, k) * D[k];
+                L.a(i, j) = sum / d;
+            }
+        }
+        return true;
+    }
+
+    /** Replaces b with the solution of L D L^T x = b */
+    static void ldltSolve(const MeasureCovariance &L, const MeasureVector &D, double *b)
+    {
+        for (int i = 0; i < measureSize; i++)
+            for (int k = 0; k < i; k++)
+                b[i] -= L.a(i, k) * b[k];
+        for (int i = 0; i < measureSize; i++)
+            b[i] /= D[i];
+        for (int i = measureSize - 1; i >= 0; i--)
+            for (int k = i + 1; k < measureSize; k++)
+                b[i] -= L.a(k, i) * b[k];
+    }
+
+    static void symmetrize(StateMatrix &M)
+    {
+        for (int i = 0; i < stateSize; i++)
+        {
+            for (int j = i + 1; j < stateSize; j++)
+            {
+                double mean = (M.a(i, j) + M.a(j, i)) / 2.0;
+                M.a(i, j) = mean;
+                M.a(j, i) = mean;
+            }
+        }
+    }
+};
+
+/**
+ *  Square root Kalman filter of the fixed size in the U D U^T form.
+ *
+ *  The covariance is never formed, the unit upper triangular U and the diagonal D are propagated
+ *  instead, so the covariance stays positive semidefinite and symmetric even for the badly conditioned
+ *  problems and the long runs. The time update is the Thornton modified weighted Gram-Schmidt, the
+ *  measurement update is the Bierman scalar update, so the measurement noise should be diagonal.
+ *
+ *  The initial covariance and the process noise are factored once by UDUTDecomposed.
+ **/
+template<int stateSize, int measureSize>
+class FixedUDUKalman
+{
+public:
+    typedef FixedVector<double, stateSize>              StateVector;
+    typedef FixedVector<double, measureSize>            MeasureVector;
+    typedef FixedMatrix<stateSize,   stateSize>         StateMatrix;
+    typedef FixedMatrix<measureSize, stateSize>         MeasureMatrix;
+
+    StateMatrix   F;
+    MeasureMatrix H;
+    /** Variances of the independent measurements */
+    MeasureVector R;
+
+    StateVector   x;
+    /** P = U diag(D) U^T */
+    StateMatrix   U;
+    StateVector   D;
+
+    FixedUDUKalman() :
+        F(StateMatrix::Diagonal(1.0)),
+        H(MeasureMatrix::Diagonal(1.0)),
+        R(1.0),
+        x(0.0),
+        U(StateMatrix::Diagonal(1.0)),
+        D(1.0),
+        Uq(StateMatrix::Diagonal(1.0)),
+        Dq(0.0)
+    {}
+
+    void setCovariance(const StateMatrix &P)
+    {
+        factor(P, U, D);
+    }
+
+    void setProcessNoise(const StateMatrix &Q)
+    {
+        factor(Q, Uq, Dq);
+    }
+
+    StateMatrix covariance() const
+    {
+        StateMatrix UD;
+        for (int i = 0; i < stateSize; i++)
+            for (int j = 0; j < stateSize; j++)
+                UD.a(i, j) = U.a(i, j) * D[j];
+        return UD * U.transposed();
+    }
+
+    /**
+     *  The rows of W = [F U | Uq] are orthogonalized with the weights diag(D, Dq) starting from the last
+     *  one, the coefficients form the new U and the weighted norms form the new D.
+     **/
+    void predict()
+    {
+        x = F * x;
+
+        StateMatrix FU = F * U;
+        double W[stateSize][2 * stateSize];
+        double weight[2 * stateSize];
+        for (int i = 0; i < stateSize; i++)
+        {
+            for (int k = 0; k < stateSize; k++)
+            {
+                W[i][k]             = FU.a(i, k);
+                W[i][stateSize + k] = Uq.a(i, k);
+            }
+            weight[i]             = D[i];
+            weight[stateSize + i] = Dq[i];
+        }
+
+        U = StateMatrix::Diagonal(1.0);
+        for (int j = stateSize - 1; j >= 0; j--)
+        {
+            double d = 0.0;
+            for (int k = 0; k < 2 * stateSize; k++)
+                d += weight[k] * W[j][k] * W[j][k];
+            D[j] = d;
+            if (d <= 0.0)
+            {
+                for (int i = 0; i < j; i++)
+                    U.a(i, j) = 0.0;
+                continue;
+            }
+
+            for (int i = 0; i < j; i++)
+            {
+                double sum = 0.0;
+                for (int k = 0; k < 2 * stateSize; k++)
+                    sum += weight[k] * W[i][k] * W[j][k];
+                double u = sum / d;
+                U.a(i, j) = u;
+                for (int k = 0; k < 2 * stateSize; k++)
+                    W[i][k] -= u * W[j][k];
+            }
+        }
+    }
+
+    /** The measurements are processed one by one, false if some innovation variance is not positive */
+    bool update(const MeasureVector &z)
+    {
+        for (int m = 0; m < measureSize; m++)
+        {
+            double h[stateSize];
+            double y = z[m];
+            for (int i = 0; i < stateSize; i++)
+            {
+                h[i] = H.a(m, i);
+                y -= h[i] * x[i];
+            }
+
+            /* f = U^T h, g = D f */
+            double f[stateSize];
+            double g[stateSize];
+            for (int j = 0; j < stateSize; j++)
+            {
+                f[j] = h[j];
+                for (int k = 0; k < j; k++)
+                    f[j] += U.a(k, j) * h[k];
+                g[j] = D[j] * f[j];
+            }
+
+            double K[stateSize];
+            double alpha = R[m] + f[0] * g[0];
+            if (!(alpha > 0.0))
+                return false;
+            D[0] *= R[m] / alpha;
+            K[0] = g[0];
+            for (int j = 1; j < stateSize; j++)
+            {
+                double beta = alpha;
+                alpha += f[j] * g[j];
+                double lambda = -f[j] / beta;
+                D[j] *= beta / alpha;
+                for (int i = 0; i < j; i++)
+                {
+                    double u = U.a(i, j);
+                    U.a(i, j) = u + lambda * K[i];
+                    K[i] += g[j] * u;
+                }
+                K[j] = g[j];
+            }
+
+            for (int i = 0; i < stateSize; i++)
+                x[i] += K[i] * y / alpha;
+        }
+        return true;
+    }
+
+    /** A = Uout diag(Dout) Uout^T by UDUTDecomposed */
+    static void factor(const StateMatrix &A, StateMatrix &Uout, StateVector &Dout)
+    {
+        Matrix copy = A.toMatrix();
+        UDUTDecomposed udu(&copy);
+        for (int i = 0; i < stateSize; i++)
+        {
+            Dout[i] = udu.diagonal->a(i);
+            for (int j = 0; j < stateSize; j++)
+                Uout.a(i, j) = udu.upper->a(i, j);
+        }
+    }
+
+private:
+    /** Factorization of the process noise Q = Uq diag(Dq) Uq^T */
+    StateMatrix Uq;
+    StateVector Dq;
+};
+
+} //namespace corecvs
+
+#endif /* FIXEDKALMAN_H_ */
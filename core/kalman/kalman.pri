@@ -5,6 +5,8 @@ HEADERS += \
     kalman/uduDecomposed.h \
 #    kalman/kalman.h \ 
     kalman/classicKalman.h \ 
+    kalman/fixedKalman.h \
+    kalman/kalmanBank.h \
 
 
 SOURCES += \
@@ -0,0 +1,737 @@
+#ifndef KALMANBANK_H_
+#define KALMANBANK_H_
+/**
+ * \file kalmanBank.h
+ * \brief Many small Kalman filters of the same model updated together
+ *
+ * \date Oct 19, 2026
+ */
+
+#include <vector>
+
+#include "global.h"
+
+#include "fixedKalman.h"
+#ifdef WITH_SSE
+#include "doublex2.h"
+#endif
+
+namespace corecvs {
+
+using std::vector;
+
+/* Loads and stores of the lanes of the filters, the scalar versions are the tails and the non-SSE build */
+static inline void bankLoad (double &lane, const double *data) { lane = *data; }
+static inline void bankStore(const double &lane, double *data) { *data = lane; }
+#ifdef WITH_SSE
+static inline void bankLoad (Doublex2 &lane, const double *data) { lane = Doublex2(data); }
+static inline void bankStore(const Doublex2 &lane, double *data) { lane.save(data); }
+#endif
+
+/* 1 / d for the positive d and zero otherwise, without branches in the SSE version */
+static inline double bankPositiveInverse(const double &d) { return d > 0.0 ? 1.0 / d : 0.0; }
+#ifdef WITH_SSE
+static inline Doublex2 bankPositiveInverse(const Doublex2 &d)
+{
+    __m128d positive = _mm_cmpgt_pd(d.data, _mm_setzero_pd());
+    return Doublex2(_mm_and_pd(positive, _mm_div_pd(_mm_set1_pd(1.0), d.data)));
+}
+#endif
+
+/**
+ *  \brief Bank of the Kalman filters of the same model
+ *
+ *  The trackers of the objects usually share the motion and the measurement models and differ only in
+ *  the state and the covariance. The bank keeps the states and the upper triangles of the covariances in
+ *  the structure of arrays form, every value of all filters is one contiguous array. So predict() and
+ *  update() run over all filters at once, two filters per SSE register, with the shared model kept in
+ *  the registers and no branches.
+ *
+ *  The math is the one of FixedKalman. The indices of the filters are dense, remove() moves the last
+ *  filter into the hole.
+ **/
+template<int stateSize, int measureSize>
+class KalmanBank
+{
+public:
+    typedef FixedKalman<stateSize, measureSize>  FilterType;
+    typedef typename FilterType::StateVector       StateVector;
+    typedef typename FilterType::MeasureVector     MeasureVector;
+    typedef typename FilterType::StateMatrix       StateMatrix;
+    typedef typename FilterType::MeasureMatrix     MeasureMatrix;
+    typedef typename FilterType::MeasureCovariance MeasureCovariance;
+
+    static const int COVARIANCE_SIZE = stateSize * (stateSize + 1) / 2;
+#ifdef WITH_SSE
+    typedef Doublex2 Lane;
+#else
+    typedef double Lane;
+#endif
+    static const int LANES = sizeof(Lane) / sizeof(double);
+
+    StateMatrix       F;
+    StateMatrix       Q;
+    MeasureMatrix     H;
+    MeasureCovariance R;
+
+    KalmanBank() :
+        F(StateMatrix::Diagonal(1.0)),
+        Q(StateMatrix::Zero()),
+        H(MeasureMatrix::Diagonal(1.0)),
+        R(MeasureCovariance::Diagonal(1.0)),
+        mCount(0),
+        mCapacity(0)
+    {}
+
+    int size() const
+    {
+        return mCount;
+    }
+
+    /** Returns the index of the new filter */
+    int add(const StateVector &x, const StateMatrix &P)
+    {
+        if (mCount == mCapacity)
+            reserve(CORE_MAX(mCapacity * 2, 16));
+        int index = mCount++;
+        setState(index, x);
+        setCovariance(index, P);
+        return index;
+    }
+
+    void remove(int index)
+    {
+        int last = mCount - 1;
+        if (index != last)
+        {
+            setState(index, state(last));
+            setCovariance(index, covariance(last));
+        }
+        mCount--;
+    }
+
+    void clear()
+    {
+        mCount = 0;
+    }
+
+    StateVector state(int index) const
+    {
+        StateVector x;
+        for (int i = 0; i < stateSize; i++)
+            x[i] = mX[i][index];
+        return x;
+    }
+
+    void setState(int index, const StateVector &x)
+    {
+        for (int i = 0; i < stateSize; i++)
+            mX[i][index] = x[i];
+    }
+
+    StateMatrix covariance(int index) const
+    {
+        StateMatrix P;
+        for (int i = 0; i < stateSize; i++)
+            for (int j = i; j < stateSize; j++)
+                P.a(i, j) = P.a(j, i) = mP[packed(i, j)][index];
+        return P;
+    }
+
+    /** The upper triangle is used */
+    void setCovariance(int index, const StateMatrix &P)
+    {
+        for (int i = 0; i < stateSize; i++)
+            for (int j = i; j < stateSize; j++)
+                mP[packed(i, j)][index] = P.a(i, j);
+    }
+
+    void predict()
+    {
+        int vectorEnd = mCount - mCount % LANES;
+        predictLanes<Lane>  (0, vectorEnd);
+        predictLanes<double>(vectorEnd, mCount);
+    }
+
+    /**
+     *  z has the measurements of all filters by their indices. If valid is given, the filters with the
+     *  zero flag have no measurement and are left as predicted.
+     *  Returns false if the innovation covariance is not positive definite, the filters are not changed then.
+     **/
+    bool update(const MeasureVector *z, const uint8_t *valid = NULL)
+    {
+        MeasureCovariance L;
+        MeasureVector     D;
+        /* The covariance of the predicted measurement is positive semidefinite, so S is positive definite with R */
+        if (!FilterType::ldltDecompose(R, L, D))
+            return false;
+
+        /* Measurements are transposed into the lanes as the states are */
+        mZ.resize(measureSize * (size_t)mCapacity);
+        mValid.resize(mCapacity);
+        for (int k = 0; k < mCount; k++)
+        {
+            for (int m = 0; m < measureSize; m++)
+                mZ[m * (size_t)mCapacity + k] = z[k][m];
+            mValid[k] = (valid == NULL || valid[k]) ? 1.0 : 0.0;
+        }
+
+        int vectorEnd = mCount - mCount % LANES;
+        updateLanes<Lane>  (0, vectorEnd);
+        updateLanes<double>(vectorEnd, mCount);
+        return true;
+    }
+
+private:
+    int mCount;
+    int mCapacity;
+
+    vector<double> mX[stateSize];
+    vector<double> mP[COVARIANCE_SIZE];
+    vector<double> mZ;
+    vector<double> mValid;
+
+    static inline int packed(int i, int j)
+    {
+        if (i > j)
+        {
+            int tmp = i; i = j; j = tmp;
+        }
+        return i * stateSize - i * (i - 1) / 2 + (j - i);
+    }
+
+    void reserve(int capacity)
+    {
+        for (int i = 0; i < stateSize; i++)
+            mX[i].resize(capacity);
+        for (int i = 0; i < COVARIANCE_SIZE; i++)
+            mP[i].resize(capacity);
+        mCapacity = capacity;
+    }
+
+    template<typename LaneType>
+    void predictLanes(int begin, int end)
+    {
+        /* Local copies of the model, so the stores to the filters can not alias it */
+        const StateMatrix F = this->F;
+        const StateMatrix Q = this->Q;
+        for (int index = begin; index < end; index += (int)(sizeof(LaneType) / sizeof(double)))
+        {
+            LaneType x[stateSize];
+            LaneType P[stateSize][stateSize];
+            for (int i = 0; i < stateSize; i++)
+            {
+                bankLoad(x[i], &mX[i][index]);
+                for (int j = i; j < stateSize; j++)
+                {
+                    bankLoad(P[i][j], &mP[packed(i, j)][index]);
+                    P[j][i] = P[i][j];
+                }
+            }
+
+            for (int i = 0; i < stateSize; i++)
+            {
+                LaneType sum = LaneType(0.0);
+                for (int k = 0; k < stateSize; k++)
+                    sum += LaneType(F.a(i, k)) * x[k];
+                bankStore(sum, &mX[i][index]);
+            }
+
+            /* T = F P, then F P F^T + Q for the upper triangle */
+            LaneType T[stateSize][stateSize];
+            for (int i = 0; i < stateSize; i++)
+            {
+                for (int j = 0; j < stateSize; j++)
+                {
+                    LaneType sum = LaneType(0.0);
+                    for (int k = 0; k < stateSize; k++)
+                        sum += LaneType(F.a(i, k)) * P[k][j];
+                    T[i][j] = sum;
+                }
+            }
+            for (int i = 0; i < stateSize; i++)
+            {
+                for (int j = i; j < stateSize; j++)
+                {
+                    LaneType sum = LaneType(Q.a(i, j));
+                    for (int k = 0; k < stateSize; k++)
+                        sum += T[i][k] * LaneType(F.a(j, k));
+                    bankStore(sum, &mP[packed(i, j)][index]);
+                }
+            }
+        }
+    }
+
+    template<typename LaneType>
+    void updateLanes(int begin, int end)
+    {
+        const MeasureMatrix     H = this->H;
+        const MeasureCovariance R = this->R;
+        for (int index = begin; index < end; index += (int)(sizeof(LaneType) / sizeof(double)))
+        {
+            LaneType x[stateSize];
+            LaneType P[stateSize][stateSize];
+            for (int i = 0; i < stateSize; i++)
+            {
+                bankLoad(x[i], &mX[i][index]);
+                for (int j = i; j < stateSize; j++)
+                {
+                    bankLoad(P[i][j], &mP[packed(i, j)][index]);
+                    P[j][i] = P[i][j];
+                }
+            }
+
+            /* P H^T and S = H P H^T + R */
+            LaneType PHt[stateSize][measureSize];
+            for (int i = 0; i < stateSize; i++)
+            {
+                for (int m = 0; m < measureSize; m++)
+                {
+                    LaneType sum = LaneType(0.0);
+                    for (int k = 0; k < stateSize; k++)
+                        sum += P[i][k] * LaneType(H.a(m, k));
+                    PHt[i][m] = sum;
+                }
+            }
+            LaneType S[measureSize][measureSize];
+            for (int m = 0; m < measureSize; m++)
+            {
+                for (int n = 0; n <= m; n++)
+                {
+                    LaneType sum = LaneType(R.a(m, n));
+                    for (int k = 0; k < stateSize; k++)
+                        sum += LaneType(H.a(m, k)) * PHt[k][n];
+                    S[m][n] = sum;
+                }
+            }
+
+            /* S = L D L^T in place, L below the diagonal and D on it */
+            for (int j = 0; j < measureSize; j++)
+            {
+                LaneType d = S[j][j];
+                for (int k = 0; k < j; k++)
+                    d -= S[j][k] * S[j][k] * S[k][k];
+                LaneType inverse = LaneType(1.0) / d;
+                for (int i = j + 1; i < measureSize; i++)
+                {
+                    LaneType sum = S[i][j];
+                    for (int k = 0; k < j; k++)
+                        sum -= S[i][k] * S[j][k] * S[k][k];
+                    S[i][j] = sum * inverse;
+                }
+                S[j][j] = d;
+            }
+
+            /* Innovation y = z - H x, zeroed for the filters with no measurement */
+            LaneType mask;
+            bankLoad(mask, &mValid[index]);
+            LaneType y[measureSize];
+            for (int m = 0; m < measureSize; m++)
+            {
+                LaneType sum;
+                bankLoad(sum, &mZ[m * (size_t)mCapacity + index]);
+                for (int k = 0; k < stateSize; k++)
+                    sum -= LaneType(H.a(m, k)) * x[k];
+                y[m] = sum;
+            }
+
+            /* Rows of K from S K^T = (P H^T)^T, masked so the missed filters keep their state */
+            LaneType K[stateSize][measureSize];
+            for (int i = 0; i < stateSize; i++)
+            {
+                LaneType *b = K[i];
+                for (int m = 0; m < measureSize; m++)
+                {
+                    b[m] = PHt[i][m];
+                    for (int k = 0; k < m; k++)
+                        b[m] -= S[m][k] * b[k];
+                }
+                for (int m = 0; m < measureSize; m++)
+                    b[m] = b[m] / S[m][m];
+                for (int m = measureSize - 1; m >= 0; m--)
+                {
+                    for (int k = m + 1; k < measureSize; k++)
+                        b[m] -= S[k][m] * b[k];
+                    b[m] = b[m] * mask;
+                }
+            }
+
+            for (int i = 0; i < stateSize; i++)
+            {
+                LaneType sum = x[i];
+                for (int m = 0; m < measureSize; m++)
+                    sum += K[i][m] * y[m];
+                bankStore(sum, &mX[i][index]);
+
+                /* P - K (P H^T)^T, symmetric, so only the upper triangle */
+                for (int j = i; j < stateSize; j++)
+                {
+                    LaneType value = P[i][j];
+                    for (int m = 0; m < measureSize; m++)
+                        value -= K[i][m] * PHt[j][m];
+                    bankStore(value, &mP[packed(i, j)][index]);
+                }
+            }
+        }
+    }
+};
+
+/**
+ *  \brief Bank of the square root Kalman filters of the same model
+ *
+ *  The U D U^T form of FixedUDUKalman in the structure of arrays layout of KalmanBank. Every filter keeps
+ *  the state, the strict upper triangle of the unit U and the diagonal D, the covariance is never formed.
+ *  predict() is the Thornton modified weighted Gram-Schmidt and update() is the Bierman scalar update,
+ *  both run over two filters per SSE register.
+ *
+ *  The measurement noise is diagonal, as in FixedUDUKalman. The filter with no measurement gets the zero
+ *  measurement row in the scalar updates, which leaves it exactly as predicted.
+ **/
+template<int stateSize, int measureSize>
+class UDUKalmanBank
+{
+public:
+    typedef FixedUDUKalman<stateSize, measureSize> FilterType;
+    typedef typename FilterType::StateVector       StateVector;
+    typedef typename FilterType::MeasureVector     MeasureVector;
+    typedef typename FilterType::StateMatrix       StateMatrix;
+    typedef typename FilterType::MeasureMatrix     MeasureMatrix;
+
+    static const int UPPER_SIZE = stateSize * (stateSize - 1) / 2;
+#ifdef WITH_SSE
+    typedef Doublex2 Lane;
+#else
+    typedef double Lane;
+#endif
+    static const int LANES = sizeof(Lane) / sizeof(double);
+
+    StateMatrix   F;
+    MeasureMatrix H;
+    /** Variances of the independent measurements */
+    MeasureVector R;
+
+    UDUKalmanBank() :
+        F(StateMatrix::Diagonal(1.0)),
+        H(MeasureMatrix::Diagonal(1.0)),
+        R(1.0),
+        mUq(StateMatrix::Diagonal(1.0)),
+        mDq(0.0),
+        mCount(0),
+        mCapacity(0)
+    {}
+
+    void setProcessNoise(const StateMatrix &Q)
+    {
+        FilterType::factor(Q, mUq, mDq);
+    }
+
+    int size() const
+    {
+        return mCount;
+    }
+
+    /** Returns the index of the new filter, P is factored by UDUTDecomposed */
+    int add(const StateVector &x, const StateMatrix &P)
+    {
+        if (mCount == mCapacity)
+            reserve(CORE_MAX(mCapacity * 2, 16));
+        int index = mCount++;
+        setState(index, x);
+        setCovariance(index, P);
+        return index;
+    }
+
+    void remove(int index)
+    {
+        int last = mCount - 1;
+        if (index != last)
+        {
+            for (int i = 0; i < stateSize; i++)
+            {
+                mX[i][index] = mX[i][last];
+                mD[i][index] = mD[i][last];
+            }
+            for (int i = 0; i < UPPER_SIZE; i++)
+                mU[i][index] = mU[i][last];
+        }
+        mCount--;
+    }
+
+    void clear()
+    {
+        mCount = 0;
+    }
+
+    StateVector state(int index) const
+    {
+        StateVector x;
+        for (int i = 0; i < stateSize; i++)
+            x[i] = mX[i][index];
+        return x;
+    }
+
+    void setState(int index, const StateVector &x)
+    {
+        for (int i = 0; i < stateSize; i++)
+            mX[i][index] = x[i];
+    }
+
+    /** The unit upper U and the diagonal D of the filter */
+    void factors(int index, StateMatrix &U, StateVector &D) const
+    {
+        U = StateMatrix::Diagonal(1.0);
+        for (int j = 0; j < stateSize; j++)
+        {
+            D[j] = mD[j][index];
+            for (int i = 0; i < j; i++)
+                U.a(i, j) = mU[upper(i, j)][index];
+        }
+    }
+
+    StateMatrix covariance(int index) const
+    {
+        StateMatrix U;
+        StateVector D;
+        factors(index, U, D);
+        StateMatrix UD;
+        for (int i = 0; i < stateSize; i++)
+            for (int j = 0; j < stateSize; j++)
+                UD.a(i, j) = U.a(i, j) * D[j];
+        return UD * U.transposed();
+    }
+
+    void setCovariance(int index, const StateMatrix &P)
+    {
+        StateMatrix U;
+        StateVector D;
+        FilterType::factor(P, U, D);
+        for (int j = 0; j < stateSize; j++)
+        {
+            mD[j][index] = D[j];
+            for (int i = 0; i < j; i++)
+                mU[upper(i, j)][index] = U.a(i, j);
+        }
+    }
+
+    void predict()
+    {
+        int vectorEnd = mCount - mCount % LANES;
+        predictLanes<Lane>  (0, vectorEnd);
+        predictLanes<double>(vectorEnd, mCount);
+    }
+
+    /**
+     *  z has the measurements of all filters by their indices. If valid is given, the filters with the
+     *  zero flag have no measurement and are left as predicted.
+     *  Returns false if some measurement variance is not positive, the filters are not changed then.
+     **/
+    bool update(const MeasureVector *z, const uint8_t *valid = NULL)
+    {
+        for (int m = 0; m < measureSize; m++)
+            if (!(R[m] > 0.0))
+                return false;
+
+        mZ.resize(measureSize * (size_t)mCapacity);
+        mValid.resize(mCapacity);
+        for (int k = 0; k < mCount; k++)
+        {
+            bool measured = (valid == NULL || valid[k]);
+            for (int m = 0; m < measureSize; m++)
+                mZ[m * (size_t)mCapacity + k] = measured ? z[k][m] : 0.0;
+            mValid[k] = measured ? 1.0 : 0.0;
+        }
+
+        int vectorEnd = mCount - mCount % LANES;
+        updateLanes<Lane>  (0, vectorEnd);
+        updateLanes<double>(vectorEnd, mCount);
+        return true;
+    }
+
+private:
+    /* Factorization of the process noise Q = Uq diag(Dq) Uq^T */
+    StateMatrix mUq;
+    StateVector mDq;
+
+    int mCount;
+    int mCapacity;
+
+    vector<double> mX[stateSize];
+    /* UPPER_SIZE may be zero for the scalar state */
+    vector<double> mU[UPPER_SIZE + 1];
+    vector<double> mD[stateSize];
+    vector<double> mZ;
+    vector<double> mValid;
+
+    /* Index of U(i, j), i < j, in the strict upper triangle stored by columns */
+    static inline int upper(int i, int j)
+    {
+        return j * (j - 1) / 2 + i;
+    }
+
+    void reserve(int capacity)
+    {
+        for (int i = 0; i < stateSize; i++)
+        {
+            mX[i].resize(capacity);
+            mD[i].resize(capacity);
+        }
+        for (int i = 0; i < UPPER_SIZE; i++)
+            mU[i].resize(capacity);
+        mCapacity = capacity;
+    }
+
+    template<typename LaneType>
+    void loadFactors(int index, LaneType U[stateSize][stateSize], LaneType D[stateSize]) const
+    {
+        for (int j = 0; j < stateSize; j++)
+        {
+            bankLoad(D[j], &mD[j][index]);
+            for (int i = 0; i < j; i++)
+                bankLoad(U[i][j], &mU[upper(i, j)][index]);
+            U[j][j] = LaneType(1.0);
+            for (int i = j + 1; i < stateSize; i++)
+                U[i][j] = LaneType(0.0);
+        }
+    }
+
+    /* The same steps as FixedUDUKalman::predict(), the zero weighted norm gives the zero column of U */
+    template<typename LaneType>
+    void predictLanes(int begin, int end)
+    {
+        const StateMatrix F  = this->F;
+        const StateMatrix Uq = mUq;
+        const StateVector Dq = mDq;
+        for (int index = begin; index < end; index += (int)(sizeof(LaneType) / sizeof(double)))
+        {
+            LaneType x[stateSize];
+            LaneType U[stateSize][stateSize];
+            LaneType weight[2 * stateSize];
+            for (int i = 0; i < stateSize; i++)
+                bankLoad(x[i], &mX[i][index]);
+            loadFactors(index, U, weight);
+
+            for (int i = 0; i < stateSize; i++)
+            {
+                LaneType sum = LaneType(0.0);
+                for (int k = 0; k < stateSize; k++)
+                    sum += LaneType(F.a(i, k)) * x[k];
+                bankStore(sum, &mX[i][index]);
+                weight[stateSize + i] = LaneType(Dq[i]);
+            }
+
+            /* W = [F U | Uq], the columns of U above the diagonal are skipped */
+            LaneType W[stateSize][2 * stateSize];
+            for (int i = 0; i < stateSize; i++)
+            {
+                for (int k = 0; k < stateSize; k++)
+                {
+                    LaneType sum = LaneType(F.a(i, k));
+                    for (int l = 0; l < k; l++)
+                        sum += LaneType(F.a(i, l)) * U[l][k];
+                    W[i][k] = sum;
+                    W[i][stateSize + k] = LaneType(Uq.a(i, k));
+                }
+            }
+
+            for (int j = stateSize - 1; j >= 0; j--)
+            {
+                LaneType d = LaneType(0.0);
+                for (int k = 0; k < 2 * stateSize; k++)
+                    d += weight[k] * W[j][k] * W[j][k];
+                bankStore(d, &mD[j][index]);
+                LaneType inverse = bankPositiveInverse(d);
+
+                LaneType weighted[2 * stateSize];
+                for (int k = 0; k < 2 * stateSize; k++)
+                    weighted[k] = weight[k] * W[j][k];
+                for (int i = 0; i < j; i++)
+                {
+                    LaneType sum = LaneType(0.0);
+                    for (int k = 0; k < 2 * stateSize; k++)
+                        sum += weighted[k] * W[i][k];
+                    LaneType u = sum * inverse;
+                    bankStore(u, &mU[upper(i, j)][index]);
+                    for (int k = 0; k < 2 * stateSize; k++)
+                        W[i][k] -= u * W[j][k];
+                }
+            }
+        }
+    }
+
+    /* The same steps as FixedUDUKalman::update(), one measurement at a time */
+    template<typename LaneType>
+    void updateLanes(int begin, int end)
+    {
+        const MeasureMatrix H = this->H;
+        const MeasureVector R = this->R;
+        for (int index = begin; index < end; index += (int)(sizeof(LaneType) / sizeof(double)))
+        {
+            LaneType x[stateSize];
+            LaneType U[stateSize][stateSize];
+            LaneType D[stateSize];
+            for (int i = 0; i < stateSize; i++)
+                bankLoad(x[i], &mX[i][index]);
+            loadFactors(index, U, D);
+
+            LaneType mask;
+            bankLoad(mask, &mValid[index]);
+
+            for (int m = 0; m < measureSize; m++)
+            {
+                LaneType h[stateSize];
+                LaneType y;
+                bankLoad(y, &mZ[m * (size_t)mCapacity + index]);
+                for (int i = 0; i < stateSize; i++)
+                {
+                    h[i] = LaneType(H.a(m, i)) * mask;
+                    y -= h[i] * x[i];
+                }
+
+                LaneType f[stateSize];
+                LaneType g[stateSize];
+                for (int j = 0; j < stateSize; j++)
+                {
+                    f[j] = h[j];
+                    for (int k = 0; k < j; k++)
+                        f[j] += U[k][j] * h[k];
+                    g[j] = D[j] * f[j];
+                }
+
+                LaneType K[stateSize];
+                LaneType alpha = LaneType(R[m]) + f[0] * g[0];
+                D[0] *= LaneType(R[m]) / alpha;
+                K[0] = g[0];
+                for (int j = 1; j < stateSize; j++)
+                {
+                    LaneType beta = alpha;
+                    alpha += f[j] * g[j];
+                    LaneType lambda = LaneType(0.0) - f[j] / beta;
+                    D[j] *= beta / alpha;
+                    for (int i = 0; i < j; i++)
+                    {
+                        LaneType u = U[i][j];
+                        U[i][j] = u + lambda * K[i];
+                        K[i] += g[j] * u;
+                    }
+                    K[j] = g[j];
+                }
+
+                LaneType step = y / alpha;
+                for (int i = 0; i < stateSize; i++)
+                    x[i] += K[i] * step;
+            }
+
+            for (int j = 0; j < stateSize; j++)
+            {
+                bankStore(x[j], &mX[j][index]);
+                bankStore(D[j], &mD[j][index]);
+                for (int i = 0; i < j; i++)
+                    bankStore(U[i][j], &mU[upper(i, j)][index]);
+            }
+        }
+    }
+};
+
+} //namespace corecvs
+
+#endif /* KALMANBANK_H_ */
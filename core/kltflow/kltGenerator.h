@@ -16,6 +16,7 @@
 #include "vector2d.h"
 #include "interpolator.h"
 #include "spatialGradient.h"
+#include "zoneTracer.h"
 #include "global.h"
 #include "mathUtils.h"
 #include "mipmapPyramid.h"
@@ -147,6 +148,7 @@ public:
             G12Buffer *second
             )
     {
+        TRACE_ZONE("KLTGenerator::calculateHierarchicalKLTFlow");
         ASSERT_TRUE(first  != NULL, "Arguments should not be null");
         ASSERT_TRUE(second != NULL, "Arguments should not be null");
 
@@ -15,6 +15,43 @@
 namespace corecvs
 {
 
+/**
+ *   Division by the constant. The signed integers are divided with the rounding to minus infinity,
+ *   as the arithmetic shift of the SSE div() does, so the scalar tails of the kernels give the same result
+ *   as the vectorized columns.
+ **/
+template<int divisor, class DividableType>
+class GenericDivider
+{
+public:
+    static DividableType div(const DividableType &val)
+    {
+        return DividableType(val / divisor);
+    }
+};
+
+template<int divisor>
+class GenericDivider<divisor, int16_t>
+{
+public:
+    static int16_t div(const int16_t &val)
+    {
+        int quotient = val / divisor;
+        return int16_t((val % divisor < 0) ? quotient - 1 : quotient);
+    }
+};
+
+template<int divisor>
+class GenericDivider<divisor, int32_t>
+{
+public:
+    static int32_t div(const int32_t &val)
+    {
+        int32_t quotient = val / divisor;
+        return (val % divisor < 0) ? quotient - 1 : quotient;
+    }
+};
+
 /**
  *   Some functions are not expressed with binary operators, so we need to add functions as
  *   static functions.
@@ -27,7 +64,7 @@ public:
 template <int divisor, class DividableType>
     static DividableType div(const DividableType &val)
     {
-        return DividableType(val / divisor);
+        return GenericDivider<divisor, DividableType>::div(val);
     }
 
 template <int multiplier>
@@ -3,6 +3,7 @@ HEADERS += \
     math/matrix/matrix.h \
     math/matrix/matrix33.h \
     math/matrix/matrix44.h \
+    math/matrix/fixedMatrix.h \
     math/matrix/diagonalMatrix.h \
     math/matrix/homographyReconstructor.h \
     math/matrix/matrixOperations.h \
@@ -28,6 +29,7 @@ HEADERS += \
     math/sse/int64x2.h \
     math/sse/int32x8.h \
     math/sse/float32x4.h \
+    math/sse/doublex2.h \
     math/sse/sseMath.h \
     math/sse/intBase16x8.h \
     math/sse/uInt16x8.h \
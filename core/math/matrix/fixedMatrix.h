@@ -0,0 +1,127 @@
+#ifndef FIXEDMATRIX_H_
+#define FIXEDMATRIX_H_
+/**
+ * \file fixedMatrix.h
+ * \brief Matrix with the sizes known at compile time
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#include "fixedVector.h"
+#include "matrix.h"
+
+namespace corecvs {
+
+/**
+ *  Row major matrix of h rows and w columns stored in place, like Matrix33 and Matrix44.
+ *  It is meant for the small matrices of the filters and the estimators, where the heap allocations of
+ *  Matrix dominate the arithmetics.
+ *
+ *  The inherited operators are elementwise, the matrix product is operator * with the other FixedMatrix
+ *  or FixedVector.
+ **/
+template<int h, int w>
+class FixedMatrix : public FixedVectorBase<FixedMatrix<h, w>, double, h * w>
+{
+public:
+    typedef FixedVectorBase<FixedMatrix<h, w>, double, h * w> BaseClass;
+
+    static const int H = h;
+    static const int W = w;
+    static const int ELEM_NUM = H * W;
+
+    FixedMatrix() {}
+
+    explicit FixedMatrix(const double *data) : BaseClass(data) {}
+
+    /** Matrix with the given value on the diagonal and zeroes elsewhere */
+    static FixedMatrix Diagonal(double value)
+    {
+        FixedMatrix result = Zero();
+        for (int i = 0; i < CORE_MIN(h, w); i++)
+            result.a(i, i) = value;
+        return result;
+    }
+
+    static FixedMatrix Zero()
+    {
+        FixedMatrix result;
+        for (int i = 0; i < ELEM_NUM; i++)
+            result.element[i] = 0.0;
+        return result;
+    }
+
+    /** The sizes of the matrix should match */
+    static FixedMatrix FromMatrix(const Matrix &matrix)
+    {
+        FixedMatrix result;
+        ASSERT_TRUE(matrix.h == h && matrix.w == w, "Wrong size of the matrix");
+        for (int i = 0; i < h; i++)
+            for (int j = 0; j < w; j++)
+                result.a(i, j) = matrix.a(i, j);
+        return result;
+    }
+
+    Matrix toMatrix() const
+    {
+        Matrix result(h, w);
+        for (int i = 0; i < h; i++)
+            for (int j = 0; j < w; j++)
+                result.a(i, j) = a(i, j);
+        return result;
+    }
+
+    inline double &a(int i, int j)
+    {
+        return this->element[i * w + j];
+    }
+
+    inline const double &a(int i, int j) const
+    {
+        return this->element[i * w + j];
+    }
+
+    FixedMatrix<w, h> transposed() const
+    {
+        FixedMatrix<w, h> result;
+        for (int i = 0; i < h; i++)
+            for (int j = 0; j < w; j++)
+                result.a(j, i) = a(i, j);
+        return result;
+    }
+
+    template<int w2>
+    FixedMatrix<h, w2> operator *(const FixedMatrix<w, w2> &that) const
+    {
+        FixedMatrix<h, w2> result;
+        for (int i = 0; i < h; i++)
+        {
+            for (int j = 0; j < w2; j++)
+            {
+                double sum = 0.0;
+                for (int k = 0; k < w; k++)
+                    sum += a(i, k) * that.a(k, j);
+                result.a(i, j) = sum;
+            }
+        }
+        return result;
+    }
+
+    FixedVector<double, h> operator *(const FixedVector<double, w> &vector) const
+    {
+        FixedVector<double, h> result;
+        for (int i = 0; i < h; i++)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < w; k++)
+                sum += a(i, k) * vector[k];
+            result[i] = sum;
+        }
+        return result;
+    }
+};
+
+} //namespace corecvs
+
+#endif  //FIXEDMATRIX_H_
@@ -0,0 +1,120 @@
+#ifndef DOUBLEX2_H_
+#define DOUBLEX2_H_
+/**
+ * \file doublex2.h
+ * \brief a wrapper around two packed double values
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#include <emmintrin.h>
+
+#include "global.h"
+
+namespace corecvs {
+
+class ALIGN_DATA(16) Doublex2
+{
+public:
+    __m128d data;
+
+    static const int SIZE = 2;
+
+    /* Constructors */
+    Doublex2() {}
+
+    /**
+    *  Copy constructor
+    **/
+    Doublex2(const Doublex2 &other) {
+        this->data = other.data;
+    }
+
+    /**
+    *  Constructor from intrinsic type
+    **/
+    explicit Doublex2(const __m128d &_data) {
+        this->data = _data;
+    }
+
+    /**
+    *  Fills the vector with 2 same double values
+    **/
+    explicit Doublex2(const double value) {
+        this->data = _mm_set1_pd(value);
+    }
+
+    /**
+    *  Loads 2 values from the unaligned memory
+    **/
+    explicit Doublex2(const double * const data_ptr) {
+        this->data = _mm_loadu_pd(data_ptr);
+    }
+
+    /**
+    *  Stores 2 values to the unaligned memory
+    **/
+    inline void save(double * const data_ptr) const {
+        _mm_storeu_pd(data_ptr, this->data);
+    }
+
+    inline Doublex2 sqrt() const
+    {
+        return Doublex2(_mm_sqrt_pd(this->data));
+    }
+
+    /* Arithmetics operations */
+    friend Doublex2 operator +(const Doublex2 &left, const Doublex2 &right);
+    friend Doublex2 operator -(const Doublex2 &left, const Doublex2 &right);
+
+    friend Doublex2 operator +=(Doublex2 &left, const Doublex2 &right);
+    friend Doublex2 operator -=(Doublex2 &left, const Doublex2 &right);
+
+    friend Doublex2 operator *(const Doublex2 &left, const Doublex2 &right);
+    friend Doublex2 operator /(const Doublex2 &left, const Doublex2 &right);
+
+    friend Doublex2 operator *=(Doublex2 &left, const Doublex2 &right);
+    friend Doublex2 operator /=(Doublex2 &left, const Doublex2 &right);
+};
+
+
+FORCE_INLINE Doublex2 operator +(const Doublex2 &left, const Doublex2 &right) {
+    return Doublex2(_mm_add_pd(left.data, right.data));
+}
+
+FORCE_INLINE Doublex2 operator -(const Doublex2 &left, const Doublex2 &right) {
+    return Doublex2(_mm_sub_pd(left.data, right.data));
+}
+
+FORCE_INLINE Doublex2 operator +=(Doublex2 &left, const Doublex2 &right) {
+    left.data = _mm_add_pd(left.data, right.data);
+    return left;
+}
+
+FORCE_INLINE Doublex2 operator -=(Doublex2 &left, const Doublex2 &right) {
+    left.data = _mm_sub_pd(left.data, right.data);
+    return left;
+}
+
+FORCE_INLINE Doublex2 operator *(const Doublex2 &left, const Doublex2 &right) {
+    return Doublex2(_mm_mul_pd(left.data, right.data));
+}
+
+FORCE_INLINE Doublex2 operator /(const Doublex2 &left, const Doublex2 &right) {
+    return Doublex2(_mm_div_pd(left.data, right.data));
+}
+
+FORCE_INLINE Doublex2 operator *=(Doublex2 &left, const Doublex2 &right) {
+    left.data = _mm_mul_pd(left.data, right.data);
+    return left;
+}
+
+FORCE_INLINE Doublex2 operator /=(Doublex2 &left, const Doublex2 &right) {
+    left.data = _mm_div_pd(left.data, right.data);
+    return left;
+}
+
+} //namespace corecvs
+
+#endif  //DOUBLEX2_H_
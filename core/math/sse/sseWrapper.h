@@ -21,6 +21,7 @@
 #include "uInt8x16.h"
 
 #include "float32x4.h"
+#include "doublex2.h"
 
 #include "sseMath.h"
 #endif //WITH_SSE
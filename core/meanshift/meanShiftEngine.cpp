@@ -0,0 +1,371 @@
+/**
+ * \file meanShiftEngine.cpp
+ * \brief Mean shift over the weight image with the moments from the integral images
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#include <math.h>
+#include <algorithm>
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+#include "meanShiftEngine.h"
+#include "tbbWrapper.h"
+
+namespace corecvs {
+
+/* Columns of the integral images accumulated by one task */
+static const int COLUMN_BLOCK = 256;
+
+MeanShiftEngine::MeanShiftEngine() :
+    mWeights(NULL),
+    mStride(0)
+{
+}
+
+MeanShiftEngine::~MeanShiftEngine()
+{
+    delete_safe(mWeights);
+}
+
+void MeanShiftEngine::setHistogram(const Histogram &target, int binBits)
+{
+    binBits = CORE_MAX(0, CORE_MIN(binBits, G12Buffer::BUFFER_BITS));
+    int bins = 1 << (G12Buffer::BUFFER_BITS - binBits);
+    vector<uint64_t> binned(bins, 0);
+    for (size_t i = 0; i < target.data.size(); i++)
+    {
+        int value = target.min + (int)i;
+        if (value >= 0 && value <= WEIGHT_MAX)
+            binned[value >> binBits] += target.data[i];
+    }
+
+    uint64_t maximum = *std::max_element(binned.begin(), binned.end());
+    mLut.resize(WEIGHT_MAX + 1);
+    for (int value = 0; value <= WEIGHT_MAX; value++)
+        mLut[value] = maximum == 0 ? 0 : (uint16_t)(binned[value >> binBits] * WEIGHT_MAX / maximum);
+}
+
+void MeanShiftEngine::resizeWeights(int h, int w)
+{
+    if (mWeights != NULL && mWeights->h == h && mWeights->w == w)
+        return;
+    delete_safe(mWeights);
+    mWeights = new G12Buffer(h, w, false);
+}
+
+class ParallelBackProject
+{
+    const G12Buffer *frame;
+    const uint16_t  *lut;
+    G12Buffer       *weights;
+
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        for (int i = r.begin(); i < r.end(); i++)
+        {
+            const uint16_t *in  = &frame->element(i, 0);
+            uint16_t       *out = &weights->element(i, 0);
+            for (int j = 0; j < frame->w; j++)
+                out[j] = lut[CORE_MIN(in[j], (uint16_t)MeanShiftEngine::WEIGHT_MAX)];
+        }
+    }
+
+    ParallelBackProject(const G12Buffer *_frame, const uint16_t *_lut, G12Buffer *_weights) :
+        frame(_frame), lut(_lut), weights(_weights)
+    {}
+};
+
+void MeanShiftEngine::backProject(const G12Buffer *frame)
+{
+    if (mLut.empty())
+    {
+        mLut.resize(WEIGHT_MAX + 1);
+        for (int value = 0; value <= WEIGHT_MAX; value++)
+            mLut[value] = value;
+    }
+    resizeWeights(frame->h, frame->w);
+    parallelable_for(0, frame->h, ParallelBackProject(frame, &mLut[0], mWeights));
+    buildIntegrals();
+}
+
+void MeanShiftEngine::setWeights(const G12Buffer *weights)
+{
+    resizeWeights(weights->h, weights->w);
+    for (int i = 0; i < weights->h; i++)
+        for (int j = 0; j < weights->w; j++)
+            mWeights->element(i, j) = CORE_MIN(weights->element(i, j), (uint16_t)WEIGHT_MAX);
+    buildIntegrals();
+}
+
+void MeanShiftEngine::setWeights(AbstractMeanShiftKernel *kernel, int h, int w)
+{
+    resizeWeights(h, w);
+    /* The kernels are not required to be thread safe */
+    kernel->setWindow(0, 0, w, h);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            mWeights->element(i, j) = (uint16_t)CORE_MIN(kernel->value(j, i), (unsigned)WEIGHT_MAX);
+    buildIntegrals();
+}
+
+/* Prefix sums along the rows, stored one row and one column below */
+class ParallelRowPrefix
+{
+    const G12Buffer *weights;
+    int       stride;
+    uint64_t *sum;
+    uint64_t *sumX;
+    uint64_t *sumY;
+
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        for (int i = r.begin(); i < r.end(); i++)
+        {
+            const uint16_t *row = &weights->element(i, 0);
+            size_t offset = (size_t)(i + 1) * stride;
+            uint64_t s  = 0;
+            uint64_t sx = 0;
+            sum [offset] = 0;
+            sumX[offset] = 0;
+            sumY[offset] = 0;
+            for (int j = 0; j < weights->w; j++)
+            {
+                s  += row[j];
+                sx += (uint64_t)j * row[j];
+                sum [offset + j + 1] = s;
+                sumX[offset + j + 1] = sx;
+                sumY[offset + j + 1] = s * i;
+            }
+        }
+    }
+
+    ParallelRowPrefix(const G12Buffer *_weights, int _stride, uint64_t *_sum, uint64_t *_sumX, uint64_t *_sumY) :
+        weights(_weights), stride(_stride), sum(_sum), sumX(_sumX), sumY(_sumY)
+    {}
+};
+
+/* The rows of the prefix sums are accumulated down the columns, the blocks of the columns are independent */
+class ParallelColumnAccumulate
+{
+    int       h;
+    int       stride;
+    uint64_t *tables[3];
+
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        for (int block = r.begin(); block < r.end(); block++)
+        {
+            int begin = block * COLUMN_BLOCK;
+            int end   = CORE_MIN(begin + COLUMN_BLOCK, stride);
+            for (int t = 0; t < 3; t++)
+            {
+                for (int i = 2; i <= h; i++)
+                {
+                    const uint64_t *up  = tables[t] + (size_t)(i - 1) * stride;
+                    uint64_t       *row = tables[t] + (size_t)i * stride;
+                    int j = begin;
+#ifdef WITH_SSE
+                    for (; j + 2 <= end; j += 2)
+                    {
+                        __m128i a = _mm_loadu_si128((const __m128i *)(row + j));
+                        __m128i b = _mm_loadu_si128((const __m128i *)(up  + j));
+                        _mm_storeu_si128((__m128i *)(row + j), _mm_add_epi64(a, b));
+                    }
+#endif
+                    for (; j < end; j++)
+                        row[j] += up[j];
+                }
+            }
+        }
+    }
+
+    ParallelColumnAccumulate(int _h, int _stride, uint64_t *sum, uint64_t *sumX, uint64_t *sumY) :
+        h(_h), stride(_stride)
+    {
+        tables[0] = sum;
+        tables[1] = sumX;
+        tables[2] = sumY;
+    }
+};
+
+void MeanShiftEngine::buildIntegrals()
+{
+    int h = mWeights->h;
+    int w = mWeights->w;
+    mStride = w + 1;
+    size_t size = (size_t)(h + 1) * mStride;
+    mSum .resize(size);
+    mSumX.resize(size);
+    mSumY.resize(size);
+    std::fill(mSum .begin(), mSum .begin() + mStride, 0);
+    std::fill(mSumX.begin(), mSumX.begin() + mStride, 0);
+    std::fill(mSumY.begin(), mSumY.begin() + mStride, 0);
+
+    parallelable_for(0, h, ParallelRowPrefix(mWeights, mStride, &mSum[0], &mSumX[0], &mSumY[0]));
+    int blocks = (mStride + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+    parallelable_for(0, blocks, ParallelColumnAccumulate(h, mStride, &mSum[0], &mSumX[0], &mSumY[0]));
+}
+
+void MeanShiftEngine::moments(int x1, int y1, int x2, int y2, uint64_t &m00, uint64_t &m10, uint64_t &m01) const
+{
+    m00 = m10 = m01 = 0;
+    if (mWeights == NULL)
+        return;
+    x1 = CORE_MAX(x1, 0);
+    y1 = CORE_MAX(y1, 0);
+    x2 = CORE_MIN(x2, mWeights->w);
+    y2 = CORE_MIN(y2, mWeights->h);
+    if (x1 >= x2 || y1 >= y2)
+        return;
+
+    size_t a = (size_t)y1 * mStride + x1;
+    size_t b = (size_t)y1 * mStride + x2;
+    size_t c = (size_t)y2 * mStride + x1;
+    size_t d = (size_t)y2 * mStride + x2;
+    m00 = mSum [d] - mSum [b] - mSum [c] + mSum [a];
+    m10 = mSumX[d] - mSumX[b] - mSumX[c] + mSumX[a];
+    m01 = mSumY[d] - mSumY[b] - mSumY[c] + mSumY[a];
+}
+
+class ParallelMeanShift
+{
+    const MeanShiftEngine *engine;
+    const vector<Rectangle<int32_t> > *windows;
+    vector<MeanShiftResult> *results;
+    int iterations;
+    int minimalMovement;
+
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        for (int k = r.begin(); k < r.end(); k++)
+        {
+            MeanShiftResult &result = (*results)[k];
+            result.window     = (*windows)[k];
+            result.center     = Vector2dd(0.0, 0.0);
+            result.weight     = 0;
+            result.iterations = 0;
+            result.converged  = false;
+
+            Vector2d<int32_t> &corner = result.window.corner;
+            const Vector2d<int32_t> &size = result.window.size;
+            for (int iteration = 0; iteration < iterations; iteration++)
+            {
+                uint64_t m00, m10, m01;
+                engine->moments(corner.x(), corner.y(), corner.x() + size.x(), corner.y() + size.y(), m00, m10, m01);
+                if (m00 == 0)
+                    break;
+
+                result.center = Vector2dd((double)m10 / m00, (double)m01 / m00);
+                result.weight = m00;
+                result.iterations = iteration + 1;
+
+                /* The window is centered at the centroid, the center of the pixels x..x+w-1 is x+(w-1)/2 */
+                int dx = (int)floor(result.center.x() - (size.x() - 1) / 2.0 + 0.5) - corner.x();
+                int dy = (int)floor(result.center.y() - (size.y() - 1) / 2.0 + 0.5) - corner.y();
+                if (abs(dx) <= minimalMovement && abs(dy) <= minimalMovement)
+                {
+                    result.converged = true;
+                    break;
+                }
+                corner += Vector2d<int32_t>(dx, dy);
+            }
+        }
+    }
+
+    ParallelMeanShift(const MeanShiftEngine *_engine, const vector<Rectangle<int32_t> > *_windows,
+                      vector<MeanShiftResult> *_results, int _iterations, int _minimalMovement) :
+        engine(_engine), windows(_windows), results(_results), iterations(_iterations), minimalMovement(_minimalMovement)
+    {}
+};
+
+void MeanShiftEngine::run(const vector<Rectangle<int32_t> > &windows, int iterations, int minimalMovement)
+{
+    mResults.resize(windows.size());
+    parallelable_for(0, (int)windows.size(), ParallelMeanShift(this, &windows, &mResults, iterations, minimalMovement));
+}
+
+vector<Rectangle<int32_t> > MeanShiftEngine::grid(int h, int w, int numberOfWindows, int overlay)
+{
+    vector<Rectangle<int32_t> > result;
+    if (numberOfWindows <= 0)
+        return result;
+
+    int windowW = w / numberOfWindows;
+    int windowH = h / numberOfWindows;
+    for (int j = 0; j < numberOfWindows; j++)
+    {
+        for (int i = 0; i < numberOfWindows; i++)
+        {
+            int x = j * windowW;
+            int y = i * windowH;
+            int minX = (j == 0) ? x : x - overlay;
+            int minY = (i == 0) ? y : y - overlay;
+            int maxX = (j == numberOfWindows - 1) ? w : x + windowW + overlay;
+            int maxY = (i == numberOfWindows - 1) ? h : y + windowH + overlay;
+            result.push_back(Rectangle<int32_t>(minX, minY, maxX - minX, maxY - minY));
+        }
+    }
+    return result;
+}
+
+/* Stronger first, the index keeps the order of the equal ones stable */
+class ResultWeightOrder
+{
+    const vector<MeanShiftResult> *results;
+
+public:
+    ResultWeightOrder(const vector<MeanShiftResult> *_results) : results(_results) {}
+
+    bool operator()(int a, int b) const
+    {
+        if ((*results)[a].weight != (*results)[b].weight)
+            return (*results)[a].weight > (*results)[b].weight;
+        return a < b;
+    }
+};
+
+vector<MeanShiftMode> MeanShiftEngine::modes(double mergeDistance) const
+{
+    vector<int> order;
+    for (size_t k = 0; k < mResults.size(); k++)
+        if (mResults[k].converged)
+            order.push_back((int)k);
+    std::sort(order.begin(), order.end(), ResultWeightOrder(&mResults));
+
+    vector<MeanShiftMode> result;
+    for (size_t k = 0; k < order.size(); k++)
+    {
+        const MeanShiftResult &window = mResults[order[k]];
+        bool merged = false;
+        for (size_t m = 0; m < result.size(); m++)
+        {
+            if ((result[m].center - window.center).l2Metric() < mergeDistance)
+            {
+                result[m].windows++;
+                merged = true;
+                break;
+            }
+        }
+        if (merged)
+            continue;
+
+        MeanShiftMode mode;
+        mode.center    = window.center;
+        mode.weight    = window.weight;
+        mode.windows   = 1;
+        mode.strongest = order[k];
+        result.push_back(mode);
+    }
+    return result;
+}
+
+} //namespace corecvs
@@ -0,0 +1,136 @@
+#ifndef MEANSHIFTENGINE_H_
+#define MEANSHIFTENGINE_H_
+/**
+ * \file meanShiftEngine.h
+ * \brief Mean shift over the weight image with the moments from the integral images
+ *
+ * \ingroup cppcorefiles
+ * \date Oct 19, 2026
+ */
+
+#include <stdint.h>
+#include <vector>
+
+#include "global.h"
+
+#include "g12Buffer.h"
+#include "histogram.h"
+#include "rectangle.h"
+#include "vector2d.h"
+#include "abstractMeanShiftKernel.h"
+
+namespace corecvs {
+
+using std::vector;
+
+/** Window after the mean shift */
+struct MeanShiftResult
+{
+    Rectangle<int32_t> window;
+    /** Centroid of the weights in the final window */
+    Vector2dd center;
+    /** Sum of the weights in the final window */
+    uint64_t  weight;
+    int       iterations;
+    /** The window has stopped moving; false if it has lost all weight or run out of iterations */
+    bool      converged;
+};
+
+/** Converged windows that came to the same place */
+struct MeanShiftMode
+{
+    /** Center and weight of the strongest window of the mode, the overlapping windows are not summed */
+    Vector2dd center;
+    uint64_t  weight;
+    /** Number of the windows merged into the mode */
+    int       windows;
+    /** Index of the strongest window of the mode in MeanShiftEngine::results() */
+    int       strongest;
+};
+
+/**
+ *  \brief Mean shift engine for the many windows over one frame
+ *
+ *  The weights of the frame are computed once, either as the back projection of the target histogram or
+ *  by evaluating AbstractMeanShiftKernel once per pixel. Then the integral images of w, x w and y w are
+ *  built, so the zero and the first moments of any window take 12 reads and an iteration costs the same
+ *  for any window size. The windows are moved to convergence independently, in parallel.
+ *
+ *  Unlike MeanShiftCalculator the weight does not depend on the window, so the kernels that use
+ *  setWindow() to weight the pixels by the position in the window need the old calculator.
+ **/
+class MeanShiftEngine
+{
+public:
+    static const int WEIGHT_MAX = G12Buffer::BUFFER_MAX_VALUE;
+
+    MeanShiftEngine();
+    ~MeanShiftEngine();
+
+    /**
+     *  Back projection table of the target histogram of the 12 bit values. The histogram is summed into
+     *  the bins of 2^binBits values and scaled so the largest bin gets WEIGHT_MAX. The table is cached
+     *  and used by all following backProject() calls.
+     **/
+    void setHistogram(const Histogram &target, int binBits = 6);
+
+    /** Weights of the frame from the cached table, then the integral images. Before setHistogram() the weight is the value */
+    void backProject(const G12Buffer *frame);
+
+    /** Weights given as is, the values should not exceed WEIGHT_MAX */
+    void setWeights(const G12Buffer *weights);
+
+    /** Weights of the area of the frame from the kernel, the window of the kernel is set to the whole area */
+    void setWeights(AbstractMeanShiftKernel *kernel, int h, int w);
+
+    /** Weights of the last frame, NULL before the first one */
+    const G12Buffer *weights() const
+    {
+        return mWeights;
+    }
+
+    /** Zero and first moments of the weights in the rectangle clipped by the frame */
+    void moments(int x1, int y1, int x2, int y2, uint64_t &m00, uint64_t &m10, uint64_t &m01) const;
+
+    /**
+     *  Moves all windows in parallel until the shift is not more than minimalMovement pixels
+     *  along both axes or the iterations are over.
+     **/
+    void run(const vector<Rectangle<int32_t> > &windows, int iterations = 20, int minimalMovement = 0);
+
+    /**
+     *  The grid of numberOfWindows x numberOfWindows windows over the frame, the neighbours overlap
+     *  by overlay pixels, as MeanShiftCalculator places them.
+     **/
+    static vector<Rectangle<int32_t> > grid(int h, int w, int numberOfWindows, int overlay);
+
+    const vector<MeanShiftResult> &results() const
+    {
+        return mResults;
+    }
+
+    /**
+     *  Converged windows with the centers closer than mergeDistance are merged, starting from the
+     *  strongest ones. The modes are sorted by the weight.
+     **/
+    vector<MeanShiftMode> modes(double mergeDistance) const;
+
+private:
+    vector<uint16_t> mLut;
+    G12Buffer       *mWeights;
+
+    /* Integral images of w, x w and y w with the zero row and column, row major */
+    int              mStride;
+    vector<uint64_t> mSum;
+    vector<uint64_t> mSumX;
+    vector<uint64_t> mSumY;
+
+    vector<MeanShiftResult> mResults;
+
+    void buildIntegrals();
+    void resizeWeights(int h, int w);
+};
+
+} //namespace corecvs
+
+#endif /* MEANSHIFTENGINE_H_ */
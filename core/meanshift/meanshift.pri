@@ -2,9 +2,11 @@ HEADERS += \
     meanshift/meanShiftCalculator.h \
     meanshift/meanShiftWindow.h \
     meanshift/abstractMeanShiftKernel.h \
+    meanshift/meanShiftEngine.h \
 
 
 SOURCES += \
     meanshift/meanShiftCalculator.cpp \
     meanshift/meanShiftWindow.cpp \
+    meanshift/meanShiftEngine.cpp \
 
@@ -0,0 +1,630 @@
+/**
+ * \file batchTriangulator.cpp
+ * \brief Triangulation of the whole disparity rows with the float vector math
+ *
+ * \date Oct 19, 2026
+ */
+
+#include <math.h>
+
+#include "global.h"
+
+#include "batchTriangulator.h"
+#include "tbbWrapper.h"
+#ifdef WITH_SSE
+#include "sseWrapper.h"
+#endif
+
+namespace corecvs {
+
+static Vector3dd matrixColumn(const Matrix33 &matrix, int column)
+{
+    return Vector3dd(matrix.a(0, column), matrix.a(1, column), matrix.a(2, column));
+}
+
+BatchTriangulator::BatchTriangulator(const Triangulator &triangulator)
+{
+    const RectificationResult &data = triangulator.rectifierData;
+    Matrix33 right = triangulator.rectifiedToCameraFrameRight;
+    Matrix33 left  = data.decomposition.rotation * triangulator.rectifiedToCameraFrameLeft;
+
+    for (int i = 0; i < 3; i++)
+    {
+        mRight[i] = matrixColumn(right, i);
+        mLeft [i] = matrixColumn(left , i);
+    }
+
+    mCrossXX = mRight[0] ^ mLeft[0];
+    mCrossYY = mRight[1] ^ mLeft[1];
+    mCross11 = mRight[2] ^ mLeft[2];
+    mCrossXY = (mRight[0] ^ mLeft[1]) + (mRight[1] ^ mLeft[0]);
+    mCrossX1 = (mRight[0] ^ mLeft[2]) + (mRight[2] ^ mLeft[0]);
+    mCrossY1 = (mRight[1] ^ mLeft[2]) + (mRight[2] ^ mLeft[1]);
+
+    mDirection = data.decomposition.direction;
+    mBaseline  = data.baseline;
+
+    /* Rectified case - no rotation, shift along x and the same affine transform that keeps the rows */
+    const double epsilon = 1e-12;
+    double scale = 0.0;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            scale = CORE_MAX(scale, fabs(right.a(i, j)));
+
+    mRectified = fabs(mDirection.y()) < epsilon && fabs(mDirection.z()) < epsilon;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            mRectified = mRectified && fabs(data.decomposition.rotation.a(i, j) - (i == j ? 1.0 : 0.0)) < epsilon;
+            mRectified = mRectified && fabs(right.a(i, j) - left.a(i, j)) <= epsilon * scale;
+        }
+    }
+    mRectified = mRectified &&
+            fabs(right.a(2, 0)) <= epsilon * scale &&
+            fabs(right.a(2, 1)) <= epsilon * scale &&
+            fabs(right.a(1, 0)) <= epsilon * scale &&
+            fabs(right.a(2, 2)) >  epsilon * scale &&
+            fabs(right.a(0, 0)) >  epsilon * scale;
+
+    for (int k = 0; k < 6; k++)
+        mAffine[k] = 0.0;
+    mPointScale = 0.0;
+    mDepthScale = 0.0;
+    if (mRectified)
+    {
+        double norm = right.a(2, 2);
+        for (int k = 0; k < 6; k++)
+            mAffine[k] = right.a(k / 3, k % 3) / norm;
+        mPointScale = mBaseline / fabs(mAffine[0]);
+        mDepthScale = -mDirection.x() * mBaseline / mAffine[0];
+    }
+}
+
+static void toFloat(const Vector3dd &vector, float out[3])
+{
+    out[0] = (float)vector.x();
+    out[1] = (float)vector.y();
+    out[2] = (float)vector.z();
+}
+
+void BatchTriangulator::rowConstants(int y, RowConstants *k) const
+{
+    Vector3dd h0 = mRight[1] * (double)y + mRight[2];
+    Vector3dd m0 = mLeft [1] * (double)y + mLeft [2];
+
+    toFloat(h0, k->h0);
+    toFloat(mRight[0], k->h1);
+    toFloat(m0, k->m0);
+    toFloat(mLeft[0], k->m1);
+    toFloat(mLeft[1], k->mY);
+
+    toFloat(h0 ^ m0, k->c0);
+    toFloat((h0 ^ mLeft[0]) + (mRight[0] ^ m0), k->c1);
+    toFloat(mRight[0] ^ mLeft[0], k->c2);
+    toFloat(mDirection, k->direction);
+    k->baseline = (float)mBaseline;
+
+    k->a = (float)mAffine[0];
+    k->b = (float)(mAffine[1] * y + mAffine[2]);
+    k->c = (float)(mAffine[4] * y + mAffine[5]);
+    k->pointScale = (float)mPointScale;
+    k->depthScale = (float)mDepthScale;
+}
+
+/* The lane operations for float and Float32x4, so the same kernel serves the vector body and the tail */
+
+static inline float laneSqrt(float value)                { return sqrtf(value); }
+static inline float laneAbs (float value)                { return fabsf(value); }
+static inline float laneSign(float value, float sign)    { return sign < 0.0f ? -value : value; }
+static inline void  laneStore(float *data, float value)  { *data = value; }
+
+template<typename T> static inline T laneLoad(const float *data);
+template<typename T> static inline T laneIndex(int index);
+
+template<> inline float laneLoad<float>(const float *data) { return *data; }
+template<> inline float laneIndex<float>(int index)        { return (float)index; }
+
+#ifdef WITH_SSE
+static inline Float32x4 laneSqrt(const Float32x4 &value) { return value.sqrt(); }
+static inline Float32x4 laneAbs (const Float32x4 &value)
+{
+    return Float32x4(_mm_andnot_ps(_mm_set1_ps(-0.0f), value.data));
+}
+/* value is not negative, the sign bit is just copied */
+static inline Float32x4 laneSign(const Float32x4 &value, const Float32x4 &sign)
+{
+    return Float32x4(_mm_or_ps(value.data, _mm_and_ps(sign.data, _mm_set1_ps(-0.0f))));
+}
+static inline void laneStore(float *data, const Float32x4 &value) { _mm_storeu_ps(data, value.data); }
+
+template<> inline Float32x4 laneLoad<Float32x4>(const float *data) { return Float32x4(_mm_loadu_ps(data)); }
+template<> inline Float32x4 laneIndex<Float32x4>(int index)
+{
+    return Float32x4(_mm_add_ps(_mm_set1_ps((float)index), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f)));
+}
+#endif
+
+template<typename T>
+static inline T laneLoadOrZero(const float *data)
+{
+    return (data == NULL) ? T(0.0f) : laneLoad<T>(data);
+}
+
+/**
+ *  Row constants broadcast to the lanes
+ **/
+template<typename T>
+struct RowLanes
+{
+    T h0[3], h1[3], m0[3], m1[3], mY[3], c0[3], c1[3], c2[3], d[3];
+    T baseline;
+    T a, b, c, pointScale, depthScale;
+
+    RowLanes(const BatchTriangulator::RowConstants &k) :
+        baseline(k.baseline),
+        a(k.a),
+        b(k.b),
+        c(k.c),
+        pointScale(k.pointScale),
+        depthScale(k.depthScale)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            h0[i] = T(k.h0[i]); h1[i] = T(k.h1[i]);
+            m0[i] = T(k.m0[i]); m1[i] = T(k.m1[i]); mY[i] = T(k.mY[i]);
+            c0[i] = T(k.c0[i]); c1[i] = T(k.c1[i]); c2[i] = T(k.c2[i]);
+            d [i] = T(k.direction[i]);
+        }
+    }
+
+    /** Rays of the right and left cameras and their cross product */
+    inline void rays(const T &x, const T &dx, const T &dy, T h[3], T m[3], T cross[3]) const
+    {
+        T delta[3];
+        for (int i = 0; i < 3; i++)
+        {
+            h[i]     = h0[i] + x * h1[i];
+            delta[i] = dx * m1[i] + dy * mY[i];
+            m[i]     = m0[i] + x * m1[i] + delta[i];
+        }
+        cross[0] = c0[0] + x * (c1[0] + x * c2[0]) + (h[1] * delta[2] - h[2] * delta[1]);
+        cross[1] = c0[1] + x * (c1[1] + x * c2[1]) + (h[2] * delta[0] - h[0] * delta[2]);
+        cross[2] = c0[2] + x * (c1[2] + x * c2[2]) + (h[0] * delta[1] - h[1] * delta[0]);
+    }
+
+    inline void point(const T &x, const T &dx, const T &dy, T &outX, T &outY, T &outZ) const
+    {
+        T h[3], m[3], cross[3];
+        rays(x, dx, dy, h, m, cross);
+        pointFromRays(h, m, cross, d, baseline, outX, outY, outZ);
+    }
+
+    inline T depth(const T &x, const T &dx, const T &dy) const
+    {
+        T h[3], m[3], cross[3];
+        rays(x, dx, dy, h, m, cross);
+        return depthFromRays(h, m, cross, d, baseline);
+    }
+
+    inline void rectifiedPoint(const T &x, const T &dx, T &outX, T &outY, T &outZ) const
+    {
+        T scale = pointScale / laneAbs(dx);
+        outX = (a * x + b) * scale;
+        outY = c * scale;
+        outZ = scale;
+    }
+
+    inline T rectifiedDepth(const T &dx) const
+    {
+        return depthScale / dx;
+    }
+
+    /** Point as in Triangulator::triangulate(), baseline * sign(h_z) * h * |m x d| / |h x m| */
+    static inline void pointFromRays(const T h[3], const T m[3], const T cross[3], const T d[3], const T &baseline, T &outX, T &outY, T &outZ)
+    {
+        T qx = m[1] * d[2] - m[2] * d[1];
+        T qy = m[2] * d[0] - m[0] * d[2];
+        T qz = m[0] * d[1] - m[1] * d[0];
+        T q2 = qx * qx + qy * qy + qz * qz;
+        T c2 = cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2];
+        T ratio = laneSign(laneSqrt(q2 / c2) * baseline, h[2]);
+        outX = h[0] * ratio;
+        outY = h[1] * ratio;
+        outZ = h[2] * ratio;
+    }
+
+    /** Depth as in Triangulator::getDepth(), baseline * h_z * (d, m x (h x m)) / |h x m|^2 */
+    static inline T depthFromRays(const T h[3], const T m[3], const T cross[3], const T d[3], const T &baseline)
+    {
+        T mcX = m[1] * cross[2] - m[2] * cross[1];
+        T mcY = m[2] * cross[0] - m[0] * cross[2];
+        T mcZ = m[0] * cross[1] - m[1] * cross[0];
+        T c2 = cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2];
+        return baseline * h[2] * (d[0] * mcX + d[1] * mcY + d[2] * mcZ) / c2;
+    }
+};
+
+static bool isHorizontal(int count, const float *dy)
+{
+    if (dy == NULL)
+        return true;
+    for (int j = 0; j < count; j++)
+    {
+        if (dy[j] != 0.0f)
+            return false;
+    }
+    return true;
+}
+
+template<typename T>
+static inline void pointStep(const RowLanes<T> &lanes, bool rectified, int j, const float *dx, const float *dy, float *outX, float *outY, float *outZ)
+{
+    T x = laneIndex<T>(j);
+    T dxLane = laneLoad<T>(dx + j);
+    T px, py, pz;
+    if (rectified)
+        lanes.rectifiedPoint(x, dxLane, px, py, pz);
+    else
+        lanes.point(x, dxLane, laneLoadOrZero<T>(dy == NULL ? NULL : dy + j), px, py, pz);
+    laneStore(outX + j, px);
+    laneStore(outY + j, py);
+    laneStore(outZ + j, pz);
+}
+
+template<typename T>
+static inline void depthStep(const RowLanes<T> &lanes, bool rectified, int j, const float *dx, const float *dy, float *depth)
+{
+    T dxLane = laneLoad<T>(dx + j);
+    if (rectified)
+        laneStore(depth + j, lanes.rectifiedDepth(dxLane));
+    else
+        laneStore(depth + j, lanes.depth(laneIndex<T>(j), dxLane, laneLoadOrZero<T>(dy == NULL ? NULL : dy + j)));
+}
+
+void BatchTriangulator::pointRow(int y, int count, const float *dx, const float *dy, float *outX, float *outY, float *outZ) const
+{
+    RowConstants k;
+    rowConstants(y, &k);
+    bool rectified = mRectified && isHorizontal(count, dy);
+
+    int j = 0;
+#ifdef WITH_SSE
+    RowLanes<Float32x4> wide(k);
+    for (; j + 8 <= count; j += 8)
+    {
+        pointStep(wide, rectified, j    , dx, dy, outX, outY, outZ);
+        pointStep(wide, rectified, j + 4, dx, dy, outX, outY, outZ);
+    }
+#endif
+    RowLanes<float> narrow(k);
+    for (; j < count; j++)
+        pointStep(narrow, rectified, j, dx, dy, outX, outY, outZ);
+}
+
+void BatchTriangulator::depthRow(int y, int count, const float *dx, const float *dy, float *depth) const
+{
+    RowConstants k;
+    rowConstants(y, &k);
+    bool rectified = mRectified && isHorizontal(count, dy);
+
+    int j = 0;
+#ifdef WITH_SSE
+    RowLanes<Float32x4> wide(k);
+    for (; j + 8 <= count; j += 8)
+    {
+        depthStep(wide, rectified, j    , dx, dy, depth);
+        depthStep(wide, rectified, j + 4, dx, dy, depth);
+    }
+#endif
+    RowLanes<float> narrow(k);
+    for (; j < count; j++)
+        depthStep(narrow, rectified, j, dx, dy, depth);
+}
+
+/**
+ *  For the arbitrary positions h x m without the shift is evaluated from the expansion in x and y
+ **/
+template<typename T>
+struct ScatterLanes
+{
+    T r[3][3], l[3][3], xx[3], yy[3], one[3], xy[3], x1[3], y1[3], d[3];
+    T baseline;
+
+    ScatterLanes(const Vector3dd right[3], const Vector3dd left[3], const Vector3dd cross[6], const Vector3dd &direction, double _baseline) :
+        baseline((float)_baseline)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                r[c][i] = T((float)right[c][i]);
+                l[c][i] = T((float)left [c][i]);
+            }
+            xx [i] = T((float)cross[0][i]);
+            yy [i] = T((float)cross[1][i]);
+            one[i] = T((float)cross[2][i]);
+            xy [i] = T((float)cross[3][i]);
+            x1 [i] = T((float)cross[4][i]);
+            y1 [i] = T((float)cross[5][i]);
+            d  [i] = T((float)direction[i]);
+        }
+    }
+
+    inline void point(const T &sx, const T &sy, const T &dx, const T &dy, T &outX, T &outY, T &outZ) const
+    {
+        T h[3], m[3], cross[3], delta[3];
+        for (int i = 0; i < 3; i++)
+        {
+            h[i]     = r[0][i] * sx + r[1][i] * sy + r[2][i];
+            delta[i] = l[0][i] * dx + l[1][i] * dy;
+            m[i]     = l[0][i] * sx + l[1][i] * sy + l[2][i] + delta[i];
+            cross[i] = xx[i] * sx * sx + yy[i] * sy * sy + one[i] + xy[i] * sx * sy + x1[i] * sx + y1[i] * sy;
+        }
+        cross[0] += h[1] * delta[2] - h[2] * delta[1];
+        cross[1] += h[2] * delta[0] - h[0] * delta[2];
+        cross[2] += h[0] * delta[1] - h[1] * delta[0];
+        RowLanes<T>::pointFromRays(h, m, cross, d, baseline, outX, outY, outZ);
+    }
+};
+
+void BatchTriangulator::points(int count, const float *sx, const float *sy, const float *dx, const float *dy, float *outX, float *outY, float *outZ) const
+{
+    Vector3dd cross[6] = { mCrossXX, mCrossYY, mCross11, mCrossXY, mCrossX1, mCrossY1 };
+
+    int j = 0;
+#ifdef WITH_SSE
+    ScatterLanes<Float32x4> wide(mRight, mLeft, cross, mDirection, mBaseline);
+    for (; j + 4 <= count; j += 4)
+    {
+        Float32x4 px, py, pz;
+        wide.point(laneLoad<Float32x4>(sx + j), laneLoad<Float32x4>(sy + j), laneLoad<Float32x4>(dx + j), laneLoadOrZero<Float32x4>(dy == NULL ? NULL : dy + j), px, py, pz);
+        laneStore(outX + j, px);
+        laneStore(outY + j, py);
+        laneStore(outZ + j, pz);
+    }
+#endif
+    ScatterLanes<float> narrow(mRight, mLeft, cross, mDirection, mBaseline);
+    for (; j < count; j++)
+        narrow.point(sx[j], sy[j], dx[j], dy == NULL ? 0.0f : dy[j], outX[j], outY[j], outZ[j]);
+}
+
+/**
+ *  Row workspace of the buffer level functions. The unknown pixels get the dummy shift, so the whole row is
+ *  computed and the known results are picked afterwards.
+ **/
+struct BatchRow
+{
+    vector<float> dx;
+    vector<float> dy;
+    vector<float> x;
+    vector<float> y;
+    vector<float> z;
+    vector<bool>  known;
+
+    BatchRow(int w) : dx(w), dy(w), x(w), y(w), z(w), known(w) {}
+
+    template<class InputType>
+    void gather(InputType *input, int i, bool enforceRectify)
+    {
+        for (int j = 0; j < input->w; j++)
+        {
+            known[j] = isTriangulable<InputType>(input, i, j);
+            Vector2dd shift = known[j] ? getInputDisparity<InputType>(input, i, j) : Vector2dd(1.0, 0.0);
+            dx[j] = (float)shift.x();
+            dy[j] = enforceRectify ? 0.0f : (float)shift.y();
+        }
+    }
+};
+
+template<class InputType>
+class ParallelBatchDepth
+{
+    const BatchTriangulator *batch;
+    InputType *input;
+    bool enforceRectify;
+    DepthBuffer *result;
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        BatchRow row(input->w);
+        for (int i = r.begin(); i < r.end(); i++)
+        {
+            row.gather(input, i, enforceRectify);
+            batch->depthRow(i, input->w, &row.dx[0], &row.dy[0], &row.z[0]);
+            for (int j = 0; j < input->w; j++)
+            {
+                if (row.known[j])
+                    result->element(i, j) = row.z[j];
+            }
+        }
+    }
+
+    ParallelBatchDepth(const BatchTriangulator *_batch, InputType *_input, bool _enforceRectify, DepthBuffer *_result) :
+        batch(_batch)
+      , input(_input)
+      , enforceRectify(_enforceRectify)
+      , result(_result)
+    {}
+};
+
+template<class InputType>
+DepthBuffer *BatchTriangulator::depthHelper(InputType *input, bool enforceRectify) const
+{
+    DepthBuffer *result = new DepthBuffer(input->h, input->w);
+    if (input->w > 0)
+        parallelable_for(0, input->h, ParallelBatchDepth<InputType>(this, input, enforceRectify, result));
+    return result;
+}
+
+DepthBuffer *BatchTriangulator::depth(DisparityBuffer *input, bool enforceRectify) const
+{
+    return depthHelper(input, enforceRectify);
+}
+
+DepthBuffer *BatchTriangulator::depth(FloatFlowBuffer *input, bool enforceRectify) const
+{
+    return depthHelper(input, enforceRectify);
+}
+
+template<class InputType>
+class ParallelBatchCloud
+{
+    const BatchTriangulator *batch;
+    InputType *input;
+    const vector<int> *offsets;
+    bool enforceRectify;
+    FloatCloud *result;
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        BatchRow row(input->w);
+        bool texture = result->hasChannel(FloatCloud::TEXTURE);
+        for (int i = r.begin(); i < r.end(); i++)
+        {
+            row.gather(input, i, enforceRectify);
+            batch->pointRow(i, input->w, &row.dx[0], enforceRectify ? NULL : &row.dy[0], &row.x[0], &row.y[0], &row.z[0]);
+
+            int index = (*offsets)[i];
+            for (int j = 0; j < input->w; j++)
+            {
+                if (!row.known[j])
+                    continue;
+                result->x[index] = row.x[j];
+                result->y[index] = row.y[j];
+                result->z[index] = row.z[j];
+                if (texture)
+                {
+                    result->texX[index] = (float)j;
+                    result->texY[index] = (float)i;
+                }
+                index++;
+            }
+        }
+    }
+
+    ParallelBatchCloud(const BatchTriangulator *_batch, InputType *_input, const vector<int> *_offsets, bool _enforceRectify, FloatCloud *_result) :
+        batch(_batch)
+      , input(_input)
+      , offsets(_offsets)
+      , enforceRectify(_enforceRectify)
+      , result(_result)
+    {}
+};
+
+template<class InputType>
+FloatCloud *BatchTriangulator::cloudHelper(InputType *input, bool enforceRectify, int channels) const
+{
+    FloatCloud *result = new FloatCloud(channels);
+    vector<int> offsets;
+    result->resize(rowOffsets(input, offsets));
+    if (input->w > 0)
+        parallelable_for(0, input->h, ParallelBatchCloud<InputType>(this, input, &offsets, enforceRectify, result));
+    return result;
+}
+
+FloatCloud *BatchTriangulator::cloud(DisparityBuffer *input, bool enforceRectify, int channels) const
+{
+    return cloudHelper(input, enforceRectify, channels);
+}
+
+FloatCloud *BatchTriangulator::cloud(FloatFlowBuffer *input, bool enforceRectify, int channels) const
+{
+    return cloudHelper(input, enforceRectify, channels);
+}
+
+/**
+ *  Current points go through the row path, the previous positions of the points with the flow
+ *  through the scattered one
+ **/
+class ParallelBatchCloud6D
+{
+    const BatchTriangulator *batch;
+    SixDBuffer *input;
+    const vector<int> *offsets;
+    FloatCloud *result;
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        BatchRow row(input->w);
+        vector<float> prevX, prevY, prevDisp, oldX, oldY, oldZ;
+        vector<int>   prevIndex;
+        bool texture = result->hasChannel(FloatCloud::TEXTURE);
+        bool speed   = result->hasChannel(FloatCloud::SPEED);
+
+        for (int i = r.begin(); i < r.end(); i++)
+        {
+            prevX.clear(); prevY.clear(); prevDisp.clear(); prevIndex.clear();
+            for (int j = 0; j < input->w; j++)
+            {
+                const Element6D &element = input->element(i, j);
+                row.known[j] = element.hasDisp() && element.disp > 0;
+                row.dx[j] = row.known[j] ? (float)element.disp : 1.0f;
+            }
+            batch->pointRow(i, input->w, &row.dx[0], NULL, &row.x[0], &row.y[0], &row.z[0]);
+
+            int index = (*offsets)[i];
+            for (int j = 0; j < input->w; j++)
+            {
+                if (!row.known[j])
+                    continue;
+                result->x[index] = row.x[j];
+                result->y[index] = row.y[j];
+                result->z[index] = row.z[j];
+                if (texture)
+                {
+                    result->texX[index] = (float)j;
+                    result->texY[index] = (float)i;
+                }
+
+                const Element6D &element = input->element(i, j);
+                if (speed && element.hasFlow() && element.hasPrevDisp() && element.dispPrev > 0)
+                {
+                    prevX.push_back((float)(j + element.flow.x()));
+                    prevY.push_back((float)(i + element.flow.y()));
+                    prevDisp.push_back((float)element.dispPrev);
+                    prevIndex.push_back(index);
+                }
+                index++;
+            }
+
+            if (prevIndex.empty())
+                continue;
+
+            int count = (int)prevIndex.size();
+            oldX.resize(count);
+            oldY.resize(count);
+            oldZ.resize(count);
+            batch->points(count, &prevX[0], &prevY[0], &prevDisp[0], NULL, &oldX[0], &oldY[0], &oldZ[0]);
+            for (int k = 0; k < count; k++)
+            {
+                int p = prevIndex[k];
+                result->speedX[p] = result->x[p] - oldX[k];
+                result->speedY[p] = result->y[p] - oldY[k];
+                result->speedZ[p] = result->z[p] - oldZ[k];
+                result->is6D  [p] = 1;
+            }
+        }
+    }
+
+    ParallelBatchCloud6D(const BatchTriangulator *_batch, SixDBuffer *_input, const vector<int> *_offsets, FloatCloud *_result) :
+        batch(_batch)
+      , input(_input)
+      , offsets(_offsets)
+      , result(_result)
+    {}
+};
+
+FloatCloud *BatchTriangulator::cloud(SixDBuffer *input, int channels) const
+{
+    FloatCloud *result = new FloatCloud(channels);
+    vector<int> offsets;
+    result->resize(rowOffsets(input, offsets));
+    if (input->w > 0)
+        parallelable_for(0, input->h, ParallelBatchCloud6D(this, input, &offsets, result));
+    return result;
+}
+
+} //namespace corecvs
+
+/* EOF */
@@ -0,0 +1,120 @@
+#pragma once
+/**
+ * \file batchTriangulator.h
+ * \brief Triangulation of the whole disparity rows with the float vector math
+ *
+ * \date Oct 19, 2026
+ */
+
+#include <vector>
+
+#include "global.h"
+
+#include "vector3d.h"
+#include "triangulator.h"
+#include "floatCloud.h"
+#include "depthBuffer.h"
+
+namespace corecvs {
+
+using std::vector;
+
+/**
+ *  Batch version of Triangulator.
+ *
+ *  The rays of the pixel (x, y) with the shift (dx, dy) are h = R (x, y, 1) for the right camera and
+ *  m = M (x + dx, y + dy, 1) for the left one, with R = rectifiedToCameraFrameRight and M = rotation * rectifiedToCameraFrameLeft.
+ *  Both the point of Triangulator::triangulate() and the depth of Triangulator::getDepth() depend only on the
+ *  directions of h and m, so the projective divisions are not needed. The cross product h x m is the small
+ *  difference of the large values, so its part without the shift is expanded in x and y with the coefficients
+ *  computed in double once per row.
+ *
+ *  The pixels are processed 8 at a time with SSE float math.
+ *
+ *  When the cameras are rectified (no rotation, shift along x, the same affine rectifying transforms) the
+ *  point is the right ray scaled by a constant over |dx|, and the depth is a constant over dx. Rows with the
+ *  horizontal disparities then take this fast path.
+ **/
+class BatchTriangulator
+{
+public:
+    BatchTriangulator(const Triangulator &triangulator);
+
+    bool isRectified() const
+    {
+        return mRectified;
+    }
+
+    /**
+     *  Pixels 0 .. count - 1 of the row y.
+     *  dy may be NULL for the horizontal disparity
+     **/
+    void depthRow(int y, int count, const float *dx, const float *dy, float *depth) const;
+    void pointRow(int y, int count, const float *dx, const float *dy, float *outX, float *outY, float *outZ) const;
+
+    /** Pixels at the arbitrary positions */
+    void points(int count, const float *sx, const float *sy, const float *dx, const float *dy, float *outX, float *outY, float *outZ) const;
+
+    DepthBuffer *depth(DisparityBuffer *input, bool enforceRectify = false) const;
+    DepthBuffer *depth(FloatFlowBuffer *input, bool enforceRectify = false) const;
+
+    FloatCloud *cloud(DisparityBuffer *input, bool enforceRectify = false, int channels = FloatCloud::TEXTURE) const;
+    FloatCloud *cloud(FloatFlowBuffer *input, bool enforceRectify = false, int channels = FloatCloud::TEXTURE) const;
+    FloatCloud *cloud(SixDBuffer *input, int channels = FloatCloud::TEXTURE | FloatCloud::SPEED) const;
+
+    /** Constants of the row in float */
+    struct RowConstants
+    {
+        /** h = h0 + x * h1 */
+        float h0[3];
+        float h1[3];
+        /** m = m0 + x * m1 + dx * m1 + dy * mY */
+        float m0[3];
+        float m1[3];
+        float mY[3];
+        /** h x (m0 + x * m1) = c0 + x * c1 + x^2 * c2 */
+        float c0[3];
+        float c1[3];
+        float c2[3];
+        float direction[3];
+        float baseline;
+
+        /* Fast path, right ray is (a * x + b, c, 1) */
+        float a;
+        float b;
+        float c;
+        float pointScale;
+        float depthScale;
+    };
+
+    void rowConstants(int y, RowConstants *constants) const;
+
+private:
+    /** Columns of R and M */
+    Vector3dd mRight[3];
+    Vector3dd mLeft[3];
+    /** Symmetric sums of R_i x M_j, the coefficients of h x m in x^2, y^2, 1, xy, x, y */
+    Vector3dd mCrossXX;
+    Vector3dd mCrossYY;
+    Vector3dd mCross11;
+    Vector3dd mCrossXY;
+    Vector3dd mCrossX1;
+    Vector3dd mCrossY1;
+
+    Vector3dd mDirection;
+    double    mBaseline;
+
+    bool   mRectified;
+    double mAffine[6];
+    double mPointScale;
+    double mDepthScale;
+
+    template<class InputType>
+    DepthBuffer *depthHelper(InputType *input, bool enforceRectify) const;
+    template<class InputType>
+    FloatCloud  *cloudHelper(InputType *input, bool enforceRectify, int channels) const;
+};
+
+} //namespace corecvs
+
+/* EOF */
@@ -12,6 +12,9 @@
 #include <algorithm>
 
 #include "global.h"
+
+#include "zoneTracer.h"
+
 namespace corecvs {
 
 using std::vector;
@@ -70,6 +73,7 @@ public:
 
     ModelType getModelRansac()
     {
+        TRACE_ZONE("Ransac::getModelRansac");
         bestInliers = 0;
         iteration = 0;
 
@@ -6,6 +6,7 @@ HEADERS += \
     rectification/ransacEstimator.h \
     rectification/stereoAligner.h \ 
     rectification/triangulator.h \
+    rectification/batchTriangulator.h \
     rectification/ransac.h \
 
 
@@ -17,4 +18,5 @@ SOURCES += \
     rectification/correspondanceList.cpp \
     rectification/stereoAligner.cpp \
     rectification/triangulator.cpp \
+    rectification/batchTriangulator.cpp \
 
@@ -7,6 +7,7 @@
  */
 
 #include "triangulator.h"
+#include "batchTriangulator.h"
 
 namespace corecvs {
 
@@ -82,40 +83,35 @@ double Triangulator::getDisparity(const Vector3dd &point) const
 }
 
 
-template<class Type>
-Vector2dd getInputDisparity(Type *input, int y, int x)
+static inline void storePoint(Cloud *cloud, int index, const Vector3dd &point, const Vector2dd &texCoor)
 {
-    return input->element(y,x);
+    SwarmPoint &cloudPoint = cloud->operator[](index);
+    cloudPoint.point   = point;
+    cloudPoint.texCoor = texCoor;
 }
 
-template<>
-Vector2dd getInputDisparity<DisparityBuffer>(DisparityBuffer *input, int y, int x)
+static inline void storeSpeed(Cloud *cloud, int index, const Vector3dd &speed, bool is6D)
 {
-    FlowElement *flowElement = &input->element(y,x);
-    return Vector2dd(flowElement->x(), flowElement->y());
+    SwarmPoint &cloudPoint = cloud->operator[](index);
+    cloudPoint.speed = speed;
+    cloudPoint.is6D  = is6D;
 }
 
-template<>
-Vector2dd getInputDisparity<FloatFlowBuffer>(FloatFlowBuffer *input, int y, int x)
-{
-    return input->element(y,x).vector;
-}
-
-
-template<class InputType>
+template<class InputType, class CloudType>
 class ParallelTriangulate
 {
     const Triangulator *realThis;
     InputType *input;
-    int density;
+    const vector<int> *offsets;
     bool enforceRectify;
+    CloudType *result;
 public:
-    Cloud *result;
-    void operator()( const BlockedRange<int>& r )
+    void operator()( const BlockedRange<int>& r ) const
     {
         int i, j;
         for (i = r.begin(); i < r.end(); i++)
         {
+            int index = (*offsets)[i];
             for (j = 0; j < input->w; j++)
             {
                 if (!input->isElementKnown(i, j))
@@ -128,98 +124,51 @@ public:
                 {
                     shift.y() = 0;
                 }
-                SwarmPoint cloudPoint;
-                cloudPoint.point = realThis->triangulate(start, shift);
-                cloudPoint.texCoor = start;
-                result->push_back(cloudPoint);
+                storePoint(result, index++, realThis->triangulate(start, shift), start);
             }
         }
     }
-#ifdef WITH_TBB
-    ParallelTriangulate( ParallelTriangulate& x, tbb::split ) :
-        realThis(x.realThis)
-      , input(x.input)
-      , density(x.density)
-      , enforceRectify(x.enforceRectify)
-    {
-        result = new Cloud();
-        result->reserve(10000);
-    }
 
-    void join( const ParallelTriangulate& y )
-    {
-        result->insert(result->end(), y.result->begin(), y.result->end());
-    }
-#endif
-    ParallelTriangulate(const Triangulator *_realThis, InputType *_input, int _density, bool _enforceRectify ) :
+    ParallelTriangulate(const Triangulator *_realThis, InputType *_input, const vector<int> *_offsets, bool _enforceRectify, CloudType *_result) :
         realThis(_realThis)
       , input(_input)
-      , density(_density)
+      , offsets(_offsets)
       , enforceRectify(_enforceRectify)
-    {
-        result = new Cloud();
-        result->reserve(10000);
-    }
-
-    ~ParallelTriangulate()
-    {
-        delete_safe(result);
-    }
+      , result(_result)
+    {}
 };
 
-template<class InputType>
-Cloud *Triangulator::triangulateHelperParallel (InputType *input,  int density, bool enforceRectify) const
+template<class InputType, class CloudType>
+void Triangulator::triangulateHelper (InputType *input, CloudType *result, bool enforceRectify) const
 {
-    ParallelTriangulate<InputType> tr(this, input, density, enforceRectify);
-
-    parallelable_reduce(0, input->h, tr);
-
-    return new Cloud(*(tr.result));
+    vector<int> offsets;
+    result->resize(rowOffsets(input, offsets));
+    parallelable_for(0, input->h, ParallelTriangulate<InputType, CloudType>(this, input, &offsets, enforceRectify, result));
 }
 
-template<class InputType>
-Cloud *Triangulator::triangulateHelper (InputType *input,  int density, bool enforceRectify) const
+/* The size is counted exactly, density is not used as the size hint any more */
+Cloud *Triangulator::triangulate (FlowBuffer *input,  int /*density*/, bool enforceRectify) const
 {
     Cloud *result = new Cloud();
-    result->reserve(density);
-
-    for (int i = 0; i < input->h; i++)
-    {
-        for (int j = 0; j < input->w; j++)
-        {
-            if (!input->isElementKnown(i, j))
-                continue;
-            /* Point in right frame*/
-            Vector2dd start(j,i);
-            Vector2dd shift;
-            shift = getInputDisparity<InputType>(input, i,j);
-            if (enforceRectify) {
-                shift.y() = 0;
-            }
+    triangulateHelper(input, result, enforceRectify);
+    return result;
+}
 
-            SwarmPoint cloudPoint;
-            cloudPoint.point = triangulate(start, shift);
-            cloudPoint.texCoor = start;
-            result->push_back(cloudPoint);
-        }
-    }
+Cloud *Triangulator::triangulate (FloatFlowBuffer *input,  int /*density*/, bool enforceRectify) const
+{
+    Cloud *result = new Cloud();
+    triangulateHelper(input, result, enforceRectify);
     return result;
 }
 
-Cloud *Triangulator::triangulate (FlowBuffer *input,  int density, bool enforceRectify) const
+FloatCloud *Triangulator::triangulateToFloatCloud (DisparityBuffer *input, bool enforceRectify, int channels) const
 {
-#ifdef WITH_TBB
-    return triangulateHelperParallel(input, density, enforceRectify);
-#endif
-    return triangulateHelper(input,  density, enforceRectify);
+    return BatchTriangulator(*this).cloud(input, enforceRectify, channels);
 }
 
-Cloud *Triangulator::triangulate (FloatFlowBuffer *input,  int density, bool enforceRectify) const
+FloatCloud *Triangulator::triangulateToFloatCloud (FloatFlowBuffer *input, bool enforceRectify, int channels) const
 {
-#ifdef WITH_TBB
-    return triangulateHelperParallel(input, density, enforceRectify);
-#endif
-    return triangulateHelper(input,  density, enforceRectify);
+    return BatchTriangulator(*this).cloud(input, enforceRectify, channels);
 }
 
 #if 0
@@ -282,77 +231,93 @@ Cloud *Triangulator::triangulate (FloatFlowBuffer *input,  int density, bool enf
 #endif
 
 
-Cloud *Triangulator::triangulate (SixDBuffer *input, int density) const
+template<class CloudType>
+class ParallelTriangulate6D
 {
-    Cloud *result = new Cloud();
-    result->reserve(density);
-
-    for (int i = 0; i < input->h; i++)
+    const Triangulator *realThis;
+    SixDBuffer *input;
+    const vector<int> *offsets;
+    CloudType *result;
+public:
+    void operator()( const BlockedRange<int>& r ) const
     {
-        for (int j = 0; j < input->w; j++)
+        for (int i = r.begin(); i < r.end(); i++)
         {
-            const Element6D &element = input->element(i,j);
-            if (!element.hasDisp() || element.disp <= 0)
-                continue;
-
-            /* Point in right frame*/
-            Vector2dd start(j,i);
-            Vector2dd shift = Vector2dd(element.disp, 0);
+            int index = (*offsets)[i];
+            for (int j = 0; j < input->w; j++)
+            {
+                const Element6D &element = input->element(i,j);
+                if (!element.hasDisp() || element.disp <= 0)
+                    continue;
 
-            SwarmPoint swarmPoint;
-            Vector3dd current3d = triangulate(start, shift);
-            swarmPoint.point = current3d;
-            swarmPoint.texCoor = start;
+                /* Point in right frame*/
+                Vector2dd start(j,i);
+                Vector2dd shift = Vector2dd(element.disp, 0);
 
-            /* Now 6D */
-            if (element.hasFlow())
-            {
-                /*Position at previous frame */
-                Vector2dd start1(start.x() + element.flow.x(), start.y() + element.flow.y());
-                Vector3dd old3d = current3d;
+                Vector3dd current3d = realThis->triangulate(start, shift);
+                storePoint(result, index, current3d, start);
 
-                if (element.hasPrevDisp() && element.dispPrev > 0)
+                /* Now 6D */
+                Vector3dd speed(0.0);
+                bool is6D = false;
+                if (element.hasFlow())
                 {
-                    Vector2dd shift1 = Vector2dd(element.dispPrev, 0);
-                    old3d = triangulate(start1, shift1);
-                    swarmPoint.is6D = true;
-                } else {
-                    //Vector2dd normalisedEnd1 = rectifiedToNormalizedRight * end1;
-                    //old3d = Vector3dd(normalisedEnd1, 1.0) * current3d.z();
-                    //old3d = current3d;
+                    /*Position at previous frame */
+                    Vector2dd start1(start.x() + element.flow.x(), start.y() + element.flow.y());
+                    Vector3dd old3d = current3d;
+
+                    if (element.hasPrevDisp() && element.dispPrev > 0)
+                    {
+                        Vector2dd shift1 = Vector2dd(element.dispPrev, 0);
+                        old3d = realThis->triangulate(start1, shift1);
+                        is6D = true;
+                    } else {
+                        //Vector2dd normalisedEnd1 = rectifiedToNormalizedRight * end1;
+                        //old3d = Vector3dd(normalisedEnd1, 1.0) * current3d.z();
+                        //old3d = current3d;
+                    }
+                    speed = current3d - old3d;
                 }
-                swarmPoint.speed = current3d - old3d;
+                storeSpeed(result, index, speed, is6D);
+                index++;
             }
-
-            result->push_back(swarmPoint);
         }
     }
+
+    ParallelTriangulate6D(const Triangulator *_realThis, SixDBuffer *_input, const vector<int> *_offsets, CloudType *_result) :
+        realThis(_realThis)
+      , input(_input)
+      , offsets(_offsets)
+      , result(_result)
+    {}
+};
+
+template<class CloudType>
+void Triangulator::triangulateHelper6D (SixDBuffer *input, CloudType *result) const
+{
+    vector<int> offsets;
+    result->resize(rowOffsets(input, offsets));
+    parallelable_for(0, input->h, ParallelTriangulate6D<CloudType>(this, input, &offsets, result));
+}
+
+Cloud *Triangulator::triangulate (SixDBuffer *input, int /*density*/) const
+{
+    Cloud *result = new Cloud();
+    triangulateHelper6D(input, result);
     return result;
 }
 
+FloatCloud *Triangulator::triangulateToFloatCloud (SixDBuffer *input, int channels) const
+{
+    return BatchTriangulator(*this).cloud(input, channels);
+}
+
 DepthBuffer *Triangulator::triangulateToDB (DisparityBuffer *input, bool enforceRectify) const
 {
-    if (input != NULL) {
+    if (input == NULL) {
         return NULL;
     }
-    DepthBuffer *result = new DepthBuffer(input->h, input->w, false);
-    for (int i = 0; i < result->h; i++)
-    {
-        for (int j = 0; j < result->w; j++)
-        {
-            if (!input->isElementKnown(i, j)) {
-                result->element(i,j) = DepthBuffer::DEPTH_UNKNOWN;
-                continue;
-            }
-
-            FlowElement *flowElement = &input->element(i,j);
-            /* Point in right frame*/
-            Vector2dd start(j,i);
-            Vector2dd shift(flowElement->x(), enforceRectify ? 0 : flowElement->y());
-            result->element(i,j) = getDepth(start, shift);
-        }
-    }
-    return result;
+    return BatchTriangulator(*this).depth(input, enforceRectify);
 }
 
 
@@ -19,6 +19,7 @@
 #include "rgbColor.h"
 #include "depthBuffer.h"
 #include "cloud.h"
+#include "floatCloud.h"
 #include "tbbWrapper.h"
 
 namespace corecvs {
@@ -148,15 +149,100 @@ public:
 
     Cloud *triangulate (SixDBuffer *input, int density) const;
 
+    /**
+     *  Same as triangulate(), but the result is the float cloud with the given channels.
+     *  Computed with BatchTriangulator, the rows are triangulated in parallel, each into its own slice
+     *  of the presized cloud.
+     **/
+    FloatCloud *triangulateToFloatCloud (DisparityBuffer *input, bool enforceRectify = false, int channels = FloatCloud::TEXTURE) const;
+    FloatCloud *triangulateToFloatCloud (FloatFlowBuffer *input, bool enforceRectify = false, int channels = FloatCloud::TEXTURE) const;
+
+    FloatCloud *triangulateToFloatCloud (SixDBuffer *input, int channels = FloatCloud::TEXTURE | FloatCloud::SPEED) const;
+
+    /** Depth as in getDepth(), computed with BatchTriangulator */
     DepthBuffer *triangulateToDB (DisparityBuffer *input, bool enforceRectify = false) const;
 private:
-    template<class InputType>
-    Cloud *triangulateHelper (InputType *input,  int density, bool enforceRectify) const;
-    template<class InputType>
-    Cloud *triangulateHelperParallel (InputType *input,  int density, bool enforceRectify) const;
+    template<class InputType, class CloudType>
+    void triangulateHelper (InputType *input, CloudType *result, bool enforceRectify) const;
+    template<class CloudType>
+    void triangulateHelper6D (SixDBuffer *input, CloudType *result) const;
 
 };
 
+/* Access to the input buffers shared by Triangulator and BatchTriangulator */
+
+template<class Type>
+inline Vector2dd getInputDisparity(Type *input, int y, int x)
+{
+    return input->element(y,x);
+}
+
+template<>
+inline Vector2dd getInputDisparity<DisparityBuffer>(DisparityBuffer *input, int y, int x)
+{
+    FlowElement *flowElement = &input->element(y,x);
+    return Vector2dd(flowElement->x(), flowElement->y());
+}
+
+template<>
+inline Vector2dd getInputDisparity<FloatFlowBuffer>(FloatFlowBuffer *input, int y, int x)
+{
+    return input->element(y,x).vector;
+}
+
+
+template<class InputType>
+inline bool isTriangulable(InputType *input, int y, int x)
+{
+    return input->isElementKnown(y, x);
+}
+
+template<>
+inline bool isTriangulable<SixDBuffer>(SixDBuffer *input, int y, int x)
+{
+    const Element6D &element = input->element(y,x);
+    return element.hasDisp() && element.disp > 0;
+}
+
+/**
+ *  Counts the points of each row, the ones isTriangulable() accepts. The prefix sums of the counts are the starts of the row slices,
+ *  so the cloud is sized once and each row is written to its own slice without locking and copying.
+ **/
+template<class InputType>
+class ParallelRowCount
+{
+    InputType *input;
+    vector<int> *offsets;
+public:
+    void operator()( const BlockedRange<int>& r ) const
+    {
+        for (int i = r.begin(); i < r.end(); i++)
+        {
+            int count = 0;
+            for (int j = 0; j < input->w; j++)
+            {
+                if (isTriangulable<InputType>(input, i, j))
+                    count++;
+            }
+            (*offsets)[i + 1] = count;
+        }
+    }
+
+    ParallelRowCount(InputType *_input, vector<int> *_offsets) :
+        input(_input)
+      , offsets(_offsets)
+    {}
+};
+
+template<class InputType>
+inline int rowOffsets(InputType *input, vector<int> &offsets)
+{
+    offsets.assign(input->h + 1, 0);
+    parallelable_for(0, input->h, ParallelRowCount<InputType>(input, &offsets));
+    for (int i = 0; i < input->h; i++)
+        offsets[i + 1] += offsets[i];
+    return offsets[input->h];
+}
 
 } //namespace corecvs
 #endif /* TRIANGULATOR_H_ */
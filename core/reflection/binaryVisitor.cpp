@@ -0,0 +1,484 @@
+/**
+ * \file binaryVisitor.cpp
+ * \brief Compact binary serialization through the reflection visitors
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <string.h>
+
+#include "binaryVisitor.h"
+
+namespace corecvs {
+
+const uint32_t BinaryVisitorBase::FNV_OFFSET;
+const uint32_t BinaryVisitorBase::FNV_PRIME;
+
+const char     BinaryRecordWriter::MAGIC[4] = { 'C', 'V', 'S', 'B' };
+const uint16_t BinaryRecordWriter::VERSION;
+
+static inline uint64_t doubleBits(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline double bitsDouble(uint64_t bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline uint64_t floatBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline float bitsFloat(uint64_t bits)
+{
+    uint32_t bits32 = (uint32_t)bits;
+    float value;
+    memcpy(&value, &bits32, sizeof(value));
+    return value;
+}
+
+static inline void appendLittleEndian(vector<uint8_t> &data, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+        data.push_back((uint8_t)(value >> (8 * i)));
+}
+
+static inline uint64_t readLittleEndian(const uint8_t *data, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++)
+        value |= (uint64_t)data[i] << (8 * i);
+    return value;
+}
+
+/**
+ * BinarySerializerVisitor
+ * @{
+ */
+void BinarySerializerVisitor::putField(BaseField::FieldType type, const char *name, uint64_t bits, int bytes)
+{
+    hashField(type, name);
+    data.push_back((uint8_t)type);
+    appendLittleEndian(data, bits, bytes);
+}
+
+void BinarySerializerVisitor::putField(const char *name, const string &value)
+{
+    hashField(BaseField::TYPE_STRING, name);
+    data.push_back((uint8_t)BaseField::TYPE_STRING);
+    appendLittleEndian(data, value.size(), 4);
+    data.insert(data.end(), value.begin(), value.end());
+}
+
+template <>
+void BinarySerializerVisitor::visit<int, IntField>(int &field, const IntField *fieldDescriptor)
+{
+    putField(BaseField::TYPE_INT, fieldDescriptor->getSimpleName(), (uint32_t)field, 4);
+}
+
+template <>
+void BinarySerializerVisitor::visit<int64_t, TimestampField>(int64_t &field, const TimestampField *fieldDescriptor)
+{
+    putField(BaseField::TYPE_TIMESTAMP, fieldDescriptor->getSimpleName(), (uint64_t)field, 8);
+}
+
+template <>
+void BinarySerializerVisitor::visit<double, DoubleField>(double &field, const DoubleField *fieldDescriptor)
+{
+    putField(BaseField::TYPE_DOUBLE, fieldDescriptor->getSimpleName(), doubleBits(field), 8);
+}
+
+template <>
+void BinarySerializerVisitor::visit<float, FloatField>(float &field, const FloatField *fieldDescriptor)
+{
+    putField(BaseField::TYPE_FLOAT, fieldDescriptor->getSimpleName(), floatBits(field), 4);
+}
+
+template <>
+void BinarySerializerVisitor::visit<bool, BoolField>(bool &field, const BoolField *fieldDescriptor)
+{
+    putField(BaseField::TYPE_BOOL, fieldDescriptor->getSimpleName(), field ? 1 : 0, 1);
+}
+
+template <>
+void BinarySerializerVisitor::visit<std::string, StringField>(std::string &field, const StringField *fieldDescriptor)
+{
+    putField(fieldDescriptor->getSimpleName(), field);
+}
+
+template <>
+void BinarySerializerVisitor::visit<int, EnumField>(int &field, const EnumField *fieldDescriptor)
+{
+    putField(BaseField::TYPE_ENUM, fieldDescriptor->getSimpleName(), (uint32_t)field, 4);
+}
+
+template <>
+void BinarySerializerVisitor::visit<void *, PointerField>(void * &/*field*/, const PointerField *fieldDescriptor)
+{
+    putField(BaseField::TYPE_POINTER, fieldDescriptor->getSimpleName(), 0, 0);
+}
+
+template <>
+void BinarySerializerVisitor::visit<int>(int &field, int /*defaultValue*/, const char *fieldName)
+{
+    putField(BaseField::TYPE_INT, fieldName, (uint32_t)field, 4);
+}
+
+template <>
+void BinarySerializerVisitor::visit<int64_t>(int64_t &field, int64_t /*defaultValue*/, const char *fieldName)
+{
+    putField(BaseField::TYPE_TIMESTAMP, fieldName, (uint64_t)field, 8);
+}
+
+template <>
+void BinarySerializerVisitor::visit<double>(double &field, double /*defaultValue*/, const char *fieldName)
+{
+    putField(BaseField::TYPE_DOUBLE, fieldName, doubleBits(field), 8);
+}
+
+template <>
+void BinarySerializerVisitor::visit<float>(float &field, float /*defaultValue*/, const char *fieldName)
+{
+    putField(BaseField::TYPE_FLOAT, fieldName, floatBits(field), 4);
+}
+
+template <>
+void BinarySerializerVisitor::visit<bool>(bool &field, bool /*defaultValue*/, const char *fieldName)
+{
+    putField(BaseField::TYPE_BOOL, fieldName, field ? 1 : 0, 1);
+}
+
+template <>
+void BinarySerializerVisitor::visit<std::string>(std::string &field, std::string /*defaultValue*/, const char *fieldName)
+{
+    putField(fieldName, field);
+}
+/**
+ * @}
+ */
+
+/**
+ * BinaryDeserializerVisitor
+ * @{
+ */
+bool BinaryDeserializerVisitor::getField(BaseField::FieldType type, const char *name, uint64_t *bits, int bytes)
+{
+    hashField(type, name);
+    if (!mOk || mPosition + 1 + bytes > mSize || mData[mPosition] != (uint8_t)type)
+    {
+        mOk = false;
+        return false;
+    }
+    *bits = readLittleEndian(mData + mPosition + 1, bytes);
+    mPosition += 1 + bytes;
+    return true;
+}
+
+bool BinaryDeserializerVisitor::getField(const char *name, string *value)
+{
+    uint64_t length = 0;
+    if (!getField(BaseField::TYPE_STRING, name, &length, 4))
+        return false;
+    if (mPosition + length > mSize)
+    {
+        mOk = false;
+        return false;
+    }
+    value->assign((const char *)mData + mPosition, (size_t)length);
+    mPosition += (size_t)length;
+    return true;
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<int, IntField>(int &field, const IntField *fieldDescriptor)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_INT, fieldDescriptor->getSimpleName(), &bits, 4))
+        field = (int32_t)(uint32_t)bits;
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<int64_t, TimestampField>(int64_t &field, const TimestampField *fieldDescriptor)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_TIMESTAMP, fieldDescriptor->getSimpleName(), &bits, 8))
+        field = (int64_t)bits;
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<double, DoubleField>(double &field, const DoubleField *fieldDescriptor)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_DOUBLE, fieldDescriptor->getSimpleName(), &bits, 8))
+        field = bitsDouble(bits);
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<float, FloatField>(float &field, const FloatField *fieldDescriptor)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_FLOAT, fieldDescriptor->getSimpleName(), &bits, 4))
+        field = bitsFloat(bits);
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<bool, BoolField>(bool &field, const BoolField *fieldDescriptor)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_BOOL, fieldDescriptor->getSimpleName(), &bits, 1))
+        field = (bits != 0);
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<std::string, StringField>(std::string &field, const StringField *fieldDescriptor)
+{
+    getField(fieldDescriptor->getSimpleName(), &field);
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<int, EnumField>(int &field, const EnumField *fieldDescriptor)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_ENUM, fieldDescriptor->getSimpleName(), &bits, 4))
+        field = (int32_t)(uint32_t)bits;
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<void *, PointerField>(void * &field, const PointerField *fieldDescriptor)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_POINTER, fieldDescriptor->getSimpleName(), &bits, 0))
+        field = NULL;
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<int>(int &field, int /*defaultValue*/, const char *fieldName)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_INT, fieldName, &bits, 4))
+        field = (int32_t)(uint32_t)bits;
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<int64_t>(int64_t &field, int64_t /*defaultValue*/, const char *fieldName)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_TIMESTAMP, fieldName, &bits, 8))
+        field = (int64_t)bits;
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<double>(double &field, double /*defaultValue*/, const char *fieldName)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_DOUBLE, fieldName, &bits, 8))
+        field = bitsDouble(bits);
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<float>(float &field, float /*defaultValue*/, const char *fieldName)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_FLOAT, fieldName, &bits, 4))
+        field = bitsFloat(bits);
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<bool>(bool &field, bool /*defaultValue*/, const char *fieldName)
+{
+    uint64_t bits;
+    if (getField(BaseField::TYPE_BOOL, fieldName, &bits, 1))
+        field = (bits != 0);
+}
+
+template <>
+void BinaryDeserializerVisitor::visit<std::string>(std::string &field, std::string /*defaultValue*/, const char *fieldName)
+{
+    getField(fieldName, &field);
+}
+/**
+ * @}
+ */
+
+/**
+ * BinarySchemaVisitor
+ * @{
+ */
+template <>
+void BinarySchemaVisitor::visit<int, IntField>(int &/*field*/, const IntField *fieldDescriptor)
+{
+    hashField(BaseField::TYPE_INT, fieldDescriptor->getSimpleName());
+}
+
+template <>
+void BinarySchemaVisitor::visit<int64_t, TimestampField>(int64_t &/*field*/, const TimestampField *fieldDescriptor)
+{
+    hashField(BaseField::TYPE_TIMESTAMP, fieldDescriptor->getSimpleName());
+}
+
+template <>
+void BinarySchemaVisitor::visit<double, DoubleField>(double &/*field*/, const DoubleField *fieldDescriptor)
+{
+    hashField(BaseField::TYPE_DOUBLE, fieldDescriptor->getSimpleName());
+}
+
+template <>
+void BinarySchemaVisitor::visit<float, FloatField>(float &/*field*/, const FloatField *fieldDescriptor)
+{
+    hashField(BaseField::TYPE_FLOAT, fieldDescriptor->getSimpleName());
+}
+
+template <>
+void BinarySchemaVisitor::visit<bool, BoolField>(bool &/*field*/, const BoolField *fieldDescriptor)
+{
+    hashField(BaseField::TYPE_BOOL, fieldDescriptor->getSimpleName());
+}
+
+template <>
+void BinarySchemaVisitor::visit<std::string, StringField>(std::string &/*field*/, const StringField *fieldDescriptor)
+{
+    hashField(BaseField::TYPE_STRING, fieldDescriptor->getSimpleName());
+}
+
+template <>
+void BinarySchemaVisitor::visit<int, EnumField>(int &/*field*/, const EnumField *fieldDescriptor)
+{
+    hashField(BaseField::TYPE_ENUM, fieldDescriptor->getSimpleName());
+}
+
+template <>
+void BinarySchemaVisitor::visit<void *, PointerField>(void * &/*field*/, const PointerField *fieldDescriptor)
+{
+    hashField(BaseField::TYPE_POINTER, fieldDescriptor->getSimpleName());
+}
+
+template <>
+void BinarySchemaVisitor::visit<int>(int &/*field*/, int /*defaultValue*/, const char *fieldName)
+{
+    hashField(BaseField::TYPE_INT, fieldName);
+}
+
+template <>
+void BinarySchemaVisitor::visit<int64_t>(int64_t &/*field*/, int64_t /*defaultValue*/, const char *fieldName)
+{
+    hashField(BaseField::TYPE_TIMESTAMP, fieldName);
+}
+
+template <>
+void BinarySchemaVisitor::visit<double>(double &/*field*/, double /*defaultValue*/, const char *fieldName)
+{
+    hashField(BaseField::TYPE_DOUBLE, fieldName);
+}
+
+template <>
+void BinarySchemaVisitor::visit<float>(float &/*field*/, float /*defaultValue*/, const char *fieldName)
+{
+    hashField(BaseField::TYPE_FLOAT, fieldName);
+}
+
+template <>
+void BinarySchemaVisitor::visit<bool>(bool &/*field*/, bool /*defaultValue*/, const char *fieldName)
+{
+    hashField(BaseField::TYPE_BOOL, fieldName);
+}
+
+template <>
+void BinarySchemaVisitor::visit<std::string>(std::string &/*field*/, std::string /*defaultValue*/, const char *fieldName)
+{
+    hashField(BaseField::TYPE_STRING, fieldName);
+}
+/**
+ * @}
+ */
+
+BinaryRecordWriter::BinaryRecordWriter(std::ostream &stream) :
+    mStream(stream),
+    mRecords(0)
+{
+    uint8_t header[8] = { (uint8_t)MAGIC[0], (uint8_t)MAGIC[1], (uint8_t)MAGIC[2], (uint8_t)MAGIC[3],
+                          (uint8_t)(VERSION & 0xFF), (uint8_t)(VERSION >> 8), 0, 0 };
+    mStream.write((const char *)header, sizeof(header));
+}
+
+void BinaryRecordWriter::writeRecord(uint32_t schemaHash, const vector<uint8_t> &payload)
+{
+    vector<uint8_t> header;
+    header.reserve(8);
+    appendLittleEndian(header, schemaHash, 4);
+    appendLittleEndian(header, payload.size(), 4);
+    mStream.write((const char *)&header[0], header.size());
+    if (!payload.empty())
+        mStream.write((const char *)&payload[0], payload.size());
+    mRecords++;
+}
+
+BinaryRecordReader::BinaryRecordReader(std::istream &stream) :
+    mStream(stream),
+    mStatus(STATUS_OK),
+    mRecordHash(0)
+{
+    uint8_t header[8];
+    mStream.read((char *)header, sizeof(header));
+    if (mStream.gcount() != (std::streamsize)sizeof(header) ||
+        memcmp(header, BinaryRecordWriter::MAGIC, sizeof(BinaryRecordWriter::MAGIC)) != 0 ||
+        readLittleEndian(header + 4, 2) > BinaryRecordWriter::VERSION)
+    {
+        mStatus = STATUS_BAD_HEADER;
+    }
+}
+
+/* Payloads are read by the chunks of this size */
+static const size_t READ_CHUNK = 1 << 16;
+
+bool BinaryRecordReader::nextRecord()
+{
+    if (mStatus == STATUS_BAD_HEADER || mStatus == STATUS_END)
+        return false;
+
+    uint8_t header[8];
+    mStream.read((char *)header, sizeof(header));
+    if (mStream.gcount() == 0)
+    {
+        mStatus = STATUS_END;
+        return false;
+    }
+    if (mStream.gcount() != (std::streamsize)sizeof(header))
+    {
+        mStatus = STATUS_DAMAGED;
+        return false;
+    }
+
+    mRecordHash = (uint32_t)readLittleEndian(header, 4);
+    size_t size = (size_t)readLittleEndian(header + 4, 4);
+
+    /* The size comes from the stream, so the payload grows only as far as the data is actually there */
+    mPayload.clear();
+    while (mPayload.size() < size)
+    {
+        size_t done  = mPayload.size();
+        size_t chunk = CORE_MIN(size - done, READ_CHUNK);
+        mPayload.resize(done + chunk);
+        mStream.read((char *)&mPayload[done], chunk);
+        if (mStream.gcount() != (std::streamsize)chunk)
+        {
+            mPayload.clear();
+            mStatus = STATUS_DAMAGED;
+            return false;
+        }
+    }
+    mStatus = STATUS_OK;
+    return true;
+}
+
+} //namespace corecvs
+
+/* EOF */
@@ -0,0 +1,360 @@
+#pragma once
+/**
+ * \file binaryVisitor.h
+ * \brief Compact binary serialization through the reflection visitors
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <stdint.h>
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include "global.h"
+
+#include "reflection.h"
+
+namespace corecvs {
+
+using std::string;
+using std::vector;
+
+/**
+ *  Common part of the binary visitors - the schema hash.
+ *
+ *  The hash is FNV-1a over the visited structure: the names of the composites with their bounds and the
+ *  names and FieldType of the scalar fields, in the order accept() visits them. The binary record is only
+ *  read into the object of the same hash, so the values are stored without the names.
+ **/
+class BinaryVisitorBase
+{
+public:
+    BinaryVisitorBase() :
+        mSchemaHash(FNV_OFFSET)
+    {}
+
+    uint32_t schemaHash() const
+    {
+        return mSchemaHash;
+    }
+
+protected:
+    static const uint32_t FNV_OFFSET = 2166136261U;
+    static const uint32_t FNV_PRIME  = 16777619U;
+
+    uint32_t mSchemaHash;
+
+    void hashByte(uint8_t value)
+    {
+        mSchemaHash = (mSchemaHash ^ value) * FNV_PRIME;
+    }
+
+    void hashName(const char *name)
+    {
+        if (name != NULL) {
+            for (const char *c = name; *c != 0; c++)
+                hashByte((uint8_t)*c);
+        }
+        hashByte(0);
+    }
+
+    void hashField(BaseField::FieldType type, const char *name)
+    {
+        hashByte((uint8_t)type);
+        hashName(name);
+    }
+
+    void hashEnter(const char *name)
+    {
+        hashByte((uint8_t)BaseField::TYPE_COMPOSITE);
+        hashName(name);
+    }
+
+    void hashLeave()
+    {
+        hashByte(0xFF);
+    }
+
+    static const char *nameOf(const BaseField *fieldDescriptor)
+    {
+        return fieldDescriptor == NULL ? "" : fieldDescriptor->getSimpleName();
+    }
+};
+
+/**
+ *  Visitor that only computes the schema hash, the object is not changed
+ **/
+class BinarySchemaVisitor : public BinaryVisitorBase
+{
+public:
+template<class Type>
+    void visit(Type &field, Type /*defaultValue*/, const char *fieldName)
+    {
+        hashEnter(fieldName);
+        field.accept(*this);
+        hashLeave();
+    }
+
+template <typename inputType, typename reflectionType>
+    void visit(inputType &field, const reflectionType *fieldDescriptor)
+    {
+        hashEnter(nameOf(fieldDescriptor));
+        field.accept(*this);
+        hashLeave();
+    }
+};
+
+/**
+ *  Visitor that appends the tagged little endian values to the buffer.
+ *
+ *  Each value is the type tag, the BaseField::FieldType of the field, followed by the value: int and enum
+ *  as 4 bytes, the timestamp as 8, double and float as their IEEE 754 bits, bool as 1 byte and the string
+ *  as the 4 byte length and the bytes. Pointers are only tagged.
+ **/
+class BinarySerializerVisitor : public BinaryVisitorBase
+{
+public:
+    vector<uint8_t> data;
+
+    /** Clears the buffer, keeps the memory for the next record */
+    void reset()
+    {
+        data.clear();
+        mSchemaHash = FNV_OFFSET;
+    }
+
+template<class Type>
+    void visit(Type &field, Type /*defaultValue*/, const char *fieldName)
+    {
+        hashEnter(fieldName);
+        field.accept(*this);
+        hashLeave();
+    }
+
+template <typename inputType, typename reflectionType>
+    void visit(inputType &field, const reflectionType *fieldDescriptor)
+    {
+        hashEnter(nameOf(fieldDescriptor));
+        field.accept(*this);
+        hashLeave();
+    }
+
+    void putField(BaseField::FieldType type, const char *name, uint64_t bits, int bytes);
+    void putField(const char *name, const string &value);
+};
+
+/**
+ *  Visitor that reads the values written by BinarySerializerVisitor. On the wrong tag or the end of
+ *  the data it stops, isOk() becomes false and the rest of the fields is not changed.
+ **/
+class BinaryDeserializerVisitor : public BinaryVisitorBase
+{
+public:
+    BinaryDeserializerVisitor(const uint8_t *data, size_t size) :
+        mData(data),
+        mSize(size),
+        mPosition(0),
+        mOk(true)
+    {}
+
+    bool isOk() const
+    {
+        return mOk;
+    }
+
+    /** All the data is consumed */
+    bool isAtEnd() const
+    {
+        return mPosition == mSize;
+    }
+
+template<class Type>
+    void visit(Type &field, Type /*defaultValue*/, const char *fieldName)
+    {
+        hashEnter(fieldName);
+        field.accept(*this);
+        hashLeave();
+    }
+
+template <typename inputType, typename reflectionType>
+    void visit(inputType &field, const reflectionType *fieldDescriptor)
+    {
+        hashEnter(nameOf(fieldDescriptor));
+        field.accept(*this);
+        hashLeave();
+    }
+
+    bool getField(BaseField::FieldType type, const char *name, uint64_t *bits, int bytes);
+    bool getField(const char *name, string *value);
+
+private:
+    const uint8_t *mData;
+    size_t mSize;
+    size_t mPosition;
+    bool   mOk;
+};
+
+/* New style visitors */
+template <> void BinarySchemaVisitor::visit<int,         IntField>      (int         &field, const IntField       *fieldDescriptor);
+template <> void BinarySchemaVisitor::visit<int64_t,     TimestampField>(int64_t     &field, const TimestampField *fieldDescriptor);
+template <> void BinarySchemaVisitor::visit<double,      DoubleField>   (double      &field, const DoubleField    *fieldDescriptor);
+template <> void BinarySchemaVisitor::visit<float,       FloatField>    (float       &field, const FloatField     *fieldDescriptor);
+template <> void BinarySchemaVisitor::visit<bool,        BoolField>     (bool        &field, const BoolField      *fieldDescriptor);
+template <> void BinarySchemaVisitor::visit<std::string, StringField>   (std::string &field, const StringField    *fieldDescriptor);
+template <> void BinarySchemaVisitor::visit<int,         EnumField>     (int         &field, const EnumField      *fieldDescriptor);
+template <> void BinarySchemaVisitor::visit<void *,      PointerField>  (void *      &field, const PointerField   *fieldDescriptor);
+
+template <> void BinarySerializerVisitor::visit<int,         IntField>      (int         &field, const IntField       *fieldDescriptor);
+template <> void BinarySerializerVisitor::visit<int64_t,     TimestampField>(int64_t     &field, const TimestampField *fieldDescriptor);
+template <> void BinarySerializerVisitor::visit<double,      DoubleField>   (double      &field, const DoubleField    *fieldDescriptor);
+template <> void BinarySerializerVisitor::visit<float,       FloatField>    (float       &field, const FloatField     *fieldDescriptor);
+template <> void BinarySerializerVisitor::visit<bool,        BoolField>     (bool        &field, const BoolField      *fieldDescriptor);
+template <> void BinarySerializerVisitor::visit<std::string, StringField>   (std::string &field, const StringField    *fieldDescriptor);
+template <> void BinarySerializerVisitor::visit<int,         EnumField>     (int         &field, const EnumField      *fieldDescriptor);
+template <> void BinarySerializerVisitor::visit<void *,      PointerField>  (void *      &field, const PointerField   *fieldDescriptor);
+
+template <> void BinaryDeserializerVisitor::visit<int,         IntField>      (int         &field, const IntField       *fieldDescriptor);
+template <> void BinaryDeserializerVisitor::visit<int64_t,     TimestampField>(int64_t     &field, const TimestampField *fieldDescriptor);
+template <> void BinaryDeserializerVisitor::visit<double,      DoubleField>   (double      &field, const DoubleField    *fieldDescriptor);
+template <> void BinaryDeserializerVisitor::visit<float,       FloatField>    (float       &field, const FloatField     *fieldDescriptor);
+template <> void BinaryDeserializerVisitor::visit<bool,        BoolField>     (bool        &field, const BoolField      *fieldDescriptor);
+template <> void BinaryDeserializerVisitor::visit<std::string, StringField>   (std::string &field, const StringField    *fieldDescriptor);
+template <> void BinaryDeserializerVisitor::visit<int,         EnumField>     (int         &field, const EnumField      *fieldDescriptor);
+template <> void BinaryDeserializerVisitor::visit<void *,      PointerField>  (void *      &field, const PointerField   *fieldDescriptor);
+
+/* Old style visitors */
+template <> void BinarySchemaVisitor::visit<int>        (int         &field, int         defaultValue, const char *fieldName);
+template <> void BinarySchemaVisitor::visit<int64_t>    (int64_t     &field, int64_t     defaultValue, const char *fieldName);
+template <> void BinarySchemaVisitor::visit<double>     (double      &field, double      defaultValue, const char *fieldName);
+template <> void BinarySchemaVisitor::visit<float>      (float       &field, float       defaultValue, const char *fieldName);
+template <> void BinarySchemaVisitor::visit<bool>       (bool        &field, bool        defaultValue, const char *fieldName);
+template <> void BinarySchemaVisitor::visit<std::string>(std::string &field, std::string defaultValue, const char *fieldName);
+
+template <> void BinarySerializerVisitor::visit<int>        (int         &field, int         defaultValue, const char *fieldName);
+template <> void BinarySerializerVisitor::visit<int64_t>    (int64_t     &field, int64_t     defaultValue, const char *fieldName);
+template <> void BinarySerializerVisitor::visit<double>     (double      &field, double      defaultValue, const char *fieldName);
+template <> void BinarySerializerVisitor::visit<float>      (float       &field, float       defaultValue, const char *fieldName);
+template <> void BinarySerializerVisitor::visit<bool>       (bool        &field, bool        defaultValue, const char *fieldName);
+template <> void BinarySerializerVisitor::visit<std::string>(std::string &field, std::string defaultValue, const char *fieldName);
+
+template <> void BinaryDeserializerVisitor::visit<int>        (int         &field, int         defaultValue, const char *fieldName);
+template <> void BinaryDeserializerVisitor::visit<int64_t>    (int64_t     &field, int64_t     defaultValue, const char *fieldName);
+template <> void BinaryDeserializerVisitor::visit<double>     (double      &field, double      defaultValue, const char *fieldName);
+template <> void BinaryDeserializerVisitor::visit<float>      (float       &field, float       defaultValue, const char *fieldName);
+template <> void BinaryDeserializerVisitor::visit<bool>       (bool        &field, bool        defaultValue, const char *fieldName);
+template <> void BinaryDeserializerVisitor::visit<std::string>(std::string &field, std::string defaultValue, const char *fieldName);
+
+/**
+ *  Writes the stream of binary records.
+ *
+ *  The stream starts with the 8 byte header, the magic "CVSB" and the version. Each record is the schema
+ *  hash, the payload size, both as the 4 byte little endian numbers, and the payload of the
+ *  BinarySerializerVisitor. Records of the different types could be mixed in one stream.
+ **/
+class BinaryRecordWriter
+{
+public:
+    static const char     MAGIC[4];
+    static const uint16_t VERSION = 1;
+
+    explicit BinaryRecordWriter(std::ostream &stream);
+
+template<class Type>
+    void write(Type &object)
+    {
+        mVisitor.reset();
+        object.accept(mVisitor);
+        writeRecord(mVisitor.schemaHash(), mVisitor.data);
+    }
+
+    void writeRecord(uint32_t schemaHash, const vector<uint8_t> &payload);
+
+    int records() const
+    {
+        return mRecords;
+    }
+
+private:
+    std::ostream &mStream;
+    BinarySerializerVisitor mVisitor;
+    int mRecords;
+};
+
+/**
+ *  Reads the stream of BinaryRecordWriter
+ **/
+class BinaryRecordReader
+{
+public:
+    enum Status {
+        STATUS_OK,
+        STATUS_END,              /**< No more records */
+        STATUS_BAD_HEADER,       /**< Stream is not the binary record stream */
+        STATUS_SCHEMA_MISMATCH,  /**< Record is of the other type, it is skipped */
+        STATUS_DAMAGED           /**< Record is truncated or the tags do not match */
+    };
+
+    explicit BinaryRecordReader(std::istream &stream);
+
+    /**
+     *  Reads the next record into the object.
+     *  \return false if the record is not read, status() tells why
+     **/
+template<class Type>
+    bool read(Type &object)
+    {
+        if (!nextRecord())
+            return false;
+
+        BinarySchemaVisitor schema;
+        object.accept(schema);
+        if (schema.schemaHash() != mRecordHash)
+        {
+            mStatus = STATUS_SCHEMA_MISMATCH;
+            return false;
+        }
+
+        BinaryDeserializerVisitor visitor(mPayload.empty() ? NULL : &mPayload[0], mPayload.size());
+        object.accept(visitor);
+        if (!visitor.isOk() || !visitor.isAtEnd())
+        {
+            mStatus = STATUS_DAMAGED;
+            return false;
+        }
+        return true;
+    }
+
+    /** Loads the next record without decoding it */
+    bool nextRecord();
+
+    Status status() const
+    {
+        return mStatus;
+    }
+
+    /** Schema hash of the last loaded record */
+    uint32_t recordHash() const
+    {
+        return mRecordHash;
+    }
+
+private:
+    std::istream &mStream;
+    Status mStatus;
+    uint32_t mRecordHash;
+    vector<uint8_t> mPayload;
+};
+
+/** Schema hash of the reflected object */
+template<class Type>
+uint32_t binarySchemaHash(Type &object)
+{
+    BinarySchemaVisitor schema;
+    object.accept(schema);
+    return schema.schemaHash();
+}
+
+} //namespace corecvs
+
+/* EOF */
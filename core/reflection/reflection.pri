@@ -2,7 +2,8 @@ SOURCES += \
     reflection/defaultSetter.cpp  \
     reflection/printerVisitor.cpp \
     reflection/serializerVisitor.cpp \
-    reflection/deserializerVisitor.cpp
+    reflection/deserializerVisitor.cpp \
+    reflection/binaryVisitor.cpp
 
 
 HEADERS += \
@@ -10,6 +11,7 @@ HEADERS += \
     reflection/defaultSetter.h   \
     reflection/printerVisitor.h  \
     reflection/serializerVisitor.h \
-    reflection/deserializerVisitor.h
+    reflection/deserializerVisitor.h \
+    reflection/binaryVisitor.h
     
     
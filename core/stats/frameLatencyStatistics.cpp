@@ -0,0 +1,284 @@
+/**
+ * \file frameLatencyStatistics.cpp
+ * \brief Latency histograms and drop accounting of the captured frames
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <fstream>
+
+#ifndef WIN32
+#include <time.h>
+#endif
+
+#include "global.h"
+
+#include "frameLatencyStatistics.h"
+
+namespace corecvs {
+
+const char *FrameLifecycle::names[] =
+{
+    "Sensor",
+    "Dequeue",
+    "Decode done",
+    "Calculation start",
+    "Calculation end",
+    "Output delivered"
+};
+
+STATIC_ASSERT(CORE_COUNT_OF(FrameLifecycle::names) == FrameLifecycle::STAMP_NUMBER, wrong_stamp_names_number);
+
+bool FrameLifecycle::monotonicTime(int64_t &usec)
+{
+#if defined(WIN32) || defined(QT_CLOCK)
+    CORE_UNUSED(usec);
+    return false;
+#else
+    struct timespec time;
+    if (clock_gettime(CLOCK_MONOTONIC, &time) != 0)
+        return false;
+    usec = (int64_t)time.tv_sec * 1000000 + time.tv_nsec / 1000;
+    return true;
+#endif
+}
+
+bool FrameLifecycle::monotonicOffset(int64_t &offset)
+{
+    int64_t monotonic;
+    if (!monotonicTime(monotonic))
+        return false;
+    offset = (int64_t)PreciseTimer::currentTime().usec() - monotonic;
+    return true;
+}
+
+const char *FrameLatencyStatistics::dropCauseNames[] =
+{
+    "Capture skipped",
+    "Calculation busy",
+    "Repeated frame",
+    "Paused",
+    "No frames",
+    "Queue full"
+};
+
+STATIC_ASSERT(CORE_COUNT_OF(FrameLatencyStatistics::dropCauseNames) == FrameLatencyStatistics::DROP_CAUSE_NUMBER, wrong_drop_cause_names_number);
+
+const char *FrameLatencyStatistics::intervalNames[] =
+{
+    "Latency",
+    "Capture wait",
+    "Decoding",
+    "Calculation wait",
+    "Calculation",
+    "Delivery"
+};
+
+STATIC_ASSERT(CORE_COUNT_OF(FrameLatencyStatistics::intervalNames) == FrameLatencyStatistics::INTERVAL_NUMBER, wrong_interval_names_number);
+
+uint64_t LatencyHistogram::percentile(double fraction) const
+{
+    if (mCount == 0)
+        return 0;
+
+    uint64_t needed = (uint64_t)(fraction * mCount + 0.5);
+    if (needed == 0)
+        needed = 1;
+
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < mBuckets.size(); i++)
+    {
+        accumulated += mBuckets[i];
+        if (accumulated >= needed)
+        {
+            /* Overflow bucket has no upper bound of its own */
+            if (i == mBuckets.size() - 1)
+                return mMax;
+            return CORE_MIN((uint64_t)(i + 1) * mBucketUsec, mMax);
+        }
+    }
+    return mMax;
+}
+
+#ifdef WITH_TBB
+#define STATS_LOCK tbb::spin_mutex::scoped_lock lock(mMutex);
+#else
+#define STATS_LOCK
+#endif
+
+FrameLatencyStatistics::FrameLatencyStatistics(unsigned maxFramesKept) :
+    mMaxFramesKept(maxFramesKept)
+  , mFramesNumber(0)
+{
+    for (int i = 0; i < DROP_CAUSE_NUMBER; i++)
+        mDropped[i] = 0;
+}
+
+void FrameLatencyStatistics::addFrame(const FrameLifecycle &lifecycle)
+{
+    int64_t intervals[INTERVAL_NUMBER];
+    intervals[LATENCY]          = lifecycle.latency();
+    intervals[CAPTURE_WAIT]     = lifecycle.interval(FrameLifecycle::SENSOR,            FrameLifecycle::DEQUEUE);
+    intervals[DECODING]         = lifecycle.interval(FrameLifecycle::DEQUEUE,           FrameLifecycle::DECODE_DONE);
+    intervals[CALCULATION_WAIT] = lifecycle.interval(FrameLifecycle::DECODE_DONE,       FrameLifecycle::CALCULATION_START);
+    intervals[CALCULATION]      = lifecycle.interval(FrameLifecycle::CALCULATION_START, FrameLifecycle::CALCULATION_END);
+    intervals[DELIVERY]         = lifecycle.interval(FrameLifecycle::CALCULATION_END,   FrameLifecycle::OUTPUT_DELIVERED);
+
+    STATS_LOCK
+    mFramesNumber++;
+    for (int i = 0; i < INTERVAL_NUMBER; i++)
+    {
+        /* Unknown stamps and clocks that went backwards are not counted */
+        if (intervals[i] >= 0)
+            mHistograms[i].add((uint64_t)intervals[i]);
+    }
+
+    mLatestFrames.push_back(lifecycle);
+    if (mLatestFrames.size() > mMaxFramesKept)
+        mLatestFrames.pop_front();
+}
+
+void FrameLatencyStatistics::addDrop(DropCause cause, uint64_t count)
+{
+    STATS_LOCK
+    mDropped[cause] += count;
+}
+
+void FrameLatencyStatistics::addQueueDepth(const string &queue, int depth)
+{
+    STATS_LOCK
+    QueueDepth &stat = mQueues[queue];
+    stat.last = depth;
+    stat.max  = CORE_MAX(stat.max, depth);
+    stat.sum += depth;
+    stat.samples++;
+}
+
+void FrameLatencyStatistics::reset()
+{
+    STATS_LOCK
+    mFramesNumber = 0;
+    for (int i = 0; i < DROP_CAUSE_NUMBER; i++)
+        mDropped[i] = 0;
+    for (int i = 0; i < INTERVAL_NUMBER; i++)
+        mHistograms[i].reset();
+    mQueues.clear();
+    mLatestFrames.clear();
+}
+
+uint64_t FrameLatencyStatistics::framesNumber()
+{
+    STATS_LOCK
+    return mFramesNumber;
+}
+
+uint64_t FrameLatencyStatistics::droppedNumber(DropCause cause)
+{
+    STATS_LOCK
+    return mDropped[cause];
+}
+
+uint64_t FrameLatencyStatistics::droppedNumber()
+{
+    STATS_LOCK
+    uint64_t sum = 0;
+    for (int i = 0; i < DROP_CAUSE_NUMBER; i++)
+        sum += mDropped[i];
+    return sum;
+}
+
+LatencyHistogram FrameLatencyStatistics::histogram(Interval interval)
+{
+    STATS_LOCK
+    return mHistograms[interval];
+}
+
+int FrameLatencyStatistics::maxQueueDepth(const string &queue)
+{
+    STATS_LOCK
+    map<string, QueueDepth>::iterator it = mQueues.find(queue);
+    return (it == mQueues.end()) ? 0 : it->second.max;
+}
+
+int FrameLatencyStatistics::lastQueueDepth(const string &queue)
+{
+    STATS_LOCK
+    map<string, QueueDepth>::iterator it = mQueues.find(queue);
+    return (it == mQueues.end()) ? 0 : it->second.last;
+}
+
+vector<FrameLifecycle> FrameLatencyStatistics::latestFrames()
+{
+    STATS_LOCK
+    return vector<FrameLifecycle>(mLatestFrames.begin(), mLatestFrames.end());
+}
+
+void FrameLatencyStatistics::printSummaryCsv(std::ostream &stream)
+{
+    STATS_LOCK
+    stream << "kind,name,count,mean_us,min_us,p50_us,p90_us,p99_us,max_us\n";
+    for (int i = 0; i < INTERVAL_NUMBER; i++)
+    {
+        const LatencyHistogram &histogram = mHistograms[i];
+        stream << "interval," << intervalNames[i]
+               << "," << histogram.count()
+               << "," << histogram.mean()
+               << "," << histogram.min()
+               << "," << histogram.percentile(0.50)
+               << "," << histogram.percentile(0.90)
+               << "," << histogram.percentile(0.99)
+               << "," << histogram.max() << "\n";
+    }
+
+    stream << "frames,Delivered," << mFramesNumber << ",,,,,,\n";
+    for (int i = 0; i < DROP_CAUSE_NUMBER; i++)
+    {
+        stream << "drop," << dropCauseNames[i] << "," << mDropped[i] << ",,,,,,\n";
+    }
+
+    /* For the queues the values are depths, not microseconds */
+    for (map<string, QueueDepth>::iterator it = mQueues.begin(); it != mQueues.end(); ++it)
+    {
+        const QueueDepth &depth = it->second;
+        stream << "queue," << it->first
+               << "," << depth.samples
+               << "," << (depth.samples ? (double)depth.sum / depth.samples : 0.0)
+               << ",,,,," << depth.max << "\n";
+    }
+}
+
+void FrameLatencyStatistics::printFramesCsv(std::ostream &stream)
+{
+    STATS_LOCK
+    for (int i = 0; i < FrameLifecycle::STAMP_NUMBER; i++)
+    {
+        stream << FrameLifecycle::names[i] << ",";
+    }
+    stream << "Latency\n";
+
+    for (size_t j = 0; j < mLatestFrames.size(); j++)
+    {
+        const FrameLifecycle &lifecycle = mLatestFrames[j];
+        for (int i = 0; i < FrameLifecycle::STAMP_NUMBER; i++)
+        {
+            stream << lifecycle.stamps[i] << ",";
+        }
+        stream << lifecycle.latency() << "\n";
+    }
+}
+
+bool FrameLatencyStatistics::dumpCsv(const string &fileName)
+{
+    std::ofstream stream(fileName.c_str());
+    if (!stream)
+        return false;
+
+    printSummaryCsv(stream);
+    stream << "\n";
+    printFramesCsv(stream);
+    return stream.good();
+}
+
+#undef STATS_LOCK
+
+} //namespace corecvs
@@ -0,0 +1,259 @@
+#pragma once
+/**
+ * \file frameLatencyStatistics.h
+ * \brief Lifecycle stamps of the captured frames, latency histograms and drop accounting
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <ostream>
+
+#ifdef WITH_TBB
+#include <tbb/spin_mutex.h>
+#endif
+
+#include "global.h"
+
+#include "preciseTimer.h"
+
+namespace corecvs {
+
+using std::string;
+using std::vector;
+using std::map;
+using std::deque;
+
+/**
+ *  Moments of the frame life from the sensor to the output.
+ *  All the stamps are in microseconds of the PreciseTimer clock, zero means that the stamp is unknown.
+ **/
+class FrameLifecycle
+{
+public:
+    enum Stamp
+    {
+        SENSOR,            /**< Timestamp of the driver. Set only by the sources that can bring it to the PreciseTimer clock */
+        DEQUEUE,           /**< Frame is requested from the capture interface */
+        DECODE_DONE,       /**< Frame is decoded and returned by the capture interface */
+        CALCULATION_START,
+        CALCULATION_END,
+        OUTPUT_DELIVERED,  /**< Host has received the result */
+        STAMP_NUMBER
+    };
+
+    static const char *names[];
+
+    uint64_t stamps[STAMP_NUMBER];
+
+    FrameLifecycle()
+    {
+        for (int i = 0; i < STAMP_NUMBER; i++)
+            stamps[i] = 0;
+    }
+
+    void stamp(Stamp id)
+    {
+        stamps[id] = PreciseTimer::currentTime().usec();
+    }
+
+    bool has(Stamp id) const
+    {
+        return stamps[id] != 0;
+    }
+
+    /**
+     * Time between two stamps, or -1 if any of them is unknown
+     **/
+    int64_t interval(Stamp from, Stamp to) const
+    {
+        if (!has(from) || !has(to))
+            return -1;
+        return (int64_t)(stamps[to] - stamps[from]);
+    }
+
+    /**
+     * Glass to output latency. If the sensor stamp is not known the dequeue time is used instead.
+     **/
+    int64_t latency() const
+    {
+        return interval(has(SENSOR) ? SENSOR : DEQUEUE, OUTPUT_DELIVERED);
+    }
+
+    /**
+     * Current time of the monotonic clock in microseconds, the drivers usually stamp the frames with it.
+     * \return false if the platform has no such clock
+     **/
+    static bool monotonicTime(int64_t &usec);
+
+    /**
+     * Difference of the PreciseTimer clock and the monotonic one, to be added to the monotonic stamps.
+     * The clocks drift apart, so it should be taken anew for every frame.
+     **/
+    static bool monotonicOffset(int64_t &offset);
+};
+
+/**
+ *  Histogram of the durations with buckets of equal width. The values above
+ *  the last bucket are counted in the overflow bucket, exact minimum and maximum are kept too.
+ **/
+class LatencyHistogram
+{
+public:
+    explicit LatencyHistogram(uint64_t bucketUsec = 1000, int bucketsNumber = 500) :
+        mBucketUsec(bucketUsec > 0 ? bucketUsec : 1)
+      , mBuckets(bucketsNumber + 1, 0)
+    {
+        reset();
+    }
+
+    void add(uint64_t usec)
+    {
+        uint64_t bucket = usec / mBucketUsec;
+        if (bucket >= mBuckets.size())
+            bucket = mBuckets.size() - 1;
+        mBuckets[(size_t)bucket]++;
+
+        mCount++;
+        mSum += usec;
+        if (usec < mMin) mMin = usec;
+        if (usec > mMax) mMax = usec;
+    }
+
+    void reset()
+    {
+        for (size_t i = 0; i < mBuckets.size(); i++)
+            mBuckets[i] = 0;
+        mCount = 0;
+        mSum   = 0;
+        mMin   = (uint64_t)-1;
+        mMax   = 0;
+    }
+
+    uint64_t count() const { return mCount; }
+    uint64_t min()   const { return mCount ? mMin : 0; }
+    uint64_t max()   const { return mMax; }
+    uint64_t mean()  const { return mCount ? mSum / mCount : 0; }
+
+    /**
+     * Upper bound of the bucket that contains the given fraction of values. The result is
+     * clamped by the exact maximum, so it is never worse than it.
+     **/
+    uint64_t percentile(double fraction) const;
+
+    uint64_t bucketUsec() const { return mBucketUsec; }
+    const vector<uint64_t> &buckets() const { return mBuckets; }
+
+private:
+    uint64_t         mBucketUsec;
+    vector<uint64_t> mBuckets;
+    uint64_t         mCount;
+    uint64_t         mSum;
+    uint64_t         mMin;
+    uint64_t         mMax;
+};
+
+/**
+ *  End to end accounting of the frames. The capture and calculation threads report dropped frames
+ *  and queue depths, and the host reports the delivered frames with their lifecycles.
+ *
+ *  All the methods are thread safe.
+ **/
+class FrameLatencyStatistics
+{
+public:
+    enum DropCause
+    {
+        DROP_CAPTURE_SKIPPED,  /**< Frame was overwritten in the capture interface before it was requested */
+        DROP_CALCULATION_BUSY, /**< Calculation thread was processing the previous frame */
+        DROP_REPEATED_FRAME,   /**< Notification about the frame that was already processed */
+        DROP_PAUSED,           /**< Calculation is paused */
+        DROP_NO_FRAMES,        /**< Capture interface returned no frames */
+        DROP_QUEUE_FULL,       /**< Frame was evicted from the full queue of the pipeline */
+        DROP_CAUSE_NUMBER
+    };
+
+    static const char *dropCauseNames[];
+
+    /** Intervals that get their own histograms, see intervalName() */
+    enum Interval
+    {
+        LATENCY,          /**< Glass to output, see FrameLifecycle::latency() */
+        CAPTURE_WAIT,     /**< From sensor to dequeue */
+        DECODING,         /**< From dequeue to decode done */
+        CALCULATION_WAIT, /**< From decode done to calculation start */
+        CALCULATION,      /**< From calculation start to end */
+        DELIVERY,         /**< From calculation end to output delivered */
+        INTERVAL_NUMBER
+    };
+
+    static const char *intervalNames[];
+
+    explicit FrameLatencyStatistics(unsigned maxFramesKept = 4096);
+
+    void addFrame(const FrameLifecycle &lifecycle);
+    void addDrop(DropCause cause, uint64_t count = 1);
+    void addQueueDepth(const string &queue, int depth);
+
+    void reset();
+
+    /* Queries */
+    uint64_t framesNumber();
+    uint64_t droppedNumber(DropCause cause);
+    uint64_t droppedNumber();
+    LatencyHistogram histogram(Interval interval);
+    /** Maximum and last depth of the queue */
+    int maxQueueDepth (const string &queue);
+    int lastQueueDepth(const string &queue);
+    /** Lifecycles of the latest delivered frames */
+    vector<FrameLifecycle> latestFrames();
+
+    /**
+     * Writes the summary: one row for each interval, drop cause and queue
+     **/
+    void printSummaryCsv(std::ostream &stream);
+
+    /**
+     * Writes the stamps of the latest delivered frames, one row per frame
+     **/
+    void printFramesCsv(std::ostream &stream);
+
+    /**
+     * Writes the summary, and then the frames
+     **/
+    bool dumpCsv(const string &fileName);
+
+private:
+    struct QueueDepth
+    {
+        int last;
+        int max;
+        uint64_t sum;
+        uint64_t samples;
+
+        QueueDepth() : last(0), max(0), sum(0), samples(0) {}
+    };
+
+    unsigned                 mMaxFramesKept;
+    uint64_t                 mFramesNumber;
+    uint64_t                 mDropped[DROP_CAUSE_NUMBER];
+    LatencyHistogram         mHistograms[INTERVAL_NUMBER];
+    map<string, QueueDepth>  mQueues;
+    deque<FrameLifecycle>    mLatestFrames;
+
+#ifdef WITH_TBB
+    tbb::spin_mutex mMutex;
+#endif
+
+    FrameLatencyStatistics(const FrameLatencyStatistics &);
+    FrameLatencyStatistics &operator =(const FrameLatencyStatistics &);
+};
+
+} //namespace corecvs
+
+/* EOF */
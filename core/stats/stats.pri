@@ -1,8 +1,12 @@
 HEADERS += \
     stats/calculationStats.h \
+    stats/zoneTracer.h \
+    stats/frameLatencyStatistics.h \
     
 
 
 SOURCES += \
     stats/calculationStats.cpp \
+    stats/zoneTracer.cpp \
+    stats/frameLatencyStatistics.cpp \
 
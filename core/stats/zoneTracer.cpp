@@ -0,0 +1,274 @@
+/**
+ * \file zoneTracer.cpp
+ * \brief Registry of the zones and ring buffers, export of the recorded events
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <fstream>
+
+#if defined(WITH_TBB)
+#   include <tbb/spin_mutex.h>
+#elif defined(_MSC_VER)
+#   include <windows.h>
+#   undef min
+#   undef max
+#else
+#   include <pthread.h>
+#endif
+
+#include "global.h"
+
+#include "zoneTracer.h"
+
+namespace corecvs {
+
+bool                          ZoneTracer::mEnabled    = false;
+CORE_THREAD_LOCAL TraceRing  *ZoneTracer::mThreadRing = NULL;
+
+/* Registry is only touched when a zone or a thread is seen for the first time, and by the readers */
+static vector<const TraceZoneInfo *> traceZones;
+static vector<TraceRing *>           traceRings;
+static double                        traceTicksPerUsec = 0.0;
+static uint64_t                      traceStartTicks   = 0;
+
+/*
+ * Zones are entered from several threads even without TBB, for example by the capture threads.
+ * The fallback locks are initialized statically, because zones could be registered by the static constructors.
+ */
+#if defined(WITH_TBB)
+static tbb::spin_mutex traceMutex;
+#define TRACE_LOCK tbb::spin_mutex::scoped_lock lock(traceMutex);
+#elif defined(_MSC_VER)
+static SRWLOCK traceMutex = SRWLOCK_INIT;
+
+class TraceLock
+{
+public:
+    TraceLock()  { AcquireSRWLockExclusive(&traceMutex); }
+    ~TraceLock() { ReleaseSRWLockExclusive(&traceMutex); }
+};
+#define TRACE_LOCK TraceLock lock;
+#else
+static pthread_mutex_t traceMutex = PTHREAD_MUTEX_INITIALIZER;
+
+class TraceLock
+{
+public:
+    TraceLock()  { pthread_mutex_lock  (&traceMutex); }
+    ~TraceLock() { pthread_mutex_unlock(&traceMutex); }
+};
+#define TRACE_LOCK TraceLock lock;
+#endif
+
+TraceZoneInfo::TraceZoneInfo(const char *_name, const char *_file, int _line) :
+    name(_name)
+  , file(_file)
+  , line(_line)
+{
+    id = ZoneTracer::registerZone(this);
+}
+
+uint32_t ZoneTracer::registerZone(const TraceZoneInfo *zone)
+{
+    TRACE_LOCK
+    traceZones.push_back(zone);
+    return (uint32_t)(traceZones.size() - 1);
+}
+
+vector<const TraceZoneInfo *> ZoneTracer::zones()
+{
+    TRACE_LOCK
+    return traceZones;
+}
+
+TraceRing *ZoneTracer::createThreadRing()
+{
+    TRACE_LOCK
+    /* Rings are never deleted, the events of the finished threads could still be exported */
+    TraceRing *ring = new TraceRing((int)traceRings.size() + 1);
+    traceRings.push_back(ring);
+    return ring;
+}
+
+static void calibrateTicks()
+{
+    PreciseTimer start      = PreciseTimer::currentTime();
+    uint64_t     startTicks = ZoneTracer::ticks();
+    while (start.usecsToNow() < 20000)
+    {
+        /* Busy wait, so the counter keeps running at the working frequency */
+    }
+    int64_t  usecs = start.usecsToNow();
+    uint64_t ticks = ZoneTracer::ticks() - startTicks;
+    traceTicksPerUsec = (double)ticks / usecs;
+}
+
+void ZoneTracer::setEnabled(bool enabled)
+{
+    if (enabled && traceTicksPerUsec == 0.0)
+    {
+        calibrateTicks();
+        traceStartTicks = ticks();
+    }
+    mEnabled = enabled;
+}
+
+double ZoneTracer::ticksPerUsec()
+{
+    if (traceTicksPerUsec == 0.0)
+        calibrateTicks();
+    return traceTicksPerUsec;
+}
+
+static inline uint64_t loadWritten(TraceRing *ring)
+{
+#if defined(__GNUC__)
+    return __atomic_load_n(&ring->written, __ATOMIC_ACQUIRE);
+#else
+    return ring->written;
+#endif
+}
+
+/**
+ * Index of the oldest event that is surely not overwritten. The slot of the event
+ * number \c written could be being overwritten right now.
+ **/
+static inline uint64_t firstIntact(uint64_t written)
+{
+    return (written + 1 > TraceRing::CAPACITY) ? written + 1 - TraceRing::CAPACITY : 0;
+}
+
+/**
+ * Copies the events of the ring starting from the index \c from, and drops the ones
+ * that the writer has overwritten while they were copied
+ **/
+static uint64_t readRing(TraceRing *ring, uint64_t from, vector<TraceEvent> &events)
+{
+    uint64_t written = loadWritten(ring);
+    from = CORE_MAX(from, firstIntact(written));
+
+    size_t oldSize = events.size();
+    for (uint64_t i = from; i < written; i++)
+        events.push_back(ring->events[i & TraceRing::MASK]);
+
+    uint64_t intact = firstIntact(loadWritten(ring));
+    if (intact > from)
+    {
+        size_t lost = (size_t)(CORE_MIN(written, intact) - from);
+        events.erase(events.begin() + oldSize, events.begin() + oldSize + lost);
+    }
+    return written;
+}
+
+void ZoneTracer::collect(BaseTimeStatisticsCollector &collector)
+{
+    vector<const TraceZoneInfo *> zoneList;
+    vector<TraceRing *> rings;
+    {
+        TRACE_LOCK
+        zoneList = traceZones;
+        rings    = traceRings;
+    }
+
+    double tickRate = ticksPerUsec();
+    vector<TraceEvent> events;
+    for (unsigned i = 0; i < rings.size(); i++)
+    {
+        events.clear();
+        rings[i]->collected = readRing(rings[i], CORE_MAX(rings[i]->collected, rings[i]->cleared), events);
+
+        for (unsigned j = 0; j < events.size(); j++)
+        {
+            const TraceEvent &event = events[j];
+            if (event.zone >= zoneList.size())
+                continue;
+            uint64_t duration = (uint64_t)((event.end - event.start) / tickRate);
+            collector.addSingleStat(zoneList[event.zone]->name, SingleStat(duration));
+        }
+    }
+}
+
+/* Zone names are string literals, but they still could contain quotes */
+static void writeJsonString(std::ostream &stream, const char *str)
+{
+    stream << '"';
+    for (const char *c = str; *c != 0; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            stream << '\\';
+        stream << *c;
+    }
+    stream << '"';
+}
+
+void ZoneTracer::exportChromeTrace(std::ostream &stream)
+{
+    vector<const TraceZoneInfo *> zoneList;
+    vector<TraceRing *> rings;
+    {
+        TRACE_LOCK
+        zoneList = traceZones;
+        rings    = traceRings;
+    }
+
+    double tickRate = ticksPerUsec();
+    bool first = true;
+
+    stream << "{\"traceEvents\":[\n";
+    vector<TraceEvent> events;
+    for (unsigned i = 0; i < rings.size(); i++)
+    {
+        events.clear();
+        readRing(rings[i], rings[i]->cleared, events);
+
+        for (unsigned j = 0; j < events.size(); j++)
+        {
+            const TraceEvent &event = events[j];
+            if (event.zone >= zoneList.size())
+                continue;
+
+            double ts  = (double)(int64_t)(event.start - traceStartTicks) / tickRate;
+            double dur = (double)(event.end - event.start) / tickRate;
+
+            if (!first)
+                stream << ",\n";
+            first = false;
+
+            stream << "{\"name\":";
+            writeJsonString(stream, zoneList[event.zone]->name);
+            stream << ",\"cat\":\"corecvs\",\"ph\":\"X\""
+                   << ",\"ts\":"  << ts
+                   << ",\"dur\":" << dur
+                   << ",\"pid\":1,\"tid\":" << rings[i]->threadId
+                   << ",\"args\":{\"depth\":" << event.depth << "}}";
+        }
+    }
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool ZoneTracer::exportChromeTrace(const string &fileName)
+{
+    std::ofstream stream(fileName.c_str());
+    if (!stream)
+        return false;
+
+    stream.precision(15);
+    exportChromeTrace(stream);
+    return stream.good();
+}
+
+void ZoneTracer::clear()
+{
+    TRACE_LOCK
+    for (unsigned i = 0; i < traceRings.size(); i++)
+    {
+        uint64_t written = loadWritten(traceRings[i]);
+        traceRings[i]->collected = written;
+        traceRings[i]->cleared   = written;
+    }
+}
+
+#undef TRACE_LOCK
+
+} //namespace corecvs
@@ -0,0 +1,227 @@
+#pragma once
+/**
+ * \file zoneTracer.h
+ * \brief Low overhead tracing of the code zones
+ *
+ * Hot code is marked with the TRACE_ZONE macro
+ * \code
+ *    void process()
+ *    {
+ *        TRACE_ZONE("Process");
+ *        ...
+ *    }
+ * \endcode
+ *
+ * The macro places a static zone descriptor into the function, so the zone is registered
+ * only once, and a scoped object that records the start and end of the zone.
+ * Events are written to the ring buffer of the current thread without any locks.
+ *
+ * Tracing is compiled in only with WITH_TRACING (CONFIG += with_tracing). Without it the
+ * macro expands to nothing. With it, and tracing disabled at runtime, a zone costs
+ * one load and one branch.
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "global.h"
+
+#include "calculationStats.h"
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#   define CORE_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#   if defined(__i386__) || defined(__x86_64__)
+#       include <x86intrin.h>
+#   endif
+#   define CORE_THREAD_LOCAL __thread
+#endif
+
+namespace corecvs {
+
+using std::string;
+using std::vector;
+
+/**
+ * Descriptor of the zone. Every TRACE_ZONE() has its own static instance,
+ * the identifier is assigned when the zone is first entered.
+ **/
+class TraceZoneInfo
+{
+public:
+    const char *name;
+    const char *file;
+    int         line;
+    uint32_t    id;
+
+    TraceZoneInfo(const char *_name, const char *_file, int _line);
+};
+
+struct TraceEvent
+{
+    uint64_t start;
+    uint64_t end;
+    uint32_t zone;
+    uint32_t depth;
+};
+
+/**
+ * Ring buffer of the single thread. Only the owner thread writes to it,
+ * readers check that the events they have read were not overwritten meanwhile.
+ **/
+class TraceRing
+{
+public:
+    static const unsigned CAPACITY = 1 << 14;
+    static const unsigned MASK     = CAPACITY - 1;
+
+    TraceEvent        events[CAPACITY];
+    /** Total number of events ever written */
+    volatile uint64_t written;
+    /** Number of events already taken by ZoneTracer::collect() */
+    uint64_t          collected;
+    /** Events before this one were dropped by ZoneTracer::clear() */
+    uint64_t          cleared;
+    uint32_t          depth;
+    int               threadId;
+
+    explicit TraceRing(int _threadId) :
+        written(0)
+      , collected(0)
+      , cleared(0)
+      , depth(0)
+      , threadId(_threadId)
+    {}
+
+    void push(uint64_t start, uint64_t end, uint32_t zone)
+    {
+        TraceEvent &event = events[written & MASK];
+        event.start = start;
+        event.end   = end;
+        event.zone  = zone;
+        event.depth = depth;
+#if defined(__GNUC__)
+        __atomic_store_n(&written, written + 1, __ATOMIC_RELEASE);
+#else
+        /* MSVC volatile stores have release semantics */
+        written = written + 1;
+#endif
+    }
+};
+
+class ZoneTracer
+{
+public:
+    static bool enabled()
+    {
+        return mEnabled;
+    }
+
+    /**
+     * Enables recording of the zones. The first call calibrates the tick counter.
+     **/
+    static void setEnabled(bool enabled);
+
+    static inline uint64_t ticks()
+    {
+#if defined(_MSC_VER) || (defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)))
+        return __rdtsc();
+#else
+        return PreciseTimer::currentTime().usec();
+#endif
+    }
+
+    /** Ticks of the counter per microsecond */
+    static double ticksPerUsec();
+
+    static TraceRing *threadRing()
+    {
+        if (mThreadRing == NULL)
+            mThreadRing = createThreadRing();
+        return mThreadRing;
+    }
+
+    static uint32_t registerZone(const TraceZoneInfo *zone);
+
+    /** Names of the registered zones indexed by the zone id */
+    static vector<const TraceZoneInfo *> zones();
+
+    /**
+     * Adds the durations of all the events that were not collected yet to the collector.
+     * Each zone becomes a separate time stat named by the zone.
+     **/
+    static void collect(BaseTimeStatisticsCollector &collector);
+
+    /**
+     * Writes all the events that are still in the ring buffers in the Chrome trace
+     * JSON format. It could be opened by chrome://tracing or Perfetto UI.
+     **/
+    static void exportChromeTrace(std::ostream &stream);
+    static bool exportChromeTrace(const string &fileName);
+
+    /**
+     * Forgets all the recorded events, they would be neither collected nor exported
+     **/
+    static void clear();
+
+private:
+    static bool mEnabled;
+    static CORE_THREAD_LOCAL TraceRing *mThreadRing;
+
+    static TraceRing *createThreadRing();
+};
+
+/**
+ * Scoped object that records the zone
+ **/
+class TraceScope
+{
+public:
+    explicit TraceScope(const TraceZoneInfo *zone)
+    {
+        if (!ZoneTracer::enabled())
+        {
+            mRing = NULL;
+            return;
+        }
+        mZone  = zone;
+        mRing  = ZoneTracer::threadRing();
+        mRing->depth++;
+        mStart = ZoneTracer::ticks();
+    }
+
+    ~TraceScope()
+    {
+        if (mRing == NULL)
+            return;
+        uint64_t end = ZoneTracer::ticks();
+        mRing->depth--;
+        mRing->push(mStart, end, mZone->id);
+    }
+
+private:
+    TraceRing           *mRing;
+    const TraceZoneInfo *mZone;
+    uint64_t             mStart;
+};
+
+} //namespace corecvs
+
+#define TRACE_ZONE_CONCAT_IMPL(A, B) A##B
+#define TRACE_ZONE_CONCAT(A, B) TRACE_ZONE_CONCAT_IMPL(A, B)
+
+#ifdef WITH_TRACING
+#define TRACE_ZONE(name)                                                                                  \
+    static corecvs::TraceZoneInfo TRACE_ZONE_CONCAT(traceZoneInfo, __LINE__)(name, __FILE__, __LINE__);  \
+    corecvs::TraceScope TRACE_ZONE_CONCAT(traceScope, __LINE__)(&TRACE_ZONE_CONCAT(traceZoneInfo, __LINE__))
+#else
+#define TRACE_ZONE(name)
+#endif
+
+/* EOF */
@@ -0,0 +1,674 @@
+/**
+ * \file asyncLog.cpp
+ * \brief Lock-free record queue and the drain thread of the asynchronous log
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <stdio.h>
+#include <time.h>
+
+#if defined(_MSC_VER)
+#   include <windows.h>
+#   undef min
+#   undef max
+#else
+#   include <pthread.h>
+#   include <unistd.h>
+#endif
+
+#include "global.h"
+
+#include "asyncLog.h"
+#include "preciseTimer.h"
+
+using corecvs::PreciseTimer;
+
+STATIC_ASSERT(Log::LEVEL_DETAILED_DEBUG == 0 && Log::LEVEL_DEBUG   == 1 && Log::LEVEL_INFO == 2 &&
+              Log::LEVEL_WARNING        == 3 && Log::LEVEL_ERROR   == 4, wrong_levels_of_log_macros);
+
+/* Atomic operations. The queue follows the bounded queue of D. Vyukov, each cell has the sequence number */
+
+#if defined(__GNUC__)
+
+static inline int64_t atomicLoad(volatile int64_t *ptr)
+{
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+static inline void atomicStore(volatile int64_t *ptr, int64_t value)
+{
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+static inline bool atomicCompareExchange(volatile int64_t *ptr, int64_t expected, int64_t value)
+{
+    return __atomic_compare_exchange_n(ptr, &expected, value, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static inline int64_t atomicAdd(volatile int64_t *ptr, int64_t value)
+{
+    return __atomic_add_fetch(ptr, value, __ATOMIC_ACQ_REL);
+}
+
+static inline int64_t atomicExchange(volatile int64_t *ptr, int64_t value)
+{
+    return __atomic_exchange_n(ptr, value, __ATOMIC_ACQ_REL);
+}
+
+#elif defined(_MSC_VER)
+
+/* Volatile accesses of MSVC on x86 have the acquire and release semantics */
+static inline int64_t atomicLoad(volatile int64_t *ptr)
+{
+    return *ptr;
+}
+
+static inline void atomicStore(volatile int64_t *ptr, int64_t value)
+{
+    *ptr = value;
+}
+
+static inline bool atomicCompareExchange(volatile int64_t *ptr, int64_t expected, int64_t value)
+{
+    return InterlockedCompareExchange64((volatile LONGLONG *)ptr, value, expected) == expected;
+}
+
+static inline int64_t atomicAdd(volatile int64_t *ptr, int64_t value)
+{
+    return InterlockedExchangeAdd64((volatile LONGLONG *)ptr, value) + value;
+}
+
+static inline int64_t atomicExchange(volatile int64_t *ptr, int64_t value)
+{
+    return InterlockedExchange64((volatile LONGLONG *)ptr, value);
+}
+
+#endif
+
+struct AsyncLogCell
+{
+    volatile int64_t sequence;
+    AsyncLogRecord   record;
+};
+
+/* Producers and the consumer positions are kept on the different cache lines */
+struct AsyncLogQueue
+{
+    AsyncLogCell     *cells;
+    int64_t           mask;
+    char              pad0[64];
+    volatile int64_t  enqueuePos;
+    char              pad1[64];
+    volatile int64_t  dequeuePos;
+    char              pad2[64];
+
+    volatile int64_t  running;
+    volatile int64_t  threadStarted;
+
+    /* Wall clock at the start, the records only take the cheap PreciseTimer stamp */
+    time_t            startTime;
+    int64_t           startUsec;
+
+    volatile int64_t  queued;
+    volatile int64_t  drained;
+    volatile int64_t  dropped;
+    volatile int64_t  suppressed;
+    volatile int64_t  synchronous;
+};
+
+static AsyncLogQueue asyncQueue = { NULL, 0, {0}, 0, {0}, 0, {0}, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+#if defined(_MSC_VER)
+static HANDLE drainThread;
+#else
+static pthread_t drainThread;
+#endif
+
+static void sleepMilliseconds(int ms)
+{
+#if defined(_MSC_VER)
+    Sleep(ms);
+#else
+    usleep(ms * 1000);
+#endif
+}
+
+/** Passes the record to the drains of Log */
+static void deliver(const AsyncLogRecord &record)
+{
+    Log::Message message;
+    message.allocate();
+    message.get()->mLevel              = (Log::LogLevel)record.level;
+    message.get()->mLog                = NULL;
+    message.get()->mOriginFileName     = record.file;
+    message.get()->mOriginLineNumber   = record.line;
+    message.get()->mOriginFunctionName = record.function;
+    if (asyncQueue.startUsec != 0) {
+        message.get()->rawtime = asyncQueue.startTime + (time_t)((record.usec - asyncQueue.startUsec) / 1000000);
+    } else {
+        time(&message.get()->rawtime);
+    }
+    message.get()->s << AsyncLog::format(record);
+    Log::drain(message);
+}
+
+/** Drains the published records, returns their number */
+static int drainAvailable()
+{
+    int count = 0;
+    while (true)
+    {
+        int64_t position = asyncQueue.dequeuePos;
+        AsyncLogCell *cell = &asyncQueue.cells[position & asyncQueue.mask];
+        if (atomicLoad(&cell->sequence) != position + 1)
+            break;
+
+        deliver(cell->record);
+        atomicStore(&cell->sequence, position + asyncQueue.mask + 1);
+        atomicStore(&asyncQueue.dequeuePos, position + 1);
+        atomicAdd(&asyncQueue.drained, 1);
+        count++;
+    }
+    return count;
+}
+
+static void drainLoop()
+{
+    while (true)
+    {
+        if (drainAvailable() != 0)
+            continue;
+        if (!atomicLoad(&asyncQueue.running))
+        {
+            /* The records that are claimed but not yet published are waited for */
+            if (atomicLoad(&asyncQueue.dequeuePos) == atomicLoad(&asyncQueue.enqueuePos))
+                break;
+        }
+        sleepMilliseconds(1);
+    }
+}
+
+#if defined(_MSC_VER)
+static DWORD WINAPI drainThreadProc(LPVOID /*parameter*/)
+{
+    drainLoop();
+    return 0;
+}
+#else
+static void *drainThreadProc(void * /*parameter*/)
+{
+    drainLoop();
+    return NULL;
+}
+#endif
+
+bool AsyncLog::start(int capacity)
+{
+    if (isRunning())
+        return true;
+
+    if (asyncQueue.cells == NULL)
+    {
+        int64_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        asyncQueue.cells = new AsyncLogCell[(size_t)size];
+        for (int64_t i = 0; i < size; i++)
+            asyncQueue.cells[i].sequence = i;
+        asyncQueue.mask = size - 1;
+    }
+
+    asyncQueue.startTime = time(NULL);
+    asyncQueue.startUsec = PreciseTimer::currentTime().usec();
+    atomicStore(&asyncQueue.running, 1);
+
+#if defined(_MSC_VER)
+    drainThread = CreateThread(NULL, 0, drainThreadProc, NULL, 0, NULL);
+    bool started = (drainThread != NULL);
+#else
+    bool started = (pthread_create(&drainThread, NULL, drainThreadProc, NULL) == 0);
+#endif
+    if (!started)
+    {
+        atomicStore(&asyncQueue.running, 0);
+        return false;
+    }
+    atomicStore(&asyncQueue.threadStarted, 1);
+    return true;
+}
+
+void AsyncLog::stop()
+{
+    if (!atomicLoad(&asyncQueue.threadStarted))
+        return;
+
+    atomicStore(&asyncQueue.running, 0);
+#if defined(_MSC_VER)
+    WaitForSingleObject(drainThread, INFINITE);
+    CloseHandle(drainThread);
+#else
+    pthread_join(drainThread, NULL);
+#endif
+    atomicStore(&asyncQueue.threadStarted, 0);
+}
+
+bool AsyncLog::isRunning()
+{
+    return atomicLoad(&asyncQueue.running) != 0;
+}
+
+void AsyncLog::flush()
+{
+    int64_t target = atomicLoad(&asyncQueue.enqueuePos);
+    while (isRunning() && atomicLoad(&asyncQueue.dequeuePos) < target)
+        sleepMilliseconds(1);
+}
+
+AsyncLog::Statistics AsyncLog::statistics()
+{
+    Statistics result;
+    result.queued      = (uint64_t)atomicLoad(&asyncQueue.queued);
+    result.drained     = (uint64_t)atomicLoad(&asyncQueue.drained);
+    result.dropped     = (uint64_t)atomicLoad(&asyncQueue.dropped);
+    result.suppressed  = (uint64_t)atomicLoad(&asyncQueue.suppressed);
+    result.synchronous = (uint64_t)atomicLoad(&asyncQueue.synchronous);
+    return result;
+}
+
+void AsyncLog::resetStatistics()
+{
+    atomicStore(&asyncQueue.queued     , 0);
+    atomicStore(&asyncQueue.drained    , 0);
+    atomicStore(&asyncQueue.dropped    , 0);
+    atomicStore(&asyncQueue.suppressed , 0);
+    atomicStore(&asyncQueue.synchronous, 0);
+}
+
+/**
+ *  Rate limiter of the site, the window of one second starts with the first message after
+ *  the previous window. Returns false if the message should be suppressed, the number of
+ *  the suppressed messages is taken by the first message of the new window.
+ **/
+static bool passRateLimit(AsyncLogSite *site, int64_t now, int64_t *suppressed)
+{
+    *suppressed = 0;
+    if (site->maxRate <= 0)
+        return true;
+
+    int64_t windowStart = atomicLoad(&site->windowStart);
+    if (windowStart == 0 || now - windowStart >= 1000000)
+    {
+        if (atomicCompareExchange(&site->windowStart, windowStart, now))
+        {
+            atomicStore(&site->count, 0);
+            *suppressed = atomicExchange(&site->suppressed, 0);
+        }
+    }
+
+    if (atomicAdd(&site->count, 1) > site->maxRate)
+    {
+        atomicAdd(&site->suppressed, 1);
+        atomicAdd(&asyncQueue.suppressed, 1);
+        return false;
+    }
+    return true;
+}
+
+/** Claims the free cell, returns NULL if the queue is full */
+static AsyncLogRecord *claimCell()
+{
+    int64_t position = atomicLoad(&asyncQueue.enqueuePos);
+    while (true)
+    {
+        AsyncLogCell *cell = &asyncQueue.cells[position & asyncQueue.mask];
+        int64_t difference = atomicLoad(&cell->sequence) - position;
+        if (difference == 0)
+        {
+            if (atomicCompareExchange(&asyncQueue.enqueuePos, position, position + 1))
+            {
+                cell->record.cell = position;
+                return &cell->record;
+            }
+            position = atomicLoad(&asyncQueue.enqueuePos);
+        }
+        else if (difference < 0)
+        {
+            return NULL;
+        }
+        else
+        {
+            position = atomicLoad(&asyncQueue.enqueuePos);
+        }
+    }
+}
+
+static void fillRecord(AsyncLogRecord *record, int level, cchar *file, int line, cchar *function, cchar *format, int64_t usec, int64_t suppressed)
+{
+    record->format     = format;
+    record->level      = level;
+    record->file       = file;
+    record->line       = line;
+    record->function   = function;
+    record->usec       = usec;
+    record->suppressed = suppressed;
+    record->used       = 0;
+    record->truncated  = false;
+}
+
+AsyncLogRecord *AsyncLog::claim(AsyncLogSite *site, const char *format, AsyncLogRecord *local)
+{
+    if (!Log::shouldWrite((Log::LogLevel)site->level))
+        return NULL;
+
+    int64_t now = PreciseTimer::currentTime().usec();
+    int64_t suppressed = 0;
+    if (!passRateLimit(site, now, &suppressed))
+        return NULL;
+
+    AsyncLogRecord *record = local;
+    if (isRunning())
+    {
+        record = claimCell();
+        if (record == NULL)
+        {
+            atomicAdd(&asyncQueue.dropped, 1);
+            /* The count is kept, so it would be reported with the next message of the site */
+            if (suppressed != 0)
+                atomicAdd(&site->suppressed, suppressed);
+            return NULL;
+        }
+    }
+    else
+    {
+        local->cell = -1;
+    }
+
+    fillRecord(record, site->level, site->file, site->line, site->function, format, now, suppressed);
+    return record;
+}
+
+void AsyncLog::publish(AsyncLogRecord *record)
+{
+    if (record->cell < 0)
+    {
+        atomicAdd(&asyncQueue.synchronous, 1);
+        deliver(*record);
+        return;
+    }
+    AsyncLogCell *cell = &asyncQueue.cells[record->cell & asyncQueue.mask];
+    atomicAdd(&asyncQueue.queued, 1);
+    atomicStore(&cell->sequence, record->cell + 1);
+}
+
+bool AsyncLog::post(Log::Message &message)
+{
+    if (!isRunning())
+        return false;
+
+    Log::MessageInternal *internal = message.get();
+    const std::string &text = internal->s.str();
+    /* The text that does not fit the record is drained by the caller, after the records queued before it */
+    if (text.size() > AsyncLogRecord::STRING_ROOM)
+    {
+        flush();
+        atomicAdd(&asyncQueue.synchronous, 1);
+        return false;
+    }
+
+    AsyncLogRecord *record = claimCell();
+    if (record == NULL)
+    {
+        atomicAdd(&asyncQueue.dropped, 1);
+        return true;
+    }
+
+    fillRecord(record, internal->mLevel, internal->mOriginFileName, internal->mOriginLineNumber, internal->mOriginFunctionName,
+               NULL, PreciseTimer::currentTime().usec(), 0);
+    record->putString(text.c_str(), text.size());
+    publish(record);
+    return true;
+}
+
+/* Formatting of the stored arguments */
+
+namespace {
+
+/** Reader of the binary arguments */
+class ArgumentReader
+{
+public:
+    ArgumentReader(const AsyncLogRecord &record) :
+        mRecord(record),
+        mPosition(0)
+    {}
+
+    bool next(AsyncLogRecord::ArgumentType *type)
+    {
+        if (mPosition >= mRecord.used)
+            return false;
+        *type = (AsyncLogRecord::ArgumentType)mRecord.payload[mPosition];
+        mPosition++;
+        return true;
+    }
+
+    template<typename Type>
+    Type value()
+    {
+        Type result;
+        memcpy(&result, mRecord.payload + mPosition, sizeof(Type));
+        mPosition += sizeof(Type);
+        return result;
+    }
+
+    std::string string()
+    {
+        uint16_t length = value<uint16_t>();
+        std::string result(mRecord.payload + mPosition, length);
+        mPosition += length;
+        return result;
+    }
+
+private:
+    const AsyncLogRecord &mRecord;
+    int mPosition;
+};
+
+/** One stored argument converted to all the forms a conversion could ask for */
+struct Argument
+{
+    bool      isString;
+    bool      isFloat;
+    bool      isSigned;
+    long long signedValue;
+    unsigned long long unsignedValue;
+    double    doubleValue;
+    const void *pointer;
+    std::string string;
+};
+
+bool readArgument(ArgumentReader &reader, Argument *argument)
+{
+    AsyncLogRecord::ArgumentType type;
+    if (!reader.next(&type))
+        return false;
+
+    argument->isString = false;
+    argument->isFloat  = false;
+    argument->isSigned = false;
+    argument->pointer  = NULL;
+    switch (type)
+    {
+        case AsyncLogRecord::ARG_INT:
+            argument->signedValue = reader.value<int>();
+            argument->isSigned = true;
+            break;
+        case AsyncLogRecord::ARG_UINT:
+            argument->signedValue = reader.value<unsigned>();
+            break;
+        case AsyncLogRecord::ARG_INT64:
+            argument->signedValue = reader.value<long long>();
+            argument->isSigned = true;
+            break;
+        case AsyncLogRecord::ARG_UINT64:
+            argument->signedValue = (long long)reader.value<unsigned long long>();
+            break;
+        case AsyncLogRecord::ARG_DOUBLE:
+            argument->doubleValue = reader.value<double>();
+            argument->isFloat = true;
+            break;
+        case AsyncLogRecord::ARG_STRING:
+            argument->string = reader.string();
+            argument->isString = true;
+            return true;
+        case AsyncLogRecord::ARG_POINTER:
+            argument->pointer = reader.value<const void *>();
+            argument->signedValue = (long long)(size_t)argument->pointer;
+            break;
+        default:
+            return false;
+    }
+    if (argument->isFloat) {
+        argument->signedValue = (long long)argument->doubleValue;
+    } else {
+        argument->doubleValue = argument->isSigned ? (double)argument->signedValue : (double)(unsigned long long)argument->signedValue;
+    }
+    argument->unsignedValue = (unsigned long long)argument->signedValue;
+    return true;
+}
+
+bool isFlag(char c)
+{
+    return c == '-' || c == '+' || c == ' ' || c == '#' || c == '0';
+}
+
+bool isLengthModifier(char c)
+{
+    return c == 'h' || c == 'l' || c == 'L' || c == 'q' || c == 'j' || c == 'z' || c == 't' || c == 'I';
+}
+
+} // namespace
+
+std::string AsyncLog::format(const AsyncLogRecord &record)
+{
+    std::string result;
+    ArgumentReader reader(record);
+
+    if (record.format == NULL)
+    {
+        /* Text of the Log message */
+        Argument text;
+        if (readArgument(reader, &text) && text.isString)
+            result = text.string;
+    }
+    else
+    {
+        const char *format = record.format;
+        char buffer[256];
+        Argument argument;
+
+        while (*format != 0)
+        {
+            if (*format != '%')
+            {
+                const char *end = format;
+                while (*end != 0 && *end != '%')
+                    end++;
+                result.append(format, end - format);
+                format = end;
+                continue;
+            }
+
+            if (format[1] == '%')
+            {
+                result += '%';
+                format += 2;
+                continue;
+            }
+
+            /* Flags, width and precision are kept, the length modifier is replaced by the stored type */
+            std::string spec("%");
+            const char *p = format + 1;
+            while (isFlag(*p))
+                spec += *p++;
+            while (*p == '*' || (*p >= '0' && *p <= '9') || *p == '.')
+            {
+                if (*p == '*')
+                {
+                    if (readArgument(reader, &argument) && !argument.isString) {
+                        snprintf2buf(buffer, "%d", (int)argument.signedValue);
+                        spec += buffer;
+                    }
+                    p++;
+                } else {
+                    spec += *p++;
+                }
+            }
+            while (isLengthModifier(*p) || (*p >= '0' && *p <= '9'))
+                p++;
+
+            char conversion = *p;
+            if (conversion == 0)
+            {
+                result.append(format);
+                break;
+            }
+            format = p + 1;
+
+            if (!readArgument(reader, &argument))
+            {
+                result += "<?>";
+                continue;
+            }
+
+            buffer[0] = 0;
+            switch (conversion)
+            {
+                case 'd': case 'i':
+                    if (argument.isString) { result += argument.string; continue; }
+                    snprintf2buf(buffer, (spec + "lld").c_str(), argument.signedValue);
+                    break;
+                case 'u': case 'o': case 'x': case 'X':
+                    if (argument.isString) { result += argument.string; continue; }
+                    snprintf2buf(buffer, (spec + "ll" + conversion).c_str(), argument.unsignedValue);
+                    break;
+                case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                    if (argument.isString) { result += argument.string; continue; }
+                    snprintf2buf(buffer, (spec + conversion).c_str(), argument.doubleValue);
+                    break;
+                case 'c':
+                    if (argument.isString) { result += argument.string; continue; }
+                    snprintf2buf(buffer, (spec + 'c').c_str(), (int)argument.signedValue);
+                    break;
+                case 'p':
+                    if (argument.isString) { result += argument.string; continue; }
+                    snprintf2buf(buffer, (spec + 'p').c_str(), argument.pointer != NULL ? argument.pointer : (const void *)(size_t)argument.unsignedValue);
+                    break;
+                case 's':
+                    if (argument.isString) {
+                        /* Width and precision are applied to the copy, which may hold the zero bytes */
+                        snprintf2buf(buffer, (spec + 's').c_str(), argument.string.c_str());
+                    } else {
+                        snprintf2buf(buffer, "<?>");
+                    }
+                    break;
+                default:
+                    snprintf2buf(buffer, "<?>");
+                    break;
+            }
+            result += buffer;
+        }
+    }
+
+    if (record.truncated)
+        result += "...";
+    if (record.suppressed != 0)
+    {
+        char buffer[64];
+        snprintf2buf(buffer, " (%lld similar messages suppressed)", (long long)record.suppressed);
+        result += buffer;
+    }
+    return result;
+}
+
+/* EOF */
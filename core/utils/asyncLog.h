@@ -0,0 +1,335 @@
+#pragma once
+/**
+ * \file asyncLog.h
+ * \brief Asynchronous log pipeline with the binary records formatted by the background thread
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+#include "global.h"
+
+#include "log.h"
+
+/**
+ *  Log call site. It is a static object of the LA_* macros, it keeps the origin of the message and
+ *  the state of the rate limiter.
+ *
+ *  This is an aggregate so the static instance is initialized at compile time.
+ **/
+struct AsyncLogSite
+{
+    int         level;
+    cchar      *file;
+    int         line;
+    cchar      *function;
+    /** Records per second the site may emit, 0 for no limit */
+    int         maxRate;
+
+    /* Rate limiter state, updated atomically */
+    int64_t     windowStart;
+    int64_t     count;
+    int64_t     suppressed;
+};
+
+/**
+ *  Fixed size record of the queue.
+ *
+ *  The arguments are stored in the binary form, each one is the type tag followed by the value. The
+ *  format string is not copied, so it should be a literal. Strings are copied and are truncated to
+ *  the room left in the payload; the arguments that do not fit are lost and printed as "<?>".
+ *
+ *  The messages of Log that come through AsyncLog::post() are already formatted, they are stored as
+ *  text with the NULL format. The text longer than STRING_ROOM is drained synchronously instead.
+ **/
+struct AsyncLogRecord
+{
+    enum {
+        PAYLOAD_SIZE = 200,
+        /** Longest string that fits the empty record */
+        STRING_ROOM  = PAYLOAD_SIZE - 1 - sizeof(uint16_t)
+    };
+
+    enum ArgumentType {
+        ARG_INT,
+        ARG_UINT,
+        ARG_INT64,
+        ARG_UINT64,
+        ARG_DOUBLE,
+        ARG_STRING,
+        ARG_POINTER
+    };
+
+    cchar      *format;
+    int         level;
+    cchar      *file;
+    int         line;
+    cchar      *function;
+    /** PreciseTimer time of the call */
+    int64_t     usec;
+    /** Messages of the site dropped by the rate limiter before this one */
+    int64_t     suppressed;
+    /** Index of the queue cell or -1 for the record formatted on the calling thread */
+    int64_t     cell;
+
+    uint16_t    used;
+    bool        truncated;
+    char        payload[PAYLOAD_SIZE];
+
+    void putRaw(ArgumentType type, const void *data, size_t size)
+    {
+        if (truncated || used + 1 + size > PAYLOAD_SIZE)
+        {
+            truncated = true;
+            return;
+        }
+        payload[used] = (char)type;
+        memcpy(payload + used + 1, data, size);
+        used += (uint16_t)(1 + size);
+    }
+
+    void putString(const char *string, size_t length)
+    {
+        if (string == NULL)
+        {
+            string = "(null)";
+            length = 6;
+        }
+        if (truncated || used + 1 + sizeof(uint16_t) > PAYLOAD_SIZE)
+        {
+            truncated = true;
+            return;
+        }
+        size_t room = PAYLOAD_SIZE - used - 1 - sizeof(uint16_t);
+        uint16_t stored = (uint16_t)CORE_MIN(length, room);
+        payload[used] = (char)ARG_STRING;
+        memcpy(payload + used + 1, &stored, sizeof(uint16_t));
+        memcpy(payload + used + 1 + sizeof(uint16_t), string, stored);
+        used += (uint16_t)(1 + sizeof(uint16_t) + stored);
+        if (stored < length)
+            truncated = true;
+    }
+
+    void put(int value)                { putRaw(ARG_INT   , &value, sizeof(value)); }
+    void put(unsigned value)           { putRaw(ARG_UINT  , &value, sizeof(value)); }
+    void put(short value)              { put((int)value); }
+    void put(unsigned short value)     { put((unsigned)value); }
+    void put(char value)               { put((int)value); }
+    void put(signed char value)        { put((int)value); }
+    void put(unsigned char value)      { put((unsigned)value); }
+    void put(bool value)               { put((int)value); }
+    void put(long long value)          { putRaw(ARG_INT64 , &value, sizeof(value)); }
+    void put(unsigned long long value) { putRaw(ARG_UINT64, &value, sizeof(value)); }
+    void put(long value)               { put((long long)value); }
+    void put(unsigned long value)      { put((unsigned long long)value); }
+    void put(double value)             { putRaw(ARG_DOUBLE, &value, sizeof(value)); }
+    void put(float value)              { put((double)value); }
+    void put(const char *value)        { putString(value, value == NULL ? 0 : strlen(value)); }
+    void put(char *value)              { put((const char *)value); }
+    void put(const std::string &value) { putString(value.c_str(), value.size()); }
+
+    template<typename Type>
+    void put(Type *value)
+    {
+        const void *pointer = value;
+        putRaw(ARG_POINTER, &pointer, sizeof(pointer));
+    }
+};
+
+/**
+ *  \brief Asynchronous log backend
+ *
+ *  The calling thread only claims a preallocated record of the bounded lock-free queue, stores the
+ *  arguments in it and publishes it. The background thread formats the records and passes them to
+ *  the drains of Log, so the existing LogDrain implementations are the sinks. If the queue is full
+ *  the record is dropped and counted, the calling thread never waits.
+ *
+ *  While the pipeline is running, the messages of the L_* stream macros go through the same queue.
+ *  When it is not started the records are formatted and drained on the calling thread.
+ *
+ *  The queue is allocated by the first start() and is never freed, so a thread that is still logging
+ *  during stop() does not touch the freed memory; its late records are drained by the next start().
+ **/
+class AsyncLog
+{
+public:
+    struct Statistics
+    {
+        /** Records published to the queue */
+        uint64_t queued;
+        /** Records drained by the background thread */
+        uint64_t drained;
+        /** Records lost because the queue was full */
+        uint64_t dropped;
+        /** Records rejected by the rate limiters */
+        uint64_t suppressed;
+        /** Records drained on the calling thread, while the pipeline was stopped */
+        uint64_t synchronous;
+    };
+
+    /** Starts the background thread, the capacity is rounded up to the power of two */
+    static bool start(int capacity = 4096);
+
+    /** Drains the queued records and stops the background thread */
+    static void stop();
+
+    static bool isRunning();
+
+    /** Waits until the records published before the call are drained */
+    static void flush();
+
+    static Statistics statistics();
+    static void resetStatistics();
+
+    /**
+     *  Queues the message of Log.
+     *  \return false if the pipeline is not running or the text is longer than the record can hold,
+     *  the message should be drained by the caller then
+     **/
+    static bool post(Log::Message &message);
+
+    /** Text of the record, the printf() style format applied to the stored arguments */
+    static std::string format(const AsyncLogRecord &record);
+
+    /**
+     *  Returns the record to fill or NULL if the message should be skipped. When the pipeline is
+     *  not running this is the local record of the caller.
+     **/
+    static AsyncLogRecord *claim(AsyncLogSite *site, const char *format, AsyncLogRecord *local);
+    static void publish(AsyncLogRecord *record);
+
+    static void write(AsyncLogSite *site, const char *format)
+    {
+        AsyncLogRecord local;
+        AsyncLogRecord *record = claim(site, format, &local);
+        if (record == NULL)
+            return;
+        publish(record);
+    }
+
+    template<typename A1>
+    static void write(AsyncLogSite *site, const char *format, const A1 &a1)
+    {
+        AsyncLogRecord local;
+        AsyncLogRecord *record = claim(site, format, &local);
+        if (record == NULL)
+            return;
+        record->put(a1);
+        publish(record);
+    }
+
+    template<typename A1, typename A2>
+    static void write(AsyncLogSite *site, const char *format, const A1 &a1, const A2 &a2)
+    {
+        AsyncLogRecord local;
+        AsyncLogRecord *record = claim(site, format, &local);
+        if (record == NULL)
+            return;
+        record->put(a1); record->put(a2);
+        publish(record);
+    }
+
+    template<typename A1, typename A2, typename A3>
+    static void write(AsyncLogSite *site, const char *format, const A1 &a1, const A2 &a2, const A3 &a3)
+    {
+        AsyncLogRecord local;
+        AsyncLogRecord *record = claim(site, format, &local);
+        if (record == NULL)
+            return;
+        record->put(a1); record->put(a2); record->put(a3);
+        publish(record);
+    }
+
+    template<typename A1, typename A2, typename A3, typename A4>
+    static void write(AsyncLogSite *site, const char *format, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4)
+    {
+        AsyncLogRecord local;
+        AsyncLogRecord *record = claim(site, format, &local);
+        if (record == NULL)
+            return;
+        record->put(a1); record->put(a2); record->put(a3); record->put(a4);
+        publish(record);
+    }
+
+    template<typename A1, typename A2, typename A3, typename A4, typename A5>
+    static void write(AsyncLogSite *site, const char *format, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5)
+    {
+        AsyncLogRecord local;
+        AsyncLogRecord *record = claim(site, format, &local);
+        if (record == NULL)
+            return;
+        record->put(a1); record->put(a2); record->put(a3); record->put(a4); record->put(a5);
+        publish(record);
+    }
+
+    template<typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
+    static void write(AsyncLogSite *site, const char *format, const A1 &a1, const A2 &a2, const A3 &a3, const A4 &a4, const A5 &a5, const A6 &a6)
+    {
+        AsyncLogRecord local;
+        AsyncLogRecord *record = claim(site, format, &local);
+        if (record == NULL)
+            return;
+        record->put(a1); record->put(a2); record->put(a3); record->put(a4); record->put(a5); record->put(a6);
+        publish(record);
+    }
+};
+
+/**
+ *  printf() style log macros of the asynchronous pipeline, the format should be a literal.
+ *  The _RATE versions emit at most the given number of records per second from the call site,
+ *  the number of the suppressed ones is added to the next emitted record.
+ *
+ *  The levels below CORE_LOG_MIN_LEVEL are removed by the preprocessor, with their arguments.
+ **/
+#define LA_LOG(level, rate, ...)                                                                        \
+    do {                                                                                                \
+        static AsyncLogSite asyncLogSite = { level, __FILE__, __LINE__, __FUNCTION__, rate, 0, 0, 0 };  \
+        AsyncLog::write(&asyncLogSite, __VA_ARGS__);                                                    \
+    } while (0)
+
+#define LA_NOTHING do {} while (0)
+
+#if CORE_LOG_MIN_LEVEL <= 0
+#define LA_DDEBUG(...)              LA_LOG(Log::LEVEL_DETAILED_DEBUG, 0   , __VA_ARGS__)
+#define LA_DDEBUG_RATE(rate, ...)   LA_LOG(Log::LEVEL_DETAILED_DEBUG, rate, __VA_ARGS__)
+#else
+#define LA_DDEBUG(...)              LA_NOTHING
+#define LA_DDEBUG_RATE(rate, ...)   LA_NOTHING
+#endif
+
+#if CORE_LOG_MIN_LEVEL <= 1
+#define LA_DEBUG(...)               LA_LOG(Log::LEVEL_DEBUG  , 0   , __VA_ARGS__)
+#define LA_DEBUG_RATE(rate, ...)    LA_LOG(Log::LEVEL_DEBUG  , rate, __VA_ARGS__)
+#else
+#define LA_DEBUG(...)               LA_NOTHING
+#define LA_DEBUG_RATE(rate, ...)    LA_NOTHING
+#endif
+
+#if CORE_LOG_MIN_LEVEL <= 2
+#define LA_INFO(...)                LA_LOG(Log::LEVEL_INFO   , 0   , __VA_ARGS__)
+#define LA_INFO_RATE(rate, ...)     LA_LOG(Log::LEVEL_INFO   , rate, __VA_ARGS__)
+#else
+#define LA_INFO(...)                LA_NOTHING
+#define LA_INFO_RATE(rate, ...)     LA_NOTHING
+#endif
+
+#if CORE_LOG_MIN_LEVEL <= 3
+#define LA_WARNING(...)             LA_LOG(Log::LEVEL_WARNING, 0   , __VA_ARGS__)
+#define LA_WARNING_RATE(rate, ...)  LA_LOG(Log::LEVEL_WARNING, rate, __VA_ARGS__)
+#else
+#define LA_WARNING(...)             LA_NOTHING
+#define LA_WARNING_RATE(rate, ...)  LA_NOTHING
+#endif
+
+#if CORE_LOG_MIN_LEVEL <= 4
+#define LA_ERROR(...)               LA_LOG(Log::LEVEL_ERROR  , 0   , __VA_ARGS__)
+#define LA_ERROR_RATE(rate, ...)    LA_LOG(Log::LEVEL_ERROR  , rate, __VA_ARGS__)
+#else
+#define LA_ERROR(...)               LA_NOTHING
+#define LA_ERROR_RATE(rate, ...)    LA_NOTHING
+#endif
+
+/* EOF */
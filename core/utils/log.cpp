@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "log.h"
+#include "asyncLog.h"
 
 const char *Log::level_names[] =
 {
@@ -37,6 +38,13 @@ int Log::staticInit()
 }
 
 void Log::message(Message &message)
+{
+    if (AsyncLog::post(message))
+        return;
+    drain(message);
+}
+
+void Log::drain(Message &message)
 {
 	for(unsigned int i = 0; i < mLogDrains.size(); i++)
 	{
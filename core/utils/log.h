@@ -23,17 +23,26 @@
 using corecvs::ObjectRef;
 
 
-#define L_ERROR            Log().error  (__FILE__, __LINE__, __FUNCTION__)
-#define L_WARNING          Log().warning(__FILE__, __LINE__, __FUNCTION__)
-#define L_INFO             Log().info   (__FILE__, __LINE__, __FUNCTION__)
-#define L_DEBUG            Log().debug  (__FILE__, __LINE__, __FUNCTION__)
-#define L_DDEBUG           Log().ddebug (__FILE__, __LINE__, __FUNCTION__)
+/**
+ * Messages of the levels below this one are removed at compile time, the values are the ones of Log::LogLevel
+ **/
+#ifndef CORE_LOG_MIN_LEVEL
+#define CORE_LOG_MIN_LEVEL 0
+#endif
+
+#define L_LEVEL_ENABLED(level) (Log::level >= CORE_LOG_MIN_LEVEL)
+
+#define L_ERROR            if (!L_LEVEL_ENABLED(LEVEL_ERROR  )) {} else Log().error  (__FILE__, __LINE__, __FUNCTION__)
+#define L_WARNING          if (!L_LEVEL_ENABLED(LEVEL_WARNING)) {} else Log().warning(__FILE__, __LINE__, __FUNCTION__)
+#define L_INFO             if (!L_LEVEL_ENABLED(LEVEL_INFO   )) {} else Log().info   (__FILE__, __LINE__, __FUNCTION__)
+#define L_DEBUG            if (!L_LEVEL_ENABLED(LEVEL_DEBUG  )) {} else Log().debug  (__FILE__, __LINE__, __FUNCTION__)
+#define L_DDEBUG           if (!L_LEVEL_ENABLED(LEVEL_DETAILED_DEBUG)) {} else Log().ddebug (__FILE__, __LINE__, __FUNCTION__)
 
-#define L_ERROR_P(  ...)   Log().error  (__FILE__, __LINE__, __FUNCTION__) << Log::formatted(__VA_ARGS__)
-#define L_WARNING_P(...)   Log().warning(__FILE__, __LINE__, __FUNCTION__) << Log::formatted(__VA_ARGS__)
-#define L_INFO_P(   ...)   Log().info   (__FILE__, __LINE__, __FUNCTION__) << Log::formatted(__VA_ARGS__)
-#define L_DEBUG_P(  ...)   Log().debug  (__FILE__, __LINE__, __FUNCTION__) << Log::formatted(__VA_ARGS__)
-#define L_DDEBUG_P( ...)   Log().ddebug (__FILE__, __LINE__, __FUNCTION__) << Log::formatted(__VA_ARGS__)
+#define L_ERROR_P(  ...)   L_ERROR   << Log::formatted(__VA_ARGS__)
+#define L_WARNING_P(...)   L_WARNING << Log::formatted(__VA_ARGS__)
+#define L_INFO_P(   ...)   L_INFO    << Log::formatted(__VA_ARGS__)
+#define L_DEBUG_P(  ...)   L_DEBUG   << Log::formatted(__VA_ARGS__)
+#define L_DDEBUG_P( ...)   L_DDEBUG  << Log::formatted(__VA_ARGS__)
 
 
 class LogDrain;
@@ -131,7 +140,10 @@ public:
             message.get()->mOriginFileName     = originFileName;
             message.get()->mOriginFunctionName = originFunctionName;
             message.get()->mOriginLineNumber   = originLineNumber;
-            time(&message.get()->rawtime);
+            message.get()->rawtime             = 0;
+            if (Log::shouldWrite(level)) {
+                time(&message.get()->rawtime);
+            }
         }
 
         ~MessageScoped()
@@ -188,10 +200,15 @@ public:
     }
 
 	/**
-	 * Log a message
+	 * Log a message. While AsyncLog is running the message is queued, otherwise it is drained at once
 	 **/
     void message(Message &message);
 
+    /**
+     * Passes the message to all the drains
+     **/
+    static void drain(Message &message);
+
     static std::string formatted(const char *format, ... );
 
     static std::string msgBufToString(const char* message);
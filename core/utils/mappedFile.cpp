@@ -0,0 +1,146 @@
+/**
+ * \file mappedFile.cpp
+ * \brief Read only memory mapping of the whole file
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include "mappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace corecvs {
+
+/* The empty file can not be mapped, it is represented by this byte */
+static const uint8_t emptyFileData = 0;
+
+MappedFile::MappedFile() :
+    mData(NULL),
+    mSize(0)
+#ifdef _WIN32
+    , mFile(NULL)
+    , mMapping(NULL)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &fileName)
+{
+    close();
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    if (size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        mData = &emptyFileData;
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    mFile    = file;
+    mMapping = mapping;
+    mData    = (const uint8_t *)view;
+    mSize    = (size_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mData != NULL && mData != &emptyFileData)
+        UnmapViewOfFile(mData);
+    if (mMapping != NULL)
+        CloseHandle(mMapping);
+    if (mFile != NULL)
+        CloseHandle(mFile);
+    mData    = NULL;
+    mSize    = 0;
+    mFile    = NULL;
+    mMapping = NULL;
+}
+
+#else
+
+bool MappedFile::open(const std::string &fileName)
+{
+    close();
+    int file = ::open(fileName.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat status;
+    if (fstat(file, &status) != 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    if (status.st_size == 0)
+    {
+        ::close(file);
+        mData = &emptyFileData;
+        return true;
+    }
+
+    void *view = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    /* The mapping keeps its own reference to the file */
+    ::close(file);
+    if (view == MAP_FAILED)
+        return false;
+
+    madvise(view, (size_t)status.st_size, MADV_SEQUENTIAL);
+    mData = (const uint8_t *)view;
+    mSize = (size_t)status.st_size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mData != NULL && mData != &emptyFileData)
+        munmap((void *)mData, mSize);
+    mData = NULL;
+    mSize = 0;
+}
+
+#endif
+
+} /* namespace corecvs */
+
+/* EOF */
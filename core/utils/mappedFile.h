@@ -0,0 +1,59 @@
+#pragma once
+/**
+ * \file mappedFile.h
+ * \brief Read only memory mapping of the whole file
+ *
+ * \date Oct 19, 2026
+ **/
+
+#include <stddef.h>
+#include <string>
+
+#include "global.h"
+
+namespace corecvs {
+
+/**
+ *  Maps the file into the address space, the pages are read by the system on the first access.
+ *  The mapping is released by close() or by the destructor.
+ **/
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const std::string &fileName);
+    void close();
+
+    bool isOpen() const
+    {
+        return mData != NULL;
+    }
+
+    const uint8_t *data() const
+    {
+        return mData;
+    }
+
+    size_t size() const
+    {
+        return mSize;
+    }
+
+private:
+    const uint8_t *mData;
+    size_t         mSize;
+#ifdef _WIN32
+    void          *mFile;
+    void          *mMapping;
+#endif
+
+    /* Not copyable */
+    MappedFile(const MappedFile &);
+    MappedFile &operator =(const MappedFile &);
+};
+
+} /* namespace corecvs */
+
+/* EOF */
@@ -7,8 +7,10 @@ HEADERS += \
     utils/utils.h \
     utils/visitors/basePathVisitor.h \
     utils/log.h \
+    utils/asyncLog.h \
     utils/countedPtr.h \
     utils/atomicOps.h \
+    utils/mappedFile.h \
 
 
 SOURCES += \
@@ -20,4 +22,6 @@ SOURCES += \
     utils/visitors/basePathVisitor.cpp \
     utils/utils.cpp \
     utils/log.cpp \
+    utils/asyncLog.cpp \
+    utils/mappedFile.cpp \
 
@@ -9,9 +9,12 @@
  */
 
 #include <iostream>
+#include <limits>
+#include <vector>
 #include "global.h"
 #include "g12Buffer.h"
 #include "assignmentOptimal.h"
+#include "lapSolver.h"
 
 
 using namespace std;
@@ -211,6 +214,169 @@ void testGeneric3 (void)
     delete mapping;
 }
 
+static AbstractBuffer<double> *randomCosts(int h, int w)
+{
+    AbstractBuffer<double> *costs = new AbstractBuffer<double>(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            costs->element(i, j) = rand() % 1000;
+    return costs;
+}
+
+/* Reference cost with the old solver, that needs no more rows than columns */
+static double referenceCost(AbstractBuffer<double> *costs)
+{
+    bool transposed = costs->h > costs->w;
+    AbstractBuffer<double> *square = new AbstractBuffer<double>(transposed ? costs->w : costs->h, transposed ? costs->h : costs->w);
+    for (int i = 0; i < square->h; i++)
+        for (int j = 0; j < square->w; j++)
+            square->element(i, j) = transposed ? costs->element(j, i) : costs->element(i, j);
+
+    AbstractBuffer<int> *mapping = new AbstractBuffer<int>(square->h, 1);
+    assignOptimal(square, mapping);
+    double cost = computeCost<double>(mapping, square);
+    delete mapping;
+    delete square;
+    return cost;
+}
+
+static bool isAssignment(AbstractBuffer<int> *mapping, int h, int w)
+{
+    vector<bool> used(w, false);
+    int assigned = 0;
+    for (int i = 0; i < h; i++)
+    {
+        int j = mapping->element(i, 0);
+        if (j == -1)
+            continue;
+        if (j < 0 || j >= w || used[j])
+            return false;
+        used[j] = true;
+        assigned++;
+    }
+    return assigned == CORE_MIN(h, w);
+}
+
+void testLapDense (void)
+{
+    printf("Starting LAP dense test...\n");
+    int sizes[][2] = { {1, 1}, {5, 5}, {17, 17}, {40, 40}, {7, 23}, {23, 7}, {60, 45} };
+
+    LapSolver solver;
+    solver.setWarmStart(false);
+    for (unsigned k = 0; k < CORE_COUNT_OF(sizes); k++)
+    {
+        int h = sizes[k][0], w = sizes[k][1];
+        AbstractBuffer<double> *costs   = randomCosts(h, w);
+        AbstractBuffer<int>    *mapping = new AbstractBuffer<int>(h, 1);
+
+        double cost = solver.solve(costs, mapping);
+        ASSERT_TRUE(isAssignment(mapping, h, w), "LAP result is not an assignment");
+        double expected = referenceCost(costs);
+        ASSERT_DOUBLE_EQUAL(cost, expected, "LAP assignment was not optimal");
+
+        delete mapping;
+        delete costs;
+    }
+    ASSERT_TRUE(solver.statistics().solves == CORE_COUNT_OF(sizes), "Wrong solve counter");
+    ASSERT_TRUE(solver.statistics().warmStarts == 0, "Warm start should be disabled");
+}
+
+/* Costs drift slightly between the frames, objects appear and disappear */
+void testLapWarmStart (void)
+{
+    printf("Starting LAP warm start test...\n");
+    int h = 50, w = 60;
+    AbstractBuffer<double> *costs = randomCosts(h, w);
+
+    LapSolver warm;
+    LapSolver cold;
+    cold.setWarmStart(false);
+    for (int frame = 0; frame < 20; frame++)
+    {
+        for (int i = 0; i < h; i++)
+            for (int j = 0; j < w; j++)
+                costs->element(i, j) = CORE_MAX(0.0, costs->element(i, j) + (rand() % 21 - 10));
+        if (frame % 5 == 4)
+        {
+            /* Column disappears */
+            for (int i = 0; i < h; i++)
+                costs->element(i, frame % w) = 5000;
+        }
+
+        AbstractBuffer<int> *warmMapping = new AbstractBuffer<int>(h, 1);
+        AbstractBuffer<int> *coldMapping = new AbstractBuffer<int>(h, 1);
+        double warmCost = warm.solve(costs, warmMapping);
+        double coldCost = cold.solve(costs, coldMapping);
+        ASSERT_TRUE(isAssignment(warmMapping, h, w), "Warm result is not an assignment");
+        ASSERT_DOUBLE_EQUAL(warmCost, coldCost, "Warm start changed the optimal cost");
+        ASSERT_DOUBLE_EQUAL(warmCost, referenceCost(costs), "Warm start result is not optimal");
+        delete coldMapping;
+        delete warmMapping;
+    }
+
+    LapSolver::Statistics &stats = warm.statistics();
+    printf("Kept rows %d, augmentations %d (cold %d), scanned %d (cold %d)\n",
+        (int)stats.keptRows, (int)stats.augmentations, (int)cold.statistics().augmentations,
+        (int)stats.scannedCosts, (int)cold.statistics().scannedCosts);
+    ASSERT_TRUE(stats.warmStarts == 19, "Wrong warm start counter");
+    ASSERT_TRUE(stats.keptRows > 0, "Warm start should keep the rows");
+    ASSERT_TRUE(stats.augmentations < cold.statistics().augmentations, "Warm start should save augmentations");
+    delete costs;
+}
+
+void testLapSparse (void)
+{
+    printf("Starting LAP sparse test...\n");
+    double forbidden = std::numeric_limits<double>::infinity();
+    int sizes[][2] = { {30, 30}, {20, 35}, {35, 20} };
+
+    LapSolver sparse;
+    LapSolver dense;
+    for (unsigned k = 0; k < CORE_COUNT_OF(sizes); k++)
+    {
+        int h = sizes[k][0], w = sizes[k][1];
+        for (int frame = 0; frame < 3; frame++)
+        {
+            /* Gated pairs, some rows have no candidates at all */
+            AbstractBuffer<double> *costs = new AbstractBuffer<double>(h, w);
+            vector<LapCandidate> candidates;
+            for (int i = 0; i < h; i++)
+            {
+                for (int j = 0; j < w; j++)
+                {
+                    bool gated = (rand() % 4 == 0) && (i % 9 != 8);
+                    costs->element(i, j) = gated ? (double)(rand() % 1000) : forbidden;
+                    if (gated)
+                        candidates.push_back(LapCandidate(i, j, costs->element(i, j)));
+                }
+            }
+
+            vector<int> columnForRow;
+            AbstractBuffer<int> *mapping = new AbstractBuffer<int>(h, 1);
+            double sparseCost = sparse.solveSparse(h, w, candidates, columnForRow);
+            double denseCost  = dense.solve(costs, mapping);
+
+            int sparseAssigned = 0, denseAssigned = 0;
+            for (int i = 0; i < h; i++)
+            {
+                if (columnForRow[i] != -1)
+                {
+                    ASSERT_TRUE(costs->element(i, columnForRow[i]) != forbidden, "Sparse solver used a forbidden pair");
+                    sparseAssigned++;
+                }
+                if (mapping->element(i, 0) != -1)
+                    denseAssigned++;
+            }
+            ASSERT_TRUE(sparseAssigned == denseAssigned, "Sparse and dense solvers assigned different number of rows");
+            ASSERT_DOUBLE_EQUAL(sparseCost, denseCost, "Sparse and dense solvers differ");
+
+            delete mapping;
+            delete costs;
+        }
+    }
+}
+
 #if 0
 void doProfileGeneric(void)
 {
@@ -250,6 +416,9 @@ int main (void)
     testGeneric1();
     testGeneric2();
     testGeneric3();
+    testLapDense();
+    testLapWarmStart();
+    testLapSparse();
 /*    doProfileGeneric();*/
     return 0;
 }
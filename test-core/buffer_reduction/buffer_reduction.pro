@@ -0,0 +1,8 @@
+##################################################################
+# buffer_reduction.pro created on Oct 19, 2026
+# This is a file for QMAKE that allows to build the test buffer_reduction
+#
+##################################################################
+include(../testsCommon.pri)
+
+SOURCES += main_test_buffer_reduction.cpp
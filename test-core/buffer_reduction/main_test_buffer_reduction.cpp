@@ -0,0 +1,217 @@
+/**
+ * \file main_test_buffer_reduction.cpp
+ * \brief This is the main file for the test buffer_reduction
+ *
+ * \date Oct 19, 2026
+ *
+ * \ingroup autotest
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef ASSERTS
+#define ASSERTS
+#endif
+
+#include "global.h"
+
+#include "g8Buffer.h"
+#include "g12Buffer.h"
+#include "bufferReduction.h"
+
+using namespace std;
+using namespace corecvs;
+
+typedef AbstractBuffer<double, int32_t> DoubleBuffer;
+
+/* Plain loops over the area in the row major order */
+template<class BufferType>
+ReductionResult<typename BufferType::InternalElementType> bruteForce(const BufferType *buffer, const Rectangle<int32_t> &area, const G8Buffer *mask)
+{
+    typedef typename BufferType::InternalElementType ElementType;
+    ReductionResult<ElementType> result;
+    for (int i = area.corner.y(); i < area.corner.y() + area.size.y(); i++)
+    {
+        for (int j = area.corner.x(); j < area.corner.x() + area.size.x(); j++)
+        {
+            if (mask != NULL && !mask->element(i, j))
+                continue;
+            ElementType value = buffer->element(i, j);
+            if (result.count == 0 || value < result.min)
+            {
+                result.min = value;
+                result.minPosition = Vector2d32(j, i);
+            }
+            if (result.count == 0 || value > result.max)
+            {
+                result.max = value;
+                result.maxPosition = Vector2d32(j, i);
+            }
+            result.count++;
+            result.sum   += value;
+            result.sumSq += (typename ReductionResult<ElementType>::SquareType)value * value;
+            result.m10 += (double)j * value;
+            result.m01 += (double)i * value;
+            result.m20 += (double)j * j * value;
+            result.m11 += (double)i * j * value;
+            result.m02 += (double)i * i * value;
+        }
+    }
+    return result;
+}
+
+template<typename ElementType>
+bool sameExact(const ReductionResult<ElementType> &a, const ReductionResult<ElementType> &b)
+{
+    return a.count == b.count && a.sum == b.sum && a.sumSq == b.sumSq &&
+           a.min == b.min && a.max == b.max &&
+           a.minPosition == b.minPosition && a.maxPosition == b.maxPosition &&
+           a.m10 == b.m10 && a.m01 == b.m01 && a.m20 == b.m20 && a.m11 == b.m11 && a.m02 == b.m02;
+}
+
+template<class BufferType>
+void checkAreas(const BufferType *buffer, const G8Buffer *mask)
+{
+    Rectangle<int32_t> areas[] = {
+        Rectangle<int32_t>(0, 0, buffer->w, buffer->h),
+        Rectangle<int32_t>(3, 5, 17, 40),
+        Rectangle<int32_t>(-10, 20, 1000, 3),
+        Rectangle<int32_t>(7, 7, 1, 1),
+        Rectangle<int32_t>(buffer->w, 0, 5, 5)
+    };
+
+    for (unsigned k = 0; k < CORE_COUNT_OF(areas); k++)
+    {
+        ReductionResult<typename BufferType::InternalElementType> result = BufferReduction::reduce(buffer, BufferReduction::ALL, &areas[k], mask);
+        Rectangle<int32_t> area = BufferReduction::clip(buffer, &areas[k]);
+        ReductionResult<typename BufferType::InternalElementType> expected = bruteForce(buffer, area, mask);
+        ASSERT_TRUE_P(sameExact(result, expected), ("Reduction differs from the plain loop in the area %d", k));
+    }
+}
+
+void testG12()
+{
+    int h = 67;
+    int w = 1203;
+    G12Buffer *buffer = new G12Buffer(h, w);
+    G8Buffer  *mask   = new G8Buffer(h, w);
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            buffer->element(i, j) = rand() % 0xFFFF;
+            mask->element(i, j) = rand() % 3 != 0;
+        }
+    }
+    /* Repeated extremums keep the first position */
+    buffer->element(30, 100) = 0xFFFF;
+    buffer->element(30, 150) = 0xFFFF;
+    buffer->element(50, 10)  = 0xFFFF;
+
+    checkAreas(buffer, (G8Buffer *)NULL);
+    checkAreas(buffer, mask);
+
+    ReductionResult<uint16_t> range = BufferReduction::minMax(buffer);
+    ASSERT_TRUE(range.max == 0xFFFF && range.maxPosition == Vector2d32(100, 30), "Maximum should be the first one");
+    ASSERT_FALSE(buffer->verify(), "Values above 12 bits should fail the verification");
+
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            buffer->element(i, j) &= G12Buffer::BUFFER_MAX_VALUE;
+    ASSERT_TRUE(buffer->verify(), "12 bit values should pass the verification");
+
+    delete mask;
+    delete buffer;
+}
+
+void testG8()
+{
+    int h = 45;
+    int w = 301;
+    G8Buffer *buffer = new G8Buffer(h, w);
+    G8Buffer *mask   = new G8Buffer(h, w);
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            buffer->element(i, j) = rand() % 256;
+            mask->element(i, j) = rand() % 2;
+        }
+    }
+
+    checkAreas(buffer, (G8Buffer *)NULL);
+    checkAreas(buffer, mask);
+
+    uint64_t sum = BufferReduction::sum(buffer);
+    ReductionResult<uint8_t> all = BufferReduction::reduce(buffer);
+    ASSERT_TRUE(sum == all.sum, "Sum alone should match the full reduction");
+
+    delete mask;
+    delete buffer;
+}
+
+void testDouble()
+{
+    int h = 100;
+    int w = 50;
+    DoubleBuffer *buffer = new DoubleBuffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            buffer->element(i, j) = (rand() % 20001 - 10000) / 7.0;
+
+    /* The result of the fixed blocks merged in order, it should not depend on the threads */
+    ReductionResult<double> expected;
+    for (int block = 0; block * BufferReduction::BLOCK_ROWS < h; block++)
+    {
+        ReductionResult<double> partial;
+        for (int i = block * BufferReduction::BLOCK_ROWS; i < CORE_MIN((block + 1) * BufferReduction::BLOCK_ROWS, h); i++)
+            BufferReduction::reduceRow(&buffer->element(i, 0), (const uint8_t *)NULL, i, 0, w, BufferReduction::ALL, partial);
+        expected.merge(partial);
+    }
+
+    for (int run = 0; run < 5; run++)
+    {
+        ReductionResult<double> result = BufferReduction::reduce(buffer);
+        ASSERT_TRUE(sameExact(result, expected), "Floating point reduction should be deterministic");
+    }
+
+    ReductionResult<double> plain = bruteForce(buffer, Rectangle<int32_t>(0, 0, w, h), (G8Buffer *)NULL);
+    ReductionResult<double> result = BufferReduction::reduce(buffer);
+    ASSERT_TRUE(fabs(result.sum - plain.sum) < 1e-6, "Wrong sum");
+    ASSERT_TRUE(fabs(result.m02 - plain.m02) < 1e-6 * fabs(plain.m02) + 1e-6, "Wrong second moment");
+    ASSERT_TRUE(result.min == plain.min && result.minPosition == plain.minPosition, "Wrong minimum");
+
+    delete buffer;
+}
+
+void testStatistics()
+{
+    G12Buffer *buffer = new G12Buffer(4, 4);
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            buffer->element(i, j) = (j == 3) ? 30 : 0;
+
+    ReductionResult<uint16_t> result = BufferReduction::reduce(buffer);
+    ASSERT_TRUE(result.mean() == 7.5, "Wrong mean");
+    ASSERT_TRUE(fabs(result.variance() - 168.75) < 1e-9, "Wrong variance");
+    ASSERT_TRUE(result.centroid() == Vector2dd(3.0, 1.5), "Wrong centroid");
+
+    Rectangle<int32_t> outside(10, 10, 2, 2);
+    ReductionResult<uint16_t> empty = BufferReduction::reduce(buffer, BufferReduction::ALL, &outside);
+    ASSERT_TRUE(empty.isEmpty() && empty.mean() == 0.0, "Area outside should be empty");
+
+    delete buffer;
+}
+
+int main (int /*argC*/, char ** /*argV*/)
+{
+    testG12();
+    testG8();
+    testDouble();
+    testStatistics();
+
+    cout << "PASSED" << endl;
+    return 0;
+}
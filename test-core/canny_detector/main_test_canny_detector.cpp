@@ -0,0 +1,228 @@
+/**
+ * \file main_test_canny_detector.cpp
+ * \brief This is the main file for the test canny_detector
+ *
+ * \date Oct 19, 2026
+ *
+ * \ingroup autotest
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef ASSERTS
+#define ASSERTS
+#endif
+
+#include "global.h"
+
+#include "g8Buffer.h"
+#include "g12Buffer.h"
+#include "cannyDetector.h"
+#include "cannyFilter.h"
+
+using namespace std;
+using namespace corecvs;
+
+static G12Buffer *blobs(int h, int w)
+{
+    G12Buffer *image = new G12Buffer(h, w);
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            double value = 2000 + 1200 * sin(i / 7.0) * cos(j / 11.0) + 300 * sin((i + j) / 3.0);
+            image->element(i, j) = (uint16_t)(value + rand() % 50);
+        }
+    }
+    return image;
+}
+
+/* Suppression with the floating point angles, the sector borders are at 22.5 and 67.5 degrees */
+void testSuppression()
+{
+    G12Buffer *image = blobs(70, 203);
+    CannyDetector detector;
+    G8Buffer *labels = detector.classify(image, 200, 1200);
+
+    int low = 50, high = 300;
+    int edges = 0;
+    for (int i = 1; i < image->h - 1; i++)
+    {
+        for (int j = 1; j < image->w - 1; j++)
+        {
+            int gx = (int16_t)detector.gradientX()->element(i, j);
+            int gy = (int16_t)detector.gradientY()->element(i, j);
+            int m  = abs(gx) + abs(gy);
+            ASSERT_TRUE(m == (int16_t)detector.magnitude()->element(i, j), "Wrong magnitude");
+
+            double angle = atan2((double)abs(gy), (double)abs(gx)) * 180.0 / M_PI;
+            /* Skip the pixels on the sector borders, the tangent is approximated by 27146 / 65536 */
+            if (fabs(angle - 22.5) < 0.01 || fabs(angle - 67.5) < 0.01)
+                continue;
+
+            int dx, dy;
+            if (angle < 22.5)      { dx = 1; dy = 0; }
+            else if (angle > 67.5) { dx = 0; dy = 1; }
+            else                   { dx = 1; dy = ((gx < 0) == (gy < 0)) ? 1 : -1; }
+
+            int first  = (int16_t)detector.magnitude()->element(i - dy, j - dx);
+            int second = (int16_t)detector.magnitude()->element(i + dy, j + dx);
+            int expected = CannyDetector::NONE;
+            if (m >= low && m > first && m >= second)
+                expected = (m > high) ? CannyDetector::STRONG : CannyDetector::WEAK;
+
+            ASSERT_TRUE_P(labels->element(i, j) == expected, ("Wrong label at %d %d", i, j));
+            if (expected != CannyDetector::NONE)
+                edges++;
+        }
+    }
+    ASSERT_TRUE(edges > 100, "Test image should have edges");
+    delete image;
+}
+
+/* Reference flood fill from every strong pixel */
+static void referenceHysteresis(G8Buffer *labels)
+{
+    vector<Vector2d32> queue;
+    for (int i = 0; i < labels->h; i++)
+        for (int j = 0; j < labels->w; j++)
+            if (labels->element(i, j) == CannyDetector::STRONG)
+                queue.push_back(Vector2d32(j, i));
+
+    for (unsigned k = 0; k < queue.size(); k++)
+    {
+        Vector2d32 p = queue[k];
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                Vector2d32 q = p + Vector2d32(dx, dy);
+                if (labels->isValidCoord(q) && labels->element(q) == CannyDetector::WEAK)
+                {
+                    labels->element(q) = CannyDetector::STRONG;
+                    queue.push_back(q);
+                }
+            }
+        }
+    }
+}
+
+void testHysteresis()
+{
+    int h = CannyDetector::STRIPE_HEIGHT * 3 + 17;
+    int w = 150;
+    G8Buffer *labels = new G8Buffer(h, w);
+
+    /* Random weak walks that cross the stripe seams, some of them with a strong pixel */
+    for (int walk = 0; walk < 60; walk++)
+    {
+        int y = rand() % h;
+        int x = rand() % w;
+        int length = 50 + rand() % 400;
+        for (int step = 0; step < length; step++)
+        {
+            labels->element(y, x) = CannyDetector::WEAK;
+            int dy = rand() % 3 - 1;
+            int dx = rand() % 3 - 1;
+            y = CORE_MAX(0, CORE_MIN(h - 1, y + dy));
+            x = CORE_MAX(0, CORE_MIN(w - 1, x + dx));
+        }
+        if (walk % 4 == 0)
+            labels->element(y, x) = CannyDetector::STRONG;
+    }
+    /* Long vertical weak line through all the stripes, seeded at the bottom only */
+    for (int i = 0; i < h; i++)
+        labels->element(i, 3) = CannyDetector::WEAK;
+    labels->element(h - 1, 3) = CannyDetector::STRONG;
+
+    G8Buffer *expected = new G8Buffer(labels);
+    referenceHysteresis(expected);
+    CannyDetector::hysteresis(labels);
+
+    ASSERT_TRUE(labels->isEqual(*expected), "Hysteresis differs from the flood fill");
+    ASSERT_TRUE(labels->element(0, 3) == CannyDetector::STRONG, "Edge should be followed across all the seams");
+
+    delete expected;
+    delete labels;
+}
+
+void testStepAndFilter()
+{
+    int h = 200, w = 120;
+    G12Buffer *image = new G12Buffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            image->element(i, j) = (j < 60) ? 500 : 3000;
+
+    CannyDetector detector;
+    G12Buffer *edges = detector.detect(image, 400, 4000);
+    for (int i = 1; i < h - 1; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            bool isEdge = (j == 59 || j == 60);
+            if (!isEdge)
+                ASSERT_TRUE_P(edges->element(i, j) == 0, ("False edge at %d %d", i, j));
+        }
+        ASSERT_TRUE((edges->element(i, 59) == G12Buffer::BUFFER_MAX_VALUE) != (edges->element(i, 60) == G12Buffer::BUFFER_MAX_VALUE),
+                    "Step should give the line of one pixel width");
+    }
+
+    /* FilterBlock gives the same output */
+    CannyFilter filter;
+    filter.mCannyParameters.setMinimumThreshold(400);
+    filter.mCannyParameters.setMaximumThreshold(4000);
+    filter.mCannyParameters.setShouldEdgeDetect(true);
+    static_cast<G12Pin *>(filter.inputPins[0])->getData() = image;
+    filter();
+    G12Buffer *filtered = static_cast<G12Pin *>(filter.outputPins[0])->getData();
+    ASSERT_TRUE(filtered != NULL && filtered->isEqual(*edges), "CannyFilter should use the detector");
+
+    delete filtered;
+    static_cast<G12Pin *>(filter.outputPins[0])->getData() = NULL;
+    static_cast<G12Pin *>(filter.inputPins[0])->getData() = NULL;
+    delete edges;
+    delete image;
+}
+
+/**
+ *  The rows are ramps of the different slopes, so the horizontal gradient is constant along each row and
+ *  is a negative value that is not divisible by 4. The last columns are computed by the scalar tail.
+ **/
+void testGradientTail()
+{
+    int h = 20, w = 61;
+    const int slopes[] = {1, 1, 2};
+    G12Buffer *image = new G12Buffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            image->element(i, j) = 500 + slopes[i % 3] * j;
+
+    CannyDetector detector;
+    G8Buffer *labels = detector.classify(image, 400, 4000);
+    ASSERT_TRUE(labels != NULL, "Classification should give labels");
+    for (int i = 1; i < h - 1; i++)
+    {
+        int16_t first = (int16_t)detector.gradientX()->element(i, 1);
+        ASSERT_TRUE_P(first < 0, ("Gradient should be negative at row %d", i));
+        for (int j = 2; j < w - 1; j++)
+        {
+            int16_t value = (int16_t)detector.gradientX()->element(i, j);
+            ASSERT_TRUE_P(value == first, ("Gradient differs at %d %d: %d and %d", i, j, value, first));
+        }
+    }
+    delete image;
+}
+
+int main (int /*argC*/, char ** /*argV*/)
+{
+    testSuppression();
+    testGradientTail();
+    testHysteresis();
+    testStepAndFilter();
+
+    cout << "PASSED" << endl;
+    return 0;
+}
@@ -0,0 +1,8 @@
+##################################################################
+# cascade_detector.pro created on Oct 19, 2026
+# This is a file for QMAKE that allows to build the test cascade_detector
+#
+##################################################################
+include(../testsCommon.pri)
+
+SOURCES += main_test_cascade_detector.cpp
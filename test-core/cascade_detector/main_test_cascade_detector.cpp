@@ -0,0 +1,177 @@
+/**
+ * \file main_test_cascade_detector.cpp
+ * \brief This is the main file for the test cascade_detector
+ *
+ * \date Oct 19, 2026
+ *
+ * \ingroup autotest
+ */
+
+#include <iostream>
+#include <math.h>
+
+#ifndef ASSERTS
+#define ASSERTS
+#endif
+
+#include "global.h"
+
+#include "g12Buffer.h"
+#include "integralBuffer.h"
+#include "vjPattern.h"
+#include "cascadeClassifier.h"
+
+using namespace std;
+using namespace corecvs;
+
+static const int WINDOW = 8;
+
+/* Bright 4x4 square in the middle of the 8x8 window */
+static void addSpotStages(CascadeClassifier &cascade)
+{
+    VJPattern *contrast = new VJPattern();
+    contrast->addRectangle(0, 0, WINDOW, WINDOW, -1);
+    contrast->addRectangle(2, 2, 6, 6, 4);
+    VJAdaBoostedClassifier contrastStage;
+    contrastStage.addClassifier(new VJSimpleClassifier(contrast, 48 * 1000, 0, 0, WINDOW, WINDOW), 1.0);
+    cascade.addStage(contrastStage);
+
+    VJPattern *brightness = new VJPattern();
+    brightness->addRectangle(2, 2, 6, 6, 1);
+    VJPattern *left = new VJPattern();
+    left->addRectangle(0, 0, 4, WINDOW, -1);
+    left->addRectangle(4, 0, WINDOW, WINDOW, 1);
+    VJAdaBoostedClassifier brightnessStage;
+    brightnessStage.addClassifier(new VJSimpleClassifier(brightness, 16 * 2000, 0, 0, WINDOW, WINDOW), 1.0);
+    brightnessStage.addClassifier(new VJSimpleClassifier(left, -32 * 400, 0, 0, WINDOW, WINDOW), 0.5);
+    cascade.addStage(brightnessStage);
+}
+
+static G12Buffer *drawSpots()
+{
+    G12Buffer *image = new G12Buffer(100, 131);
+    for (int i = 0; i < image->h; i++)
+        for (int j = 0; j < image->w; j++)
+            image->element(i, j) = 500 + ((i * 7 + j * 13) % 50);
+
+    /* 4x4 spot is found at the scale 1.0, 8x8 one at the scale 1.95 */
+    for (int i = 20; i < 24; i++)
+        for (int j = 20; j < 24; j++)
+            image->element(i, j) = 3000;
+    for (int i = 60; i < 68; i++)
+        for (int j = 90; j < 98; j++)
+            image->element(i, j) = 3500;
+    return image;
+}
+
+/* Checks the threaded SIMD scan against the plain evaluation of every window */
+void testAgainstScalar(int step)
+{
+    CascadeClassifier cascade(WINDOW, WINDOW);
+    addSpotStages(cascade);
+    G12Buffer *image = drawSpots();
+    G12IntegralBuffer *integral = new G12IntegralBuffer(image);
+
+    CascadeDetectorParameters params;
+    params.step = step;
+    params.minNeighbours = 0;
+
+    vector<CascadeHit> hits;
+    cascade.detect(integral, params, &hits);
+
+    vector<CascadeHit> expected;
+    CascadeStatistics expectedStats(cascade.stagesNumber());
+    for (double scale = params.minScale; ; scale *= params.scaleFactor)
+    {
+        CompiledCascade *compiled = cascade.compile(scale, integral->stride);
+        if (compiled->windowH > image->h || compiled->windowW > image->w)
+        {
+            delete compiled;
+            break;
+        }
+        int scaledStep = CORE_MAX(1, fround(step * scale));
+        for (int y = 0; y + compiled->windowH <= image->h; y += scaledStep)
+        {
+            for (int x = 0; x + compiled->windowW <= image->w; x += scaledStep)
+            {
+                int passed = compiled->evaluate(&integral->element(y, x));
+                expectedStats.addWindow(passed);
+                if (passed == cascade.stagesNumber())
+                    expected.push_back(CascadeHit(x, y, compiled->windowW, compiled->windowH, scale));
+            }
+        }
+        delete compiled;
+    }
+    std::sort(expected.begin(), expected.end());
+
+    cout << "Step " << step << ": " << hits.size() << " hits among " << cascade.stats.windows << " windows" << endl;
+    ASSERT_TRUE(hits.size() == expected.size(), "Wrong number of hits");
+    ASSERT_TRUE(hits.size() > 0, "Spots should be detected");
+    for (unsigned i = 0; i < hits.size(); i++)
+    {
+        ASSERT_TRUE(hits[i].x == expected[i].x && hits[i].y == expected[i].y && hits[i].w == expected[i].w, "Hits differ");
+    }
+
+    ASSERT_TRUE(cascade.stats.windows  == expectedStats.windows,  "Wrong number of windows");
+    ASSERT_TRUE(cascade.stats.accepted == expected.size(),        "Wrong number of accepted windows");
+    uint64_t total = cascade.stats.accepted;
+    for (int s = 0; s < cascade.stagesNumber(); s++)
+    {
+        ASSERT_TRUE(cascade.stats.rejected[s] == expectedStats.rejected[s], "Wrong early reject statistics");
+        total += cascade.stats.rejected[s];
+    }
+    ASSERT_TRUE(total == cascade.stats.windows, "Every window is either rejected or accepted");
+    ASSERT_TRUE(cascade.stats.rejected[0] > cascade.stats.windows / 2, "Most windows should be rejected by the first stage");
+
+    delete integral;
+    delete image;
+}
+
+void testGrouping()
+{
+    CascadeClassifier cascade(WINDOW, WINDOW);
+    addSpotStages(cascade);
+    G12Buffer *image = drawSpots();
+    G12IntegralBuffer *integral = new G12IntegralBuffer(image);
+
+    CascadeDetectorParameters params;
+    params.minNeighbours = 1;
+    vector<DetectedObject> objects = cascade.detect(integral, params);
+
+    bool smallFound = false;
+    bool largeFound = false;
+    for (unsigned i = 0; i < objects.size(); i++)
+    {
+        Vector2dd center = objects[i].imagePosition;
+        if (fabs(center.x() - 22) <= 2 && fabs(center.y() - 22) <= 2)
+            smallFound = true;
+        else if (fabs(center.x() - 94) <= 3 && fabs(center.y() - 64) <= 3)
+            largeFound = true;
+        else
+            ASSERT_FALSE(true, "Object found away from the spots");
+    }
+    ASSERT_TRUE(smallFound, "Small spot is not found");
+    ASSERT_TRUE(largeFound, "Large spot is not found");
+
+    vector<CascadeHit> hits;
+    hits.push_back(CascadeHit(10, 10, 20, 20));
+    hits.push_back(CascadeHit(11, 10, 20, 20));
+    hits.push_back(CascadeHit(10, 11, 21, 21));
+    hits.push_back(CascadeHit(60, 60, 20, 20));
+    vector<DetectedObject> grouped = CascadeClassifier::group(hits, 2, 0.2);
+    ASSERT_TRUE(grouped.size() == 1, "Lonely hit should be discarded");
+    ASSERT_TRUE(fabs(grouped[0].imagePosition.x() - (31.0 / 3 + 61.0 / 6)) < 1e-9, "Wrong mean of the group");
+
+    delete integral;
+    delete image;
+}
+
+int main (int /*argC*/, char ** /*argV*/)
+{
+    testAgainstScalar(1);
+    testAgainstScalar(2);
+    testGrouping();
+
+    cout << "PASSED" << endl;
+    return 0;
+}
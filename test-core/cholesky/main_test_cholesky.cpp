@@ -78,10 +78,36 @@ void testCholesky1(void)
 
 }
 
+void testZeroPivot(void)
+{
+    /* Semidefinite, the zero pivot has the zero numerator */
+    Matrix semidefinite(2, 2);
+    semidefinite.fillWithArgs(
+            1.0, 0.0,
+            0.0, 0.0);
+    UpperUnitaryMatrix *U;
+    DiagonalMatrix *D;
+    Cholesky::udutDecompose(&semidefinite, &U, &D);
+    ASSERT_TRUE(U->a(0, 1) == 0.0 && D->at(1) == 0.0, "Semidefinite matrix should be factored");
+    delete U;
+    delete D;
+
+    /* Indefinite, the zero pivot with the nonzero numerator should not become zero */
+    Matrix indefinite(2, 2);
+    indefinite.fillWithArgs(
+            1.0, 1.0,
+            1.0, 0.0);
+    Cholesky::udutDecompose(&indefinite, &U, &D);
+    ASSERT_TRUE(U->a(0, 1) != 0.0, "Indefinite matrix should not be silently factored");
+    delete U;
+    delete D;
+}
+
 int main (int /*argC*/, char ** /*argV*/)
 {
     //testCholesky();
     testCholesky1();
+    testZeroPivot();
         cout << "PASSED" << endl;
         return 0;
 }
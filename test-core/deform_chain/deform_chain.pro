@@ -0,0 +1,8 @@
+##################################################################
+# deform_chain.pro created on Oct 19, 2026
+# This is a file for QMAKE that allows to build the test deform_chain
+#
+##################################################################
+include(../testsCommon.pri)
+
+SOURCES += main_test_deform_chain.cpp
@@ -0,0 +1,201 @@
+/**
+ * \file main_test_deform_chain.cpp
+ * \brief This is the main file for the test deform_chain
+ *
+ * \date Oct 19, 2026
+ *
+ * \ingroup autotest
+ */
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef ASSERTS
+#define ASSERTS
+#endif
+
+#include "global.h"
+
+#include "g12Buffer.h"
+#include "matrix33.h"
+#include "deformChain.h"
+#include "transformationCache.h"
+
+using namespace std;
+using namespace corecvs;
+
+static const int H = 100;
+static const int W = 300;
+
+static Matrix33 rectification()
+{
+    return Matrix33::ShiftProj(4.5, -3.25) * Matrix33::RotateProj(0.05) * Matrix33::Scale2(0.97);
+}
+
+static LensCorrectionParametres lens(double k1)
+{
+    vector<double> koeff;
+    koeff.push_back(0.0);
+    koeff.push_back(k1);
+    LensCorrectionParametres params(koeff, 0.001, -0.002, Vector2d32(W / 2, H / 2));
+    params.focal = 200.0;
+    return params;
+}
+
+static DeformChain *makeChain(double k1)
+{
+    DeformChain *chain = new DeformChain();
+    chain->add(new ProjectiveDeformStep(rectification()))
+          .add(new RadialDeformStep(lens(k1)));
+    return chain;
+}
+
+static bool sameMaps(const RemapMap &first, const RemapMap &second)
+{
+    return first.coords == second.coords && first.fractions == second.fractions;
+}
+
+void testComposition()
+{
+    ComposedRemap composed(makeChain(0.05), H, W, H, W);
+
+    RemapMap expected(H, W, H, W);
+    Matrix33 matrix = rectification();
+    RadialCorrection correction(lens(0.05));
+    for (int i = 0; i < H; i++)
+    {
+        for (int j = 0; j < W; j++)
+        {
+            Vector2dd source = correction.map(matrix * Vector2dd(j, i));
+            expected.set(i, j, source.x(), source.y());
+        }
+    }
+    ASSERT_TRUE(sameMaps(composed.map(), expected), "Composed map differs from the sequential mapping");
+}
+
+void testLazyTiles()
+{
+    ComposedRemap composed(makeChain(0.05), H, W, H, W);
+    int tiles = composed.tilesH() * composed.tilesW();
+    ASSERT_TRUE(tiles > 2, "Test needs several tiles");
+
+    composed.prepare(RemapEngine::TILE_H + 1, 1, 2, 2);
+    ASSERT_TRUE(composed.tilesBuilt() == 1, "Only the requested tile should be built");
+    ASSERT_TRUE(composed.isTileReady(1, 0), "Requested tile is not built");
+    ASSERT_TRUE(!composed.isTileReady(0, 0), "Not requested tile is built");
+    ASSERT_TRUE(!composed.isComplete(), "Map should not be complete");
+
+    composed.prepare(0, 0, RemapEngine::TILE_H * 2, RemapEngine::TILE_W + 1);
+    ASSERT_TRUE(composed.tilesBuilt() == 4, "Built tiles should not be rebuilt");
+
+    composed.prepareAll();
+    ASSERT_TRUE(composed.isComplete() && composed.tilesBuilt() == tiles, "All tiles should be built once");
+}
+
+void testDiskCache()
+{
+    string directory = ".";
+    ComposedRemap first(makeChain(0.05), H, W, H, W);
+    string fileName = ComposedRemap::cacheFileName(directory, first.key());
+    remove(fileName.c_str());
+
+    ASSERT_TRUE(!first.setCacheDirectory(directory), "Cache should be empty");
+    first.prepareAll();
+    FILE *file = fopen(fileName.c_str(), "rb");
+    ASSERT_TRUE(file != NULL, "Complete map should be stored");
+    fclose(file);
+
+    ComposedRemap second(makeChain(0.05), H, W, H, W);
+    ASSERT_TRUE(second.key() == first.key(), "Same parameters should give the same key");
+    ASSERT_TRUE(second.setCacheDirectory(directory), "Map should be read from the cache");
+    ASSERT_TRUE(second.isComplete() && second.tilesBuilt() == 0, "Map read from the cache should not be rebuilt");
+    ASSERT_TRUE(sameMaps(second.map(), first.map()), "Cached map differs");
+
+    /* Damaged coordinates under the valid header are not trusted */
+    FILE *damaged = fopen(fileName.c_str(), "r+b");
+    ASSERT_TRUE(damaged != NULL, "Unable to open the cache file");
+    int16_t outside[2] = { W + 100, 5 };
+    fseek(damaged, 8 + 6 * 4 + 2 * 2 * (10 * W + 20), SEEK_SET);
+    size_t written = fwrite(outside, sizeof(int16_t), 2, damaged);
+    fclose(damaged);
+    ASSERT_TRUE(written == 2, "Unable to damage the cache file");
+    ComposedRemap third(makeChain(0.05), H, W, H, W);
+    bool damagedLoaded = third.loadCache(fileName);
+    ASSERT_TRUE(!damagedLoaded && !third.isComplete(), "Cache with the source outside of the input should be rejected");
+
+    ComposedRemap other(makeChain(0.06), H, W, H, W);
+    ASSERT_TRUE(other.key() != first.key(), "Other parameters should give the other key");
+    ComposedRemap otherSize(makeChain(0.05), H, W + 1, H, W);
+    ASSERT_TRUE(otherSize.key() != first.key(), "Other size should give the other key");
+
+    remove(fileName.c_str());
+}
+
+void testOtherStepsAndCache()
+{
+    G12Buffer *image = new G12Buffer(H, W);
+    for (int i = 0; i < H; i++)
+        for (int j = 0; j < W; j++)
+            image->element(i, j) = (i * 7 + j * 13) % 4096;
+
+    vector<Vector2dd> lut;
+    lut.push_back(Vector2dd(0.0    , 1.0));
+    lut.push_back(Vector2dd(1000.0 , 1.0));
+    lut.push_back(Vector2dd(40000.0, 0.98));
+    Vector2dd center(W / 2.0, H / 2.0);
+
+    DisplacementBuffer shift(H, W, Vector2dd(1.5, -0.5));
+
+    DeformChain *chain = new DeformChain();
+    chain->add(new SphericalDeformStep(center, lut))
+          .add(new DisplacementDeformStep(&shift));
+
+    /* Spherical LUT is identity near the center, the displacement is the constant shift */
+    Vector2dd source;
+    ASSERT_TRUE(chain->map(center + Vector2dd(3, 4), source), "Point should be mapped");
+    ASSERT_TRUE((source - (center + Vector2dd(4.5, 3.5))).l2Metric() < 1e-9, "Wrong chain mapping");
+    ASSERT_TRUE(!chain->map(Vector2dd(-5.0, 10.0), source), "Point outside of the displacement should have no source");
+
+    DeformChain *copy = new DeformChain();
+    copy->add(new SphericalDeformStep(center, lut))
+         .add(new DisplacementDeformStep(&shift));
+    ComposedRemap composed(copy, H, W, H, W);
+
+    /* The region remap builds and writes only its own tiles */
+    G12Buffer *partial = new G12Buffer(H, W);
+    for (int i = 0; i < H; i++)
+        for (int j = 0; j < W; j++)
+            partial->element(i, j) = G12Buffer::BUFFER_MAX_VALUE;
+    ComposedRemap lazy(makeChain(0.05), H, W, H, W);
+    lazy.remap(image, partial, RemapEngine::TILE_H + 3, RemapEngine::TILE_W - 5, 4, 10);
+    ASSERT_TRUE(lazy.tilesBuilt() == 2, "Only the tiles of the region should be built");
+    ASSERT_TRUE(partial->element(0, 0) == G12Buffer::BUFFER_MAX_VALUE && partial->element(H - 1, W - 1) == G12Buffer::BUFFER_MAX_VALUE, "Pixels outside of the region should not change");
+    G12Buffer *whole = lazy.remap(image);
+    for (int i = RemapEngine::TILE_H + 3; i < RemapEngine::TILE_H + 7; i++)
+        for (int j = RemapEngine::TILE_W - 5; j < RemapEngine::TILE_W + 5; j++)
+            ASSERT_TRUE(partial->element(i, j) == whole->element(i, j), "Region remap differs from the whole one");
+    delete whole;
+    delete partial;
+
+    TransformationCache cache(chain, W, H, Vector2d<int>(W, H));
+    G12Buffer *cached = cache.doDeformation(InterpolationType::BILINEAR, image);
+    G12Buffer *direct = composed.remap(image);
+    ASSERT_TRUE(cached->isEqual(*direct), "TransformationCache should use the composed map");
+
+    delete direct;
+    delete cached;
+    delete image;
+}
+
+int main (int /*argC*/, char ** /*argV*/)
+{
+    testComposition();
+    testLazyTiles();
+    testDiskCache();
+    testOtherStepsAndCache();
+
+    cout << "PASSED" << endl;
+    return 0;
+}
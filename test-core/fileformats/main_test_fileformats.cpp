@@ -8,13 +8,22 @@
  */
 
 #include <global.h>
+#include <stdio.h>
+#include <math.h>
 #include <sstream>
+#include <fstream>
 #include <iostream>
 #include "rawLoader.h"
 #include "g12Buffer.h"
 #include "bmpLoader.h"
 #include "ppmLoader.h"
 #include "plyLoader.h"
+#include "preciseTimer.h"
+#include "tiledBuffer.h"
+#include "g12Codec.h"
+#include "bufferFactory.h"
+#include "flowBuffer.h"
+#include "depthBuffer.h"
 
 using namespace std;
 using namespace corecvs;
@@ -118,9 +127,513 @@ void testPlyLoader()
 
 }
 
+static FloatCloud *makeCloud(int count)
+{
+    FloatCloud *cloud = new FloatCloud(FloatCloud::COLOR);
+    cloud->resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        cloud->x[i] = 0.37f * i - 100.0f;
+        cloud->y[i] = 1.0f / (i + 1);
+        cloud->z[i] = (float)(i % 1013) * 3.1f;
+        cloud->color[i] = RGBColor(i % 256, (i * 7) % 256, (i * 13) % 256);
+    }
+    return cloud;
+}
+
+static bool isSameCloud(const FloatCloud *a, const FloatCloud *b)
+{
+    return a->size()  == b->size() &&
+           a->x       == b->x &&
+           a->y       == b->y &&
+           a->z       == b->z &&
+           a->hasChannel(FloatCloud::COLOR) == b->hasChannel(FloatCloud::COLOR) &&
+           (!a->hasChannel(FloatCloud::COLOR) || a->color == b->color);
+}
+
+void testPlyCloud()
+{
+    const int count = 100003;
+    FloatCloud *cloud = makeCloud(count);
+
+    /* Binary file through the mapping */
+    const char *fileName = "ply_cloud_test.ply";
+    {
+        ofstream file(fileName, ios::out | ios::binary);
+        bool written = PLYWriter::write(file, *cloud);
+        ASSERT_TRUE(written, "Unable to write the binary cloud");
+    }
+
+    PreciseTimer timer = PreciseTimer::currentTime();
+    PLYReader reader;
+    bool opened = reader.open(fileName);
+    ASSERT_TRUE(opened, "Unable to map the binary cloud");
+    FloatCloud *binary = reader.readCloud();
+    printf("Binary cloud of %d points read in %" PRIu64 " us\n", count, timer.usecsToNow());
+    ASSERT_TRUE(binary != NULL && isSameCloud(cloud, binary), "Binary cloud differs");
+
+    size_t stride = 0;
+    const uint8_t *rows = reader.elementData(reader.findElement("vertex"), &stride);
+    ASSERT_TRUE(rows != NULL && stride == 3 * sizeof(float) + 3, "Binary rows should be available in place");
+    float x;
+    memcpy(&x, rows + 5 * stride, sizeof(x));
+    ASSERT_TRUE(x == cloud->x[5], "Wrong mapped row");
+    reader.close();
+    remove(fileName);
+
+    /* Ascii and big endian through the stream */
+    PlyHeader::Format formats[2] = { PlyHeader::ASCII, PlyHeader::BINARY_BIG_ENDIAN };
+    for (int f = 0; f < 2; f++)
+    {
+        std::stringstream stream;
+        bool written = PLYWriter::write(stream, *cloud, formats[f]);
+        ASSERT_TRUE(written, "Unable to write the cloud");
+
+        timer = PreciseTimer::currentTime();
+        PLYReader streamReader;
+        bool opened = streamReader.open(stream);
+        ASSERT_TRUE(opened, "Unable to read the cloud");
+        FloatCloud *read = streamReader.readCloud();
+        printf("Format %d cloud read in %" PRIu64 " us\n", formats[f], timer.usecsToNow());
+        ASSERT_TRUE(read != NULL && isSameCloud(cloud, read), "Cloud differs after the round trip");
+        ASSERT_TRUE(formats[f] != PlyHeader::ASCII || streamReader.elementData(0, NULL) == NULL, "Ascii rows are not binary");
+        delete_safe(read);
+    }
+
+    delete_safe(binary);
+    delete_safe(cloud);
+}
+
+void testPlyProperties()
+{
+    const int count = 1000;
+    PlyHeader::Format formats[2] = { PlyHeader::ASCII, PlyHeader::BINARY_LITTLE_ENDIAN };
+    for (int f = 0; f < 2; f++)
+    {
+        std::stringstream stream;
+        PLYWriter writer(stream, formats[f]);
+        writer.addComment("normals and confidence");
+        writer.addElement("vertex", count);
+        writer.addProperty("x" , PlyProperty::TYPE_DOUBLE);
+        writer.addProperty("y" , PlyProperty::TYPE_DOUBLE);
+        writer.addProperty("z" , PlyProperty::TYPE_DOUBLE);
+        writer.addProperty("nx", PlyProperty::TYPE_FLOAT);
+        writer.addProperty("ny", PlyProperty::TYPE_FLOAT);
+        writer.addProperty("nz", PlyProperty::TYPE_FLOAT);
+        writer.addProperty("confidence", PlyProperty::TYPE_USHORT);
+        /* Triangles mixed with the quads */
+        writer.addElement("face", count / 2);
+        writer.addListProperty("vertex_indices", PlyProperty::TYPE_UCHAR, PlyProperty::TYPE_INT);
+        bool written = writer.writeHeader();
+        ASSERT_TRUE(written, "Unable to write the header");
+
+        for (int i = 0; i < count; i++)
+        {
+            double values[7] = { i * 0.1, -i * 0.2, 1.0 / (i + 1), 0.0, 1.0, 0.0, (double)(i * 61 % 65536) };
+            writer.writeRow(values);
+        }
+        for (int i = 0; i < count / 2; i++)
+        {
+            int face[4] = { i, i + 1, i + 2, i + 3 };
+            writer.writeListRow(i % 3 == 0 ? 4 : 3, face);
+        }
+        bool finished = writer.finish();
+        ASSERT_TRUE(finished, "Not all rows are written");
+
+        PLYReader reader;
+        bool opened = reader.open(stream);
+        ASSERT_TRUE(opened, "Unable to read the properties");
+        ASSERT_TRUE(reader.header().comments.size() == 1 && reader.header().comments[0] == "normals and confidence", "Comment is lost");
+        ASSERT_TRUE(reader.elementCount("face") == count / 2, "Wrong face count");
+
+        int vertex = reader.findElement("vertex");
+        vector<float> ny;
+        vector<int> confidence;
+        bool read = reader.readProperty(vertex, "ny", ny) && reader.readProperty(vertex, "confidence", confidence);
+        ASSERT_TRUE(read, "Unable to read the properties");
+        vector<float> missing;
+        read = reader.readProperty(vertex, "nw", missing);
+        ASSERT_FALSE(read, "Missing property should fail");
+        for (int i = 0; i < count; i++)
+        {
+            ASSERT_TRUE(ny[i] == 1.0f, "Wrong normal");
+            ASSERT_TRUE(confidence[i] == i * 61 % 65536, "Wrong confidence");
+        }
+
+        Mesh3D mesh;
+        read = reader.readMesh(mesh);
+        ASSERT_TRUE(read, "Unable to read the mesh");
+        ASSERT_TRUE(mesh.vertexes.size() == count, "Wrong vertex number");
+        ASSERT_TRUE(mesh.vertexes[10] == Vector3dd(10 * 0.1, -10 * 0.2, 1.0 / 11), "Wrong double vertex");
+        int triangles = 0;
+        for (int i = 0; i < count / 2; i++)
+        {
+            if (i % 3 == 0)
+                continue;
+            ASSERT_TRUE(mesh.faces[triangles] == Vector3d32(i, i + 1, i + 2), "Wrong triangle");
+            triangles++;
+        }
+        ASSERT_TRUE(mesh.faces.size() == (size_t)triangles, "Quads should be skipped");
+    }
+}
+
+void testPlyMesh()
+{
+    Mesh3D mesh;
+    mesh.addSphere(Vector3dd(1.0, 2.0, 3.0), 5.0, 20);
+    mesh.addAOB(Vector3dd(0.0), Vector3dd(1.0, 2.0, 3.0));
+
+    std::stringstream stream;
+    bool written = PLYWriter::write(stream, mesh);
+    ASSERT_TRUE(written, "Unable to write the mesh");
+
+    /* The loaded mesh is appended to the existing one */
+    Mesh3D loaded;
+    loaded.addAOB(Vector3dd(0.0), Vector3dd(1.0));
+    size_t vertexes = loaded.vertexes.size();
+    size_t faces    = loaded.faces.size();
+
+    PLYLoader loader;
+    int result = loader.loadPLY(stream, loaded);
+    ASSERT_TRUE(result == 0, "Unable to load the mesh");
+    ASSERT_TRUE(loaded.vertexes.size() == vertexes + mesh.vertexes.size(), "Wrong vertex number");
+    ASSERT_TRUE(loaded.faces.size()    == faces    + mesh.faces.size()   , "Wrong face number");
+    for (size_t i = 0; i < mesh.vertexes.size(); i++)
+        ASSERT_TRUE(loaded.vertexes[vertexes + i] == mesh.vertexes[i], "Vertex differs");
+    for (size_t i = 0; i < mesh.faces.size(); i++)
+        ASSERT_TRUE(loaded.faces[faces + i] == mesh.faces[i] + Vector3d32((int)vertexes), "Face differs");
+
+    /* Truncated binary data and the wrong index */
+    std::string data = stream.str();
+    std::stringstream truncated(data.substr(0, data.size() - 5));
+    Mesh3D broken;
+    result = loader.loadPLY(truncated, broken);
+    ASSERT_TRUE(result != 0, "Truncated mesh should fail");
+
+    /* The face count of the corrupted header is far above the data */
+    std::string hugeHeader =
+        "ply\n"
+        "format binary_little_endian 1.0\n"
+        "element face 1000000000000\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n";
+    std::string huge = hugeHeader + std::string("\x03\x00\x00\x00\x00\x01\x00\x00\x00\x02\x00\x00\x00", 13);
+    PLYReader hugeReader;
+    bool hugeOpened = hugeReader.open((const uint8_t *)huge.data(), huge.size());
+    ASSERT_FALSE(hugeOpened, "Face count above the data should fail");
+
+    std::stringstream wrongIndex(
+        "ply\n"
+        "format ascii 1.0\n"
+        "element vertex 3\n"
+        "property float x\n"
+        "property float y\n"
+        "property float z\n"
+        "element face 1\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n"
+        "0 0 0\n"
+        "0 1 0\n"
+        "1 0 0\n"
+        "3 0 1 3\n");
+    result = loader.loadPLY(wrongIndex, broken);
+    ASSERT_TRUE(result != 0, "Wrong vertex index should fail");
+}
+
+/* The rectangle of the buffer is the same as the other buffer */
+template<class BufferType>
+static bool isSameRect(const BufferType *buffer, int top, int left, const BufferType *rect)
+{
+    for (int i = 0; i < rect->h; i++)
+        for (int j = 0; j < rect->w; j++)
+            if (!(buffer->element(top + i, left + j) == rect->element(i, j)))
+                return false;
+    return true;
+}
+
+void testTiledLZ()
+{
+    /* Repetitive, random and short inputs */
+    vector<uint8_t> inputs[4];
+    for (int i = 0; i < 100000; i++)
+        inputs[0].push_back((uint8_t)((i / 7) % 13));
+    for (int i = 0; i < 5000; i++)
+        inputs[1].push_back((uint8_t)(rand() >> 4));
+    inputs[2].push_back(42);
+    inputs[3].assign(70000, 0xFF);
+
+    for (unsigned t = 0; t < CORE_COUNT_OF(inputs); t++)
+    {
+        vector<uint8_t> packed;
+        TiledBufferFormat::compressLZ(&inputs[t][0], inputs[t].size(), packed);
+        vector<uint8_t> unpacked(inputs[t].size());
+        bool ok = TiledBufferFormat::decompressLZ(&packed[0], packed.size(), &unpacked[0], unpacked.size());
+        printf("LZ case %u: %d -> %d bytes\n", t, (int)inputs[t].size(), (int)packed.size());
+        ASSERT_TRUE(ok && unpacked == inputs[t], "LZ round trip failed");
+        if (t == 0 || t == 3)
+            ASSERT_TRUE(packed.size() * 50 < inputs[t].size(), "Repetitive data should compress well");
+
+        /* The damaged stream should be rejected, not overrun the output */
+        ok = TiledBufferFormat::decompressLZ(&packed[0], packed.size() - 1, &unpacked[0], unpacked.size());
+        ASSERT_FALSE(ok && packed.size() > 1, "Truncated LZ stream should fail");
+    }
+}
+
+void testTiledBuffer()
+{
+    /* Smooth flow with the holes, the usual debug dump */
+    int h = 300, w = 257;
+    FlowBuffer *flow = new FlowBuffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            if ((i / 5 + j / 3) % 7 != 0)
+                flow->element(i, j) = FlowElement(j / 10 - 12, i / 20 + (i * j) % 3);
+
+    FlowBuffer *half = TiledBufferWriter::subsample(flow);
+    ASSERT_TRUE(half->h == 150 && half->w == 129, "Wrong level size");
+
+    TiledBufferFormat::Codec codecs[3] = { TiledBufferFormat::CODEC_NONE, TiledBufferFormat::CODEC_LZ, TiledBufferFormat::CODEC_DELTA_LZ };
+    uint64_t sizes[3];
+    for (int c = 0; c < 3; c++)
+    {
+        std::stringstream stream;
+        TiledBufferWriter writer(sizeof(FlowElement), 64, codecs[c]);
+        writer.addLevel(flow);
+        writer.addLevel(half);
+        bool written = writer.write(stream);
+        ASSERT_TRUE(written, "Unable to write the tiled flow");
+        sizes[c] = writer.encodedSize();
+
+        TiledBufferReader reader;
+        bool opened = reader.open(stream);
+        ASSERT_TRUE(opened, "Unable to read the tiled flow");
+        ASSERT_TRUE(reader.levels() == 2 && reader.levelH(1) == half->h && reader.levelW(1) == half->w, "Wrong levels");
+
+        FlowBuffer *whole = reader.read<FlowBuffer>();
+        ASSERT_TRUE(whole != NULL && whole->isEqual(*flow), "Tiled flow differs");
+        ASSERT_TRUE(reader.decodedTiles() == 5 * 5, "Whole level should decode all tiles");
+
+        /* The rectangle inside of two tiles */
+        FlowBuffer *rect = reader.read<FlowBuffer>(0, 100, 70, 50, 40);
+        ASSERT_TRUE(rect != NULL && isSameRect(flow, 100, 70, rect), "Tiled rectangle differs");
+        ASSERT_TRUE(reader.decodedTiles() == 5 * 5 + 2, "Rectangle should decode only the crossed tiles");
+
+        FlowBuffer *level = reader.read<FlowBuffer>(1);
+        ASSERT_TRUE(level != NULL && level->isEqual(*half), "Pyramid level differs");
+
+        DepthBuffer *wrongType = reader.read<DepthBuffer>();
+        ASSERT_TRUE(wrongType == NULL, "Element size should be checked");
+        FlowBuffer *outside = reader.read<FlowBuffer>(0, 290, 0, 20, 10);
+        ASSERT_TRUE(outside == NULL, "Rectangle outside of the level should fail");
+
+        delete_safe(level);
+        delete_safe(rect);
+        delete_safe(whole);
+    }
+    printf("Tiled flow: raw %d, LZ %d, delta LZ %d bytes\n", (int)sizes[0], (int)sizes[1], (int)sizes[2]);
+    ASSERT_TRUE(sizes[0] == (uint64_t)(h * w + half->h * half->w) * sizeof(FlowElement), "Raw tiles should be stored as is");
+    ASSERT_TRUE(sizes[2] * 4 < sizes[0], "Delta coding should compress the smooth flow");
+
+    /* Depth buffer through the mapped file, then the damaged copies */
+    DepthBuffer *depth = new DepthBuffer(100, 130);
+    for (int i = 0; i < depth->h; i++)
+        for (int j = 0; j < depth->w; j++)
+            depth->element(i, j) = (i + j) % 11 == 0 ? DepthBuffer::DEPTH_UNKNOWN : 1000.0 / (1 + i) + j * 0.25;
+
+    const char *fileName = "tiled_buffer_test.cvst";
+    std::string data;
+    {
+        std::stringstream stream;
+        TiledBufferWriter writer(sizeof(double), 32);
+        writer.addLevel(depth);
+        writer.write(stream);
+        data = stream.str();
+        ofstream file(fileName, ios::out | ios::binary);
+        file.write(data.c_str(), data.size());
+    }
+
+    TiledBufferReader reader;
+    bool opened = reader.open(fileName);
+    ASSERT_TRUE(opened, "Unable to map the tiled depth");
+    DepthBuffer *depthRead = reader.read<DepthBuffer>(0, 33, 1, 60, 128);
+    ASSERT_TRUE(depthRead != NULL && isSameRect(depth, 33, 1, depthRead), "Tiled depth differs");
+    reader.close();
+    remove(fileName);
+
+    opened = reader.open((const uint8_t *)data.c_str(), data.size() - 10);
+    ASSERT_FALSE(opened, "Truncated file should fail");
+    std::string damaged = data;
+    damaged[damaged.size() - 20] ^= 0x5A;
+    opened = reader.open((const uint8_t *)damaged.c_str(), damaged.size());
+    ASSERT_TRUE(opened, "Index is intact");
+    DepthBuffer *damagedRead = reader.read<DepthBuffer>();
+    ASSERT_TRUE(damagedRead == NULL || !isSameRect(depth, 0, 0, damagedRead), "Damaged tile should not pass unnoticed");
+
+    delete_safe(damagedRead);
+    delete_safe(depthRead);
+    delete_safe(depth);
+    delete_safe(half);
+    delete_safe(flow);
+}
+
+/* Smooth scene with the sensor noise of a few low bits */
+static G12Buffer *makeFrame(int h, int w, int noise)
+{
+    G12Buffer *frame = new G12Buffer(h, w);
+    uint32_t seed = 12345;
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            seed = seed * 1664525 + 1013904223;
+            int value = 600 + 8 * i + 3 * j + ((i / 16 + j / 16) % 2) * 500 + (int)(seed >> 16) % (2 * noise + 1) - noise;
+            frame->element(i, j) = (uint16_t)CORE_MAX(0, CORE_MIN(value, G12Buffer::BUFFER_MAX_VALUE));
+        }
+    }
+    return frame;
+}
+
+/**
+ *  Smooth illumination falling to the corners with a few bright objects and the gaussian read noise
+ *  of 2 codes, like the frames of our stereo cameras
+ **/
+static G12Buffer *makeSensorFrame(int h, int w)
+{
+    G12Buffer *frame = new G12Buffer(h, w);
+    uint32_t seed = 54321;
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            double dx = (j - w / 2.0) / w;
+            double dy = (i - h / 2.0) / h;
+            double value = 1800.0 * (1.0 - 1.2 * (dx * dx + dy * dy));
+            if ((i / 40 + j / 60) % 3 == 0)
+                value += 700.0;
+            /* Sum of the four uniform values, close to gaussian, scaled to sigma 2 */
+            double noise = 0.0;
+            for (int k = 0; k < 4; k++)
+            {
+                seed = seed * 1664525 + 1013904223;
+                noise += (seed >> 8) / (double)(1 << 24) - 0.5;
+            }
+            value += noise * 2.0 * sqrt(3.0);
+            frame->element(i, j) = (uint16_t)CORE_MAX(0, CORE_MIN((int)(value + 0.5), G12Buffer::BUFFER_MAX_VALUE));
+        }
+    }
+    return frame;
+}
+
+void testG12Codec()
+{
+    uint16_t values[6] = { 0, 4095, 1, 2048, 0xABC, 0x123 };
+    uint8_t packed[9];
+    uint16_t unpacked[6];
+    G12Codec::pack12(values, 6, packed);
+    G12Codec::unpack12(packed, 6, unpacked);
+    ASSERT_TRUE(memcmp(values, unpacked, sizeof(values)) == 0, "12 bit packing differs");
+
+    int h = 240, w = 321;
+    G12Buffer *frame = makeFrame(h, w, 6);
+    size_t packedSize = ((size_t)w * 3 + 1) / 2 * h;
+
+    G12Codec codecs[3] = {
+        G12Codec(G12Codec::MODE_PACKED),
+        G12Codec(G12Codec::MODE_RICE, G12Codec::PREDICTOR_UP),
+        G12Codec(G12Codec::MODE_RICE, G12Codec::PREDICTOR_MED, 17)
+    };
+    size_t sizes[3];
+    for (int c = 0; c < 3; c++)
+    {
+        vector<uint8_t> encoded;
+        PreciseTimer timer = PreciseTimer::currentTime();
+        bool ok = codecs[c].encode(frame, encoded);
+        uint64_t encodeTime = timer.usecsToNow();
+        ASSERT_TRUE(ok, "Unable to encode the frame");
+        sizes[c] = encoded.size();
+
+        timer = PreciseTimer::currentTime();
+        G12Buffer *decoded = G12Codec::decode(&encoded[0], encoded.size());
+        uint64_t decodeTime = timer.usecsToNow();
+        ASSERT_TRUE(decoded != NULL && decoded->isEqual(*frame), "Decoded frame differs");
+        printf("G12 codec %d: %d bytes, encode %d us, decode %d us\n", c, (int)sizes[c], (int)encodeTime, (int)decodeTime);
+
+        G12Buffer *truncated = G12Codec::decode(&encoded[0], encoded.size() - 1);
+        ASSERT_TRUE(truncated == NULL, "Truncated frame should fail");
+        delete_safe(decoded);
+    }
+    printf("G12 codec: 16 bit %d, packed %d, up %d, med %d bytes\n", h * w * 2, (int)sizes[0], (int)sizes[1], (int)sizes[2]);
+    ASSERT_TRUE(sizes[0] < packedSize + 100, "Packed frame should take 12 bits per pixel");
+    ASSERT_TRUE(sizes[1] < (size_t)h * w, "Rice code should be twice smaller than the 16 bit frame");
+    ASSERT_TRUE(sizes[2] < sizes[1], "Median predictor should be better than the row delta");
+
+    /* The recordings should become 3-4 times smaller than the 16 bit frames */
+    G12Buffer *sensor = makeSensorFrame(480, 640);
+    vector<uint8_t> sensorEncoded;
+    bool sensorOk = G12Codec().encode(sensor, sensorEncoded);
+    ASSERT_TRUE(sensorOk, "Unable to encode the sensor frame");
+    double ratio = (double)sensor->h * sensor->w * sizeof(uint16_t) / sensorEncoded.size();
+    printf("G12 codec: sensor frame compressed %.2lf times\n", ratio);
+    ASSERT_TRUE_P(ratio >= 3.0, ("Sensor frame should be compressed at least 3 times, not %.2lf", ratio));
+    G12Buffer *sensorDecoded = G12Codec::decode(&sensorEncoded[0], sensorEncoded.size());
+    ASSERT_TRUE(sensorDecoded != NULL && sensorDecoded->isEqual(*sensor), "Decoded sensor frame differs");
+    delete_safe(sensorDecoded);
+    delete_safe(sensor);
+
+    /* The header mode should agree with the stripes */
+    vector<uint8_t> packedEncoded;
+    bool packedOk = G12Codec(G12Codec::MODE_PACKED).encode(frame, packedEncoded);
+    ASSERT_TRUE(packedOk, "Unable to encode the packed frame");
+    packedEncoded[16] = 7;
+    G12Buffer *wrongMode = G12Codec::decode(&packedEncoded[0], packedEncoded.size());
+    ASSERT_TRUE(wrongMode == NULL, "Unknown mode should fail");
+    delete_safe(wrongMode);
+
+    /* White noise is not compressible, the stripes fall back to the packing */
+    G12Buffer *noise = new G12Buffer(64, 64);
+    uint32_t seed = 1;
+    for (int i = 0; i < noise->h; i++)
+    {
+        for (int j = 0; j < noise->w; j++)
+        {
+            seed = seed * 1664525 + 1013904223;
+            noise->element(i, j) = (uint16_t)(seed >> 20);
+        }
+    }
+    vector<uint8_t> encoded;
+    bool ok = G12Codec().encode(noise, encoded);
+    ASSERT_TRUE(ok, "Unable to encode the noise");
+    ASSERT_TRUE(encoded.size() <= 64 * 96 + 100, "Noise should not grow above the packing");
+    G12Buffer *decoded = G12Codec::decode(&encoded[0], encoded.size());
+    ASSERT_TRUE(decoded != NULL && decoded->isEqual(*noise), "Decoded noise differs");
+    delete_safe(decoded);
+
+    noise->element(10, 10) = G12Buffer::BUFFER_MAX_VALUE + 1;
+    ok = G12Codec().encode(noise, encoded);
+    ASSERT_FALSE(ok, "Values above 12 bits should not be accepted");
+
+    /* Through the factory, as the file capture reads it */
+    const char *fileName = "test.g12z";
+    int saved = G12CodecLoader().save(fileName, frame);
+    ASSERT_TRUE(saved == 0, "Unable to save the frame");
+    G12Buffer *loaded = BufferFactory::getInstance()->loadG12Bitmap(fileName);
+    ASSERT_TRUE(loaded != NULL && loaded->isEqual(*frame), "Loaded frame differs");
+    remove(fileName);
+
+    delete_safe(loaded);
+    delete_safe(noise);
+    delete_safe(frame);
+}
+
 int main (int /*argC*/, char ** /*argV*/)
 {
     testPlyLoader();
+    testPlyCloud();
+    testPlyProperties();
+    testPlyMesh();
+    testTiledLZ();
+    testTiledBuffer();
+    testG12Codec();
     cout << "PASSED" << endl;
     return 0;
 }
@@ -0,0 +1,8 @@
+##################################################################
+# filter_graph.pro created on Oct 19, 2026
+# This is a file for QMAKE that allows to build the test filter_graph
+#
+##################################################################
+include(../testsCommon.pri)
+
+SOURCES += main_test_filter_graph.cpp
@@ -0,0 +1,443 @@
+/**
+ * \file main_test_filter_graph.cpp
+ * \brief This is the main file for the test filter_graph
+ *
+ * \date Oct 19, 2026
+ *
+ * \ingroup autotest
+ */
+
+#ifndef ASSERTS
+#define ASSERTS
+#endif
+
+#include <iostream>
+
+#include "global.h"
+
+#include "filterGraph.h"
+#include "inputFilter.h"
+#include "outputFilter.h"
+#include "gainOffsetFilter.h"
+#include "binarizeBlock.h"
+#include "maskFilterBlock.h"
+#include "bitSelectorFilter.h"
+#include "thickeningBlock.h"
+#include "sobelFilter.h"
+#include "calculationStats.h"
+
+using namespace std;
+using namespace corecvs;
+
+/**
+ *  Test graph
+ *
+ *       In
+ *      /  \
+ *   Gain  Binarize
+ *      \  /
+ *      Mask
+ *       |
+ *      Out
+ **/
+struct TestGraph
+{
+    FilterGraph graph;
+    InputFilter      *in;
+    GainOffsetFilter *gain;
+    BinarizeBlock    *binarize;
+    MaskFilterBlock  *mask;
+    OutputFilter     *out;
+
+    TestGraph() : graph(NULL, NULL)
+    {
+        /* Added in a wrong order on purpose */
+        out      = new OutputFilter();
+        mask     = new MaskFilterBlock();
+        gain     = new GainOffsetFilter();
+        binarize = new BinarizeBlock();
+        in       = new InputFilter();
+
+        graph.addBlock(out);
+        graph.addBlock(mask);
+        graph.addBlock(gain);
+        graph.addBlock(binarize);
+        graph.addBlock(in);
+
+        GainOffsetParameters gainParams(2.0, 0.0);
+        gain->setParameters(&gainParams);
+        BinarizeParameters binarizeParams(100);
+        binarize->setParameters(&binarizeParams);
+
+        graph.connect(in->outputPins[0]      , gain->inputPins[0]);
+        graph.connect(in->outputPins[0]      , binarize->inputPins[0]);
+        graph.connect(gain->outputPins[0]    , mask->inputPins[0]);
+        graph.connect(binarize->outputPins[0], mask->inputPins[1]);
+        graph.connect(mask->outputPins[0]    , out->inputPins[0]);
+    }
+};
+
+static G12Buffer *runGraph(TestGraph &test, G12Buffer *input)
+{
+    test.in->inputPins[0]->initPin(input);
+    test.graph.execute();
+
+    G12Buffer *output = NULL;
+    test.out->outputPins[0]->getPin(output, true);
+    test.graph.clearAllData();
+    return output;
+}
+
+void testLevels()
+{
+    TestGraph test;
+    ASSERT_TRUE(test.graph.topologicSort(), "Sort failed");
+    ASSERT_TRUE(test.graph.levelsNumber() == 4, "Wrong number of levels");
+    ASSERT_TRUE(test.graph.blocks[0] == test.in, "Input should come first");
+    ASSERT_TRUE(test.graph.levelStarts[2] - test.graph.levelStarts[1] == 2, "Gain and binarize should share a level");
+    ASSERT_TRUE(test.graph.blocks.back() == test.out, "Output should come last");
+}
+
+void testExecution(bool parallel)
+{
+    cout << "Testing graph execution. Parallel: " << parallel << endl;
+    TestGraph test;
+    test.graph.topologicSort();
+    test.graph.parallelExecution = parallel;
+
+    G12Buffer *input = new G12Buffer(20, 30);
+    for (int i = 0; i < input->h; i++)
+        for (int j = 0; j < input->w; j++)
+            input->element(i, j) = (i * 7 + j * 3) % 200;
+
+    for (int frame = 0; frame < 3; frame++)
+    {
+        G12Buffer *output = runGraph(test, input);
+        ASSERT_TRUE(output != NULL, "No output");
+
+        for (int i = 0; i < input->h; i++)
+        {
+            for (int j = 0; j < input->w; j++)
+            {
+                int value    = input->element(i, j);
+                int expected = value > 100 ? value / 2 : 0;    /* GainOffsetMapper divides by gain */
+                ASSERT_TRUE_P(output->element(i, j) == expected, ("Wrong value at %d %d: %d instead of %d\n", i, j, output->element(i, j), expected));
+            }
+        }
+        delete_safe(output);
+    }
+
+    /* Intermediate buffers of the first frame should be reused in the next ones */
+    ASSERT_TRUE(test.graph.pool.hits() > 0, "Pool was not used");
+    delete_safe(input);
+}
+
+void testFusedPlan()
+{
+    cout << "Testing fused execution plan" << endl;
+    TestGraph plain;
+    TestGraph fused;
+    plain.graph.topologicSort();
+    fused.graph.fusePointwise = true;
+
+    G12Buffer *input = new G12Buffer(50, 70);
+    input->fillWithRands(G12Buffer::BUFFER_MAX_VALUE);
+
+    for (int frame = 0; frame < 2; frame++)
+    {
+        G12Buffer *expected = runGraph(plain, input);
+        G12Buffer *output   = runGraph(fused, input);
+        ASSERT_TRUE(output != NULL, "No output from the fused graph");
+        ASSERT_TRUE(output->isEqual(*expected), "Fused and plain graphs differ");
+        delete_safe(expected);
+        delete_safe(output);
+    }
+
+    /* Gain and binarize read the same frame, so mask folds all three into one table */
+    ASSERT_TRUE(fused.graph.plan != NULL && fused.graph.plan->isValid(), "Plan should be compiled");
+    ASSERT_TRUE(fused.graph.plan->fusedBlocksNumber() == 2, "Gain and binarize should be fused into mask");
+
+    BinarizeParameters binarizeParams(2000);
+    fused.binarize->setParameters(&binarizeParams);
+    plain.binarize->setParameters(&binarizeParams);
+    ASSERT_FALSE(fused.graph.plan->isValid(), "Plan should be invalidated by parameters");
+
+    G12Buffer *expected = runGraph(plain, input);
+    G12Buffer *output   = runGraph(fused, input);
+    ASSERT_TRUE(output->isEqual(*expected), "Fused graph ignores new parameters");
+    delete_safe(expected);
+    delete_safe(output);
+
+    /* Chain of maps is fused into one step */
+    FilterGraph chain(NULL, NULL);
+    InputFilter       *in   = new InputFilter();
+    GainOffsetFilter  *gain = new GainOffsetFilter();
+    BitSelectorFilter *bits = new BitSelectorFilter();
+    OutputFilter      *out  = new OutputFilter();
+    chain.addBlock(in);
+    chain.addBlock(gain);
+    chain.addBlock(bits);
+    chain.addBlock(out);
+    chain.connect(in  ->outputPins[0], gain->inputPins[0]);
+    chain.connect(gain->outputPins[0], bits->inputPins[0]);
+    chain.connect(bits->outputPins[0], out ->inputPins[0]);
+    chain.fusePointwise = true;
+
+    in->inputPins[0]->initPin(input);
+    chain.execute();
+    ASSERT_TRUE(chain.plan->steps.size() == 3, "Gain and bit selector should make one step");
+    chain.clearAllData();
+
+    delete_safe(input);
+}
+
+/**
+ *  In -> Gain -> Binarize -> Thickening -> Out, the maps are the prologue of the striped thickening
+ **/
+struct StripedGraph
+{
+    FilterGraph graph;
+    InputFilter      *in;
+    ThickeningBlock  *thickening;
+    OutputFilter     *out;
+
+    StripedGraph(int power) : graph(NULL, NULL)
+    {
+        in         = new InputFilter();
+        GainOffsetFilter *gain     = new GainOffsetFilter();
+        BinarizeBlock    *binarize = new BinarizeBlock();
+        thickening = new ThickeningBlock();
+        out        = new OutputFilter();
+
+        graph.addBlock(in);
+        graph.addBlock(gain);
+        graph.addBlock(binarize);
+        graph.addBlock(thickening);
+        graph.addBlock(out);
+
+        GainOffsetParameters gainParams(1.0, 0.0);
+        gain->setParameters(&gainParams);
+        BinarizeParameters binarizeParams(4000);
+        binarize->setParameters(&binarizeParams);
+        ThickeningParameters thickeningParams(power);
+        thickening->setParameters(&thickeningParams);
+
+        graph.connect(in        ->outputPins[0], gain      ->inputPins[0]);
+        graph.connect(gain      ->outputPins[0], binarize  ->inputPins[0]);
+        graph.connect(binarize  ->outputPins[0], thickening->inputPins[0]);
+        graph.connect(thickening->outputPins[0], out       ->inputPins[0]);
+    }
+
+    G12Buffer *run(G12Buffer *input)
+    {
+        in->inputPins[0]->initPin(input);
+        graph.execute();
+        G12Buffer *output = NULL;
+        out->outputPins[0]->getPin(output, true);
+        graph.clearAllData();
+        return output;
+    }
+};
+
+void testStripedPlan()
+{
+    cout << "Testing striped neighbourhood blocks" << endl;
+    /* Several stripes of the plan, the sparse bright points cross the stripe borders */
+    G12Buffer *input = new G12Buffer(700, 150);
+    for (int i = 0; i < input->h; i++)
+        for (int j = 0; j < input->w; j++)
+            input->element(i, j) = (rand() % 50 == 0) ? 4095 : rand() % 4000;
+
+    int powers[] = {1, 4, 5};
+    for (unsigned k = 0; k < CORE_COUNT_OF(powers); k++)
+    {
+        StripedGraph plain(powers[k]);
+        StripedGraph fused(powers[k]);
+        plain.graph.topologicSort();
+        fused.graph.fusePointwise = true;
+        fused.graph.parallelExecution = true;
+
+        Statistics plainStats;
+        Statistics fusedStats;
+        plain.graph.stats = &plainStats;
+        fused.graph.stats = &fusedStats;
+
+        for (int frame = 0; frame < 2; frame++)
+        {
+            G12Buffer *expected = plain.run(input);
+            G12Buffer *output   = fused.run(input);
+            ASSERT_TRUE(output != NULL, "No output from the striped graph");
+            ASSERT_TRUE_P(output->isEqual(*expected), ("Striped and plain thickening of power %d differ", powers[k]));
+            delete_safe(expected);
+            delete_safe(output);
+        }
+
+        ASSERT_TRUE(fused.graph.plan->steps.size() == 3, "Gain and binarize should be the prologue of the thickening");
+        ASSERT_TRUE(fused.graph.plan->steps[1].striped && fused.graph.plan->steps[1].blocksFused == 3, "Thickening should be striped");
+
+        /* Both paths report the same rows */
+        ASSERT_TRUE(fusedStats.values.size() == plainStats.values.size(), "Statistics of the plan should have the same rows");
+        ASSERT_TRUE(fusedStats.values.find("Pool misses") != fusedStats.values.end(), "Plan should report the pool misses");
+    }
+
+    /* Without the prologue the thickening reads the frame directly */
+    FilterGraph direct(NULL, NULL);
+    InputFilter     *in         = new InputFilter();
+    ThickeningBlock *thickening = new ThickeningBlock();
+    OutputFilter    *out        = new OutputFilter();
+    direct.addBlock(in);
+    direct.addBlock(thickening);
+    direct.addBlock(out);
+    ThickeningParameters thickeningParams(3);
+    thickening->setParameters(&thickeningParams);
+    direct.connect(in        ->outputPins[0], thickening->inputPins[0]);
+    direct.connect(thickening->outputPins[0], out       ->inputPins[0]);
+    direct.fusePointwise = true;
+
+    in->inputPins[0]->initPin(input);
+    direct.execute();
+    G12Buffer *output = NULL;
+    out->outputPins[0]->getPin(output, true);
+    direct.clearAllData();
+
+    ThickeningBlock reference;
+    reference.setParameters(&thickeningParams);
+    reference.inputPins[0]->initPin(input);
+    reference();
+    G12Buffer *expected = NULL;
+    reference.outputPins[0]->getPin(expected, true);
+
+    ASSERT_TRUE(direct.plan->steps[1].striped && direct.plan->steps[1].valueTable.empty(), "Thickening should be striped without the prologue");
+    ASSERT_TRUE(output != NULL && output->isEqual(*expected), "Striped thickening differs from the block");
+    delete_safe(expected);
+    delete_safe(output);
+    delete_safe(input);
+}
+
+/**
+ *  In -> Gain -> Sobel -> Out, or In -> Sobel -> Out without the prologue
+ **/
+struct SobelGraph
+{
+    FilterGraph graph;
+    InputFilter  *in;
+    SobelFilter  *sobel;
+    OutputFilter *out;
+
+    SobelGraph(const SobelParameters &params, bool prologue) : graph(NULL, NULL)
+    {
+        in    = new InputFilter();
+        sobel = new SobelFilter();
+        out   = new OutputFilter();
+        graph.addBlock(in);
+        graph.addBlock(sobel);
+        graph.addBlock(out);
+        sobel->setParameters(&params);
+
+        Pin *source = in->outputPins[0];
+        if (prologue)
+        {
+            GainOffsetFilter *gain = new GainOffsetFilter();
+            graph.addBlock(gain);
+            GainOffsetParameters gainParams(2.0, 0.0);
+            gain->setParameters(&gainParams);
+            graph.connect(in->outputPins[0], gain->inputPins[0]);
+            source = gain->outputPins[0];
+        }
+        graph.connect(source              , sobel->inputPins[0]);
+        graph.connect(sobel->outputPins[0], out  ->inputPins[0]);
+    }
+
+    G12Buffer *run(G12Buffer *input)
+    {
+        in->inputPins[0]->initPin(input);
+        graph.execute();
+        G12Buffer *output = NULL;
+        out->outputPins[0]->getPin(output, true);
+        graph.clearAllData();
+        return output;
+    }
+};
+
+void testStripedSobel()
+{
+    cout << "Testing striped Sobel" << endl;
+    G12Buffer *input = new G12Buffer(900, 131);
+    input->fillWithRands(G12Buffer::BUFFER_MAX_VALUE);
+
+    SobelParameters modes[] = {
+        SobelParameters(SobelMixingType::SUM_OF_ABSOLUTE, true , true ),
+        SobelParameters(SobelMixingType::L2             , true , true ),
+        SobelParameters(SobelMixingType::L2             , true , false),
+        SobelParameters(SobelMixingType::L2             , false, true )
+    };
+
+    for (unsigned k = 0; k < CORE_COUNT_OF(modes); k++)
+    {
+        for (int prologue = 0; prologue < 2; prologue++)
+        {
+            SobelGraph plain(modes[k], prologue != 0);
+            SobelGraph fused(modes[k], prologue != 0);
+            plain.graph.topologicSort();
+            fused.graph.fusePointwise = true;
+            fused.graph.parallelExecution = true;
+
+            G12Buffer *expected = plain.run(input);
+            G12Buffer *output   = fused.run(input);
+            ASSERT_TRUE(output != NULL, "No output from the striped Sobel");
+            ASSERT_TRUE_P(output->isEqual(*expected), ("Striped and whole frame Sobel differ in the mode %d, prologue %d", k, prologue));
+            delete_safe(expected);
+            delete_safe(output);
+
+            FilterGraphPlan::Step &step = fused.graph.plan->steps[1];
+            ASSERT_TRUE(step.striped && step.block == fused.sobel, "Sobel should be striped");
+            ASSERT_TRUE(step.valueTable.empty() == (prologue == 0), "Gain should be the prologue of Sobel");
+        }
+    }
+
+    /* Without the directions Sobel is a view of the input and is executed by itself */
+    SobelGraph none(SobelParameters(SobelMixingType::L2, false, false), false);
+    none.graph.fusePointwise = true;
+    G12Buffer *output = none.run(input);
+    ASSERT_TRUE(!none.graph.plan->steps[1].striped, "Sobel without directions should not be striped");
+    ASSERT_TRUE(output->isEqual(*input), "Sobel without directions should pass the input");
+    delete_safe(output);
+    delete_safe(input);
+}
+
+void testSharedView()
+{
+    G12Buffer *buffer = new G12Buffer(10, 10);
+    buffer->element(5, 5) = 42;
+
+    G12Pin pin(NULL, Pin::OUTPUT_PIN, false);
+    pin.initPin(buffer);
+
+    G12Buffer *view = NULL;
+    pin.getPin(view, true);
+    ASSERT_TRUE(view != buffer, "Pin should give a separate object");
+    ASSERT_TRUE(view->data == buffer->data, "Pin should not copy data");
+    ASSERT_TRUE(buffer->isShared(), "Memory should be shared");
+
+    G12BufferPool pool;
+    pool.release(buffer);
+    pin.initPin(NULL);
+    ASSERT_TRUE(pool.size() == 0, "Shared buffer should not be pooled");
+    ASSERT_TRUE(view->element(5, 5) == 42, "View should survive the original buffer");
+    ASSERT_FALSE(view->isShared(), "View should be the only owner now");
+
+    delete_safe(view);
+}
+
+int main (int /*argC*/, char ** /*argV*/)
+{
+    testLevels();
+    testExecution(false);
+    testExecution(true);
+    testFusedPlan();
+    testStripedPlan();
+    testStripedSobel();
+    testSharedView();
+    cout << "PASSED" << endl;
+    return 0;
+}
@@ -0,0 +1,8 @@
+##################################################################
+# frame_latency.pro created on Oct 19, 2026
+# This is a file for QMAKE that allows to build the test frame_latency
+#
+##################################################################
+include(../testsCommon.pri)
+
+SOURCES += main_test_frame_latency.cpp
@@ -0,0 +1,140 @@
+/**
+ * \file main_test_frame_latency.cpp
+ * \brief This is the main file for the test frame_latency
+ *
+ * \date Oct 19, 2026
+ *
+ * \ingroup autotest
+ */
+
+#include <iostream>
+#include <sstream>
+
+#ifndef ASSERTS
+#define ASSERTS
+#endif
+
+#include "global.h"
+
+#include "frameLatencyStatistics.h"
+
+using namespace std;
+using namespace corecvs;
+
+static FrameLifecycle makeLifecycle(uint64_t start, uint64_t latency)
+{
+    FrameLifecycle lifecycle;
+    lifecycle.stamps[FrameLifecycle::DEQUEUE]           = start;
+    lifecycle.stamps[FrameLifecycle::DECODE_DONE]       = start + 100;
+    lifecycle.stamps[FrameLifecycle::CALCULATION_START] = start + 200;
+    lifecycle.stamps[FrameLifecycle::CALCULATION_END]   = start + latency - 100;
+    lifecycle.stamps[FrameLifecycle::OUTPUT_DELIVERED]  = start + latency;
+    return lifecycle;
+}
+
+void testHistogram()
+{
+    LatencyHistogram histogram(10, 100);
+    for (uint64_t i = 1; i <= 100; i++)
+        histogram.add(i * 5);
+    histogram.add(100000);
+
+    ASSERT_TRUE(histogram.count() == 101, "Wrong count");
+    ASSERT_TRUE(histogram.min() == 5, "Wrong minimum");
+    ASSERT_TRUE(histogram.max() == 100000, "Wrong maximum");
+    ASSERT_TRUE(histogram.percentile(0.5) == 260, "Median should be the upper bound of its bucket");
+    ASSERT_TRUE(histogram.percentile(1.0) == 100000, "Overflow bucket should be clamped by the maximum");
+    ASSERT_TRUE(histogram.buckets().back() == 1, "Large value should get to the overflow bucket");
+
+    histogram.reset();
+    ASSERT_TRUE(histogram.count() == 0 && histogram.min() == 0 && histogram.percentile(0.9) == 0, "Reset failed");
+}
+
+void testLifecycle()
+{
+    FrameLifecycle lifecycle = makeLifecycle(1000, 5000);
+    ASSERT_TRUE(lifecycle.latency() == 5000, "Without the sensor stamp latency starts at dequeue");
+
+    lifecycle.stamps[FrameLifecycle::SENSOR] = 500;
+    ASSERT_TRUE(lifecycle.latency() == 5500, "Latency should start at the sensor stamp");
+
+    FrameLifecycle empty;
+    ASSERT_TRUE(empty.latency() == -1, "Unknown latency should be negative");
+    ASSERT_TRUE(empty.interval(FrameLifecycle::DEQUEUE, FrameLifecycle::DECODE_DONE) == -1, "Unknown interval should be negative");
+}
+
+/* Stamp of the driver taken with the monotonic clock just before the frame is dequeued */
+void testMonotonicSensor()
+{
+    int64_t sensor;
+    if (!FrameLifecycle::monotonicTime(sensor))
+    {
+        cout << "No monotonic clock, skipping" << endl;
+        return;
+    }
+
+    int64_t offset = 0;
+    bool known = FrameLifecycle::monotonicOffset(offset);
+    ASSERT_TRUE(known, "Offset should be known with the monotonic clock");
+    FrameLifecycle lifecycle;
+    lifecycle.stamps[FrameLifecycle::SENSOR] = (uint64_t)(sensor + offset);
+    lifecycle.stamp(FrameLifecycle::DEQUEUE);
+
+    int64_t delta = lifecycle.interval(FrameLifecycle::SENSOR, FrameLifecycle::DEQUEUE);
+    printf("Sensor to dequeue %d us\n", (int)delta);
+    ASSERT_TRUE_P(delta >= 0 && delta < 100000, ("Sensor stamp should be just before the dequeue, not %d us away", (int)delta));
+}
+
+void testStatistics()
+{
+    FrameLatencyStatistics stats(10);
+    for (uint64_t i = 0; i < 20; i++)
+        stats.addFrame(makeLifecycle(1000 + i * 40000, 10000 + i * 1000));
+
+    stats.addDrop(FrameLatencyStatistics::DROP_CALCULATION_BUSY, 3);
+    stats.addDrop(FrameLatencyStatistics::DROP_QUEUE_FULL);
+    stats.addQueueDepth("Filter", 2);
+    stats.addQueueDepth("Filter", 1);
+
+    ASSERT_TRUE(stats.framesNumber() == 20, "Wrong number of frames");
+    ASSERT_TRUE(stats.droppedNumber() == 4, "Wrong number of dropped frames");
+    ASSERT_TRUE(stats.droppedNumber(FrameLatencyStatistics::DROP_QUEUE_FULL) == 1, "Wrong number of queue drops");
+    ASSERT_TRUE(stats.maxQueueDepth("Filter") == 2 && stats.lastQueueDepth("Filter") == 1, "Wrong queue depth");
+    ASSERT_TRUE(stats.maxQueueDepth("Unknown") == 0, "Unknown queue should be empty");
+
+    LatencyHistogram latency = stats.histogram(FrameLatencyStatistics::LATENCY);
+    ASSERT_TRUE(latency.count() == 20, "All the frames should get to the latency histogram");
+    ASSERT_TRUE(latency.min() == 10000 && latency.max() == 29000, "Wrong latency range");
+    ASSERT_TRUE(stats.histogram(FrameLatencyStatistics::DECODING).max() == 100, "Wrong decoding time");
+    ASSERT_TRUE(stats.histogram(FrameLatencyStatistics::CAPTURE_WAIT).count() == 0, "Capture wait is unknown without the sensor stamp");
+
+    ASSERT_TRUE(stats.latestFrames().size() == 10, "Only the latest frames should be kept");
+    ASSERT_TRUE(stats.latestFrames().front().stamps[FrameLifecycle::DEQUEUE] == 1000 + 10 * 40000, "Oldest frames should be forgotten");
+
+    stringstream summary;
+    stats.printSummaryCsv(summary);
+    ASSERT_TRUE(summary.str().find("interval,Latency,20,") != string::npos, "Summary should have the latency row");
+    ASSERT_TRUE(summary.str().find("drop,Calculation busy,3,") != string::npos, "Summary should have the drop rows");
+    ASSERT_TRUE(summary.str().find("queue,Filter,2,1.5,") != string::npos, "Summary should have the queue rows");
+
+    stringstream frames;
+    stats.printFramesCsv(frames);
+    int lines = 0;
+    for (string line; getline(frames, line); )
+        lines++;
+    ASSERT_TRUE(lines == 11, "Frames table should have a header and a row per kept frame");
+
+    stats.reset();
+    ASSERT_TRUE(stats.framesNumber() == 0 && stats.droppedNumber() == 0, "Reset failed");
+}
+
+int main (int /*argC*/, char ** /*argV*/)
+{
+    testHistogram();
+    testLifecycle();
+    testMonotonicSensor();
+    testStatistics();
+
+    cout << "PASSED" << endl;
+    return 0;
+}
@@ -0,0 +1,8 @@
+##################################################################
+# histogram_builder.pro created on Oct 19, 2026
+# This is a file for QMAKE that allows to build the test histogram_builder
+#
+##################################################################
+include(../testsCommon.pri)
+
+SOURCES += main_test_histogram_builder.cpp
@@ -0,0 +1,175 @@
+/**
+ * \file main_test_histogram_builder.cpp
+ * \brief This is the main file for the test histogram_builder
+ *
+ * \date Oct 19, 2026
+ *
+ * \ingroup autotest
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef ASSERTS
+#define ASSERTS
+#endif
+
+#include "global.h"
+
+#include "g8Buffer.h"
+#include "g12Buffer.h"
+#include "histogram.h"
+#include "histogramBuilder.h"
+
+using namespace std;
+using namespace corecvs;
+
+static G12Buffer *randomBuffer(int h, int w, int range)
+{
+    G12Buffer *buffer = new G12Buffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            buffer->element(i, j) = (uint16_t)(rand() % range);
+    return buffer;
+}
+
+void testCount()
+{
+    int h = 97, w = 131;
+    G12Buffer *buffer = randomBuffer(h, w, G12Buffer::BUFFER_MAX_VALUE + 1);
+    /* Flat area, the worst case for a single counter array */
+    for (int i = 10; i < 40; i++)
+        for (int j = 0; j < w; j++)
+            buffer->element(i, j) = 1000;
+
+    G8Buffer *mask = new G8Buffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            mask->element(i, j) = (rand() % 3 == 0) ? 0 : 1;
+
+    Histogram *full = HistogramBuilder::build(buffer);
+    ASSERT_TRUE(full->getTotalSum() == h * w, "Wrong total");
+    Histogram *constructed = new Histogram(buffer);
+    ASSERT_TRUE(constructed->data == full->data, "Histogram constructor should use the builder");
+
+    Rectangle<int32_t> roi(13, 5, 200, 60); /* Goes out of the buffer on the right */
+    Histogram *clamped = new Histogram(500, 3000);
+    HistogramBuilder::add(clamped, buffer, &roi, mask);
+
+    vector<unsigned> expectedFull(G12Buffer::BUFFER_MAX_VALUE + 1, 0);
+    vector<unsigned> expectedClamped(3000 - 500 + 1, 0);
+    int clampedTotal = 0;
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            int value = buffer->element(i, j);
+            expectedFull[value]++;
+            if (i >= 5 && i < 65 && j >= 13 && mask->element(i, j))
+            {
+                expectedClamped[CORE_MAX(500, CORE_MIN(3000, value)) - 500]++;
+                clampedTotal++;
+            }
+        }
+    }
+
+    ASSERT_TRUE(full->data == expectedFull, "Full histogram differs from the naive count");
+    ASSERT_TRUE(clamped->data == expectedClamped, "Masked histogram differs from the naive count");
+    ASSERT_TRUE(clamped->getTotalSum() == clampedTotal, "Wrong masked total");
+    ASSERT_TRUE(clamped->getUnderExpo() > 0 && clamped->getOverExpo() > 0, "Margins should be filled");
+
+    delete_safe(clamped);
+    delete_safe(constructed);
+    delete_safe(full);
+    delete_safe(mask);
+    delete_safe(buffer);
+}
+
+/* Values with the high bit set are clamped to the maximum on both the SSE and the scalar paths */
+void testHighValues()
+{
+    int h = 3, w = 37;
+    G12Buffer *buffer = new G12Buffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            buffer->element(i, j) = (j % 2) ? 0x9000 : 0xFFFF;
+
+    Histogram *histogram = new Histogram(0, G12Buffer::BUFFER_MAX_VALUE);
+    HistogramBuilder::add(histogram, buffer);
+    ASSERT_TRUE(histogram->data[G12Buffer::BUFFER_MAX_VALUE] == (unsigned)(h * w), "High values should go to the maximum bin");
+    ASSERT_TRUE(histogram->data[0] == 0, "High values should not go to the minimum bin");
+
+    delete_safe(histogram);
+    delete_safe(buffer);
+}
+
+void testJoint()
+{
+    int h = 64, w = 77;
+    G12Buffer *first  = randomBuffer(h, w, G12Buffer::BUFFER_MAX_VALUE + 1);
+    G12Buffer *second = new G12Buffer(h, w);
+    G12Buffer *noise  = randomBuffer(h, w, G12Buffer::BUFFER_MAX_VALUE + 1);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            second->element(i, j) = G12Buffer::BUFFER_MAX_VALUE - first->element(i, j);
+
+    JointHistogram joint(4, 5);
+    HistogramBuilder::addJoint(&joint, first, second);
+    ASSERT_TRUE(joint.totalSum == (uint64_t)(h * w), "Wrong joint total");
+
+    vector<unsigned> expected(joint.data.size(), 0);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            expected[(first->element(i, j) >> 4) * joint.binsB + (second->element(i, j) >> 5)]++;
+    ASSERT_TRUE(joint.data == expected, "Joint histogram differs from the naive count");
+
+    /* Dependent buffers share much more information than the independent ones */
+    JointHistogram independent(4, 5);
+    HistogramBuilder::addJoint(&independent, first, noise);
+    ASSERT_TRUE(joint.mutualInformation() > 2.0 * independent.mutualInformation(), "Mutual information is wrong");
+
+    delete_safe(noise);
+    delete_safe(second);
+    delete_safe(first);
+}
+
+void testLocalEqualize()
+{
+    int h = 45, w = 52, radius = 6;
+    G12Buffer *buffer = randomBuffer(h, w, 300);
+    G12Buffer *result = HistogramBuilder::localEqualize(buffer, radius);
+
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            int64_t less = 0, equal = 0, total = 0;
+            for (int y = CORE_MAX(i - radius, 0); y <= CORE_MIN(i + radius, h - 1); y++)
+            {
+                for (int x = CORE_MAX(j - radius, 0); x <= CORE_MIN(j + radius, w - 1); x++)
+                {
+                    if (buffer->element(y, x) <  buffer->element(i, j)) less++;
+                    if (buffer->element(y, x) == buffer->element(i, j)) equal++;
+                    total++;
+                }
+            }
+            int expected = (int)((2 * less + equal) * G12Buffer::BUFFER_MAX_VALUE / (2 * total));
+            ASSERT_TRUE_P(result->element(i, j) == expected, ("Wrong equalized value at %d %d", i, j));
+        }
+    }
+
+    delete_safe(result);
+    delete_safe(buffer);
+}
+
+int main (int /*argC*/, char ** /*argV*/)
+{
+    testCount();
+    testHighValues();
+    testJoint();
+    testLocalEqualize();
+
+    cout << "PASSED" << endl;
+    return 0;
+}
@@ -13,6 +13,8 @@
 #endif
 #include <iostream>
 #include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
 
 #include "global.h"
 
@@ -126,6 +128,157 @@ void testIntegralBlurLarge()
 
 }
 
+static G12Buffer *randomG12(int h, int w)
+{
+    G12Buffer *image = new G12Buffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            image->element(i, j) = rand() % 4096;
+    return image;
+}
+
+/* Plain sequential scan that is used as the reference */
+template<typename ElementType, typename BufferType>
+static ElementType referenceSum(BufferType *input, int y, int x)
+{
+    ElementType sum(0);
+    for (int i = 0; i < y; i++)
+        for (int j = 0; j < x; j++)
+            sum += input->element(i, j);
+    return sum;
+}
+
+void testIntegralBufferParallel()
+{
+    cout << "Testing the parallel Integral Buffer generation" << endl;
+
+    /* Several stripes and the width that is not a multiple of the SSE block */
+    G12Buffer *image = randomG12(203, 77);
+    G12IntegralBuffer integral(image);
+    G12IntegralBuffer64 integral64(image);
+    G12IntegralBufferDouble integralDouble(image);
+
+    for (int i = 0; i <= image->h; i++)
+    {
+        uint64_t rowSum = 0;
+        for (int j = 0; j <= image->w; j++)
+        {
+            if (i > 0 && j > 0)
+                rowSum += image->element(i - 1, j - 1);
+            uint64_t expected = (i > 0 ? integral64.element(i - 1, j) : 0) + rowSum;
+            if (i > 0 && j > 0)
+                ASSERT_TRUE(integral64.element(i, j) == expected, "Wrong 64 bit integral");
+            ASSERT_TRUE_P(integral.element(i, j) == (uint32_t)integral64.element(i, j),
+                          ("Wrong integral at %d %d", i, j));
+            ASSERT_TRUE(integralDouble.element(i, j) == (double)integral64.element(i, j), "Wrong double integral");
+        }
+    }
+    ASSERT_TRUE(integral64.element(image->h, image->w) == referenceSum<uint64_t>(image, image->h, image->w), "Wrong total sum");
+
+    /* Input that is a view with the stride wider than its width */
+    G12Buffer *view = image->createView<G12Buffer>(5, 3, 130, 61);
+    G12IntegralBuffer viewIntegral(view);
+    for (int i = 0; i < view->h; i += 7)
+        for (int j = 0; j < view->w; j += 5)
+            ASSERT_TRUE(viewIntegral.rectangle(j, i, view->w - 1, view->h - 1) ==
+                        integral.rectangle(j + 3, i + 5, 3 + view->w - 1, 5 + view->h - 1), "Wrong integral of the view");
+    delete view;
+
+    G8Buffer *image8 = new G8Buffer(70, 45);
+    for (int i = 0; i < image8->h; i++)
+        for (int j = 0; j < image8->w; j++)
+            image8->element(i, j) = rand() % 256;
+    G8IntegralBuffer integral8(image8);
+    for (int i = 0; i <= image8->h; i++)
+        for (int j = 0; j <= image8->w; j++)
+            ASSERT_TRUE(integral8.element(i, j) == referenceSum<uint32_t>(image8, i, j), "Wrong G8 integral");
+
+    delete image8;
+    delete image;
+}
+
+void testSquaredIntegralBuffer()
+{
+    cout << "Testing the Integral Buffer with squares" << endl;
+
+    G12Buffer *image = randomG12(150, 33);
+    G12SquaredIntegralBuffer integral(image);
+    G12IntegralBuffer plain(image);
+
+    ASSERT_TRUE(integral.isEqual(&plain), "Fused integral differs from the plain one");
+
+    for (int k = 0; k < 100; k++)
+    {
+        int x1 = rand() % image->w;
+        int y1 = rand() % image->h;
+        int x2 = x1 + rand() % (image->w - x1);
+        int y2 = y1 + rand() % (image->h - y1);
+
+        uint64_t squares = 0;
+        double sum = 0;
+        for (int i = y1; i <= y2; i++)
+        {
+            for (int j = x1; j <= x2; j++)
+            {
+                uint64_t value = image->element(i, j);
+                squares += value * value;
+                sum += value;
+            }
+        }
+        double area = (double)(x2 - x1 + 1) * (y2 - y1 + 1);
+        double variance = squares / area - (sum / area) * (sum / area);
+
+        ASSERT_TRUE(integral.squaresRectangle(x1, y1, x2, y2) == squares, "Wrong sum of squares");
+        ASSERT_TRUE(fabs(integral.variance(x1, y1, x2, y2) - variance) <= 1e-6 * (1.0 + variance), "Wrong variance");
+    }
+
+    delete image;
+}
+
+void testTiltedIntegralBuffer()
+{
+    cout << "Testing the tilted Integral Buffer" << endl;
+
+    G12Buffer *image = randomG12(23, 31);
+    G12TiltedIntegralBuffer tilted(image);
+
+    for (int y = 0; y <= image->h; y++)
+    {
+        for (int x = 0; x <= image->w; x++)
+        {
+            uint32_t expected = 0;
+            for (int i = 0; i < y; i++)
+                for (int j = 0; j < image->w; j++)
+                    if (abs(j - x + 1) <= y - 1 - i)
+                        expected += image->element(i, j);
+            ASSERT_TRUE_P(tilted.element(y, x) == expected, ("Wrong tilted integral at %d %d", y, x));
+        }
+    }
+
+    /* Rotated rectangle with the top corner at (7, 10), 5 pixels to the right and 3 to the left */
+    int x = 10, y = 7, w = 5, h = 3;
+    uint32_t expected = 0;
+    int area = 0;
+    for (int i = 0; i < image->h; i++)
+    {
+        for (int j = 0; j < image->w; j++)
+        {
+            /* Coordinates along the sides of the rectangle */
+            int a = (i - y) + (j - x);
+            int b = (i - y) - (j - x);
+            if (a >= 0 && a < 2 * w && b >= 0 && b < 2 * h)
+            {
+                expected += image->element(i, j);
+                area++;
+            }
+        }
+    }
+    ASSERT_TRUE(area == 2 * w * h, "Wrong reference area");
+    ASSERT_TRUE(tilted.tiltedRectangle(x, y, w, h) == expected, "Wrong tilted rectangle");
+
+    delete image;
+}
+
 #ifdef WITH_SSE
 ALIGN_STACK_SSE
 void testIntergralBufferSSE (void)
@@ -248,6 +401,10 @@ int main (int /*a*/, char * /*b*/[])
     testBlurBufferSSE();
 #endif
 
+    testIntegralBufferParallel();
+    testSquaredIntegralBuffer();
+    testTiltedIntegralBuffer();
+
     testIntegralBlurLarge();
     testIntergralBufferBlur();
     testIntergralBufferGeneration ();
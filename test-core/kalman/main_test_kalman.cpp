@@ -10,6 +10,9 @@
 
 #include "matrix.h"
 #include "classicKalman.h"
+#include "fixedKalman.h"
+#include "kalmanBank.h"
+#include "preciseTimer.h"
 
 using namespace corecvs;
 
@@ -161,7 +164,301 @@ void testClassicKalman (void)
 
 }
 
+static bool isClose(double a, double b, double tolerance)
+{
+    return fabs(a - b) <= tolerance * (1.0 + fabs(a) + fabs(b));
+}
+
+template<class MatrixType>
+static bool isCloseMatrix(const MatrixType &a, const MatrixType &b, double tolerance)
+{
+    for (int i = 0; i < a.size(); i++)
+        if (!isClose(a[i], b[i], tolerance))
+            return false;
+    return true;
+}
+
+/* Constant velocity in the plane, the state is x vx y vy, the position is measured */
+template<class FilterType>
+static void setupConstantVelocity(FilterType &filter, double dt)
+{
+    filter.F = FixedMatrix<4, 4>::Diagonal(1.0);
+    filter.F.a(0, 1) = dt;
+    filter.F.a(2, 3) = dt;
+    filter.H = FixedMatrix<2, 4>::Zero();
+    filter.H.a(0, 0) = 1.0;
+    filter.H.a(1, 2) = 1.0;
+}
+
+static FixedMatrix<4, 4> constantVelocityNoise(double dt, double acceleration)
+{
+    /* Q = G G^T a^2 with G = (dt^2/2, dt) for each axis */
+    FixedMatrix<4, 4> Q = FixedMatrix<4, 4>::Zero();
+    double g0 = dt * dt / 2.0, g1 = dt, a2 = acceleration * acceleration;
+    for (int axis = 0; axis < 4; axis += 2)
+    {
+        Q.a(axis    , axis    ) = g0 * g0 * a2;
+        Q.a(axis    , axis + 1) = g0 * g1 * a2;
+        Q.a(axis + 1, axis    ) = g0 * g1 * a2;
+        Q.a(axis + 1, axis + 1) = g1 * g1 * a2;
+    }
+    return Q;
+}
+
+void testFixedKalman (void)
+{
+    TestF F;
+    TestH H;
+
+    Matrix P(2, 2, 0.0);
+    Matrix Q(2, 2);
+    Q.fillWithArgs(
+            0.25, 0.5,
+            0.5 , 1.0);
+    Q *= 0.25;
+    Matrix R(1, 1, 10.0);
+    Vector x(2);
+    x[0] = 0.0;
+    x[1] = 0.0;
+    ClassicKalman classic(&F, &H, Q, R, P, x);
+
+    FixedKalman<2, 1> fixed;
+    fixed.F.a(0, 1) = TestF::TIME_QUANT;
+    fixed.H.a(0, 1) = 0.0;
+    fixed.Q = FixedMatrix<2, 2>::FromMatrix(Q);
+    fixed.R = FixedMatrix<1, 1>::FromMatrix(R);
+    fixed.P = FixedMatrix<2, 2>::Zero();
+
+    for (int step = 0; step < 25; step++)
+    {
+        double measurement = (step + 1) * 0.2;
+        classic.predict();
+        classic.z[0] = measurement;
+        classic.update();
+
+        fixed.predict();
+        bool updated = fixed.update(FixedVector<double, 1>(measurement));
+        ASSERT_TRUE(updated, "Fixed Kalman update failed");
+        for (int i = 0; i < 2; i++)
+        {
+            ASSERT_TRUE(isClose(classic.x[i], fixed.x[i], 1e-6), "Fixed Kalman state differs from the classic one");
+            for (int j = 0; j < 2; j++)
+                ASSERT_TRUE(isClose(classic.P.a(i, j), fixed.P.a(i, j), 1e-6), "Fixed Kalman covariance differs from the classic one");
+        }
+    }
+    printf("Fixed Kalman: x=%lg v=%lg\n", fixed.x[0], fixed.x[1]);
+}
+
+void testUDUKalman (void)
+{
+    FixedKalman<4, 2>    reference;
+    FixedUDUKalman<4, 2> udu;
+    setupConstantVelocity(reference, 0.5);
+    setupConstantVelocity(udu, 0.5);
+
+    FixedMatrix<4, 4> Q = constantVelocityNoise(0.5, 0.3);
+    reference.Q = Q;
+    udu.setProcessNoise(Q);
+
+    reference.R = FixedMatrix<2, 2>::Diagonal(0.04);
+    udu.R = FixedVector<double, 2>(0.04);
+
+    FixedMatrix<4, 4> P = FixedMatrix<4, 4>::Diagonal(100.0);
+    P.a(0, 1) = P.a(1, 0) = 5.0;
+    reference.P = P;
+    udu.setCovariance(P);
+    ASSERT_TRUE(isCloseMatrix(udu.covariance(), P, 1e-12), "UDU factorization differs");
+
+    for (int step = 0; step < 60; step++)
+    {
+        reference.predict();
+        udu.predict();
+        ASSERT_TRUE(isCloseMatrix(udu.covariance(), reference.P, 1e-9), "UDU time update differs");
+
+        double t = step * 0.5;
+        FixedVector<double, 2> z;
+        z[0] = 1.0 + 2.0 * t + 0.1 * sin(t * 7.0);
+        z[1] = -3.0 + 0.5 * t + 0.1 * cos(t * 5.0);
+        bool updated = reference.update(z);
+        ASSERT_TRUE(updated, "Kalman update failed");
+        updated = udu.update(z);
+        ASSERT_TRUE(updated, "UDU Kalman update failed");
+        ASSERT_TRUE(isCloseMatrix(udu.x, reference.x, 1e-9), "UDU state differs");
+        ASSERT_TRUE(isCloseMatrix(udu.covariance(), reference.P, 1e-9), "UDU measurement update differs");
+    }
+    printf("UDU Kalman: x=%lg vx=%lg y=%lg vy=%lg\n", udu.x[0], udu.x[1], udu.x[2], udu.x[3]);
+    ASSERT_TRUE(isClose(udu.x[1], 2.0, 0.05) && isClose(udu.x[3], 0.5, 0.05), "UDU Kalman should track the speed");
+}
+
+void testKalmanBank (void)
+{
+    const int count = 101;
+    const int steps = 40;
+    KalmanBank<4, 2>         bank;
+    vector<FixedKalman<4, 2> > filters(count);
+
+    setupConstantVelocity(bank, 1.0);
+    bank.Q = constantVelocityNoise(1.0, 0.2);
+    bank.R = FixedMatrix<2, 2>::Diagonal(0.25);
+    bank.R.a(0, 1) = bank.R.a(1, 0) = 0.05;
+
+    for (int k = 0; k < count; k++)
+    {
+        FixedKalman<4, 2> &filter = filters[k];
+        setupConstantVelocity(filter, 1.0);
+        filter.Q = bank.Q;
+        filter.R = bank.R;
+        filter.x[0] = k;
+        filter.x[2] = -k;
+        filter.P = FixedMatrix<4, 4>::Diagonal(10.0 + k);
+        int index = bank.add(filter.x, filter.P);
+        ASSERT_TRUE(index == k, "Bank indices should be dense");
+    }
+
+    vector<FixedVector<double, 2> > z(count);
+    vector<uint8_t> valid(count);
+    for (int step = 0; step < steps; step++)
+    {
+        if (step == steps / 2)
+        {
+            /* The last filter takes the place of the removed one */
+            bank.remove(7);
+            filters[7] = filters.back();
+            filters.pop_back();
+        }
+        int active = bank.size();
+        for (int k = 0; k < active; k++)
+        {
+            z[k][0] = filters[k].x[0] + 0.3 * sin(step + k);
+            z[k][1] = filters[k].x[2] + 0.5 * cos(step * 2.0 + k);
+            valid[k] = (step + k) % 5 != 0;
+        }
+
+        bank.predict();
+        bool updated = bank.update(&z[0], &valid[0]);
+        ASSERT_TRUE(updated, "Bank update failed");
+        for (int k = 0; k < active; k++)
+        {
+            filters[k].predict();
+            if (valid[k])
+            {
+                updated = filters[k].update(z[k]);
+                ASSERT_TRUE(updated, "Kalman update failed");
+            }
+        }
+    }
+
+    ASSERT_TRUE(bank.size() == count - 1, "Wrong bank size");
+    for (int k = 0; k < bank.size(); k++)
+    {
+        ASSERT_TRUE(isCloseMatrix(bank.state(k), filters[k].x, 1e-9), "Bank state differs");
+        ASSERT_TRUE(isCloseMatrix(bank.covariance(k), filters[k].P, 1e-9), "Bank covariance differs");
+    }
+
+    /* Timing of the bank against the separate filters */
+    vector<FixedVector<double, 2> > zeros(bank.size(), FixedVector<double, 2>(0.0));
+    PreciseTimer timer = PreciseTimer::currentTime();
+    for (int step = 0; step < 1000; step++)
+    {
+        bank.predict();
+        bank.update(&zeros[0]);
+    }
+    uint64_t bankTime = timer.usecsToNow();
+    timer = PreciseTimer::currentTime();
+    for (int step = 0; step < 1000; step++)
+    {
+        for (size_t k = 0; k < filters.size(); k++)
+        {
+            filters[k].predict();
+            filters[k].update(zeros[k]);
+        }
+    }
+    uint64_t separateTime = timer.usecsToNow();
+    printf("Kalman bank of %d filters, 1000 frames: bank %d us, separate %d us\n", bank.size(), (int)bankTime, (int)separateTime);
+}
+
+void testUDUKalmanBank (void)
+{
+    const int count = 37;
+    const int steps = 50;
+    UDUKalmanBank<4, 2>          bank;
+    vector<FixedUDUKalman<4, 2> > filters(count);
+
+    setupConstantVelocity(bank, 0.5);
+    FixedMatrix<4, 4> Q = constantVelocityNoise(0.5, 0.3);
+    bank.setProcessNoise(Q);
+    bank.R = FixedVector<double, 2>(0.04);
+
+    for (int k = 0; k < count; k++)
+    {
+        FixedUDUKalman<4, 2> &filter = filters[k];
+        setupConstantVelocity(filter, 0.5);
+        filter.setProcessNoise(Q);
+        filter.R = bank.R;
+        filter.x[0] = k;
+        filter.x[2] = -k;
+        FixedMatrix<4, 4> P = FixedMatrix<4, 4>::Diagonal(100.0 + k);
+        P.a(0, 1) = P.a(1, 0) = 5.0;
+        filter.setCovariance(P);
+        int index = bank.add(filter.x, P);
+        ASSERT_TRUE(index == k, "Bank indices should be dense");
+    }
+
+    vector<FixedVector<double, 2> > z(count);
+    vector<uint8_t> valid(count);
+    for (int step = 0; step < steps; step++)
+    {
+        if (step == steps / 2)
+        {
+            bank.remove(3);
+            filters[3] = filters.back();
+            filters.pop_back();
+        }
+        int active = bank.size();
+        double t = step * 0.5;
+        for (int k = 0; k < active; k++)
+        {
+            z[k][0] = k + 2.0 * t + 0.1 * sin(t * 7.0 + k);
+            z[k][1] = -k + 0.5 * t + 0.1 * cos(t * 5.0 + k);
+            valid[k] = (step + k) % 4 != 0;
+        }
+
+        bank.predict();
+        bool updated = bank.update(&z[0], &valid[0]);
+        ASSERT_TRUE(updated, "UDU bank update failed");
+        for (int k = 0; k < active; k++)
+        {
+            filters[k].predict();
+            if (valid[k])
+            {
+                updated = filters[k].update(z[k]);
+                ASSERT_TRUE(updated, "UDU Kalman update failed");
+            }
+        }
+    }
+
+    ASSERT_TRUE(bank.size() == count - 1, "Wrong bank size");
+    for (int k = 0; k < bank.size(); k++)
+    {
+        FixedMatrix<4, 4> U;
+        FixedVector<double, 4> D;
+        bank.factors(k, U, D);
+        ASSERT_TRUE(isCloseMatrix(bank.state(k), filters[k].x, 1e-9), "UDU bank state differs");
+        ASSERT_TRUE(isCloseMatrix(U, filters[k].U, 1e-9) && isCloseMatrix(D, filters[k].D, 1e-9), "UDU bank factors differ");
+    }
+
+    FixedVector<double, 2> wrongNoise(0.0);
+    bank.R = wrongNoise;
+    bool updated = bank.update(&z[0]);
+    ASSERT_TRUE(!updated, "Zero measurement variance should be rejected");
+}
+
 int main (int /*argC*/, char ** /*argV[]*/)
 {
     testClassicKalman ();
+    testFixedKalman ();
+    testUDUKalman ();
+    testKalmanBank ();
+    testUDUKalmanBank ();
+    printf("PASSED\n");
 }
@@ -18,13 +18,159 @@
 #define TRACE
 #endif
 
+/* Detailed debug is removed at compile time */
+#define CORE_LOG_MIN_LEVEL 1
+
 #include "global.h"
 
 #include "log.h"
+#include "asyncLog.h"
+#include "tbbWrapper.h"
 
 
 using namespace std;
 
+/* Keeps the texts, it is called either by the drain thread or by the logging one */
+class CaptureLogDrain : public LogDrain
+{
+public:
+    vector<string> texts;
+    vector<int>    lines;
+
+    virtual void drain(Log::Message &message)
+    {
+        texts.push_back(message.get()->s.str());
+        lines.push_back(message.get()->mOriginLineNumber);
+    }
+};
+
+static int sideEffects = 0;
+
+static int sideEffect()
+{
+    return ++sideEffects;
+}
+
+void testAsyncFormat(CaptureLogDrain &capture)
+{
+    capture.texts.clear();
+    string name("name");
+    int64_t big = 12345678901LL;
+    LA_INFO("value %d %s %.2f %x|%5s|%-4d|", 42, "str", 3.14159, 255u, "ab", 7);
+    LA_WARNING("%s %lld %lu %c %% %5.1e", name, big, (unsigned long)3, 'z', 100.0);
+    LA_ERROR("Missing %d and %s", 1);
+    LA_ERROR("Converted %d %.1f", 2.75, 3);
+    LA_INFO("No arguments");
+
+    ASSERT_TRUE(capture.texts.size() == 5, "Records should be drained at once without the thread");
+    ASSERT_TRUE(capture.texts[0] == "value 42 str 3.14 ff|   ab|7   |", "Wrong formatting");
+    ASSERT_TRUE(capture.texts[1] == "name 12345678901 3 z % 1.0e+02", "Wrong formatting");
+    ASSERT_TRUE(capture.texts[2] == "Missing 1 and <?>", "Missing argument should be marked");
+    ASSERT_TRUE(capture.texts[3] == "Converted 2 3.0", "Arguments should be converted");
+    ASSERT_TRUE(capture.texts[4] == "No arguments", "Wrong formatting");
+
+    /* Long strings are truncated to the record */
+    string longString(1000, 'a');
+    LA_INFO("%s", longString);
+    ASSERT_TRUE(capture.texts[5].size() < 250, "Record should be fixed size");
+    ASSERT_TRUE(capture.texts[5].substr(capture.texts[5].size() - 3) == "...", "Truncation should be marked");
+
+    /* Removed at compile time, the arguments are not evaluated */
+    LA_DDEBUG("%d", sideEffect());
+    L_DDEBUG << sideEffect();
+    ASSERT_TRUE(sideEffects == 0, "Disabled levels should be compiled out");
+    LA_DEBUG("%d", sideEffect());
+    ASSERT_TRUE(sideEffects == 1, "Enabled level should be evaluated");
+}
+
+void testAsyncRateLimit(CaptureLogDrain &capture)
+{
+    capture.texts.clear();
+    AsyncLog::resetStatistics();
+    AsyncLogSite site = { Log::LEVEL_INFO, __FILE__, __LINE__, __FUNCTION__, 10, 0, 0, 0 };
+    for (int i = 0; i < 100; i++)
+        AsyncLog::write(&site, "limited %d", i);
+    ASSERT_TRUE(capture.texts.size() == 10, "Rate limiter should pass 10 records");
+    ASSERT_TRUE(AsyncLog::statistics().suppressed == 90, "Suppressed records should be counted");
+
+    /* Next window reports the suppressed ones */
+    site.windowStart = 1;
+    AsyncLog::write(&site, "limited %d", 100);
+    ASSERT_TRUE(capture.texts.back() == "limited 100 (90 similar messages suppressed)", "Suppressed count should be reported");
+}
+
+class ParallelAsyncWriter
+{
+public:
+    void operator()( const corecvs::BlockedRange<int>& r ) const
+    {
+        for (int i = r.begin(); i < r.end(); i++)
+            LA_INFO("record %d of %s", i, "writer");
+    }
+};
+
+void testAsyncPipeline(CaptureLogDrain &capture)
+{
+    capture.texts.clear();
+    capture.lines.clear();
+    AsyncLog::resetStatistics();
+    ASSERT_TRUE(AsyncLog::start(256), "Drain thread should start");
+    ASSERT_TRUE(AsyncLog::isRunning(), "Pipeline should run");
+
+    const int total = 20000;
+    corecvs::parallelable_for(0, total, 100, ParallelAsyncWriter());
+    L_INFO << "Stream message " << 5;
+    AsyncLog::flush();
+
+    AsyncLog::Statistics statistics = AsyncLog::statistics();
+    printf("Queued %d, dropped %d\n", (int)statistics.queued, (int)statistics.dropped);
+    ASSERT_TRUE(statistics.queued + statistics.dropped == total + 1, "Every record should be queued or dropped");
+    ASSERT_TRUE(statistics.drained == statistics.queued, "Flush should drain all the records");
+    ASSERT_TRUE(statistics.synchronous == 0, "Nothing should be drained on the calling threads");
+    ASSERT_TRUE(capture.texts.size() == statistics.drained, "Drains should get all the records");
+    for (size_t i = 0; i < capture.texts.size(); i++)
+    {
+        ASSERT_TRUE(capture.texts[i].find("record ") == 0 || capture.texts[i] == "Stream message 5", "Wrong record text");
+    }
+
+    AsyncLog::stop();
+    ASSERT_TRUE(!AsyncLog::isRunning(), "Pipeline should stop");
+
+    /* Restart reuses the queue */
+    capture.texts.clear();
+    ASSERT_TRUE(AsyncLog::start(), "Drain thread should restart");
+    LA_ERROR("after restart %d", 1);
+    AsyncLog::stop();
+    ASSERT_TRUE(capture.texts.size() == 1 && capture.texts[0] == "after restart 1", "Stop should drain the queue");
+
+    /* Message longer than the record is drained whole, after the queued ones */
+    capture.texts.clear();
+    AsyncLog::resetStatistics();
+    ASSERT_TRUE(AsyncLog::start(), "Drain thread should restart");
+    string longText(500, 'b');
+    LA_INFO("before long %d", 1);
+    L_INFO << longText;
+    AsyncLog::stop();
+    ASSERT_TRUE(capture.texts.size() == 2, "Both messages should be drained");
+    ASSERT_TRUE(capture.texts[0] == "before long 1", "Queued record should come first");
+    ASSERT_TRUE(capture.texts[1] == longText, "Long message should not be truncated");
+    ASSERT_TRUE(AsyncLog::statistics().synchronous == 1, "Long message should be drained on the calling thread");
+}
+
+void testAsyncLog()
+{
+    vector<LogDrain *> drains = Log::mLogDrains;
+    CaptureLogDrain capture;
+    Log::mLogDrains.clear();
+    Log::mLogDrains.push_back(&capture);
+
+    testAsyncFormat(capture);
+    testAsyncRateLimit(capture);
+    testAsyncPipeline(capture);
+
+    Log::mLogDrains = drains;
+}
+
 int main (int /*argC*/, char ** /*argV*/)
 {
  //   L_ERROR("Test with place");
@@ -36,6 +182,8 @@ int main (int /*argC*/, char ** /*argV*/)
 
     cout << Log::formatted("Here we go %d\n", 1, 2, "three");
 
+    testAsyncLog();
+
     cout << "PASSED" << endl;
     return 0;
 }
@@ -0,0 +1,157 @@
+/**
+ * \file main_test_meanshift.cpp
+ * \brief This is the main file for the test meanshift
+ *
+ * \date Oct 19, 2026
+ *
+ * \ingroup autotest
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef ASSERTS
+#define ASSERTS
+#endif
+
+#include "global.h"
+
+#include "g12Buffer.h"
+#include "histogram.h"
+#include "meanShiftEngine.h"
+
+using namespace std;
+using namespace corecvs;
+
+/* Gaussian blobs of the value 3000 over the noise below 500 */
+static G12Buffer *blobs(int h, int w, const int *centers, int count)
+{
+    G12Buffer *image = new G12Buffer(h, w);
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            double value = rand() % 500;
+            for (int k = 0; k < count; k++)
+            {
+                double dx = j - centers[2 * k];
+                double dy = i - centers[2 * k + 1];
+                value += 3000 * exp(-(dx * dx + dy * dy) / 200.0);
+            }
+            image->element(i, j) = (uint16_t)CORE_MIN(value, (double)G12Buffer::BUFFER_MAX_VALUE);
+        }
+    }
+    return image;
+}
+
+void testMoments()
+{
+    int h = 61;
+    int w = 97;
+    G12Buffer *image = new G12Buffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            image->element(i, j) = rand() % (G12Buffer::BUFFER_MAX_VALUE + 1);
+
+    MeanShiftEngine engine;
+    engine.backProject(image);
+    ASSERT_TRUE(engine.weights()->isEqual(*image), "Without the histogram the weight should be the value");
+
+    for (int test = 0; test < 200; test++)
+    {
+        int x1 = rand() % (w + 20) - 10;
+        int y1 = rand() % (h + 20) - 10;
+        int x2 = x1 + rand() % 40;
+        int y2 = y1 + rand() % 40;
+
+        uint64_t m00, m10, m01;
+        engine.moments(x1, y1, x2, y2, m00, m10, m01);
+
+        uint64_t b00 = 0, b10 = 0, b01 = 0;
+        for (int i = CORE_MAX(y1, 0); i < CORE_MIN(y2, h); i++)
+        {
+            for (int j = CORE_MAX(x1, 0); j < CORE_MIN(x2, w); j++)
+            {
+                b00 += image->element(i, j);
+                b10 += (uint64_t)j * image->element(i, j);
+                b01 += (uint64_t)i * image->element(i, j);
+            }
+        }
+        ASSERT_TRUE_P(m00 == b00 && m10 == b10 && m01 == b01, ("Wrong moments of %d %d %d %d", x1, y1, x2, y2));
+    }
+    delete image;
+}
+
+void testBackProject()
+{
+    G12Buffer *image = new G12Buffer(4, 4);
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            image->element(i, j) = (i < 2) ? 100 : 3000;
+
+    /* The target is the bright values only */
+    Histogram target(0, G12Buffer::BUFFER_MAX_VALUE);
+    target.data[3000] = 10;
+    target.data[3010] = 5;
+
+    MeanShiftEngine engine;
+    engine.setHistogram(target, 6);
+    engine.backProject(image);
+    const G12Buffer *weights = engine.weights();
+    ASSERT_TRUE(weights->element(0, 0) == 0, "Values outside the target should have zero weight");
+    ASSERT_TRUE(weights->element(3, 3) == MeanShiftEngine::WEIGHT_MAX, "The largest bin should have the maximal weight");
+    delete image;
+}
+
+void testConvergence()
+{
+    int h = 240;
+    int w = 320;
+    const int centers[] = {70, 60, 240, 170};
+    G12Buffer *image = blobs(h, w, centers, 2);
+
+    /* Only the bright part counts */
+    Histogram target(0, G12Buffer::BUFFER_MAX_VALUE);
+    for (int value = 1000; value <= G12Buffer::BUFFER_MAX_VALUE; value++)
+        target.data[value] = 1;
+
+    MeanShiftEngine engine;
+    engine.setHistogram(target);
+    engine.backProject(image);
+    engine.run(MeanShiftEngine::grid(h, w, 4, 20), 30);
+
+    vector<MeanShiftResult> results = engine.results();
+    ASSERT_TRUE(results.size() == 16, "Grid should have 4 x 4 windows");
+
+    vector<MeanShiftMode> modes = engine.modes(10.0);
+    ASSERT_TRUE_P(modes.size() == 2, ("Two blobs should give two modes, not %d", (int)modes.size()));
+    for (size_t m = 0; m < modes.size(); m++)
+    {
+        double best = 1e10;
+        for (int k = 0; k < 2; k++)
+            best = CORE_MIN(best, (modes[m].center - Vector2dd(centers[2 * k], centers[2 * k + 1])).l2Metric());
+        ASSERT_TRUE_P(best < 2.0, ("Mode %d is %lf away from the blob", (int)m, best));
+        ASSERT_TRUE(results[modes[m].strongest].weight == modes[m].weight, "Mode should keep the strongest window");
+    }
+    ASSERT_TRUE(modes[0].weight >= modes[1].weight, "Modes should be sorted by the weight");
+
+    int merged = modes[0].windows + modes[1].windows;
+    int converged = 0;
+    for (size_t k = 0; k < results.size(); k++)
+        if (results[k].converged)
+            converged++;
+    ASSERT_TRUE(merged == converged, "Every converged window should be in some mode");
+
+    delete image;
+}
+
+int main (int /*argC*/, char ** /*argV*/)
+{
+    testMoments();
+    testBackProject();
+    testConvergence();
+
+    cout << "PASSED" << endl;
+    return 0;
+}
@@ -0,0 +1,8 @@
+##################################################################
+# meanshift.pro created on Oct 19, 2026
+# This is a file for QMAKE that allows to build the test meanshift
+#
+##################################################################
+include(../testsCommon.pri)
+
+SOURCES += main_test_meanshift.cpp
@@ -10,6 +10,8 @@
 #include <stdio.h>
 #include <string>
 #include <cstdio>
+#include <math.h>
+#include <stdlib.h>
 
 #include "global.h"
 
@@ -21,8 +23,106 @@
 
 using namespace corecvs;
 
+static G12Buffer *randomG12(int h, int w)
+{
+    G12Buffer *image = new G12Buffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            image->element(i, j) = rand() % 4096;
+    return image;
+}
+
+/* Direct 5x5 binomial kernel with the mirrored borders */
+static uint16_t referenceReduce(G12Buffer *input, int i, int j)
+{
+    static const int kernel[5] = {1, 4, 6, 4, 1};
+    uint32_t sum = 0;
+    for (int dy = 0; dy < 5; dy++)
+    {
+        for (int dx = 0; dx < 5; dx++)
+        {
+            int y = pyramidMirror(2 * i + dy - 2, input->h);
+            int x = pyramidMirror(2 * j + dx - 2, input->w);
+            sum += kernel[dy] * kernel[dx] * input->element(y, x);
+        }
+    }
+    return (sum + 128) >> 8;
+}
+
+static void checkLevels(GaussianPyramid<G12Buffer> &pyramid, G12Buffer *input)
+{
+    ASSERT_TRUE(pyramid.levels[0]->isEqual(*input), "Level 0 should be the copy of the input");
+    for (int l = 1; l < pyramid.levelNumber(); l++)
+    {
+        G12Buffer *previous = pyramid.levels[l - 1];
+        G12Buffer *level    = pyramid.levels[l];
+        ASSERT_TRUE(level->h == previous->h / 2 && level->w == previous->w / 2, "Wrong level size");
+        for (int i = 0; i < level->h; i++)
+            for (int j = 0; j < level->w; j++)
+                ASSERT_TRUE_P(level->element(i, j) == referenceReduce(previous, i, j),
+                              ("Wrong reduce at level %d, %d %d", l, i, j));
+    }
+}
+
+void testGaussianPyramid()
+{
+    printf("Testing the Gaussian pyramid\n");
+
+    G12Buffer *first = randomG12(97, 130);
+    GaussianPyramid<G12Buffer> pyramid(first, 4);
+    checkLevels(pyramid, first);
+
+    /* The next frame of the same size reuses the level buffers */
+    vector<G12Buffer *> storage = pyramid.levels;
+    G12Buffer *second = randomG12(97, 130);
+    pyramid.build(second);
+    ASSERT_TRUE(pyramid.levels == storage, "Levels should be reused");
+    checkLevels(pyramid, second);
+
+    G12Buffer *other = randomG12(40, 21);
+    pyramid.build(other);
+    checkLevels(pyramid, other);
+
+    /* Fractional factor keeps the constant exactly and the ramp approximately */
+    G12Buffer *ramp = new G12Buffer(90, 120);
+    for (int i = 0; i < ramp->h; i++)
+        for (int j = 0; j < ramp->w; j++)
+            ramp->element(i, j) = 1000 + 10 * j + 3 * i;
+    GaussianPyramid<G12Buffer> fractional(ramp, 3, 1.5);
+    ASSERT_TRUE(fractional.levels[1]->h == 60 && fractional.levels[1]->w == 80, "Wrong fractional level size");
+    G12Buffer *level = fractional.levels[1];
+    for (int i = 2; i < level->h - 2; i++)
+    {
+        for (int j = 2; j < level->w - 2; j++)
+        {
+            double expected = 1000 + 10 * ((j + 0.5) * 1.5 - 0.5) + 3 * ((i + 0.5) * 1.5 - 0.5);
+            ASSERT_TRUE_P(fabs(level->element(i, j) - expected) <= 1.0,
+                          ("Wrong resampled value at %d %d: %d instead of %lf", i, j, level->element(i, j), expected));
+        }
+    }
+
+    G12Buffer *constant = new G12Buffer(50, 50);
+    constant->fillWith(1234);
+    GaussianPyramid<G12Buffer> constantPyramid(constant, 3, 1.3);
+    for (int l = 0; l < constantPyramid.levelNumber(); l++)
+    {
+        G12Buffer *c = constantPyramid.levels[l];
+        for (int i = 0; i < c->h; i++)
+            for (int j = 0; j < c->w; j++)
+                ASSERT_TRUE(c->element(i, j) == 1234, "Constant should stay constant");
+    }
+
+    delete constant;
+    delete ramp;
+    delete other;
+    delete second;
+    delete first;
+}
+
 int main ( int /*argC*/, char * /*argV*/[])
 {
+    testGaussianPyramid();
+
     G12Buffer *buffer = BufferFactory::getInstance()->loadG12Bitmap("data/pair/image0001_c0.pgm");
 
     int numLevels = 8;
@@ -14,6 +14,7 @@
 #include "g12Buffer.h"
 #include "bmpLoader.h"
 #include "morphological.h"
+#include "rectMorphology.h"
 
 using namespace std;
 using namespace corecvs;
@@ -94,11 +95,104 @@ void testErodeDilate8 (void)
     delete element;
 }
 
+/* Brute force window min/max, the pixels outside of the buffer are skipped */
+template<typename BufferType>
+static BufferType *bruteForce(BufferType *input, int h, int w, int centerY, int centerX, bool isMin)
+{
+    BufferType *result = new BufferType(input->h, input->w);
+    for (int i = 0; i < input->h; i++)
+    {
+        for (int j = 0; j < input->w; j++)
+        {
+            int value = isMin ? 0xFFFF : 0;
+            for (int dy = 0; dy < h; dy++)
+            {
+                for (int dx = 0; dx < w; dx++)
+                {
+                    int y = i - centerY + dy;
+                    int x = j - centerX + dx;
+                    if (!input->isValidCoord(y, x))
+                        continue;
+                    value = isMin ? CORE_MIN(value, (int)input->element(y, x)) : CORE_MAX(value, (int)input->element(y, x));
+                }
+            }
+            result->element(i, j) = value;
+        }
+    }
+    return result;
+}
+
+template<typename BufferType>
+static void testRectMorphology(int maxValue)
+{
+    BufferType *input = new BufferType(45, 300);
+    for (int i = 0; i < input->h; i++)
+        for (int j = 0; j < input->w; j++)
+            input->element(i, j) = (rand() % 4 == 0) ? maxValue : rand() % (maxValue + 1);
+
+    BufferType *output = new BufferType(input->h, input->w);
+    RectMorphology<BufferType> engine;
+
+    /* Rectangles, lines and off center anchors */
+    int sizes[][4] = {
+        {15, 15,  7, 7},
+        { 1,  7,  0, 3},
+        { 9,  1,  4, 0},
+        { 4,  6,  0, 5},
+        { 1,  1,  0, 0},
+        {50,  3, 10, 1}
+    };
+
+    for (unsigned t = 0; t < CORE_COUNT_OF(sizes); t++)
+    {
+        int h = sizes[t][0], w = sizes[t][1], cy = sizes[t][2], cx = sizes[t][3];
+
+        engine.erode(input, output, h, w, cx, cy);
+        BufferType *expected = bruteForce(input, h, w, cy, cx, true);
+        ASSERT_TRUE_P(output->isEqual(*expected), ("Wrong erosion with %dx%d element", h, w));
+        delete expected;
+
+        engine.dilate(input, output, h, w, cx, cy);
+        expected = bruteForce(input, h, w, h - 1 - cy, w - 1 - cx, false);
+        ASSERT_TRUE_P(output->isEqual(*expected), ("Wrong dilation with %dx%d element", h, w));
+        delete expected;
+    }
+
+    /* Composites against the sequence of the brute force passes */
+    BufferType *eroded  = bruteForce(input , 15, 15, 7, 7, true );
+    BufferType *opened  = bruteForce(eroded, 15, 15, 7, 7, false);
+    BufferType *dilated = bruteForce(input , 15, 15, 7, 7, false);
+    BufferType *closed  = bruteForce(dilated, 15, 15, 7, 7, true);
+
+    engine.open(input, output, 15, 15);
+    ASSERT_TRUE(output->isEqual(*opened), "Wrong opening");
+    engine.close(input, output, 15, 15);
+    ASSERT_TRUE(output->isEqual(*closed), "Wrong closing");
+
+    engine.topHat(input, output, 15, 15);
+    for (int i = 0; i < input->h; i++)
+        for (int j = 0; j < input->w; j++)
+            ASSERT_TRUE(output->element(i, j) == input->element(i, j) - opened->element(i, j), "Wrong top-hat");
+
+    engine.blackHat(input, output, 15, 15);
+    for (int i = 0; i < input->h; i++)
+        for (int j = 0; j < input->w; j++)
+            ASSERT_TRUE(output->element(i, j) == closed->element(i, j) - input->element(i, j), "Wrong black top-hat");
+
+    delete closed;
+    delete dilated;
+    delete opened;
+    delete eroded;
+    delete output;
+    delete input;
+}
 
 int main (int /*argC*/, char ** /*argV*/)
 {
     /*testErodeDilate12();*/
     testErodeDilate8 ();
+    testRectMorphology<G8Buffer>(255);
+    testRectMorphology<G12Buffer>(4095);
     cout << "PASSED" << endl;
     return 0;
 }
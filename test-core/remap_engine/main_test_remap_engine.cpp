@@ -0,0 +1,173 @@
+/**
+ * \file main_test_remap_engine.cpp
+ * \brief This is the main file for the test remap_engine
+ *
+ * \date Oct 19, 2026
+ *
+ * \ingroup autotest
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef ASSERTS
+#define ASSERTS
+#endif
+
+#include "global.h"
+
+#include "g12Buffer.h"
+#include "matrix33.h"
+#include "remapEngine.h"
+#include "transformationCache.h"
+
+using namespace std;
+using namespace corecvs;
+
+static const int H = 61;
+static const int W = 77;
+
+/* Small rotation, scale and shift that leaves some of the output outside of the input */
+static Matrix33 testMatrix()
+{
+    double angle = 0.1;
+    return Matrix33(
+        1.05 * cos(angle), -1.05 * sin(angle),  6.3,
+        1.05 * sin(angle),  1.05 * cos(angle), -4.7,
+        0.0              ,  0.0              ,  1.0
+    );
+}
+
+static G12Buffer *ramp()
+{
+    G12Buffer *image = new G12Buffer(H, W);
+    for (int i = 0; i < H; i++)
+        for (int j = 0; j < W; j++)
+            image->element(i, j) = 100 + 20 * j + 13 * i;
+    return image;
+}
+
+void testBilinear()
+{
+    G12Buffer *image = new G12Buffer(H, W);
+    for (int i = 0; i < H; i++)
+        for (int j = 0; j < W; j++)
+            image->element(i, j) = rand() % 4096;
+
+    Matrix33 inverse = testMatrix();
+    RemapMap *map = RemapMap::fromMatrix(inverse, H, W, H, W);
+    G12Buffer *result = RemapEngine::remap(*map, image, RemapEngine::BILINEAR);
+
+    /* SIMD path against the plain formula on the packed map */
+    int valid = 0;
+    for (int i = 0; i < H; i++)
+    {
+        for (int j = 0; j < W; j++)
+        {
+            int index = i * W + j;
+            int x = map->coords[2 * index];
+            if (x == RemapMap::INVALID)
+            {
+                ASSERT_TRUE(result->element(i, j) == 0, "Invalid pixels should be zero");
+                continue;
+            }
+            valid++;
+            int y  = map->coords[2 * index + 1];
+            int fx = map->fractions[index] & 0xFF;
+            int fy = map->fractions[index] >> 8;
+            uint32_t sum = image->element(y    , x) * (32 - fx) * (32 - fy) + image->element(y    , x + 1) * fx * (32 - fy)
+                         + image->element(y + 1, x) * (32 - fx) * fy        + image->element(y + 1, x + 1) * fx * fy;
+            ASSERT_TRUE_P(result->element(i, j) == (sum + 512) >> 10, ("Wrong bilinear value at %d %d", i, j));
+
+            Vector2dd source = inverse * Vector2dd(j, i);
+            ASSERT_TRUE(fabs(x + fx / 32.0 - source.x()) <= 1.0 / 64 + 1e-9, "Wrong packed x");
+            ASSERT_TRUE(fabs(y + fy / 32.0 - source.y()) <= 1.0 / 64 + 1e-9, "Wrong packed y");
+        }
+    }
+    ASSERT_TRUE(valid > H * W / 2 && valid < H * W, "The map should have both valid and invalid pixels");
+
+    delete result;
+    delete map;
+    delete image;
+}
+
+void testInterpolationAccuracy()
+{
+    G12Buffer *image = ramp();
+    Matrix33 inverse = testMatrix();
+    RemapMap *map = RemapMap::fromMatrix(inverse, H, W, H, W);
+
+    G12Buffer *bilinear = RemapEngine::remap(*map, image, RemapEngine::BILINEAR);
+    G12Buffer *bicubic  = RemapEngine::remap(*map, image, RemapEngine::BICUBIC);
+
+    for (int i = 0; i < H; i++)
+    {
+        for (int j = 0; j < W; j++)
+        {
+            if (!map->isValid(i, j))
+                continue;
+            Vector2dd source = inverse * Vector2dd(j, i);
+            double expected = 100 + 20 * source.x() + 13 * source.y();
+            /* Half of the quantum of the map times the gradient, and the rounding */
+            double tolerance = (20 + 13) / 64.0 + 1.0;
+            ASSERT_TRUE_P(fabs(bilinear->element(i, j) - expected) <= tolerance, ("Wrong bilinear at %d %d", i, j));
+            ASSERT_TRUE_P(fabs(bicubic ->element(i, j) - expected) <= tolerance, ("Wrong bicubic at %d %d", i, j));
+        }
+    }
+
+    delete bicubic;
+    delete bilinear;
+    delete map;
+    delete image;
+}
+
+void testNearestAndCache()
+{
+    G12Buffer *image = ramp();
+
+    /* Integer shift is exact for the nearest */
+    Matrix33 shift(
+        1.0, 0.0, 3.0,
+        0.0, 1.0, 2.0,
+        0.0, 0.0, 1.0
+    );
+    RemapMap *map = RemapMap::fromMatrix(shift, H, W, H, W);
+    G12Buffer *nearest = RemapEngine::remap(*map, image, RemapEngine::NEAREST);
+    for (int i = 0; i < H; i++)
+    {
+        for (int j = 0; j < W; j++)
+        {
+            if (i + 2 < H && j + 3 < W) {
+                ASSERT_TRUE(nearest->element(i, j) == image->element(i + 2, j + 3), "Wrong nearest value");
+            } else {
+                ASSERT_TRUE(nearest->element(i, j) == 0, "Pixel outside of the input should be zero");
+            }
+        }
+    }
+
+    /* The cache uses the same engine */
+    Matrix33 inverse = testMatrix();
+    RemapMap *testMap = RemapMap::fromMatrix(inverse, H, W, H, W);
+    TransformationCache cache(inverse, W, H, Vector2d<int>(W, H));
+    G12Buffer *cached = cache.doDeformation(InterpolationType::BILINEAR_FIXED8, image);
+    G12Buffer *direct = RemapEngine::remap(*testMap, image);
+    ASSERT_TRUE(cached->isEqual(*direct), "TransformationCache should use the remap engine");
+
+    delete direct;
+    delete cached;
+    delete testMap;
+    delete nearest;
+    delete map;
+    delete image;
+}
+
+int main (int /*argC*/, char ** /*argV*/)
+{
+    testBilinear();
+    testInterpolationAccuracy();
+    testNearestAndCache();
+
+    cout << "PASSED" << endl;
+    return 0;
+}
@@ -0,0 +1,8 @@
+##################################################################
+# remap_engine.pro created on Oct 19, 2026
+# This is a file for QMAKE that allows to build the test remap_engine
+#
+##################################################################
+include(../testsCommon.pri)
+
+SOURCES += main_test_remap_engine.cpp
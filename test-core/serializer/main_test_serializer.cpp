@@ -21,6 +21,9 @@
 #include "propertyListVisitor.h"
 #include "triangulator.h"
 #include "printerVisitor.h"
+#include "binaryVisitor.h"
+#include "cannyParameters.h"
+#include "makePreciseParameters.h"
 
 
 using namespace std;
@@ -99,11 +102,159 @@ void testSerializer1( void )
     list.save(cout);
 }
 
+/* Per frame metadata with the old style visitor and the types the generated classes do not have */
+struct FrameMetadata
+{
+    int64_t   timestamp;
+    int       frame;
+    float     gain;
+    string    source;
+    Vector3dd speed;
+
+template<class VisitorType>
+    void accept(VisitorType &visitor)
+    {
+        visitor.visit(timestamp, (int64_t)0, "timestamp");
+        visitor.visit(frame    , 0         , "frame");
+        visitor.visit(gain     , 1.0f      , "gain");
+        visitor.visit(source   , string()  , "source");
+        visitor.visit(speed    , Vector3dd(0.0), "speed");
+    }
+};
+
+template<class Type>
+vector<uint8_t> binaryOf(Type &object)
+{
+    BinarySerializerVisitor visitor;
+    object.accept(visitor);
+    return visitor.data;
+}
+
+void testBinarySerializer( void )
+{
+    RectificationResult rectification;
+    rectification.leftCamera  = CameraIntrinsics(Vector2dd(640.0, 480.0), Vector2dd(320.5, 240.25), 3.6, 0.006);
+    rectification.decomposition = EssentialDecomposition(Matrix33::RotationY(0.01), Vector3dd(-1.0, 0.01, 0.0).normalised());
+    rectification.leftTransform = Matrix33(1.0, 0.1, 3.0, 0.0, 1.2, -2.0, 1e-5, 0.0, 1.0);
+    rectification.baseline = 123.456;
+
+    CannyParameters canny(false, 17, 123);
+    MakePreciseParameters precise;
+    precise.setInterpolation(PreciseInterpolationType::POLYNOM);
+    precise.setKLTThreshold(0.125);
+
+    ASSERT_TRUE(binarySchemaHash(rectification) != binarySchemaHash(canny), "Schemas should differ");
+    CannyParameters otherCanny;
+    ASSERT_TRUE(binarySchemaHash(otherCanny) == binarySchemaHash(canny), "Schema should not depend on values");
+
+    /* Stream of the mixed records */
+    std::ostringstream output;
+    BinaryRecordWriter writer(output);
+    const int frames = 100;
+    for (int i = 0; i < frames; i++)
+    {
+        FrameMetadata metadata;
+        metadata.timestamp = 1000000000000LL + i * 33333;
+        metadata.frame  = i - 50;
+        metadata.gain   = 1.0f + i / 64.0f;
+        metadata.source = (i % 2) ? "left" : "";
+        metadata.speed  = Vector3dd(i, -i, 0.5 * i);
+        writer.write(metadata);
+    }
+    writer.write(rectification);
+    writer.write(canny);
+    writer.write(precise);
+    ASSERT_TRUE(writer.records() == frames + 3, "Wrong number of records");
+
+    PropertyList list;
+    PropertyListWriterVisitor listWriter(&list);
+    listWriter.visit(rectification, rectification, "RectificationResult");
+    std::ostringstream listOutput;
+    list.save(listOutput);
+    size_t binarySize = binaryOf(rectification).size();
+    cout << "RectificationResult binary " << binarySize << " bytes, property list " << listOutput.str().size() << " bytes" << endl;
+    ASSERT_TRUE(binarySize * 2 < listOutput.str().size(), "Binary form should be compact");
+
+    std::istringstream input(output.str());
+    BinaryRecordReader reader(input);
+    for (int i = 0; i < frames; i++)
+    {
+        FrameMetadata metadata;
+        bool isRead = reader.read(metadata);
+        ASSERT_TRUE(isRead, "Metadata should be read");
+        ASSERT_TRUE(metadata.timestamp == 1000000000000LL + i * 33333, "Wrong timestamp");
+        ASSERT_TRUE(metadata.frame == i - 50, "Wrong frame");
+        ASSERT_TRUE(metadata.gain == 1.0f + i / 64.0f, "Wrong gain");
+        ASSERT_TRUE(metadata.source == ((i % 2) ? "left" : ""), "Wrong source");
+        ASSERT_TRUE(metadata.speed == Vector3dd(i, -i, 0.5 * i), "Wrong speed");
+    }
+
+    /* Record of the other type is reported and skipped */
+    CannyParameters wrong;
+    bool wrongRead = reader.read(wrong);
+    ASSERT_TRUE(!wrongRead, "Schema mismatch expected");
+    ASSERT_TRUE(reader.status() == BinaryRecordReader::STATUS_SCHEMA_MISMATCH, "Wrong status");
+    ASSERT_TRUE(wrong.minimumThreshold() == otherCanny.minimumThreshold(), "Object should not be touched");
+
+    CannyParameters readCanny;
+    MakePreciseParameters readPrecise;
+    bool cannyRead   = reader.read(readCanny);
+    bool preciseRead = reader.read(readPrecise);
+    ASSERT_TRUE(cannyRead, "Canny should be read");
+    ASSERT_TRUE(preciseRead, "MakePrecise should be read");
+    ASSERT_TRUE(!readCanny.shouldEdgeDetect() && readCanny.minimumThreshold() == 17 && readCanny.maximumThreshold() == 123, "Wrong canny");
+    ASSERT_TRUE(readPrecise.interpolation() == PreciseInterpolationType::POLYNOM && readPrecise.kLTThreshold() == 0.125, "Wrong enum or double");
+    ASSERT_TRUE(binaryOf(readPrecise) == binaryOf(precise), "MakePrecise should round trip");
+    bool pastEndRead = reader.read(readCanny);
+    ASSERT_TRUE(!pastEndRead && reader.status() == BinaryRecordReader::STATUS_END, "End expected");
+
+    /* Rectification round trip, values are bit exact */
+    std::istringstream input2(output.str());
+    BinaryRecordReader reader2(input2);
+    for (int i = 0; i < frames; i++)
+    {
+        bool isSkipped = reader2.nextRecord();
+        ASSERT_TRUE(isSkipped, "Record should be skipped");
+    }
+    RectificationResult readRectification;
+    bool rectificationRead = reader2.read(readRectification);
+    ASSERT_TRUE(rectificationRead, "Rectification should be read");
+    ASSERT_TRUE(binaryOf(readRectification) == binaryOf(rectification), "Rectification should round trip");
+    ASSERT_TRUE(readRectification.baseline == 123.456, "Wrong baseline");
+    ASSERT_TRUE(readRectification.leftCamera.center == Vector2dd(320.5, 240.25), "Wrong camera");
+    ASSERT_TRUE(readRectification.leftTransform.a(2, 0) == 1e-5, "Wrong transform");
+
+    /* Damaged streams */
+    string data = output.str();
+    std::istringstream truncated(data.substr(0, data.size() - 3));
+    BinaryRecordReader truncatedReader(truncated);
+    for (int i = 0; i < frames + 2; i++)
+    {
+        bool isIntact = truncatedReader.nextRecord();
+        ASSERT_TRUE(isIntact, "Intact records should be read");
+    }
+    bool truncatedRead = truncatedReader.read(readPrecise);
+    ASSERT_TRUE(!truncatedRead && truncatedReader.status() == BinaryRecordReader::STATUS_DAMAGED, "Truncation should be detected");
+
+    /* Corrupted size of the record, the reader should not allocate it */
+    string oversized = data.substr(0, 8) + data.substr(8, 4) + string("\xF0\xFF\xFF\xFF", 4) + data.substr(16, 64);
+    std::istringstream oversizedInput(oversized);
+    BinaryRecordReader oversizedReader(oversizedInput);
+    bool oversizedRead = oversizedReader.nextRecord();
+    ASSERT_TRUE(!oversizedRead && oversizedReader.status() == BinaryRecordReader::STATUS_DAMAGED, "Oversized record should be damaged");
+
+    std::istringstream garbage("not a record stream");
+    BinaryRecordReader garbageReader(garbage);
+    bool garbageRead = garbageReader.read(readCanny);
+    ASSERT_TRUE(!garbageRead && garbageReader.status() == BinaryRecordReader::STATUS_BAD_HEADER, "Header should be checked");
+}
+
 int main (int /*argC*/, char ** /*argV*/)
 {
     testReflection();
     testSerializer();
     testSerializer1();
+    testBinarySerializer();
 
     cout << "PASSED" << endl;
         return 0;
@@ -16,6 +16,10 @@
 #include "vector3d.h"
 #include "triangulator.h"
 #include "cameraParameters.h"
+#include "flowBuffer.h"
+#include "floatCloud.h"
+#include "batchTriangulator.h"
+#include "sixDBuffer.h"
 
 
 using namespace std;
@@ -62,9 +66,200 @@ void testDepthAndDisparity()
 
 }
 
+void testFloatCloud()
+{
+    RectificationResult rectification;
+    rectification.leftCamera  = CameraIntrinsics(Vector2dd(100.0, 100.0), Vector2dd(50.0, 40.0), 100.0, 1.0);
+    rectification.rightCamera = CameraIntrinsics(Vector2dd(100.0, 100.0), Vector2dd(50.0, 40.0), 100.0, 1.0);
+    rectification.decomposition = EssentialDecomposition(Matrix33(1.0), Vector3dd(-1.0, 0.0, 0.0));
+    rectification.baseline = 10.0;
+    Triangulator triangulator(rectification);
+
+    int h = 80, w = 100;
+    DisparityBuffer *disparity = new DisparityBuffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            if ((i * 7 + j * 3) % 5 != 0)
+                disparity->element(i, j) = FlowElement(-(1 + (i + j) % 20), 0);
+
+    Cloud      *cloud      = triangulator.triangulate(disparity, 0);
+    FloatCloud *floatCloud = triangulator.triangulateToFloatCloud(disparity);
+    ASSERT_TRUE(cloud->size() == floatCloud->size(), "Clouds differ in size");
+    ASSERT_TRUE(floatCloud->pointSize() * 3 < sizeof(SwarmPoint), "Float cloud should be much smaller");
+
+    /* Row major order, same as the serial triangulation */
+    unsigned k = 0;
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            if (!disparity->isElementKnown(i, j))
+                continue;
+            Vector2dd start(j, i);
+            Vector3dd expected = triangulator.triangulate(start, Vector2dd(disparity->element(i, j).x(), 0));
+            ASSERT_TRUE(cloud->at(k).texCoor == start, "Wrong texture coordinate");
+            ASSERT_TRUE((cloud->at(k).point - expected).notTooFar(Vector3dd(0.0), 1e-9), "Wrong point");
+            ASSERT_TRUE(floatCloud->texCoor(k) == start, "Wrong float texture coordinate");
+            ASSERT_TRUE((floatCloud->point(k) - expected).notTooFar(Vector3dd(0.0), 1e-5 * expected.l2Metric()), "Wrong float point");
+            k++;
+        }
+    }
+    ASSERT_TRUE(k == cloud->size(), "Wrong number of points");
+
+    /* Box filter against the double one over the converted cloud */
+    Cloud *converted = floatCloud->toCloud();
+    Vector3dd center = converted->at(converted->size() / 2).point;
+    AxisAlignedBox3d box = AxisAlignedBox3d::ByCenter(center, Vector3dd(30.0, 20.0, 40.0));
+    Cloud      *filtered      = converted->filterByAABB(box);
+    FloatCloud *floatFiltered = floatCloud->filterByAABB(box);
+    ASSERT_TRUE(filtered->size() > 0 && filtered->size() < converted->size(), "Box should cut the cloud");
+    ASSERT_TRUE(filtered->size() == floatFiltered->size(), "Float box filter differs");
+    for (unsigned i = 0; i < filtered->size(); i++)
+    {
+        ASSERT_TRUE(filtered->at(i).point == floatFiltered->point(i), "Float box filter differs");
+        ASSERT_TRUE(filtered->at(i).texCoor == floatFiltered->texCoor(i), "Float box filter lost the channel");
+    }
+
+    FloatCloud *back = FloatCloud::fromCloud(converted);
+    ASSERT_TRUE(back->x == floatCloud->x && back->texY == floatCloud->texY, "Conversion should round trip");
+
+    delete_safe(back);
+    delete_safe(floatFiltered);
+    delete_safe(filtered);
+    delete_safe(converted);
+    delete_safe(floatCloud);
+    delete_safe(cloud);
+    delete_safe(disparity);
+}
+
+static bool isClose(const Vector3dd &value, const Vector3dd &expected, double tolerance)
+{
+    return (value - expected).notTooFar(Vector3dd(0.0), tolerance * expected.l2Metric());
+}
+
+/* Batch results against the per pixel double ones, with the vertical disparity for the general case */
+static void checkBatch(const RectificationResult &rectification, bool rectified)
+{
+    Triangulator triangulator(rectification);
+    BatchTriangulator batch(triangulator);
+    ASSERT_TRUE(batch.isRectified() == rectified, "Wrong rectification detection");
+
+    int h = 30, w = 67;
+    DisparityBuffer *disparity = new DisparityBuffer(h, w);
+    for (int i = 0; i < h; i++)
+        for (int j = 0; j < w; j++)
+            if ((i * 5 + j * 3) % 7 != 0)
+                disparity->element(i, j) = FlowElement(-(2 + (i + 2 * j) % 30), rectified ? 0 : (i + j) % 5 - 2);
+
+    DepthBuffer *depth = triangulator.triangulateToDB(disparity);
+    ASSERT_TRUE(depth != NULL, "Depth buffer expected");
+    FloatCloud *cloud = triangulator.triangulateToFloatCloud(disparity);
+
+    unsigned k = 0;
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            if (!disparity->isElementKnown(i, j))
+            {
+                ASSERT_TRUE(depth->element(i, j) == DepthBuffer::DEPTH_UNKNOWN, "Unknown pixel should stay unknown");
+                continue;
+            }
+            Vector2dd start(j, i);
+            Vector2dd shift(disparity->element(i, j).x(), disparity->element(i, j).y());
+            double expectedDepth = triangulator.getDepth(start, shift);
+            /* Float depth of the general configuration loses more near the degenerate pixels */
+            double tolerance = rectified ? 1e-4 : 1e-3;
+            ASSERT_TRUE(fabs(depth->element(i, j) - expectedDepth) < tolerance * fabs(expectedDepth), "Wrong batch depth");
+            ASSERT_TRUE(isClose(cloud->point(k), triangulator.triangulate(start, shift), 1e-4), "Wrong batch point");
+            ASSERT_TRUE(cloud->texCoor(k) == start, "Wrong batch texture coordinate");
+            k++;
+        }
+    }
+    ASSERT_TRUE(k == cloud->size(), "Wrong number of batch points");
+
+    /* Scattered positions, the odd count leaves the scalar tail */
+    const int count = 7;
+    float sx[count], sy[count], dx[count], dy[count], px[count], py[count], pz[count];
+    for (int i = 0; i < count; i++)
+    {
+        sx[i] = 3.5f + 9.25f * i;
+        sy[i] = 2.0f + 3.5f * i;
+        dx[i] = -4.0f - i;
+        dy[i] = rectified ? 0.0f : 0.5f * (i % 3) - 0.5f;
+    }
+    batch.points(count, sx, sy, dx, dy, px, py, pz);
+    for (int i = 0; i < count; i++)
+    {
+        Vector3dd expected = triangulator.triangulate(Vector2dd(sx[i], sy[i]), Vector2dd(dx[i], dy[i]));
+        ASSERT_TRUE(isClose(Vector3dd(px[i], py[i], pz[i]), expected, 1e-4), "Wrong scattered point");
+    }
+
+    delete_safe(cloud);
+    delete_safe(depth);
+    delete_safe(disparity);
+}
+
+void testBatchTriangulator()
+{
+    RectificationResult rectification;
+    rectification.leftCamera  = CameraIntrinsics(Vector2dd(100.0, 100.0), Vector2dd(50.0, 40.0), 100.0, 1.0);
+    rectification.rightCamera = CameraIntrinsics(Vector2dd(100.0, 100.0), Vector2dd(50.0, 40.0), 100.0, 1.0);
+    rectification.decomposition = EssentialDecomposition(Matrix33(1.0), Vector3dd(-1.0, 0.0, 0.0));
+    rectification.baseline = 10.0;
+    rectification.rightTransform = Matrix33(1.0, 0.1, 3.0,   0.0, 1.2, -2.0,  0.0, 0.0, 1.0);
+    rectification.leftTransform  = rectification.rightTransform;
+    checkBatch(rectification, true);
+
+    rectification.decomposition = EssentialDecomposition(
+            Matrix33::RotationY(0.03) * Matrix33::RotationX(0.01),
+            Vector3dd(-1.0, 0.05, 0.02).normalised());
+    rectification.rightTransform = Matrix33(1.0,  0.02, 1.0,   0.01, 1.0, -2.0,  1e-4, 2e-4, 1.0);
+    rectification.leftTransform  = Matrix33(1.0, -0.01, 2.0,  -0.02, 1.0,  1.0, -1e-4, 1e-4, 1.0);
+    checkBatch(rectification, false);
+
+    /* Speed of the 6D cloud against the Cloud one */
+    Triangulator triangulator(rectification);
+    int h = 20, w = 37;
+    SixDBuffer *sixD = new SixDBuffer(h, w);
+    for (int i = 0; i < h; i++)
+    {
+        for (int j = 0; j < w; j++)
+        {
+            if ((i + j) % 4 == 0)
+                continue;
+            int dispPrev = ((i + j) % 3 == 0) ? Element6D::CFLOW_UNKNOWN_X : 3 + (i * j) % 10;
+            sixD->element(i, j) = Element6D(Vector2d16(j % 5 - 2, i % 3 - 1), 2 + (i + j) % 15, dispPrev);
+        }
+    }
+
+    Cloud      *cloud      = triangulator.triangulate(sixD, 0);
+    FloatCloud *floatCloud = triangulator.triangulateToFloatCloud(sixD);
+    ASSERT_TRUE(cloud->size() == floatCloud->size(), "6D clouds differ in size");
+    int moving = 0;
+    for (unsigned i = 0; i < cloud->size(); i++)
+    {
+        const SwarmPoint &expected = cloud->at(i);
+        double scale = expected.point.l2Metric();
+        ASSERT_TRUE(isClose(floatCloud->point(i), expected.point, 1e-4), "Wrong 6D point");
+        ASSERT_TRUE(floatCloud->texCoor(i) == expected.texCoor, "Wrong 6D texture coordinate");
+        ASSERT_TRUE((floatCloud->speed(i) - expected.speed).notTooFar(Vector3dd(0.0), 1e-4 * scale), "Wrong 6D speed");
+        ASSERT_TRUE((floatCloud->is6D[i] != 0) == expected.is6D, "Wrong 6D flag");
+        if (expected.is6D)
+            moving++;
+    }
+    ASSERT_TRUE(moving > 0 && moving < (int)cloud->size(), "Test should have both kinds of points");
+
+    delete_safe(floatCloud);
+    delete_safe(cloud);
+    delete_safe(sixD);
+}
+
 int main (int /*argC*/, char ** /*argV*/)
 {
     testDepthAndDisparity();
+    testFloatCloud();
+    testBatchTriangulator();
     cout << "PASSED" << endl;
     return 0;
 }
@@ -63,3 +63,14 @@ SUBDIRS += \
     triangulator \
     cloud \
     distortion \
+    filter_graph \
+    zone_tracer \
+    frame_latency \
+    cascade_detector \
+    vj_trainer \
+    remap_engine \
+    deform_chain \
+    canny_detector \
+    histogram_builder \
+    meanshift \
+    buffer_reduction \
@@ -0,0 +1,224 @@
+/**
+ * \file main_test_vj_trainer.cpp
+ * \brief This is the main file for the test vj_trainer
+ *
+ * \date Oct 19, 2026
+ *
+ * \ingroup autotest
+ */
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef ASSERTS
+#define ASSERTS
+#endif
+
+#include "global.h"
+
+#include "g12Buffer.h"
+#include "integralBuffer.h"
+#include "vjPattern.h"
+#include "cascadeClassifier.h"
+#include "vjTrainer.h"
+
+using namespace std;
+using namespace corecvs;
+
+static const int WINDOW = 8;
+
+/* Bright 4x4 spot in the middle of the noisy window */
+static G12Buffer *drawPositive()
+{
+    G12Buffer *window = new G12Buffer(WINDOW, WINDOW);
+    for (int i = 0; i < WINDOW; i++)
+        for (int j = 0; j < WINDOW; j++)
+            window->element(i, j) = 400 + rand() % 400;
+    int brightness = 2000 + rand() % 1500;
+    for (int i = 2; i < 6; i++)
+        for (int j = 2; j < 6; j++)
+            window->element(i, j) = brightness + rand() % 200;
+    return window;
+}
+
+/* Noise with the bright bars and the spots of the wrong size */
+static G12Buffer *drawBackground(int size)
+{
+    G12Buffer *image = new G12Buffer(size, size);
+    for (int i = 0; i < size; i++)
+        for (int j = 0; j < size; j++)
+            image->element(i, j) = 300 + rand() % 800;
+    for (int bar = 0; bar < 4; bar++)
+    {
+        int x = rand() % (size - 12);
+        for (int i = 0; i < size; i++)
+            for (int j = x; j < x + 12; j++)
+                image->element(i, j) = 2500 + rand() % 500;
+    }
+    for (int spot = 0; spot < size * size / 64; spot++)
+    {
+        int side = (rand() % 2) ? 2 : 6;
+        int x = rand() % (size - side);
+        int y = rand() % (size - side);
+        for (int i = y; i < y + side; i++)
+            for (int j = x; j < x + side; j++)
+                image->element(i, j) = 2000 + rand() % 1500;
+    }
+    return image;
+}
+
+void testFindBestFeature()
+{
+    VJSampleSet samples(WINDOW, WINDOW);
+    for (int s = 0; s < 60; s++)
+    {
+        G12Buffer *window = (s % 3 == 0) ? drawPositive() : drawBackground(WINDOW);
+        samples.add(window, s % 3 == 0);
+        delete window;
+    }
+
+    vector<VJPattern *> features = VJCascadeTrainer::generateFeatures(WINDOW, WINDOW, 40, 7);
+    VJFeatureResponses responses;
+    responses.compute(samples, features);
+
+    vector<double> weights(samples.size());
+    for (int s = 0; s < samples.size(); s++)
+        weights[s] = (rand() % 100 + 1) / 100.0;
+
+    for (int f = 0; f < responses.featuresNumber(); f++)
+    {
+        for (int s = 0; s < samples.size(); s++)
+            ASSERT_TRUE(responses.value(f, s) == VJFeatureResponses::evaluate(features[f], samples.integral(s), samples.integralStride()),
+                        "Bulk response differs from the single one");
+        const int32_t *sorted = responses.sorted(f);
+        for (int s = 1; s < samples.size(); s++)
+            ASSERT_TRUE(responses.value(f, sorted[s - 1]) <= responses.value(f, sorted[s]), "Responses are not sorted");
+    }
+
+    /* Brute force over every threshold of every feature */
+    double bestError = 1e100;
+    for (int f = 0; f < responses.featuresNumber(); f++)
+    {
+        for (int t = 0; t < samples.size(); t++)
+        {
+            int32_t threshold = responses.value(f, t);
+            for (int inverted = 0; inverted < 2; inverted++)
+            {
+                double error = 0.0;
+                for (int s = 0; s < samples.size(); s++)
+                {
+                    int32_t v = responses.value(f, s);
+                    bool prediction = inverted ? (v <= threshold) : (v > threshold);
+                    if (prediction != samples.isPositive(s))
+                        error += weights[s];
+                }
+                bestError = CORE_MIN(bestError, error);
+            }
+        }
+    }
+
+    VJWeakSearchResult best = VJCascadeTrainer::findBestFeature(responses, samples, weights);
+    ASSERT_TRUE(best.feature >= 0, "No feature found");
+    ASSERT_TRUE(fabs(best.error - bestError) < 1e-9, "Sweep missed the best threshold");
+
+    double error = 0.0;
+    for (int s = 0; s < samples.size(); s++)
+        if (best.predict(responses.value(best.feature, s)) != samples.isPositive(s))
+            error += weights[s];
+    ASSERT_TRUE(fabs(best.error - error) < 1e-9, "Reported error does not match the threshold");
+
+    for (unsigned i = 0; i < features.size(); i++)
+        delete features[i];
+}
+
+static void fillTrainer(VJCascadeTrainer &trainer, vector<G12Buffer *> &buffers)
+{
+    for (int i = 0; i < 200; i++)
+    {
+        G12Buffer *window = drawPositive();
+        trainer.addPositive(window);
+        delete window;
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        buffers.push_back(drawBackground(64));
+        trainer.addBackground(buffers.back());
+    }
+}
+
+void testTraining()
+{
+    srand(1);
+    const char *checkpoint = "vj_trainer_checkpoint.txt";
+    remove(checkpoint);
+
+    VJCascadeTrainerParameters params;
+    params.featuresNumber  = 300;
+    params.stagesNumber    = 1;
+    params.maxWeakNumber   = 3;
+    params.negativesNumber = 400;
+    params.negativeStep    = 2;
+    params.checkpointFile  = checkpoint;
+
+    vector<G12Buffer *> buffers;
+    VJCascadeTrainer first(WINDOW, WINDOW, params);
+    fillTrainer(first, buffers);
+    ASSERT_TRUE(first.train(), "Training failed");
+    ASSERT_TRUE(first.cascade()->stagesNumber() == 1, "Wrong number of stages");
+
+    /* Second trainer resumes from the checkpoint of the first one */
+    params.stagesNumber = 2;
+    VJCascadeTrainer second(WINDOW, WINDOW, params);
+    fillTrainer(second, buffers);
+    ASSERT_TRUE(second.train(), "Resumed training failed");
+    CascadeClassifier *cascade = second.cascade();
+    ASSERT_TRUE(cascade->stagesNumber() == 2, "Wrong number of stages after resume");
+
+    CascadeClassifier stored(WINDOW, WINDOW);
+    ASSERT_TRUE(stored.load(string(checkpoint)), "Checkpoint is not readable");
+    ASSERT_TRUE(stored.stagesNumber() == 2, "Checkpoint is not updated");
+
+    /* The cascade should keep most of the new positives */
+    VJSampleSet positives(WINDOW, WINDOW);
+    for (int i = 0; i < 200; i++)
+    {
+        G12Buffer *window = drawPositive();
+        positives.add(window, true);
+        delete window;
+    }
+    CompiledCascade *compiled = cascade->compile(1.0, positives.integralStride());
+    int detected = 0;
+    for (int i = 0; i < positives.size(); i++)
+        if (compiled->evaluate(positives.integral(i)) == compiled->stagesNumber())
+            detected++;
+    delete compiled;
+    cout << "Hit rate " << detected << " of " << positives.size() << endl;
+    ASSERT_TRUE(detected >= 180, "Hit rate is too low");
+
+    /* ...and reject most of the new background */
+    G12Buffer *background = drawBackground(64);
+    G12IntegralBuffer integral(background);
+    CascadeDetectorParameters detectorParams;
+    detectorParams.maxScale      = 1.0;
+    detectorParams.minNeighbours = 0;
+    vector<CascadeHit> hits;
+    cascade->detect(&integral, detectorParams, &hits);
+    cout << "False alarms " << hits.size() << " of " << cascade->stats.windows << endl;
+    ASSERT_TRUE(hits.size() * 20 < cascade->stats.windows, "False alarm rate is too high");
+
+    delete background;
+    for (unsigned i = 0; i < buffers.size(); i++)
+        delete buffers[i];
+    remove(checkpoint);
+}
+
+int main (int /*argC*/, char ** /*argV*/)
+{
+    testFindBestFeature();
+    testTraining();
+
+    cout << "PASSED" << endl;
+    return 0;
+}
@@ -0,0 +1,8 @@
+##################################################################
+# vj_trainer.pro created on Oct 19, 2026
+# This is a file for QMAKE that allows to build the test vj_trainer
+#
+##################################################################
+include(../testsCommon.pri)
+
+SOURCES += main_test_vj_trainer.cpp
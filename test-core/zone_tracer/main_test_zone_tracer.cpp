@@ -0,0 +1,134 @@
+/**
+ * \file main_test_zone_tracer.cpp
+ * \brief This is the main file for the test zone_tracer
+ *
+ * \date Oct 19, 2026
+ *
+ * \ingroup autotest
+ */
+
+#include <iostream>
+#include <sstream>
+
+#ifndef ASSERTS
+#define ASSERTS
+#endif
+
+#ifndef WITH_TRACING
+#define WITH_TRACING
+#endif
+
+#include "global.h"
+
+#include "zoneTracer.h"
+#include "calculationStats.h"
+#include "tbbWrapper.h"
+
+using namespace std;
+using namespace corecvs;
+
+static volatile int sink = 0;
+
+static void innerWork()
+{
+    TRACE_ZONE("Inner");
+    for (int i = 0; i < 1000; i++)
+        sink += i;
+}
+
+static void outerWork()
+{
+    TRACE_ZONE("Outer");
+    innerWork();
+    innerWork();
+}
+
+class ParallelWork
+{
+public:
+    void operator()(const BlockedRange<int> &r) const
+    {
+        for (int i = r.begin(); i < r.end(); i++)
+            outerWork();
+    }
+};
+
+void testDisabled()
+{
+    ZoneTracer::setEnabled(false);
+    ZoneTracer::clear();
+    outerWork();
+
+    BaseTimeStatisticsCollector collector;
+    ZoneTracer::collect(collector);
+    ASSERT_TRUE(collector.sumValues.empty(), "Disabled tracer should not record anything");
+}
+
+void testCollect()
+{
+    ZoneTracer::setEnabled(true);
+    ZoneTracer::clear();
+    for (int i = 0; i < 10; i++)
+        outerWork();
+
+    BaseTimeStatisticsCollector collector;
+    ZoneTracer::collect(collector);
+    ASSERT_TRUE(collector.sumValues.size() == 2, "Two zones expected");
+    ASSERT_TRUE(collector.sumValues["Outer"].number == 10, "Outer zone should be entered 10 times");
+    ASSERT_TRUE(collector.sumValues["Inner"].number == 20, "Inner zone should be entered 20 times");
+    ASSERT_TRUE(collector.sumValues["Outer"].sum >= collector.sumValues["Inner"].sum, "Outer zone includes the inner ones");
+
+    /* Events are collected only once */
+    BaseTimeStatisticsCollector collector1;
+    ZoneTracer::collect(collector1);
+    ASSERT_TRUE(collector1.sumValues.empty(), "Events should not be collected twice");
+    ZoneTracer::setEnabled(false);
+}
+
+void testOverflow()
+{
+    ZoneTracer::setEnabled(true);
+    ZoneTracer::clear();
+    int calls = TraceRing::CAPACITY;
+    for (int i = 0; i < calls; i++)
+        innerWork();
+
+    BaseTimeStatisticsCollector collector;
+    ZoneTracer::collect(collector);
+    /* Only the latest events survive in the ring */
+    unsigned number = (unsigned)collector.sumValues["Inner"].number;
+    ASSERT_TRUE(number > 0 && number <= TraceRing::CAPACITY, "Ring should keep at most CAPACITY events");
+    ZoneTracer::setEnabled(false);
+}
+
+void testChromeExport()
+{
+    ZoneTracer::setEnabled(true);
+    ZoneTracer::clear();
+    parallelable_for(0, 64, 1, ParallelWork());
+    ZoneTracer::setEnabled(false);
+
+    stringstream stream;
+    ZoneTracer::exportChromeTrace(stream);
+    string json = stream.str();
+
+    ASSERT_TRUE(json.find("{\"traceEvents\":[") == 0, "Wrong header of the trace");
+    ASSERT_TRUE(json.find("\"name\":\"Outer\"") != string::npos, "Outer zone should be exported");
+    ASSERT_TRUE(json.find("\"name\":\"Inner\"") != string::npos, "Inner zone should be exported");
+
+    size_t events = 0;
+    for (size_t pos = json.find("\"ph\":\"X\""); pos != string::npos; pos = json.find("\"ph\":\"X\"", pos + 1))
+        events++;
+    ASSERT_TRUE(events == 64 * 3, "All the events of all the threads should be exported");
+}
+
+int main (int /*argC*/, char ** /*argV*/)
+{
+    testDisabled();
+    testCollect();
+    testOverflow();
+    testChromeExport();
+
+    cout << "PASSED" << endl;
+    return 0;
+}
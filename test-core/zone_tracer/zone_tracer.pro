@@ -0,0 +1,10 @@
+##################################################################
+# zone_tracer.pro created on Oct 19, 2026
+# This is a file for QMAKE that allows to build the test zone_tracer
+#
+##################################################################
+include(../testsCommon.pri)
+
+DEFINES += WITH_TRACING
+
+SOURCES += main_test_zone_tracer.cpp
@@ -52,7 +52,15 @@ void Frames::fetchNewFrames(ImageCaptureInterface *input)
 {
  //   DOTRACE(("New frames arrived: left=0x8%X right=0x8%X\n", left, right));
 
+    PreciseTimer dequeueTime = PreciseTimer::currentTime();
     ImageCaptureInterface::FramePair pair = input->isRgb ? input->getFrameRGB24() : input->getFrame();
+
+    /* Sources that know better could have set these stamps themselves */
+    mLifecycle = pair.lifecycle;
+    if (!mLifecycle.has(FrameLifecycle::DEQUEUE))
+        mLifecycle.stamps[FrameLifecycle::DEQUEUE] = dequeueTime.usec();
+    if (!mLifecycle.has(FrameLifecycle::DECODE_DONE))
+        mLifecycle.stamp(FrameLifecycle::DECODE_DONE);
     if (pair.bufferLeft == NULL || pair.bufferRight == NULL)
     {
         printf("Alert: We have received one or zero frames\n");
@@ -47,11 +47,15 @@ public:
 
     uint64_t startProcessTimestamp() const          { return mStartProcessTimestamp; }
 
+    /** Lifecycle of the current frames, calculation threads add their stamps to it */
+    FrameLifecycle &lifecycle()                     { return mLifecycle; }
+
 private:
     bool     mSwapped;
     uint64_t mTimestamp;
     int64_t  mDesyncTime;
     uint64_t mStartProcessTimestamp;
+    FrameLifecycle mLifecycle;
 
     /* Not allowed to call*/
     Frames(const Frames &);
@@ -1,5 +1,7 @@
 #include "abstractFileCaptureSpinThread.h"
 #include "abstractFileCapture.h"
+#include "asyncLog.h"
+#include "zoneTracer.h"
 
 AbstractFileCaptureSpinThread::AbstractFileCaptureSpinThread(
     AbstractFileCapture *pInterface
@@ -33,11 +35,12 @@ void AbstractFileCaptureSpinThread::run()
 
         if (!mPaused || mNextFrameNeeded)
         {
+            TRACE_ZONE("AbstractFileCaptureSpinThread::grab");
             mNextFrameNeeded = false;
 
             mInterface->protectFrameMutex().lock();
                 if (!grabFramePair()) {
-                    printf("No more frames.\n");
+                    LA_INFO_RATE(1, "No more frames.");
                 }
                 else {
                     frame_data_t frameData;
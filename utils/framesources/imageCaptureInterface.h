@@ -11,6 +11,7 @@
 
 #include "g12Buffer.h"
 #include "rgb24Buffer.h"
+#include "frameLatencyStatistics.h"
 
 using namespace corecvs;
 
@@ -125,6 +126,7 @@ public:
         RGB24Buffer *rgbBufferRight;
         uint64_t   leftTimeStamp;
         uint64_t   rightTimeStamp;
+        FrameLifecycle lifecycle;   /**< Stamps known to the capture interface, Frames fills the missing ones */
 
         FramePair(G12Buffer* _bufferLeft = NULL, G12Buffer* _bufferRight = NULL)
             : bufferLeft (_bufferLeft )
@@ -13,6 +13,7 @@
 
 #include "openCVCapture.h"
 #include "openCvHelper.h"
+#include "zoneTracer.h"
 
 OpenCVCaptureInterface::OpenCVCaptureInterface(string _devname,  unsigned int mode) : spin(this)
 {
@@ -96,6 +97,7 @@ void OpenCVCaptureInterface::SpinThread::run()
 
     while (!mStopping)
     {
+        TRACE_ZONE("OpenCVCaptureInterface::SpinThread::frame");
         uint width  = cvGetCaptureProperty(mInterface->captureLeft, CV_CAP_PROP_FRAME_WIDTH);
         uint height = cvGetCaptureProperty(mInterface->captureLeft, CV_CAP_PROP_FRAME_HEIGHT);
 
@@ -142,6 +144,7 @@ void OpenCVCaptureInterface::SpinThread::stop()
 
 OpenCVCaptureInterface::FramePair OpenCVCaptureInterface::getFrame()
 {
+    TRACE_ZONE("OpenCVCaptureInterface::getFrame");
     protectFrame.lock();
         FramePair result;
         result.bufferLeft     = new G12Buffer(current.bufferLeft);
@@ -24,6 +24,7 @@
 
 #include "uEyeCapture.h"
 #include "preciseTimer.h"
+#include "zoneTracer.h"
 
 
 #ifdef PROFILE_DEQUEUE
@@ -193,6 +194,7 @@ UEyeCaptureInterface::UEyeCaptureInterface(string _devname) :
 
 UEyeCaptureInterface::FramePair UEyeCaptureInterface::getFrame()
 {
+    TRACE_ZONE("UEyeCaptureInterface::getFrame");
     CaptureStatistics  stats;
     PreciseTimer start = PreciseTimer::currentTime();
     FramePair result( NULL, NULL);
@@ -417,6 +419,7 @@ void UEyeCaptureInterface::SpinThread::run()
 {
     qDebug("new frame thread running");
     while (capInterface->spinRunning.tryLock()) {
+        TRACE_ZONE("UEyeCaptureInterface::SpinThread::frame");
 
     	//usleep(20000);
         if (capInterface->sync == SOFT_SYNC || capInterface->sync == FRAME_HARD_SYNC) {
@@ -13,6 +13,7 @@
 #include <sys/ioctl.h>
 
 #include "V4L2.h"
+#include "asyncLog.h"
 
 #ifdef PROFILE_DEQUEUE
 #define TRACE_DEQUEUE(X) printf X
@@ -302,9 +303,9 @@ int V4L2CameraDescriptor::dequeue( V4L2BufferDescriptor &bufferDescr)
     bufferDescr.isFilled = false;
     if (ioctl (deviceHandle, VIDIOC_DQBUF, &bufferDescr) == -1)
     {
-        printf ("Unable to dequeue buffer (%d) on camera %s(handle 0x%X). Error:%s\n",
+        LA_ERROR_RATE(1, "Unable to dequeue buffer (%d) on camera %s(handle 0x%X). Error:%s",
                 errno,
-                camFileName.c_str(),
+                camFileName,
                 deviceHandle,
                 strerror(errno));
         return 1;
@@ -312,9 +313,9 @@ int V4L2CameraDescriptor::dequeue( V4L2BufferDescriptor &bufferDescr)
 
     if (bufferDescr.index >= count)
     {
-        printf("Dequeue returned buffer id %d (expcted number < %d) for camera %s(handle 0x%X).\n",
+        LA_ERROR_RATE(1, "Dequeue returned buffer id %d (expcted number < %d) for camera %s(handle 0x%X).",
                bufferDescr.index, count,
-               camFileName.c_str(),
+               camFileName,
                deviceHandle);
         return 1;
     }
@@ -334,13 +335,13 @@ int V4L2CameraDescriptor::enqueue(V4L2BufferDescriptor buffer)
 
     if (!buffer.isFilled)
     {
-        printf("Empty Buffer. Will not enqueue\n");
+        LA_WARNING_RATE(1, "Empty Buffer. Will not enqueue");
         return 0;
     }
 
     if (ioctl (deviceHandle, VIDIOC_QBUF, &buffer) == -1)
     {
-        printf ("Unable to requeue buffer (%d).\n", errno);
+        LA_ERROR_RATE(1, "Unable to requeue buffer (%d).", errno);
         return 1;
     }
 
@@ -51,6 +51,16 @@ class V4L2BufferDescriptor : public v4l2_buffer {
         {
             return timestamp.tv_sec * 1000000UL + timestamp.tv_usec;
         }
+
+        /** The driver has taken the timestamp with CLOCK_MONOTONIC */
+        bool hasMonotonicTimeStamp() const
+        {
+#ifdef V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC
+            return (flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) == V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC;
+#else
+            return false;
+#endif
+        }
 };
 
 class V4L2CameraMode {
@@ -28,6 +28,8 @@
 #include "mjpegDecoder.h"
 #include "preciseTimer.h"
 #include "mjpegDecoderLazy.h"
+#include "asyncLog.h"
+#include "zoneTracer.h"
 
 
 const char* V4L2CaptureInterface::CODEC_NAMES[] =
@@ -119,6 +121,7 @@ int V4L2CaptureInterface::setConfigurationString(string _devname)
 
 V4L2CaptureInterface::FramePair V4L2CaptureInterface::getFrame()
 {
+    TRACE_ZONE("V4L2CaptureInterface::getFrame");
     CaptureStatistics  stats;
 
     PreciseTimer start = PreciseTimer::currentTime();
@@ -138,7 +141,7 @@ V4L2CaptureInterface::FramePair V4L2CaptureInterface::getFrame()
         decodeData(&camera[i],  &currentFrame[i],  results[i]);
 
         if ((*results[i]) == NULL) {
-            printf("V4L2CaptureInterface::getFrame(): Precrash condition\n");
+            LA_ERROR_RATE(1, "V4L2CaptureInterface::getFrame(): Precrash condition");
         }
     }
 
@@ -148,9 +151,33 @@ V4L2CaptureInterface::FramePair V4L2CaptureInterface::getFrame()
     if (currentFrame[Frames::RIGHT_FRAME].isFilled)
         result.rightTimeStamp = currentFrame[Frames::RIGHT_FRAME].usecsTimeStamp();
 
+    /*
+     * Drivers stamp the buffers with CLOCK_MONOTONIC and PreciseTimer is the wall clock, so the stamp is
+     * moved by the offset of the clocks. The stamps of the other clocks are not comparable and SENSOR is left unknown.
+     */
+    bool monotonic = true;
+    for (int i = 0; i < Frames::MAX_INPUTS_NUMBER; i++)
+    {
+        if (currentFrame[i].isFilled && !currentFrame[i].hasMonotonicTimeStamp())
+            monotonic = false;
+    }
+
+    int64_t offset = 0;
+    if (monotonic && FrameLifecycle::monotonicOffset(offset))
+    {
+        uint64_t sensor;
+        if (result.leftTimeStamp != 0 && result.rightTimeStamp != 0)
+            sensor = CORE_MIN(result.leftTimeStamp, result.rightTimeStamp);
+        else
+            sensor = CORE_MAX(result.leftTimeStamp, result.rightTimeStamp);
+        if (sensor != 0)
+            result.lifecycle.stamps[FrameLifecycle::SENSOR] = (uint64_t)((int64_t)sensor + offset);
+    }
+    result.lifecycle.stamps[FrameLifecycle::DEQUEUE] = start.usec();
+
     if (skippedCount == 0)
     {
-        SYNC_PRINT(("Warning: Requested same frames twice. Is this by design?\n"));
+        LA_WARNING_RATE(1, "Warning: Requested same frames twice. Is this by design?");
     }
 
     stats.framesSkipped = skippedCount > 0 ? skippedCount - 1 : 0;
@@ -171,6 +198,7 @@ V4L2CaptureInterface::FramePair V4L2CaptureInterface::getFrame()
 
 V4L2CaptureInterface::FramePair V4L2CaptureInterface::getFrameRGB24()
 {
+    TRACE_ZONE("V4L2CaptureInterface::getFrameRGB24");
 //    CaptureStatistics  stats;
 
 //    PreciseTimer start = PreciseTimer::currentTime();
@@ -189,7 +217,7 @@ V4L2CaptureInterface::FramePair V4L2CaptureInterface::getFrameRGB24()
         decodeDataRGB24(&camera[i],  &currentFrame[i],  results[i]);
 
         if ((*results[i]) == NULL) {
-            printf("V4L2CaptureInterface::getFrameRGB24(): Precrash condition\n");
+            LA_ERROR_RATE(1, "V4L2CaptureInterface::getFrameRGB24(): Precrash condition");
         }
     }
 
@@ -230,6 +258,7 @@ void V4L2CaptureInterface::SpinThread::run()
 {
     while (interface->spinRunning.tryLock())
     {
+        TRACE_ZONE("V4L2CaptureInterface::SpinThread::frame");
         V4L2BufferDescriptor newBufferLeft;
         V4L2BufferDescriptor newBufferRight;
 
@@ -325,7 +354,7 @@ uint16_t *V4L2CaptureInterface::decodeMjpeg(unsigned char *data)
     int result = decoder.decode(&framebuffer, data, &width, &height);
     if (result != 0)
     {
-        SYNC_PRINT(("MJPEG decoder error, code %d\n", result));
+        LA_ERROR_RATE(1, "MJPEG decoder error, code %d", result);
     }
 
     return (uint16_t*)framebuffer;
@@ -360,7 +389,7 @@ void V4L2CaptureInterface::decodeData(V4L2CameraDescriptor *camera, V4L2BufferDe
             MjpegDecoderLazy lazyDecoder;
             *output = lazyDecoder.decode(ptrL);
             if (*output == NULL) {
-                SYNC_PRINT(("V4L2CaptureInterface::decodeData(): Decoded to buffer that is NULL\n"));
+                LA_ERROR_RATE(1, "V4L2CaptureInterface::decodeData(): Decoded to buffer that is NULL");
             }
         }
         break;
@@ -381,7 +410,6 @@ void V4L2CaptureInterface::decodeDataRGB24(V4L2CameraDescriptor *camera, V4L2Buf
     {
         case UNCOMPRESSED:
             *output = new RGB24Buffer(formatH, formatW);
-            printf("Decoding image...");
             timer = PreciseTimer::currentTime();
 #if 0
             for(int i = 0; i < formatH; i++)
@@ -402,7 +430,7 @@ void V4L2CaptureInterface::decodeDataRGB24(V4L2CameraDescriptor *camera, V4L2Buf
             }
 #endif
             (*output)->fillWithYUYV(ptrL);
-            printf("Delay: %i\n", timer.usecsToNow());
+            LA_DEBUG("Decoding image... Delay: %i", (int)timer.usecsToNow());
             break;
         case COMPRESSED_JPEG:
         {
@@ -9,6 +9,7 @@
 
 #include "V4L2CaptureDecouple.h"
 #include "decoupleYUYV.h"
+#include "zoneTracer.h"
 
 V4L2CaptureDecoupleInterface::V4L2CaptureDecoupleInterface(string _devname)
     : spin(this)
@@ -97,6 +98,7 @@ V4L2CaptureDecoupleInterface::V4L2CaptureDecoupleInterface(string _devname)
 
 V4L2CaptureDecoupleInterface::FramePair V4L2CaptureDecoupleInterface::getFrame()
 {
+    TRACE_ZONE("V4L2CaptureDecoupleInterface::getFrame");
     CaptureStatistics  stats;
 
     PreciseTimer start = PreciseTimer::currentTime();
@@ -167,6 +169,7 @@ void V4L2CaptureDecoupleInterface::SpinThread::run()
 {
     while (interface->spinRunning.tryLock())
     {
+        TRACE_ZONE("V4L2CaptureDecoupleInterface::SpinThread::frame");
         V4L2BufferDescriptor newBuffer;
 
         V4L2CameraDescriptor* camera = &(interface->camera);
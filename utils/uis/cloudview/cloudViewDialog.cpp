@@ -116,7 +116,7 @@ CloudViewDialog::CloudViewDialog(QWidget *parent) :
 
     Mesh3DScene *mesh = new Mesh3DScene();
     PLYLoader loader;
-    ifstream file("data/box.ply", ios::in);
+    ifstream file("data/box.ply", ios::in | ios::binary);
     if (!file.fail() && loader.loadPLY(file, *mesh) != 0)
     {
         qDebug() << "CloudViewDialog::Unable to load mesh";
@@ -724,7 +724,7 @@ void CloudViewDialog::savePointsPLY()
 
     count++;
     qDebug("Dumping current scene to <%s>...", name);
-    fstream file(name, fstream::out);
+    fstream file(name, fstream::out | fstream::binary);
     mScenes[MAIN_SCENE]->dumpPLY(file);
     file.close();
     qDebug("done\n");
@@ -739,18 +739,11 @@ void CloudViewDialog::loadMesh()
       tr("3D Model (*.ply)"));
 
     Mesh3DScene *mesh = new Mesh3DScene();
-    ifstream file;
-    file.open(fileName.toAscii().data(), ios::in);
-    if (file.fail())
-    {
-        qDebug() << "Can't open property list file" << endl;
-        return;
-    }
     PLYLoader loader;
-    if (loader.loadPLY(file, *mesh) != 0)
+    if (loader.loadPLY(fileName.toAscii().data(), *mesh) != 0)
     {
        qDebug() << "CloudViewDialog::Unable to load mesh";
-       file.close();
+       delete_safe(mesh);
        return;
     }
 